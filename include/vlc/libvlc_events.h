@@ -53,6 +53,7 @@ enum libvlc_event_e {
     libvlc_MediaFreed,
     libvlc_MediaStateChanged,
     libvlc_MediaSubItemTreeAdded,
+    libvlc_MediaThumbnailGenerated,
 
     libvlc_MediaPlayerMediaChanged=0x100,
     libvlc_MediaPlayerNothingSpecial,
@@ -154,6 +155,11 @@ typedef struct libvlc_event_t
         {
             libvlc_media_t * item;
         } media_subitemtree_added;
+        struct
+        {
+            /** path of the generated image, or NULL on failure */
+            const char * psz_path;
+        } media_thumbnail_generated;
 
         /* media instance */
         struct
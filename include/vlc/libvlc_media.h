@@ -679,6 +679,35 @@ LIBVLC_API int
 libvlc_media_parse_with_options( libvlc_media_t *p_md,
                                  libvlc_media_parse_flag_t parse_flag );
 
+/**
+ * Request a thumbnail for the media.
+ *
+ * The media is decoded at the given position on a worker thread shared by
+ * all thumbnail requests of the LibVLC instance; the decoded frame is
+ * scaled, encoded and written to psz_filepath. The image type is selected
+ * from the file extension (png or jpg).
+ *
+ * The method is asynchronous. To track completion, listen to the
+ * libvlc_MediaThumbnailGenerated event of the media: psz_path is the
+ * output path on success and NULL on failure.
+ *
+ * \see libvlc_MediaThumbnailGenerated
+ *
+ * \param p_inst LibVLC instance to generate the thumbnail with
+ * \param p_md media descriptor object
+ * \param f_position position at which to take the thumbnail, between 0.0 and 1.0
+ * \param i_width thumbnail width, or 0 to use the media dimensions
+ * \param i_height thumbnail height, or 0 to use the media dimensions
+ * \param psz_filepath path of the image file to write
+ * \return 0 if the request was queued, -1 in case of error
+ * \version LibVLC 3.0.0 or later
+ */
+LIBVLC_API int
+libvlc_media_thumbnail_request( libvlc_instance_t *p_inst,
+                                libvlc_media_t *p_md, float f_position,
+                                unsigned i_width, unsigned i_height,
+                                const char *psz_filepath );
+
 /**
  * Get Parsed status for media descriptor object.
  *
@@ -124,6 +124,44 @@ libvlc_media_list_insert_media( libvlc_media_list_t *p_ml,
 LIBVLC_API int
 libvlc_media_list_remove_index( libvlc_media_list_t *p_ml, int i_pos );
 
+/**
+ * Insert several media instances in the media list at once.
+ * The storage is grown a single time and a single
+ * libvlc_MediaListWillAddItem / libvlc_MediaListItemAdded event pair is
+ * emitted for the whole batch, carrying the first inserted item and its
+ * position; listeners should requery the list for the details.
+ * The libvlc_media_list_lock should be held upon entering this function.
+ *
+ * \param p_ml a media list instance
+ * \param pp_mds array of media instances to insert
+ * \param i_count number of entries in pp_mds
+ * \param i_pos position in array where to insert
+ * \return 0 on success, -1 if the media list is read-only
+ * \version LibVLC 3.0.0 or later
+ */
+LIBVLC_API int
+libvlc_media_list_insert_media_array( libvlc_media_list_t *p_ml,
+                                      libvlc_media_t *const *pp_mds,
+                                      int i_count, int i_pos );
+
+/**
+ * Remove a range of media instances from the media list at once.
+ * The items are shifted a single time and a single
+ * libvlc_MediaListWillDeleteItem / libvlc_MediaListItemDeleted event pair
+ * is emitted for the whole batch, carrying the first removed item and its
+ * position.
+ * The libvlc_media_list_lock should be held upon entering this function.
+ *
+ * \param p_ml a media list instance
+ * \param i_pos position in array of the first item to remove
+ * \param i_count number of items to remove
+ * \return 0 on success, -1 if the list is read-only or the range is invalid
+ * \version LibVLC 3.0.0 or later
+ */
+LIBVLC_API int
+libvlc_media_list_remove_index_range( libvlc_media_list_t *p_ml,
+                                      int i_pos, int i_count );
+
 /**
  * Get count on media list items
  * The libvlc_media_list_lock should be held upon entering this function.
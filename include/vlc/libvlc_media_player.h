@@ -412,6 +412,60 @@ void libvlc_video_set_format_callbacks( libvlc_media_player_t *mp,
                                         libvlc_video_format_cb setup,
                                         libvlc_video_cleanup_cb cleanup );
 
+/**
+ * Callback prototype to lend a decoded video frame to the host application.
+ *
+ * The frame is backed by LibVLC-owned memory; no copy into application
+ * memory takes place. The application keeps the planes valid until it
+ * returns the frame with libvlc_video_release_picture(). Frames must be
+ * released promptly: the player only owns a small pool of pictures and
+ * decoding stalls once they are all lent out. All frames must be released
+ * before the media player is stopped or destroyed.
+ *
+ * \param opaque private pointer as passed to libvlc_video_set_lend_callbacks() [IN]
+ * \param picture opaque handle to pass to libvlc_video_release_picture() [IN]
+ * \param plane_count number of entries in the planes, pitches and lines tables [IN]
+ * \param planes start address of each plane [IN]
+ * \param pitches pitch of each plane, in bytes [IN]
+ * \param lines number of visible lines in each plane [IN]
+ * \version LibVLC 3.0.0 or later
+ */
+typedef void (*libvlc_video_lend_cb)(void *opaque, void *picture,
+                                     unsigned plane_count,
+                                     void *const planes[],
+                                     const unsigned pitches[],
+                                     const unsigned lines[]);
+
+/**
+ * Set a callback lending decoded video frames to the host application
+ * without copying them.
+ * This is an alternative to libvlc_video_set_callbacks(): instead of
+ * rendering into application-provided buffers, the player hands out
+ * its own reference-counted pictures and the application releases each
+ * one with libvlc_video_release_picture() when done with it.
+ * Use libvlc_video_set_format() or libvlc_video_set_format_callbacks()
+ * to configure the decoded format.
+ *
+ * \param mp the media player
+ * \param lend callback invoked for each decoded frame (must not be NULL)
+ * \param opaque private pointer for the callback (as first parameter)
+ * \version LibVLC 3.0.0 or later
+ */
+LIBVLC_API
+void libvlc_video_set_lend_callbacks( libvlc_media_player_t *mp,
+                                      libvlc_video_lend_cb lend,
+                                      void *opaque );
+
+/**
+ * Return a video frame obtained through @ref libvlc_video_lend_cb to the
+ * player. The planes of the frame must not be accessed afterwards.
+ *
+ * \param picture opaque picture handle from @ref libvlc_video_lend_cb
+ * \version LibVLC 3.0.0 or later
+ */
+LIBVLC_API
+void libvlc_video_release_picture( void *picture );
+
 /**
  * Set the NSView handler where the media player should render its video output.
  *
@@ -862,6 +916,25 @@ LIBVLC_API int libvlc_media_player_set_rate( libvlc_media_player_t *p_mi, float
  */
 LIBVLC_API libvlc_state_t libvlc_media_player_get_state( libvlc_media_player_t *p_mi );
 
+/**
+ * Get the current time, position and state in a single call.
+ *
+ * This is a polling alternative to listening for the TimeChanged,
+ * PositionChanged and state events: the three values are read together,
+ * so they are mutually consistent, and only one call crosses the LibVLC
+ * boundary per sample.
+ *
+ * \param p_mi the Media Player
+ * \param p_time pointer to the current time in ms, -1 if there is no media [OUT]
+ * \param p_position pointer to the current position, -1. if there is no media [OUT]
+ * \param p_state pointer to the current state of the media player [OUT]
+ * \version LibVLC 3.0.0 or later
+ */
+LIBVLC_API void libvlc_media_player_get_state_snapshot( libvlc_media_player_t *p_mi,
+                                                        libvlc_time_t *p_time,
+                                                        float *p_position,
+                                                        libvlc_state_t *p_state );
+
 /**
  * Get movie fps rate
  *
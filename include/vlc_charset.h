@@ -62,15 +62,25 @@ VLC_API size_t vlc_towc(const char *str, uint32_t *restrict pwc);
  */
 VLC_USED static inline const char *IsUTF8(const char *str)
 {
-    size_t n;
-    uint32_t cp;
+    for (;;)
+    {
+        unsigned char c = *str;
 
-    while ((n = vlc_towc(str, &cp)) != 0)
-        if (likely(n != (size_t)-1))
-            str += n;
-        else
+        /* ASCII is trivially valid: no call into vlc_towc() per byte */
+        if (likely(c > 0 && c < 0x80))
+        {
+            str++;
+            continue;
+        }
+        if (c == '\0')
+            return str;
+
+        uint32_t cp;
+        size_t n = vlc_towc(str, &cp);
+        if (n == (size_t)-1)
             return NULL;
-    return str;
+        str += n;
+    }
 }
 
 /**
@@ -94,10 +104,22 @@ VLC_USED static inline const char *IsUTF8(const char *str)
 static inline char *EnsureUTF8(char *str)
 {
     char *ret = str;
-    size_t n;
-    uint32_t cp;
 
-    while ((n = vlc_towc(str, &cp)) != 0)
+    for (;;)
+    {
+        unsigned char c = *str;
+
+        /* ASCII is trivially valid: no call into vlc_towc() per byte */
+        if (likely(c > 0 && c < 0x80))
+        {
+            str++;
+            continue;
+        }
+        if (c == '\0')
+            return ret;
+
+        uint32_t cp;
+        size_t n = vlc_towc(str, &cp);
         if (likely(n != (size_t)-1))
             str += n;
         else
@@ -105,7 +127,7 @@ static inline char *EnsureUTF8(char *str)
             *str++ = '?';
             ret = NULL;
         }
-    return ret;
+    }
 }
 
 /* iconv wrappers (defined in src/extras/libc.c) */
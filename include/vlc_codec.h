@@ -148,6 +148,11 @@ struct decoder_t
      * XXX use decoder_GetDisplayRate */
     int             (*pf_get_display_rate)( decoder_t * );
 
+    /* Shared worker pool
+     * XXX use decoder_ScheduleTask and decoder_WaitTasks */
+    int             (*pf_schedule_task)( decoder_t *, void (*pf_run)(void *), void * );
+    void            (*pf_wait_tasks)( decoder_t * );
+
     /* XXX use decoder_QueueVideo */
     int             (*pf_queue_video)( decoder_t *, picture_t * );
     /* XXX use decoder_QueueAudio */
@@ -353,6 +358,31 @@ static inline int decoder_UpdateAudioFormat( decoder_t *dec )
         return -1;
 }
 
+/**
+ * Schedules an independent task, typically a frame or slice decode, on the
+ * worker pool shared by all decoders of an input. Tasks scheduled by one
+ * decoder may run concurrently; use decoder_WaitTasks() as a barrier.
+ *
+ * When the owner provides no pool the task is run synchronously before
+ * returning, so callers do not need a separate single-threaded path.
+ */
+static inline void decoder_ScheduleTask( decoder_t *dec,
+                                         void (*pf_run)(void *), void *p_data )
+{
+    if( dec->pf_schedule_task == NULL ||
+        dec->pf_schedule_task( dec, pf_run, p_data ) )
+        pf_run( p_data );
+}
+
+/**
+ * Waits until all pool tasks scheduled by this decoder have completed.
+ */
+static inline void decoder_WaitTasks( decoder_t *dec )
+{
+    if( dec->pf_wait_tasks != NULL )
+        dec->pf_wait_tasks( dec );
+}
+
 /**
  * This function will return a new audio buffer usable by a decoder as an
  * output buffer. It must be released with block_Release() or returned it to
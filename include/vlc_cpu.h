@@ -195,4 +195,24 @@ VLC_API unsigned vlc_CPU(void);
 
 # endif
 
+/**
+ * Generic function pointer, for CPU dispatch tables.
+ */
+typedef void (*vlc_cpu_fn_t)(void);
+
+/**
+ * CPU dispatch table entry.
+ *
+ * Associates one implementation of a function with the capability flags it
+ * requires. A table lists entries from the most to the least demanding
+ * implementation and ends with a fallback requiring no flags at all.
+ */
+typedef struct
+{
+    unsigned flags;    /**< required VLC_CPU_* flags, 0 for the fallback */
+    vlc_cpu_fn_t func; /**< the implementation */
+} vlc_cpu_dispatch_t;
+
+VLC_API vlc_cpu_fn_t vlc_CPU_resolve(const vlc_cpu_dispatch_t *) VLC_USED;
+
 #endif /* !VLC_CPU_H */
@@ -0,0 +1,50 @@
+/*****************************************************************************
+ * vlc_crc.h: CRC checksums
+ *****************************************************************************
+ * Copyright © 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef VLC_CRC_H
+# define VLC_CRC_H
+
+/**
+ * \file
+ * This file defines functions to compute CRC checksums
+ */
+
+/**
+ * Computes a CRC-32 checksum with the MPEG-2 polynomial (0x04C11DB7,
+ * most-significant bit first, no final complement), as used by MPEG-TS
+ * PSI sections, DVB SI tables and Ogg pages.
+ *
+ * The computation can be chained: the checksum of a buffer split in two
+ * is vlc_crc32(vlc_crc32(init, part1, size1), part2, size2).
+ *
+ * A section carrying its own CRC (e.g. a PSI section including the
+ * trailing CRC_32 field) checks out if and only if the checksum of the
+ * whole section, CRC included, is zero.
+ *
+ * \param i_crc initial checksum value (0xFFFFFFFF for MPEG/DVB sections,
+ *              0 for Ogg pages)
+ * \param p_data start of the buffer to checksum
+ * \param i_size size of the buffer in bytes
+ * \return the updated checksum
+ */
+VLC_API uint32_t vlc_crc32( uint32_t i_crc, const void *p_data, size_t i_size )
+VLC_USED;
+
+#endif
@@ -93,5 +93,13 @@ VLC_API void vlc_epg_SetCurrent(vlc_epg_t *p_epg, int64_t i_start);
  */
 VLC_API void vlc_epg_Merge(vlc_epg_t *p_dst, const vlc_epg_t *p_src);
 
+/**
+ * Like vlc_epg_Merge(), but returns the number of events of \p p_dst that
+ * were actually added, updated or expired, so callers can skip refreshes
+ * when a merge turns out to be a redundant table repeat (the common case
+ * with DVB, where EIT tables are broadcast in a continuous loop).
+ */
+VLC_API int vlc_epg_MergeDelta(vlc_epg_t *p_dst, const vlc_epg_t *p_src);
+
 #endif
 
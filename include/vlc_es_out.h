@@ -24,6 +24,8 @@
 #ifndef VLC_ES_OUT_H
 #define VLC_ES_OUT_H 1
 
+#include <vlc_block.h>
+
 /**
  * \defgroup es_out ES output
  * \ingroup input
@@ -100,6 +102,11 @@ struct es_out_t
     int          (*pf_control)( es_out_t *, int i_query, va_list );
     void         (*pf_destroy)( es_out_t * );
 
+    /* Optional: send a p_next chain of blocks of one ES in a single call
+     * (one lock acquisition, one statistics update). May be NULL, in which
+     * case es_out_SendBatch() falls back on pf_send per block. */
+    int          (*pf_send_batch)( es_out_t *, es_out_id_t *, block_t * );
+
     es_out_sys_t    *p_sys;
 };
 
@@ -120,6 +127,29 @@ static inline int es_out_Send( es_out_t *out, es_out_id_t *id,
     return out->pf_send( out, id, p_block );
 }
 
+/**
+ * Sends a chain of blocks, linked through p_next and all belonging to the
+ * given ES, in one call. The chain is consumed whatever the result.
+ */
+static inline int es_out_SendBatch( es_out_t *out, es_out_id_t *id,
+                                    block_t *p_block )
+{
+    if( out->pf_send_batch != NULL )
+        return out->pf_send_batch( out, id, p_block );
+
+    int i_ret = VLC_SUCCESS;
+    while( p_block != NULL )
+    {
+        block_t *p_next = p_block->p_next;
+
+        p_block->p_next = NULL;
+        if( out->pf_send( out, id, p_block ) )
+            i_ret = VLC_EGENERIC;
+        p_block = p_next;
+    }
+    return i_ret;
+}
+
 static inline int es_out_vaControl( es_out_t *out, int i_query, va_list args )
 {
     return out->pf_control( out, i_query, args );
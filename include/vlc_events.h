@@ -127,6 +127,7 @@ typedef enum vlc_event_type_t {
 
     /* Service Discovery event */
     vlc_ServicesDiscoveryItemAdded,
+    vlc_ServicesDiscoveryItemsAdded,
     vlc_ServicesDiscoveryItemRemoved,
     vlc_ServicesDiscoveryItemRemoveAll,
     vlc_ServicesDiscoveryStarted,
@@ -195,6 +196,12 @@ typedef struct vlc_event_t
             input_item_t * p_new_item;
             const char * psz_category;
         } services_discovery_item_added;
+        struct vlc_services_discovery_items_added
+        {
+            input_item_t * const * pp_items;
+            int i_count;
+            const char * psz_category;
+        } services_discovery_items_added;
         struct vlc_services_discovery_item_removed
         {
             input_item_t * p_item;
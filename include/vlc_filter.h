@@ -79,6 +79,13 @@ struct filter_t
     es_format_t         fmt_out;
     bool                b_allow_fmt_out_change;
 
+    /* Set by video filters whose output may share the input picture
+     * buffers (strictly per-pixel processing, no neighbour reads): when
+     * formats match and the input is not referenced elsewhere, the owner
+     * may hand the input picture back from filter_NewPicture() so that
+     * the filter effectively runs in place. */
+    bool                b_allow_in_place;
+
     /* Filter configuration */
     config_chain_t *    p_cfg;
 
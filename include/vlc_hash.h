@@ -0,0 +1,62 @@
+/*****************************************************************************
+ * vlc_hash.h: fast non-cryptographic hashing
+ *****************************************************************************
+ * Copyright © 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef VLC_HASH_H
+# define VLC_HASH_H
+
+/**
+ * \file
+ * This file defines a fast non-cryptographic 64-bit hash (XXH64)
+ *
+ * Use it for cache keys, deduplication and in-memory hash tables where MD5
+ * strength is pointless and its cost is not. Do NOT use it where a
+ * protocol or file format mandates a specific digest.
+ */
+
+/**
+ * XXH64 streaming state. Can live on the stack; no cleanup needed.
+ */
+struct vlc_hash64_s
+{
+    uint64_t v[4];     /* lane accumulators */
+    uint64_t total;    /* bytes hashed so far */
+    uint8_t  buf[32];  /* pending partial stripe */
+    size_t   count;    /* bytes pending in buf */
+};
+
+VLC_API void vlc_hash64_Init( struct vlc_hash64_s *, uint64_t i_seed );
+VLC_API void vlc_hash64_Add( struct vlc_hash64_s *, const void *, size_t );
+VLC_API uint64_t vlc_hash64_Finish( struct vlc_hash64_s * ) VLC_USED;
+
+/**
+ * Convenience one-shot variant, with a zero seed.
+ */
+VLC_API uint64_t vlc_hash64( const void *, size_t ) VLC_USED;
+
+/**
+ * Returns the hash as a 16 character lowercase hexadecimal string,
+ * suitable for cache file names. The buffer must hold 17 bytes.
+ */
+static inline void vlc_hash64_hex( char *psz, uint64_t i_hash )
+{
+    snprintf( psz, 17, "%016"PRIx64, i_hash );
+}
+
+#endif
@@ -185,6 +185,10 @@ struct vlc_credential
 
     char *psz_dialog_username;
     char *psz_dialog_password;
+
+    char *psz_cached_username;
+    char *psz_cached_password;
+
     bool b_from_keystore;
     bool b_store;
 };
@@ -110,6 +110,43 @@ static inline int net_ListenUDP1 (vlc_object_t *obj, const char *host, int port)
 
 VLC_API void net_ListenClose( int *fd );
 
+/**
+ * Receives one datagram per block, up to \p count datagrams, in a single
+ * system call if the operating system supports it (one otherwise).
+ * On input, each block buffer size is the receive capacity; on output, it
+ * is the length of the received datagram.
+ * @return the number of datagrams received, or -1 on error
+ */
+VLC_API ssize_t net_RecvDgrams( int fd, block_t *const *blocks,
+                                unsigned count );
+
+/**
+ * Sends each block as one datagram, up to \p count datagrams, in a single
+ * system call if the operating system supports it (one otherwise).
+ * @return the number of datagrams sent (possibly fewer than \p count),
+ * or -1 if no datagram was sent
+ */
+VLC_API ssize_t net_SendDgrams( int fd, block_t *const *blocks,
+                                unsigned count );
+
+/**
+ * Enables kernel transmit time pacing on a datagram socket
+ * (Linux SO_TXTIME, requires an fq or etf queueing discipline).
+ * @return 0 on success, -1 if unsupported or on error
+ */
+VLC_API int net_SetDgramTxTime( int fd );
+
+/**
+ * Sends each block as one datagram like net_SendDgrams(), with a per
+ * datagram transmit deadline on the mdate() clock. The deadlines are
+ * honoured on a socket prepared with net_SetDgramTxTime() and ignored
+ * elsewhere.
+ * @return the number of datagrams sent (possibly fewer than \p count),
+ * or -1 if no datagram was sent
+ */
+VLC_API ssize_t net_SendDgramsAt( int fd, block_t *const *blocks,
+                                  unsigned count, const mtime_t *deadlines );
+
 int net_Subscribe (vlc_object_t *obj, int fd, const struct sockaddr *addr,
                    socklen_t addrlen);
 
@@ -119,6 +156,9 @@ VLC_API ssize_t net_Read( vlc_object_t *p_this, int fd, void *p_data, size_t i_d
 #define net_Read(a,b,c,d) net_Read(VLC_OBJECT(a),b,c,d)
 VLC_API ssize_t net_Write( vlc_object_t *p_this, int fd, const void *p_data, size_t i_data );
 #define net_Write(a,b,c,d) net_Write(VLC_OBJECT(a),b,c,d)
+struct iovec;
+VLC_API ssize_t net_Writev( vlc_object_t *p_this, int fd, const struct iovec *iov, unsigned count );
+#define net_Writev(a,b,c,d) net_Writev(VLC_OBJECT(a),b,c,d)
 VLC_API char * net_Gets( vlc_object_t *p_this, int fd );
 #define net_Gets(a,b) net_Gets(VLC_OBJECT(a),b)
 
@@ -227,6 +267,9 @@ VLC_API int  getnameinfo ( const struct sockaddr *, socklen_t,
 VLC_API int vlc_getnameinfo( const struct sockaddr *, int, char *, int, int *, int );
 VLC_API int vlc_getaddrinfo (const char *, unsigned,
                              const struct addrinfo *, struct addrinfo **);
+VLC_API int vlc_getaddrinfo_i11e (const char *, unsigned,
+                                  const struct addrinfo *, struct addrinfo **);
+VLC_API void vlc_freeaddrinfo (struct addrinfo *);
 
 
 #ifdef __OS2__
@@ -43,6 +43,17 @@ typedef struct picture_fifo_t picture_fifo_t;
  */
 VLC_API picture_fifo_t * picture_fifo_New( void ) VLC_USED;
 
+/**
+ * It creates an empty picture_fifo_t with a bounded lock-free fast path.
+ *
+ * As long as no more than \p capacity pictures are queued, a single pushing
+ * thread and a single popping thread operate on an atomic ring and never
+ * contend on a lock; excess pictures transparently spill over to a locked
+ * list. Use this for high-rate single-producer/single-consumer queues such
+ * as the decoder-to-vout picture hand-off.
+ */
+VLC_API picture_fifo_t * picture_fifo_NewSPSC( unsigned capacity ) VLC_USED;
+
 /**
  * It destroys a fifo created by picture_fifo_New.
  *
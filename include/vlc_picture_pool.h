@@ -95,6 +95,22 @@ VLC_API picture_pool_t * picture_pool_New(unsigned count,
 VLC_API picture_pool_t * picture_pool_NewFromFormat(const video_format_t *fmt,
                                                     unsigned count) VLC_USED;
 
+/**
+ * Creates a pool of preallocated pictures with node-local memory.
+ *
+ * Like picture_pool_NewFromFormat(), but every plane is pre-faulted on the
+ * calling thread, so that first-touch NUMA policies place the pixel pages on
+ * the memory node of the caller. Call this from the thread that will consume
+ * the pictures (e.g. the video output thread).
+ *
+ * @param fmt video format of pictures to allocate from the heap
+ * @param count number of pictures to allocate
+ *
+ * @return a pointer to the new pool on success, NULL on error
+ */
+VLC_API picture_pool_t * picture_pool_NewFromFormatLocal(
+                        const video_format_t *fmt, unsigned count) VLC_USED;
+
 /**
  * Releases a pool created by picture_pool_NewExtended(), picture_pool_New()
  * or picture_pool_NewFromFormat().
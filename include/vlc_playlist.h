@@ -141,6 +141,8 @@ struct playlist_item_t
     int                    i_id;        /**< Playlist item specific id */
     uint8_t                i_flags;     /**< Flags \see playlist_item_flags_e */
 
+    char                  *psz_search_key; /**< Cached live search key,
+                                                core-private */
     playlist_t            *p_playlist;  /**< Parent playlist */
 };
 
@@ -156,6 +156,10 @@ VLC_API vlc_event_manager_t * services_discovery_EventManager( services_discover
     /* About the psz_category, it is a legacy way to add info to the item,
      * for more options, directly set the (meta) data on the input item */
 VLC_API void services_discovery_AddItem( services_discovery_t * p_this, input_item_t * p_item, const char * psz_category );
+    /* Batch variant: the whole array is announced as one event, so the
+     * playlist adds all items in a single transaction instead of waking the
+     * interfaces once per item */
+VLC_API void services_discovery_AddItems( services_discovery_t * p_this, input_item_t * const * pp_items, int i_count, const char * psz_category );
 VLC_API void services_discovery_RemoveItem( services_discovery_t * p_this, input_item_t * p_item );
 VLC_API void services_discovery_RemoveAll( services_discovery_t * p_sd );
 
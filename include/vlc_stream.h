@@ -127,8 +127,12 @@ VLC_API ssize_t stream_Read(stream_t *, void *, size_t) VLC_USED;
  * or stream_Block(), this function does not modify the stream read offset.
  *
  * \note
- * The buffer remains valid until the next read/peek or seek operation on the
- * same stream. In case of error, the buffer address is undefined.
+ * The returned buffer is borrowed from the stream: it remains valid until the
+ * next read or seek operation on the same stream, or until a later peek
+ * requests more bytes than are currently buffered. Peeking again for no more
+ * than the buffered length leaves the buffer address unchanged, so probing
+ * code may peek repeatedly without incurring any copy. In case of error, the
+ * buffer address is undefined.
  *
  * \param bufp storage space for the buffer address [OUT]
  * \param len number of bytes to peek
@@ -100,6 +100,20 @@ VLC_API char *vlc_uri_decode_duplicate(const char *str) VLC_MALLOC;
  */
 VLC_API char *vlc_uri_encode(const char *str) VLC_MALLOC;
 
+/**
+ * Encodes a URI component into a caller-supplied buffer.
+ *
+ * Same as vlc_uri_encode() but without heap allocation, for hot paths that
+ * encode short components into a stack buffer.
+ *
+ * @param buf buffer to write the encoded component to
+ * @param size size of the buffer in bytes; must cover the worst case of
+ *             three bytes per input byte, plus one for the terminator
+ * @param str nul-terminated UTF-8 representation of the component.
+ * @return buf, or NULL if the buffer is too small.
+ */
+VLC_API char *vlc_uri_encode_buf(char *buf, size_t size, const char *str);
+
 /** @} */
 
 struct vlc_url_t
@@ -66,6 +66,12 @@
 
 #define VLC_VAR_ISCOMMAND 0x2000
 
+/* Value change callbacks run asynchronously on a notifier thread instead
+   of the thread calling var_Set(), which returns immediately; bursts of
+   changes are coalesced into a single notification carrying the latest
+   value. Use for hot-path variables watched by slow observers. */
+#define VLC_VAR_ISDEFERRED 0x4000
+
 /** Creation flag */
 /* If the variable is not found on the current module
    search all parents and finally module config until found */
@@ -197,6 +197,11 @@ enum {
 
     VOUT_DISPLAY_EVENT_DISPLAY_SIZE,        /* The display size need to change : int i_width, int i_height */
 
+    /* A picture was effectively shown on screen: mtime_t date.
+     * Optional; displays that know actual presentation times (vsync
+     * feedback) can report them so the core phase-locks its pacing. */
+    VOUT_DISPLAY_EVENT_PRESENTED,
+
     /* */
     VOUT_DISPLAY_EVENT_CLOSE,
     VOUT_DISPLAY_EVENT_KEY,
@@ -352,6 +357,10 @@ static inline void vout_display_SendEventPicturesInvalid(vout_display_t *vd)
 {
     vout_display_SendEvent(vd, VOUT_DISPLAY_EVENT_PICTURES_INVALID);
 }
+static inline void vout_display_SendEventPresented(vout_display_t *vd, mtime_t date)
+{
+    vout_display_SendEvent(vd, VOUT_DISPLAY_EVENT_PRESENTED, date);
+}
 static inline void vout_display_SendEventClose(vout_display_t *vd)
 {
     vout_display_SendEvent(vd, VOUT_DISPLAY_EVENT_CLOSE);
@@ -68,6 +68,7 @@ libvlc_instance_t * libvlc_new( int argc, const char *const *argv )
     p_new->libvlc_vlm.pf_release = NULL;
     p_new->ref_count = 1;
     p_new->p_callback_list = NULL;
+    p_new->p_thumbnailer = NULL;
     vlc_mutex_init(&p_new->instance_lock);
     return p_new;
 
@@ -99,6 +100,7 @@ void libvlc_release( libvlc_instance_t *p_instance )
 
     if( refs == 0 )
     {
+        libvlc_thumbnailer_Destroy( p_instance );
         vlc_mutex_destroy( lock );
         if( p_instance->libvlc_vlm.pf_release )
             p_instance->libvlc_vlm.pf_release( p_instance );
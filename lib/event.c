@@ -78,11 +78,28 @@ typedef struct libvlc_event_listener_t
     libvlc_callback_t   pf_callback;
 } libvlc_event_listener_t;
 
+/* Minimum interval between two dispatches of the same high-rate event type.
+ * These events carry the current absolute value, so every event supersedes
+ * the previous one and dropping intermediate ones only reduces granularity.
+ * Discrete events (state changes, end of stream...) are never coalesced. */
+static const struct
+{
+    int     type;
+    mtime_t interval;
+} coalesce_policy[] = {
+    { libvlc_MediaPlayerBuffering,       CLOCK_FREQ / 10 },
+    { libvlc_MediaPlayerTimeChanged,     CLOCK_FREQ / 10 },
+    { libvlc_MediaPlayerPositionChanged, CLOCK_FREQ / 10 },
+};
+#define COALESCED_TYPES \
+    (sizeof (coalesce_policy) / sizeof (coalesce_policy[0]))
+
 typedef struct libvlc_event_manager_t
 {
     void * p_obj;
     vlc_array_t listeners;
     vlc_mutex_t lock;
+    mtime_t last_sent[COALESCED_TYPES];
 } libvlc_event_sender_t;
 
 /*
@@ -109,6 +126,8 @@ libvlc_event_manager_new( void * p_obj )
     p_em->p_obj = p_obj;
     vlc_array_init(&p_em->listeners);
     vlc_mutex_init_recursive(&p_em->lock);
+    for (size_t i = 0; i < COALESCED_TYPES; i++)
+        p_em->last_sent[i] = VLC_TS_INVALID;
     return p_em;
 }
 
@@ -136,10 +155,44 @@ void libvlc_event_manager_release( libvlc_event_manager_t * p_em )
 void libvlc_event_send( libvlc_event_manager_t * p_em,
                         libvlc_event_t * p_event )
 {
+    int slot = -1;
+
     /* Fill event with the sending object now */
     p_event->p_obj = p_em->p_obj;
 
+    for (size_t i = 0; i < COALESCED_TYPES; i++)
+        if (coalesce_policy[i].type == p_event->type)
+        {
+            slot = i;
+            break;
+        }
+
+    /* Terminal values are never coalesced: nothing supersedes them, and
+     * applications key UI state on receiving them (e.g. leaving the
+     * "buffering" state on 100%). */
+    bool b_edge = false;
+    if (p_event->type == libvlc_MediaPlayerBuffering)
+    {
+        float f_cache = p_event->u.media_player_buffering.new_cache;
+        b_edge = f_cache <= 0.f || f_cache >= 100.f;
+    }
+
     vlc_mutex_lock(&p_em->lock);
+    if (slot >= 0)
+    {
+        mtime_t now = mdate();
+
+        if (!b_edge
+         && now - p_em->last_sent[slot] < coalesce_policy[slot].interval)
+        {   /* Too soon after the previous one, drop this update. The next
+             * event of this type will carry a fresher value anyway, and
+             * libvlc_media_player_get_state_snapshot() always returns the
+             * current values regardless of event pacing. */
+            vlc_mutex_unlock(&p_em->lock);
+            return;
+        }
+        p_em->last_sent[slot] = now;
+    }
     for (int i = 0; i < vlc_array_count(&p_em->listeners); i++)
     {
         libvlc_event_listener_t *listener;
@@ -171,6 +224,7 @@ static const event_name_t event_list[] = {
     DEF(MediaFreed)
     DEF(MediaStateChanged)
     DEF(MediaSubItemTreeAdded)
+    DEF(MediaThumbnailGenerated)
 
     DEF(MediaPlayerMediaChanged)
     DEF(MediaPlayerNothingSpecial)
@@ -73,6 +73,8 @@ struct libvlc_instance_t
     unsigned      ref_count;
     vlc_mutex_t   instance_lock;
     struct libvlc_callback_entry_list_t *p_callback_list;
+    /* Shared thumbnail worker, created on first use. See lib/media.c. */
+    struct libvlc_thumbnailer_t *p_thumbnailer;
     struct
     {
         void (*cb) (void *, int, const libvlc_log_t *, const char *, va_list);
@@ -89,6 +91,9 @@ struct libvlc_instance_t
 void libvlc_threads_init (void);
 void libvlc_threads_deinit (void);
 
+/* Thumbnailer (lib/media.c) */
+void libvlc_thumbnailer_Destroy( libvlc_instance_t *p_instance );
+
 /* Events */
 libvlc_event_manager_t * libvlc_event_manager_new(void * p_obj);
 
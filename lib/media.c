@@ -33,9 +33,13 @@
 #include <vlc/libvlc_media_list.h> // For the subitems, here for convenience
 #include <vlc/libvlc_events.h>
 
+#include <vlc/libvlc_media_player.h> // For the thumbnailer
+
 #include <vlc_common.h>
+#include <vlc_image.h>
 #include <vlc_input.h>
 #include <vlc_meta.h>
+#include <vlc_picture.h>
 #include <vlc_playlist.h> /* For the preparser */
 #include <vlc_url.h>
 
@@ -1046,3 +1050,402 @@ libvlc_media_type_t libvlc_media_get_type( libvlc_media_t *p_md )
         return libvlc_media_type_unknown;
     }
 }
+
+/**************************************************************************
+ * Thumbnailer
+ *
+ * A single worker thread, shared by all requests of the instance and
+ * created on first use, decodes one frame per request through a reused
+ * media player and encodes it with a reused image handler. The player
+ * and media references the worker holds pin the instance, so releasing
+ * them can drop the last instance reference and re-enter
+ * libvlc_thumbnailer_Destroy() on the worker thread itself. The worker
+ * flags itself unjoinable around those releases; Destroy then leaves the
+ * thread to exit and free its own state instead of joining it.
+ **************************************************************************/
+
+#define THUMBNAIL_TIMEOUT (10 * CLOCK_FREQ)
+
+typedef struct libvlc_thumbnail_request_t
+{
+    libvlc_media_t *p_md;
+    float           f_position;
+    unsigned        i_width, i_height;
+    char           *psz_path;
+    struct libvlc_thumbnail_request_t *p_next;
+} libvlc_thumbnail_request_t;
+
+struct libvlc_thumbnailer_t
+{
+    libvlc_instance_t *p_instance;
+    vlc_thread_t    thread;
+    vlc_mutex_t     lock;
+    vlc_cond_t      wait;
+    bool            b_dead;
+    /* True while the worker releases references that may tear the
+     * instance down; tells Destroy not to join (see above). */
+    bool            b_unjoinable;
+    /* Set by Destroy when it could not join: the worker then frees the
+     * thumbnailer itself on exit. */
+    bool            b_orphan;
+    libvlc_thumbnail_request_t *p_queue;
+    libvlc_thumbnail_request_t **pp_queue_last;
+
+    /* Capture state of the request being processed. p_pic is written by
+     * the format callback and read by the video callbacks from the vout
+     * thread, which is gone by the time the worker encodes it. */
+    libvlc_thumbnail_request_t *p_current;
+    picture_t      *p_pic;
+    bool            b_done;
+};
+
+static unsigned thumbnailer_setup( void **pp_opaque, char *psz_chroma,
+                                   unsigned *pi_width, unsigned *pi_height,
+                                   unsigned *pi_pitches, unsigned *pi_lines )
+{
+    struct libvlc_thumbnailer_t *p_t = *pp_opaque;
+    unsigned i_width = p_t->p_current->i_width;
+    unsigned i_height = p_t->p_current->i_height;
+    video_format_t fmt;
+
+    if( i_width != 0 )
+        *pi_width = i_width;
+    if( i_height != 0 )
+        *pi_height = i_height;
+    memcpy( psz_chroma, "RV32", 4 );
+
+    video_format_Init( &fmt, VLC_CODEC_RGB32 );
+    video_format_Setup( &fmt, VLC_CODEC_RGB32, *pi_width, *pi_height,
+                        *pi_width, *pi_height, 1, 1 );
+    p_t->p_pic = picture_NewFromFormat( &fmt );
+    if( p_t->p_pic == NULL )
+        return 0;
+
+    pi_pitches[0] = p_t->p_pic->p[0].i_pitch;
+    pi_lines[0] = p_t->p_pic->p[0].i_lines;
+    return 1;
+}
+
+static void *thumbnailer_lock( void *p_opaque, void **pp_planes )
+{
+    struct libvlc_thumbnailer_t *p_t = p_opaque;
+
+    pp_planes[0] = p_t->p_pic->p[0].p_pixels;
+    return NULL;
+}
+
+static void thumbnailer_display( void *p_opaque, void *p_id )
+{
+    struct libvlc_thumbnailer_t *p_t = p_opaque;
+
+    vlc_mutex_lock( &p_t->lock );
+    p_t->b_done = true;
+    vlc_cond_signal( &p_t->wait );
+    vlc_mutex_unlock( &p_t->lock );
+    (void) p_id;
+}
+
+/* Decode one frame of the request into p_t->p_pic.
+ * Runs on the worker thread, outside the thumbnailer lock. */
+static bool thumbnailer_decode( struct libvlc_thumbnailer_t *p_t,
+                                libvlc_media_player_t *p_mp,
+                                libvlc_thumbnail_request_t *p_req )
+{
+    libvlc_media_t *p_dup = libvlc_media_duplicate( p_req->p_md );
+    if( p_dup == NULL )
+        return false;
+
+    libvlc_media_add_option( p_dup, ":no-audio" );
+    libvlc_media_add_option( p_dup, ":no-spu" );
+    libvlc_media_add_option( p_dup, ":no-osd" );
+    libvlc_media_add_option( p_dup, ":input-fast-seek" );
+
+    /* Seek through start-time, so no frame before the target position is
+     * ever decoded. This needs the duration, parse if it is unknown. */
+    libvlc_time_t i_duration = libvlc_media_get_duration( p_dup );
+    if( i_duration <= 0 )
+    {
+        libvlc_media_parse( p_dup );
+        i_duration = libvlc_media_get_duration( p_dup );
+    }
+    if( i_duration > 0 )
+    {
+        char psz_opt[64];
+        snprintf( psz_opt, sizeof (psz_opt), ":start-time=%.3f",
+                  p_req->f_position * i_duration / 1000.f );
+        libvlc_media_add_option( p_dup, psz_opt );
+    }
+
+    libvlc_media_player_set_media( p_mp, p_dup );
+    libvlc_media_release( p_dup );
+
+    if( libvlc_media_player_play( p_mp ) )
+        return false;
+    if( i_duration <= 0 )
+        /* Best effort when the duration cannot be figured out */
+        libvlc_media_player_set_position( p_mp, p_req->f_position );
+
+    mtime_t i_deadline = mdate() + THUMBNAIL_TIMEOUT;
+
+    vlc_mutex_lock( &p_t->lock );
+    while( !p_t->b_done && mdate() < i_deadline )
+    {
+        vlc_cond_timedwait( &p_t->wait, &p_t->lock, mdate() + CLOCK_FREQ / 4 );
+        if( p_t->b_done )
+            break;
+
+        vlc_mutex_unlock( &p_t->lock );
+        libvlc_state_t state = libvlc_media_player_get_state( p_mp );
+        vlc_mutex_lock( &p_t->lock );
+        if( state == libvlc_Ended || state == libvlc_Error )
+            break;
+    }
+    bool b_done = p_t->b_done;
+    vlc_mutex_unlock( &p_t->lock );
+
+    libvlc_media_player_stop( p_mp );
+    return b_done;
+}
+
+static void *thumbnailer_thread( void *p_data )
+{
+    struct libvlc_thumbnailer_t *p_t = p_data;
+    libvlc_media_player_t *p_mp = NULL;
+    image_handler_t *p_image = NULL;
+
+    vlc_mutex_lock( &p_t->lock );
+    for( ;; )
+    {
+        while( !p_t->b_dead && p_t->p_queue == NULL )
+            vlc_cond_wait( &p_t->wait, &p_t->lock );
+        if( p_t->b_dead )
+            break;
+
+        libvlc_thumbnail_request_t *p_req = p_t->p_queue;
+        p_t->p_queue = p_req->p_next;
+        if( p_t->p_queue == NULL )
+            p_t->pp_queue_last = &p_t->p_queue;
+        p_t->p_current = p_req;
+        p_t->b_done = false;
+        p_t->p_pic = NULL;
+        vlc_mutex_unlock( &p_t->lock );
+
+        if( p_mp == NULL )
+        {
+            p_mp = libvlc_media_player_new( p_t->p_instance );
+            if( p_mp != NULL )
+            {
+                libvlc_video_set_callbacks( p_mp, thumbnailer_lock, NULL,
+                                            thumbnailer_display, p_t );
+                libvlc_video_set_format_callbacks( p_mp, thumbnailer_setup,
+                                                   NULL );
+            }
+        }
+        if( p_image == NULL )
+            p_image = image_HandlerCreate( p_t->p_instance->p_libvlc_int );
+
+        bool b_ok = p_mp != NULL && p_image != NULL
+                 && thumbnailer_decode( p_t, p_mp, p_req );
+
+        if( b_ok )
+        {
+            video_format_t fmt_out;
+            video_format_Init( &fmt_out, image_Ext2Fourcc( p_req->psz_path ) );
+            b_ok = image_WriteUrl( p_image, p_t->p_pic, &p_t->p_pic->format,
+                                   &fmt_out, p_req->psz_path ) == VLC_SUCCESS;
+            video_format_Clean( &fmt_out );
+        }
+        if( p_t->p_pic != NULL )
+        {
+            picture_Release( p_t->p_pic );
+            p_t->p_pic = NULL;
+        }
+
+        /* Drop the reused player and encoder when the queue drains: they
+         * pin resources (and the player a reference on the instance) that
+         * must not outlive the completion event of the last request. */
+        vlc_mutex_lock( &p_t->lock );
+        bool b_idle = p_t->p_queue == NULL;
+        p_t->p_current = NULL;
+        p_t->b_unjoinable = true;
+        vlc_mutex_unlock( &p_t->lock );
+        if( b_idle )
+        {
+            if( p_mp != NULL )
+            {
+                libvlc_media_player_release( p_mp );
+                p_mp = NULL;
+            }
+            if( p_image != NULL )
+            {
+                image_HandlerDelete( p_image );
+                p_image = NULL;
+            }
+        }
+
+        /* Send the event while still holding our media reference: if the
+         * application already released its handle, ours is the last one and
+         * releasing first would free the event manager under the send (same
+         * order libvlc_media_release() uses for libvlc_MediaFreed). The
+         * release may then drop the last instance reference and re-enter
+         * libvlc_thumbnailer_Destroy() right here, which is why
+         * b_unjoinable was raised above; past this point only p_t may be
+         * touched, never the instance. The player release above is under
+         * the same cover, it pins an instance reference too. */
+        libvlc_event_t event;
+        event.type = libvlc_MediaThumbnailGenerated;
+        event.u.media_thumbnail_generated.psz_path = b_ok ? p_req->psz_path
+                                                          : NULL;
+        libvlc_event_send( p_req->p_md->p_event_manager, &event );
+
+        libvlc_media_release( p_req->p_md );
+
+        free( p_req->psz_path );
+        free( p_req );
+        vlc_mutex_lock( &p_t->lock );
+        p_t->b_unjoinable = false;
+    }
+    bool b_orphan = p_t->b_orphan;
+    vlc_mutex_unlock( &p_t->lock );
+
+    if( p_mp != NULL )
+        libvlc_media_player_release( p_mp );
+    if( p_image != NULL )
+        image_HandlerDelete( p_image );
+    if( b_orphan )
+    {   /* Destroy could not join us, reclaim our own state. */
+        vlc_cond_destroy( &p_t->wait );
+        vlc_mutex_destroy( &p_t->lock );
+        free( p_t );
+    }
+    return NULL;
+}
+
+static struct libvlc_thumbnailer_t *
+thumbnailer_get( libvlc_instance_t *p_inst )
+{
+    struct libvlc_thumbnailer_t *p_t;
+
+    vlc_mutex_lock( &p_inst->instance_lock );
+    p_t = p_inst->p_thumbnailer;
+    if( p_t == NULL )
+    {
+        p_t = malloc( sizeof (*p_t) );
+        if( likely(p_t != NULL) )
+        {
+            p_t->p_instance = p_inst;
+            vlc_mutex_init( &p_t->lock );
+            vlc_cond_init( &p_t->wait );
+            p_t->b_dead = false;
+            p_t->b_unjoinable = false;
+            p_t->b_orphan = false;
+            p_t->p_queue = NULL;
+            p_t->pp_queue_last = &p_t->p_queue;
+            p_t->p_current = NULL;
+            p_t->p_pic = NULL;
+
+            if( vlc_clone( &p_t->thread, thumbnailer_thread, p_t,
+                           VLC_THREAD_PRIORITY_LOW ) )
+            {
+                vlc_cond_destroy( &p_t->wait );
+                vlc_mutex_destroy( &p_t->lock );
+                free( p_t );
+                p_t = NULL;
+            }
+            else
+                p_inst->p_thumbnailer = p_t;
+        }
+    }
+    vlc_mutex_unlock( &p_inst->instance_lock );
+    return p_t;
+}
+
+/* Called with the last instance reference, see lib/core.c */
+void libvlc_thumbnailer_Destroy( libvlc_instance_t *p_instance )
+{
+    struct libvlc_thumbnailer_t *p_t = p_instance->p_thumbnailer;
+
+    if( p_t == NULL )
+        return;
+
+    vlc_mutex_lock( &p_t->lock );
+    p_t->b_dead = true;
+    vlc_cond_signal( &p_t->wait );
+
+    /* Pending requests hold media, thus instance, references; with the
+     * last reference gone the queue can only be empty. */
+    assert( p_t->p_queue == NULL );
+
+    if( p_t->b_unjoinable )
+    {
+        /* The worker is releasing its completion references and one of
+         * them was the last instance reference, so this is running on the
+         * worker thread itself (or racing with its final releases) and
+         * joining could deadlock on ourselves. Leave the thread to exit
+         * and free the thumbnailer on its own instead. */
+        p_t->b_orphan = true;
+        vlc_mutex_unlock( &p_t->lock );
+    }
+    else
+    {
+        vlc_mutex_unlock( &p_t->lock );
+        vlc_join( p_t->thread, NULL );
+        vlc_cond_destroy( &p_t->wait );
+        vlc_mutex_destroy( &p_t->lock );
+        free( p_t );
+    }
+    p_instance->p_thumbnailer = NULL;
+}
+
+/**************************************************************************
+ * Request a thumbnail of the media (Public)
+ **************************************************************************/
+int libvlc_media_thumbnail_request( libvlc_instance_t *p_inst,
+                                    libvlc_media_t *p_md, float f_position,
+                                    unsigned i_width, unsigned i_height,
+                                    const char *psz_filepath )
+{
+    assert( p_md );
+    assert( psz_filepath );
+
+    if( image_Ext2Fourcc( psz_filepath ) == 0 )
+    {
+        libvlc_printerr( "Unsupported thumbnail image type" );
+        return -1;
+    }
+
+    struct libvlc_thumbnailer_t *p_t = thumbnailer_get( p_inst );
+    if( p_t == NULL )
+    {
+        libvlc_printerr( "Not enough memory" );
+        return -1;
+    }
+
+    libvlc_thumbnail_request_t *p_req = malloc( sizeof (*p_req) );
+    if( unlikely(p_req == NULL) )
+        goto error;
+    p_req->psz_path = strdup( psz_filepath );
+    if( unlikely(p_req->psz_path == NULL) )
+    {
+        free( p_req );
+        goto error;
+    }
+
+    libvlc_media_retain( p_md );
+    p_req->p_md = p_md;
+    p_req->f_position = VLC_CLIP( f_position, 0.f, 1.f );
+    p_req->i_width = i_width;
+    p_req->i_height = i_height;
+    p_req->p_next = NULL;
+
+    vlc_mutex_lock( &p_t->lock );
+    *p_t->pp_queue_last = p_req;
+    p_t->pp_queue_last = &p_req->p_next;
+    vlc_cond_signal( &p_t->wait );
+    vlc_mutex_unlock( &p_t->lock );
+    return 0;
+
+error:
+    libvlc_printerr( "Not enough memory" );
+    return -1;
+}
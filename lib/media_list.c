@@ -378,6 +378,57 @@ void libvlc_media_list_internal_insert_media( libvlc_media_list_t * p_mlist,
     notify_item_addition( p_mlist, p_md, index, EventDidHappen );
 }
 
+/**************************************************************************
+ *       libvlc_media_list_insert_media_array (Public)
+ *
+ * Lock should be held when entering.
+ **************************************************************************/
+int libvlc_media_list_insert_media_array( libvlc_media_list_t * p_mlist,
+                                          libvlc_media_t * const * pp_mds,
+                                          int i_count,
+                                          int index )
+{
+    vlc_array_t * p_items = &p_mlist->items;
+    void ** pp_elems;
+
+    if( !mlist_is_writable(p_mlist) )
+        return -1;
+    if( index < 0 || index > vlc_array_count( p_items ) )
+    {
+        libvlc_printerr( "Index out of bounds" );
+        return -1;
+    }
+    if( i_count <= 0 )
+        return 0;
+
+    /* Grow and shift the storage once for the whole batch, instead of a
+     * realloc and a memmove per item. */
+    pp_elems = realloc( p_items->pp_elems,
+                        ( p_items->i_count + i_count ) * sizeof( void * ) );
+    if( unlikely(pp_elems == NULL) )
+    {
+        libvlc_printerr( "Not enough memory" );
+        return -1;
+    }
+    p_items->pp_elems = pp_elems;
+
+    /* A single event pair describes the whole batch: listeners get the
+     * first inserted item and index, and should requery the list. */
+    notify_item_addition( p_mlist, pp_mds[0], index, EventWillHappen );
+
+    memmove( pp_elems + index + i_count, pp_elems + index,
+             ( p_items->i_count - index ) * sizeof( void * ) );
+    for( int i = 0; i < i_count; i++ )
+    {
+        libvlc_media_retain( pp_mds[i] );
+        pp_elems[index + i] = pp_mds[i];
+    }
+    p_items->i_count += i_count;
+
+    notify_item_addition( p_mlist, pp_mds[0], index, EventDidHappen );
+    return 0;
+}
+
 /**************************************************************************
  *       libvlc_media_list_remove_index (Public)
  *
@@ -413,6 +464,46 @@ int libvlc_media_list_internal_remove_index( libvlc_media_list_t * p_mlist,
     return 0;
 }
 
+/**************************************************************************
+ *       libvlc_media_list_remove_index_range (Public)
+ *
+ * Lock should be held when entering.
+ **************************************************************************/
+int libvlc_media_list_remove_index_range( libvlc_media_list_t * p_mlist,
+                                          int index,
+                                          int i_count )
+{
+    vlc_array_t * p_items = &p_mlist->items;
+    libvlc_media_t * p_md;
+
+    if( !mlist_is_writable(p_mlist) )
+        return -1;
+    if( index < 0 || i_count < 0
+     || index + i_count > vlc_array_count( p_items ) )
+    {
+        libvlc_printerr( "Index out of bounds" );
+        return -1;
+    }
+    if( i_count == 0 )
+        return 0;
+
+    p_md = vlc_array_item_at_index( p_items, index );
+
+    /* As for bulk insertion, a single event pair covers the batch. */
+    notify_item_deletion( p_mlist, p_md, index, EventWillHappen );
+
+    for( int i = 1; i < i_count; i++ )
+        libvlc_media_release( vlc_array_item_at_index( p_items, index + i ) );
+    memmove( p_items->pp_elems + index, p_items->pp_elems + index + i_count,
+             ( p_items->i_count - index - i_count ) * sizeof( void * ) );
+    p_items->i_count -= i_count;
+
+    notify_item_deletion( p_mlist, p_md, index, EventDidHappen );
+    /* Keep the item carried by the events alive until they are delivered */
+    libvlc_media_release( p_md );
+    return 0;
+}
+
 /**************************************************************************
  *       libvlc_media_list_item_at_index (Public)
  *
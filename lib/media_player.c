@@ -125,12 +125,28 @@ static inline void unlock_input(libvlc_media_player_t *mp)
 }
 
 /*
- * Release the associated input thread.
+ * Join a previously detached input thread, if any.
+ *
+ * Input lock is held or instance is being destroyed.
+ */
+static void drain_zombie_input_thread( libvlc_media_player_t *p_mi )
+{
+    if( p_mi->input.p_thread_zombie == NULL )
+        return;
+    input_Close( p_mi->input.p_thread_zombie );
+    p_mi->input.p_thread_zombie = NULL;
+}
+
+/*
+ * Stop the associated input thread but defer the blocking join until
+ * drain_zombie_input_thread(), so that changing media does not stall the
+ * caller while the old input finishes shutting down. The vout and aout
+ * are handed back through the input resource as usual once it dies.
  *
  * Object lock is NOT held.
  * Input lock is held or instance is being destroyed.
  */
-static void release_input_thread( libvlc_media_player_t *p_mi )
+static void detach_input_thread( libvlc_media_player_t *p_mi )
 {
     assert( p_mi );
 
@@ -151,7 +167,21 @@ static void release_input_thread( libvlc_media_player_t *p_mi )
 
     /* We owned this one */
     input_Stop( p_input_thread );
-    input_Close( p_input_thread );
+
+    drain_zombie_input_thread( p_mi );
+    p_mi->input.p_thread_zombie = p_input_thread;
+}
+
+/*
+ * Release the associated input thread, waiting for it to terminate.
+ *
+ * Object lock is NOT held.
+ * Input lock is held or instance is being destroyed.
+ */
+static void release_input_thread( libvlc_media_player_t *p_mi )
+{
+    detach_input_thread( p_mi );
+    drain_zombie_input_thread( p_mi );
 }
 
 /*
@@ -578,6 +608,7 @@ libvlc_media_player_new( libvlc_instance_t *instance )
     var_Create (mp, "vmem-unlock", VLC_VAR_ADDRESS);
     var_Create (mp, "vmem-display", VLC_VAR_ADDRESS);
     var_Create (mp, "vmem-data", VLC_VAR_ADDRESS);
+    var_Create (mp, "vmem-lend", VLC_VAR_ADDRESS);
     var_Create (mp, "vmem-setup", VLC_VAR_ADDRESS);
     var_Create (mp, "vmem-cleanup", VLC_VAR_ADDRESS);
     var_Create (mp, "vmem-chroma", VLC_VAR_STRING | VLC_VAR_DOINHERIT);
@@ -674,6 +705,7 @@ libvlc_media_player_new( libvlc_instance_t *instance )
     mp->state = libvlc_NothingSpecial;
     mp->p_libvlc_instance = instance;
     mp->input.p_thread = NULL;
+    mp->input.p_thread_zombie = NULL;
     mp->input.p_resource = input_resource_New(VLC_OBJECT(mp));
     if (unlikely(mp->input.p_resource == NULL))
     {
@@ -752,8 +784,7 @@ static void libvlc_media_player_destroy( libvlc_media_player_t *p_mi )
     var_DelCallback( p_mi, "corks", corks_changed, NULL );
 
     /* No need for lock_input() because no other threads knows us anymore */
-    if( p_mi->input.p_thread )
-        release_input_thread(p_mi);
+    release_input_thread(p_mi);
     input_resource_Terminate( p_mi->input.p_resource );
     input_resource_Release( p_mi->input.p_resource );
     vlc_mutex_destroy( &p_mi->input.lock );
@@ -810,7 +841,9 @@ void libvlc_media_player_set_media(
 {
     lock_input(p_mi);
 
-    release_input_thread( p_mi );
+    /* The old input keeps shutting down in the background; it is joined
+     * before the next input is created */
+    detach_input_thread( p_mi );
 
     lock( p_mi );
     set_state( p_mi, libvlc_NothingSpecial, true );
@@ -915,6 +948,9 @@ int libvlc_media_player_play( libvlc_media_player_t *p_mi )
         return -1;
     }
 
+    /* Make sure a previously detached input has given its resources back */
+    drain_zombie_input_thread( p_mi );
+
     p_input_thread = input_Create( p_mi, p_mi->p_md->p_input_item, NULL,
                                    p_mi->input.p_resource );
     unlock(p_mi);
@@ -1036,6 +1072,22 @@ void libvlc_video_set_callbacks( libvlc_media_player_t *mp,
     var_SetString( mp, "window", "none" );
 }
 
+void libvlc_video_set_lend_callbacks( libvlc_media_player_t *mp,
+                                      libvlc_video_lend_cb lend,
+                                      void *opaque )
+{
+    var_SetAddress( mp, "vmem-lend", lend );
+    var_SetAddress( mp, "vmem-data", opaque );
+    var_SetString( mp, "avcodec-hw", "none" );
+    var_SetString( mp, "vout", "vmem" );
+    var_SetString( mp, "window", "none" );
+}
+
+void libvlc_video_release_picture( void *picture )
+{
+    picture_Release( picture );
+}
+
 void libvlc_video_set_format_callbacks( libvlc_media_player_t *mp,
                                         libvlc_video_format_cb setup,
                                         libvlc_video_cleanup_cb cleanup )
@@ -1679,6 +1731,32 @@ libvlc_state_t libvlc_media_player_get_state( libvlc_media_player_t *p_mi )
     return state;
 }
 
+void libvlc_media_player_get_state_snapshot( libvlc_media_player_t *p_mi,
+                                             libvlc_time_t *p_time,
+                                             float *p_position,
+                                             libvlc_state_t *p_state )
+{
+    input_thread_t *p_input_thread;
+
+    lock(p_mi);
+    *p_state = p_mi->state;
+    unlock(p_mi);
+
+    /* Fetch the input thread only once so time and position come from the
+     * same input, even if the media changes concurrently. */
+    p_input_thread = libvlc_get_input_thread( p_mi );
+    if( !p_input_thread )
+    {
+        *p_time = -1;
+        *p_position = -1.f;
+        return;
+    }
+
+    *p_time = from_mtime( var_GetInteger( p_input_thread, "time" ) );
+    *p_position = var_GetFloat( p_input_thread, "position" );
+    vlc_object_release( p_input_thread );
+}
+
 int libvlc_media_player_is_seekable( libvlc_media_player_t *p_mi )
 {
     input_thread_t *p_input_thread;
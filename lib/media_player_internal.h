@@ -46,6 +46,8 @@ struct libvlc_media_player_t
     struct
     {
         input_thread_t   *p_thread;
+        /* stopped input whose join was deferred, see detach_input_thread() */
+        input_thread_t   *p_thread_zombie;
         input_resource_t *p_resource;
         vlc_mutex_t       lock;
     } input;
@@ -62,7 +62,7 @@ vlc_module_end()
 /*****************************************************************************
  * Local prototypes
  *****************************************************************************/
-static ssize_t Read   (access_t *, uint8_t *, size_t);
+static block_t *Block (access_t *);
 static int     Seek   (access_t *, uint64_t);
 static int     Control(access_t *, int, va_list);
 static ssize_t Write(sout_access_out_t *, block_t *);
@@ -194,11 +194,13 @@ int OpenAvio(vlc_object_t *object)
 #endif
     msg_Dbg(access, "%sseekable, size=%"PRIi64, seekable ? "" : "not ", size);
 
+    sys->size = size;
+
     /* */
     access_InitFields(access);
 
-    access->pf_read = Read;
-    access->pf_block = NULL;
+    access->pf_read = NULL;
+    access->pf_block = Block;
     access->pf_control = Control;
     access->pf_seek = Seek;
     access->p_sys = sys;
@@ -303,14 +305,26 @@ void OutCloseAvio(vlc_object_t *object)
     free(sys);
 }
 
-static ssize_t Read(access_t *access, uint8_t *data, size_t size)
+/* At least as large as the avio internal buffer: once that buffer is
+ * drained, libavformat serves requests of a full buffer size or more
+ * straight from the protocol into the destination, so reads land in the
+ * block without transiting avio's own buffer */
+#define AVIO_BLOCK_SIZE 65536
+
+static block_t *Block(access_t *access)
 {
-    int r = avio_read(access->p_sys->context, data, size);
+    block_t *block = block_Alloc(AVIO_BLOCK_SIZE);
+    if (!block)
+        return NULL;
+
+    int r = avio_read(access->p_sys->context, block->p_buffer, block->i_buffer);
     if (r <= 0) {
         access->info.b_eof = true;
-        r = 0;
+        block_Release(block);
+        return NULL;
     }
-    return r;
+    block->i_buffer = r;
+    return block;
 }
 
 /*****************************************************************************
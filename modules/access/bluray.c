@@ -191,6 +191,9 @@ struct  demux_sys_t
 
     /* stream input */
     vlc_mutex_t         read_block_lock;
+    uint8_t             *p_read_cache;       /* readahead for block reads */
+    int64_t             i_read_cache_lba;    /* first cached block, -1: none */
+    int                 i_read_cache_blocks;
 
     /* Used to store bluray disc path */
     char                *psz_bd_path;
@@ -510,6 +513,11 @@ static int probeStream(demux_t *p_demux)
 }
 
 #ifdef BLURAY_DEMUX
+/* Blocks read ahead per stream access. libbluray requests a few aligned
+ * blocks at a time; fetching a larger span at once and serving the following
+ * requests from memory spares the underlying device one seek per request. */
+#define BD_READ_CACHE_BLOCKS 128
+
 static int blurayReadBlock(void *object, void *buf, int lba, int num_blocks)
 {
     demux_t *p_demux = (demux_t*)object;
@@ -520,18 +528,59 @@ static int blurayReadBlock(void *object, void *buf, int lba, int num_blocks)
 
     vlc_mutex_lock(&p_sys->read_block_lock);
 
-    if (stream_Seek( p_demux->s, lba * INT64_C(2048) ) == VLC_SUCCESS) {
-        size_t  req = (size_t)2048 * num_blocks;
-        ssize_t got;
+    if (p_sys->p_read_cache == NULL)
+        p_sys->p_read_cache = malloc((size_t)2048 * BD_READ_CACHE_BLOCKS);
+
+    if (p_sys->p_read_cache == NULL || num_blocks > BD_READ_CACHE_BLOCKS) {
+        /* No cache memory or oversized request: read straight through */
+        if (stream_Seek( p_demux->s, lba * INT64_C(2048) ) == VLC_SUCCESS) {
+            size_t  req = (size_t)2048 * num_blocks;
+            ssize_t got;
 
-        got = stream_Read( p_demux->s, buf, req);
-        if (got < 0) {
-            msg_Err(p_demux, "read from lba %d failed", lba);
+            got = stream_Read( p_demux->s, buf, req);
+            if (got < 0) {
+                msg_Err(p_demux, "read from lba %d failed", lba);
+            } else {
+                result = got / 2048;
+            }
         } else {
-            result = got / 2048;
+           msg_Err(p_demux, "seek to lba %d failed", lba);
         }
-    } else {
-       msg_Err(p_demux, "seek to lba %d failed", lba);
+
+        vlc_mutex_unlock(&p_sys->read_block_lock);
+
+        return result;
+    }
+
+    if (lba < p_sys->i_read_cache_lba ||
+        lba + num_blocks >
+            p_sys->i_read_cache_lba + p_sys->i_read_cache_blocks) {
+        /* Refill the cache window from the requested block onwards */
+        p_sys->i_read_cache_lba = -1;
+        p_sys->i_read_cache_blocks = 0;
+
+        if (stream_Seek( p_demux->s, lba * INT64_C(2048) ) == VLC_SUCCESS) {
+            ssize_t got = stream_Read( p_demux->s, p_sys->p_read_cache,
+                                       (size_t)2048 * BD_READ_CACHE_BLOCKS );
+            if (got < 0) {
+                msg_Err(p_demux, "read from lba %d failed", lba);
+            } else {
+                p_sys->i_read_cache_lba = lba;
+                p_sys->i_read_cache_blocks = got / 2048;
+            }
+        } else {
+           msg_Err(p_demux, "seek to lba %d failed", lba);
+        }
+    }
+
+    if (p_sys->i_read_cache_lba >= 0) {
+        /* Serve from the cache (possibly short near the end of stream) */
+        int avail = p_sys->i_read_cache_lba + p_sys->i_read_cache_blocks - lba;
+
+        result = __MIN(num_blocks, avail);
+        memcpy(buf, p_sys->p_read_cache
+                    + (size_t)2048 * (lba - p_sys->i_read_cache_lba),
+               (size_t)2048 * result);
     }
 
     vlc_mutex_unlock(&p_sys->read_block_lock);
@@ -668,6 +717,7 @@ static int blurayOpen(vlc_object_t *object)
     vlc_mutex_init(&p_sys->pl_info_lock);
     vlc_mutex_init(&p_sys->bdj_overlay_lock);
     vlc_mutex_init(&p_sys->read_block_lock); /* used during bd_open_stream() */
+    p_sys->i_read_cache_lba = -1;
 
     var_AddCallback( p_demux->p_input, "intf-event", onIntfEvent, p_demux );
 
@@ -900,6 +950,7 @@ static void blurayClose(vlc_object_t *object)
     vlc_mutex_destroy(&p_sys->bdj_overlay_lock);
     vlc_mutex_destroy(&p_sys->read_block_lock);
 
+    free(p_sys->p_read_cache);
     free(p_sys->psz_bd_path);
     free(p_sys);
 }
@@ -1085,6 +1136,7 @@ static es_out_t *esOutNew(demux_t *p_demux)
     p_out->pf_del       = esOutDel;
     p_out->pf_destroy   = esOutDestroy;
     p_out->pf_send      = esOutSend;
+    p_out->pf_send_batch = NULL;
 
     p_out->p_sys = malloc(sizeof(*p_out->p_sys));
     if (unlikely(p_out->p_sys == NULL)) {
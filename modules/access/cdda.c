@@ -90,6 +90,11 @@ vlc_module_end ()
 #define CDDA_BLOCKS_ONCE 20
 #define CDDA_DATA_ONCE   (CDDA_BLOCKS_ONCE * CDDA_DATA_SIZE)
 
+/* Sectors fetched from the drive per command. A physical drive takes far
+ * longer to position its pickup than to read, so one large window is read
+ * at once and seeks within it are then served from memory. */
+#define CDDA_CACHE_BLOCKS 64
+
 /*****************************************************************************
  * Access: local prototypes
  *****************************************************************************/
@@ -102,6 +107,11 @@ struct access_sys_t
     int         i_sector;                                  /* Current Sector */
     int        *p_sectors;                                  /* Track sectors */
 
+    /* Sector cache (allocated on first read) */
+    uint8_t    *p_cache;
+    int         i_cache_first;     /* first cached sector (count == 0: none) */
+    int         i_cache_count;
+
     /* Wave header for the output data */
     WAVEHEADER  waveheader;
     bool        b_header;
@@ -249,6 +259,7 @@ static void Close( vlc_object_t *p_this )
     access_t     *p_access = (access_t *)p_this;
     access_sys_t *p_sys = p_access->p_sys;
 
+    free( p_sys->p_cache );
     free( p_sys->p_sectors );
     ioctl_Close( p_this, p_sys->vcddev );
     free( p_sys );
@@ -287,7 +298,55 @@ static block_t *Block( access_t *p_access )
     if( p_sys->i_sector + i_blocks >= p_sys->i_last_sector )
         i_blocks = p_sys->i_last_sector - p_sys->i_sector;
 
-    /* Do the actual reading */
+    if( p_sys->p_cache == NULL )
+        p_sys->p_cache = malloc( CDDA_CACHE_BLOCKS * CDDA_DATA_SIZE );
+
+    if( p_sys->p_cache != NULL )
+    {
+        /* Refill the sector cache if the current sector lies outside it */
+        if( p_sys->i_sector < p_sys->i_cache_first ||
+            p_sys->i_sector >= p_sys->i_cache_first + p_sys->i_cache_count )
+        {
+            int i_want = CDDA_CACHE_BLOCKS;
+            if( p_sys->i_sector + i_want >= p_sys->i_last_sector )
+                i_want = p_sys->i_last_sector - p_sys->i_sector;
+
+            if( ioctl_ReadSectors( VLC_OBJECT(p_access), p_sys->vcddev,
+                    p_sys->i_sector, p_sys->p_cache, i_want, CDDA_TYPE ) < 0 )
+            {
+                msg_Err( p_access, "cannot read sector %i", p_sys->i_sector );
+                p_sys->i_cache_count = 0;
+
+                /* Try to skip one sector (in case of bad sectors) */
+                p_sys->i_sector++;
+                return NULL;
+            }
+            p_sys->i_cache_first = p_sys->i_sector;
+            p_sys->i_cache_count = i_want;
+        }
+
+        /* Serve from the cache */
+        if( p_sys->i_sector + i_blocks >
+            p_sys->i_cache_first + p_sys->i_cache_count )
+            i_blocks = p_sys->i_cache_first + p_sys->i_cache_count
+                     - p_sys->i_sector;
+
+        if( !( p_block = block_Alloc( i_blocks * CDDA_DATA_SIZE ) ) )
+        {
+            msg_Err( p_access, "cannot get a new block of size: %i",
+                     i_blocks * CDDA_DATA_SIZE );
+            return NULL;
+        }
+        memcpy( p_block->p_buffer,
+                p_sys->p_cache + (size_t)(p_sys->i_sector
+                                          - p_sys->i_cache_first)
+                               * CDDA_DATA_SIZE,
+                i_blocks * CDDA_DATA_SIZE );
+        p_sys->i_sector += i_blocks;
+        return p_block;
+    }
+
+    /* Degraded mode without cache memory: read straight into the block */
     if( !( p_block = block_Alloc( i_blocks * CDDA_DATA_SIZE ) ) )
     {
         msg_Err( p_access, "cannot get a new block of size: %i",
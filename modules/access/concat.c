@@ -35,9 +35,15 @@ struct access_entry
     char mrl[1];
 };
 
+/* Bytes prefetched from the next child, handed over at the boundary */
+#define PREFETCH_SIZE 65536
+
 struct access_sys_t
 {
     access_t *access;
+    access_t *ahead; /* pre-opened next child */
+    block_t *ahead_block; /* data prefetched from ahead */
+    block_t *pending; /* prefetched data not yet returned */
     struct access_entry *next;
     struct access_entry *first;
     bool can_seek;
@@ -48,6 +54,52 @@ struct access_sys_t
     int64_t caching;
 };
 
+/* Pre-opens the next child access and prefetches an initial buffer from it,
+ * so that the file transition waits for neither the open nor the first read
+ * round-trip. */
+static void PrefetchNext(access_t *access)
+{
+    access_sys_t *sys = access->p_sys;
+
+    if (sys->ahead != NULL || sys->next == NULL)
+        return;
+
+    access_t *a = vlc_access_NewMRL(VLC_OBJECT(access), sys->next->mrl);
+    if (a == NULL)
+        return; /* retried, and the error reported, at the boundary */
+
+    sys->ahead = a;
+    sys->next = sys->next->next;
+
+    assert(sys->ahead_block == NULL);
+
+    if (a->pf_block != NULL)
+        sys->ahead_block = vlc_access_Block(a);
+    else if (a->pf_read != NULL)
+    {
+        block_t *block = block_Alloc(PREFETCH_SIZE);
+        if (likely(block != NULL))
+        {
+            ssize_t ret = vlc_access_Read(a, block->p_buffer,
+                                          block->i_buffer);
+            if (ret > 0)
+                block->i_buffer = ret;
+            else
+            {
+                block_Release(block);
+                block = NULL;
+            }
+            sys->ahead_block = block;
+        }
+    }
+
+    if (sys->ahead_block != NULL && sys->ahead_block->i_buffer == 0)
+    {
+        block_Release(sys->ahead_block);
+        sys->ahead_block = NULL;
+    }
+}
+
 static access_t *GetAccess(access_t *access)
 {
     access_sys_t *sys = access->p_sys;
@@ -62,6 +114,18 @@ static access_t *GetAccess(access_t *access)
         sys->access = NULL;
     }
 
+    if (sys->ahead != NULL)
+    {   /* Hand over the pre-opened next access and its prefetched data */
+        a = sys->ahead;
+        sys->ahead = NULL;
+        if (sys->pending != NULL)
+            block_Release(sys->pending);
+        sys->pending = sys->ahead_block;
+        sys->ahead_block = NULL;
+        sys->access = a;
+        return a;
+    }
+
     if (sys->next == NULL)
     {
 error:
@@ -80,6 +144,7 @@ error:
 
 static ssize_t Read(access_t *access, uint8_t *buf, size_t len)
 {
+    access_sys_t *sys = access->p_sys;
     access_t *a = GetAccess(access);
     if (a == NULL)
         return 0;
@@ -93,15 +158,43 @@ static ssize_t Read(access_t *access, uint8_t *buf, size_t len)
         return 0;
     }
 
+    PrefetchNext(access);
+
+    block_t *pending = sys->pending;
+    if (pending != NULL)
+    {   /* Drain the buffer prefetched across the last file boundary */
+        if (len > pending->i_buffer)
+            len = pending->i_buffer;
+        memcpy(buf, pending->p_buffer, len);
+        pending->p_buffer += len;
+        pending->i_buffer -= len;
+        if (pending->i_buffer == 0)
+        {
+            block_Release(pending);
+            sys->pending = NULL;
+        }
+        return len;
+    }
+
     return vlc_access_Read(a, buf, len);
 }
 
 static block_t *Block(access_t *access)
 {
+    access_sys_t *sys = access->p_sys;
     access_t *a = GetAccess(access);
     if (a == NULL)
         return NULL;
 
+    PrefetchNext(access);
+
+    block_t *pending = sys->pending;
+    if (pending != NULL)
+    {   /* Hand the prefetched buffer over as is - no copy */
+        sys->pending = NULL;
+        return pending;
+    }
+
     if (likely(a->pf_block != NULL))
         return vlc_access_Block(a);
 
@@ -136,6 +229,21 @@ static int Seek(access_t *access, uint64_t position)
         vlc_access_Delete(sys->access);
         sys->access = NULL;
     }
+    if (sys->ahead != NULL)
+    {
+        vlc_access_Delete(sys->ahead);
+        sys->ahead = NULL;
+    }
+    if (sys->ahead_block != NULL)
+    {
+        block_Release(sys->ahead_block);
+        sys->ahead_block = NULL;
+    }
+    if (sys->pending != NULL)
+    {
+        block_Release(sys->pending);
+        sys->pending = NULL;
+    }
 
     sys->next = sys->first;
 
@@ -226,6 +334,9 @@ static int Open(vlc_object_t *obj)
     bool read_cb = true;
 
     sys->access = NULL;
+    sys->ahead = NULL;
+    sys->ahead_block = NULL;
+    sys->pending = NULL;
     sys->can_seek = true;
     sys->can_seek_fast = true;
     sys->can_pause = true;
@@ -316,6 +427,12 @@ static void Close(vlc_object_t *obj)
 
     if (sys->access != NULL)
         vlc_access_Delete(sys->access);
+    if (sys->ahead != NULL)
+        vlc_access_Delete(sys->ahead);
+    if (sys->ahead_block != NULL)
+        block_Release(sys->ahead_block);
+    if (sys->pending != NULL)
+        block_Release(sys->pending);
 
     for (struct access_entry *e = sys->first, *next; e != NULL; e = next)
     {
@@ -113,54 +113,102 @@ void DirClose(vlc_object_t *obj)
     free(sys);
 }
 
+/* On POSIX systems, readdir() batches directory entries (getdents) and most
+ * file systems report each entry's type along with its name, sparing one
+ * stat() round-trip per entry - those round-trips dominate the enumeration
+ * time of large directories on network mounts. Entries whose type is not
+ * reported (DT_UNKNOWN) or needs resolving (symbolic links) still take the
+ * stat() path. */
+#if defined (_DIRENT_HAVE_D_TYPE) && !defined (_WIN32) && !defined (__OS2__)
+# define DIR_HAVE_D_TYPE 1
+#endif
+
+/**
+ * Determines the item type of a directory entry from a stat() call.
+ * Returns -1 when the entry must be skipped.
+ */
+static int DirEntryTypeStat(access_t *access, const char *entry)
+{
+    access_sys_t *sys = access->p_sys;
+    struct stat st;
+
+#ifdef HAVE_OPENAT
+    if (fstatat(dirfd(sys->dir), entry, &st, 0))
+        return -1;
+#else
+    char path[PATH_MAX];
+
+    if (snprintf(path, PATH_MAX, "%s"DIR_SEP"%s", access->psz_filepath,
+                 entry) >= PATH_MAX || vlc_stat(path, &st))
+        return -1;
+#endif
+    switch (st.st_mode & S_IFMT)
+    {
+        case S_IFBLK:
+            return sys->special_files ? ITEM_TYPE_DISC : -1;
+        case S_IFCHR:
+            return sys->special_files ? ITEM_TYPE_CARD : -1;
+        case S_IFIFO:
+            return sys->special_files ? ITEM_TYPE_STREAM : -1;
+        case S_IFREG:
+            return ITEM_TYPE_FILE;
+        case S_IFDIR:
+            return ITEM_TYPE_DIRECTORY;
+        /* S_IFLNK cannot occur while following symbolic links */
+        /* S_IFSOCK cannot be opened with open()/openat() */
+        default:
+            return -1; /* ignore */
+    }
+}
+
 input_item_t *DirRead(access_t *access)
 {
     access_sys_t *sys = access->p_sys;
-    const char *entry;
 
-    while ((entry = vlc_readdir(sys->dir)) != NULL)
+    for (;;)
     {
-        struct stat st;
+        const char *entry;
         int type;
 
-#ifdef HAVE_OPENAT
-        if (fstatat(dirfd(sys->dir), entry, &st, 0))
-            continue;
-#else
-        char path[PATH_MAX];
+#ifdef DIR_HAVE_D_TYPE
+        struct dirent *ent = readdir(sys->dir);
+        if (ent == NULL)
+            break;
+        entry = ent->d_name;
 
-        if (snprintf(path, PATH_MAX, "%s"DIR_SEP"%s", access->psz_filepath,
-                     entry) >= PATH_MAX || vlc_stat(path, &st))
-            continue;
-#endif
-        switch (st.st_mode & S_IFMT)
+        switch (ent->d_type)
         {
-            case S_IFBLK:
-                if (!sys->special_files)
-                    continue;
-                type = ITEM_TYPE_DISC;
+            case DT_BLK:
+                type = sys->special_files ? ITEM_TYPE_DISC : -1;
                 break;
-            case S_IFCHR:
-                if (!sys->special_files)
-                    continue;
-                type = ITEM_TYPE_CARD;
+            case DT_CHR:
+                type = sys->special_files ? ITEM_TYPE_CARD : -1;
                 break;
-            case S_IFIFO:
-                if (!sys->special_files)
-                    continue;
-                type = ITEM_TYPE_STREAM;
+            case DT_FIFO:
+                type = sys->special_files ? ITEM_TYPE_STREAM : -1;
                 break;
-            case S_IFREG:
+            case DT_REG:
                 type = ITEM_TYPE_FILE;
                 break;
-            case S_IFDIR:
+            case DT_DIR:
                 type = ITEM_TYPE_DIRECTORY;
                 break;
-            /* S_IFLNK cannot occur while following symbolic links */
-            /* S_IFSOCK cannot be opened with open()/openat() */
-            default:
-                continue; /* ignore */
+            case DT_SOCK:
+                type = -1; /* cannot be opened with open()/openat() */
+                break;
+            default: /* DT_UNKNOWN, DT_LNK: ask stat() */
+                type = DirEntryTypeStat(access, entry);
+                break;
         }
+#else
+        entry = vlc_readdir(sys->dir);
+        if (entry == NULL)
+            break;
+
+        type = DirEntryTypeStat(access, entry);
+#endif
+        if (type == -1)
+            continue;
 
         /* Create an input item for the current entry */
         char *encoded = vlc_uri_encode(entry);
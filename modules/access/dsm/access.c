@@ -34,6 +34,7 @@
 #include <vlc_access.h>
 #include <vlc_variables.h>
 #include <vlc_keystore.h>
+#include <vlc_block.h>
 
 #include <assert.h>
 #include <string.h>
@@ -84,6 +85,12 @@ vlc_module_begin ()
 
 vlc_module_end ()
 
+/* Bytes fetched per SMB read. libdsm splits larger requests anyway, and one
+ * chunk is what Seek() may throw away at worst. */
+#define DSM_READAHEAD_CHUNK (size_t)(64 * 1024)
+/* Bytes kept ready ahead of the consumer, i.e. the pipeline depth */
+#define DSM_READAHEAD_MAX   (16 * DSM_READAHEAD_CHUNK)
+
 /*****************************************************************************
  * Local prototypes
  *****************************************************************************/
@@ -92,6 +99,8 @@ static int Seek( access_t *, uint64_t );
 static int Control( access_t *, int, va_list );
 static int BrowserInit( access_t *p_access );
 
+static void *ReadaheadThread( void * );
+
 static int get_address( access_t *p_access );
 static int login( access_t *p_access );
 static void backslash_path( vlc_url_t *p_url );
@@ -115,6 +124,28 @@ struct access_sys_t
 
     smb_fd              i_fd;               /**< SMB fd for the file we're reading */
     smb_tid             i_tid;              /**< SMB Tree ID we're connected to */
+    uint64_t            i_size;             /**< File size, fetched at Open() */
+
+    /* Readahead pipeline. libdsm only offers synchronous reads, so a worker
+     * thread keeps the next chunks on the wire while the input consumes the
+     * current one. The libdsm session is not thread safe: once the worker is
+     * running, it is the only caller of smb_fread()/smb_fseek(). */
+    struct
+    {
+        vlc_thread_t    thread;
+        vlc_mutex_t     lock;
+        vlc_cond_t      wait_data;          /**< Read() waits for a chunk */
+        vlc_cond_t      wait_space;         /**< worker waits for room */
+        block_t        *p_first;            /**< Chunks ready, FIFO order */
+        block_t       **pp_last;
+        size_t          i_buffered;         /**< Bytes queued in the FIFO */
+        uint64_t        i_seek_offset;
+        bool            b_seek;             /**< Seek requested by Seek() */
+        bool            b_eof;              /**< Server returned a zero read */
+        bool            b_error;
+        bool            b_exit;
+        bool            b_thread;           /**< Worker successfully spawned */
+    } readahead;
 
     size_t              i_browse_count;
     size_t              i_browse_idx;
@@ -188,9 +219,27 @@ static int Open( vlc_object_t *p_this )
         smb_fclose( p_sys->p_session, p_sys->i_fd );
         return BrowserInit( p_access );
     }
+    /* Cached so that Control() does not touch the session while the
+     * readahead worker owns it */
+    p_sys->i_size = smb_stat_get( st, SMB_STAT_SIZE );
 
     msg_Dbg( p_access, "Successfully opened smb://%s", p_access->psz_location );
 
+    vlc_mutex_init( &p_sys->readahead.lock );
+    vlc_cond_init( &p_sys->readahead.wait_data );
+    vlc_cond_init( &p_sys->readahead.wait_space );
+    p_sys->readahead.pp_last = &p_sys->readahead.p_first;
+    if( vlc_clone( &p_sys->readahead.thread, ReadaheadThread, p_access,
+                   VLC_THREAD_PRIORITY_INPUT ) == 0 )
+        p_sys->readahead.b_thread = true;
+    else
+    {   /* Read() falls back to synchronous reads */
+        msg_Warn( p_access, "cannot spawn readahead thread" );
+        vlc_cond_destroy( &p_sys->readahead.wait_space );
+        vlc_cond_destroy( &p_sys->readahead.wait_data );
+        vlc_mutex_destroy( &p_sys->readahead.lock );
+    }
+
     ACCESS_SET_CALLBACKS( Read, NULL, Control, Seek );
     return VLC_SUCCESS;
 
@@ -207,6 +256,20 @@ static void Close( vlc_object_t *p_this )
     access_t     *p_access = (access_t*)p_this;
     access_sys_t *p_sys = p_access->p_sys;
 
+    if( p_sys->readahead.b_thread )
+    {
+        vlc_mutex_lock( &p_sys->readahead.lock );
+        p_sys->readahead.b_exit = true;
+        vlc_cond_signal( &p_sys->readahead.wait_space );
+        vlc_mutex_unlock( &p_sys->readahead.lock );
+        vlc_join( p_sys->readahead.thread, NULL );
+
+        block_ChainRelease( p_sys->readahead.p_first );
+        vlc_cond_destroy( &p_sys->readahead.wait_space );
+        vlc_cond_destroy( &p_sys->readahead.wait_data );
+        vlc_mutex_destroy( &p_sys->readahead.lock );
+    }
+
     if( p_sys->p_ns )
         netbios_ns_destroy( p_sys->p_ns );
     if( p_sys->i_fd )
@@ -466,8 +529,24 @@ static int Seek( access_t *p_access, uint64_t i_pos )
 
     msg_Dbg( p_access, "seeking to %"PRId64, i_pos );
 
-    /* seek cannot fail in bdsm, but the subsequent read can */
-    smb_fseek(p_sys->p_session, p_sys->i_fd, i_pos, SMB_SEEK_SET);
+    if( p_sys->readahead.b_thread )
+    {
+        /* The worker owns the session: hand the seek over to it and throw
+         * away whatever was prefetched beyond the new position */
+        vlc_mutex_lock( &p_sys->readahead.lock );
+        block_ChainRelease( p_sys->readahead.p_first );
+        p_sys->readahead.p_first = NULL;
+        p_sys->readahead.pp_last = &p_sys->readahead.p_first;
+        p_sys->readahead.i_buffered = 0;
+        p_sys->readahead.i_seek_offset = i_pos;
+        p_sys->readahead.b_seek = true;
+        p_sys->readahead.b_eof = false;
+        vlc_cond_signal( &p_sys->readahead.wait_space );
+        vlc_mutex_unlock( &p_sys->readahead.lock );
+    }
+    else
+        /* seek cannot fail in bdsm, but the subsequent read can */
+        smb_fseek(p_sys->p_session, p_sys->i_fd, i_pos, SMB_SEEK_SET);
 
     p_access->info.b_eof = false;
 
@@ -484,16 +563,131 @@ static ssize_t Read( access_t *p_access, uint8_t *p_buffer, size_t i_len )
 
     if( p_access->info.b_eof ) return 0;
 
-    i_read = smb_fread( p_sys->p_session, p_sys->i_fd, p_buffer, i_len );
-    if( i_read < 0 )
+    if( !p_sys->readahead.b_thread )
     {
-        msg_Err( p_access, "read failed" );
-        return -1;
+        i_read = smb_fread( p_sys->p_session, p_sys->i_fd, p_buffer, i_len );
+        if( i_read < 0 )
+        {
+            msg_Err( p_access, "read failed" );
+            return -1;
+        }
+
+        if( i_read == 0 ) p_access->info.b_eof = true;
+
+        return i_read;
     }
 
-    if( i_read == 0 ) p_access->info.b_eof = true;
+    size_t i_copied = 0;
+
+    vlc_mutex_lock( &p_sys->readahead.lock );
+    while( p_sys->readahead.p_first == NULL
+        && !p_sys->readahead.b_eof && !p_sys->readahead.b_error )
+        vlc_cond_wait( &p_sys->readahead.wait_data, &p_sys->readahead.lock );
 
-    return i_read;
+    while( i_copied < i_len && p_sys->readahead.p_first != NULL )
+    {
+        block_t *p_block = p_sys->readahead.p_first;
+        size_t i_chunk = __MIN( i_len - i_copied, p_block->i_buffer );
+
+        memcpy( p_buffer + i_copied, p_block->p_buffer, i_chunk );
+        i_copied += i_chunk;
+        p_sys->readahead.i_buffered -= i_chunk;
+        p_block->p_buffer += i_chunk;
+        p_block->i_buffer -= i_chunk;
+        if( p_block->i_buffer == 0 )
+        {
+            p_sys->readahead.p_first = p_block->p_next;
+            if( p_sys->readahead.p_first == NULL )
+                p_sys->readahead.pp_last = &p_sys->readahead.p_first;
+            block_Release( p_block );
+        }
+    }
+
+    bool b_error = p_sys->readahead.b_error;
+    bool b_eof = p_sys->readahead.b_eof;
+
+    vlc_cond_signal( &p_sys->readahead.wait_space );
+    vlc_mutex_unlock( &p_sys->readahead.lock );
+
+    if( i_copied == 0 )
+    {
+        if( b_error )
+        {
+            msg_Err( p_access, "read failed" );
+            return -1;
+        }
+        if( b_eof )
+            p_access->info.b_eof = true;
+    }
+
+    return i_copied;
+}
+
+/* Keeps DSM_READAHEAD_MAX bytes of the file prefetched ahead of Read().
+ * All session I/O happens here once the thread is running. */
+static void *ReadaheadThread( void *p_data )
+{
+    access_t *p_access = p_data;
+    access_sys_t *p_sys = p_access->p_sys;
+
+    vlc_mutex_lock( &p_sys->readahead.lock );
+    for( ;; )
+    {
+        while( !p_sys->readahead.b_exit && !p_sys->readahead.b_seek
+            && ( p_sys->readahead.b_eof || p_sys->readahead.b_error
+              || p_sys->readahead.i_buffered >= DSM_READAHEAD_MAX ) )
+            vlc_cond_wait( &p_sys->readahead.wait_space,
+                           &p_sys->readahead.lock );
+
+        if( p_sys->readahead.b_exit )
+            break;
+
+        if( p_sys->readahead.b_seek )
+        {
+            uint64_t i_pos = p_sys->readahead.i_seek_offset;
+
+            p_sys->readahead.b_seek = false;
+            p_sys->readahead.b_error = false;
+            vlc_mutex_unlock( &p_sys->readahead.lock );
+            /* seek cannot fail in bdsm, but the subsequent read can */
+            smb_fseek( p_sys->p_session, p_sys->i_fd, i_pos, SMB_SEEK_SET );
+            vlc_mutex_lock( &p_sys->readahead.lock );
+            continue;
+        }
+
+        vlc_mutex_unlock( &p_sys->readahead.lock );
+
+        block_t *p_block = block_Alloc( DSM_READAHEAD_CHUNK );
+        int i_read = -1;
+        if( likely(p_block != NULL) )
+            i_read = smb_fread( p_sys->p_session, p_sys->i_fd,
+                                p_block->p_buffer, p_block->i_buffer );
+
+        vlc_mutex_lock( &p_sys->readahead.lock );
+        if( p_sys->readahead.b_seek || p_sys->readahead.b_exit || i_read <= 0 )
+        {
+            /* Stale chunk (issued before a seek), shutdown, EOF or error */
+            if( p_block != NULL )
+                block_Release( p_block );
+            if( !p_sys->readahead.b_seek && !p_sys->readahead.b_exit )
+            {
+                if( i_read == 0 )
+                    p_sys->readahead.b_eof = true;
+                else
+                    p_sys->readahead.b_error = true;
+                vlc_cond_signal( &p_sys->readahead.wait_data );
+            }
+            continue;
+        }
+
+        p_block->i_buffer = i_read;
+        *p_sys->readahead.pp_last = p_block;
+        p_sys->readahead.pp_last = &p_block->p_next;
+        p_sys->readahead.i_buffered += i_read;
+        vlc_cond_signal( &p_sys->readahead.wait_data );
+    }
+    vlc_mutex_unlock( &p_sys->readahead.lock );
+    return NULL;
 }
 
 /*****************************************************************************
@@ -514,12 +708,9 @@ static int Control( access_t *p_access, int i_query, va_list args )
         break;
 
     case ACCESS_GET_SIZE:
-    {
-        smb_stat st = smb_stat_fd( p_access->p_sys->p_session,
-                                   p_access->p_sys->i_fd );
-        *va_arg( args, uint64_t * ) = smb_stat_get( st, SMB_STAT_SIZE );
+        /* Cached at Open(): the readahead worker owns the session */
+        *va_arg( args, uint64_t * ) = p_access->p_sys->i_size;
         break;
-    }
     case ACCESS_GET_PTS_DELAY:
         *va_arg( args, int64_t * ) = INT64_C(1000)
             * var_InheritInteger( p_access, "network-caching" );
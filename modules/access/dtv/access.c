@@ -46,6 +46,11 @@
 #define BUDGET_LONGTEXT N_( \
     "Only useful programs are normally demultiplexed from the transponder. " \
     "This option will disable demultiplexing and receive all programs.")
+#define DVR_BUFFER_TEXT N_("Receive buffer size (bytes)")
+#define DVR_BUFFER_LONGTEXT N_( \
+    "Size of the kernel ring buffer for received TS packets. " \
+    "A larger buffer absorbs scheduling hiccups during " \
+    "full-transponder capture.")
 
 #define NAME_TEXT N_("Network name")
 #define NAME_LONGTEXT N_("Unique network name in the System Tuning Spaces")
@@ -262,6 +267,9 @@ vlc_module_begin ()
         change_integer_range (0, 255)
         change_safe ()
     add_bool ("dvb-budget-mode", false, BUDGET_TEXT, BUDGET_LONGTEXT, true)
+    add_integer ("dvb-dvr-buffer-size", 1 << 22, DVR_BUFFER_TEXT,
+                 DVR_BUFFER_LONGTEXT, true)
+        change_integer_range (1 << 20, 1 << 26)
 #endif
 #ifdef _WIN32
     add_integer ("dvb-adapter", -1, ADAPTER_TEXT, ADAPTER_LONGTEXT, true)
@@ -503,7 +511,9 @@ static void Close (vlc_object_t *obj)
 
 static block_t *Read (access_t *access)
 {
-#define BUFSIZE (20*188)
+    /* Drain many TS packets per syscall: after poll() reports data, the
+     * kernel ring typically holds far more than a handful of packets. */
+#define BUFSIZE (344*188)
     block_t *block = block_Alloc (BUFSIZE);
     if (unlikely(block == NULL))
         return NULL;
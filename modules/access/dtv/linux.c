@@ -163,7 +163,7 @@ struct dvb_device
 #endif
     uint8_t device;
     bool budget;
-    //size_t buffer_size;
+    uint64_t overflows;
 };
 
 /** Opens the device directory for the specified DVB adapter */
@@ -211,6 +211,9 @@ dvb_device_t *dvb_open (vlc_object_t *obj)
     d->cam = NULL;
 #endif
     d->budget = var_InheritBool (obj, "dvb-budget-mode");
+    d->overflows = 0;
+
+    unsigned bufsize = var_InheritInteger (obj, "dvb-dvr-buffer-size");
 
 #ifndef USE_DMX
     if (d->budget)
@@ -226,7 +229,7 @@ dvb_device_t *dvb_open (vlc_object_t *obj)
            return NULL;
        }
 
-       if (ioctl (d->demux, DMX_SET_BUFFER_SIZE, 1 << 20) < 0)
+       if (ioctl (d->demux, DMX_SET_BUFFER_SIZE, bufsize) < 0)
            msg_Warn (obj, "cannot expand demultiplexing buffer: %s",
                      vlc_strerror_c(errno));
 
@@ -259,6 +262,10 @@ dvb_device_t *dvb_open (vlc_object_t *obj)
             free (d);
             return NULL;
         }
+
+        if (ioctl (d->demux, DMX_SET_BUFFER_SIZE, bufsize) < 0)
+            msg_Warn (obj, "cannot expand DVR buffer: %s",
+                      vlc_strerror_c(errno));
 #endif
     }
 
@@ -373,7 +380,10 @@ ssize_t dvb_read (dvb_device_t *d, void *buf, size_t len)
         {
             if (errno == EOVERFLOW)
             {
-                msg_Err (d->obj, "cannot demux data fast enough!");
+                d->overflows++;
+                msg_Err (d->obj, "cannot demux data fast enough! "
+                         "(%"PRIu64" receive buffer overruns so far)",
+                         d->overflows);
                 return -1;
             }
             msg_Err (d->obj, "cannot demux: %s", vlc_strerror_c(errno));
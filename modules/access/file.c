@@ -50,6 +50,7 @@
 #   include <shlwapi.h>
 #else
 #   include <unistd.h>
+#   include <sys/uio.h>
 #endif
 #include <dirent.h>
 
@@ -70,6 +71,13 @@ struct access_sys_t
     int fd;
 
     bool b_pace_control;
+
+    /* Memory-mapped block mode (large local regular files only) */
+    uint64_t offset;
+    uint64_t size;
+
+    /* Vectored block mode: blocks filled ahead but not yet handed out */
+    block_t *p_queue;
 };
 
 #if !defined (_WIN32) && !defined (__OS2__)
@@ -132,6 +140,23 @@ static ssize_t Read (access_t *, uint8_t *, size_t);
 static int FileSeek (access_t *, uint64_t);
 static int NoSeek (access_t *, uint64_t);
 static int FileControl (access_t *, int, va_list);
+#ifdef HAVE_MMAP
+static block_t *MmapBlock (access_t *);
+static int MmapSeek (access_t *, uint64_t);
+
+/* Minimum file size before mapped windows are used instead of read(). */
+# define FILE_MMAP_THRESHOLD (16u << 20)
+/* Size of each mapped window handed to the demuxer. */
+# define FILE_MMAP_CHUNK     (4u << 20)
+#endif
+#if !defined (_WIN32) && !defined (__OS2__)
+static block_t *ReadvBlock (access_t *);
+static int ReadvSeek (access_t *, uint64_t);
+
+/* Number and size of the blocks filled by each readv() call. */
+# define FILE_READV_COUNT 8
+# define FILE_READV_BLOCK (32u << 10)
+#endif
 
 /*****************************************************************************
  * FileOpen: open the file
@@ -220,12 +245,41 @@ int FileOpen( vlc_object_t *p_this )
     p_access->pf_control = FileControl;
     p_access->p_sys = p_sys;
     p_sys->fd = fd;
+    p_sys->offset = 0;
+    p_sys->size = st.st_size;
+    p_sys->p_queue = NULL;
 
     if (S_ISREG (st.st_mode) || S_ISBLK (st.st_mode))
     {
         p_access->pf_seek = FileSeek;
         p_sys->b_pace_control = true;
 
+#ifdef HAVE_MMAP
+        /* Large local regular files: serve the demuxer directly from the
+         * page cache through mapped windows instead of copying out of it
+         * with read(). Only worthwhile where address space is plentiful. */
+        if (S_ISREG (st.st_mode) && sizeof (void *) >= 8
+         && (uint64_t)st.st_size >= FILE_MMAP_THRESHOLD
+         && !IsRemote (fd, p_access->psz_filepath))
+        {
+            p_access->pf_read = NULL;
+            p_access->pf_block = MmapBlock;
+            p_access->pf_seek = MmapSeek;
+        }
+#endif
+#if !defined (_WIN32) && !defined (__OS2__)
+        if (p_access->pf_read != NULL)
+        {   /* Remaining regular files and block devices: fill several
+             * demuxer-bound blocks per readv() call instead of one
+             * buffer per read(), which matters on high-latency mounts. */
+            p_access->pf_read = NULL;
+            p_access->pf_block = ReadvBlock;
+            p_access->pf_seek = ReadvSeek;
+        }
+#endif
+
+        /* We read the file sequentially in the vast majority of cases. */
+        posix_fadvise (fd, 0, 0, POSIX_FADV_SEQUENTIAL);
         /* Demuxers will need the beginning of the file for probing. */
         posix_fadvise (fd, 0, 4096, POSIX_FADV_WILLNEED);
         /* In most cases, we only read the file once. */
@@ -260,7 +314,7 @@ void FileClose (vlc_object_t * p_this)
 {
     access_t     *p_access = (access_t*)p_this;
 
-    if (p_access->pf_read == NULL)
+    if (p_access->pf_read == NULL && p_access->pf_block == NULL)
     {
         DirClose (p_this);
         return;
@@ -268,6 +322,8 @@ void FileClose (vlc_object_t * p_this)
 
     access_sys_t *p_sys = p_access->p_sys;
 
+    if (p_sys->p_queue != NULL)
+        block_ChainRelease (p_sys->p_queue);
     close (p_sys->fd);
     free (p_sys);
 }
@@ -299,6 +355,156 @@ static ssize_t Read (access_t *p_access, uint8_t *p_buffer, size_t i_len)
     return val;
 }
 
+#if !defined (_WIN32) && !defined (__OS2__)
+static block_t *ReadvBlock (access_t *p_access)
+{
+    access_sys_t *p_sys = p_access->p_sys;
+
+    block_t *block = p_sys->p_queue;
+    if (block != NULL)
+    {   /* Hand out a block filled by a previous readv() */
+        p_sys->p_queue = block->p_next;
+        block->p_next = NULL;
+        return block;
+    }
+
+    block_t *blocks[FILE_READV_COUNT];
+    struct iovec iov[FILE_READV_COUNT];
+    int n = 0;
+
+    while (n < FILE_READV_COUNT
+        && (blocks[n] = block_Alloc (FILE_READV_BLOCK)) != NULL)
+    {
+        iov[n].iov_base = blocks[n]->p_buffer;
+        iov[n].iov_len = FILE_READV_BLOCK;
+        n++;
+    }
+    if (unlikely(n == 0))
+        return NULL;
+
+    ssize_t val = vlc_readv_i11e (p_sys->fd, iov, n);
+    if (val <= 0)
+    {
+        for (int i = 0; i < n; i++)
+            block_Release (blocks[i]);
+
+        if (val == 0)
+        {
+            p_access->info.b_eof = true;
+            return NULL;
+        }
+        switch (errno)
+        {
+            case EINTR:
+            case EAGAIN:
+                return NULL;
+        }
+
+        msg_Err (p_access, "read error: %s", vlc_strerror_c(errno));
+        dialog_Fatal (p_access, _("File reading failed"),
+                      _("VLC could not read the file (%s)."),
+                      vlc_strerror(errno));
+        p_access->info.b_eof = true;
+        return NULL;
+    }
+
+    /* Spread the bytes read over the blocks; queue full ones for the next
+     * calls and drop the ones readv() did not reach. */
+    block_t *first = NULL;
+    block_t **pp_last = &p_sys->p_queue;
+
+    for (int i = 0; i < n; i++)
+    {
+        size_t len = __MIN ((size_t)val, FILE_READV_BLOCK);
+
+        if (len == 0)
+        {
+            block_Release (blocks[i]);
+            continue;
+        }
+        blocks[i]->i_buffer = len;
+        val -= len;
+
+        if (first == NULL)
+            first = blocks[i];
+        else
+        {
+            *pp_last = blocks[i];
+            pp_last = &blocks[i]->p_next;
+        }
+    }
+    *pp_last = NULL;
+    return first;
+}
+
+static int ReadvSeek (access_t *p_access, uint64_t i_pos)
+{
+    access_sys_t *p_sys = p_access->p_sys;
+
+    p_access->info.b_eof = false;
+    if (p_sys->p_queue != NULL)
+    {   /* Blocks read ahead beyond the seek point are stale */
+        block_ChainRelease (p_sys->p_queue);
+        p_sys->p_queue = NULL;
+    }
+
+    if (lseek (p_sys->fd, i_pos, SEEK_SET) == (off_t)-1)
+        return VLC_EGENERIC;
+
+    /* Kick readahead at the target right away */
+    posix_fadvise (p_sys->fd, i_pos, FILE_READV_COUNT * FILE_READV_BLOCK,
+                   POSIX_FADV_WILLNEED);
+    return VLC_SUCCESS;
+}
+#endif
+
+#ifdef HAVE_MMAP
+static block_t *MmapBlock (access_t *p_access)
+{
+    access_sys_t *p_sys = p_access->p_sys;
+
+    if (p_sys->offset >= p_sys->size)
+    {
+        p_access->info.b_eof = true;
+        return NULL;
+    }
+
+    size_t length = FILE_MMAP_CHUNK;
+    if (length > p_sys->size - p_sys->offset)
+        length = p_sys->size - p_sys->offset;
+
+    block_t *block = block_FileMap (p_sys->fd, p_sys->offset, length);
+    if (block == NULL)
+    {   /* Mapping can fail transiently (address space pressure): copy the
+         * window through the heap rather than bailing out. */
+        block = block_Alloc (length);
+        if (unlikely(block == NULL))
+            return NULL;
+
+        ssize_t val = pread (p_sys->fd, block->p_buffer, length,
+                             p_sys->offset);
+        if (val <= 0)
+        {
+            block_Release (block);
+            if (val == 0)
+                p_access->info.b_eof = true;
+            return NULL;
+        }
+        block->i_buffer = val;
+    }
+
+    p_sys->offset += block->i_buffer;
+    return block;
+}
+
+static int MmapSeek (access_t *p_access, uint64_t i_pos)
+{
+    p_access->info.b_eof = false;
+    p_access->p_sys->offset = i_pos;
+    return VLC_SUCCESS;
+}
+#endif
+
 /*****************************************************************************
  * Seek: seek to a specific location in a file
  *****************************************************************************/
@@ -361,7 +567,22 @@ static int FileControl( access_t *p_access, int i_query, va_list args )
             break;
 
         case ACCESS_SET_PAUSE_STATE:
-            /* Nothing to do */
+            if( !va_arg( args, int ) && p_access->pf_seek != NoSeek )
+            {   /* Resuming: prime readahead where we left off, the kernel
+                 * window has decayed while the input was paused. */
+                off_t pos;
+#ifdef HAVE_MMAP
+                if( p_access->pf_block == MmapBlock )
+                    pos = p_sys->offset;
+                else
+#endif
+                    pos = lseek( p_sys->fd, 0, SEEK_CUR );
+                if( pos != (off_t)-1 )
+                {
+                    posix_fadvise( p_sys->fd, pos, 1 << 20,
+                                   POSIX_FADV_WILLNEED );
+                }
+            }
             break;
 
         default:
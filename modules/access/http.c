@@ -180,6 +180,7 @@ struct access_sys_t
 
     bool b_seekable;
     bool b_reconnect;
+    bool b_keepalive;
     bool b_continuous;
     bool b_pace_control;
     bool b_has_size;
@@ -231,6 +232,7 @@ static int Open( vlc_object_t *p_this )
     p_sys->psz_username = NULL;
     p_sys->psz_password = NULL;
     p_sys->b_pace_control = true;
+    p_sys->b_keepalive = false;
 #ifdef HAVE_ZLIB_H
     p_sys->b_compressed = false;
     memset( &p_sys->inflate.stream, 0, sizeof(p_sys->inflate.stream) );
@@ -781,14 +783,38 @@ static ssize_t ReadCompressed( access_t *p_access, uint8_t *p_buffer,
 #endif
 
 /*****************************************************************************
- * Seek: close and re-open a connection at the right place
+ * DrainResponse: read and discard the rest of the current response so that
+ * the connection can be reused for another request
+ *****************************************************************************/
+/* Draining is only worth it while it is cheaper than a reconnection */
+#define HTTP_DRAIN_MAX (256 * 1024)
+
+static int DrainResponse( access_t *p_access )
+{
+    access_sys_t *p_sys = p_access->p_sys;
+    uint8_t buffer[8192];
+
+    while( p_sys->i_remaining > 0 )
+    {
+        int i_read;
+
+        if( ReadData( p_access, &i_read, buffer,
+                      __MIN( p_sys->i_remaining, sizeof(buffer) ) )
+         || i_read <= 0 )
+            return VLC_EGENERIC;
+        p_sys->i_remaining -= i_read;
+    }
+    return VLC_SUCCESS;
+}
+
+/*****************************************************************************
+ * Seek: request a new range, reusing the connection when possible
  *****************************************************************************/
 static int Seek( access_t *p_access, uint64_t i_pos )
 {
     access_sys_t *p_sys = p_access->p_sys;
 
     msg_Dbg( p_access, "trying to seek to %"PRId64, i_pos );
-    Disconnect( p_access );
 
     if( p_sys->size && i_pos >= p_sys->size )
     {
@@ -801,6 +827,29 @@ static int Seek( access_t *p_access, uint64_t i_pos )
         }
         return retval;
     }
+
+    /* Send the new range request on the established connection if the server
+     * supports keep-alive, rather than paying a reconnection and TLS
+     * handshake per seek. The rest of the current response must be drained
+     * first, so only do so when little of it is left. */
+    if( p_sys->fd != -1 && p_sys->b_keepalive && !p_sys->b_chunked
+     && p_sys->b_has_size && p_sys->i_remaining <= HTTP_DRAIN_MAX
+     && DrainResponse( p_access ) == VLC_SUCCESS )
+    {
+        p_sys->offset = i_pos;
+        p_sys->i_icy_offset = i_pos;
+        p_sys->b_has_size = false;
+        p_sys->size = 0;
+        p_access->info.b_eof = false;
+
+        if( Request( p_access, i_pos ) == VLC_SUCCESS )
+            return VLC_SUCCESS;
+        /* Request() has closed the connection (e.g. the server dropped an
+         * idle connection) - fall back to a full reconnection */
+        msg_Dbg( p_access, "connection reuse failed, reconnecting" );
+    }
+
+    Disconnect( p_access );
     if( Connect( p_access, i_pos ) )
     {
         msg_Err( p_access, "seek failed" );
@@ -1025,6 +1074,7 @@ static int Request( access_t *p_access, uint64_t i_tell )
     char           *psz ;
 
     p_sys->i_remaining = 0;
+    p_sys->b_keepalive = false;
 
     const char *psz_path = p_sys->url.psz_path;
     if( !psz_path || !*psz_path )
@@ -1051,7 +1101,6 @@ static int Request( access_t *p_access, uint64_t i_tell )
     /* Offset */
     if( !p_sys->b_continuous )
         WriteHeaders( p_access, "Range: bytes=%"PRIu64"-\r\n", i_tell );
-    WriteHeaders( p_access, "Connection: close\r\n" );
 
     /* Cookies */
     if( p_sys->cookies )
@@ -1096,6 +1145,8 @@ static int Request( access_t *p_access, uint64_t i_tell )
     }
     if( !strncmp( psz, "HTTP/1.", 7 ) )
     {
+        /* Persistent connections are the default since HTTP/1.1 */
+        p_sys->b_keepalive = atoi( &psz[7] ) >= 1;
         p_sys->i_code = atoi( &psz[9] );
         msg_Dbg( p_access, "HTTP answer code %d", p_sys->i_code );
     }
@@ -1383,6 +1434,14 @@ static int Request( access_t *p_access, uint64_t i_tell )
             if( !strcasecmp( p, "bytes" ) )
                 p_sys->b_seekable = true;
         }
+        else if( !strcasecmp( psz, "Connection" ) )
+        {
+            msg_Dbg( p_access, "Connection: %s", p );
+            if( strcasestr( p, "close" ) != NULL )
+                p_sys->b_keepalive = false;
+            else if( strcasestr( p, "keep-alive" ) != NULL )
+                p_sys->b_keepalive = true;
+        }
 
         free( psz );
     }
@@ -160,8 +160,8 @@ typedef struct
     bool            b_discard_trunc;
     stream_t        *p_out_muxed;    /* for muxed stream */
 
-    uint8_t         *p_buffer;
-    unsigned int    i_buffer;
+    block_t         *p_block;   /* receive target handed to live555 */
+    unsigned int    i_buffer;   /* writable payload capacity of p_block */
 
     bool            b_rtcp_sync;
     char            waiting;
@@ -450,7 +450,7 @@ static void Close( vlc_object_t *p_this )
 
         if( tk->b_muxed ) stream_Delete( tk->p_out_muxed );
         es_format_Clean( &tk->fmt );
-        free( tk->p_buffer );
+        if( tk->p_block ) block_Release( tk->p_block );
         free( tk );
     }
     TAB_CLEAN( p_sys->i_track, p_sys->track );
@@ -468,6 +468,25 @@ static void Close( vlc_object_t *p_this )
 static inline const char *strempty( const char *s ) { return s?s:""; }
 static inline Boolean toBool( bool b ) { return b?True:False; } // silly, no?
 
+/* Headroom reserved in front of the receive target so codec headers
+ * (start codes, AMR/H.261 headers) can be prepended without copying the
+ * frame live555 assembled in place */
+#define TRACK_BLOCK_HEADROOM 4
+
+static bool TrackAllocBlock( live_track_t *tk, unsigned int i_size )
+{
+    block_t *p_block = block_Alloc( i_size + TRACK_BLOCK_HEADROOM );
+    if( !p_block )
+        return false;
+    p_block->p_buffer += TRACK_BLOCK_HEADROOM;
+    p_block->i_buffer -= TRACK_BLOCK_HEADROOM;
+    if( tk->p_block )
+        block_Release( tk->p_block );
+    tk->p_block = p_block;
+    tk->i_buffer = i_size;
+    return true;
+}
+
 static void default_live555_callback( RTSPClient* client, int result_code, char* result_string )
 {
     RTSPClientVlc *client_vlc = static_cast<RTSPClientVlc *> ( client );
@@ -749,7 +768,9 @@ static int SessionsSetup( demux_t *p_demux )
             int i_var_buf_size = var_InheritInteger( p_demux, "rtsp-frame-buffer-size" );
             if( i_var_buf_size > 0 )
                 i_frame_buffer = i_var_buf_size;
-            i_receive_buffer = 2000000;
+            /* High bitrate sources (4K cameras...) need more socket room
+             * than the default, scale with the negotiated frame buffer */
+            i_receive_buffer = __MAX( 2000000, 2 * i_frame_buffer );
         }
         else if( !strcmp( sub->mediumName(), "text" ) )
             ;
@@ -853,10 +874,10 @@ static int SessionsSetup( demux_t *p_demux )
             tk->i_pts       = VLC_TS_INVALID;
             tk->f_npt       = 0.;
             tk->b_selected  = true;
-            tk->i_buffer    = i_frame_buffer;
-            tk->p_buffer    = (uint8_t *)malloc( i_frame_buffer );
+            tk->p_block     = NULL;
+            tk->i_buffer    = 0;
 
-            if( !tk->p_buffer )
+            if( !TrackAllocBlock( tk, i_frame_buffer ) )
             {
                 free( tk );
                 delete iter;
@@ -1366,8 +1387,11 @@ static int Demux( demux_t *p_demux )
 
         if( tk->waiting == 0 )
         {
+            /* The previous receive block was sent downstream: stage a new one */
+            if( tk->p_block == NULL && !TrackAllocBlock( tk, tk->i_buffer ) )
+                continue;
             tk->waiting = 1;
-            tk->sub->readSource()->getNextFrame( tk->p_buffer, tk->i_buffer,
+            tk->sub->readSource()->getNextFrame( tk->p_block->p_buffer, tk->i_buffer,
                                           StreamRead, tk, StreamClose, tk );
         }
     }
@@ -1736,7 +1760,7 @@ static int RollOverTcp( demux_t *p_demux )
         if( tk->p_es ) es_out_Del( p_demux->out, tk->p_es );
         if( tk->p_asf_block ) block_Release( tk->p_asf_block );
         es_format_Clean( &tk->fmt );
-        free( tk->p_buffer );
+        if( tk->p_block ) block_Release( tk->p_block );
         free( tk );
     }
     TAB_CLEAN( p_sys->i_track, p_sys->track );
@@ -1961,17 +1985,21 @@ static void StreamRead( void *p_private, unsigned int i_size,
     {
         if( tk->i_buffer < 2000000 )
         {
-            void *p_tmp;
+            block_t *p_tmp;
             msg_Dbg( p_demux, "lost %d bytes", i_truncated_bytes );
             msg_Dbg( p_demux, "increasing buffer size to %d", tk->i_buffer * 2 );
-            p_tmp = realloc( tk->p_buffer, tk->i_buffer * 2 );
+            p_tmp = block_Alloc( tk->i_buffer * 2 + TRACK_BLOCK_HEADROOM );
             if( p_tmp == NULL )
             {
-                msg_Warn( p_demux, "realloc failed" );
+                msg_Warn( p_demux, "buffer resize failed" );
             }
             else
             {
-                tk->p_buffer = (uint8_t*)p_tmp;
+                p_tmp->p_buffer += TRACK_BLOCK_HEADROOM;
+                p_tmp->i_buffer -= TRACK_BLOCK_HEADROOM;
+                memcpy( p_tmp->p_buffer, tk->p_block->p_buffer, i_size );
+                block_Release( tk->p_block );
+                tk->p_block = p_tmp;
                 tk->i_buffer *= 2;
             }
         }
@@ -1986,51 +2014,57 @@ static void StreamRead( void *p_private, unsigned int i_size,
 
     assert( i_size <= tk->i_buffer );
 
-    if( tk->fmt.i_codec == VLC_CODEC_AMR_NB ||
-        tk->fmt.i_codec == VLC_CODEC_AMR_WB )
-    {
-        AMRAudioSource *amrSource = (AMRAudioSource*)tk->sub->readSource();
-
-        p_block = block_Alloc( i_size + 1 );
-        p_block->p_buffer[0] = amrSource->lastFrameHeader();
-        memcpy( p_block->p_buffer + 1, tk->p_buffer, i_size );
-    }
-    else if( tk->fmt.i_codec == VLC_CODEC_H261 )
-    {
-        H261VideoRTPSource *h261Source = (H261VideoRTPSource*)tk->sub->rtpSource();
-        uint32_t header = h261Source->lastSpecialHeader();
-        p_block = block_Alloc( i_size + 4 );
-        memcpy( p_block->p_buffer, &header, 4 );
-        memcpy( p_block->p_buffer + 4, tk->p_buffer, i_size );
-
-        if( tk->sub->rtpSource()->curPacketMarkerBit() )
-            p_block->i_flags |= BLOCK_FLAG_END_OF_FRAME;
-    }
-    else if( tk->fmt.i_codec == VLC_CODEC_H264 || tk->fmt.i_codec == VLC_CODEC_HEVC )
-    {
-        if( tk->fmt.i_codec == VLC_CODEC_H264 && (tk->p_buffer[0] & 0x1f) >= 24 )
-            msg_Warn( p_demux, "unsupported NAL type for H264" );
-        else if( tk->fmt.i_codec == VLC_CODEC_HEVC && ((tk->p_buffer[0] & 0x7e)>>1) >= 48 )
-            msg_Warn( p_demux, "unsupported NAL type for H265" );
-
-        /* Normal NAL type */
-        p_block = block_Alloc( i_size + 4 );
-        p_block->p_buffer[0] = 0x00;
-        p_block->p_buffer[1] = 0x00;
-        p_block->p_buffer[2] = 0x00;
-        p_block->p_buffer[3] = 0x01;
-        memcpy( &p_block->p_buffer[4], tk->p_buffer, i_size );
-    }
-    else if( tk->b_asf )
+    if( tk->b_asf )
     {
+        /* payload gets repacketized into p_asf_block, keep the receive
+         * block as target for the next frame */
         p_block = StreamParseAsf( p_demux, tk,
                                   tk->sub->rtpSource()->curPacketMarkerBit(),
-                                  tk->p_buffer, i_size );
+                                  tk->p_block->p_buffer, i_size );
     }
     else
     {
-        p_block = block_Alloc( i_size );
-        memcpy( p_block->p_buffer, tk->p_buffer, i_size );
+        /* live555 assembled the frame directly in our block: finish it in
+         * place, prepending codec headers into the reserved headroom */
+        p_block = tk->p_block;
+        tk->p_block = NULL;
+        p_block->i_buffer = i_size;
+
+        if( tk->fmt.i_codec == VLC_CODEC_AMR_NB ||
+            tk->fmt.i_codec == VLC_CODEC_AMR_WB )
+        {
+            AMRAudioSource *amrSource = (AMRAudioSource*)tk->sub->readSource();
+
+            p_block->p_buffer -= 1;
+            p_block->i_buffer += 1;
+            p_block->p_buffer[0] = amrSource->lastFrameHeader();
+        }
+        else if( tk->fmt.i_codec == VLC_CODEC_H261 )
+        {
+            H261VideoRTPSource *h261Source = (H261VideoRTPSource*)tk->sub->rtpSource();
+            uint32_t header = h261Source->lastSpecialHeader();
+            p_block->p_buffer -= 4;
+            p_block->i_buffer += 4;
+            memcpy( p_block->p_buffer, &header, 4 );
+
+            if( tk->sub->rtpSource()->curPacketMarkerBit() )
+                p_block->i_flags |= BLOCK_FLAG_END_OF_FRAME;
+        }
+        else if( tk->fmt.i_codec == VLC_CODEC_H264 || tk->fmt.i_codec == VLC_CODEC_HEVC )
+        {
+            if( tk->fmt.i_codec == VLC_CODEC_H264 && (p_block->p_buffer[0] & 0x1f) >= 24 )
+                msg_Warn( p_demux, "unsupported NAL type for H264" );
+            else if( tk->fmt.i_codec == VLC_CODEC_HEVC && ((p_block->p_buffer[0] & 0x7e)>>1) >= 48 )
+                msg_Warn( p_demux, "unsupported NAL type for H265" );
+
+            /* Normal NAL type */
+            p_block->p_buffer -= 4;
+            p_block->i_buffer += 4;
+            p_block->p_buffer[0] = 0x00;
+            p_block->p_buffer[1] = 0x00;
+            p_block->p_buffer[2] = 0x00;
+            p_block->p_buffer[3] = 0x01;
+        }
     }
 
     if( p_sys->i_pcr < i_pts )
@@ -64,6 +64,22 @@ vlc_module_begin()
     set_callbacks(Open, Close)
 vlc_module_end()
 
+/* Number of read RPCs kept in flight. Each request is sized to the mount's
+ * read maximum (rsize), so the pipeline covers several network round-trips
+ * worth of data. */
+#define NFS_PIPELINE_DEPTH 4
+/* Request size used when the server does not report a read maximum */
+#define NFS_CHUNK_DEFAULT 65536
+
+struct nfs_read_req
+{
+    access_t *p_access;
+    uint8_t * p_buf;
+    uint64_t  i_offset;
+    size_t    i_len;     /* valid bytes once the reply arrived */
+    bool      b_pending; /* RPC in flight */
+};
+
 struct access_sys_t
 {
     struct rpc_context *    p_mount; /* used to to get exports mount point */
@@ -85,16 +101,18 @@ struct access_sys_t
             int             i_count;
             unsigned int    i_current;
         } exports;
-        struct
-        {
-            uint8_t *p_buf;
-            size_t i_len;
-        } read;
-        struct
-        {
-            bool b_done;
-        } seek;
     } res;
+
+    struct
+    {
+        struct nfs_read_req req[NFS_PIPELINE_DEPTH];
+        uint64_t i_offset;   /* next offset to request */
+        uint64_t i_pos;      /* next byte to hand to the caller */
+        unsigned i_head;     /* oldest outstanding request */
+        unsigned i_count;    /* outstanding requests */
+        size_t   i_chunk;    /* bytes per request, from the mount's rsize */
+        size_t   i_consumed; /* bytes of the head request already returned */
+    } pipeline;
 };
 
 static bool
@@ -171,70 +189,128 @@ vlc_mount_mainloop(access_t *p_access, bool (*pf_until_cb)(access_t *))
 }
 
 static void
-nfs_read_cb(int i_status, struct nfs_context *p_nfs, void *p_data,
-            void *p_private_data)
+nfs_pread_cb(int i_status, struct nfs_context *p_nfs, void *p_data,
+             void *p_private_data)
 {
-    access_t *p_access = p_private_data;
-    access_sys_t *p_sys = p_access->p_sys;
-    assert(p_sys->p_nfs == p_nfs);
+    struct nfs_read_req *p_req = p_private_data;
+    access_t *p_access = p_req->p_access;
+    assert(p_access->p_sys->p_nfs == p_nfs);
+
+    p_req->b_pending = false;
     if (NFS_CHECK_STATUS(p_access, i_status, p_data))
         return;
 
-    if (i_status == 0)
-        p_access->info.b_eof = true;
-    else
-    {
-        p_sys->res.read.i_len = i_status;
-        memcpy(p_sys->res.read.p_buf, p_data, i_status);
-    }
+    p_req->i_len = i_status;
+    if (i_status > 0)
+        memcpy(p_req->p_buf, p_data, i_status);
 }
 
 static bool
-nfs_read_finished_cb(access_t *p_access)
+nfs_pipeline_head_done_cb(access_t *p_access)
 {
     access_sys_t *p_sys = p_access->p_sys;
-    return p_sys->res.read.i_len > 0 || p_access->info.b_eof;
+    return !p_sys->pipeline.req[p_sys->pipeline.i_head].b_pending;
 }
 
-static ssize_t
-FileRead(access_t *p_access, uint8_t *p_buf, size_t i_len)
+static bool
+nfs_pipeline_idle_cb(access_t *p_access)
 {
     access_sys_t *p_sys = p_access->p_sys;
 
-    p_sys->res.read.i_len = 0;
-    p_sys->res.read.p_buf = p_buf;
-    if (nfs_read_async(p_sys->p_nfs, p_sys->p_nfsfh, i_len, nfs_read_cb,
-                       p_access) < 0)
-    {
-        msg_Err(p_access, "nfs_read_async failed");
-        return -1;
-    }
+    for (unsigned i = 0; i < NFS_PIPELINE_DEPTH; ++i)
+        if (p_sys->pipeline.req[i].b_pending)
+            return false;
+    return true;
+}
 
-    if (vlc_nfs_mainloop(p_access, nfs_read_finished_cb) < 0)
-        return -1;
+/* Issues read RPCs until the pipeline is full. Replies may arrive in any
+ * order; requests are consumed in issue order. */
+static void
+nfs_pipeline_fill(access_t *p_access)
+{
+    access_sys_t *p_sys = p_access->p_sys;
 
-    return p_sys->res.read.i_len;
+    while (!p_sys->b_error && p_sys->pipeline.i_count < NFS_PIPELINE_DEPTH)
+    {
+        unsigned i_slot = (p_sys->pipeline.i_head + p_sys->pipeline.i_count)
+                        % NFS_PIPELINE_DEPTH;
+        struct nfs_read_req *p_req = &p_sys->pipeline.req[i_slot];
+
+        p_req->i_offset = p_sys->pipeline.i_offset;
+        p_req->i_len = 0;
+        p_req->b_pending = true;
+        if (nfs_pread_async(p_sys->p_nfs, p_sys->p_nfsfh, p_req->i_offset,
+                            p_sys->pipeline.i_chunk, nfs_pread_cb, p_req) < 0)
+        {
+            p_req->b_pending = false;
+            msg_Err(p_access, "nfs_pread_async failed");
+            p_sys->b_error = true;
+            break;
+        }
+        p_sys->pipeline.i_offset += p_sys->pipeline.i_chunk;
+        p_sys->pipeline.i_count++;
+    }
 }
 
-static void
-nfs_seek_cb(int i_status, struct nfs_context *p_nfs, void *p_data,
-            void *p_private_data)
+/* Waits for all in-flight reads and restarts the pipeline at the current
+ * position. Needed after a seek or a short reply, since the requests behind
+ * the head were issued at now-wrong offsets. */
+static int
+nfs_pipeline_flush(access_t *p_access)
 {
-    access_t *p_access = p_private_data;
     access_sys_t *p_sys = p_access->p_sys;
-    assert(p_sys->p_nfs == p_nfs);
-    (void) p_data;
-    if (NFS_CHECK_STATUS(p_access, i_status, p_data))
-        return;
 
-    p_sys->res.seek.b_done = true;
+    if (vlc_nfs_mainloop(p_access, nfs_pipeline_idle_cb) < 0)
+        return -1;
+
+    p_sys->pipeline.i_head = 0;
+    p_sys->pipeline.i_count = 0;
+    p_sys->pipeline.i_consumed = 0;
+    p_sys->pipeline.i_offset = p_sys->pipeline.i_pos;
+    return 0;
 }
 
-static bool
-nfs_seek_finished_cb(access_t *p_access)
+static ssize_t
+FileRead(access_t *p_access, uint8_t *p_buf, size_t i_len)
 {
     access_sys_t *p_sys = p_access->p_sys;
-    return p_sys->res.seek.b_done;
+
+    nfs_pipeline_fill(p_access);
+    if (p_sys->b_error)
+        return -1;
+
+    if (vlc_nfs_mainloop(p_access, nfs_pipeline_head_done_cb) < 0)
+        return -1;
+
+    struct nfs_read_req *p_req = &p_sys->pipeline.req[p_sys->pipeline.i_head];
+    if (p_req->i_len == 0)
+    {
+        p_access->info.b_eof = true;
+        return 0;
+    }
+
+    size_t i_avail = p_req->i_len - p_sys->pipeline.i_consumed;
+    if (i_len > i_avail)
+        i_len = i_avail;
+    memcpy(p_buf, p_req->p_buf + p_sys->pipeline.i_consumed, i_len);
+    p_sys->pipeline.i_consumed += i_len;
+    p_sys->pipeline.i_pos += i_len;
+
+    if (p_sys->pipeline.i_consumed >= p_req->i_len)
+    {
+        bool b_short = p_req->i_len < p_sys->pipeline.i_chunk;
+
+        p_sys->pipeline.i_consumed = 0;
+        p_sys->pipeline.i_head = (p_sys->pipeline.i_head + 1)
+                               % NFS_PIPELINE_DEPTH;
+        p_sys->pipeline.i_count--;
+        if (b_short)
+            nfs_pipeline_flush(p_access);
+        else
+            nfs_pipeline_fill(p_access);
+    }
+
+    return i_len;
 }
 
 static int
@@ -243,15 +319,9 @@ FileSeek(access_t *p_access, uint64_t i_pos)
     access_sys_t *p_sys = p_access->p_sys;
     p_access->info.b_eof = false;
 
-    p_sys->res.seek.b_done = false;
-    if (nfs_lseek_async(p_sys->p_nfs, p_sys->p_nfsfh, i_pos, SEEK_SET,
-                        nfs_seek_cb, p_access) < 0)
-    {
-        msg_Err(p_access, "nfs_seek_async failed");
-        return VLC_EGENERIC;
-    }
-
-    if (vlc_nfs_mainloop(p_access, nfs_seek_finished_cb) < 0)
+    /* Reads carry their own offset; just restart the pipeline there */
+    p_sys->pipeline.i_pos = i_pos;
+    if (nfs_pipeline_flush(p_access) < 0)
         return VLC_EGENERIC;
 
     return VLC_SUCCESS;
@@ -679,6 +749,21 @@ Open(vlc_object_t *p_obj)
 
         if (p_sys->p_nfsfh != NULL)
         {
+            /* Size each pipelined request to the mount's read maximum */
+            size_t i_chunk = nfs_get_readmax(p_sys->p_nfs);
+            if (i_chunk == 0)
+                i_chunk = NFS_CHUNK_DEFAULT;
+            p_sys->pipeline.i_chunk = i_chunk;
+            msg_Dbg(p_access, "pipelining %d read RPCs of %zu bytes",
+                    NFS_PIPELINE_DEPTH, i_chunk);
+            for (unsigned i = 0; i < NFS_PIPELINE_DEPTH; ++i)
+            {
+                p_sys->pipeline.req[i].p_access = p_access;
+                p_sys->pipeline.req[i].p_buf = malloc(i_chunk);
+                if (unlikely(p_sys->pipeline.req[i].p_buf == NULL))
+                    goto error;
+            }
+
             p_access->pf_read = FileRead;
             p_access->pf_seek = FileSeek;
             p_access->pf_control = FileControl;
@@ -757,6 +842,9 @@ Close(vlc_object_t *p_obj)
     if (p_sys->p_nfs_url != NULL)
         nfs_destroy_url(p_sys->p_nfs_url);
 
+    for (unsigned i = 0; i < NFS_PIPELINE_DEPTH; ++i)
+        free(p_sys->pipeline.req[i].p_buf);
+
     vlc_UrlClean(&p_sys->encoded_url);
 
     free(p_sys->psz_url_decoded);
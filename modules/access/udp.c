@@ -55,6 +55,9 @@ static void Close( vlc_object_t * );
 
 #define BUFFER_TEXT N_("Receive buffer")
 #define BUFFER_LONGTEXT N_("UDP receive buffer size (bytes)" )
+#define BATCH_TEXT N_("Receive batch size")
+#define BATCH_LONGTEXT N_("Maximum number of datagrams received per " \
+    "system call, on systems that support batched reception." )
 
 vlc_module_begin ()
     set_shortname( N_("UDP" ) )
@@ -64,6 +67,8 @@ vlc_module_begin ()
 
     add_obsolete_integer( "server-port" ) /* since 2.0.0 */
     add_integer( "udp-buffer", 0x400000, BUFFER_TEXT, BUFFER_LONGTEXT, true )
+    add_integer( "udp-batch", 8, BATCH_TEXT, BATCH_LONGTEXT, true )
+        change_integer_range( 1, 32 )
 
     set_capability( "access", 0 )
     add_shortcut( "udp", "udpstream", "udp4", "udp6" )
@@ -74,6 +79,7 @@ vlc_module_end ()
 struct access_sys_t
 {
     int fd;
+    unsigned batch;
     size_t fifo_size;
     block_fifo_t *fifo;
     vlc_sem_t semaphore;
@@ -179,6 +185,7 @@ static int Open( vlc_object_t *p_this )
     }
 
     sys->fifo_size = var_InheritInteger( p_access, "udp-buffer");
+    sys->batch = var_InheritInteger( p_access, "udp-batch");
     vlc_sem_init( &sys->semaphore, 0 );
 
     if( vlc_clone( &sys->thread, ThreadRead, p_access,
@@ -260,6 +267,11 @@ static block_t *BlockUDP( access_t *p_access )
     return block;
 }
 
+static void ChainCleanup(void *chain)
+{
+    block_ChainRelease((block_t *)chain);
+}
+
 /*****************************************************************************
  * ThreadRead: Pull packets from socket as soon as possible.
  *****************************************************************************/
@@ -267,45 +279,67 @@ static void* ThreadRead( void *data )
 {
     access_t *access = data;
     access_sys_t *sys = access->p_sys;
+    block_t *pktv[sys->batch];
+    unsigned pktc = 0;
 
     for(;;)
     {
-        block_t *pkt = block_Alloc(MTU);
-        if (unlikely(pkt == NULL))
+        while (pktc < sys->batch)
+        {
+            block_t *pkt = block_Alloc(MTU);
+            if (unlikely(pkt == NULL))
+                break;
+            pktv[pktc++] = pkt;
+        }
+        if (unlikely(pktc == 0))
         {   /* OOM - dequeue and discard one packet */
             char dummy;
             recv(sys->fd, &dummy, 1, 0);
             continue;
         }
 
-        ssize_t len;
+        /* Chain the packets so a single cleanup covers the whole batch */
+        for (unsigned i = 0; i < pktc; i++)
+            pktv[i]->p_next = (i + 1 < pktc) ? pktv[i + 1] : NULL;
+
+        ssize_t num;
 
-        block_cleanup_push(pkt);
+        vlc_cleanup_push(ChainCleanup, pktv[0]);
         do
         {
 #ifndef LIBVLC_USE_PTHREAD
             struct pollfd ufd = { .fd = sys->fd, .events = POLLIN };
             while (poll(&ufd, 1, -1) <= 0); /* cancellation point */
 #endif
-            len = recv(sys->fd, pkt->p_buffer, MTU, 0);
+            num = net_RecvDgrams(sys->fd, pktv, pktc);
         }
-        while (len == -1);
+        while (num == -1);
         vlc_cleanup_pop();
 
-        pkt->i_buffer = len;
-
         vlc_fifo_Lock(sys->fifo);
-        /* Discard old buffers on overflow */
-        while (vlc_fifo_GetBytes(sys->fifo) + len > sys->fifo_size)
+        for (ssize_t i = 0; i < num; i++)
         {
-            int canc = vlc_savecancel();
-            block_Release(vlc_fifo_DequeueUnlocked(sys->fifo));
-            vlc_restorecancel(canc);
-        }
+            block_t *pkt = pktv[i];
+
+            pkt->p_next = NULL;
+            /* Discard old buffers on overflow */
+            while (vlc_fifo_GetBytes(sys->fifo) + pkt->i_buffer
+                                                         > sys->fifo_size)
+            {
+                int canc = vlc_savecancel();
+                block_Release(vlc_fifo_DequeueUnlocked(sys->fifo));
+                vlc_restorecancel(canc);
+            }
 
-        vlc_fifo_QueueUnlocked(sys->fifo, pkt);
+            vlc_fifo_QueueUnlocked(sys->fifo, pkt);
+        }
         vlc_fifo_Unlock(sys->fifo);
-        vlc_sem_post(&sys->semaphore);
+        for (ssize_t i = 0; i < num; i++)
+            vlc_sem_post(&sys->semaphore);
+
+        /* Keep the packets that were not filled for the next batch */
+        pktc -= num;
+        memmove(pktv, pktv + num, pktc * sizeof (*pktv));
     }
 
     return NULL;
@@ -37,6 +37,9 @@
 #include <errno.h>
 #include <sys/stat.h>
 #include <unistd.h>
+#ifndef _WIN32
+#   include <sys/uio.h>
+#endif
 #ifdef __OS2__
 #   include <io.h>      /* setmode() */
 #endif
@@ -59,6 +62,9 @@
 
 #define SOUT_CFG_PREFIX "sout-file-"
 
+/* Number of chained blocks gathered into one vectored write */
+#define MAX_WRITEV_BLOCKS 64
+
 /*****************************************************************************
  * Read: standard read on a file descriptor.
  *****************************************************************************/
@@ -82,9 +88,21 @@ static ssize_t Write( sout_access_out_t *p_access, block_t *p_buffer )
 
     while( p_buffer )
     {
-        ssize_t val = write ((intptr_t)p_access->p_sys,
-                             p_buffer->p_buffer, p_buffer->i_buffer);
-        if (val <= 0)
+        /* Gather the chain so the kernel sees a few large writes
+         * instead of one small write per block */
+        struct iovec iov[MAX_WRITEV_BLOCKS];
+        int i_count = 0;
+
+        for( block_t *b = p_buffer;
+             b != NULL && i_count < MAX_WRITEV_BLOCKS; b = b->p_next )
+        {
+            iov[i_count].iov_base = b->p_buffer;
+            iov[i_count].iov_len = b->i_buffer;
+            i_count++;
+        }
+
+        ssize_t val = vlc_writev ((intptr_t)p_access->p_sys, iov, i_count);
+        if (val < 0)
         {
             if (errno == EINTR)
                 continue;
@@ -92,19 +110,21 @@ static ssize_t Write( sout_access_out_t *p_access, block_t *p_buffer )
             msg_Err( p_access, "cannot write: %s", vlc_strerror_c(errno) );
             return -1;
         }
+        i_write += val;
 
-        if ((size_t)val >= p_buffer->i_buffer)
+        /* release the fully written blocks, rewind into a partial one */
+        while (p_buffer != NULL && (size_t)val >= p_buffer->i_buffer)
         {
             block_t *p_next = p_buffer->p_next;
+            val -= p_buffer->i_buffer;
             block_Release (p_buffer);
             p_buffer = p_next;
         }
-        else
+        if (p_buffer != NULL)
         {
             p_buffer->p_buffer += val;
             p_buffer->i_buffer -= val;
         }
-        i_write += val;
     }
     return i_write;
 }
@@ -116,16 +136,18 @@ static ssize_t WritePipe(sout_access_out_t *access, block_t *block)
 
     while (block != NULL)
     {
-        if (block->i_buffer == 0)
+        struct iovec iov[MAX_WRITEV_BLOCKS];
+        int count = 0;
+
+        for (block_t *b = block;
+             b != NULL && count < MAX_WRITEV_BLOCKS; b = b->p_next)
         {
-            block_t *next = block->p_next;
-            block_Release(block);
-            block = next;
-            continue;
+            iov[count].iov_base = b->p_buffer;
+            iov[count].iov_len = b->i_buffer;
+            count++;
         }
 
-        /* TODO: vectorized I/O with writev() */
-        ssize_t val = vlc_write(fd, block->p_buffer, block->i_buffer);
+        ssize_t val = vlc_writev(fd, iov, count);
         if (val < 0)
         {
             if (errno == EINTR)
@@ -139,9 +161,19 @@ static ssize_t WritePipe(sout_access_out_t *access, block_t *block)
 
         total += val;
 
-        assert((size_t)val <= block->i_buffer);
-        block->p_buffer += val;
-        block->i_buffer -= val;
+        while (block != NULL && (size_t)val >= block->i_buffer)
+        {
+            block_t *next = block->p_next;
+            val -= block->i_buffer;
+            block_Release(block);
+            block = next;
+        }
+        if (block != NULL)
+        {
+            assert((size_t)val <= block->i_buffer);
+            block->p_buffer += val;
+            block->i_buffer -= val;
+        }
     }
 
     return total;
@@ -198,6 +230,249 @@ static int NoSeek(sout_access_out_t *access, off_t pos)
     return -1;
 }
 
+#ifdef O_DIRECT
+/*****************************************************************************
+ * Direct I/O writer: blocks are accumulated into one half of an aligned
+ * double buffer on the mux thread while a dedicated thread writes the other
+ * half with O_DIRECT. Recording thus bypasses the page cache entirely and
+ * the mux thread never blocks on disk except when the device cannot keep up
+ * with the accumulation rate.
+ *****************************************************************************/
+
+/* Bytes per ring half; must be a multiple of any plausible device I/O
+ * alignment so that flushed chunks always remain aligned */
+#define DIRECT_RING_SIZE (1 << 20)
+
+typedef struct
+{
+    int             fd;
+    size_t          i_align;      /* device I/O alignment */
+
+    unsigned char  *p_half[2];    /* accumulation double buffer */
+    int             i_active;     /* half currently being filled */
+    size_t          i_fill;       /* bytes accumulated in the active half */
+
+    vlc_thread_t    thread;
+    vlc_mutex_t     lock;
+    vlc_cond_t      wait;
+    int             i_pending;    /* half owned by the thread, or -1 */
+    size_t          i_pending_size;
+    bool            b_error;
+    bool            b_exit;
+} direct_sys_t;
+
+static void *DirectThread( void *opaque )
+{
+    sout_access_out_t *p_access = opaque;
+    direct_sys_t *p_sys = (direct_sys_t *)p_access->p_sys;
+
+    vlc_mutex_lock( &p_sys->lock );
+    for( ;; )
+    {
+        while( p_sys->i_pending < 0 && !p_sys->b_exit )
+            vlc_cond_wait( &p_sys->wait, &p_sys->lock );
+        if( p_sys->i_pending < 0 )
+            break;
+
+        const unsigned char *p_buf = p_sys->p_half[p_sys->i_pending];
+        size_t i_size = p_sys->i_pending_size;
+        vlc_mutex_unlock( &p_sys->lock );
+
+        size_t i_done = 0;
+        while( i_done < i_size )
+        {
+            ssize_t val = write( p_sys->fd, p_buf + i_done, i_size - i_done );
+            if( val == -1 )
+            {
+                if( errno == EINTR )
+                    continue;
+                msg_Err( p_access, "cannot write: %s",
+                         vlc_strerror_c(errno) );
+                break;
+            }
+            i_done += val;
+        }
+
+        vlc_mutex_lock( &p_sys->lock );
+        if( i_done < i_size )
+            p_sys->b_error = true;
+        p_sys->i_pending = -1;
+        vlc_cond_signal( &p_sys->wait );
+    }
+    vlc_mutex_unlock( &p_sys->lock );
+    return NULL;
+}
+
+/* Hand the active half over to the flush thread, waiting for the previous
+ * flush to complete first. Returns false if a write failed. */
+static bool DirectFlush( direct_sys_t *p_sys )
+{
+    vlc_mutex_lock( &p_sys->lock );
+    while( p_sys->i_pending >= 0 && !p_sys->b_error )
+        vlc_cond_wait( &p_sys->wait, &p_sys->lock );
+
+    bool b_ok = !p_sys->b_error;
+    if( b_ok )
+    {
+        p_sys->i_pending = p_sys->i_active;
+        p_sys->i_pending_size = p_sys->i_fill;
+        p_sys->i_active = 1 - p_sys->i_active;
+        p_sys->i_fill = 0;
+        vlc_cond_signal( &p_sys->wait );
+    }
+    vlc_mutex_unlock( &p_sys->lock );
+    return b_ok;
+}
+
+static ssize_t WriteDirect( sout_access_out_t *p_access, block_t *p_buffer )
+{
+    direct_sys_t *p_sys = (direct_sys_t *)p_access->p_sys;
+    size_t i_write = 0;
+
+    while( p_buffer )
+    {
+        block_t *p_next = p_buffer->p_next;
+        size_t i_copied = 0;
+
+        while( i_copied < p_buffer->i_buffer )
+        {
+            size_t i_room = DIRECT_RING_SIZE - p_sys->i_fill;
+            size_t i_copy = __MIN( i_room, p_buffer->i_buffer - i_copied );
+
+            memcpy( p_sys->p_half[p_sys->i_active] + p_sys->i_fill,
+                    p_buffer->p_buffer + i_copied, i_copy );
+            p_sys->i_fill += i_copy;
+            i_copied += i_copy;
+
+            if( p_sys->i_fill == DIRECT_RING_SIZE && !DirectFlush( p_sys ) )
+            {   /* the flush thread already reported the error */
+                block_ChainRelease( p_buffer );
+                return -1;
+            }
+        }
+        i_write += p_buffer->i_buffer;
+        block_Release( p_buffer );
+        p_buffer = p_next;
+    }
+    return i_write;
+}
+
+static int DirectOpen( sout_access_out_t *p_access, int fd,
+                       const struct stat *st )
+{
+    /* O_DIRECT requires device-aligned file offsets */
+    size_t i_align = (st->st_blksize > 512) ? st->st_blksize : 512;
+    off_t i_pos = lseek( fd, 0, SEEK_CUR );
+
+    if( i_pos == (off_t)-1 || (i_pos % (off_t)i_align) != 0
+     || (DIRECT_RING_SIZE % i_align) != 0 )
+        return VLC_EGENERIC;
+
+    long flags = fcntl( fd, F_GETFL );
+    if( flags == -1 || fcntl( fd, F_SETFL, flags | O_DIRECT ) )
+        return VLC_EGENERIC;
+
+    direct_sys_t *p_sys = malloc( sizeof( *p_sys ) );
+    if( unlikely(p_sys == NULL) )
+        goto error;
+
+    p_sys->fd = fd;
+    p_sys->i_align = i_align;
+    p_sys->p_half[0] = vlc_memalign( i_align, DIRECT_RING_SIZE );
+    p_sys->p_half[1] = vlc_memalign( i_align, DIRECT_RING_SIZE );
+    p_sys->i_active = 0;
+    p_sys->i_fill = 0;
+    p_sys->i_pending = -1;
+    p_sys->b_error = false;
+    p_sys->b_exit = false;
+
+    if( !p_sys->p_half[0] || !p_sys->p_half[1] )
+        goto error;
+
+    vlc_mutex_init( &p_sys->lock );
+    vlc_cond_init( &p_sys->wait );
+
+    p_access->p_sys = (void *)p_sys;
+    if( vlc_clone( &p_sys->thread, DirectThread, p_access,
+                   VLC_THREAD_PRIORITY_OUTPUT ) )
+    {
+        vlc_cond_destroy( &p_sys->wait );
+        vlc_mutex_destroy( &p_sys->lock );
+        p_access->p_sys = (void *)(intptr_t)fd;
+        goto error;
+    }
+
+    p_access->pf_write = WriteDirect;
+    p_access->pf_seek = NoSeek;
+    p_access->pf_read = NULL;
+    return VLC_SUCCESS;
+
+error:
+    if( p_sys != NULL )
+    {
+        free( p_sys->p_half[0] );
+        free( p_sys->p_half[1] );
+        free( p_sys );
+    }
+    fcntl( fd, F_SETFL, flags );
+    return VLC_EGENERIC;
+}
+
+static void DirectClose( sout_access_out_t *p_access )
+{
+    direct_sys_t *p_sys = (direct_sys_t *)p_access->p_sys;
+
+    /* Flush the aligned part of what is left through the thread */
+    size_t i_tail = p_sys->i_fill % p_sys->i_align;
+    size_t i_aligned = p_sys->i_fill - i_tail;
+    int i_from = p_sys->i_active;
+
+    if( i_aligned > 0 )
+    {
+        p_sys->i_fill = i_aligned;
+        DirectFlush( p_sys );
+    }
+
+    vlc_mutex_lock( &p_sys->lock );
+    p_sys->b_exit = true;
+    vlc_cond_signal( &p_sys->wait );
+    vlc_mutex_unlock( &p_sys->lock );
+    vlc_join( p_sys->thread, NULL );
+
+    /* The unaligned tail cannot go through O_DIRECT: drop the flag and
+     * finish with a plain write */
+    if( i_tail > 0 && !p_sys->b_error )
+    {
+        long flags = fcntl( p_sys->fd, F_GETFL );
+        const unsigned char *p = p_sys->p_half[i_from] + i_aligned;
+
+        if( flags != -1
+         && fcntl( p_sys->fd, F_SETFL, flags & ~O_DIRECT ) == 0 )
+            while( i_tail > 0 )
+            {
+                ssize_t val = write( p_sys->fd, p, i_tail );
+                if( val == -1 )
+                {
+                    if( errno == EINTR )
+                        continue;
+                    msg_Err( p_access, "cannot write: %s",
+                             vlc_strerror_c(errno) );
+                    break;
+                }
+                p += val;
+                i_tail -= val;
+            }
+    }
+
+    close( p_sys->fd );
+    free( p_sys->p_half[0] );
+    free( p_sys->p_half[1] );
+    vlc_cond_destroy( &p_sys->wait );
+    vlc_mutex_destroy( &p_sys->lock );
+    free( p_sys );
+}
+#endif /* O_DIRECT */
+
 static int Control( sout_access_out_t *p_access, int i_query, va_list args )
 {
     switch( i_query )
@@ -228,6 +503,9 @@ static const char *const ppsz_sout_options[] = {
     "overwrite",
 #ifdef O_SYNC
     "sync",
+#endif
+#ifdef O_DIRECT
+    "direct",
 #endif
     NULL
 };
@@ -364,6 +642,13 @@ static int Open( vlc_object_t *p_this )
     if (append)
         lseek (fd, 0, SEEK_END);
 
+#ifdef O_DIRECT
+    if (p_access->pf_write == Write
+     && var_GetBool (p_access, SOUT_CFG_PREFIX"direct")
+     && DirectOpen (p_access, fd, &st) != VLC_SUCCESS)
+        msg_Warn (p_access, "direct I/O unavailable, using buffered writes");
+#endif
+
     return VLC_SUCCESS;
 }
 
@@ -374,6 +659,11 @@ static void Close( vlc_object_t * p_this )
 {
     sout_access_out_t *p_access = (sout_access_out_t*)p_this;
 
+#ifdef O_DIRECT
+    if( p_access->pf_write == WriteDirect )
+        DirectClose( p_access );
+    else
+#endif
     close( (intptr_t)p_access->p_sys );
 
     msg_Dbg( p_access, "file access output closed" );
@@ -390,6 +680,10 @@ static void Close( vlc_object_t * p_this )
     "on the file path")
 #define SYNC_TEXT N_("Synchronous writing")
 #define SYNC_LONGTEXT N_( "Open the file with synchronous writing.")
+#define DIRECT_TEXT N_("Direct disk writing")
+#define DIRECT_LONGTEXT N_( "Write to the file with O_DIRECT from a " \
+    "dedicated thread, bypassing the page cache. The output cannot be " \
+    "seeked, so this is only usable with streamable formats.")
 
 vlc_module_begin ()
     set_description( N_("File stream output") )
@@ -407,6 +701,10 @@ vlc_module_begin ()
 #ifdef O_SYNC
     add_bool( SOUT_CFG_PREFIX "sync", false, SYNC_TEXT,SYNC_LONGTEXT,
               false )
+#endif
+#ifdef O_DIRECT
+    add_bool( SOUT_CFG_PREFIX "direct", false, DIRECT_TEXT, DIRECT_LONGTEXT,
+              false )
 #endif
     set_callbacks( Open, Close )
 vlc_module_end ()
@@ -174,6 +174,22 @@ typedef struct output_segment
     uint8_t aes_ivs[16];
 } output_segment_t;
 
+/* Segment finalization (stuffing write, close, index rewrite, deletion of
+ * expired segments) is queued to a worker thread so that segment boundaries
+ * do not stall the mux thread while the next segment is already written */
+typedef struct finalize_job
+{
+    struct finalize_job *p_next;
+    output_segment_t *p_segment;
+    int      i_handle;
+    uint32_t i_segment_number;
+    float    f_seglength;
+    uint8_t  stuffing_bytes[16];
+    ssize_t  i_stuffing;
+    bool     b_update_index;
+    bool     b_isend;
+} finalize_job_t;
+
 struct sout_access_out_sys_t
 {
     char *psz_cursegPath;
@@ -204,6 +220,15 @@ struct sout_access_out_sys_t
     uint8_t stuffing_bytes[16];
     ssize_t stuffing_size;
     vlc_array_t *segments_t;
+
+    /* Finalization worker, see FinalizeThread() */
+    vlc_thread_t finalize_thread;
+    vlc_mutex_t  lock;          /* protects segments_t and the job queue */
+    vlc_cond_t   wait;
+    finalize_job_t *p_job_first;
+    finalize_job_t **pp_job_last;
+    bool         b_thread;
+    bool         b_exit;
 };
 
 static int LoadCryptFile( sout_access_out_t *p_access);
@@ -211,6 +236,7 @@ static int CryptSetup( sout_access_out_t *p_access, char *keyfile );
 static int CheckSegmentChange( sout_access_out_t *p_access, block_t *p_buffer );
 static ssize_t writeSegment( sout_access_out_t *p_access );
 static ssize_t openNextFile( sout_access_out_t *p_access, sout_access_out_sys_t *p_sys );
+static void *FinalizeThread( void *opaque );
 /*****************************************************************************
  * Open: open the file
  *****************************************************************************/
@@ -301,6 +327,17 @@ static int Open( vlc_object_t *p_this )
     p_access->pf_seek  = Seek;
     p_access->pf_control = Control;
 
+    vlc_mutex_init( &p_sys->lock );
+    vlc_cond_init( &p_sys->wait );
+    p_sys->p_job_first = NULL;
+    p_sys->pp_job_last = &p_sys->p_job_first;
+    p_sys->b_exit = false;
+    p_sys->b_thread = !vlc_clone( &p_sys->finalize_thread, FinalizeThread,
+                                  p_access, VLC_THREAD_PRIORITY_LOW );
+    if( !p_sys->b_thread )
+        msg_Warn( p_access, "cannot spawn finalization thread, "
+                  "segments will be finalized on the mux thread" );
+
     return VLC_SUCCESS;
 }
 
@@ -517,18 +554,18 @@ static void destroySegment( output_segment_t *segment )
  * segmentAmountNeeded: check that playlist has atleast 3*p_sys->i_seglength of segments
  * return how many segments are needed for that (max of p_sys->i_segment )
  ************************************************************************/
-static uint32_t segmentAmountNeeded( sout_access_out_sys_t *p_sys )
+static uint32_t segmentAmountNeeded( sout_access_out_sys_t *p_sys, int i_count )
 {
     float duration = .0f;
-    for( unsigned index = 1; (int)index <= vlc_array_count( p_sys->segments_t ); index++ )
+    for( unsigned index = 1; (int)index <= i_count; index++ )
     {
-        output_segment_t* segment = vlc_array_item_at_index( p_sys->segments_t, vlc_array_count( p_sys->segments_t ) - index );
+        output_segment_t* segment = vlc_array_item_at_index( p_sys->segments_t, i_count - index );
         duration += segment->f_seglength;
 
         if( duration >= (float)( 3 * p_sys->i_seglen ) )
             return __MAX(index, p_sys->i_numsegs);
     }
-    return vlc_array_count( p_sys->segments_t )-1;
+    return i_count-1;
 
 }
 
@@ -538,7 +575,7 @@ static uint32_t segmentAmountNeeded( sout_access_out_sys_t *p_sys )
  * check that the first item has been around outside playlist
  * segment->f_seglength + (p_sys->i_numsegs * p_sys->i_seglen) before it is removed.
  ************************************************************************/
-static bool isFirstItemRemovable( sout_access_out_sys_t *p_sys, uint32_t i_firstseg, uint32_t i_index_offset )
+static bool isFirstItemRemovable( sout_access_out_sys_t *p_sys, uint32_t i_lastseg, uint32_t i_firstseg, uint32_t i_index_offset )
 {
     float duration = .0f;
 
@@ -547,7 +584,7 @@ static bool isFirstItemRemovable( sout_access_out_sys_t *p_sys, uint32_t i_first
      */
     for( unsigned int index = 0; index < i_index_offset; index++ )
     {
-        output_segment_t *segment = vlc_array_item_at_index( p_sys->segments_t, p_sys->i_segment - i_firstseg + index );
+        output_segment_t *segment = vlc_array_item_at_index( p_sys->segments_t, i_lastseg - i_firstseg + index );
         duration += segment->f_seglength;
     }
     output_segment_t *first = vlc_array_item_at_index( p_sys->segments_t, 0 );
@@ -558,22 +595,31 @@ static bool isFirstItemRemovable( sout_access_out_sys_t *p_sys, uint32_t i_first
 /************************************************************************
  * updateIndexAndDel: If necessary, update index file & delete old segments
  ************************************************************************/
-static int updateIndexAndDel( sout_access_out_t *p_access, sout_access_out_sys_t *p_sys, bool b_isend )
+static int updateIndexAndDel( sout_access_out_t *p_access, sout_access_out_sys_t *p_sys, bool b_isend,
+                              uint32_t i_lastseg, const output_segment_t *p_lastseg )
 {
 
     uint32_t i_firstseg;
     unsigned i_index_offset = 0;
+    int i_count;
+
+    /* The mux thread may already have opened the next segment: only publish
+     * up to and including the segment being finalized */
+    i_count = vlc_array_count( p_sys->segments_t );
+    while( i_count > 0 &&
+           vlc_array_item_at_index( p_sys->segments_t, i_count - 1 ) != p_lastseg )
+        i_count--;
 
     if ( p_sys->i_numsegs == 0 ||
-         p_sys->i_segment < ( p_sys->i_numsegs + p_sys->i_initial_segment ) )
+         i_lastseg < ( p_sys->i_numsegs + p_sys->i_initial_segment ) )
     {
         i_firstseg = p_sys->i_initial_segment;
     }
     else
     {
-        unsigned numsegs = segmentAmountNeeded( p_sys );
-        i_firstseg = ( p_sys->i_segment - numsegs ) + 1;
-        i_index_offset = vlc_array_count( p_sys->segments_t ) - numsegs;
+        unsigned numsegs = segmentAmountNeeded( p_sys, i_count );
+        i_firstseg = ( i_lastseg - numsegs ) + 1;
+        i_index_offset = i_count - numsegs;
     }
 
     // First update index
@@ -607,7 +653,7 @@ static int updateIndexAndDel( sout_access_out_t *p_access, sout_access_out_sys_t
         char *psz_current_uri=NULL;
 
 
-        for ( uint32_t i = i_firstseg; i <= p_sys->i_segment; i++ )
+        for ( uint32_t i = i_firstseg; i <= i_lastseg; i++ )
         {
             //scale to i_index_offset..numsegs + i_index_offset
             uint32_t index = i - i_firstseg + i_index_offset;
@@ -685,7 +731,7 @@ static int updateIndexAndDel( sout_access_out_t *p_access, sout_access_out_sys_t
     // Then take care of deletion
     // Try to follow pantos draft 11 section 6.2.2
     while( p_sys->b_delsegs && p_sys->i_numsegs &&
-           isFirstItemRemovable( p_sys, i_firstseg, i_index_offset )
+           isFirstItemRemovable( p_sys, i_lastseg, i_firstseg, i_index_offset )
          )
     {
          output_segment_t *segment = vlc_array_item_at_index( p_sys->segments_t, 0 );
@@ -706,13 +752,93 @@ static int updateIndexAndDel( sout_access_out_t *p_access, sout_access_out_sys_t
 }
 
 /*****************************************************************************
- * closeCurrentSegment: Close the segment file
+ * FinalizeSegment: Write the cipher stuffing, close the segment file and
+ * publish it in the index. Runs on the finalization thread (or inline on
+ * the mux thread when that thread could not be spawned).
+ *****************************************************************************/
+static void FinalizeSegment( sout_access_out_t *p_access, finalize_job_t *p_job )
+{
+    sout_access_out_sys_t *p_sys = p_access->p_sys;
+    output_segment_t *segment = p_job->p_segment;
+
+    if( p_job->i_stuffing > 0 &&
+        vlc_write( p_job->i_handle, p_job->stuffing_bytes,
+                   p_job->i_stuffing ) != p_job->i_stuffing )
+        msg_Err( p_access, "Couldn't write %zd bytes", p_job->i_stuffing );
+
+    close( p_job->i_handle );
+
+    if( ! ( us_asprintf( &segment->psz_duration, "%.2f", p_job->f_seglength ) ) )
+    {
+        msg_Err( p_access, "Couldn't set duration on closed segment");
+        return;
+    }
+    segment->f_seglength = p_job->f_seglength;
+    segment->i_segment_number = p_job->i_segment_number;
+
+    if( p_job->b_update_index )
+    {
+        vlc_mutex_lock( &p_sys->lock );
+        updateIndexAndDel( p_access, p_sys, p_job->b_isend,
+                           p_job->i_segment_number, segment );
+        vlc_mutex_unlock( &p_sys->lock );
+    }
+}
+
+static void *FinalizeThread( void *opaque )
+{
+    sout_access_out_t *p_access = opaque;
+    sout_access_out_sys_t *p_sys = p_access->p_sys;
+
+    vlc_mutex_lock( &p_sys->lock );
+    for( ;; )
+    {
+        while( p_sys->p_job_first == NULL && !p_sys->b_exit )
+            vlc_cond_wait( &p_sys->wait, &p_sys->lock );
+
+        finalize_job_t *p_job = p_sys->p_job_first;
+        if( p_job == NULL )
+            break;      /* exit requested and the queue is drained */
+        p_sys->p_job_first = p_job->p_next;
+        if( p_sys->p_job_first == NULL )
+            p_sys->pp_job_last = &p_sys->p_job_first;
+        vlc_mutex_unlock( &p_sys->lock );
+
+        FinalizeSegment( p_access, p_job );
+        free( p_job );
+
+        vlc_mutex_lock( &p_sys->lock );
+    }
+    vlc_mutex_unlock( &p_sys->lock );
+    return NULL;
+}
+
+/*****************************************************************************
+ * closeCurrentSegment: Hand the segment file over to the finalization
+ * thread. The cipher stuffing is encrypted here, before CryptKey() rekeys
+ * the shared cipher context for the next segment.
  *****************************************************************************/
 static void closeCurrentSegment( sout_access_out_t *p_access, sout_access_out_sys_t *p_sys, bool b_isend )
 {
     if ( p_sys->i_handle >= 0 )
     {
-        output_segment_t *segment = (output_segment_t *)vlc_array_item_at_index( p_sys->segments_t, vlc_array_count( p_sys->segments_t ) - 1 );
+        finalize_job_t *p_job = malloc( sizeof( *p_job ) );
+        finalize_job_t job;
+
+        if( unlikely( p_job == NULL ) )
+            p_job = &job;       /* finalize synchronously below */
+
+        vlc_mutex_lock( &p_sys->lock );
+        p_job->p_segment = (output_segment_t *)vlc_array_item_at_index( p_sys->segments_t, vlc_array_count( p_sys->segments_t ) - 1 );
+        vlc_mutex_unlock( &p_sys->lock );
+
+        p_job->p_next = NULL;
+        p_job->i_handle = p_sys->i_handle;
+        p_job->i_segment_number = p_sys->i_segment;
+        p_job->f_seglength = p_sys->f_seglen;
+        p_job->i_stuffing = 0;
+        p_job->b_update_index = p_sys->psz_cursegPath != NULL;
+        p_job->b_isend = b_isend;
 
         if( p_sys->key_uri )
         {
@@ -723,33 +849,34 @@ static void closeCurrentSegment( sout_access_out_t *p_access, sout_access_out_sy
             if( err ) {
                msg_Err( p_access, "Couldn't encrypt 16 bytes: %s", gpg_strerror(err) );
             } else {
-
-            int ret = vlc_write( p_sys->i_handle, p_sys->stuffing_bytes, 16 );
-            if( ret != 16 )
-                msg_Err( p_access, "Couldn't write 16 bytes" );
+               memcpy( p_job->stuffing_bytes, p_sys->stuffing_bytes, 16 );
+               p_job->i_stuffing = 16;
             }
             p_sys->stuffing_size = 0;
         }
 
-
-        close( p_sys->i_handle );
         p_sys->i_handle = -1;
 
-        if( ! ( us_asprintf( &segment->psz_duration, "%.2f", p_sys->f_seglen ) ) )
-        {
-            msg_Err( p_access, "Couldn't set duration on closed segment");
-            return;
-        }
-        segment->f_seglength = p_sys->f_seglen;
-
-        segment->i_segment_number = p_sys->i_segment;
-
         if ( p_sys->psz_cursegPath )
         {
             msg_Dbg( p_access, "LiveHttpSegmentComplete: %s (%"PRIu32")" , p_sys->psz_cursegPath, p_sys->i_segment );
             free( p_sys->psz_cursegPath );
             p_sys->psz_cursegPath = 0;
-            updateIndexAndDel( p_access, p_sys, b_isend );
+        }
+
+        if( p_sys->b_thread && p_job != &job )
+        {
+            vlc_mutex_lock( &p_sys->lock );
+            *p_sys->pp_job_last = p_job;
+            p_sys->pp_job_last = &p_job->p_next;
+            vlc_cond_broadcast( &p_sys->wait );
+            vlc_mutex_unlock( &p_sys->lock );
+        }
+        else
+        {
+            FinalizeSegment( p_access, p_job );
+            if( p_job != &job )
+                free( p_job );
         }
     }
 }
@@ -803,6 +930,19 @@ static void Close( vlc_object_t * p_this )
 
     closeCurrentSegment( p_access, p_sys, true );
 
+    if( p_sys->b_thread )
+    {
+        /* The worker drains the queue (including the end-of-list index
+         * rewrite just queued) before exiting */
+        vlc_mutex_lock( &p_sys->lock );
+        p_sys->b_exit = true;
+        vlc_cond_broadcast( &p_sys->wait );
+        vlc_mutex_unlock( &p_sys->lock );
+        vlc_join( p_sys->finalize_thread, NULL );
+    }
+    vlc_cond_destroy( &p_sys->wait );
+    vlc_mutex_destroy( &p_sys->lock );
+
     if( p_sys->key_uri )
     {
         gcry_cipher_close( p_sys->aes_ctx );
@@ -886,7 +1026,9 @@ static ssize_t openNextFile( sout_access_out_t *p_access, sout_access_out_sys_t
         return -1;
     }
 
+    vlc_mutex_lock( &p_sys->lock );
     vlc_array_append( p_sys->segments_t, segment);
+    vlc_mutex_unlock( &p_sys->lock );
 
     if( p_sys->psz_keyfile )
     {
@@ -39,6 +39,17 @@
 #include <vlc_aout.h>
 #include <vlc_block.h>
 #include <vlc_filter.h>
+#include <vlc_cpu.h>
+
+#if defined(CAN_COMPILE_SSE2) && (defined(__i386__) || defined(__x86_64__))
+# define CONVERT_USE_SSE2
+# include <emmintrin.h>
+# ifndef __SSE2__
+#  define VLC_TARGET_SSE2 __attribute__((__target__("sse2")))
+# else
+#  define VLC_TARGET_SSE2
+# endif
+#endif
 
 /*****************************************************************************
  * Module descriptor
@@ -439,9 +450,188 @@ static block_t *Fl64toS32(filter_t *filter, block_t *b)
 }
 
 
+/*** SSE2 versions of the conversions dominating aout filter chains.
+ *** They are bit-exact with the C versions above (the scale factors are
+ *** powers of two and both round to nearest even), except on garbage
+ *** input beyond [-2., 2.] for Fl32toS16. ***/
+#ifdef CONVERT_USE_SSE2
+VLC_TARGET_SSE2
+static block_t *S16toFl32_SSE2(filter_t *filter, block_t *bsrc)
+{
+    block_t *bdst = block_Alloc(bsrc->i_buffer * 2);
+    if (unlikely(bdst == NULL))
+        goto out;
+
+    block_CopyProperties(bdst, bsrc);
+    int16_t *src = (int16_t *)bsrc->p_buffer;
+    float   *dst = (float *)bdst->p_buffer;
+    size_t i = bsrc->i_buffer / 2;
+    const __m128 scale = _mm_set1_ps(1.f / 32768.f);
+
+    for (; i >= 8; i -= 8, src += 8, dst += 8)
+    {
+        __m128i s = _mm_loadu_si128((const __m128i *)src);
+        __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(s, s), 16);
+        __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(s, s), 16);
+        _mm_storeu_ps(dst,     _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+        _mm_storeu_ps(dst + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+    }
+    for (; i > 0; i--)
+        *dst++ = (float)*src++ / 32768.f;
+out:
+    block_Release(bsrc);
+    VLC_UNUSED(filter);
+    return bdst;
+}
+
+VLC_TARGET_SSE2
+static block_t *S16toS32_SSE2(filter_t *filter, block_t *bsrc)
+{
+    block_t *bdst = block_Alloc(bsrc->i_buffer * 2);
+    if (unlikely(bdst == NULL))
+        goto out;
+
+    block_CopyProperties(bdst, bsrc);
+    int16_t *src = (int16_t *)bsrc->p_buffer;
+    int32_t *dst = (int32_t *)bdst->p_buffer;
+    size_t i = bsrc->i_buffer / 2;
+    const __m128i zero = _mm_setzero_si128();
+
+    for (; i >= 8; i -= 8, src += 8, dst += 8)
+    {
+        __m128i s = _mm_loadu_si128((const __m128i *)src);
+        _mm_storeu_si128((__m128i *)dst,       _mm_unpacklo_epi16(zero, s));
+        _mm_storeu_si128((__m128i *)(dst + 4), _mm_unpackhi_epi16(zero, s));
+    }
+    for (; i > 0; i--)
+        *dst++ = *src++ << 16;
+out:
+    block_Release(bsrc);
+    VLC_UNUSED(filter);
+    return bdst;
+}
+
+VLC_TARGET_SSE2
+static block_t *Fl32toS16_SSE2(filter_t *filter, block_t *b)
+{
+    VLC_UNUSED(filter);
+    float   *src = (float *)b->p_buffer;
+    int16_t *dst = (int16_t *)src;
+    size_t i = b->i_buffer / 4;
+    const __m128 scale = _mm_set1_ps(32768.f);
+
+    for (; i >= 8; i -= 8, src += 8, dst += 8)
+    {
+        __m128i lo = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(src),     scale));
+        __m128i hi = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(src + 4), scale));
+        _mm_storeu_si128((__m128i *)dst, _mm_packs_epi32(lo, hi));
+    }
+    for (; i > 0; i--) {
+        union { float f; int32_t i; } u;
+        u.f = *src++ + 384.f;
+        if (u.i > 0x43c07fff)
+            *dst++ = 32767;
+        else if (u.i < 0x43bf8000)
+            *dst++ = -32768;
+        else
+            *dst++ = u.i - 0x43c00000;
+    }
+    b->i_buffer /= 2;
+    return b;
+}
+
+VLC_TARGET_SSE2
+static block_t *Fl32toFl64_SSE2(filter_t *filter, block_t *bsrc)
+{
+    block_t *bdst = block_Alloc(bsrc->i_buffer * 2);
+    if (unlikely(bdst == NULL))
+        goto out;
+
+    block_CopyProperties(bdst, bsrc);
+    float  *src = (float *)bsrc->p_buffer;
+    double *dst = (double *)bdst->p_buffer;
+    size_t i = bsrc->i_buffer / 4;
+
+    for (; i >= 4; i -= 4, src += 4, dst += 4)
+    {
+        __m128 s = _mm_loadu_ps(src);
+        _mm_storeu_pd(dst,     _mm_cvtps_pd(s));
+        _mm_storeu_pd(dst + 2, _mm_cvtps_pd(_mm_movehl_ps(s, s)));
+    }
+    for (; i > 0; i--)
+        *(dst++) = *(src++);
+out:
+    block_Release(bsrc);
+    VLC_UNUSED(filter);
+    return bdst;
+}
+
+VLC_TARGET_SSE2
+static block_t *S32toS16_SSE2(filter_t *filter, block_t *b)
+{
+    VLC_UNUSED(filter);
+    int32_t *src = (int32_t *)b->p_buffer;
+    int16_t *dst = (int16_t *)src;
+    size_t i = b->i_buffer / 4;
+
+    for (; i >= 8; i -= 8, src += 8, dst += 8)
+    {
+        __m128i lo = _mm_srai_epi32(_mm_loadu_si128((const __m128i *)src), 16);
+        __m128i hi = _mm_srai_epi32(_mm_loadu_si128((const __m128i *)(src + 4)), 16);
+        _mm_storeu_si128((__m128i *)dst, _mm_packs_epi32(lo, hi));
+    }
+    for (; i > 0; i--)
+        *dst++ = (*src++) >> 16;
+
+    b->i_buffer /= 2;
+    return b;
+}
+
+VLC_TARGET_SSE2
+static block_t *S32toFl32_SSE2(filter_t *filter, block_t *b)
+{
+    VLC_UNUSED(filter);
+    int32_t *src = (int32_t *)b->p_buffer;
+    float   *dst = (float *)src;
+    size_t i = b->i_buffer / 4;
+    const __m128 scale = _mm_set1_ps(1.f / 2147483648.f);
+
+    for (; i >= 8; i -= 8, src += 8, dst += 8)
+    {
+        __m128i lo = _mm_loadu_si128((const __m128i *)src);
+        __m128i hi = _mm_loadu_si128((const __m128i *)(src + 4));
+        _mm_storeu_ps(dst,     _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+        _mm_storeu_ps(dst + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+    }
+    for (; i > 0; i--)
+        *dst++ = (float)(*src++) / 2147483648.f;
+    return b;
+}
+
+VLC_TARGET_SSE2
+static block_t *Fl64toFl32_SSE2(filter_t *filter, block_t *b)
+{
+    VLC_UNUSED(filter);
+    double *src = (double *)b->p_buffer;
+    float  *dst = (float *)src;
+    size_t i = b->i_buffer / 8;
+
+    for (; i >= 4; i -= 4, src += 4, dst += 4)
+    {
+        __m128 lo = _mm_cvtpd_ps(_mm_loadu_pd(src));
+        __m128 hi = _mm_cvtpd_ps(_mm_loadu_pd(src + 2));
+        _mm_storeu_ps(dst, _mm_movelh_ps(lo, hi));
+    }
+    for (; i > 0; i--)
+        *(dst++) = *(src++);
+    return b;
+}
+#endif
+
+
 /* */
 /* */
-static const struct {
+static const struct cvt_direct {
     vlc_fourcc_t src;
     vlc_fourcc_t dst;
     cvt_t convert;
@@ -474,8 +664,33 @@ static const struct {
     { 0, 0, NULL }
 };
 
+#ifdef CONVERT_USE_SSE2
+static const struct cvt_direct cvt_directs_sse2[] = {
+    { VLC_CODEC_S16N, VLC_CODEC_FL32, S16toFl32_SSE2  },
+    { VLC_CODEC_S16N, VLC_CODEC_S32N, S16toS32_SSE2   },
+
+    { VLC_CODEC_FL32, VLC_CODEC_S16N, Fl32toS16_SSE2  },
+    { VLC_CODEC_FL32, VLC_CODEC_FL64, Fl32toFl64_SSE2 },
+
+    { VLC_CODEC_S32N, VLC_CODEC_S16N, S32toS16_SSE2   },
+    { VLC_CODEC_S32N, VLC_CODEC_FL32, S32toFl32_SSE2  },
+
+    { VLC_CODEC_FL64, VLC_CODEC_FL32, Fl64toFl32_SSE2 },
+
+    { 0, 0, NULL }
+};
+#endif
+
 static cvt_t FindConversion(vlc_fourcc_t src, vlc_fourcc_t dst)
 {
+#ifdef CONVERT_USE_SSE2
+    if (vlc_CPU_SSE2())
+        for (int i = 0; cvt_directs_sse2[i].convert; i++) {
+            if (cvt_directs_sse2[i].src == src &&
+                cvt_directs_sse2[i].dst == dst)
+                return cvt_directs_sse2[i].convert;
+        }
+#endif
     for (int i = 0; cvt_directs[i].convert; i++) {
         if (cvt_directs[i].src == src &&
             cvt_directs[i].dst == dst)
@@ -37,9 +37,20 @@
 
 #include <vlc_aout.h>
 #include <vlc_filter.h>
+#include <vlc_cpu.h>
 
 #include "equalizer_presets.h"
 
+#if defined(CAN_COMPILE_SSE2) && (defined(__i386__) || defined(__x86_64__))
+# define EQZ_USE_SSE2
+# include <emmintrin.h>
+# ifndef __SSE2__
+#  define VLC_TARGET_SSE2 __attribute__((__target__("sse2")))
+# else
+#  define VLC_TARGET_SSE2
+# endif
+#endif
+
 /* TODO:
  *  - optimize a bit (you can hardly do slower ;)
  *  - add tables for more bands (15 and 32 would be cool), maybe with auto coeffs
@@ -114,13 +125,16 @@ struct filter_sys_t
     float f_gamp;   /* Global preamp */
     bool b_2eqz;
 
-    /* Filter state */
+    /* Filter state. The two delay slots of each band are kept in separate
+     * planes so that all the bands of a channel can be stepped with SIMD */
     float x[32][2];
-    float y[32][128][2];
+    float y_0[32][128];
+    float y_1[32][128];
 
     /* Second filter state */
     float x2[32][2];
-    float y2[32][128][2];
+    float y2_0[32][128];
+    float y2_1[32][128];
 
     vlc_mutex_t lock;
 };
@@ -288,11 +302,13 @@ static int EqzInit( filter_t *p_filter, int i_rate )
     bool b_vlcFreqs = var_InheritBool( p_aout, "equalizer-vlcfreqs" );
     EqzCoeffs( i_rate, 1.0f, b_vlcFreqs, &cfg );
 
-    /* Create the static filter config */
+    /* Create the static filter config. The arrays are padded to a multiple
+     * of 4 bands with null coefficients so the SIMD path needs no tail. */
     p_sys->i_band = cfg.i_band;
-    p_sys->f_alpha = malloc( p_sys->i_band * sizeof(float) );
-    p_sys->f_beta  = malloc( p_sys->i_band * sizeof(float) );
-    p_sys->f_gamma = malloc( p_sys->i_band * sizeof(float) );
+    const int i_band_padded = ( cfg.i_band + 3 ) & ~3;
+    p_sys->f_alpha = calloc( i_band_padded, sizeof(float) );
+    p_sys->f_beta  = calloc( i_band_padded, sizeof(float) );
+    p_sys->f_gamma = calloc( i_band_padded, sizeof(float) );
     if( !p_sys->f_alpha || !p_sys->f_beta || !p_sys->f_gamma )
         goto error;
 
@@ -306,15 +322,10 @@ static int EqzInit( filter_t *p_filter, int i_rate )
     /* Filter dyn config */
     p_sys->b_2eqz = false;
     p_sys->f_gamp = 1.0f;
-    p_sys->f_amp  = malloc( p_sys->i_band * sizeof(float) );
+    p_sys->f_amp  = calloc( i_band_padded, sizeof(float) );
     if( !p_sys->f_amp )
         goto error;
 
-    for( i = 0; i < p_sys->i_band; i++ )
-    {
-        p_sys->f_amp[i] = 0.0f;
-    }
-
     /* Filter state */
     for( ch = 0; ch < 32; ch++ )
     {
@@ -325,10 +336,10 @@ static int EqzInit( filter_t *p_filter, int i_rate )
 
         for( i = 0; i < p_sys->i_band; i++ )
         {
-            p_sys->y[ch][i][0]  =
-            p_sys->y[ch][i][1]  =
-            p_sys->y2[ch][i][0] =
-            p_sys->y2[ch][i][1] = 0.0f;
+            p_sys->y_0[ch][i]  =
+            p_sys->y_1[ch][i]  =
+            p_sys->y2_0[ch][i] =
+            p_sys->y2_1[ch][i] = 0.0f;
         }
     }
 
@@ -385,11 +396,79 @@ error:
     return i_ret;
 }
 
+/**
+ * Steps every band of one channel by one sample and returns the
+ * accumulated band output. \p f_in is the input minus the two-sample
+ * delayed input; it does not depend on the band.
+ */
+static float EqzBands( const float *f_alpha, const float *f_beta,
+                       const float *f_gamma, const float *f_amp,
+                       float *y_0, float *y_1, float f_in, int i_band )
+{
+    float o = 0.0f;
+
+    for( int j = 0; j < i_band; j++ )
+    {
+        float y = f_alpha[j] * f_in +
+                  f_gamma[j] * y_0[j] -
+                  f_beta[j]  * y_1[j];
+
+        y_1[j] = y_0[j];
+        y_0[j] = y;
+
+        o += y * f_amp[j];
+    }
+    return o;
+}
+
+#ifdef EQZ_USE_SSE2
+/* Same as EqzBands(), four bands per step. The bands are independent of
+ * each other; only the time recursion is serial. i_band must be a
+ * multiple of 4, which the coefficient padding in EqzInit() guarantees. */
+VLC_TARGET_SSE2
+static float EqzBands_SSE2( const float *f_alpha, const float *f_beta,
+                            const float *f_gamma, const float *f_amp,
+                            float *y_0, float *y_1, float f_in, int i_band )
+{
+    const __m128 xv = _mm_set1_ps( f_in );
+    __m128 acc = _mm_setzero_ps();
+
+    for( int j = 0; j < i_band; j += 4 )
+    {
+        __m128 y0 = _mm_loadu_ps( y_0 + j );
+        __m128 y = _mm_add_ps(
+            _mm_mul_ps( _mm_loadu_ps( f_alpha + j ), xv ),
+            _mm_sub_ps( _mm_mul_ps( _mm_loadu_ps( f_gamma + j ), y0 ),
+                        _mm_mul_ps( _mm_loadu_ps( f_beta + j ),
+                                    _mm_loadu_ps( y_1 + j ) ) ) );
+
+        _mm_storeu_ps( y_1 + j, y0 );
+        _mm_storeu_ps( y_0 + j, y );
+
+        acc = _mm_add_ps( acc, _mm_mul_ps( y, _mm_loadu_ps( f_amp + j ) ) );
+    }
+    acc = _mm_add_ps( acc, _mm_movehl_ps( acc, acc ) );
+    acc = _mm_add_ss( acc, _mm_shuffle_ps( acc, acc, 1 ) );
+    return _mm_cvtss_f32( acc );
+}
+#endif
+
 static void EqzFilter( filter_t *p_filter, float *out, float *in,
                        int i_samples, int i_channels )
 {
     filter_sys_t *p_sys = p_filter->p_sys;
-    int i, ch, j;
+    int i, ch;
+
+    float (*pf_bands)( const float *, const float *, const float *,
+                       const float *, float *, float *, float, int ) = EqzBands;
+    int i_band = p_sys->i_band;
+#ifdef EQZ_USE_SSE2
+    if( vlc_CPU_SSE2() )
+    {
+        pf_bands = EqzBands_SSE2;
+        i_band = ( i_band + 3 ) & ~3; /* padded with null coefficients */
+    }
+#endif
 
     vlc_mutex_lock( &p_sys->lock );
     for( i = 0; i < i_samples; i++ )
@@ -397,19 +476,10 @@ static void EqzFilter( filter_t *p_filter, float *out, float *in,
         for( ch = 0; ch < i_channels; ch++ )
         {
             const float x = in[ch];
-            float o = 0.0f;
-
-            for( j = 0; j < p_sys->i_band; j++ )
-            {
-                float y = p_sys->f_alpha[j] * ( x - p_sys->x[ch][1] ) +
-                          p_sys->f_gamma[j] * p_sys->y[ch][j][0] -
-                          p_sys->f_beta[j]  * p_sys->y[ch][j][1];
-
-                p_sys->y[ch][j][1] = p_sys->y[ch][j][0];
-                p_sys->y[ch][j][0] = y;
+            float o = pf_bands( p_sys->f_alpha, p_sys->f_beta, p_sys->f_gamma,
+                                p_sys->f_amp, p_sys->y_0[ch], p_sys->y_1[ch],
+                                x - p_sys->x[ch][1], i_band );
 
-                o += y * p_sys->f_amp[j];
-            }
             p_sys->x[ch][1] = p_sys->x[ch][0];
             p_sys->x[ch][0] = x;
 
@@ -417,18 +487,10 @@ static void EqzFilter( filter_t *p_filter, float *out, float *in,
             if( p_sys->b_2eqz )
             {
                 const float x2 = EQZ_IN_FACTOR * x + o;
-                o = 0.0f;
-                for( j = 0; j < p_sys->i_band; j++ )
-                {
-                    float y = p_sys->f_alpha[j] * ( x2 - p_sys->x2[ch][1] ) +
-                              p_sys->f_gamma[j] * p_sys->y2[ch][j][0] -
-                              p_sys->f_beta[j]  * p_sys->y2[ch][j][1];
-
-                    p_sys->y2[ch][j][1] = p_sys->y2[ch][j][0];
-                    p_sys->y2[ch][j][0] = y;
-
-                    o += y * p_sys->f_amp[j];
-                }
+                o = pf_bands( p_sys->f_alpha, p_sys->f_beta, p_sys->f_gamma,
+                              p_sys->f_amp, p_sys->y2_0[ch], p_sys->y2_1[ch],
+                              x2 - p_sys->x2[ch][1], i_band );
+
                 p_sys->x2[ch][1] = p_sys->x2[ch][0];
                 p_sys->x2[ch][0] = x2;
 
@@ -42,11 +42,22 @@
 #include <vlc_aout.h>
 #include <vlc_filter.h>
 #include <vlc_block.h>
+#include <vlc_cpu.h>
 
 #include <assert.h>
 
 #include "bandlimited.h"
 
+#if defined(CAN_COMPILE_SSE2) && (defined(__i386__) || defined(__x86_64__))
+# define RESAMPLE_USE_SSE2
+# include <emmintrin.h>
+# ifndef __SSE2__
+#  define VLC_TARGET_SSE2 __attribute__((__target__("sse2")))
+# else
+#  define VLC_TARGET_SSE2
+# endif
+#endif
+
 /*****************************************************************************
  * Local prototypes
  *****************************************************************************/
@@ -336,6 +347,24 @@ static void CloseFilter( vlc_object_t *p_this )
     free( p_filter->p_sys );
 }
 
+#ifdef RESAMPLE_USE_SSE2
+/* p_out[i] += t * p_in[i], vectorized over the channels of one frame */
+VLC_TARGET_SSE2
+static void MacFloat_SSE2( float *p_out, const float *p_in, float t, int n )
+{
+    const __m128 tv = _mm_set1_ps( t );
+    int i = 0;
+
+    for( ; i + 4 <= n; i += 4 )
+        _mm_storeu_ps( p_out + i,
+                       _mm_add_ps( _mm_loadu_ps( p_out + i ),
+                                   _mm_mul_ps( _mm_loadu_ps( p_in + i ),
+                                               tv ) ) );
+    for( ; i < n; i++ )
+        p_out[i] += t * p_in[i];
+}
+#endif
+
 static void FilterFloatUP( const float Imp[], const float ImpD[], uint16_t Nwing, float *p_in,
                             float *p_out, uint32_t ui_remainder,
                             uint32_t ui_output_rate, int16_t Inc, int i_nb_channels )
@@ -363,10 +392,19 @@ static void FilterFloatUP( const float Imp[], const float ImpD[], uint16_t Nwing
         }
     }
 
+    /* Linear interpolation phase, hoisted out of the loop: it does not
+     * depend on the tap, only on the output phase remainder */
+    const float f_phase = (float)ui_linear_remainder / ui_output_rate / Npc;
+
     while (Hp < End) {
         t = *Hp;                /* Get filter coeff */
                                 /* t is now interp'd filter coeff */
-        t += *Hdp * ui_linear_remainder / ui_output_rate / Npc;
+        t += *Hdp * f_phase;
+#ifdef RESAMPLE_USE_SSE2
+        if( i_nb_channels >= 4 && vlc_CPU_SSE2() )
+            MacFloat_SSE2( p_out, p_in, t, i_nb_channels );
+        else
+#endif
         for( i = 0; i < i_nb_channels; i++ )
         {
             temp = t;
@@ -407,6 +445,9 @@ static void FilterFloatUD( const float Imp[], const float ImpD[], uint16_t Nwing
         }
     }
 
+    /* Hoist the per-tap divisions; only the remainder varies below */
+    const float f_scale = 1.f / ( (float)ui_input_rate * Npc );
+
     while (Hp < End) {
         t = *Hp;                /* Get filter coeff */
                                 /* t is now interp'd filter coeff */
@@ -414,7 +455,12 @@ static void FilterFloatUD( const float Imp[], const float ImpD[], uint16_t Nwing
           ((ui_output_rate * ui_counter + ui_remainder)<< Nhc) -
           ((ui_output_rate * ui_counter + ui_remainder)<< Nhc) /
           ui_input_rate * ui_input_rate;
-        t += *Hdp * ui_linear_remainder / ui_input_rate / Npc;
+        t += *Hdp * ui_linear_remainder * f_scale;
+#ifdef RESAMPLE_USE_SSE2
+        if( i_nb_channels >= 4 && vlc_CPU_SSE2() )
+            MacFloat_SSE2( p_out, p_in, t, i_nb_channels );
+        else
+#endif
         for( i = 0; i < i_nb_channels; i++ )
         {
             temp = t;
@@ -34,6 +34,26 @@
 #include <vlc_plugin.h>
 #include <vlc_aout.h>
 #include <vlc_aout_volume.h>
+#include <vlc_cpu.h>
+
+#if defined(CAN_COMPILE_SSE2) && (defined(__i386__) || defined(__x86_64__))
+# define VOLUME_USE_SSE2
+# include <emmintrin.h>
+# ifndef __SSE2__
+#  define VLC_TARGET_SSE2 __attribute__((__target__("sse2")))
+# else
+#  define VLC_TARGET_SSE2
+# endif
+#endif
+#if defined(CAN_COMPILE_AVX) && (defined(__i386__) || defined(__x86_64__))
+# define VOLUME_USE_AVX
+# include <immintrin.h>
+# ifndef __AVX__
+#  define VLC_TARGET_AVX __attribute__((__target__("avx")))
+# else
+#  define VLC_TARGET_AVX
+# endif
+#endif
 
 /*****************************************************************************
  * Local prototypes
@@ -81,20 +101,137 @@ static void FilterFL64( audio_volume_t *p_volume, block_t *p_buffer,
     (void) p_volume;
 }
 
+#ifdef VOLUME_USE_SSE2
+VLC_TARGET_SSE2
+static void FilterFL32_SSE2( audio_volume_t *p_volume, block_t *p_buffer,
+                             float f_multiplier )
+{
+    if( f_multiplier == 1.f )
+        return; /* nothing to do */
+
+    float *p = (float *)p_buffer->p_buffer;
+    size_t i = p_buffer->i_buffer / sizeof(*p);
+    const __m128 m = _mm_set1_ps( f_multiplier );
+
+    for( ; i >= 8; i -= 8, p += 8 )
+    {
+        _mm_storeu_ps( p,     _mm_mul_ps( _mm_loadu_ps( p ),     m ) );
+        _mm_storeu_ps( p + 4, _mm_mul_ps( _mm_loadu_ps( p + 4 ), m ) );
+    }
+    for( ; i > 0; i--, p++ )
+        *p *= f_multiplier;
+
+    (void) p_volume;
+}
+
+VLC_TARGET_SSE2
+static void FilterFL64_SSE2( audio_volume_t *p_volume, block_t *p_buffer,
+                             float f_multiplier )
+{
+    double *p = (double *)p_buffer->p_buffer;
+    double mult = f_multiplier;
+    if( mult == 1. )
+        return; /* nothing to do */
+
+    size_t i = p_buffer->i_buffer / sizeof(*p);
+    const __m128d m = _mm_set1_pd( mult );
+
+    for( ; i >= 4; i -= 4, p += 4 )
+    {
+        _mm_storeu_pd( p,     _mm_mul_pd( _mm_loadu_pd( p ),     m ) );
+        _mm_storeu_pd( p + 2, _mm_mul_pd( _mm_loadu_pd( p + 2 ), m ) );
+    }
+    for( ; i > 0; i--, p++ )
+        *p *= mult;
+
+    (void) p_volume;
+}
+#endif
+
+#ifdef VOLUME_USE_AVX
+VLC_TARGET_AVX
+static void FilterFL32_AVX( audio_volume_t *p_volume, block_t *p_buffer,
+                            float f_multiplier )
+{
+    if( f_multiplier == 1.f )
+        return; /* nothing to do */
+
+    float *p = (float *)p_buffer->p_buffer;
+    size_t i = p_buffer->i_buffer / sizeof(*p);
+    const __m256 m = _mm256_set1_ps( f_multiplier );
+
+    for( ; i >= 16; i -= 16, p += 16 )
+    {
+        _mm256_storeu_ps( p,     _mm256_mul_ps( _mm256_loadu_ps( p ),     m ) );
+        _mm256_storeu_ps( p + 8, _mm256_mul_ps( _mm256_loadu_ps( p + 8 ), m ) );
+    }
+    for( ; i > 0; i--, p++ )
+        *p *= f_multiplier;
+
+    (void) p_volume;
+}
+
+VLC_TARGET_AVX
+static void FilterFL64_AVX( audio_volume_t *p_volume, block_t *p_buffer,
+                            float f_multiplier )
+{
+    double *p = (double *)p_buffer->p_buffer;
+    double mult = f_multiplier;
+    if( mult == 1. )
+        return; /* nothing to do */
+
+    size_t i = p_buffer->i_buffer / sizeof(*p);
+    const __m256d m = _mm256_set1_pd( mult );
+
+    for( ; i >= 8; i -= 8, p += 8 )
+    {
+        _mm256_storeu_pd( p,     _mm256_mul_pd( _mm256_loadu_pd( p ),     m ) );
+        _mm256_storeu_pd( p + 4, _mm256_mul_pd( _mm256_loadu_pd( p + 4 ), m ) );
+    }
+    for( ; i > 0; i--, p++ )
+        *p *= mult;
+
+    (void) p_volume;
+}
+#endif
+
+static const vlc_cpu_dispatch_t dispatchFL32[] =
+{
+#ifdef VOLUME_USE_AVX
+    { VLC_CPU_AVX,  (vlc_cpu_fn_t)FilterFL32_AVX },
+#endif
+#ifdef VOLUME_USE_SSE2
+    { VLC_CPU_SSE2, (vlc_cpu_fn_t)FilterFL32_SSE2 },
+#endif
+    { 0,            (vlc_cpu_fn_t)FilterFL32 },
+};
+
+static const vlc_cpu_dispatch_t dispatchFL64[] =
+{
+#ifdef VOLUME_USE_AVX
+    { VLC_CPU_AVX,  (vlc_cpu_fn_t)FilterFL64_AVX },
+#endif
+#ifdef VOLUME_USE_SSE2
+    { VLC_CPU_SSE2, (vlc_cpu_fn_t)FilterFL64_SSE2 },
+#endif
+    { 0,            (vlc_cpu_fn_t)FilterFL64 },
+};
+
 /**
  * Initializes the mixer
  */
 static int Create( vlc_object_t *p_this )
 {
     audio_volume_t *p_volume = (audio_volume_t *)p_this;
+    typedef void (*amplify_fn_t)(audio_volume_t *, block_t *, float);
 
     switch (p_volume->format)
     {
         case VLC_CODEC_FL32:
-            p_volume->amplify = FilterFL32;
+            p_volume->amplify = (amplify_fn_t)vlc_CPU_resolve( dispatchFL32 );
             break;
         case VLC_CODEC_FL64:
-            p_volume->amplify = FilterFL64;
+            p_volume->amplify = (amplify_fn_t)vlc_CPU_resolve( dispatchFL64 );
             break;
         default:
             return -1;
@@ -29,6 +29,7 @@
 #endif
 
 #include <assert.h>
+#include <errno.h>
 
 #include <vlc_common.h>
 #include <vlc_plugin.h>
@@ -48,6 +49,7 @@ struct aout_sys_t
     uint8_t chans_table[AOUT_CHAN_MAX]; /**< Channels order table */
     uint8_t chans_to_reorder; /**< Number of channels to reorder */
 
+    bool mmap; /**< Whether the device buffer is memory-mapped */
     bool soft_mute;
     float soft_gain;
     char *device;
@@ -64,6 +66,12 @@ static int EnumDevices (vlc_object_t *, char const *, char ***, char ***);
 #define AUDIO_DEV_TEXT N_("Audio output device")
 #define AUDIO_DEV_LONGTEXT N_("Audio output device (using ALSA syntax).")
 
+#define AUDIO_MMAP_TEXT N_("Memory-mapped audio output")
+#define AUDIO_MMAP_LONGTEXT N_("Write samples directly into the " \
+    "memory-mapped device buffer instead of copying them through a write " \
+    "system call. This saves one copy of all audio data, but not all " \
+    "devices and plugins support it.")
+
 #define AUDIO_CHAN_TEXT N_("Audio output channels")
 #define AUDIO_CHAN_LONGTEXT N_("Channels available for audio output. " \
     "If the input has more channels than the output, it will be down-mixed. " \
@@ -85,6 +93,8 @@ vlc_module_begin ()
     add_string ("alsa-audio-device", "default",
                 AUDIO_DEV_TEXT, AUDIO_DEV_LONGTEXT, false)
         change_string_cb (EnumDevices)
+    add_bool ("alsa-audio-mmap", false,
+              AUDIO_MMAP_TEXT, AUDIO_MMAP_LONGTEXT, true)
     add_integer ("alsa-audio-channels", AOUT_CHANS_FRONT,
                  AUDIO_CHAN_TEXT, AUDIO_CHAN_LONGTEXT, false)
         change_integer_list (channels, channels_text)
@@ -276,6 +286,7 @@ out:
 
 static int TimeGet (audio_output_t *aout, mtime_t *);
 static void Play (audio_output_t *, block_t *);
+static void PlayMmap (audio_output_t *, block_t *);
 static void Pause (audio_output_t *, bool, mtime_t);
 static void PauseDummy (audio_output_t *, bool, mtime_t);
 static void Flush (audio_output_t *, bool);
@@ -415,12 +426,28 @@ static int Start (audio_output_t *aout, audio_sample_format_t *restrict fmt)
         goto error;
     }
 
-    val = snd_pcm_hw_params_set_access (pcm, hw,
-                                        SND_PCM_ACCESS_RW_INTERLEAVED);
-    if (val)
+    /* Memory-mapped access spares the copy through the write system call,
+     * but some devices and alsa-lib plugins do not support it. */
+    sys->mmap = false;
+    if (!spdif && var_InheritBool (aout, "alsa-audio-mmap"))
     {
-        msg_Err (aout, "cannot set access mode: %s", snd_strerror (val));
-        goto error;
+        val = snd_pcm_hw_params_set_access (pcm, hw,
+                                            SND_PCM_ACCESS_MMAP_INTERLEAVED);
+        if (val == 0)
+            sys->mmap = true;
+        else
+            msg_Warn (aout, "cannot map device buffer: %s",
+                      snd_strerror (val));
+    }
+    if (!sys->mmap)
+    {
+        val = snd_pcm_hw_params_set_access (pcm, hw,
+                                            SND_PCM_ACCESS_RW_INTERLEAVED);
+        if (val)
+        {
+            msg_Err (aout, "cannot set access mode: %s", snd_strerror (val));
+            goto error;
+        }
     }
 
     /* Set sample format */
@@ -585,7 +612,7 @@ static int Start (audio_output_t *aout, audio_sample_format_t *restrict fmt)
     sys->format = fmt->i_format;
 
     aout->time_get = TimeGet;
-    aout->play = Play;
+    aout->play = sys->mmap ? PlayMmap : Play;
     if (snd_pcm_hw_params_can_pause (hw))
         aout->pause = Pause;
     else
@@ -617,6 +644,24 @@ static int TimeGet (audio_output_t *aout, mtime_t *restrict delay)
     return 0;
 }
 
+/**
+ * Recovers the stream from an underrun or a suspend.
+ * @return zero if playback can go on, an error otherwise
+ */
+static int Recover (audio_output_t *aout, int err)
+{
+    snd_pcm_t *pcm = aout->sys->pcm;
+
+    int val = snd_pcm_recover (pcm, err, 1);
+    if (val)
+    {
+        msg_Err (aout, "cannot recover playback stream: %s",
+                 snd_strerror (val));
+        DumpDeviceStatus (aout, pcm);
+    }
+    return val;
+}
+
 /**
  * Queues one audio buffer to the hardware.
  */
@@ -646,22 +691,79 @@ static void Play (audio_output_t *aout, block_t *block)
             block->i_buffer -= bytes;
             // pts, length
         }
-        else  
+        else
         {
-            int val = snd_pcm_recover (pcm, frames, 1);
-            if (val)
-            {
-                msg_Err (aout, "cannot recover playback stream: %s",
-                         snd_strerror (val));
-                DumpDeviceStatus (aout, pcm);
+            if (Recover (aout, frames))
                 break;
-            }
             msg_Warn (aout, "cannot write samples: %s", snd_strerror (frames));
         }
     }
     block_Release (block);
 }
 
+/**
+ * Queues one audio buffer directly through the memory-mapped device buffer.
+ */
+static void PlayMmap (audio_output_t *aout, block_t *block)
+{
+    aout_sys_t *sys = aout->sys;
+    snd_pcm_t *pcm = sys->pcm;
+
+    if (sys->chans_to_reorder != 0)
+        aout_ChannelReorder(block->p_buffer, block->i_buffer,
+                           sys->chans_to_reorder, sys->chans_table, sys->format);
+
+    while (block->i_nb_samples > 0)
+    {
+        snd_pcm_sframes_t avail = snd_pcm_avail_update (pcm);
+
+        if (avail == 0)
+        {   /* The whole device buffer is queued. Wait for a period. */
+            int val = snd_pcm_wait (pcm, -1);
+            if (val < 0 && Recover (aout, val))
+                break;
+            continue;
+        }
+
+        const snd_pcm_channel_area_t *areas;
+        snd_pcm_uframes_t offset;
+        snd_pcm_uframes_t frames = block->i_nb_samples;
+
+        int val = (avail < 0) ? avail
+                : snd_pcm_mmap_begin (pcm, &areas, &offset, &frames);
+        if (val < 0)
+        {
+            if (Recover (aout, val))
+                break;
+            msg_Warn (aout, "cannot map samples: %s", snd_strerror (val));
+            continue;
+        }
+
+        /* With interleaved access, the channels share a single area. */
+        memcpy ((char *)areas->addr + (areas->first / 8)
+                                    + snd_pcm_frames_to_bytes (pcm, offset),
+                block->p_buffer, snd_pcm_frames_to_bytes (pcm, frames));
+
+        snd_pcm_sframes_t done = snd_pcm_mmap_commit (pcm, offset, frames);
+        if (done < 0 || (snd_pcm_uframes_t)done != frames)
+        {   /* The period was lost to an underrun while it was written */
+            if (Recover (aout, (done < 0) ? done : -EPIPE))
+                break;
+            continue;
+        }
+
+        size_t bytes = snd_pcm_frames_to_bytes (pcm, done);
+        block->i_nb_samples -= done;
+        block->p_buffer += bytes;
+        block->i_buffer -= bytes;
+
+        /* Memory-mapped writes do not honour the start threshold */
+        if (snd_pcm_state (pcm) == SND_PCM_STATE_PREPARED)
+            snd_pcm_start (pcm);
+    }
+    block_Release (block);
+}
+
 /**
  * Pauses/resumes the audio playback.
  */
@@ -63,6 +63,11 @@ void ffmpeg_CloseCodec( decoder_t *p_dec );
 #define DR_TEXT N_("Direct rendering")
 /* FIXME Does somebody who knows what it does, explain */
 
+#define STRICT_DR_TEXT N_("Strict direct rendering")
+#define STRICT_DR_LONGTEXT N_( \
+    "Renegotiate the video output buffer pool once when a frame cannot be " \
+    "rendered directly, before falling back on copying frames." )
+
 #define ERROR_TEXT N_("Error resilience")
 #define ERROR_LONGTEXT N_( \
     "libavcodec can do error resilience.\n" \
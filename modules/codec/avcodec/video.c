@@ -56,6 +56,7 @@ struct decoder_sys_t
     /* for frame skipping algo */
     bool b_hurry_up;
     enum AVDiscard i_skip_frame;
+    enum AVDiscard i_skip_loop_filter;
 
     /* how many decoded frames are late */
     int     i_late_frames;
@@ -65,6 +66,11 @@ struct decoder_sys_t
     bool        b_direct_rendering;
     atomic_bool b_dr_failure;
 
+    /* zero-copy audit: frames served from the output pool vs copied */
+    bool        b_strict_direct;
+    unsigned    i_direct_frames;
+    unsigned    i_copied_frames;
+
     /* Hack to force display of still pictures */
     bool b_first_frame;
 
@@ -365,6 +371,7 @@ int InitVideoDec( decoder_t *p_dec, AVCodecContext *p_context,
     else if( i_val == 3 ) p_context->skip_loop_filter = AVDISCARD_NONKEY;
     else if( i_val == 2 ) p_context->skip_loop_filter = AVDISCARD_BIDIR;
     else if( i_val == 1 ) p_context->skip_loop_filter = AVDISCARD_NONREF;
+    p_sys->i_skip_loop_filter = p_context->skip_loop_filter;
 
     if( var_CreateGetBool( p_dec, "avcodec-fast" ) )
         p_context->flags2 |= CODEC_FLAG2_FAST;
@@ -392,6 +399,9 @@ int InitVideoDec( decoder_t *p_dec, AVCodecContext *p_context,
     /* ***** libavcodec direct rendering ***** */
     p_sys->b_direct_rendering = false;
     atomic_init(&p_sys->b_dr_failure, false);
+    p_sys->b_strict_direct = var_InheritBool( p_dec, "avcodec-strict-dr" );
+    p_sys->i_direct_frames = 0;
+    p_sys->i_copied_frames = 0;
     if( var_CreateGetBool( p_dec, "avcodec-dr" ) &&
        (p_codec->capabilities & CODEC_CAP_DR1) &&
         /* No idea why ... but this fixes flickering on some TSCC streams */
@@ -611,12 +621,27 @@ static picture_t *DecodeVideo( decoder_t *p_dec, block_t **pp_block )
     }
     else
     {
-        if( p_sys->b_hurry_up )
-            p_context->skip_frame = p_sys->i_skip_frame;
         if( !p_block || !(p_block->i_flags & BLOCK_FLAG_PREROLL) )
+        {
+            if( p_sys->b_hurry_up ||
+                p_context->skip_frame > p_sys->i_skip_frame )
+                p_context->skip_frame = p_sys->i_skip_frame;
+            if( p_context->skip_loop_filter > p_sys->i_skip_loop_filter )
+                p_context->skip_loop_filter = p_sys->i_skip_loop_filter;
             b_drawpicture = 1;
+        }
         else
+        {
+            /* Preroll frames are only decoded to rebuild the reference
+             * chain up to the seek target: frames nothing is predicted
+             * from can be skipped wholesale, and those that are kept
+             * only need loop filtering where it feeds prediction. */
+            if( p_context->skip_frame < AVDISCARD_NONREF )
+                p_context->skip_frame = AVDISCARD_NONREF;
+            if( p_context->skip_loop_filter < AVDISCARD_NONREF )
+                p_context->skip_loop_filter = AVDISCARD_NONREF;
             b_drawpicture = 0;
+        }
     }
 
     if( p_context->width <= 0 || p_context->height <= 0 )
@@ -813,12 +838,14 @@ static picture_t *DecodeVideo( decoder_t *p_dec, block_t **pp_block )
 
             /* Fill picture_t from AVFrame */
             lavc_CopyPicture(p_dec, p_pic, frame);
+            p_sys->i_copied_frames++;
         }
         else
         {
             if( p_sys->p_va != NULL )
                 vlc_va_Extract( p_sys->p_va, p_pic, frame->data[3] );
             picture_Hold( p_pic );
+            p_sys->i_direct_frames++;
         }
 
         if( !p_dec->fmt_in.video.i_sar_num || !p_dec->fmt_in.video.i_sar_den )
@@ -870,6 +897,10 @@ void EndVideoDec( decoder_t *p_dec )
 {
     decoder_sys_t *p_sys = p_dec->p_sys;
 
+    if( p_sys->i_direct_frames > 0 || p_sys->i_copied_frames > 0 )
+        msg_Dbg( p_dec, "zero-copy audit: %u frame(s) direct, %u copied",
+                 p_sys->i_direct_frames, p_sys->i_copied_frames );
+
     post_mt( p_sys );
 
     /* do not flush buffers if codec hasn't been opened (theora/vorbis/VC1) */
@@ -1110,6 +1141,20 @@ static int lavc_GetFrame(struct AVCodecContext *ctx, AVFrame *frame, int flags)
     /* Some codecs set pix_fmt only after the 1st frame has been decoded,
      * so we need to check for direct rendering again. */
     int ret = lavc_dr_GetFrame(ctx, frame, pic);
+    if (ret && sys->b_strict_direct)
+    {
+        /* Renegotiate the output pool once before accepting copies; the
+         * failure may come from a pool set up for a stale format. The MT
+         * semaphore must be held to protect p_dec->fmt_out. */
+        wait_mt(sys);
+        ret = lavc_UpdateVideoFormat(dec, ctx, ctx->pix_fmt, ctx->pix_fmt);
+        post_mt(sys);
+        if (ret == 0)
+        {
+            pic = decoder_GetPicture(dec);
+            ret = (pic != NULL) ? lavc_dr_GetFrame(ctx, frame, pic) : -1;
+        }
+    }
     if (ret)
         ret = avcodec_default_get_buffer2(ctx, frame, flags);
     return ret;
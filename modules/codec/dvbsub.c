@@ -155,6 +155,7 @@ typedef struct dvbsub_objectdef_s
 {
     int i_id;
     int i_type;
+    int i_version; /* last object_version decoded here, -1 if none yet */
     int i_x;
     int i_y;
     int i_fg_pc;
@@ -979,6 +980,7 @@ static void decode_region_composition( decoder_t *p_dec, bs_t *s )
         p_obj = &p_region->p_object_defs[p_region->i_object_defs - 1];
         p_obj->i_id         = bs_read( s, 16 );
         p_obj->i_type       = bs_read( s, 2 );
+        p_obj->i_version    = -1;
         bs_skip( s, 2 ); /* Provider */
         p_obj->i_x          = bs_read( s, 12 );
         bs_skip( s, 4 ); /* Reserved */
@@ -1074,14 +1076,14 @@ static void decode_object( decoder_t *p_dec, bs_t *s )
 {
     decoder_sys_t *p_sys = p_dec->p_sys;
     dvbsub_region_t *p_region;
-    int i_segment_length, i_coding_method, i_id, i;
+    int i_segment_length, i_coding_method, i_version, i_id, i;
 
     /* ETSI 300-743 paragraph 7.2.4
      * sync_byte, segment_type and page_id have already been processed.
      */
     i_segment_length = bs_read( s, 16 );
     i_id             = bs_read( s, 16 );
-    bs_skip( s, 4 ); /* version */
+    i_version        = bs_read( s, 4 );
     i_coding_method  = bs_read( s, 2 );
 
     if( i_coding_method > 1 )
@@ -1091,13 +1093,16 @@ static void decode_object( decoder_t *p_dec, bs_t *s )
         return;
     }
 
-    /* Check if the object needs to be rendered in at least one
-     * of the regions */
+    /* Check if the object needs to be rendered in at least one of the
+     * regions. Unchanged versions are retransmitted with every display
+     * set; the region pixel buffers already hold their rendering, so
+     * only out of date placements are worth the trip. */
     for( p_region = p_sys->p_regions; p_region != NULL;
          p_region = p_region->p_next )
     {
         for( i = 0; i < p_region->i_object_defs; i++ )
-            if( p_region->p_object_defs[i].i_id == i_id ) break;
+            if( ( p_region->p_object_defs[i].i_id == i_id ) &&
+                ( p_region->p_object_defs[i].i_version != i_version ) ) break;
 
         if( i != p_region->i_object_defs ) break;
     }
@@ -1140,6 +1145,8 @@ static void decode_object( decoder_t *p_dec, bs_t *s )
             for( i = 0; i < p_region->i_object_defs; i++ )
             {
                 if( p_region->p_object_defs[i].i_id != i_id ) continue;
+                if( p_region->p_object_defs[i].i_version == i_version )
+                    continue;
 
                 dvbsub_render_pdata( p_dec, p_region,
                                      p_region->p_object_defs[i].i_x,
@@ -1161,6 +1168,8 @@ static void decode_object( decoder_t *p_dec, bs_t *s )
                                          p_region->p_object_defs[i].i_y + 1,
                                          p_topfield, i_topfield );
                 }
+
+                p_region->p_object_defs[i].i_version = i_version;
             }
         }
     }
@@ -1186,6 +1195,9 @@ static void decode_object( decoder_t *p_dec, bs_t *s )
                 int j;
 
                 if( p_region->p_object_defs[i].i_id != i_id ) continue;
+                if( p_region->p_object_defs[i].i_version == i_version )
+                    continue;
+                p_region->p_object_defs[i].i_version = i_version;
 
                 p_region->p_object_defs[i].psz_text =
                     xrealloc( p_region->p_object_defs[i].psz_text,
@@ -28,6 +28,8 @@
 # include "config.h"
 #endif
 
+#include <assert.h>
+
 #include <vlc_common.h>
 #include <vlc_plugin.h>
 #include <vlc_input.h>
@@ -74,6 +76,13 @@ vlc_module_begin ()
 
 vlc_module_end ()
 
+/* Batch output size, in samples at 48 kHz. Packets shorter than this (the
+ * 10 ms and below frames of low-latency streams) are decoded back to back
+ * into one output buffer instead of one buffer per packet, so the aout
+ * pipeline runs per 20 ms block as it would for a standard stream. This
+ * also bounds the latency added by batching to under 20 ms. */
+#define OPUS_BATCH_SAMPLES 960
+
 /*****************************************************************************
  * decoder_sys_t : opus decoder descriptor
  *****************************************************************************/
@@ -90,6 +99,14 @@ struct decoder_sys_t
     OpusHeader header;
     OpusMSDecoder *p_st;
 
+    /*
+     * Output batching: small packets accumulate here until
+     * OPUS_BATCH_SAMPLES are ready (see DecodePacket())
+     */
+    block_t *p_batch;
+    int      i_batch_capacity;  /**< In samples */
+    block_t *p_pending;         /**< Emitted block waiting for a drain call */
+
     /*
      * Common properties
      */
@@ -189,10 +206,33 @@ static int OpenDecoder( vlc_object_t *p_this )
     p_dec->pf_flush        = Flush;
 
     p_sys->p_st = NULL;
+    p_sys->p_batch = NULL;
+    p_sys->i_batch_capacity = 0;
+    p_sys->p_pending = NULL;
 
     return VLC_SUCCESS;
 }
 
+/* Hands out the accumulated batch, sized down to its payload.
+ * Returns NULL if nothing was accumulated. */
+static block_t *BatchEmit( decoder_t *p_dec )
+{
+    decoder_sys_t *p_sys = p_dec->p_sys;
+    block_t *p_batch = p_sys->p_batch;
+
+    p_sys->p_batch = NULL;
+    if( p_batch == NULL )
+        return NULL;
+    if( p_batch->i_nb_samples == 0 )
+    {
+        block_Release( p_batch );
+        return NULL;
+    }
+    p_batch->i_buffer = p_batch->i_nb_samples *
+                        p_sys->header.channels * sizeof(float);
+    return p_batch;
+}
+
 /****************************************************************************
  * DecodeBlock: the whole thing
  ****************************************************************************
@@ -203,9 +243,20 @@ static block_t *DecodeBlock( decoder_t *p_dec, block_t **pp_block )
     decoder_sys_t *p_sys = p_dec->p_sys;
     ogg_packet oggpacket;
 
-    if( !pp_block || !*pp_block)
+    if( !pp_block )
         return NULL;
 
+    if( !*pp_block )
+    {
+        /* Drain call: the core loops here after a non-NULL return and at
+         * the end of the stream, so no batched samples get stranded */
+        block_t *p_out = p_sys->p_pending;
+        p_sys->p_pending = NULL;
+        if( p_out == NULL )
+            p_out = BatchEmit( p_dec );
+        return p_out;
+    }
+
     /* Block to Ogg packet */
     oggpacket.packet = (*pp_block)->p_buffer;
     oggpacket.bytes = (*pp_block)->i_buffer;
@@ -369,6 +420,16 @@ static void Flush( decoder_t *p_dec )
     decoder_sys_t *p_sys = p_dec->p_sys;
 
     date_Set( &p_sys->end_date, 0 );
+    if( p_sys->p_batch )
+    {
+        block_Release( p_sys->p_batch );
+        p_sys->p_batch = NULL;
+    }
+    if( p_sys->p_pending )
+    {
+        block_Release( p_sys->p_pending );
+        p_sys->p_pending = NULL;
+    }
 }
 
 /*****************************************************************************
@@ -386,17 +447,21 @@ static void *ProcessPacket( decoder_t *p_dec, ogg_packet *p_oggpacket,
 
     if( p_block->i_flags & BLOCK_FLAG_CORRUPTED )
     {
+        /* The batched samples predate the corruption and are still good */
         block_Release( p_block );
-        return NULL;
+        return BatchEmit( p_dec );
     }
 
     if( p_block->i_flags & BLOCK_FLAG_DISCONTINUITY )
         Flush( p_dec );
 
     /* Date management */
+    block_t *p_batched = NULL;
     if( p_block->i_pts > VLC_TS_INVALID &&
         p_block->i_pts != date_Get( &p_sys->end_date ) )
     {
+        /* The pending batch is only contiguous up to the old date */
+        p_batched = BatchEmit( p_dec );
         date_Set( &p_sys->end_date, p_block->i_pts );
     }
 
@@ -404,7 +469,7 @@ static void *ProcessPacket( decoder_t *p_dec, ogg_packet *p_oggpacket,
     {
         /* We've just started the stream, wait for the first PTS. */
         block_Release( p_block );
-        return NULL;
+        return p_batched;
     }
 
     block_t *p_aout_buffer = DecodePacket( p_dec, p_oggpacket,
@@ -412,6 +477,16 @@ static void *ProcessPacket( decoder_t *p_dec, ogg_packet *p_oggpacket,
                                            (int)p_block->i_length );
 
     block_Release( p_block );
+    if( p_batched != NULL )
+    {
+        /* Two blocks ready at once: queue the second for the drain call */
+        if( p_aout_buffer != NULL )
+        {
+            assert( p_sys->p_pending == NULL );
+            p_sys->p_pending = p_aout_buffer;
+        }
+        return p_batched;
+    }
     return p_aout_buffer;
 }
 
@@ -422,6 +497,7 @@ static block_t *DecodePacket( decoder_t *p_dec, ogg_packet *p_oggpacket,
                               int i_nb_samples, int i_end_trim )
 {
     decoder_sys_t *p_sys = p_dec->p_sys;
+    const int i_channels = p_sys->header.channels;
 
     if( !p_oggpacket->bytes )
         return NULL;
@@ -436,50 +512,70 @@ static block_t *DecodePacket( decoder_t *p_dec, ogg_packet *p_oggpacket,
     if(!i_nb_samples)
         i_nb_samples = spp;
 
-    block_t *p_aout_buffer=decoder_NewAudioBuffer( p_dec, spp );
-    if ( !p_aout_buffer )
+    /* Emit the pending batch when the new packet would not fit */
+    block_t *p_done = NULL;
+    if( p_sys->p_batch != NULL &&
+        p_sys->i_batch_capacity - p_sys->p_batch->i_nb_samples < (unsigned)spp )
+        p_done = BatchEmit( p_dec );
+
+    if( p_sys->p_batch == NULL )
     {
-        msg_Err(p_dec, "Oops: No new buffer was returned!");
-        return NULL;
+        /* Room for the packet plus a batch's worth of smaller successors */
+        int i_capacity = spp + OPUS_BATCH_SAMPLES;
+        block_t *p_batch = decoder_NewAudioBuffer( p_dec, i_capacity );
+        if ( !p_batch )
+        {
+            msg_Err(p_dec, "Oops: No new buffer was returned!");
+            return p_done;
+        }
+        p_batch->i_nb_samples = 0;
+        p_batch->i_pts = date_Get( &p_sys->end_date );
+        p_batch->i_length = 0;
+        p_sys->p_batch = p_batch;
+        p_sys->i_batch_capacity = i_capacity;
     }
 
+    block_t *p_batch = p_sys->p_batch;
+    float *p_out = (float *)p_batch->p_buffer
+                 + p_batch->i_nb_samples * i_channels;
+
     spp=opus_multistream_decode_float(p_sys->p_st, p_oggpacket->packet,
-         p_oggpacket->bytes, (float *)p_aout_buffer->p_buffer, spp, 0);
+         p_oggpacket->bytes, p_out, spp, 0);
     if( spp < 0 || i_nb_samples <= 0 || i_end_trim >= i_nb_samples)
     {
-        block_Release(p_aout_buffer);
+        /* Nothing was appended; earlier batched samples are still good */
         if( spp < 0 )
             msg_Err( p_dec, "Error: corrupted stream?" );
-        return NULL;
+        return p_done ? p_done : BatchEmit( p_dec );
     }
 
-    p_aout_buffer->i_buffer = (i_nb_samples - i_end_trim) *
-                              p_sys->header.channels * sizeof(float);
+    const int i_keep = i_nb_samples - i_end_trim;
 
     if( spp > i_nb_samples )
     {
-        memmove(p_aout_buffer->p_buffer,
-            p_aout_buffer->p_buffer
-            + (spp - i_nb_samples)*p_sys->header.channels*sizeof(float),
-            p_aout_buffer->i_buffer);
+        /* Skip the decoder pre-roll */
+        memmove(p_out, p_out + (spp - i_nb_samples)*i_channels,
+                i_keep*i_channels*sizeof(float));
     }
-    i_nb_samples -= i_end_trim;
 
 #ifndef OPUS_SET_GAIN
     if(p_sys->header.gain!=0)
     {
         float gain = pow(10., p_sys->header.gain/5120.);
-        float *buf =(float *)p_aout_buffer->p_buffer;
         int i;
-        for( i = 0; i < i_nb_samples*p_sys->header.channels; i++)
-            buf[i] *= gain;
+        for( i = 0; i < i_keep*i_channels; i++)
+            p_out[i] *= gain;
     }
 #endif
-    p_aout_buffer->i_nb_samples = i_nb_samples;
-    p_aout_buffer->i_pts = date_Get( &p_sys->end_date );
-    p_aout_buffer->i_length = date_Increment( &p_sys->end_date, i_nb_samples )
-        - p_aout_buffer->i_pts;
-    return p_aout_buffer;
+    mtime_t i_prev = date_Get( &p_sys->end_date );
+    p_batch->i_nb_samples += i_keep;
+    p_batch->i_length += date_Increment( &p_sys->end_date, i_keep ) - i_prev;
+
+    if( p_done != NULL )
+        return p_done; /* The refilled batch goes out on the drain call */
+    if( p_batch->i_nb_samples >= OPUS_BATCH_SAMPLES )
+        return BatchEmit( p_dec );
+    return NULL;
 }
 
 /*****************************************************************************
@@ -491,6 +587,8 @@ static void CloseDecoder( vlc_object_t *p_this )
     decoder_sys_t *p_sys = p_dec->p_sys;
 
     if( p_sys->p_st ) opus_multistream_decoder_destroy(p_sys->p_st);
+    if( p_sys->p_batch ) block_Release( p_sys->p_batch );
+    if( p_sys->p_pending ) block_Release( p_sys->p_pending );
 
     free( p_sys );
 }
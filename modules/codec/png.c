@@ -58,6 +58,10 @@ typedef struct png_sys_t png_sys_t;
 struct decoder_sys_t
 {
     PNG_SYS_COMMON_MEMBERS
+
+    /* row pointer scratch array, kept across pictures */
+    png_bytep *p_row_pointers;
+    size_t i_row_pointers;
 };
 
 /*****************************************************************************
@@ -121,6 +125,8 @@ static int OpenDecoder( vlc_object_t *p_this )
         return VLC_ENOMEM;
 
     p_dec->p_sys->p_obj = p_this;
+    p_dec->p_sys->p_row_pointers = NULL;
+    p_dec->p_sys->i_row_pointers = 0;
 
     /* Set output properties */
     p_dec->fmt_out.i_cat = VIDEO_ES;
@@ -198,7 +204,6 @@ static picture_t *DecodeBlock( decoder_t *p_dec, block_t **pp_block )
 
     png_structp p_png;
     png_infop p_info, p_end_info;
-    png_bytep *volatile p_row_pointers = NULL;
 
     if( !pp_block || !*pp_block ) return NULL;
 
@@ -283,19 +288,24 @@ static picture_t *DecodeBlock( decoder_t *p_dec, block_t **pp_block )
     if( !p_pic ) goto error;
 
     /* Decode picture */
-    p_row_pointers = malloc( sizeof(png_bytep) * i_height );
-    if( !p_row_pointers )
-        goto error;
+    if( p_sys->i_row_pointers < i_height )
+    {
+        png_bytep *p_rows = realloc( p_sys->p_row_pointers,
+                                     sizeof(png_bytep) * i_height );
+        if( !p_rows )
+            goto error;
+        p_sys->p_row_pointers = p_rows;
+        p_sys->i_row_pointers = i_height;
+    }
     for( i = 0; i < (int)i_height; i++ )
-        p_row_pointers[i] = p_pic->p->p_pixels + p_pic->p->i_pitch * i;
+        p_sys->p_row_pointers[i] = p_pic->p->p_pixels + p_pic->p->i_pitch * i;
 
-    png_read_image( p_png, p_row_pointers );
+    png_read_image( p_png, p_sys->p_row_pointers );
     if( p_sys->b_error ) goto error;
     png_read_end( p_png, p_end_info );
     if( p_sys->b_error ) goto error;
 
     png_destroy_read_struct( &p_png, &p_info, &p_end_info );
-    free( p_row_pointers );
 
     p_pic->date = p_block->i_pts > VLC_TS_INVALID ? p_block->i_pts : p_block->i_dts;
 
@@ -304,7 +314,6 @@ static picture_t *DecodeBlock( decoder_t *p_dec, block_t **pp_block )
 
  error:
 
-    free( p_row_pointers );
     png_destroy_read_struct( &p_png, &p_info, &p_end_info );
     block_Release( p_block ); *pp_block = NULL;
     return NULL;
@@ -318,6 +327,7 @@ static void CloseDecoder( vlc_object_t *p_this )
     decoder_t *p_dec = (decoder_t *)p_this;
     decoder_sys_t *p_sys = p_dec->p_sys;
 
+    free( p_sys->p_row_pointers );
     free( p_sys );
 }
 
@@ -35,6 +35,10 @@ AbstractStream::AbstractStream(demux_t * demux_, const StreamFormat &format_)
     p_realdemux = demux_;
     format = format_;
     currentChunk = NULL;
+    prefetchedChunk = NULL;
+    prefetching = false;
+    prefetchDiscontinuity = false;
+    prefetchFormatChange = false;
     eof = false;
     dead = false;
     disabled = false;
@@ -67,6 +71,7 @@ AbstractStream::AbstractStream(demux_t * demux_, const StreamFormat &format_)
 AbstractStream::~AbstractStream()
 {
     delete currentChunk;
+    delete prefetchedChunk;
     delete segmentTracker;
 
     delete demuxer;
@@ -290,10 +295,47 @@ AbstractStream::status AbstractStream::demux(mtime_t nz_deadline, bool send)
     return AbstractStream::status_demuxed;
 }
 
+void AbstractStream::prefetchNextChunk()
+{
+    if(prefetchedChunk || eof || discontinuity)
+        return;
+
+    /* Tracker events fired while creating the chunk describe the *next*
+     * segment: capture them and replay once the chunk is promoted. */
+    prefetching = true;
+    prefetchedChunk = segmentTracker->getNextChunk(!fakeesout->restarting(), connManager);
+    prefetching = false;
+}
+
 block_t * AbstractStream::readNextBlock()
 {
     if (currentChunk == NULL && !eof)
-        currentChunk = segmentTracker->getNextChunk(!fakeesout->restarting(), connManager);
+    {
+        if(prefetchedChunk)
+        {
+            currentChunk = prefetchedChunk;
+            prefetchedChunk = NULL;
+
+            if(prefetchFormatChange)
+            {
+                prefetchFormatChange = false;
+                if(format != prefetchFormat)
+                {
+                    msg_Info(p_realdemux, "Changing stream format %s -> %s",
+                             format.str().c_str(), prefetchFormat.str().c_str());
+                    format = prefetchFormat;
+                    discontinuity = true;
+                }
+            }
+            if(prefetchDiscontinuity)
+            {
+                prefetchDiscontinuity = false;
+                discontinuity = true;
+            }
+        }
+        else
+            currentChunk = segmentTracker->getNextChunk(!fakeesout->restarting(), connManager);
+    }
 
     if(discontinuity)
     {
@@ -308,6 +350,9 @@ block_t * AbstractStream::readNextBlock()
         return NULL;
     }
 
+    /* Pipeline the following segment download while this one drains */
+    prefetchNextChunk();
+
     const bool b_segment_head_chunk = (currentChunk->getBytesRead() == 0);
 
     block_t *block = currentChunk->readBlock();
@@ -343,6 +388,11 @@ bool AbstractStream::setPosition(mtime_t time, bool tryonly)
                 delete currentChunk;
             currentChunk = NULL;
 
+            delete prefetchedChunk;
+            prefetchedChunk = NULL;
+            prefetchDiscontinuity = false;
+            prefetchFormatChange = false;
+
             if( !restartDemux() )
                 dead = true;
 
@@ -382,10 +432,19 @@ void AbstractStream::trackerEvent(const SegmentTrackerEvent &event)
     switch(event.type)
     {
         case SegmentTrackerEvent::DISCONTINUITY:
-            discontinuity = true;
+            if(prefetching)
+                prefetchDiscontinuity = true;
+            else
+                discontinuity = true;
             break;
 
         case SegmentTrackerEvent::FORMATCHANGE:
+            if(prefetching)
+            {
+                prefetchFormatChange = true;
+                prefetchFormat = *event.u.format.f;
+                break;
+            }
             /* Check if our current demux is still valid */
             if(*event.u.format.f != format)
             {
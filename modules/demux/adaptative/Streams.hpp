@@ -106,6 +106,13 @@ namespace adaptative
         SegmentTracker *segmentTracker;
 
         SegmentChunk *currentChunk;
+        /* One segment ahead pipelining, so boundaries are served from memory */
+        void prefetchNextChunk();
+        SegmentChunk *prefetchedChunk;
+        bool prefetching;
+        bool prefetchDiscontinuity;
+        bool prefetchFormatChange;
+        StreamFormat prefetchFormat;
         bool disabled;
         bool eof;
         bool dead;
@@ -33,6 +33,7 @@
 #include <vlc_demux.h>
 
 #include "playlist/BasePeriod.h"
+#include "logic/BandwidthEstimation.hpp"
 #include "xml/DOMParser.h"
 
 #include "../dash/DASHManager.h"
@@ -72,6 +73,10 @@ static void Close   (vlc_object_t *);
 
 #define ADAPT_LOGIC_TEXT N_("Adaptation Logic")
 
+#define ADAPT_BWEST_TEXT N_("Bandwidth estimator")
+#define ADAPT_BWEST_LONGTEXT N_("Estimator used to derive the available " \
+    "bandwidth from download timings")
+
 static const int pi_logics[] = {AbstractAdaptationLogic::RateBased,
                                 AbstractAdaptationLogic::FixedRate,
                                 AbstractAdaptationLogic::AlwaysLowest,
@@ -82,6 +87,14 @@ static const char *const ppsz_logics[] = { N_("Bandwidth Adaptive"),
                                            N_("Lowest Bandwidth/Quality"),
                                            N_("Highest Bandwith/Quality")};
 
+static const int pi_estimators[] = {BandwidthEstimation::MovingAverage,
+                                    BandwidthEstimation::EWMA,
+                                    BandwidthEstimation::HarmonicMean};
+
+static const char *const ppsz_estimators[] = { N_("Moving Average"),
+                                               N_("Streaming EWMA"),
+                                               N_("Streaming Harmonic Mean")};
+
 vlc_module_begin ()
         set_shortname( N_("Adaptative"))
         set_description( N_("Unified adaptative streaming for DASH/HLS") )
@@ -91,6 +104,9 @@ vlc_module_begin ()
         add_integer( "adaptative-logic",  AbstractAdaptationLogic::Default,
                                           ADAPT_LOGIC_TEXT, NULL, false )
             change_integer_list( pi_logics, ppsz_logics )
+        add_integer( "adaptative-bw-estimator", BandwidthEstimation::MovingAverage,
+                                          ADAPT_BWEST_TEXT, ADAPT_BWEST_LONGTEXT, true )
+            change_integer_list( pi_estimators, ppsz_estimators )
         add_integer( "adaptative-width",  480, ADAPT_WIDTH_TEXT,  ADAPT_WIDTH_TEXT,  true )
         add_integer( "adaptative-height", 360, ADAPT_HEIGHT_TEXT, ADAPT_HEIGHT_TEXT, true )
         add_integer( "adaptative-bw",     250, ADAPT_BW_TEXT,     ADAPT_BW_LONGTEXT,     false )
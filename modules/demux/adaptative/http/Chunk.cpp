@@ -116,10 +116,33 @@ HTTPChunkSource::HTTPChunkSource(const std::string& url, HTTPConnectionManager *
 {
     prepared = false;
     eof = false;
+    notModified = false;
     if(!init(url))
         throw VLC_EGENERIC;
 }
 
+void HTTPChunkSource::setConditionalGet(const std::string &etag,
+                                        const std::string &lastModified)
+{
+    condETag = etag;
+    condLastModified = lastModified;
+}
+
+bool HTTPChunkSource::isNotModified() const
+{
+    return notModified;
+}
+
+const std::string & HTTPChunkSource::getETag() const
+{
+    return respETag;
+}
+
+const std::string & HTTPChunkSource::getLastModified() const
+{
+    return respLastModified;
+}
+
 HTTPChunkSource::~HTTPChunkSource()
 {
     if(connection)
@@ -173,12 +196,18 @@ bool HTTPChunkSource::hasMoreData() const
 
 block_t * HTTPChunkSource::read(size_t readsize)
 {
+    if(eof)
+        return NULL;
+
     if(!prepare())
     {
         eof = true;
         return NULL;
     }
 
+    if(eof) /* bodyless reply (304) */
+        return NULL;
+
     if(consumed == contentLength && consumed > 0)
     {
         eof = true;
@@ -195,9 +224,8 @@ block_t * HTTPChunkSource::read(size_t readsize)
         return NULL;
     }
 
-    mtime_t time = mdate();
+    /* rate is reported by the connection itself, per socket read */
     ssize_t ret = connection->read(p_block->p_buffer, readsize);
-    time = mdate() - time;
     if(ret < 0)
     {
         block_Release(p_block);
@@ -210,7 +238,6 @@ block_t * HTTPChunkSource::read(size_t readsize)
         consumed += p_block->i_buffer;
         if((size_t)ret < readsize)
             eof = true;
-        connManager->updateDownloadRate(p_block->i_buffer, time);
     }
 
     return p_block;
@@ -231,11 +258,19 @@ bool HTTPChunkSource::prepare()
             return false;
     }
 
+    if(!condETag.empty() || !condLastModified.empty())
+        connection->setConditionalGet(condETag, condLastModified);
+
     if( connection->query(path, bytesRange) != VLC_SUCCESS )
         return false;
     /* Because we don't know Chunk size at start, we need to get size
            from content length */
     contentLength = connection->getContentLength();
+    respETag = connection->getETag();
+    respLastModified = connection->getLastModified();
+    notModified = connection->isNotModified();
+    if(notModified) /* 304 reply carries no body */
+        eof = true;
     prepared = true;
 
     return true;
@@ -256,7 +291,6 @@ HTTPChunkBufferedSource::HTTPChunkBufferedSource(const std::string& url, HTTPCon
     vlc_cond_init(&avail);
     done = false;
     eof = false;
-    downloadstart = 0;
 }
 
 HTTPChunkBufferedSource::~HTTPChunkBufferedSource()
@@ -310,21 +344,13 @@ void HTTPChunkBufferedSource::bufferize(size_t readsize)
     if(!p_block)
         return;
 
-    struct
-    {
-        size_t size;
-        mtime_t time;
-    } rate = {0,0};
-
+    /* rate is reported by the connection itself, per socket read */
     ssize_t ret = connection->read(p_block->p_buffer, readsize);
     if(ret <= 0)
     {
         block_Release(p_block);
         vlc_mutex_lock(&lock);
         done = true;
-        rate.size = buffered + consumed;
-        rate.time = mdate() - downloadstart;
-        downloadstart = 0;
         vlc_mutex_unlock(&lock);
     }
     else
@@ -334,33 +360,13 @@ void HTTPChunkBufferedSource::bufferize(size_t readsize)
         buffered += p_block->i_buffer;
         block_ChainLastAppend(&pp_tail, p_block);
         if((size_t) ret < readsize)
-        {
             done = true;
-            rate.size = buffered + consumed;
-            rate.time = mdate() - downloadstart;
-            downloadstart = 0;
-        }
         vlc_mutex_unlock(&lock);
     }
 
-    if(rate.size)
-    {
-        connManager->updateDownloadRate(rate.size, rate.time);
-    }
-
     vlc_cond_signal(&avail);
 }
 
-bool HTTPChunkBufferedSource::prepare()
-{
-    if(!prepared)
-    {
-        downloadstart = mdate();
-        return HTTPChunkSource::prepare();
-    }
-    return true;
-}
-
 bool HTTPChunkBufferedSource::hasMoreData() const
 {
     bool b_hasdata;
@@ -464,3 +470,24 @@ HTTPChunk::~HTTPChunk()
 {
 
 }
+
+void HTTPChunk::setConditionalGet(const std::string &etag,
+                                  const std::string &lastModified)
+{
+    static_cast<HTTPChunkSource *>(source)->setConditionalGet(etag, lastModified);
+}
+
+bool HTTPChunk::isNotModified() const
+{
+    return static_cast<HTTPChunkSource *>(source)->isNotModified();
+}
+
+const std::string & HTTPChunk::getETag() const
+{
+    return static_cast<HTTPChunkSource *>(source)->getETag();
+}
+
+const std::string & HTTPChunk::getLastModified() const
+{
+    return static_cast<HTTPChunkSource *>(source)->getLastModified();
+}
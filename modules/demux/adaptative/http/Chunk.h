@@ -87,6 +87,14 @@ namespace adaptative
                 virtual block_t *   read            (size_t); /* impl */
                 virtual bool        hasMoreData     () const; /* impl */
 
+                /* Conditional GET: validators of a previous fetch of the
+                 * same resource, and those returned with the reply */
+                void                setConditionalGet(const std::string &etag,
+                                                      const std::string &lastModified);
+                bool                isNotModified   () const;
+                const std::string & getETag         () const;
+                const std::string & getLastModified () const;
+
                 static const size_t CHUNK_SIZE = 32768;
 
             protected:
@@ -104,6 +112,11 @@ namespace adaptative
                 std::string         path;
                 std::string         hostname;
                 uint16_t            port;
+                std::string         condETag;
+                std::string         condLastModified;
+                std::string         respETag;
+                std::string         respLastModified;
+                bool                notModified;
         };
 
         class HTTPChunkBufferedSource : public HTTPChunkSource
@@ -118,7 +131,6 @@ namespace adaptative
                 virtual bool       hasMoreData     () const; /* impl */
 
             protected:
-                virtual bool       prepare(); /* reimpl */
                 void               bufferize(size_t);
                 bool               isDone() const;
 
@@ -128,7 +140,6 @@ namespace adaptative
                 size_t              buffered; /* read cache size */
                 bool                done;
                 bool                eof;
-                mtime_t             downloadstart;
                 vlc_mutex_t         lock;
                 vlc_cond_t          avail;
         };
@@ -139,6 +150,12 @@ namespace adaptative
                 HTTPChunk(const std::string &url, HTTPConnectionManager *);
                 virtual ~HTTPChunk();
 
+                void                setConditionalGet(const std::string &etag,
+                                                      const std::string &lastModified);
+                bool                isNotModified   () const;
+                const std::string & getETag         () const;
+                const std::string & getLastModified () const;
+
                 virtual void        onDownload      (block_t **) {} /* impl */
         };
 
@@ -105,7 +105,17 @@ void Downloader::Run()
             HTTPChunkBufferedSource *source = chunks.front();
             DownloadSource(source);
             if(source->isDone())
+            {
                 chunks.pop_front();
+            }
+            else if(chunks.size() > 1)
+            {
+                /* Round robin between scheduled sources, so the streams
+                 * of one presentation share the link fairly instead of
+                 * the front source starving the others until done */
+                chunks.pop_front();
+                chunks.push_back(source);
+            }
         }
 
         vlc_mutex_unlock(&lock);
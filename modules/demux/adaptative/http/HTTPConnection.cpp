@@ -38,6 +38,8 @@ HTTPConnection::HTTPConnection(vlc_object_t *stream_, Socket *socket_, bool pers
     connectionClose = !persistent;
     port = 80;
     available = true;
+    rateObserver = NULL;
+    notModified = false;
 }
 
 HTTPConnection::~HTTPConnection()
@@ -92,7 +94,26 @@ int HTTPConnection::query(const std::string &path, const BytesRange &range)
     if(range.isValid() && range.getEndByte() > 0)
         contentLength = range.getEndByte() - range.getStartByte() + 1;
 
+    notModified = false;
+    respETag.clear();
+    respLastModified.clear();
+
     std::string header = buildRequestHeader(path);
+    /* One-shot validators from the previous fetch of the same entity */
+    if(!ifNoneMatch.empty())
+    {
+        header.append("If-None-Match: ");
+        header.append(ifNoneMatch);
+        header.append("\r\n");
+        ifNoneMatch.clear();
+    }
+    if(!ifModifiedSince.empty())
+    {
+        header.append("If-Modified-Since: ");
+        header.append(ifModifiedSince);
+        header.append("\r\n");
+        ifModifiedSince.clear();
+    }
     if(connectionClose)
         header.append("Connection: close\r\n");
     header.append("\r\n");
@@ -145,10 +166,17 @@ ssize_t HTTPConnection::read(void *p_buffer, size_t len)
     if(len > toRead)
         len = toRead;
 
+    mtime_t time = mdate();
     ssize_t ret = socket->read(stream, p_buffer, len);
+    time = mdate() - time;
     if(ret >= 0)
         bytesRead += ret;
 
+    /* Report each socket read so rate estimation can converge while a
+     * segment is still downloading, not a whole segment late */
+    if(ret > 0 && rateObserver)
+        rateObserver->updateDownloadRate(ret, time);
+
     if(ret < 0 || (size_t)ret < len) /* set EOF */
     {
         socket->disconnect();
@@ -181,7 +209,9 @@ int HTTPConnection::parseReply()
     std::istringstream ss(line.substr(9));
     int replycode;
     ss >> replycode;
-    if (replycode != 200 && replycode != 206)
+    if (replycode == 304) /* our conditional GET validators still hold */
+        notModified = true;
+    else if (replycode != 200 && replycode != 206)
         return VLC_ENOOBJ;
 
     line = readLine();
@@ -233,6 +263,26 @@ size_t HTTPConnection::getContentLength() const
     return contentLength;
 }
 
+bool HTTPConnection::canBeReused() const
+{
+    return available && !connectionClose && socket->connected();
+}
+
+void HTTPConnection::rebind(vlc_object_t *stream_)
+{
+    /* Adopted from another stream instance: messages and inherited
+     * variables must resolve against the new owner */
+    stream = stream_;
+    free(psz_useragent);
+    psz_useragent = var_InheritString(stream, "http-user-agent");
+    rateObserver = NULL;
+}
+
+void HTTPConnection::setDownloadRateObserver(IDownloadRateObserver *obs)
+{
+    rateObserver = obs;
+}
+
 void HTTPConnection::onHeader(const std::string &key,
                               const std::string &value)
 {
@@ -243,12 +293,42 @@ void HTTPConnection::onHeader(const std::string &key,
         ss >> length;
         contentLength = length;
     }
+    else if (key == "ETag")
+    {
+        respETag = value;
+    }
+    else if (key == "Last-Modified")
+    {
+        respLastModified = value;
+    }
     else if (key == "Connection" && value =="close")
     {
         connectionClose = true;
     }
 }
 
+void HTTPConnection::setConditionalGet(const std::string &etag,
+                                       const std::string &lastModified)
+{
+    ifNoneMatch = etag;
+    ifModifiedSince = lastModified;
+}
+
+const std::string & HTTPConnection::getETag() const
+{
+    return respETag;
+}
+
+const std::string & HTTPConnection::getLastModified() const
+{
+    return respLastModified;
+}
+
+bool HTTPConnection::isNotModified() const
+{
+    return notModified;
+}
+
 std::string HTTPConnection::buildRequestHeader(const std::string &path) const
 {
     std::stringstream req;
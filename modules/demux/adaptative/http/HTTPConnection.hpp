@@ -30,6 +30,7 @@
 #endif
 
 #include "BytesRange.hpp"
+#include "../logic/IDownloadRateObserver.h"
 #include <vlc_common.h>
 #include <string>
 
@@ -55,8 +56,18 @@ namespace adaptative
                 virtual bool    send        (const std::string &data);
 
                 size_t getContentLength() const;
+                /* Conditional GET: validators sent with the next query and
+                 * captured from its reply (one-shot) */
+                void setConditionalGet(const std::string &etag,
+                                       const std::string &lastModified);
+                const std::string & getETag() const;
+                const std::string & getLastModified() const;
+                bool isNotModified() const;
                 bool isAvailable () const;
                 void setUsed( bool );
+                bool canBeReused() const;
+                void rebind(vlc_object_t *);
+                void setDownloadRateObserver(IDownloadRateObserver *);
 
             protected:
 
@@ -76,6 +87,12 @@ namespace adaptative
                 BytesRange bytesRange;
                 bool available;
 
+                std::string         ifNoneMatch;
+                std::string         ifModifiedSince;
+                std::string         respETag;
+                std::string         respLastModified;
+                bool                notModified;
+
                 bool                connectionClose;
                 bool                queryOk;
                 int                 retries;
@@ -83,6 +100,7 @@ namespace adaptative
 
             private:
                 Socket *socket;
+                IDownloadRateObserver *rateObserver;
        };
     }
 }
@@ -33,6 +33,9 @@
 
 using namespace adaptative::http;
 
+vlc_mutex_t HTTPConnectionManager::warm_lock = VLC_STATIC_MUTEX;
+std::vector<HTTPConnection *> HTTPConnectionManager::warmPool;
+
 HTTPConnectionManager::HTTPConnectionManager    (vlc_object_t *stream) :
                        stream                   (stream),
                        rateObserver             (NULL)
@@ -44,7 +47,7 @@ HTTPConnectionManager::HTTPConnectionManager    (vlc_object_t *stream) :
 HTTPConnectionManager::~HTTPConnectionManager   ()
 {
     delete downloader;
-    this->closeAllConnections();
+    this->parkAllConnections();
     vlc_mutex_destroy(&lock);
 }
 
@@ -63,6 +66,51 @@ void HTTPConnectionManager::releaseAllConnections()
         (*it)->setUsed(false);
 }
 
+void HTTPConnectionManager::parkAllConnections()
+{
+    vlc_mutex_lock(&lock);
+    releaseAllConnections();
+    vlc_mutex_lock(&warm_lock);
+    std::vector<HTTPConnection *>::iterator it;
+    for(it = connectionPool.begin(); it != connectionPool.end(); ++it)
+    {
+        HTTPConnection *conn = *it;
+        if(conn->canBeReused() && warmPool.size() < MAX_WARM)
+            warmPool.push_back(conn);
+        else
+            delete conn;
+    }
+    connectionPool.clear();
+    vlc_mutex_unlock(&warm_lock);
+    vlc_mutex_unlock(&lock);
+}
+
+HTTPConnection * HTTPConnectionManager::adoptWarmConnection(const std::string &hostname,
+                                                            uint16_t port, int sockettype)
+{
+    HTTPConnection *conn = NULL;
+    vlc_mutex_lock(&warm_lock);
+    std::vector<HTTPConnection *>::iterator it;
+    for(it = warmPool.begin(); it != warmPool.end(); ++it)
+    {
+        if((*it)->compare(hostname, port, sockettype))
+        {
+            conn = *it;
+            warmPool.erase(it);
+            break;
+        }
+    }
+    vlc_mutex_unlock(&warm_lock);
+
+    if(conn)
+    {
+        conn->rebind(stream);
+        conn->setDownloadRateObserver(this);
+        connectionPool.push_back(conn);
+    }
+    return conn;
+}
+
 HTTPConnection * HTTPConnectionManager::getConnection(const std::string &hostname, uint16_t port, int sockettype)
 {
     std::vector<HTTPConnection *>::const_iterator it;
@@ -85,6 +133,8 @@ HTTPConnection * HTTPConnectionManager::getConnection(const std::string &scheme,
     const int sockettype = (scheme == "https") ? TLSSocket::TLS : Socket::REGULAR;
     vlc_mutex_lock(&lock);
     HTTPConnection *conn = getConnection(hostname, port, sockettype);
+    if(!conn)
+        conn = adoptWarmConnection(hostname, port, sockettype);
     if(!conn)
     {
         Socket *socket = (sockettype == TLSSocket::TLS) ? new (std::nothrow) TLSSocket()
@@ -94,8 +144,10 @@ HTTPConnection * HTTPConnectionManager::getConnection(const std::string &scheme,
             vlc_mutex_unlock(&lock);
             return NULL;
         }
-        /* disable pipelined tls until we have ticket/resume session support */
-        conn = new (std::nothrow) HTTPConnection(stream, socket, sockettype != TLSSocket::TLS);
+        /* Keep TLS connections persistent too: reusing them skips the
+         * handshake entirely, and query() falls back to a fresh connection
+         * if the server dropped an idle one meanwhile. */
+        conn = new (std::nothrow) HTTPConnection(stream, socket, true);
         if(!conn)
         {
             delete socket;
@@ -103,6 +155,7 @@ HTTPConnection * HTTPConnectionManager::getConnection(const std::string &scheme,
             return NULL;
         }
 
+        conn->setDownloadRateObserver(this);
         connectionPool.push_back(conn);
 
         if (!conn->connect(hostname, port))
@@ -59,11 +59,20 @@ namespace adaptative
 
             private:
                 void    releaseAllConnections ();
+                void    parkAllConnections ();
                 vlc_mutex_t                                         lock;
                 std::vector<HTTPConnection *>                       connectionPool;
                 vlc_object_t                                       *stream;
                 IDownloadRateObserver                              *rateObserver;
                 HTTPConnection * getConnection(const std::string &hostname, uint16_t port, int);
+                HTTPConnection * adoptWarmConnection(const std::string &hostname, uint16_t port, int);
+
+                /* Process wide pool of warm idle connections, so several
+                 * streams or successive playlist updates reuse sockets
+                 * instead of redialing the same host */
+                static const unsigned                               MAX_WARM = 4;
+                static vlc_mutex_t                                  warm_lock;
+                static std::vector<HTTPConnection *>                warmPool;
         };
     }
 }
@@ -0,0 +1,88 @@
+/*
+ * BandwidthEstimation.cpp
+ *****************************************************************************
+ * Copyright © 2015 - VideoLAN and VLC Authors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "BandwidthEstimation.hpp"
+
+using namespace adaptative::logic;
+
+BandwidthEstimation::BandwidthEstimation(Mode mode_)
+{
+    mode = mode_;
+    bpsAvg = 0;
+    for(unsigned i=0; i<TOTALOBS; i++)
+        observations[i] = 0;
+    obs_count = 0;
+    obs_idx = 0;
+    dlsize = 0;
+    dllength = 0;
+}
+
+void BandwidthEstimation::push(size_t size, mtime_t time)
+{
+    if(unlikely(time == 0))
+        return;
+
+    /* Individual socket reads are too short to be meaningful on their
+     * own, coalesce them into observations of at least 1/8th second */
+    dllength += time;
+    dlsize += size;
+
+    if(dllength < CLOCK_FREQ / 8)
+        return;
+
+    const size_t bps = CLOCK_FREQ * dlsize * 8 / dllength;
+    dlsize = 0;
+    dllength = 0;
+
+    if(mode == EWMA)
+    {
+        /* Smoothing weight balanced for ~8 observations per second */
+        bpsAvg = (bpsAvg) ? (3 * bpsAvg + bps) / 4 : bps;
+    }
+    else
+    {
+        observations[obs_idx] = bps;
+        obs_idx = (obs_idx + 1) % TOTALOBS;
+        if(obs_count < TOTALOBS)
+            obs_count++;
+
+        /* The harmonic mean is dominated by the slowest observations,
+         * which keeps the estimate conservative on bursty links */
+        double invsum = 0;
+        unsigned n = 0;
+        for(unsigned i=0; i<obs_count; i++)
+        {
+            if(observations[i])
+            {
+                invsum += 1.0 / observations[i];
+                n++;
+            }
+        }
+        bpsAvg = (invsum > 0) ? n / invsum : 0;
+    }
+}
+
+size_t BandwidthEstimation::getEstimate() const
+{
+    return bpsAvg;
+}
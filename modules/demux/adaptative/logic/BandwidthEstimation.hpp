@@ -0,0 +1,66 @@
+/*
+ * BandwidthEstimation.hpp
+ *****************************************************************************
+ * Copyright © 2015 - VideoLAN and VLC Authors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef BANDWIDTHESTIMATION_HPP
+#define BANDWIDTHESTIMATION_HPP
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <vlc_common.h>
+
+namespace adaptative
+{
+    namespace logic
+    {
+        /* Streaming bandwidth estimator fed with individual socket read
+         * timings. Unlike the per segment average, its estimate converges
+         * while a segment is still downloading, so the rate based logic
+         * can react before committing to the next segment. */
+        class BandwidthEstimation
+        {
+            public:
+                enum Mode
+                {
+                    MovingAverage = 0, /* legacy VHF/MA estimator */
+                    EWMA,
+                    HarmonicMean,
+                };
+
+                BandwidthEstimation(Mode);
+
+                void    push(size_t, mtime_t);
+                size_t  getEstimate() const;
+
+            private:
+                static const unsigned TOTALOBS = 10;
+                Mode                mode;
+                size_t              bpsAvg;
+                size_t              observations[TOTALOBS];
+                unsigned            obs_count;
+                unsigned            obs_idx;
+                size_t              dlsize;
+                mtime_t             dllength;
+        };
+    }
+}
+
+#endif /* BANDWIDTHESTIMATION_HPP */
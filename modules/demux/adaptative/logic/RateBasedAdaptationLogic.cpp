@@ -49,11 +49,18 @@ RateBasedAdaptationLogic::RateBasedAdaptationLogic  (vlc_object_t *p_obj_, int w
     window_idx = 0;
     prevbps = 0;
     dlsize = 0;
+    int i_mode = var_InheritInteger(p_obj_, "adaptative-bw-estimator");
+    if(i_mode != BandwidthEstimation::MovingAverage)
+        streamEstimator = new (std::nothrow)
+            BandwidthEstimation(static_cast<BandwidthEstimation::Mode>(i_mode));
+    else
+        streamEstimator = NULL;
     vlc_mutex_init(&lock);
 }
 
 RateBasedAdaptationLogic::~RateBasedAdaptationLogic()
 {
+    delete streamEstimator;
     vlc_mutex_destroy(&lock);
 }
 
@@ -86,6 +93,23 @@ void RateBasedAdaptationLogic::updateDownloadRate(size_t size, mtime_t time)
 {
     if(unlikely(time == 0))
         return;
+
+    if(streamEstimator)
+    {
+        vlc_mutex_lock(&lock);
+        streamEstimator->push(size, time);
+        const size_t estimate = streamEstimator->getEstimate();
+        if(estimate)
+        {
+            bpsAvg = estimate;
+            currentBps = bpsAvg * 3/4;
+            BwDebug(msg_Dbg(p_obj, "stream bw estimation avg %zu KiB/s",
+                            bpsAvg / 8192));
+        }
+        vlc_mutex_unlock(&lock);
+        return;
+    }
+
     /* Accumulate up to observation window */
     dllength += time;
     dlsize += size;
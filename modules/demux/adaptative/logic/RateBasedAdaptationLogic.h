@@ -26,6 +26,7 @@
 #define RATEBASEDADAPTATIONLOGIC_H_
 
 #include "AbstractAdaptationLogic.h"
+#include "BandwidthEstimation.hpp"
 
 namespace adaptative
 {
@@ -62,6 +63,8 @@ namespace adaptative
                 size_t                  dlsize;
                 mtime_t                 dllength;
 
+                BandwidthEstimation    *streamEstimator;
+
                 vlc_mutex_t             lock;
         };
 
@@ -27,6 +27,12 @@ using namespace adaptative;
 using namespace adaptative::http;
 
 block_t * Retrieve::HTTP(vlc_object_t *obj, const std::string &uri)
+{
+    return HTTP(obj, uri, NULL);
+}
+
+block_t * Retrieve::HTTP(vlc_object_t *obj, const std::string &uri,
+                         ConditionalGet *cond)
 {
     HTTPConnectionManager connManager(obj);
     HTTPChunk *datachunk;
@@ -37,7 +43,20 @@ block_t * Retrieve::HTTP(vlc_object_t *obj, const std::string &uri)
         return NULL;
     }
 
+    if(cond)
+        datachunk->setConditionalGet(cond->etag, cond->lastModified);
+
     block_t *block = datachunk->read(1<<21);
+
+    if(cond)
+    {
+        cond->notModified = datachunk->isNotModified();
+        if(!datachunk->getETag().empty())
+            cond->etag = datachunk->getETag();
+        if(!datachunk->getLastModified().empty())
+            cond->lastModified = datachunk->getLastModified();
+    }
+
     delete datachunk;
     return block;
 }
@@ -32,7 +32,19 @@ namespace adaptative
     class Retrieve
     {
         public:
+            /* In/out validators for a conditional fetch: filled with those
+             * of the previous retrieval, updated from the reply */
+            struct ConditionalGet
+            {
+                ConditionalGet() : notModified(false) {}
+                std::string etag;
+                std::string lastModified;
+                bool notModified;
+            };
+
             static block_t * HTTP(vlc_object_t *, const std::string &uri);
+            static block_t * HTTP(vlc_object_t *, const std::string &uri,
+                                  ConditionalGet *);
     };
 }
 
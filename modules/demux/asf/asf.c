@@ -72,6 +72,7 @@ vlc_module_end ()
 static int Demux  ( demux_t * );
 static int Control( demux_t *, int i_query, va_list args );
 static void FlushQueues( demux_t *p_demux );
+static void BuiltIndexRecord( demux_t *p_demux, uint64_t i_packet_pos );
 
 #define MAX_ASF_TRACKS (ASF_MAX_STREAMNUMBER + 1)
 #define ASF_PREROLL_FROM_CURRENT -1
@@ -108,6 +109,16 @@ typedef struct
 
 } asf_track_t;
 
+/* Index built on-the-fly for files lacking a simple index object:
+ * packet positions of keyframe-bearing packets, sampled during playback */
+typedef struct
+{
+    mtime_t          i_time; /* send time of the packet */
+    uint64_t         i_pos;  /* absolute stream offset of the packet */
+} asf_built_index_entry_t;
+
+#define ASF_BUILT_INDEX_INTERVAL CLOCK_FREQ /* at most one entry per second */
+
 struct demux_sys_t
 {
     mtime_t             i_time;     /* s */
@@ -126,6 +137,15 @@ struct demux_sys_t
     uint64_t            i_data_begin;
     uint64_t            i_data_end;
 
+    struct
+    {
+        asf_built_index_entry_t *p_entries;
+        size_t           i_count;
+        size_t           i_size;
+        mtime_t          i_last_time;
+        bool             b_keyframe_seen; /* in the packet being demuxed */
+    } builtindex;
+
     bool                b_index;
     bool                b_canfastseek;
     uint8_t             i_seek_track;
@@ -212,10 +232,17 @@ static int Demux( demux_t *p_demux )
 
     while( !p_sys->b_eos && p_sys->i_sendtime - p_sys->i_time < (mtime_t)p_sys->p_fp->i_preroll * 1000 + CHUNK )
     {
+        const uint64_t i_packet_pos = stream_Tell( p_demux->s );
+        p_sys->builtindex.b_keyframe_seen = false;
+
         /* Read and demux a packet */
         if( DemuxASFPacket( &p_sys->packet_sys,
                              p_sys->p_fp->i_min_data_packet_size,
-                             p_sys->p_fp->i_max_data_packet_size ) <= 0 )
+                             p_sys->p_fp->i_max_data_packet_size ) > 0 )
+        {
+            BuiltIndexRecord( p_demux, i_packet_pos );
+        }
+        else
         {
             p_sys->b_eos = true;
             /* Check if we have concatenated files */
@@ -380,6 +407,86 @@ static int SeekIndex( demux_t *p_demux, mtime_t i_date, float f_pos )
     else return VLC_EGENERIC;
 }
 
+/*****************************************************************************
+ * BuiltIndexRecord: samples a packet -> time entry during playback
+ *****************************************************************************/
+static void BuiltIndexRecord( demux_t *p_demux, uint64_t i_packet_pos )
+{
+    demux_sys_t *p_sys = p_demux->p_sys;
+
+    /* Only packets starting a video keyframe are worth seeking back to */
+    if( !p_sys->builtindex.b_keyframe_seen || p_sys->i_sendtime < 0 )
+        return;
+
+    /* Keeps entries time ordered, and skips times already covered after
+     * a backward seek */
+    if( p_sys->builtindex.i_count > 0 &&
+        p_sys->i_sendtime - p_sys->builtindex.i_last_time < ASF_BUILT_INDEX_INTERVAL )
+        return;
+
+    if( p_sys->builtindex.i_count == p_sys->builtindex.i_size )
+    {
+        size_t i_newsize = p_sys->builtindex.i_size ? p_sys->builtindex.i_size * 2
+                                                    : 256;
+        asf_built_index_entry_t *p_realloc =
+            realloc( p_sys->builtindex.p_entries, i_newsize * sizeof(*p_realloc) );
+        if( !p_realloc )
+            return;
+        p_sys->builtindex.p_entries = p_realloc;
+        p_sys->builtindex.i_size = i_newsize;
+    }
+
+    asf_built_index_entry_t *p_entry =
+        &p_sys->builtindex.p_entries[p_sys->builtindex.i_count++];
+    p_entry->i_time = p_sys->i_sendtime;
+    p_entry->i_pos = i_packet_pos;
+    p_sys->builtindex.i_last_time = p_sys->i_sendtime;
+}
+
+/*****************************************************************************
+ * SeekBuiltIndex: seek using the index built during playback
+ *****************************************************************************/
+static int SeekBuiltIndex( demux_t *p_demux, mtime_t i_date, float f_pos )
+{
+    demux_sys_t *p_sys = p_demux->p_sys;
+
+    if( i_date < 0 )
+        i_date = p_sys->i_length * f_pos;
+
+    if( p_sys->builtindex.i_count == 0 ||
+        i_date < p_sys->builtindex.p_entries[0].i_time ||
+        i_date > p_sys->builtindex.i_last_time )
+        return VLC_EGENERIC;
+
+    /* Last entry not past the target date */
+    size_t lo = 0, hi = p_sys->builtindex.i_count;
+    while( hi - lo > 1 )
+    {
+        size_t mid = lo + (hi - lo) / 2;
+        if( p_sys->builtindex.p_entries[mid].i_time <= i_date )
+            lo = mid;
+        else
+            hi = mid;
+    }
+
+    const asf_built_index_entry_t *p_entry = &p_sys->builtindex.p_entries[lo];
+
+    msg_Dbg( p_demux, "seek with built index: %i seconds to packet @%"PRIu64,
+             (int)(i_date/1000000), p_entry->i_pos );
+
+    p_sys->i_preroll_start = i_date - (int64_t) p_sys->p_fp->i_preroll;
+    if ( p_sys->i_preroll_start < 0 ) p_sys->i_preroll_start = 0;
+
+    WaitKeyframe( p_demux );
+
+    if ( stream_Seek( p_demux->s, p_entry->i_pos ) == VLC_SUCCESS )
+    {
+        es_out_Control( p_demux->out, ES_OUT_SET_NEXT_DISPLAY_TIME, VLC_TS_0 + i_date );
+        return VLC_SUCCESS;
+    }
+    else return VLC_EGENERIC;
+}
+
 static void SeekPrepare( demux_t *p_demux )
 {
     demux_sys_t *p_sys = p_demux->p_sys;
@@ -431,14 +538,17 @@ static int Control( demux_t *p_demux, int i_query, va_list args )
 
         SeekPrepare( p_demux );
 
-        if( p_sys->b_index && p_sys->i_length > 0 )
         {
             va_list acpy;
             va_copy( acpy, args );
             i64 = (int64_t)va_arg( acpy, int64_t );
             va_end( acpy );
 
-            if( !SeekIndex( p_demux, i64, -1 ) )
+            if( p_sys->b_index && p_sys->i_length > 0 &&
+                !SeekIndex( p_demux, i64, -1 ) )
+                return VLC_SUCCESS;
+
+            if( !SeekBuiltIndex( p_demux, i64, -1 ) )
                 return VLC_SUCCESS;
         }
         return SeekPercent( p_demux, i_query, args );
@@ -489,14 +599,17 @@ static int Control( demux_t *p_demux, int i_query, va_list args )
 
         SeekPrepare( p_demux );
 
-        if( p_sys->b_index && p_sys->i_length > 0 )
         {
             va_list acpy;
             va_copy( acpy, args );
             f = (double)va_arg( acpy, double );
             va_end( acpy );
 
-            if( !SeekIndex( p_demux, -1, f ) )
+            if( p_sys->b_index && p_sys->i_length > 0 &&
+                !SeekIndex( p_demux, -1, f ) )
+                return VLC_SUCCESS;
+
+            if( !SeekBuiltIndex( p_demux, -1, f ) )
                 return VLC_SUCCESS;
         }
         return SeekPercent( p_demux, i_query, args );
@@ -587,6 +700,9 @@ static bool Packet_DoSkip( asf_packet_sys_t *p_packetsys, uint8_t i_stream_numbe
         return true;
     }
 
+    if( tk->i_cat == VIDEO_ES && b_packet_keyframe )
+        p_sys->builtindex.b_keyframe_seen = true;
+
     if( p_sys->i_wait_keyframe )
     {
         if ( i_stream_number == p_sys->i_seek_track )
@@ -766,6 +882,11 @@ static int DemuxInit( demux_t *p_demux )
     p_sys->i_data_end   = 0;
     p_sys->i_preroll_start = 0;
     p_sys->meta         = NULL;
+    p_sys->builtindex.p_entries = NULL;
+    p_sys->builtindex.i_count = 0;
+    p_sys->builtindex.i_size = 0;
+    p_sys->builtindex.i_last_time = 0;
+    p_sys->builtindex.b_keyframe_seen = false;
 
     /* Now load all object ( except raw data ) */
     stream_Control( p_demux->s, STREAM_CAN_FASTSEEK, &p_sys->b_canfastseek );
@@ -1282,6 +1403,10 @@ static void DemuxEnd( demux_t *p_demux )
         vlc_meta_Delete( p_sys->meta );
         p_sys->meta = NULL;
     }
+    free( p_sys->builtindex.p_entries );
+    p_sys->builtindex.p_entries = NULL;
+    p_sys->builtindex.i_count = 0;
+    p_sys->builtindex.i_size = 0;
 
     FlushQueues( p_demux );
 
@@ -42,6 +42,11 @@
 #include <vlc_codecs.h>
 #include <vlc_charset.h>
 #include <vlc_memory.h>
+#include <vlc_configuration.h>
+#include <vlc_fs.h>
+#include <vlc_hash.h>
+
+#include <sys/stat.h>
 
 #include "libavi.h"
 #include "../rawdv.h"
@@ -228,6 +233,8 @@ static int AVI_PacketSearch   ( demux_t * );
 
 static void AVI_IndexLoad    ( demux_t * );
 static void AVI_IndexCreate  ( demux_t * );
+static int  AVI_IndexCacheLoad( demux_t * );
+static void AVI_IndexCacheSave( demux_t * );
 
 static void AVI_ExtractSubtitle( demux_t *, unsigned int i_stream, avi_chunk_list_t *, avi_chunk_STRING_t * );
 
@@ -263,7 +270,7 @@ static int Open( vlc_object_t * p_this )
     demux_t  *p_demux = (demux_t *)p_this;
     demux_sys_t     *p_sys;
 
-    bool       b_index = false, b_aborted = false;
+    bool       b_index = false, b_index_from_cache = false, b_aborted = false;
     int              i_do_index;
 
     avi_chunk_list_t    *p_riff;
@@ -711,7 +718,16 @@ static int Open( vlc_object_t * p_this )
 aviindex:
         if( p_sys->b_fastseekable )
         {
-            AVI_IndexCreate( p_demux );
+            /* A cached index that turned out incomplete is rebuilt on the
+             * next pass through this label */
+            if( b_index_from_cache || AVI_IndexCacheLoad( p_demux ) )
+            {
+                b_index_from_cache = false;
+                AVI_IndexCreate( p_demux );
+                AVI_IndexCacheSave( p_demux );
+            }
+            else
+                b_index_from_cache = true;
         }
         else if( p_sys->b_seekable )
         {
@@ -745,7 +761,8 @@ aviindex:
     {
         msg_Warn( p_demux, "broken or missing index, 'seek' will be "
                            "approximative or will exhibit strange behavior" );
-        if( (i_do_index == 0 || i_do_index == 3) && !b_index )
+        if( (i_do_index == 0 || i_do_index == 3) &&
+            (!b_index || b_index_from_cache) )
         {
             if( !p_sys->b_fastseekable ) {
                 b_index = true;
@@ -2724,6 +2741,166 @@ print_stat:
     }
 }
 
+/*****************************************************************************
+ * Persistent index cache
+ *****************************************************************************
+ * An index rebuilt by scanning LIST-movi is saved under the user cache
+ * directory, keyed on the file path, size and modification time, so the
+ * scan of an index-less file happens once instead of on every open.
+ */
+static const uint8_t avi_index_cache_magic[8] =
+    { 'V', 'L', 'C', ' ', 'A', 'V', 'I', 0x01 };
+
+static char *AVI_IndexCachePath( demux_t *p_demux )
+{
+    if( !p_demux->psz_file )
+        return NULL;
+
+    struct stat st;
+    if( vlc_stat( p_demux->psz_file, &st ) )
+        return NULL;
+
+    struct vlc_hash64_s hash;
+    uint64_t i_size = st.st_size;
+    uint64_t i_mtime = st.st_mtime;
+    vlc_hash64_Init( &hash, 0 );
+    vlc_hash64_Add( &hash, p_demux->psz_file, strlen( p_demux->psz_file ) );
+    vlc_hash64_Add( &hash, &i_size, sizeof (i_size) );
+    vlc_hash64_Add( &hash, &i_mtime, sizeof (i_mtime) );
+
+    char psz_key[17];
+    vlc_hash64_hex( psz_key, vlc_hash64_Finish( &hash ) );
+
+    char *psz_dir = config_GetUserDir( VLC_CACHE_DIR );
+    if( !psz_dir )
+        return NULL;
+
+    char *psz_path;
+    if( asprintf( &psz_path, "%s" DIR_SEP "avi-index-%s.dat",
+                  psz_dir, psz_key ) == -1 )
+        psz_path = NULL;
+    free( psz_dir );
+    return psz_path;
+}
+
+static int AVI_IndexCacheLoad( demux_t *p_demux )
+{
+    demux_sys_t *p_sys = p_demux->p_sys;
+    uint8_t header[8];
+    uint32_t i_track;
+    unsigned i;
+
+    char *psz_path = AVI_IndexCachePath( p_demux );
+    if( !psz_path )
+        return VLC_EGENERIC;
+
+    FILE *f = vlc_fopen( psz_path, "rb" );
+    free( psz_path );
+    if( !f )
+        return VLC_EGENERIC;
+
+    if( fread( header, 1, 8, f ) != 8 ||
+        memcmp( header, avi_index_cache_magic, 8 ) ||
+        fread( &i_track, sizeof (i_track), 1, f ) != 1 ||
+        i_track != p_sys->i_track )
+        goto error;
+
+    for( i = 0; i < p_sys->i_track; i++ )
+        avi_index_Init( &p_sys->track[i]->idx );
+
+    for( i = 0; i < p_sys->i_track; i++ )
+    {
+        uint32_t i_count;
+
+        if( fread( &i_count, sizeof (i_count), 1, f ) != 1 )
+            goto error;
+
+        for( uint32_t j = 0; j < i_count; j++ )
+        {
+            avi_entry_t index;
+            uint64_t i_pos;
+
+            if( fread( &index.i_id, sizeof (uint32_t), 1, f ) != 1 ||
+                fread( &index.i_flags, sizeof (uint32_t), 1, f ) != 1 ||
+                fread( &i_pos, sizeof (i_pos), 1, f ) != 1 ||
+                fread( &index.i_length, sizeof (uint32_t), 1, f ) != 1 )
+                goto error;
+
+            index.i_pos = i_pos;
+            index.i_lengthtotal = index.i_length;
+            avi_index_Append( &p_sys->track[i]->idx,
+                              &p_sys->i_movi_lastchunk_pos, &index );
+        }
+    }
+
+    fclose( f );
+    msg_Dbg( p_demux, "loaded index from cache" );
+    p_sys->b_indexloaded = true;
+    return VLC_SUCCESS;
+
+error:
+    for( i = 0; i < p_sys->i_track; i++ )
+    {
+        avi_index_Clean( &p_sys->track[i]->idx );
+        avi_index_Init( &p_sys->track[i]->idx );
+    }
+    p_sys->i_movi_lastchunk_pos = 0;
+    fclose( f );
+    return VLC_EGENERIC;
+}
+
+static void AVI_IndexCacheSave( demux_t *p_demux )
+{
+    demux_sys_t *p_sys = p_demux->p_sys;
+
+    char *psz_path = AVI_IndexCachePath( p_demux );
+    if( !psz_path )
+        return;
+
+    char *psz_tmp;
+    if( asprintf( &psz_tmp, "%s.tmp", psz_path ) == -1 )
+    {
+        free( psz_path );
+        return;
+    }
+
+    FILE *f = vlc_fopen( psz_tmp, "wb" );
+    if( f )
+    {
+        uint32_t i_track = p_sys->i_track;
+        bool b_ok;
+
+        b_ok = fwrite( avi_index_cache_magic, 1, 8, f ) == 8 &&
+               fwrite( &i_track, sizeof (i_track), 1, f ) == 1;
+
+        for( unsigned i = 0; b_ok && i < p_sys->i_track; i++ )
+        {
+            const avi_index_t *p_index = &p_sys->track[i]->idx;
+            uint32_t i_count = p_index->i_size;
+
+            b_ok = fwrite( &i_count, sizeof (i_count), 1, f ) == 1;
+            for( uint32_t j = 0; b_ok && j < i_count; j++ )
+            {
+                const avi_entry_t *p_entry = &p_index->p_entry[j];
+                uint64_t i_pos = p_entry->i_pos;
+
+                b_ok = fwrite( &p_entry->i_id, sizeof (uint32_t), 1, f ) == 1
+                    && fwrite( &p_entry->i_flags, sizeof (uint32_t), 1, f ) == 1
+                    && fwrite( &i_pos, sizeof (i_pos), 1, f ) == 1
+                    && fwrite( &p_entry->i_length, sizeof (uint32_t), 1, f ) == 1;
+            }
+        }
+
+        if( fclose( f ) == 0 && b_ok &&
+            vlc_rename( psz_tmp, psz_path ) == 0 )
+            msg_Dbg( p_demux, "saved index to cache" );
+        else
+            vlc_unlink( psz_tmp );
+    }
+    free( psz_tmp );
+    free( psz_path );
+}
+
 /* */
 static void AVI_MetaLoad( demux_t *p_demux,
                           avi_chunk_list_t *p_riff, avi_chunk_avih_t *p_avih )
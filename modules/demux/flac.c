@@ -36,8 +36,12 @@
 #include <vlc_input.h>                /* vlc_input_attachment, vlc_seekpoint */
 #include <vlc_codec.h>                /* decoder_t */
 #include <vlc_charset.h>              /* EnsureUTF8 */
+#include <vlc_configuration.h>        /* config_GetUserDir */
+#include <vlc_fs.h>                   /* vlc_fopen, vlc_stat */
+#include <vlc_hash.h>                 /* vlc_hash64 */
 
 #include <assert.h>
+#include <sys/stat.h>
 #include "xiph_metadata.h"            /* vorbis comments */
 
 /*****************************************************************************
@@ -63,6 +67,11 @@ static int Control( demux_t *, int, va_list );
 
 static int  ReadMeta( demux_t *, uint8_t **pp_streaminfo, int *pi_streaminfo );
 
+static void LearnSeekpoint( demux_t *, mtime_t i_time_offset,
+                            uint64_t i_byte_offset );
+static void LoadSeekpointCache( demux_t * );
+static void SaveSeekpointCache( demux_t * );
+
 typedef struct
 {
     mtime_t  i_time_offset;
@@ -87,6 +96,8 @@ struct demux_sys_t
     /* */
     int         i_seekpoint;
     flac_seekpoint_t **seekpoint;
+    uint64_t    i_last_chunk_pos;    /* maps streamed frames to offsets */
+    bool        b_seekpoints_dirty;  /* learned points not yet saved */
 
     /* title/chapters seekpoints */
     int           i_title_seekpoints;
@@ -141,6 +152,8 @@ static int Open( vlc_object_t * p_this )
     p_sys->i_pts = 0;
     p_sys->p_es = NULL;
     TAB_INIT( p_sys->i_seekpoint, p_sys->seekpoint );
+    p_sys->i_last_chunk_pos = 0;
+    p_sys->b_seekpoints_dirty = false;
     TAB_INIT( p_sys->i_attachments, p_sys->attachments);
     TAB_INIT( p_sys->i_title_seekpoints, p_sys->pp_title_seekpoints );
     p_sys->i_cover_idx = 0;
@@ -166,6 +179,9 @@ static int Open( vlc_object_t * p_this )
         return VLC_EGENERIC;
     }
 
+    p_sys->i_last_chunk_pos = p_sys->i_data_pos;
+    LoadSeekpointCache( p_demux );
+
     if( p_sys->i_cover_idx < p_sys->i_attachments )
     {
         char psz_url[128];
@@ -186,6 +202,9 @@ static void Close( vlc_object_t * p_this )
     demux_t     *p_demux = (demux_t*)p_this;
     demux_sys_t *p_sys = p_demux->p_sys;
 
+    if( p_sys->b_seekpoints_dirty )
+        SaveSeekpointCache( p_demux );
+
     for( int i = 0; i < p_sys->i_seekpoint; i++ )
         free(p_sys->seekpoint[i]);
     TAB_CLEAN( p_sys->i_seekpoint, p_sys->seekpoint );
@@ -215,6 +234,7 @@ static int Demux( demux_t *p_demux )
 {
     demux_sys_t *p_sys = p_demux->p_sys;
     block_t     *p_block_in, *p_block_out;
+    uint64_t     i_chunk_pos = stream_Tell( p_demux->s );
 
     bool b_eof = !( p_block_in = stream_Block( p_demux->s, FLAC_PACKET_SIZE ) );
 
@@ -241,6 +261,13 @@ static int Demux( demux_t *p_demux )
 
             p_sys->i_pts = p_block_out->i_dts;
 
+            /* Learn a seekpoint from the streamed frame. The chunk read
+             * previously is a lower bound for the frame start offset. */
+            if( p_block_out->i_dts > VLC_TS_INVALID &&
+                p_sys->i_last_chunk_pos >= (uint64_t)p_sys->i_data_pos )
+                LearnSeekpoint( p_demux, p_block_out->i_dts - VLC_TS_0,
+                                p_sys->i_last_chunk_pos - p_sys->i_data_pos );
+
             /* set PCR */
             es_out_Control( p_demux->out, ES_OUT_SET_PCR, p_block_out->i_dts );
 
@@ -249,6 +276,8 @@ static int Demux( demux_t *p_demux )
             p_block_out = p_next;
         }
     }
+
+    p_sys->i_last_chunk_pos = i_chunk_pos;
     return !b_eof;
 }
 
@@ -313,6 +342,7 @@ static int ControlSetTime( demux_t *p_demux, int64_t i_time )
     {
         if( stream_Seek( p_demux->s, p_sys->seekpoint[i]->i_byte_offset+p_sys->i_data_pos ) )
             return VLC_EGENERIC;
+        p_sys->i_last_chunk_pos = stream_Tell( p_demux->s );
 
         es_out_Control( p_demux->out, ES_OUT_SET_NEXT_DISPLAY_TIME, i_time );
     }
@@ -345,6 +375,7 @@ static int ControlSetTime( demux_t *p_demux, int64_t i_time )
 
         if( stream_Seek( p_demux->s, p_sys->seekpoint[i]->i_byte_offset+p_sys->i_data_pos + i_delta_offset ) )
             return VLC_EGENERIC;
+        p_sys->i_last_chunk_pos = stream_Tell( p_demux->s );
     }
     return VLC_SUCCESS;
 }
@@ -640,6 +671,165 @@ static void ParseSeekTable( demux_t *p_demux, const uint8_t *p_data, int i_data,
     /* TODO sort it by size and remove wrong seek entry (time not increasing) */
 }
 
+/*****************************************************************************
+ * Seekpoints learned from playback
+ *****************************************************************************
+ * Frames streaming by densify the (often sparse) seektable, so seeking back
+ * into an already played range needs no bisection. The learned points are
+ * saved under the user cache directory and reloaded on the next open.
+ *****************************************************************************/
+#define FLAC_LEARNED_SEEKPOINT_GAP (INT64_C(10) * CLOCK_FREQ)
+#define FLAC_SEEKPOINT_CACHE_MAX 65536
+
+static const uint8_t flac_seek_cache_magic[8] =
+    { 'V', 'L', 'C', 'F', 'L', 'A', 'C', 0x01 };
+
+static void LearnSeekpoint( demux_t *p_demux, mtime_t i_time_offset,
+                            uint64_t i_byte_offset )
+{
+    demux_sys_t *p_sys = p_demux->p_sys;
+    int i;
+
+    for( i = p_sys->i_seekpoint - 1; i >= 0; i-- )
+    {
+        if( p_sys->seekpoint[i]->i_time_offset <= i_time_offset )
+            break;
+    }
+
+    /* Keep the table sparse, and drop points that would break the time and
+     * byte offset ordering (e.g. learned before an accurate seek settled) */
+    if( i >= 0 &&
+        ( i_time_offset - p_sys->seekpoint[i]->i_time_offset
+              < FLAC_LEARNED_SEEKPOINT_GAP ||
+          i_byte_offset <= p_sys->seekpoint[i]->i_byte_offset ) )
+        return;
+    if( i + 1 < p_sys->i_seekpoint &&
+        ( p_sys->seekpoint[i+1]->i_time_offset - i_time_offset
+              < FLAC_LEARNED_SEEKPOINT_GAP ||
+          i_byte_offset >= p_sys->seekpoint[i+1]->i_byte_offset ) )
+        return;
+
+    flac_seekpoint_t *s = malloc( sizeof (*s) );
+    if( unlikely(s == NULL) )
+        return;
+    s->i_time_offset = i_time_offset;
+    s->i_byte_offset = i_byte_offset;
+    TAB_INSERT( p_sys->i_seekpoint, p_sys->seekpoint, s, i + 1 );
+    p_sys->b_seekpoints_dirty = true;
+}
+
+static char *SeekpointCachePath( demux_t *p_demux )
+{
+    if( !p_demux->psz_file )
+        return NULL;
+
+    struct stat st;
+    if( vlc_stat( p_demux->psz_file, &st ) )
+        return NULL;
+
+    struct vlc_hash64_s hash;
+    uint64_t i_size = st.st_size;
+    uint64_t i_mtime = st.st_mtime;
+    vlc_hash64_Init( &hash, 0 );
+    vlc_hash64_Add( &hash, p_demux->psz_file, strlen( p_demux->psz_file ) );
+    vlc_hash64_Add( &hash, &i_size, sizeof (i_size) );
+    vlc_hash64_Add( &hash, &i_mtime, sizeof (i_mtime) );
+
+    char psz_key[17];
+    vlc_hash64_hex( psz_key, vlc_hash64_Finish( &hash ) );
+
+    char *psz_dir = config_GetUserDir( VLC_CACHE_DIR );
+    if( !psz_dir )
+        return NULL;
+
+    char *psz_path;
+    if( asprintf( &psz_path, "%s" DIR_SEP "flac-seek-%s.dat",
+                  psz_dir, psz_key ) == -1 )
+        psz_path = NULL;
+    free( psz_dir );
+    return psz_path;
+}
+
+static void LoadSeekpointCache( demux_t *p_demux )
+{
+    demux_sys_t *p_sys = p_demux->p_sys;
+    uint8_t header[8];
+    uint32_t i_count;
+
+    char *psz_path = SeekpointCachePath( p_demux );
+    if( !psz_path )
+        return;
+
+    FILE *f = vlc_fopen( psz_path, "rb" );
+    free( psz_path );
+    if( !f )
+        return;
+
+    if( fread( header, 1, 8, f ) == 8 &&
+        !memcmp( header, flac_seek_cache_magic, 8 ) &&
+        fread( &i_count, sizeof (i_count), 1, f ) == 1 &&
+        i_count <= FLAC_SEEKPOINT_CACHE_MAX )
+    {
+        for( uint32_t j = 0; j < i_count; j++ )
+        {
+            int64_t i_time_offset;
+            uint64_t i_byte_offset;
+
+            if( fread( &i_time_offset, sizeof (i_time_offset), 1, f ) != 1 ||
+                fread( &i_byte_offset, sizeof (i_byte_offset), 1, f ) != 1 )
+                break;
+            LearnSeekpoint( p_demux, i_time_offset, i_byte_offset );
+        }
+        msg_Dbg( p_demux, "loaded seekpoints from cache" );
+    }
+    fclose( f );
+
+    /* The loaded points are already on disk */
+    p_sys->b_seekpoints_dirty = false;
+}
+
+static void SaveSeekpointCache( demux_t *p_demux )
+{
+    demux_sys_t *p_sys = p_demux->p_sys;
+
+    char *psz_path = SeekpointCachePath( p_demux );
+    if( !psz_path )
+        return;
+
+    char *psz_tmp;
+    if( asprintf( &psz_tmp, "%s.tmp", psz_path ) == -1 )
+    {
+        free( psz_path );
+        return;
+    }
+
+    FILE *f = vlc_fopen( psz_tmp, "wb" );
+    if( f )
+    {
+        uint32_t i_count = p_sys->i_seekpoint;
+        bool b_ok;
+
+        b_ok = fwrite( flac_seek_cache_magic, 1, 8, f ) == 8 &&
+               fwrite( &i_count, sizeof (i_count), 1, f ) == 1;
+
+        for( int j = 0; b_ok && j < p_sys->i_seekpoint; j++ )
+        {
+            int64_t i_time_offset = p_sys->seekpoint[j]->i_time_offset;
+            uint64_t i_byte_offset = p_sys->seekpoint[j]->i_byte_offset;
+
+            b_ok = fwrite( &i_time_offset, sizeof (i_time_offset), 1, f ) == 1
+                && fwrite( &i_byte_offset, sizeof (i_byte_offset), 1, f ) == 1;
+        }
+
+        if( fclose( f ) == 0 && b_ok && vlc_rename( psz_tmp, psz_path ) == 0 )
+            msg_Dbg( p_demux, "saved seekpoints to cache" );
+        else
+            vlc_unlink( psz_tmp );
+    }
+    free( psz_tmp );
+    free( psz_path );
+}
+
 static void ParseComment( demux_t *p_demux, const uint8_t *p_data, int i_data )
 {
     demux_sys_t *p_sys = p_demux->p_sys;
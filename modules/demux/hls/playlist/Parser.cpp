@@ -187,9 +187,19 @@ void M3U8Parser::createAndFillRepresentation(vlc_object_t *p_obj, BaseAdaptation
 
 bool M3U8Parser::appendSegmentsFromPlaylistURI(vlc_object_t *p_obj, Representation *rep)
 {
-    block_t *p_block = Retrieve::HTTP(p_obj, rep->getPlaylistUrl().toString());
+    Retrieve::ConditionalGet cond;
+    cond.etag = rep->playlistETag;
+    cond.lastModified = rep->playlistLastModified;
+    block_t *p_block = Retrieve::HTTP(p_obj, rep->getPlaylistUrl().toString(), &cond);
+    if(cond.notModified)
+    {
+        /* Playlist unchanged since last refresh, nothing to parse */
+        return true;
+    }
     if(p_block)
     {
+        rep->playlistETag = cond.etag;
+        rep->playlistLastModified = cond.lastModified;
         stream_t *substream = stream_MemoryNew(p_obj, p_block->p_buffer, p_block->i_buffer, true);
         if(substream)
         {
@@ -223,6 +233,19 @@ void M3U8Parser::parseSegments(vlc_object_t *p_obj, Representation *rep, const s
     SegmentEncryption encryption;
     const ValuesListTag *ctx_extinf = NULL;
 
+    /* On a refresh, segments up to the last known number are already in the
+     * representation and would be dropped by the merge: don't materialize
+     * them, only account their duration so start times line up */
+    uint64_t lastKnownNumber = 0;
+    bool b_hasKnownSegments = false;
+    std::vector<ISegment *> knownSegments;
+    rep->getSegments(SegmentInformation::INFOTYPE_MEDIA, knownSegments);
+    if(!knownSegments.empty())
+    {
+        lastKnownNumber = knownSegments.back()->getSequenceNumber();
+        b_hasKnownSegments = true;
+    }
+
     std::list<Tag *>::const_iterator it;
     for(it = tagslist.begin(); it != tagslist.end(); ++it)
     {
@@ -252,6 +275,34 @@ void M3U8Parser::parseSegments(vlc_object_t *p_obj, Representation *rep, const s
                     break;
                 }
 
+                if(b_hasKnownSegments && sequenceNumber <= lastKnownNumber)
+                {
+                    /* skip already known entry, keeping time/offset accounting */
+                    sequenceNumber++;
+                    if(ctx_extinf)
+                    {
+                        if(ctx_extinf->getAttributeByName("DURATION"))
+                        {
+                            const mtime_t nzDuration = CLOCK_FREQ * ctx_extinf->getAttributeByName("DURATION")->floatingPoint();
+                            nzStartTime += nzDuration;
+                            totalduration += nzDuration;
+                            if(absReferenceTime > VLC_TS_INVALID)
+                                absReferenceTime += nzDuration;
+                        }
+                        ctx_extinf = NULL;
+                    }
+                    if(ctx_byterange)
+                    {
+                        std::pair<std::size_t,std::size_t> range = ctx_byterange->getValue().getByteRange();
+                        if(range.first == 0)
+                            range.first = prevbyterangeoffset;
+                        prevbyterangeoffset = range.first + range.second;
+                        ctx_byterange = NULL;
+                    }
+                    discontinuity = false;
+                    break;
+                }
+
                 HLSSegment *segment = new (std::nothrow) HLSSegment(rep, sequenceNumber++);
                 if(!segment)
                     break;
@@ -24,6 +24,7 @@
 #include "../adaptative/playlist/BaseRepresentation.h"
 #include "../adaptative/tools/Properties.hpp"
 #include "../adaptative/StreamFormat.hpp"
+#include <string>
 
 namespace hls
 {
@@ -60,6 +61,9 @@ namespace hls
                 time_t nextUpdateTime;
                 time_t targetDuration;
                 Url playlistUrl;
+                /* validators of the last playlist fetch, for conditional refreshes */
+                std::string playlistETag;
+                std::string playlistLastModified;
         };
     }
 }
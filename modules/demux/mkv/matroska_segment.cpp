@@ -28,6 +28,9 @@
 #include "util.hpp"
 #include "Ebml_parser.hpp"
 
+#include <vlc_configuration.h>
+#include <vlc_fs.h>
+
 matroska_segment_c::matroska_segment_c( demux_sys_t & demuxer, EbmlStream & estream )
     :segment(NULL)
     ,es(estream)
@@ -105,6 +108,107 @@ matroska_segment_c::~matroska_segment_c()
  *  * LoadTags : load ... the tags element
  *  * InformationCreate : create all information, load tags if present
  *****************************************************************************/
+/* On-disk cues index cache, keyed on the segment UID. The entries are
+ * stored in the native memory layout, like the plugins cache: the cache
+ * is local to the machine and the version field covers layout changes. */
+#define CUES_CACHE_MAGIC   "MKVCUEIX"
+#define CUES_CACHE_VERSION 1
+
+char *matroska_segment_c::CueIndexCachePath() const
+{
+    if( p_segment_uid == NULL || p_segment_uid->GetBuffer() == NULL )
+        return NULL;
+
+    size_t i_size = p_segment_uid->GetSize();
+    if( i_size == 0 || i_size > 16 )
+        return NULL;
+
+    char psz_uid[2 * 16 + 1];
+    for( size_t i = 0; i < i_size; i++ )
+        sprintf( &psz_uid[2 * i], "%02x", p_segment_uid->GetBuffer()[i] );
+
+    char *psz_cachedir = config_GetUserDir( VLC_CACHE_DIR );
+    if( psz_cachedir == NULL )
+        return NULL;
+
+    char *psz_path;
+    if( asprintf( &psz_path, "%s" DIR_SEP "mkv-cues-%s.dat",
+                  psz_cachedir, psz_uid ) == -1 )
+        psz_path = NULL;
+    free( psz_cachedir );
+    return psz_path;
+}
+
+bool matroska_segment_c::LoadCachedCues()
+{
+    if( !var_InheritBool( &sys.demuxer, "mkv-cues-cache" ) )
+        return false;
+
+    char *psz_path = CueIndexCachePath();
+    if( psz_path == NULL )
+        return false;
+
+    FILE *file = vlc_fopen( psz_path, "rb" );
+    free( psz_path );
+    if( file == NULL )
+        return false;
+
+    char magic[8];
+    uint32_t i_version, i_count;
+    bool b_ok = fread( magic, 1, sizeof(magic), file ) == sizeof(magic) &&
+                memcmp( magic, CUES_CACHE_MAGIC, sizeof(magic) ) == 0 &&
+                fread( &i_version, sizeof(i_version), 1, file ) == 1 &&
+                i_version == CUES_CACHE_VERSION &&
+                fread( &i_count, sizeof(i_count), 1, file ) == 1 &&
+                i_count > 0 && i_count <= (1 << 24);
+    if( b_ok )
+    {
+        if( (int)i_count > i_index_max )
+        {
+            i_index_max = (i_count + 1023) & ~1023;
+            p_indexes = (mkv_index_t*)xrealloc( p_indexes,
+                                                sizeof( mkv_index_t ) * i_index_max );
+        }
+        b_ok = fread( p_indexes, sizeof( mkv_index_t ), i_count, file ) == i_count;
+        if( b_ok )
+        {
+            i_index = i_count;
+            b_cues = true;
+            msg_Dbg( &sys.demuxer, "|   - loaded %" PRIu32 " cues from index cache",
+                     i_count );
+        }
+        else
+            i_index = 0;
+    }
+    fclose( file );
+    return b_ok;
+}
+
+void matroska_segment_c::SaveCachedCues()
+{
+    if( i_index <= 0 || !var_InheritBool( &sys.demuxer, "mkv-cues-cache" ) )
+        return;
+
+    char *psz_path = CueIndexCachePath();
+    if( psz_path == NULL )
+        return;
+
+    FILE *file = vlc_fopen( psz_path, "wb" );
+    if( file != NULL )
+    {
+        uint32_t i_version = CUES_CACHE_VERSION;
+        uint32_t i_count = i_index;
+        bool b_ok = fwrite( CUES_CACHE_MAGIC, 1, 8, file ) == 8 &&
+                    fwrite( &i_version, sizeof(i_version), 1, file ) == 1 &&
+                    fwrite( &i_count, sizeof(i_count), 1, file ) == 1 &&
+                    fwrite( p_indexes, sizeof( mkv_index_t ), i_count, file )
+                        == i_count;
+        if( fclose( file ) != 0 || !b_ok )
+            vlc_unlink( psz_path );
+    }
+    free( psz_path );
+}
+
 void matroska_segment_c::LoadCues( KaxCues *cues )
 {
     bool b_invalid_cue;
@@ -248,6 +352,8 @@ void matroska_segment_c::LoadCues( KaxCues *cues )
     delete ep;
     b_cues = true;
     msg_Dbg( &sys.demuxer, "|   - loading cues done." );
+
+    SaveCachedCues();
 }
 
 
@@ -707,7 +813,8 @@ bool matroska_segment_c::Preload( )
             msg_Dbg(  &sys.demuxer, "|   + Cues" );
             if( i_cues_position < 0 )
             {
-                LoadCues( static_cast<KaxCues*>( el ) );
+                if( !LoadCachedCues() )
+                    LoadCues( static_cast<KaxCues*>( el ) );
                 i_cues_position = el->GetElementPosition();
             }
         }
@@ -825,7 +932,8 @@ bool matroska_segment_c::LoadSeekHeadItem( const EbmlCallbacks & ClassInfos, int
         msg_Dbg( &sys.demuxer, "|   + Cues" );
         if( i_cues_position < 0 )
         {
-            LoadCues( static_cast<KaxCues*>( el ) );
+            if( !LoadCachedCues() )
+                LoadCues( static_cast<KaxCues*>( el ) );
             i_cues_position = i_element_position;
         }
     }
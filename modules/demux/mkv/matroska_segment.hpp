@@ -148,6 +148,9 @@ public:
     static bool CompareSegmentUIDs( const matroska_segment_c * item_a, const matroska_segment_c * item_b );
 
 private:
+    char *CueIndexCachePath() const;
+    bool LoadCachedCues();
+    void SaveCachedCues();
     void LoadCues( KaxCues *cues );
     void LoadTags( KaxTags *tags );
     bool LoadSeekHeadItem( const EbmlCallbacks & ClassInfos, int64_t i_element_position );
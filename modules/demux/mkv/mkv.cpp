@@ -74,6 +74,10 @@ vlc_module_begin ()
             N_("Dummy Elements"),
             N_("Read and discard unknown EBML elements (not good for broken files)."), true );
 
+    add_bool( "mkv-cues-cache", true,
+            N_("Cues index cache"),
+            N_("Cache the cues index on disk, keyed on the segment UID, to speed up reopening."), true );
+
     add_shortcut( "mka", "mkv" )
 vlc_module_end ()
 
@@ -27,6 +27,8 @@
 #include "matroska_segment.hpp"
 #include "demux.hpp"
 
+#define MKV_IO_CACHE_SIZE (256 * 1024)
+
 /*****************************************************************************
  * Stream managment
  *****************************************************************************/
@@ -34,6 +36,11 @@ vlc_stream_io_callback::vlc_stream_io_callback( stream_t *s_, bool b_owner_ )
                        : s( s_), b_owner( b_owner_ )
 {
     mb_eof = false;
+    p_cache = (uint8_t*)malloc( MKV_IO_CACHE_SIZE );
+    i_cache_size = ( p_cache != NULL ) ? MKV_IO_CACHE_SIZE : 0;
+    i_cache_valid = 0;
+    i_cache_offset = 0;
+    i_cache_start = ( s != NULL ) ? stream_Tell( s ) : 0;
 }
 
 uint32 vlc_stream_io_callback::read( void *p_buffer, size_t i_size )
@@ -41,13 +48,49 @@ uint32 vlc_stream_io_callback::read( void *p_buffer, size_t i_size )
     if( i_size <= 0 || mb_eof )
         return 0;
 
-    return stream_Read( s, p_buffer, i_size );
+    uint8_t *p_dst = (uint8_t*)p_buffer;
+    size_t i_copied = 0;
+
+    while( i_size > 0 )
+    {
+        size_t i_avail = i_cache_valid - i_cache_offset;
+        if( i_avail > 0 )
+        {
+            size_t i_copy = __MIN( i_avail, i_size );
+            memcpy( p_dst + i_copied, p_cache + i_cache_offset, i_copy );
+            i_cache_offset += i_copy;
+            i_copied += i_copy;
+            i_size -= i_copy;
+            continue;
+        }
+
+        /* Cache drained: the underlying position matches ours */
+        i_cache_start += i_cache_valid;
+        i_cache_valid = i_cache_offset = 0;
+
+        if( i_size >= i_cache_size )
+        {   /* Large read, no point going through the cache */
+            ssize_t i_ret = stream_Read( s, p_dst + i_copied, i_size );
+            if( i_ret <= 0 )
+                break;
+            i_cache_start += i_ret;
+            i_copied += i_ret;
+            break;
+        }
+
+        ssize_t i_ret = stream_Read( s, p_cache, i_cache_size );
+        if( i_ret <= 0 )
+            break;
+        i_cache_valid = i_ret;
+    }
+
+    return i_copied;
 }
 
 void vlc_stream_io_callback::setFilePointer(int64_t i_offset, seek_mode mode )
 {
     int64_t i_pos, i_size;
-    int64_t i_current = stream_Tell( s );
+    int64_t i_current = getFilePointer();
 
     switch( mode )
     {
@@ -72,6 +115,16 @@ void vlc_stream_io_callback::setFilePointer(int64_t i_offset, seek_mode mode )
     }
 
     mb_eof = false;
+
+    if( (uint64_t)i_pos >= i_cache_start &&
+        (uint64_t)i_pos <= i_cache_start + i_cache_valid )
+    {   /* Short hop within (or right after) the cached data */
+        i_cache_offset = i_pos - i_cache_start;
+        return;
+    }
+
+    i_cache_valid = i_cache_offset = 0;
+    i_cache_start = i_pos;
     if( stream_Seek( s, i_pos ) )
     {
         mb_eof = true;
@@ -83,7 +136,7 @@ uint64 vlc_stream_io_callback::getFilePointer( void )
 {
     if ( s == NULL )
         return 0;
-    return stream_Tell( s );
+    return i_cache_start + i_cache_offset;
 }
 
 size_t vlc_stream_io_callback::write(const void *, size_t )
@@ -103,6 +156,5 @@ uint64 vlc_stream_io_callback::toRead( void )
     if( i_size == 0 )
         return UINT64_MAX;
 
-    return (uint64) i_size - stream_Tell( s );
+    return (uint64) i_size - getFilePointer();
 }
-
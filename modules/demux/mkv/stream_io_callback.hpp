@@ -33,11 +33,22 @@ class vlc_stream_io_callback: public IOCallback
     bool           mb_eof;
     bool           b_owner;
 
+    /* Read cache, so EBML ID/size parsing does not cross the stream
+     * filter stack one or two bytes at a time. The underlying stream
+     * position is always i_cache_start + i_cache_valid; the position
+     * seen by the EBML layer is i_cache_start + i_cache_offset. */
+    uint8_t        *p_cache;
+    size_t         i_cache_size;
+    size_t         i_cache_valid;
+    size_t         i_cache_offset;
+    uint64_t       i_cache_start;
+
   public:
     vlc_stream_io_callback( stream_t *, bool );
 
     virtual ~vlc_stream_io_callback()
     {
+        free( p_cache );
         if( b_owner )
             stream_Delete( s );
     }
@@ -51,6 +51,7 @@ void MP4_Fragments_Clean( mp4_fragments_t *p_frags )
         p_frags->moov.p_next = p_fragment;
     }
     MP4_Fragment_Clean( &p_frags->moov );
+    free( p_frags->index.p_entries );
 }
 
 void MP4_Fragments_Insert( mp4_fragments_t *p_frags, mp4_fragment_t *p_new )
@@ -90,9 +91,87 @@ void MP4_Fragments_Insert( mp4_fragments_t *p_frags, mp4_fragment_t *p_new )
 bool MP4_Fragments_Init( mp4_fragments_t *p_frags )
 {
     memset( &p_frags->moov, 0, sizeof(mp4_fragment_t) );
+    memset( &p_frags->index, 0, sizeof(mp4_fragments_index_t) );
     return true;
 }
 
+bool MP4_Fragments_Index_Build( mp4_fragments_t *p_frags,
+                                const MP4_Box_data_sidx_t *p_data,
+                                uint64_t i_start_pos )
+{
+    if( p_frags->index.p_entries ||
+        !p_data->i_timescale || !p_data->i_reference_count )
+        return false;
+
+    /* Nested indexes would need the referenced sidx boxes fetched first,
+     * which defeats eager indexing. Only flat media references qualify. */
+    for( uint16_t i=0; i<p_data->i_reference_count; i++ )
+    {
+        if( p_data->p_items[i].b_reference_type != 0 )
+            return false;
+    }
+
+    mp4_fragindex_entry_t *p_entries =
+            calloc( p_data->i_reference_count, sizeof(*p_entries) );
+    if( !p_entries )
+        return false;
+
+    uint64_t i_offset = i_start_pos + p_data->i_first_offset;
+    stime_t i_time = p_data->i_earliest_presentation_time;
+    for( uint16_t i=0; i<p_data->i_reference_count; i++ )
+    {
+        p_entries[i].i_moof_offset = i_offset;
+        p_entries[i].i_time = i_time;
+        p_entries[i].i_duration = p_data->p_items[i].i_subsegment_duration;
+        i_offset += p_data->p_items[i].i_referenced_size;
+        i_time += p_data->p_items[i].i_subsegment_duration;
+    }
+
+    p_frags->index.p_entries = p_entries;
+    p_frags->index.i_entries = p_data->i_reference_count;
+    p_frags->index.i_timescale = p_data->i_timescale;
+    return true;
+}
+
+int MP4_Fragments_Index_GetMoofPosByTime( mp4_fragments_t *p_frags,
+                                          const mtime_t i_target_time,
+                                          uint64_t *pi_pos, mtime_t *pi_mooftime )
+{
+    const mp4_fragments_index_t *p_index = &p_frags->index;
+    if( !p_index->i_entries )
+        return VLC_EGENERIC;
+
+    const stime_t i_scaled_time = i_target_time * p_index->i_timescale / CLOCK_FREQ;
+    const mp4_fragindex_entry_t *p_last = &p_index->p_entries[p_index->i_entries - 1];
+    if( i_scaled_time >= p_last->i_time + p_last->i_duration )
+        return VLC_EGENERIC;
+
+    /* Find the last entry starting at or before the target time */
+    uint32_t i_low = 0;
+    uint32_t i_high = p_index->i_entries;
+    while( i_high - i_low > 1 )
+    {
+        const uint32_t i_mid = i_low + (i_high - i_low) / 2;
+        if( p_index->p_entries[i_mid].i_time <= i_scaled_time )
+            i_low = i_mid;
+        else
+            i_high = i_mid;
+    }
+
+    *pi_pos = p_index->p_entries[i_low].i_moof_offset;
+    *pi_mooftime = CLOCK_FREQ * p_index->p_entries[i_low].i_time / p_index->i_timescale;
+    return VLC_SUCCESS;
+}
+
+mtime_t MP4_Fragments_Index_GetTotalDuration( mp4_fragments_t *p_frags )
+{
+    const mp4_fragments_index_t *p_index = &p_frags->index;
+    if( !p_index->i_entries )
+        return 0;
+    const mp4_fragindex_entry_t *p_last = &p_index->p_entries[p_index->i_entries - 1];
+    return CLOCK_FREQ * (p_last->i_time + p_last->i_duration) / p_index->i_timescale;
+}
+
 static stime_t GetTrackDurationInFragment( const mp4_fragment_t *p_fragment,
                                            unsigned int i_track_ID )
 {
@@ -46,10 +46,25 @@ struct mp4_fragment_t
     mp4_fragment_t *p_next;
 };
 
+typedef struct
+{
+    uint64_t i_moof_offset;
+    stime_t  i_time;     /* index timescale */
+    stime_t  i_duration; /* index timescale */
+} mp4_fragindex_entry_t;
+
+typedef struct
+{
+    mp4_fragindex_entry_t *p_entries; /* sorted by time/offset */
+    uint32_t i_entries;
+    uint32_t i_timescale;
+} mp4_fragments_index_t;
+
 typedef struct
 {
     mp4_fragment_t moov; /* known fragments (moof following moov) */
     mp4_fragment_t *p_last;
+    mp4_fragments_index_t index; /* eager index built from sidx */
 } mp4_fragments_t;
 
 static inline mp4_fragment_t * MP4_Fragment_Moov(mp4_fragments_t *p_fragments)
@@ -57,6 +72,11 @@ static inline mp4_fragment_t * MP4_Fragment_Moov(mp4_fragments_t *p_fragments)
     return &p_fragments->moov;
 }
 
+static inline bool MP4_Fragments_Index_Present(const mp4_fragments_t *p_fragments)
+{
+    return p_fragments->index.i_entries > 0;
+}
+
 mp4_fragment_t * MP4_Fragment_New( MP4_Box_t *, unsigned );
 void MP4_Fragment_Clean(mp4_fragment_t *);
 
@@ -70,6 +90,14 @@ bool MP4_Fragments_Init(mp4_fragments_t *);
 void MP4_Fragments_Clean(mp4_fragments_t *);
 void MP4_Fragments_Insert(mp4_fragments_t *, mp4_fragment_t *);
 
+bool MP4_Fragments_Index_Build( mp4_fragments_t *p_frags,
+                                const MP4_Box_data_sidx_t *p_data,
+                                uint64_t i_start_pos );
+int MP4_Fragments_Index_GetMoofPosByTime( mp4_fragments_t *p_frags,
+                                          const mtime_t i_target_time,
+                                          uint64_t *pi_pos, mtime_t *pi_mooftime );
+mtime_t MP4_Fragments_Index_GetTotalDuration( mp4_fragments_t *p_frags );
+
 stime_t GetTrackTotalDuration( mp4_fragments_t *p_frags, unsigned int i_track_ID );
 mp4_fragment_t * GetFragmentByAtomPos( mp4_fragments_t *p_frags, uint64_t i_pos );
 mp4_fragment_t * GetFragmentByPos( mp4_fragments_t *p_frags, uint64_t i_pos, bool b_exact );
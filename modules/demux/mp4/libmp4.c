@@ -823,6 +823,19 @@ static int MP4_ReadBox_trun(  stream_t *p_stream, MP4_Box_t *p_box )
     if( p_box->data.p_trun->i_flags & MP4_TRUN_FIRST_FLAGS )
         MP4_GET4BYTES( p_box->data.p_trun->i_first_sample_flags );
 
+    uint32_t i_entry_size = 0;
+    if( p_box->data.p_trun->i_flags & MP4_TRUN_SAMPLE_DURATION )
+        i_entry_size += 4;
+    if( p_box->data.p_trun->i_flags & MP4_TRUN_SAMPLE_SIZE )
+        i_entry_size += 4;
+    if( p_box->data.p_trun->i_flags & MP4_TRUN_SAMPLE_FLAGS )
+        i_entry_size += 4;
+    if( p_box->data.p_trun->i_flags & MP4_TRUN_SAMPLE_TIME_OFFSET )
+        i_entry_size += 4;
+    if( i_entry_size > 0 &&
+        p_box->data.p_trun->i_sample_count > i_read / i_entry_size )
+        p_box->data.p_trun->i_sample_count = i_read / i_entry_size;
+
     p_box->data.p_trun->p_samples =
       calloc( p_box->data.p_trun->i_sample_count, sizeof(MP4_descriptor_trun_sample_t) );
     if ( p_box->data.p_trun->p_samples == NULL )
@@ -1251,6 +1264,10 @@ static int MP4_ReadBox_stts( stream_t *p_stream, MP4_Box_t *p_box )
     MP4_GETVERSIONFLAGS( p_box->data.p_stts );
     MP4_GET4BYTES( p_box->data.p_stts->i_entry_count );
 
+    /* Don't allocate more entries than the payload can hold */
+    if( p_box->data.p_stts->i_entry_count > i_read / 8 )
+        p_box->data.p_stts->i_entry_count = i_read / 8;
+
     p_box->data.p_stts->pi_sample_count =
         calloc( p_box->data.p_stts->i_entry_count, sizeof(uint32_t) );
     p_box->data.p_stts->pi_sample_delta =
@@ -1294,6 +1311,9 @@ static int MP4_ReadBox_ctts( stream_t *p_stream, MP4_Box_t *p_box )
 
     MP4_GET4BYTES( p_box->data.p_ctts->i_entry_count );
 
+    if( p_box->data.p_ctts->i_entry_count > i_read / 8 )
+        p_box->data.p_ctts->i_entry_count = i_read / 8;
+
     p_box->data.p_ctts->pi_sample_count =
         calloc( p_box->data.p_ctts->i_entry_count, sizeof(uint32_t) );
     p_box->data.p_ctts->pi_sample_offset =
@@ -2307,6 +2327,9 @@ static int MP4_ReadBox_stsc( stream_t *p_stream, MP4_Box_t *p_box )
 
     MP4_GET4BYTES( p_box->data.p_stsc->i_entry_count );
 
+    if( p_box->data.p_stsc->i_entry_count > i_read / 12 )
+        p_box->data.p_stsc->i_entry_count = i_read / 12;
+
     p_box->data.p_stsc->i_first_chunk =
         calloc( p_box->data.p_stsc->i_entry_count, sizeof(uint32_t) );
     p_box->data.p_stsc->i_samples_per_chunk =
@@ -2348,6 +2371,10 @@ static int MP4_ReadBox_stco_co64( stream_t *p_stream, MP4_Box_t *p_box )
 
     MP4_GET4BYTES( p_box->data.p_co64->i_entry_count );
 
+    const uint64_t i_entry_size = ( p_box->i_type == ATOM_stco ) ? 4 : 8;
+    if( p_box->data.p_co64->i_entry_count > i_read / i_entry_size )
+        p_box->data.p_co64->i_entry_count = i_read / i_entry_size;
+
     p_box->data.p_co64->i_chunk_offset =
         calloc( p_box->data.p_co64->i_entry_count, sizeof(uint64_t) );
     if( p_box->data.p_co64->i_chunk_offset == NULL )
@@ -2394,6 +2421,9 @@ static int MP4_ReadBox_stss( stream_t *p_stream, MP4_Box_t *p_box )
 
     MP4_GET4BYTES( p_box->data.p_stss->i_entry_count );
 
+    if( p_box->data.p_stss->i_entry_count > i_read / 4 )
+        p_box->data.p_stss->i_entry_count = i_read / 4;
+
     p_box->data.p_stss->i_sample_number =
         calloc( p_box->data.p_stss->i_entry_count, sizeof(uint32_t) );
     if( unlikely( p_box->data.p_stss->i_sample_number == NULL ) )
@@ -2560,6 +2590,10 @@ static int MP4_ReadBox_elst( stream_t *p_stream, MP4_Box_t *p_box )
 
     MP4_GET4BYTES( p_box->data.p_elst->i_entry_count );
 
+    const uint64_t i_entry_size = ( p_box->data.p_elst->i_version == 1 ) ? 20 : 12;
+    if( p_box->data.p_elst->i_entry_count > i_read / i_entry_size )
+        p_box->data.p_elst->i_entry_count = i_read / i_entry_size;
+
     p_box->data.p_elst->i_segment_duration =
         calloc( p_box->data.p_elst->i_entry_count, sizeof(uint64_t) );
     p_box->data.p_elst->i_media_time =
@@ -588,7 +588,20 @@ static int Open( vlc_object_t * p_this )
             ProbeFragments( p_demux, false );
             p_sys->b_fragmented = !!MP4_BoxCount( p_sys->p_root, "/moof" );
 
-            if ( p_sys->b_fragmented && !p_sys->i_overall_duration )
+            /* DASH VOD fronts the file with a segment index: build our
+             * seek table from it once instead of walking every box */
+            if ( p_sys->b_fragmented )
+            {
+                MP4_Box_t *p_sidx = MP4_BoxGet( p_sys->p_root, "sidx" );
+                if ( p_sidx && BOXDATA(p_sidx) &&
+                     MP4_Fragments_Index_Build( &p_sys->fragments, BOXDATA(p_sidx),
+                                                p_sidx->i_pos + p_sidx->i_size ) )
+                    msg_Dbg( p_demux, "built sidx fragments index, %"PRIu32" entries",
+                             p_sys->fragments.index.i_entries );
+            }
+
+            if ( p_sys->b_fragmented && !p_sys->i_overall_duration &&
+                 !MP4_Fragments_Index_Present( &p_sys->fragments ) )
                 ProbeFragments( p_demux, true );
 
             MP4_Box_t *p_mdat = MP4_BoxGet( p_sys->p_root, "mdat" );
@@ -820,6 +833,10 @@ static int Open( vlc_object_t * p_this )
         MP4_Box_t *p_mehd = MP4_BoxGet( p_demux->p_sys->p_root, "moov/mvex/mehd");
         if ( p_mehd && p_mehd->data.p_mehd )
             p_sys->i_overall_duration = p_mehd->data.p_mehd->i_fragment_duration;
+        else if ( MP4_Fragments_Index_Present( &p_sys->fragments ) )
+            p_sys->i_overall_duration =
+                    MP4_Fragments_Index_GetTotalDuration( &p_sys->fragments )
+                        * p_sys->i_timescale / CLOCK_FREQ;
         else
         {
             for( i = 0; i < p_sys->i_tracks; i++ )
@@ -1179,7 +1196,9 @@ static int LeafSeekToTime( demux_t *p_demux, mtime_t i_nztime )
     if ( !p_sys->i_timescale || !p_sys->i_overall_duration || !p_sys->b_seekable )
          return VLC_EGENERIC;
 
-    if ( !p_sys->b_fragments_probed && !p_sys->b_index_probed && p_sys->b_seekable )
+    /* No need to fetch a tail mfra when the sidx already maps times to moofs */
+    if ( !p_sys->b_fragments_probed && !p_sys->b_index_probed && p_sys->b_seekable &&
+         !MP4_Fragments_Index_Present( &p_sys->fragments ) )
     {
         ProbeIndex( p_demux );
         p_sys->b_index_probed = true;
@@ -1205,7 +1224,9 @@ static int LeafSeekToTime( demux_t *p_demux, mtime_t i_nztime )
     {
         mtime_t i_mooftime;
         msg_Dbg( p_demux, "seek can't find matching fragment for %"PRId64", trying index", i_nztime );
-        if ( LeafIndexGetMoofPosByTime( p_demux, i_nztime, &i64, &i_mooftime ) == VLC_SUCCESS )
+        if ( MP4_Fragments_Index_GetMoofPosByTime( &p_sys->fragments, i_nztime,
+                                                   &i64, &i_mooftime ) == VLC_SUCCESS ||
+             LeafIndexGetMoofPosByTime( p_demux, i_nztime, &i64, &i_mooftime ) == VLC_SUCCESS )
         {
             msg_Dbg( p_demux, "seek trying to go to unknown but indexed fragment at %"PRId64, i64 );
             if( stream_Seek( p_demux->s, i64 ) )
@@ -2417,23 +2438,20 @@ static int TrackTimeToSampleChunk( demux_t *p_demux, mp4_track_t *p_track,
         i_start = i_start * p_track->i_timescale / CLOCK_FREQ;
     }
 
-    /* we start from sample 0/chunk 0, hope it won't take too much time */
     /* *** find good chunk *** */
-    for( i_chunk = 0; ; i_chunk++ )
+    /* i_first_dts is cumulative and sorted: binary search the last chunk
+     * starting at or before i_start */
     {
-        if( i_chunk + 1 >= p_track->i_chunk_count )
+        uint32_t i_lo = 0, i_hi = p_track->i_chunk_count - 1;
+        while( i_lo < i_hi )
         {
-            /* at the end and can't check if i_start in this chunk,
-               it will be check while searching i_sample */
-            i_chunk = p_track->i_chunk_count - 1;
-            break;
-        }
-
-        if( (uint64_t)i_start >= p_track->chunk[i_chunk].i_first_dts &&
-            (uint64_t)i_start <  p_track->chunk[i_chunk + 1].i_first_dts )
-        {
-            break;
+            uint32_t i_mid = i_lo + (i_hi - i_lo + 1) / 2;
+            if( (uint64_t)i_start >= p_track->chunk[i_mid].i_first_dts )
+                i_lo = i_mid;
+            else
+                i_hi = i_mid - 1;
         }
+        i_chunk = i_lo;
     }
 
     /* *** find sample in the chunk *** */
@@ -2474,37 +2492,44 @@ static int TrackTimeToSampleChunk( demux_t *p_demux, mp4_track_t *p_track,
 
 
     /* *** Try to find nearest sync points *** */
-    if( ( p_box_stss = MP4_BoxGet( p_track->p_stbl, "stss" ) ) )
+    if( ( p_box_stss = MP4_BoxGet( p_track->p_stbl, "stss" ) ) &&
+        p_box_stss->data.p_stss->i_entry_count > 0 )
     {
         MP4_Box_data_stss_t *p_stss = p_box_stss->data.p_stss;
         msg_Dbg( p_demux, "track[Id 0x%x] using Sync Sample Box (stss)",
                  p_track->i_track_ID );
-        for( unsigned i_index = 0; i_index < p_stss->i_entry_count; i_index++ )
+
+        /* Sample numbers are sorted: binary search the last sync point
+         * at or before i_sample (first entry if seeking before it) */
+        unsigned i_index = 0;
+        unsigned i_max = p_stss->i_entry_count - 1;
+        while( i_index < i_max )
         {
-            if( i_index >= p_stss->i_entry_count - 1 ||
-                i_sample < p_stss->i_sample_number[i_index+1] )
-            {
-                unsigned i_sync_sample = p_stss->i_sample_number[i_index];
-                msg_Dbg( p_demux, "stss gives %d --> %d (sample number)",
-                         i_sample, i_sync_sample );
+            unsigned i_mid = i_index + (i_max - i_index + 1) / 2;
+            if( p_stss->i_sample_number[i_mid] <= i_sample )
+                i_index = i_mid;
+            else
+                i_max = i_mid - 1;
+        }
 
-                if( i_sync_sample <= i_sample )
-                {
-                    while( i_chunk > 0 &&
-                           i_sync_sample < p_track->chunk[i_chunk].i_sample_first )
-                        i_chunk--;
-                }
-                else
-                {
-                    while( i_chunk < p_track->i_chunk_count - 1 &&
-                           i_sync_sample >= p_track->chunk[i_chunk].i_sample_first +
-                                            p_track->chunk[i_chunk].i_sample_count )
-                        i_chunk++;
-                }
-                i_sample = i_sync_sample;
-                break;
-            }
+        unsigned i_sync_sample = p_stss->i_sample_number[i_index];
+        msg_Dbg( p_demux, "stss gives %d --> %d (sample number)",
+                 i_sample, i_sync_sample );
+
+        if( i_sync_sample <= i_sample )
+        {
+            while( i_chunk > 0 &&
+                   i_sync_sample < p_track->chunk[i_chunk].i_sample_first )
+                i_chunk--;
+        }
+        else
+        {
+            while( i_chunk < p_track->i_chunk_count - 1 &&
+                   i_sync_sample >= p_track->chunk[i_chunk].i_sample_first +
+                                    p_track->chunk[i_chunk].i_sample_count )
+                i_chunk++;
         }
+        i_sample = i_sync_sample;
     }
     else
     {
@@ -191,52 +191,77 @@ static void Close( vlc_object_t *p_this )
     free( p_sys );
 }
 
-static int Demux2( demux_t *p_demux, bool b_end )
+/* Size of the bulk reads used when probing the stream duration */
+#define PS_SCAN_WINDOW (256*1024)
+/* Number of PES headers sampled when probing the first timestamps */
+#define PS_SCAN_MAX_PES 64
+
+/* Scan a memory window for PES packets and record the first (resp. last)
+ * PTS of each track.  Working from one bulk read, with memchr doing the
+ * start code prefix search, is far cheaper than reading and parsing the
+ * stream packet per packet. */
+static void ScanTimestamps( demux_t *p_demux, bool b_end,
+                            const uint8_t *p_data, size_t i_data )
 {
     demux_sys_t *p_sys = p_demux->p_sys;
-    int i_ret, i_id;
-    uint32_t i_code;
-    block_t *p_pkt;
+    const uint8_t *p = p_data;
+    const uint8_t *p_end = p_data + i_data;
+    int i_pes = 0;
 
-    i_ret = ps_pkt_resynch( p_demux->s, &i_code );
-    if( i_ret < 0 )
-    {
-        return 0;
-    }
-    else if( i_ret == 0 )
+    while( p + 4 <= p_end )
     {
-        if( !p_sys->b_lost_sync )
-            msg_Warn( p_demux, "garbage at input, trying to resync..." );
-
-        p_sys->b_lost_sync = true;
-        return 1;
-    }
+        p = memchr( p, 0, p_end - p );
+        if( p == NULL || p + 4 > p_end )
+            break;
+        if( p[1] != 0 || p[2] != 1 || p[3] < 0xb9 )
+        {
+            p++;
+            continue;
+        }
 
-    if( p_sys->b_lost_sync ) msg_Warn( p_demux, "found sync code" );
-    p_sys->b_lost_sync = false;
+        int i_size = ps_pkt_size( p, p_end - p );
+        if( i_size < 4 )
+        {
+            p += 4;
+            continue;
+        }
+        if( i_size > p_end - p )
+            i_size = p_end - p;
 
-    if( ( p_pkt = ps_pkt_read( p_demux->s, i_code ) ) == NULL )
-    {
-        return 0;
-    }
-    if( (i_id = ps_pkt_id( p_pkt )) >= 0xc0 )
-    {
-        ps_track_t *tk = &p_sys->tk[PS_ID_TO_TK(i_id)];
-        if( !ps_pkt_parse_pes( VLC_OBJECT(p_demux), p_pkt, tk->i_skip ) &&
-             p_pkt->i_pts > VLC_TS_INVALID )
+        if( p[3] >= 0xbc )
         {
-            if( b_end && p_pkt->i_pts > tk->i_last_pts )
-            {
-                tk->i_last_pts = p_pkt->i_pts;
-            }
-            else if ( tk->i_first_pts == -1 )
+            block_t pkt;
+            pkt.p_buffer = (uint8_t *)p;
+            pkt.i_buffer = i_size;
+
+            int i_id = ps_pkt_id( &pkt );
+            if( i_id >= 0xc0 )
             {
-                tk->i_first_pts = p_pkt->i_pts;
+                ps_track_t *tk = &p_sys->tk[PS_ID_TO_TK(i_id)];
+                unsigned int i_skip = 0;
+                mtime_t i_dts = -1, i_pts = -1;
+                uint8_t i_stream_id = 0;
+
+                if( ParsePESHeader( VLC_OBJECT(p_demux), p, i_size, &i_skip,
+                                    &i_dts, &i_pts, &i_stream_id ) == VLC_SUCCESS &&
+                    i_pts >= 0 )
+                {
+                    mtime_t i_ts = FROM_SCALE( i_pts );
+                    if( b_end && i_ts > tk->i_last_pts )
+                    {
+                        tk->i_last_pts = i_ts;
+                    }
+                    else if( tk->i_first_pts == -1 )
+                    {
+                        tk->i_first_pts = i_ts;
+                    }
+                }
+                if( !b_end && ++i_pes >= PS_SCAN_MAX_PES )
+                    break;
             }
         }
+        p += i_size;
     }
-    block_Release( p_pkt );
-    return 1;
 }
 
 static void FindLength( demux_t *p_demux )
@@ -249,19 +274,28 @@ static void FindLength( demux_t *p_demux )
 
     if( p_sys->i_length == -1 ) /* First time */
     {
+        block_t *p_block;
+
         p_sys->i_length = 0;
         /* Check beginning */
-        int i = 0;
         i_current_pos = stream_Tell( p_demux->s );
-        while( i < 40 && Demux2( p_demux, false ) > 0 ) i++;
+        if( ( p_block = stream_Block( p_demux->s, PS_SCAN_WINDOW ) ) )
+        {
+            ScanTimestamps( p_demux, false, p_block->p_buffer,
+                            p_block->i_buffer );
+            block_Release( p_block );
+        }
 
         /* Check end */
         i_size = stream_Size( p_demux->s );
-        i_end = VLC_CLIP( i_size, 0, 200000 );
-        stream_Seek( p_demux->s, i_size - i_end );
-
-        i = 0;
-        while( i < 400 && Demux2( p_demux, true ) > 0 ) i++;
+        i_end = VLC_CLIP( i_size, 0, PS_SCAN_WINDOW );
+        if( !stream_Seek( p_demux->s, i_size - i_end ) &&
+            ( p_block = stream_Block( p_demux->s, i_end ) ) )
+        {
+            ScanTimestamps( p_demux, true, p_block->p_buffer,
+                            p_block->i_buffer );
+            block_Release( p_block );
+        }
         if( i_current_pos >= 0 ) stream_Seek( p_demux->s, i_current_pos );
     }
 
@@ -20,6 +20,7 @@
 #include "sections.h"
 
 #include <vlc_block.h>
+#include <vlc_crc.h>
 
 typedef struct ts_sections_assembler_t
 {
@@ -87,7 +88,14 @@ static block_t * ts_sections_assembler_Append( ts_sections_assembler_t *p_as, bl
             block_Release( p_content );
             return NULL;
         }
-        /* TODO: CRC32 */
+        /* Long sections carry a trailing CRC_32 over the whole section;
+         * the checksum of the section including that field must be zero. */
+        if( vlc_crc32( 0xffffffff, p_content->p_buffer,
+                       3 + i_private_length ) != 0 )
+        {
+            block_Release( p_content );
+            return NULL;
+        }
         const uint8_t i_version = ( p_content->p_buffer[5] & 0x3F ) >> 1;
         const uint8_t i_current = p_content->p_buffer[5] & 0x01;
         const uint8_t i_section = p_content->p_buffer[6];
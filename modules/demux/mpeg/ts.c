@@ -2675,8 +2675,18 @@ static block_t* ReadTSPacket( demux_t *p_demux )
 
             while( i_skip < i_peek - p_sys->i_packet_size )
             {
-                if( p_peek[i_skip + p_sys->i_packet_header_size] == 0x47 &&
-                        p_peek[i_skip + p_sys->i_packet_header_size + p_sys->i_packet_size] == 0x47 )
+                /* Jump between 0x47 candidates with memchr (vectorized by
+                 * the libc) instead of testing every byte */
+                const uint8_t *p_sync =
+                    memchr( &p_peek[i_skip + p_sys->i_packet_header_size], 0x47,
+                            i_peek - p_sys->i_packet_size - i_skip );
+                if( p_sync == NULL )
+                {
+                    i_skip = i_peek - p_sys->i_packet_size;
+                    break;
+                }
+                i_skip = (p_sync - p_peek) - p_sys->i_packet_header_size;
+                if( p_peek[i_skip + p_sys->i_packet_header_size + p_sys->i_packet_size] == 0x47 )
                 {
                     break;
                 }
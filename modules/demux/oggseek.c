@@ -121,6 +121,7 @@ const demux_index_entry_t *OggSeek_IndexAdd ( logical_stream_t *p_stream,
 
     while ( idx != NULL )
     {
+        if ( idx->i_pagepos == i_pagepos ) return idx; /* already known */
         if ( idx->i_pagepos > i_pagepos ) break;
         last_idx = idx;
         idx = idx->p_next;
@@ -815,6 +816,12 @@ static int64_t OggBisectSearchByTime( demux_t *p_demux, logical_stream_t *p_stre
         {
             /* found a page */
 
+            /* Remember every probed page, so that the next bisections
+             * for nearby times start from much tighter bounds */
+            OggNoDebug(
+                OggSeek_IndexAdd( p_stream, current.i_timestamp, current.i_pos )
+            );
+
             if ( current.i_timestamp <= i_targettime )
             {
                 /* set our lower bound */
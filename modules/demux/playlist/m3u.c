@@ -177,7 +177,10 @@ static int Demux( demux_t *p_demux )
     input_item_t *p_current_input = GetCurrentItem(p_demux);
     input_item_node_t *p_subitems = input_item_node_Create( p_current_input );
 
-    psz_line = stream_ReadLine( p_demux->s );
+    struct playlist_lines lines;
+    playlist_LinesInit( &lines, p_demux->s );
+
+    psz_line = playlist_LinesNext( &lines );
     while( psz_line )
     {
         char *psz_parse = psz_line;
@@ -274,8 +277,7 @@ static int Demux( demux_t *p_demux )
  error:
 
         /* Fetch another line */
-        free( psz_line );
-        psz_line = stream_ReadLine( p_demux->s );
+        psz_line = playlist_LinesNext( &lines );
         if( !psz_line ) b_cleanup = true;
 
         if( b_cleanup )
@@ -293,6 +295,7 @@ static int Demux( demux_t *p_demux )
             b_cleanup = false;
         }
     }
+    playlist_LinesClean( &lines );
     input_item_node_PostAndDelete( p_subitems );
     vlc_gc_decref(p_current_input);
     var_Destroy( p_demux, "m3u-extvlcopt" );
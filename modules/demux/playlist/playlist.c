@@ -298,3 +298,93 @@ bool CheckContentType( stream_t * p_stream, const char * psz_ctype )
 
     return ( i_res == 0 ) ? true : false;
 }
+
+/* Do not slurp more than this; anything bigger is likely not a playlist
+ * anyway and falls back to line-by-line reading */
+#define PLAYLIST_SLURP_MAX (1 << 26)
+
+/**
+ * Prepares reading a text playlist line by line.
+ *
+ * When the size of the stream is known (and sane), the whole payload is
+ * read at once and lines are later split in place, instead of one heap
+ * allocation per line through stream_ReadLine(). Non-seekable and UTF-16
+ * streams (stream_ReadLine() converts the latter) keep the line-by-line
+ * path.
+ */
+void playlist_LinesInit( struct playlist_lines *p_lines, stream_t *s )
+{
+    p_lines->p_buffer = p_lines->p_next = p_lines->p_end = NULL;
+    p_lines->s = s;
+    p_lines->psz_last = NULL;
+
+    int64_t i_size = stream_Size( s );
+    if( i_size <= 0 || i_size > PLAYLIST_SLURP_MAX )
+        return;
+
+    const uint8_t *p_peek;
+    if( stream_Peek( s, &p_peek, 2 ) == 2
+     && ( ( p_peek[0] == 0xFF && p_peek[1] == 0xFE )
+       || ( p_peek[0] == 0xFE && p_peek[1] == 0xFF ) ) )
+        return; /* UTF-16 BOM */
+
+    char *p_buffer = malloc( i_size + 1 );
+    if( !p_buffer )
+        return;
+
+    ssize_t i_read = stream_Read( s, p_buffer, i_size );
+    if( i_read <= 0 )
+    {
+        free( p_buffer );
+        return;
+    }
+    p_buffer[i_read] = '\0';
+
+    p_lines->p_buffer = p_lines->p_next = p_buffer;
+    p_lines->p_end = p_buffer + i_read;
+    p_lines->s = NULL;
+}
+
+/**
+ * Returns the next line, or NULL at end of stream.
+ *
+ * The line is owned by the reader: do not free it, and do not use it after
+ * the next call.
+ */
+char *playlist_LinesNext( struct playlist_lines *p_lines )
+{
+    if( p_lines->s != NULL )
+    {
+        free( p_lines->psz_last );
+        p_lines->psz_last = stream_ReadLine( p_lines->s );
+        return p_lines->psz_last;
+    }
+
+    char *psz_line = p_lines->p_next;
+    if( psz_line >= p_lines->p_end )
+        return NULL;
+
+    char *psz_eol = memchr( psz_line, '\n', p_lines->p_end - psz_line );
+    if( psz_eol != NULL )
+    {
+        p_lines->p_next = psz_eol + 1;
+        if( psz_eol > psz_line && psz_eol[-1] == '\r' )
+            psz_eol--;
+        *psz_eol = '\0';
+    }
+    else
+    {
+        /* Last line, already NUL-terminated at the end of the buffer */
+        p_lines->p_next = p_lines->p_end;
+        if( p_lines->p_end > psz_line && p_lines->p_end[-1] == '\r' )
+            p_lines->p_end[-1] = '\0';
+    }
+
+    return psz_line;
+}
+
+void playlist_LinesClean( struct playlist_lines *p_lines )
+{
+    free( p_lines->p_buffer );
+    free( p_lines->psz_last );
+}
@@ -27,6 +27,22 @@ int Control(demux_t *, int, va_list);
 char *ProcessMRL( const char *, const char * );
 char *FindPrefix( demux_t * );
 
+/* Bulk line reader: seekable streams are slurped once and lines handed out
+ * are split in place; otherwise falls back to stream_ReadLine(). Lines are
+ * owned by the reader and only valid until the next call. */
+struct playlist_lines
+{
+    char     *p_buffer;   /* slurped payload, lines NUL-split in place */
+    char     *p_next;     /* cursor into p_buffer */
+    char     *p_end;
+    stream_t *s;          /* fallback source (NULL when slurped) */
+    char     *psz_last;   /* last line returned by the fallback */
+};
+
+void playlist_LinesInit( struct playlist_lines *, stream_t * );
+char *playlist_LinesNext( struct playlist_lines * );
+void playlist_LinesClean( struct playlist_lines * );
+
 int Import_Old ( vlc_object_t * );
 
 int Import_Native ( vlc_object_t * );
@@ -125,6 +125,7 @@ typedef struct
     int     i_line_count;
     int     i_line;
     char    **line;
+    char    *p_buffer; /* Arena holding all the lines, when slurped at once */
 } text_t;
 
 static int  TextLoad( text_t *, stream_t *s );
@@ -152,6 +153,8 @@ struct demux_sys_t
     int         i_subtitle;
     int         i_subtitles;
     subtitle_t  *subtitle;
+    /* Running maximum of the stop times, for binary-search seeking */
+    int64_t     *pi_stop_max;
 
     int64_t     i_length;
 
@@ -229,6 +232,8 @@ static int Demux( demux_t * );
 static int Control( demux_t *, int, va_list );
 
 static void Fix( demux_t * );
+static void BuildSeekIndex( demux_t * );
+static int  SearchSubtitle( const demux_sys_t *, int64_t );
 static char * get_language_from_filename( const char * );
 
 /*****************************************************************************
@@ -260,6 +265,7 @@ static int Open ( vlc_object_t *p_this )
     p_sys->i_subtitle         = 0;
     p_sys->i_subtitles        = 0;
     p_sys->subtitle           = NULL;
+    p_sys->pi_stop_max        = NULL;
     p_sys->i_microsecperframe = 40000;
 
     p_sys->jss.b_inited       = false;
@@ -563,6 +569,8 @@ static int Open ( vlc_object_t *p_this )
     else
         es_format_Init( &fmt, SPU_ES, VLC_CODEC_SUBT );
 
+    BuildSeekIndex( p_demux );
+
     /* Stupid language detection in the filename */
     char * psz_language = get_language_from_filename( p_demux->psz_file );
 
@@ -603,6 +611,7 @@ static void Close( vlc_object_t *p_this )
     for( i = 0; i < p_sys->i_subtitles; i++ )
         free( p_sys->subtitle[i].psz_text );
     free( p_sys->subtitle );
+    free( p_sys->pi_stop_max );
     free( p_sys->psz_header );
 
     free( p_sys );
@@ -639,17 +648,22 @@ static int Control( demux_t *p_demux, int i_query, va_list args )
 
         case DEMUX_SET_TIME:
             i64 = (int64_t)va_arg( args, int64_t );
-            p_sys->i_subtitle = 0;
-            while( p_sys->i_subtitle < p_sys->i_subtitles )
+            if( p_sys->pi_stop_max != NULL )
+                p_sys->i_subtitle = SearchSubtitle( p_sys, i64 );
+            else
             {
-                const subtitle_t *p_subtitle = &p_sys->subtitle[p_sys->i_subtitle];
+                p_sys->i_subtitle = 0;
+                while( p_sys->i_subtitle < p_sys->i_subtitles )
+                {
+                    const subtitle_t *p_subtitle = &p_sys->subtitle[p_sys->i_subtitle];
 
-                if( p_subtitle->i_start > i64 )
-                    break;
-                if( p_subtitle->i_stop > p_subtitle->i_start && p_subtitle->i_stop > i64 )
-                    break;
+                    if( p_subtitle->i_start > i64 )
+                        break;
+                    if( p_subtitle->i_stop > p_subtitle->i_start && p_subtitle->i_stop > i64 )
+                        break;
 
-                p_sys->i_subtitle++;
+                    p_sys->i_subtitle++;
+                }
             }
 
             if( p_sys->i_subtitle >= p_sys->i_subtitles )
@@ -677,11 +691,19 @@ static int Control( demux_t *p_demux, int i_query, va_list args )
             f = (double)va_arg( args, double );
             i64 = f * p_sys->i_length;
 
-            p_sys->i_subtitle = 0;
-            while( p_sys->i_subtitle < p_sys->i_subtitles &&
-                   p_sys->subtitle[p_sys->i_subtitle].i_start < i64 )
+            /* First subtitle starting at the requested date, by binary
+             * search; BuildSeekIndex() sorted the array */
             {
-                p_sys->i_subtitle++;
+                int i_low = 0, i_high = p_sys->i_subtitles;
+                while( i_low < i_high )
+                {
+                    const int i_mid = i_low + (i_high - i_low) / 2;
+                    if( p_sys->subtitle[i_mid].i_start < i64 )
+                        i_low = i_mid + 1;
+                    else
+                        i_high = i_mid;
+                }
+                p_sys->i_subtitle = i_low;
             }
             if( p_sys->i_subtitle >= p_sys->i_subtitles )
                 return VLC_EGENERIC;
@@ -781,19 +803,84 @@ static void Fix( demux_t *p_demux )
     qsort( p_sys->subtitle, p_sys->i_subtitles, sizeof( p_sys->subtitle[0] ), subtitle_cmp);
 }
 
-static int TextLoad( text_t *txt, stream_t *s )
+/*****************************************************************************
+ * BuildSeekIndex: sort the subtitles and index the stop times
+ *****************************************************************************/
+static void BuildSeekIndex( demux_t *p_demux )
 {
-    int   i_line_max;
+    demux_sys_t *p_sys = p_demux->p_sys;
 
-    /* init txt */
-    i_line_max          = 500;
-    txt->i_line_count   = 0;
-    txt->i_line         = 0;
-    txt->line           = calloc( i_line_max, sizeof( char * ) );
+    /* Most formats are already ordered; keep their original order for
+     * identical start times in that case */
+    for( int i = 1; i < p_sys->i_subtitles; i++ )
+        if( subtitle_cmp( &p_sys->subtitle[i-1], &p_sys->subtitle[i] ) > 0 )
+        {
+            Fix( p_demux );
+            break;
+        }
+
+    p_sys->pi_stop_max = malloc( p_sys->i_subtitles * sizeof( int64_t ) );
+    if( p_sys->pi_stop_max == NULL )
+        return; /* Seeking falls back on the linear scan */
+
+    /* Running maximum of the stop times: a subtitle may still be displayed
+     * at a given date even though later ones already ended */
+    int64_t i_max = INT64_MIN;
+    for( int i = 0; i < p_sys->i_subtitles; i++ )
+    {
+        const subtitle_t *p_subtitle = &p_sys->subtitle[i];
+
+        if( p_subtitle->i_stop > p_subtitle->i_start &&
+            p_subtitle->i_stop > i_max )
+            i_max = p_subtitle->i_stop;
+        p_sys->pi_stop_max[i] = i_max;
+    }
+}
+
+/*****************************************************************************
+ * SearchSubtitle: first subtitle to send for a given date
+ *****************************************************************************
+ * Binary-search equivalent of the linear scan: the first subtitle either
+ * starting after the date, or still displayed at it.
+ *****************************************************************************/
+static int SearchSubtitle( const demux_sys_t *p_sys, int64_t i_date )
+{
+    int i_low = 0, i_high = p_sys->i_subtitles;
+
+    /* First subtitle starting after the date */
+    while( i_low < i_high )
+    {
+        const int i_mid = i_low + (i_high - i_low) / 2;
+        if( p_sys->subtitle[i_mid].i_start > i_date )
+            i_high = i_mid;
+        else
+            i_low = i_mid + 1;
+    }
+
+    /* First subtitle still displayed at the date, if any comes earlier */
+    i_high = i_low;
+    i_low = 0;
+    while( i_low < i_high )
+    {
+        const int i_mid = i_low + (i_high - i_low) / 2;
+        if( p_sys->pi_stop_max[i_mid] > i_date )
+            i_high = i_mid;
+        else
+            i_low = i_mid + 1;
+    }
+
+    return i_low;
+}
+
+/* Per-line loader, for character sets stream_ReadLine() converts for us */
+static int TextLoadLines( text_t *txt, stream_t *s )
+{
+    int i_line_max = 500;
+
+    txt->line = calloc( i_line_max, sizeof( char * ) );
     if( !txt->line )
         return VLC_ENOMEM;
 
-    /* load the complete file */
     for( ;; )
     {
         char *psz = stream_ReadLine( s );
@@ -804,7 +891,7 @@ static int TextLoad( text_t *txt, stream_t *s )
         txt->line[txt->i_line_count++] = psz;
         if( txt->i_line_count >= i_line_max )
         {
-            i_line_max += 100;
+            i_line_max *= 2;
             txt->line = realloc_or_free( txt->line, i_line_max * sizeof( char * ) );
             if( !txt->line )
                 return VLC_ENOMEM;
@@ -814,20 +901,110 @@ static int TextLoad( text_t *txt, stream_t *s )
     if( txt->i_line_count <= 0 )
     {
         free( txt->line );
+        txt->line = NULL;
         return VLC_EGENERIC;
     }
 
     return VLC_SUCCESS;
 }
-static void TextUnload( text_t *txt )
+
+static int TextLoad( text_t *txt, stream_t *s )
 {
-    int i;
+    const uint8_t *p_peek;
+
+    /* init txt */
+    txt->i_line_count   = 0;
+    txt->i_line         = 0;
+    txt->line           = NULL;
+    txt->p_buffer       = NULL;
+
+    /* An UTF-16 or UTF-32 file needs the conversion done by
+     * stream_ReadLine(), so load it the slow way */
+    if( stream_Peek( s, &p_peek, 2 ) < 2
+     || !memcmp( p_peek, "\xFF\xFE", 2 ) || !memcmp( p_peek, "\xFE\xFF", 2 ) )
+        return TextLoadLines( txt, s );
+
+    /* Slurp the whole file at once and split it in place: one allocation
+     * for the text instead of one per line */
+    uint64_t i_alloc = 65536;
+    int64_t i_ssize = stream_Size( s );
+    if( i_ssize > 0 && (uint64_t)i_ssize > stream_Tell( s ) )
+        i_alloc = i_ssize - stream_Tell( s );
+
+    char *p_buffer = malloc( i_alloc + 1 );
+    if( !p_buffer )
+        return VLC_ENOMEM;
+
+    size_t i_len = 0;
+    for( ;; )
+    {
+        if( i_len == i_alloc )
+        {
+            i_alloc *= 2;
+            p_buffer = realloc_or_free( p_buffer, i_alloc + 1 );
+            if( !p_buffer )
+                return VLC_ENOMEM;
+        }
+        int i_read = stream_Read( s, p_buffer + i_len, i_alloc - i_len );
+        if( i_read <= 0 )
+            break;
+        i_len += i_read;
+    }
+
+    if( i_len == 0 )
+    {
+        free( p_buffer );
+        return VLC_EGENERIC;
+    }
+    p_buffer[i_len] = '\0';
 
-    for( i = 0; i < txt->i_line_count; i++ )
+    int i_lines = 0;
+    for( size_t i = 0; i < i_len; i++ )
+        if( p_buffer[i] == '\n' )
+            i_lines++;
+    if( p_buffer[i_len - 1] != '\n' )
+        i_lines++;
+
+    txt->line = calloc( i_lines, sizeof( char * ) );
+    if( !txt->line )
     {
-        free( txt->line[i] );
+        free( p_buffer );
+        return VLC_ENOMEM;
     }
+    txt->p_buffer = p_buffer;
+
+    char *p = p_buffer;
+    while( p < p_buffer + i_len )
+    {
+        char *p_nl = memchr( p, '\n', p_buffer + i_len - p );
+
+        txt->line[txt->i_line_count++] = p;
+        if( p_nl == NULL )
+        {   /* Last line, without a newline; strip a stray carriage return */
+            if( p_buffer[i_len - 1] == '\r' )
+                p_buffer[i_len - 1] = '\0';
+            break;
+        }
+        if( p_nl > p && p_nl[-1] == '\r' )
+            p_nl[-1] = '\0';
+        *p_nl = '\0';
+        p = p_nl + 1;
+    }
+    assert( txt->i_line_count <= i_lines );
+
+    return VLC_SUCCESS;
+}
+
+static void TextUnload( text_t *txt )
+{
+    if( txt->p_buffer != NULL )
+        free( txt->p_buffer );
+    else
+        for( int i = 0; i < txt->i_line_count; i++ )
+            free( txt->line[i] );
     free( txt->line );
+    txt->p_buffer     = NULL;
+    txt->line         = NULL;
     txt->i_line       = 0;
     txt->i_line_count = 0;
 }
@@ -59,6 +59,7 @@ struct demux_sys_t
     xml_t*          p_xml;
     xml_reader_t*   p_reader;
     subtitle_t*     subtitle;
+    char*           p_cue_arena; /* Cue texts, when the fast path was taken */
     es_out_id_t*    p_es;
     int64_t         i_length;
     int64_t         i_next_demux_time;
@@ -458,6 +459,339 @@ static void ParseHead( demux_t* p_demux )
     }
 }
 
+/*****************************************************************************
+ * Fast path: scan the slurped document in place
+ *****************************************************************************
+ * Live TTML caption streams spend more CPU in the generic XML reader than
+ * in rendering, and the cues are re-serialized XML anyway. So scan the raw
+ * document with memchr() and copy the <p> elements out into one
+ * arena, and fall back on the XML reader whenever the document contains
+ * anything the scanner does not handle.
+ *****************************************************************************/
+
+struct cue_arena
+{
+    char   *p_data;
+    size_t  i_len;
+    size_t  i_size;
+};
+
+static bool ArenaAppend( struct cue_arena* p_arena, const char* p, size_t i_len )
+{
+    if ( p_arena->i_len + i_len > p_arena->i_size )
+    {
+        size_t i_size = __MAX( p_arena->i_size * 2, p_arena->i_len + i_len );
+        char* p_data = realloc( p_arena->p_data, i_size );
+        if ( unlikely( p_data == NULL ) )
+            return false;
+        p_arena->p_data = p_data;
+        p_arena->i_size = i_size;
+    }
+    memcpy( p_arena->p_data + p_arena->i_len, p, i_len );
+    p_arena->i_len += i_len;
+    return true;
+}
+
+/* Bounded substring search, letting memchr() do the scanning */
+static const char* FindStr( const char* p, const char* p_end,
+                            const char* psz_needle )
+{
+    const size_t i_needle = strlen( psz_needle );
+
+    while ( (size_t)( p_end - p ) >= i_needle )
+    {
+        p = memchr( p, psz_needle[0], p_end - p - ( i_needle - 1 ) );
+        if ( p == NULL )
+            return NULL;
+        if ( !memcmp( p, psz_needle, i_needle ) )
+            return p;
+        p++;
+    }
+    return NULL;
+}
+
+/* Skip past the '>' ending a tag, ignoring quoted attribute values */
+static const char* SkipTag( const char* p, const char* p_end )
+{
+    char c_quote = 0;
+    for ( ; p < p_end; p++ )
+    {
+        if ( c_quote == 0 && ( *p == '"' || *p == '\'' ) )
+            c_quote = *p;
+        else if ( c_quote != 0 && *p == c_quote )
+            c_quote = 0;
+        else if ( c_quote == 0 && *p == '>' )
+            return p + 1;
+    }
+    return NULL;
+}
+
+/* Find the close tag of an element that cannot nest, skipping comments */
+static const char* FindCloseTag( const char* p, const char* p_end,
+                                 const char* p_name, size_t i_name )
+{
+    while ( ( p = memchr( p, '<', p_end - p ) ) != NULL )
+    {
+        if ( (size_t)( p_end - p ) >= 4 && !memcmp( p, "<!--", 4 ) )
+        {
+            p = FindStr( p + 4, p_end, "-->" );
+            if ( p == NULL )
+                return NULL;
+            p += 3;
+            continue;
+        }
+        if ( (size_t)( p_end - p ) > i_name + 2
+          && p[1] == '/' && !memcmp( p + 2, p_name, i_name )
+          && p[2 + i_name] == '>' )
+            return p;
+        p++;
+    }
+    return NULL;
+}
+
+static int ScanTTML( demux_t* p_demux, const char* p_data, size_t i_data )
+{
+    demux_sys_t* p_sys = p_demux->p_sys;
+    struct cue_arena arena = { NULL, 0, 0 };
+    size_t* pi_offset = NULL;
+    int i_max_sub = 0;
+    const char* p = p_data;
+    const char* p_end = p_data + i_data;
+
+    if ( memchr( p_data, '\0', i_data ) != NULL )
+        goto fallback; /* Not a plain text document */
+
+    while ( ( p = memchr( p, '<', p_end - p ) ) != NULL )
+    {
+        if ( (size_t)( p_end - p ) >= 4 && !memcmp( p, "<!--", 4 ) )
+        {
+            p = FindStr( p + 4, p_end, "-->" );
+            if ( p == NULL )
+                goto fallback;
+            p += 3;
+            continue;
+        }
+        if ( (size_t)( p_end - p ) >= 9 && !memcmp( p, "<![CDATA[", 9 ) )
+        {
+            p = FindStr( p + 9, p_end, "]]>" );
+            if ( p == NULL )
+                goto fallback;
+            p += 3;
+            continue;
+        }
+        if ( p + 1 >= p_end )
+            goto fallback;
+        if ( p[1] == '?' || p[1] == '!' || p[1] == '/' )
+        {
+            p = SkipTag( p + 1, p_end );
+            if ( p == NULL )
+                goto fallback;
+            continue;
+        }
+
+        /* A start tag */
+        const char* p_name = p + 1;
+        const char* p_name_end = p_name;
+        while ( p_name_end < p_end && !strchr( " \t\r\n/>", *p_name_end ) )
+            p_name_end++;
+        const size_t i_name = p_name_end - p_name;
+        if ( i_name == 0 )
+            goto fallback;
+
+        const bool b_p = ( i_name == 1 && p_name[0] == 'p' ) ||
+                         ( i_name == 4 && !memcmp( p_name, "tt:p", 4 ) );
+        const bool b_head = ( i_name == 4 && !memcmp( p_name, "head", 4 ) ) ||
+                            ( i_name == 7 && !memcmp( p_name, "tt:head", 7 ) );
+
+        if ( b_head && !p_sys->b_has_head )
+        {
+            /* Keep the whole element verbatim as the decoder extra data */
+            char psz_close[16];
+            int i_close = snprintf( psz_close, sizeof( psz_close ), "</%.*s>",
+                                    (int)i_name, p_name );
+            const char* p_close = FindStr( p, p_end, psz_close );
+            if ( p_close == NULL )
+                goto fallback;
+            p_close += i_close;
+            p_sys->i_head_len = p_close - p;
+            p_sys->psz_head = malloc( p_sys->i_head_len );
+            if ( unlikely( p_sys->psz_head == NULL ) )
+                goto fallback;
+            memcpy( p_sys->psz_head, p, p_sys->i_head_len );
+            p_sys->b_has_head = true;
+            p = p_close;
+            continue;
+        }
+        if ( !b_p )
+        {
+            p = SkipTag( p_name_end, p_end );
+            if ( p == NULL )
+                goto fallback;
+            continue;
+        }
+
+        /* A cue. Re-serialize it like ReadTTML() does: the original tag
+         * minus the begin/end attributes, the raw body, then "</p>" */
+        int64_t i_start = -1, i_stop = -1;
+        bool b_begin = false, b_end = false;
+        bool b_selfclosing = false;
+        const size_t i_cue = arena.i_len;
+        bool b_ok = ArenaAppend( &arena, p, 1 + i_name );
+        const char* p_attr = p_name_end;
+
+        for ( ;; )
+        {
+            while ( p_attr < p_end && strchr( " \t\r\n", *p_attr ) )
+                p_attr++;
+            if ( p_attr >= p_end )
+                goto fallback;
+            if ( *p_attr == '>' )
+            {
+                p_attr++;
+                break;
+            }
+            if ( *p_attr == '/' )
+            {
+                if ( p_attr + 1 >= p_end || p_attr[1] != '>' )
+                    goto fallback;
+                b_selfclosing = true;
+                p_attr += 2;
+                break;
+            }
+
+            const char* p_a = p_attr;
+            while ( p_attr < p_end && !strchr( " \t\r\n=", *p_attr ) )
+                p_attr++;
+            const size_t i_a = p_attr - p_a;
+            while ( p_attr < p_end && strchr( " \t\r\n", *p_attr ) )
+                p_attr++;
+            if ( p_attr >= p_end || *p_attr != '=' )
+                goto fallback;
+            p_attr++;
+            while ( p_attr < p_end && strchr( " \t\r\n", *p_attr ) )
+                p_attr++;
+            if ( p_attr >= p_end || ( *p_attr != '"' && *p_attr != '\'' ) )
+                goto fallback;
+            const char c_quote = *p_attr++;
+            const char* p_v = p_attr;
+            p_attr = memchr( p_attr, c_quote, p_end - p_attr );
+            if ( p_attr == NULL )
+                goto fallback;
+            const char* p_v_end = p_attr++;
+
+            if ( ( !b_begin && i_a == 5 && !strncasecmp( p_a, "begin", 5 ) ) ||
+                 ( !b_end && i_a == 3 && !strncasecmp( p_a, "end", 3 ) ) )
+            {
+                char buf[32];
+                size_t i_v = __MIN( (size_t)( p_v_end - p_v ),
+                                    sizeof( buf ) - 1 );
+                memcpy( buf, p_v, i_v );
+                buf[i_v] = '\0';
+                if ( i_a == 5 )
+                    b_begin = ( Convert_time( &i_start, buf ) == VLC_SUCCESS );
+                else
+                    b_end = ( Convert_time( &i_stop, buf ) == VLC_SUCCESS );
+            }
+            else
+                b_ok = b_ok && ArenaAppend( &arena, " ", 1 )
+                            && ArenaAppend( &arena, p_a, p_attr - p_a );
+        }
+
+        b_ok = b_ok && ArenaAppend( &arena, ">", 1 );
+        if ( !b_selfclosing )
+        {
+            const char* p_close = FindCloseTag( p_attr, p_end, p_name, i_name );
+            if ( p_close == NULL )
+                goto fallback;
+            b_ok = b_ok && ArenaAppend( &arena, p_attr, p_close - p_attr );
+            p_attr = p_close + 2 + i_name + 1;
+        }
+        b_ok = b_ok && ArenaAppend( &arena, "</p>", 5 /* with the NUL */ );
+        if ( !b_ok )
+            goto fallback;
+
+        if ( b_begin && b_end )
+        {
+            if ( p_sys->i_subtitles >= i_max_sub )
+            {
+                i_max_sub += 500;
+                p_sys->subtitle = realloc_or_free( p_sys->subtitle,
+                        sizeof( *p_sys->subtitle ) * i_max_sub );
+                if ( unlikely( p_sys->subtitle == NULL ) )
+                    goto fallback;
+                pi_offset = realloc_or_free( pi_offset,
+                        sizeof( *pi_offset ) * i_max_sub );
+                if ( unlikely( pi_offset == NULL ) )
+                    goto fallback;
+            }
+            p_sys->subtitle[p_sys->i_subtitles].i_start = i_start;
+            p_sys->subtitle[p_sys->i_subtitles].i_stop = i_stop;
+            p_sys->subtitle[p_sys->i_subtitles].psz_text = NULL;
+            pi_offset[p_sys->i_subtitles] = i_cue;
+            p_sys->i_subtitles++;
+        }
+        else
+            arena.i_len = i_cue; /* Not a timed cue, discard */
+        p = p_attr;
+    }
+
+    for ( int i = 0; i < p_sys->i_subtitles; ++i )
+        p_sys->subtitle[i].psz_text = arena.p_data + pi_offset[i];
+    p_sys->p_cue_arena = arena.p_data;
+    free( pi_offset );
+    return VLC_SUCCESS;
+
+fallback:
+    free( arena.p_data );
+    free( pi_offset );
+    free( p_sys->subtitle );
+    p_sys->subtitle = NULL;
+    p_sys->i_subtitles = 0;
+    free( p_sys->psz_head );
+    p_sys->psz_head = NULL;
+    p_sys->i_head_len = 0;
+    p_sys->b_has_head = false;
+    return VLC_EGENERIC;
+}
+
+static int FastLoadTTML( demux_t* p_demux )
+{
+    size_t i_alloc = 65536;
+    int64_t i_ssize = stream_Size( p_demux->s );
+    if ( i_ssize > 0 )
+        i_alloc = i_ssize;
+
+    char* p_data = malloc( i_alloc );
+    if ( unlikely( p_data == NULL ) )
+        return VLC_EGENERIC;
+
+    size_t i_data = 0;
+    for ( ;; )
+    {
+        if ( i_data == i_alloc )
+        {
+            i_alloc *= 2;
+            char* p = realloc( p_data, i_alloc );
+            if ( unlikely( p == NULL ) )
+            {
+                free( p_data );
+                return VLC_EGENERIC;
+            }
+            p_data = p;
+        }
+        ssize_t i_read = stream_Read( p_demux->s, p_data + i_data,
+                                      i_alloc - i_data );
+        if ( i_read <= 0 )
+            break;
+        i_data += i_read;
+    }
+
+    int i_ret = i_data > 0 ? ScanTTML( p_demux, p_data, i_data )
+                           : VLC_EGENERIC;
+    free( p_data );
+    return i_ret;
+}
+
 static int Open( vlc_object_t* p_this )
 {
     demux_t     *p_demux = (demux_t*)p_this;
@@ -509,21 +843,34 @@ static int Open( vlc_object_t* p_this )
         return VLC_EGENERIC;
     }
 
-    p_sys->p_reader = xml_ReaderReset( p_sys->p_reader, p_demux->s );
-    stream_Delete( p_probestream );
-    if ( !p_sys->p_reader )
+    if ( FastLoadTTML( p_demux ) == VLC_SUCCESS )
     {
-        Close( p_demux );
-        return VLC_EGENERIC;
+        /* The whole document was parsed without the XML reader */
+        xml_ReaderDelete( p_sys->p_reader );
+        p_sys->p_reader = NULL;
+        xml_Delete( p_sys->p_xml );
+        p_sys->p_xml = NULL;
+        stream_Delete( p_probestream );
     }
-
-    if ( ReadTTML( p_demux ) != VLC_SUCCESS )
+    else
     {
-        Close( p_demux );
-        return VLC_EGENERIC;
+        stream_Seek( p_demux->s, 0 );
+        p_sys->p_reader = xml_ReaderReset( p_sys->p_reader, p_demux->s );
+        stream_Delete( p_probestream );
+        if ( !p_sys->p_reader )
+        {
+            Close( p_demux );
+            return VLC_EGENERIC;
+        }
+
+        if ( ReadTTML( p_demux ) != VLC_SUCCESS )
+        {
+            Close( p_demux );
+            return VLC_EGENERIC;
+        }
+        if ( p_sys->b_has_head )
+            ParseHead( p_demux );
     }
-    if ( p_sys->b_has_head )
-        ParseHead( p_demux );
 
     p_demux->pf_demux = Demux;
     p_demux->pf_control = Control;
@@ -555,10 +902,11 @@ static void Close( demux_t* p_demux )
         xml_ReaderDelete( p_sys->p_reader );
     if ( p_sys->p_xml )
         xml_Delete( p_sys->p_xml );
-    for ( int i = 0; i < p_sys->i_subtitles; ++i )
-    {
-        free( p_sys->subtitle[i].psz_text );
-    }
+    if ( p_sys->p_cue_arena != NULL )
+        free( p_sys->p_cue_arena );
+    else
+        for ( int i = 0; i < p_sys->i_subtitles; ++i )
+            free( p_sys->subtitle[i].psz_text );
     free( p_sys->subtitle );
     free( p_sys );
 }
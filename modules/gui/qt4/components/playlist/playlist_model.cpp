@@ -56,6 +56,10 @@ PLModel::PLModel( playlist_t *_p_playlist,  /* THEPL */
     rootItem          = NULL; /* PLItem rootItem, will be set in rebuild( ) */
     latestSearch      = QString();
 
+    eventTimer.setSingleShot( true );
+    eventTimer.setInterval( 100 );
+    CONNECT( &eventTimer, timeout(), this, flushPendingEvents() );
+
     rebuild( p_root );
     DCONNECT( THEMIM->getIM(), metaChanged( input_item_t *),
               this, processInputItemUpdate( input_item_t *) );
@@ -598,10 +602,55 @@ void PLModel::processInputItemUpdate( input_item_t *p_item )
 void PLModel::processItemRemoval( int i_pl_itemid )
 {
     if( i_pl_itemid <= 0 ) return;
-    removeItem( findByPLId( rootItem, i_pl_itemid ) );
+    PLEvent ev = { i_pl_itemid, -1 };
+    pendingEvents.append( ev );
+    if( !eventTimer.isActive() )
+        eventTimer.start();
 }
 
 void PLModel::processItemAppend( int i_pl_itemid, int i_pl_itemidparent )
+{
+    PLEvent ev = { i_pl_itemid, i_pl_itemidparent };
+    pendingEvents.append( ev );
+    if( !eventTimer.isActive() )
+        eventTimer.start();
+}
+
+/* Above this many queued events, one model reset is cheaper than replaying
+ * the events one row at a time through the views */
+#define PL_EVENT_REBUILD_THRESHOLD 100
+
+void PLModel::flushPendingEvents()
+{
+    if( pendingEvents.isEmpty() ) return;
+
+    if( pendingEvents.count() > PL_EVENT_REBUILD_THRESHOLD )
+    {
+        pendingEvents.clear();
+        rebuild();
+    }
+    else
+    {
+        foreach( const PLEvent &ev, pendingEvents )
+        {
+            if( ev.i_parent == -1 )
+                doProcessItemRemoval( ev.i_id );
+            else
+                doProcessItemAppend( ev.i_id, ev.i_parent );
+        }
+        pendingEvents.clear();
+    }
+
+    if( latestSearch.isEmpty() ) return;
+    filter( latestSearch, index( rootItem, 0), false /*FIXME*/ );
+}
+
+void PLModel::doProcessItemRemoval( int i_pl_itemid )
+{
+    removeItem( findByPLId( rootItem, i_pl_itemid ) );
+}
+
+void PLModel::doProcessItemAppend( int i_pl_itemid, int i_pl_itemidparent )
 {
     playlist_item_t *p_item = NULL;
     PLItem *newItem = NULL;
@@ -635,9 +684,6 @@ void PLModel::processItemAppend( int i_pl_itemid, int i_pl_itemidparent )
     endInsertRows();
     if ( newItem->inputItem() == THEMIM->currentInputItem() )
         emit currentIndexChanged( index( newItem, 0 ) );
-
-    if( latestSearch.isEmpty() ) return;
-    filter( latestSearch, index( rootItem, 0), false /*FIXME*/ );
 }
 
 void PLModel::rebuild( playlist_item_t *p_root )
@@ -42,6 +42,7 @@
 #include <QVariant>
 #include <QModelIndex>
 #include <QAction>
+#include <QTimer>
 
 class PLItem;
 class PlMimeData;
@@ -152,6 +153,18 @@ private:
     };
     pl_nodetype getPLRootType() const;
 
+    /* Coalesced core playlist events, flushed in batch so that mass
+     * imports do not trigger one view update per item */
+    struct PLEvent
+    {
+        int i_id;
+        int i_parent; /* -1 for a removal */
+    };
+    QList<PLEvent> pendingEvents;
+    QTimer eventTimer;
+    void doProcessItemRemoval( int i_pl_itemid );
+    void doProcessItemAppend( int i_pl_itemid, int i_pl_itemidparent );
+
     /* */
     QString latestSearch;
     QFont   customFont;
@@ -161,6 +174,7 @@ private slots:
     void processInputItemUpdate();
     void processItemRemoval( int i_pl_itemid );
     void processItemAppend( int i_pl_itemid, int i_pl_itemidparent );
+    void flushPendingEvents();
     void activateItem( playlist_item_t *p_item );
     virtual void activateItem( const QModelIndex &index ) Q_DECL_OVERRIDE;
 };
@@ -42,6 +42,8 @@ struct filter_sys_t
     VdpVideoMixer mixer;
     VdpChromaType chroma;
     VdpYCbCrFormat format;
+    vlc_vdp_video_pool_t *pool; /* imported surfaces recycling (or NULL) */
+    unsigned readbacks; /* forced surface exports to system memory */
 
     struct
     {
@@ -328,14 +330,11 @@ static picture_t *VideoImport(filter_t *filter, picture_t *src)
     VdpVideoSurface surface;
     VdpStatus err;
 
-    if (sys->vdp == NULL)
+    if (sys->vdp == NULL || sys->pool == NULL)
         goto drop;
 
-    /* Create surface (TODO: reuse?) */
-    err = vdp_video_surface_create(sys->vdp, sys->device, sys->chroma,
-                                   filter->fmt_in.video.i_width,
-                                   filter->fmt_in.video.i_visible_height,
-                                   &surface);
+    /* Get a surface, reusing a recycled one whenever possible */
+    err = vlc_vdp_video_pool_Get(sys->pool, &surface);
     if (err != VDP_STATUS_OK)
     {
         msg_Err(filter, "video %s %s failure: %s", "surface", "creation",
@@ -404,7 +403,7 @@ static picture_t *VideoImport(filter_t *filter, picture_t *src)
     picture_CopyProperties(dst, src);
     picture_Release(src);
 
-    err = vlc_vdp_video_attach(sys->vdp, surface, dst);
+    err = vlc_vdp_video_pool_Attach(sys->pool, surface, dst);
     if (unlikely(err != VDP_STATUS_OK))
     {
         picture_Release(dst);
@@ -447,6 +446,7 @@ static picture_t *Render(filter_t *filter, picture_t *src, bool import)
         picture_t *pic = picture_NewFromFormat(&fmt);
         if (likely(pic != NULL))
         {
+            sys->readbacks++;
             pic = VideoExport(filter, src, pic);
             if (pic != NULL)
                 src = VideoImport(filter, pic);
@@ -748,6 +748,21 @@ static int OutputOpen(vlc_object_t *obj)
         goto error;
     }
 
+    /* Surfaces cycle through the import path and the mixer history, so a
+     * pool barely larger than the history keeps the driver allocation-free
+     * in the steady state. */
+    sys->pool = vlc_vdp_video_pool_Create(sys->vdp, sys->device, sys->chroma,
+                                          filter->fmt_in.video.i_width,
+                                          filter->fmt_in.video.i_visible_height,
+                                          MAX_PAST + 1 + MAX_FUTURE + 2);
+    if (unlikely(sys->pool == NULL))
+    {
+        vdp_video_mixer_destroy(sys->vdp, sys->mixer);
+        vdp_release_x11(sys->vdp);
+        goto error;
+    }
+    sys->readbacks = 0;
+
     /* NOTE: The video mixer capabilities should be checked here, and the
      * then video mixer set up. But:
      * 1) The VDPAU back-end is accessible only once the first picture
@@ -777,6 +792,10 @@ static void OutputClose(vlc_object_t *obj)
     filter_sys_t *sys = filter->p_sys;
 
     Flush(filter);
+    if (sys->readbacks > 0)
+        msg_Warn(obj, "%u video surfaces were read back to system memory",
+                 sys->readbacks);
+    vlc_vdp_video_pool_Release(sys->pool);
     vdp_video_mixer_destroy(sys->vdp, sys->mixer);
     vdp_release_x11(sys->vdp);
     free(sys);
@@ -32,6 +32,8 @@
 
 #pragma GCC visibility push(default)
 
+static void PoolRecycle(vlc_vdp_video_pool_t *pool, VdpVideoSurface surface);
+
 static void SurfaceDestroy(void *opaque)
 {
     vlc_vdp_video_field_t *field = opaque;
@@ -44,6 +46,14 @@ static void SurfaceDestroy(void *opaque)
     if (atomic_fetch_sub(&frame->refs, 1) != 1)
         return;
 
+    if (frame->pool != NULL)
+    {   /* Return frame (video surface) to its pool */
+        PoolRecycle(frame->pool, frame->surface);
+        vdp_release_x11(frame->vdp);
+        free(frame);
+        return;
+    }
+
     /* Destroy frame (video surface) */
     err = vdp_video_surface_destroy(frame->vdp, frame->surface);
     if (err != VDP_STATUS_OK)
@@ -84,6 +94,7 @@ vlc_vdp_video_field_t *vlc_vdp_video_create(vdp_t *vdp,
 
     atomic_init(&frame->refs, 1);
     frame->surface = surface;
+    frame->pool = NULL;
     frame->vdp = vdp_hold_x11(vdp, &frame->device);
     return field;
 }
@@ -120,3 +131,103 @@ vlc_vdp_video_field_t *vlc_vdp_video_copy(vlc_vdp_video_field_t *fold)
     atomic_fetch_add(&frame->refs, 1);
     return fnew;
 }
+
+struct vlc_vdp_video_pool
+{
+    vdp_t *vdp;
+    VdpDevice device;
+    VdpChromaType chroma;
+    uint32_t width;
+    uint32_t height;
+
+    vlc_mutex_t lock;
+    atomic_uintptr_t refs;
+    unsigned capacity;
+    unsigned count; /* number of idle surfaces below */
+    VdpVideoSurface surfaces[];
+};
+
+static void PoolUnref(vlc_vdp_video_pool_t *pool)
+{
+    if (atomic_fetch_sub(&pool->refs, 1) != 1)
+        return;
+
+    for (unsigned i = 0; i < pool->count; i++)
+        vdp_video_surface_destroy(pool->vdp, pool->surfaces[i]);
+    vlc_mutex_destroy(&pool->lock);
+    vdp_release_x11(pool->vdp);
+    free(pool);
+}
+
+static void PoolRecycle(vlc_vdp_video_pool_t *pool, VdpVideoSurface surface)
+{
+    bool idle = false;
+
+    vlc_mutex_lock(&pool->lock);
+    if (pool->count < pool->capacity)
+    {
+        pool->surfaces[pool->count++] = surface;
+        idle = true;
+    }
+    vlc_mutex_unlock(&pool->lock);
+
+    if (!idle)
+        vdp_video_surface_destroy(pool->vdp, surface);
+    PoolUnref(pool);
+}
+
+vlc_vdp_video_pool_t *vlc_vdp_video_pool_Create(vdp_t *vdp, VdpDevice device,
+                                                VdpChromaType chroma,
+                                                uint32_t width, uint32_t height,
+                                                unsigned capacity)
+{
+    vlc_vdp_video_pool_t *pool = malloc(sizeof (*pool)
+                                + capacity * sizeof (pool->surfaces[0]));
+    if (unlikely(pool == NULL))
+        return NULL;
+
+    pool->vdp = vdp_hold_x11(vdp, NULL);
+    pool->device = device;
+    pool->chroma = chroma;
+    pool->width = width;
+    pool->height = height;
+    vlc_mutex_init(&pool->lock);
+    atomic_init(&pool->refs, 1);
+    pool->capacity = capacity;
+    pool->count = 0;
+    return pool;
+}
+
+void vlc_vdp_video_pool_Release(vlc_vdp_video_pool_t *pool)
+{
+    PoolUnref(pool);
+}
+
+VdpStatus vlc_vdp_video_pool_Get(vlc_vdp_video_pool_t *pool,
+                                 VdpVideoSurface *restrict surfacep)
+{
+    vlc_mutex_lock(&pool->lock);
+    if (pool->count > 0)
+    {
+        *surfacep = pool->surfaces[--pool->count];
+        vlc_mutex_unlock(&pool->lock);
+        return VDP_STATUS_OK;
+    }
+    vlc_mutex_unlock(&pool->lock);
+
+    return vdp_video_surface_create(pool->vdp, pool->device, pool->chroma,
+                                    pool->width, pool->height, surfacep);
+}
+
+VdpStatus vlc_vdp_video_pool_Attach(vlc_vdp_video_pool_t *pool,
+                                    VdpVideoSurface surface, picture_t *pic)
+{
+    VdpStatus err = vlc_vdp_video_attach(pool->vdp, surface, pic);
+    if (err != VDP_STATUS_OK)
+        return err;
+
+    vlc_vdp_video_field_t *field = pic->context;
+    atomic_fetch_add(&pool->refs, 1);
+    field->frame->pool = pool;
+    return VDP_STATUS_OK;
+}
@@ -262,11 +262,14 @@ struct picture_sys_t
     vdp_t *vdp;
 };
 
+struct vlc_vdp_video_pool;
+
 typedef struct vlc_vdp_video_frame
 {
     VdpVideoSurface surface;
     VdpDevice device;
     vdp_t *vdp;
+    struct vlc_vdp_video_pool *pool; /* NULL if the surface is not pooled */
     atomic_uintptr_t refs;
 } vlc_vdp_video_frame_t;
 
@@ -296,4 +299,41 @@ vlc_vdp_video_field_t *vlc_vdp_video_create(vdp_t *, VdpVideoSurface);
  * (the underlying VDPAU video surface is shared).
  */
 vlc_vdp_video_field_t *vlc_vdp_video_copy(vlc_vdp_video_field_t *);
+
+/**
+ * Pool of reusable VDPAU video surfaces of identical parameters.
+ * Surfaces attached through the pool return to it when their last
+ * reference goes away, instead of being destroyed, saving a driver
+ * surface allocation and destruction per frame.
+ */
+typedef struct vlc_vdp_video_pool vlc_vdp_video_pool_t;
+
+/**
+ * Creates a video surface pool. The pool keeps up to \p capacity idle
+ * surfaces of the given chroma type and dimensions ready for reuse.
+ */
+vlc_vdp_video_pool_t *vlc_vdp_video_pool_Create(vdp_t *, VdpDevice,
+                                                VdpChromaType,
+                                                uint32_t width, uint32_t height,
+                                                unsigned capacity);
+
+/**
+ * Releases a video surface pool. Surfaces still referenced elsewhere
+ * remain valid and are destroyed once their last reference goes away.
+ */
+void vlc_vdp_video_pool_Release(vlc_vdp_video_pool_t *);
+
+/**
+ * Gets an idle surface from the pool, creating one if none is available.
+ */
+VdpStatus vlc_vdp_video_pool_Get(vlc_vdp_video_pool_t *,
+                                 VdpVideoSurface *restrict);
+
+/**
+ * Attaches a pooled VDPAU video surface as context of a VLC picture,
+ * like vlc_vdp_video_attach(). The surface returns to the pool when the
+ * last reference to it goes away.
+ */
+VdpStatus vlc_vdp_video_pool_Attach(vlc_vdp_video_pool_t *, VdpVideoSurface,
+                                    picture_t *);
 #endif
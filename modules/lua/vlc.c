@@ -835,17 +835,137 @@ int vlclua_add_modules_path( lua_State *L, const char *psz_filename )
     return 0;
 }
 
+/*****************************************************************************
+ * Precompiled script cache
+ *****************************************************************************
+ * Compiling a script is the expensive part of loading it, and the same
+ * scripts get compiled over and over (service discoveries are even loaded
+ * twice, once to probe and once to run). The bytecode of each successfully
+ * compiled script is kept in the user cache directory, keyed by a hash of
+ * the script path, and reused as long as it is newer than its source.
+ * Anything Lua refuses to load (truncated file, bytecode from another Lua
+ * version) just falls back to compiling the source again.
+ *****************************************************************************/
+static char *LuacCachePath( const char *psz_file )
+{
+    char *psz_dir = config_GetUserDir( VLC_CACHE_DIR );
+    if( psz_dir == NULL )
+        return NULL;
+
+    /* djb2 of the script path */
+    uint64_t i_hash = 5381;
+    for( const char *p = psz_file; *p; p++ )
+        i_hash = i_hash * 33 ^ (unsigned char)*p;
+
+    char *psz_cache;
+    if( asprintf( &psz_cache, "%s" DIR_SEP "luac" DIR_SEP "%016"PRIx64".luac",
+                  psz_dir, i_hash ) == -1 )
+        psz_cache = NULL;
+    else
+    {
+        psz_cache[strlen(psz_dir) + strlen(DIR_SEP "luac")] = '\0';
+        vlc_mkdir( psz_cache, 0700 );
+        psz_cache[strlen(psz_dir) + strlen(DIR_SEP "luac")] = DIR_SEP_CHAR;
+    }
+    free( psz_dir );
+    return psz_cache;
+}
+
+static int LuacLoadCached( lua_State *L, const char *psz_file,
+                           const char *psz_cache )
+{
+    struct stat src, luac;
+
+    if( vlc_stat( psz_file, &src ) || vlc_stat( psz_cache, &luac )
+     || luac.st_mtime <= src.st_mtime )
+        return 1;
+
+    FILE *f = vlc_fopen( psz_cache, "rb" );
+    if( f == NULL )
+        return 1;
+
+    int i_ret = 1;
+    char *p_buffer = malloc( luac.st_size );
+    if( p_buffer != NULL
+     && fread( p_buffer, 1, luac.st_size, f ) == (size_t)luac.st_size )
+    {
+        /* Keep the source path as the chunk name for error messages */
+        char *psz_name;
+        if( asprintf( &psz_name, "@%s", psz_file ) == -1 )
+            psz_name = NULL;
+        i_ret = luaL_loadbuffer( L, p_buffer, luac.st_size,
+                                 psz_name ? psz_name : psz_file );
+        if( i_ret )
+            lua_pop( L, 1 );
+        free( psz_name );
+    }
+    free( p_buffer );
+    fclose( f );
+    return i_ret;
+}
+
+static int LuacWriter( lua_State *L, const void *p, size_t i_size, void *opaque )
+{
+    (void) L;
+    return fwrite( p, 1, i_size, (FILE *)opaque ) != i_size;
+}
+
+/* Dump the function on top of the stack (left there) to the cache file */
+static void LuacStoreCached( lua_State *L, const char *psz_cache )
+{
+    char *psz_tmp;
+    if( asprintf( &psz_tmp, "%s.tmp", psz_cache ) == -1 )
+        return;
+
+    FILE *f = vlc_fopen( psz_tmp, "wb" );
+    if( f != NULL )
+    {
+#if LUA_VERSION_NUM >= 503
+        int i_ret = lua_dump( L, LuacWriter, f, 0 );
+#else
+        int i_ret = lua_dump( L, LuacWriter, f );
+#endif
+        if( fclose( f ) == 0 && i_ret == 0 )
+            vlc_rename( psz_tmp, psz_cache );
+        else
+            vlc_unlink( psz_tmp );
+    }
+    free( psz_tmp );
+}
+
+/* luaL_dofile, going through the bytecode cache */
+static int vlclua_dofile_cached( lua_State *L, const char *psz_file )
+{
+    char *psz_cache = LuacCachePath( psz_file );
+
+    if( psz_cache != NULL && LuacLoadCached( L, psz_file, psz_cache ) == 0 )
+    {
+        free( psz_cache );
+        return lua_pcall( L, 0, LUA_MULTRET, 0 );
+    }
+
+    int i_ret = luaL_loadfile( L, psz_file );
+    if( !i_ret )
+    {
+        if( psz_cache != NULL )
+            LuacStoreCached( L, psz_cache );
+        i_ret = lua_pcall( L, 0, LUA_MULTRET, 0 );
+    }
+    free( psz_cache );
+    return i_ret;
+}
+
 /** Replacement for luaL_dofile, using VLC's input capabilities */
 int vlclua_dofile( vlc_object_t *p_this, lua_State *L, const char *curi )
 {
     char *uri = ToLocaleDup( curi );
     if( !strstr( uri, "://" ) ) {
-        int ret = luaL_dofile( L, uri );
+        int ret = vlclua_dofile_cached( L, uri );
         free( uri );
         return ret;
     }
     if( !strncasecmp( uri, "file://", 7 ) ) {
-        int ret = luaL_dofile( L, uri + 7 );
+        int ret = vlclua_dofile_cached( L, uri + 7 );
         free( uri );
         return ret;
     }
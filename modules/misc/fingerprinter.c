@@ -53,12 +53,32 @@ struct fingerprinter_sys_t
     struct
     {
         vlc_array_t         *queue;
+        vlc_mutex_t         lock;
+        vlc_cond_t          wait;
+        int                 i_jobs; /* requests handed to a worker */
+        bool                b_exit;
     } processing;
+
+    /* Shared pacing gate for the lookup web service, see WebRequestThrottle */
+    struct
+    {
+        vlc_mutex_t         lock;
+        mtime_t             i_last;
+    } web;
+
+    vlc_thread_t            *p_workers;
+    unsigned                i_workers;
 };
 
 static int  Open            (vlc_object_t *);
 static void Close           (vlc_object_t *);
 static void *Run(void *);
+static void *Worker(void *);
+
+#define THREADS_TEXT N_("Concurrent fingerprintings")
+#define THREADS_LONGTEXT N_( \
+    "Number of tracks decoded and fingerprinted in parallel " \
+    "(0 = auto, based on the number of CPUs)." )
 
 /*****************************************************************************
  * Module descriptor
@@ -69,6 +89,8 @@ vlc_module_begin ()
     set_shortname(N_("acoustid"))
     set_description(N_("Track fingerprinter (based on Acoustid)"))
     set_capability("fingerprinter", 10)
+    add_integer( "fingerprint-threads", 0, THREADS_TEXT, THREADS_LONGTEXT,
+                 true )
     set_callbacks(Open, Close)
 vlc_module_end ()
 
@@ -89,9 +111,12 @@ static void QueueIncomingRequests( fingerprinter_sys_t *p_sys )
     vlc_mutex_lock( &p_sys->incoming.lock );
     int i = vlc_array_count( p_sys->incoming.queue );
     if ( i == 0 ) goto end;
+    vlc_mutex_lock( &p_sys->processing.lock );
     while( i )
         vlc_array_append( p_sys->processing.queue,
                           vlc_array_item_at_index( p_sys->incoming.queue, --i ) );
+    vlc_cond_broadcast( &p_sys->processing.wait );
+    vlc_mutex_unlock( &p_sys->processing.lock );
     vlc_array_clear( p_sys->incoming.queue );
 end:
     vlc_mutex_unlock(&p_sys->incoming.lock);
@@ -181,6 +206,24 @@ static void DoFingerprint( vlc_object_t *p_this, acoustid_fingerprint_t *fp,
         fp->i_duration = chroma_fingerprint.i_duration;
 }
 
+/* AcoustID asks clients to stay below 3 requests per second. The workers
+ * share this single pacing gate, so scaling the pool up speeds up decoding
+ * without multiplying the lookup rate. */
+#define ACOUSTID_MIN_INTERVAL (CLOCK_FREQ / 3)
+
+static void WebRequestThrottle( fingerprinter_sys_t *p_sys )
+{
+    vlc_mutex_lock( &p_sys->web.lock );
+    mtime_t now = mdate();
+    if ( p_sys->web.i_last + ACOUSTID_MIN_INTERVAL > now )
+    {
+        msleep( p_sys->web.i_last + ACOUSTID_MIN_INTERVAL - now );
+        now = mdate();
+    }
+    p_sys->web.i_last = now;
+    vlc_mutex_unlock( &p_sys->web.lock );
+}
+
 /*****************************************************************************
  * Open:
  *****************************************************************************/
@@ -198,6 +241,10 @@ static int Open(vlc_object_t *p_this)
     vlc_mutex_init( &p_sys->incoming.lock );
 
     p_sys->processing.queue = vlc_array_new();
+    vlc_mutex_init( &p_sys->processing.lock );
+    vlc_cond_init( &p_sys->processing.wait );
+
+    vlc_mutex_init( &p_sys->web.lock );
 
     p_sys->results.queue = vlc_array_new();
     vlc_mutex_init( &p_sys->results.lock );
@@ -206,7 +253,28 @@ static int Open(vlc_object_t *p_this)
     p_fingerprinter->pf_getresults = GetResult;
     p_fingerprinter->pf_apply = ApplyResult;
 
+    int i_workers = var_InheritInteger( p_fingerprinter, "fingerprint-threads" );
+    if ( i_workers <= 0 )
+        i_workers = __MIN( (int)vlc_GetCPUCount(), 4 );
+
+    p_sys->p_workers = malloc( i_workers * sizeof(*p_sys->p_workers) );
+    if ( !p_sys->p_workers )
+        goto error;
+
     var_Create( p_fingerprinter, "results-available", VLC_VAR_BOOL );
+    for ( int i = 0; i < i_workers; i++ )
+    {
+        if( vlc_clone( &p_sys->p_workers[i], Worker, p_fingerprinter,
+                       VLC_THREAD_PRIORITY_LOW ) )
+            break;
+        p_sys->i_workers++;
+    }
+    if ( p_sys->i_workers == 0 )
+    {
+        msg_Err( p_fingerprinter, "cannot spawn any fingerprinter worker" );
+        goto error;
+    }
+
     if( vlc_clone( &p_sys->thread, Run, p_fingerprinter,
                    VLC_THREAD_PRIORITY_LOW ) )
     {
@@ -217,6 +285,21 @@ static int Open(vlc_object_t *p_this)
     return VLC_SUCCESS;
 
 error:
+    vlc_mutex_lock( &p_sys->processing.lock );
+    p_sys->processing.b_exit = true;
+    vlc_cond_broadcast( &p_sys->processing.wait );
+    vlc_mutex_unlock( &p_sys->processing.lock );
+    for ( unsigned i = 0; i < p_sys->i_workers; i++ )
+        vlc_join( p_sys->p_workers[i], NULL );
+    free( p_sys->p_workers );
+    vlc_array_destroy( p_sys->incoming.queue );
+    vlc_mutex_destroy( &p_sys->incoming.lock );
+    vlc_array_destroy( p_sys->processing.queue );
+    vlc_cond_destroy( &p_sys->processing.wait );
+    vlc_mutex_destroy( &p_sys->processing.lock );
+    vlc_mutex_destroy( &p_sys->web.lock );
+    vlc_array_destroy( p_sys->results.queue );
+    vlc_mutex_destroy( &p_sys->results.lock );
     free( p_sys );
     return VLC_EGENERIC;
 }
@@ -232,6 +315,14 @@ static void Close(vlc_object_t *p_this)
     vlc_cancel( p_sys->thread );
     vlc_join( p_sys->thread, NULL );
 
+    vlc_mutex_lock( &p_sys->processing.lock );
+    p_sys->processing.b_exit = true;
+    vlc_cond_broadcast( &p_sys->processing.wait );
+    vlc_mutex_unlock( &p_sys->processing.lock );
+    for ( unsigned i = 0; i < p_sys->i_workers; i++ )
+        vlc_join( p_sys->p_workers[i], NULL );
+    free( p_sys->p_workers );
+
     for ( int i = 0; i < vlc_array_count( p_sys->incoming.queue ); i++ )
         fingerprint_request_Delete( vlc_array_item_at_index( p_sys->incoming.queue, i ) );
     vlc_array_destroy( p_sys->incoming.queue );
@@ -240,6 +331,9 @@ static void Close(vlc_object_t *p_this)
     for ( int i = 0; i < vlc_array_count( p_sys->processing.queue ); i++ )
         fingerprint_request_Delete( vlc_array_item_at_index( p_sys->processing.queue, i ) );
     vlc_array_destroy( p_sys->processing.queue );
+    vlc_cond_destroy( &p_sys->processing.wait );
+    vlc_mutex_destroy( &p_sys->processing.lock );
+    vlc_mutex_destroy( &p_sys->web.lock );
 
     for ( int i = 0; i < vlc_array_count( p_sys->results.queue ); i++ )
         fingerprint_request_Delete( vlc_array_item_at_index( p_sys->results.queue, i ) );
@@ -269,6 +363,81 @@ static void fill_metas_with_results( fingerprint_request_t *p_r, acoustid_finger
     }
 }
 
+static void ProcessRequest( fingerprinter_thread_t *p_fingerprinter,
+                            fingerprint_request_t *p_data )
+{
+    fingerprinter_sys_t *p_sys = p_fingerprinter->p_sys;
+
+    char *psz_uri = input_item_GetURI( p_data->p_item );
+    if ( psz_uri != NULL )
+    {
+         acoustid_fingerprint_t acoustid_print;
+
+         memset( &acoustid_print , 0, sizeof (acoustid_print) );
+        /* overwrite with hint, as in this case, fingerprint's session will be truncated */
+        if ( p_data->i_duration )
+             acoustid_print.i_duration = p_data->i_duration;
+
+        DoFingerprint( VLC_OBJECT(p_fingerprinter),
+                       &acoustid_print, psz_uri );
+        free( psz_uri );
+
+        WebRequestThrottle( p_sys );
+        DoAcoustIdWebRequest( VLC_OBJECT(p_fingerprinter), &acoustid_print );
+        fill_metas_with_results( p_data, &acoustid_print );
+
+        for( unsigned j = 0; j < acoustid_print.results.count; j++ )
+             free_acoustid_result_t( &acoustid_print.results.p_results[j] );
+        if( acoustid_print.results.count )
+            free( acoustid_print.results.p_results );
+        free( acoustid_print.psz_fingerprint );
+    }
+
+    /* copy results */
+    vlc_mutex_lock( &p_sys->results.lock );
+    vlc_array_append( p_sys->results.queue, p_data );
+    vlc_mutex_unlock( &p_sys->results.lock );
+}
+
+/*****************************************************************************
+ * Worker : a decode+fingerprint pipeline
+ *****************************************************************************/
+static void *Worker( void *opaque )
+{
+    fingerprinter_thread_t *p_fingerprinter = opaque;
+    fingerprinter_sys_t *p_sys = p_fingerprinter->p_sys;
+    int canc = vlc_savecancel();
+
+    vlc_mutex_lock( &p_sys->processing.lock );
+    for (;;)
+    {
+        while ( !p_sys->processing.b_exit &&
+                vlc_array_count( p_sys->processing.queue ) == 0 )
+            vlc_cond_wait( &p_sys->processing.wait, &p_sys->processing.lock );
+        if ( p_sys->processing.b_exit )
+            break;
+
+        fingerprint_request_t *p_data =
+                vlc_array_item_at_index( p_sys->processing.queue, 0 );
+        vlc_array_remove( p_sys->processing.queue, 0 );
+        p_sys->processing.i_jobs++;
+        vlc_mutex_unlock( &p_sys->processing.lock );
+
+        ProcessRequest( p_fingerprinter, p_data );
+
+        vlc_mutex_lock( &p_sys->processing.lock );
+        p_sys->processing.i_jobs--;
+        /* signal once per drained batch, like the old serial loop did */
+        if ( p_sys->processing.i_jobs == 0 &&
+             vlc_array_count( p_sys->processing.queue ) == 0 )
+            var_TriggerCallback( p_fingerprinter, "results-available" );
+    }
+    vlc_mutex_unlock( &p_sys->processing.lock );
+
+    vlc_restorecancel( canc );
+    return NULL;
+}
+
 /*****************************************************************************
  * Run :
  *****************************************************************************/
@@ -283,50 +452,6 @@ static void *Run( void *opaque )
         msleep( CLOCK_FREQ );
 
         QueueIncomingRequests( p_sys );
-
-        for ( int i = 0 ; i < vlc_array_count( p_sys->processing.queue ); i++ )
-        {
-            int canc = vlc_savecancel();
-            fingerprint_request_t *p_data = vlc_array_item_at_index( p_sys->processing.queue, i );
-
-            char *psz_uri = input_item_GetURI( p_data->p_item );
-            if ( psz_uri != NULL )
-            {
-                 acoustid_fingerprint_t acoustid_print;
-
-                 memset( &acoustid_print , 0, sizeof (acoustid_print) );
-                /* overwrite with hint, as in this case, fingerprint's session will be truncated */
-                if ( p_data->i_duration )
-                     acoustid_print.i_duration = p_data->i_duration;
-
-                DoFingerprint( VLC_OBJECT(p_fingerprinter),
-                               &acoustid_print, psz_uri );
-                free( psz_uri );
-
-                DoAcoustIdWebRequest( VLC_OBJECT(p_fingerprinter), &acoustid_print );
-                fill_metas_with_results( p_data, &acoustid_print );
-
-                for( unsigned j = 0; j < acoustid_print.results.count; j++ )
-                     free_acoustid_result_t( &acoustid_print.results.p_results[j] );
-                if( acoustid_print.results.count )
-                    free( acoustid_print.results.p_results );
-                free( acoustid_print.psz_fingerprint );
-            }
-            vlc_restorecancel(canc);
-
-            /* copy results */
-            vlc_mutex_lock( &p_sys->results.lock );
-            vlc_array_append( p_sys->results.queue, p_data );
-            vlc_mutex_unlock( &p_sys->results.lock );
-
-            vlc_testcancel();
-        }
-
-        if ( vlc_array_count( p_sys->processing.queue ) )
-        {
-            var_TriggerCallback( p_fingerprinter, "results-available" );
-            vlc_array_clear( p_sys->processing.queue );
-        }
     }
     vlc_assert_unreachable();
 }
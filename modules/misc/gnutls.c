@@ -388,6 +388,117 @@ done:
     return 0;
 }
 
+/*
+ * Client-side session cache for TLS resumption. Session tickets are stored
+ * per host after a fully verified handshake, so reconnections to the same
+ * server (e.g. per-segment HTTP connections) can resume with a single
+ * round-trip instead of a complete handshake. A rejected ticket merely
+ * falls back to a full handshake.
+ */
+#define CACHE_TIMEOUT  (3600 * CLOCK_FREQ)
+#define CACHE_SIZE     32
+
+struct gnutls_cached_session
+{
+    char *host;
+    gnutls_datum_t data;
+    mtime_t expiry;
+    struct gnutls_cached_session *next;
+};
+
+static vlc_mutex_t cache_lock = VLC_STATIC_MUTEX;
+static struct gnutls_cached_session *cache_entries = NULL;
+static unsigned cache_count = 0;
+
+static void gnutls_CacheEntryDelete (struct gnutls_cached_session *entry)
+{
+    gnutls_free (entry->data.data);
+    free (entry->host);
+    free (entry);
+}
+
+/** Tries to resume an earlier session with the same host. */
+static void gnutls_SessionResume (gnutls_session_t session, const char *host)
+{
+    mtime_t now = mdate ();
+
+    vlc_mutex_lock (&cache_lock);
+    for (struct gnutls_cached_session *entry = cache_entries,
+         **pp = &cache_entries; entry != NULL; entry = *pp)
+    {
+        if (entry->expiry <= now)
+        {   /* expired ticket - drop it */
+            *pp = entry->next;
+            cache_count--;
+            gnutls_CacheEntryDelete (entry);
+            continue;
+        }
+        if (!strcmp (entry->host, host))
+            /* The data is copied into the session */
+            gnutls_session_set_data (session, entry->data.data,
+                                     entry->data.size);
+        pp = &entry->next;
+    }
+    vlc_mutex_unlock (&cache_lock);
+}
+
+/** Stores the session ticket of a (verified) established session. */
+static void gnutls_SessionCache (gnutls_session_t session, const char *host)
+{
+    gnutls_datum_t data;
+
+    if (gnutls_session_get_data2 (session, &data) != 0)
+        return;
+    if (data.size == 0)
+    {
+        gnutls_free (data.data);
+        return;
+    }
+
+    struct gnutls_cached_session *entry = malloc (sizeof (*entry));
+    if (unlikely(entry == NULL))
+    {
+        gnutls_free (data.data);
+        return;
+    }
+    entry->host = strdup (host);
+    if (unlikely(entry->host == NULL))
+    {
+        gnutls_free (data.data);
+        free (entry);
+        return;
+    }
+    entry->data = data;
+    entry->expiry = mdate () + CACHE_TIMEOUT;
+
+    vlc_mutex_lock (&cache_lock);
+    /* Replace any previous ticket for this host */
+    for (struct gnutls_cached_session **pp = &cache_entries; *pp != NULL;
+         pp = &(*pp)->next)
+        if (!strcmp ((*pp)->host, host))
+        {
+            struct gnutls_cached_session *old = *pp;
+            *pp = old->next;
+            cache_count--;
+            gnutls_CacheEntryDelete (old);
+            break;
+        }
+
+    entry->next = cache_entries;
+    cache_entries = entry;
+    if (++cache_count > CACHE_SIZE)
+    {   /* evict the oldest ticket */
+        struct gnutls_cached_session **pp = &cache_entries;
+        while ((*pp)->next != NULL)
+            pp = &(*pp)->next;
+        struct gnutls_cached_session *last = *pp;
+        *pp = NULL;
+        cache_count--;
+        gnutls_CacheEntryDelete (last);
+    }
+    vlc_mutex_unlock (&cache_lock);
+}
+
 static int gnutls_ClientSessionOpen(vlc_tls_creds_t *crd, vlc_tls_t *tls,
                                     vlc_tls_t *sk, const char *hostname,
                                     const char *const *alpn)
@@ -402,9 +513,13 @@ static int gnutls_ClientSessionOpen(vlc_tls_creds_t *crd, vlc_tls_t *tls,
     gnutls_dh_set_prime_bits (session, 1024);
 
     if (likely(hostname != NULL))
+    {
         /* fill Server Name Indication */
         gnutls_server_name_set (session, GNUTLS_NAME_DNS,
                                 hostname, strlen (hostname));
+        /* resume an earlier session with the host if possible */
+        gnutls_SessionResume (session, hostname);
+    }
 
     return VLC_SUCCESS;
 }
@@ -421,6 +536,13 @@ static int gnutls_ClientHandshake(vlc_tls_creds_t *creds, vlc_tls_t *tls,
     gnutls_session_t session = tls->sys;
     unsigned status;
 
+    if (gnutls_session_is_resumed (session))
+    {   /* no certificate is re-sent on resumption: the chain was already
+         * verified when the session ticket was stored */
+        msg_Dbg(creds, "TLS session resumed with %s", host);
+        return 0;
+    }
+
     val = gnutls_certificate_verify_peers3 (session, host, &status);
     if (val)
     {
@@ -432,8 +554,12 @@ error:
         return -1;
     }
 
-    if (status == 0) /* Good certificate */
+    if (status == 0)
+    {   /* Good certificate */
+        if (host != NULL)
+            gnutls_SessionCache (session, host);
         return 0;
+    }
 
     /* Bad certificate */
     gnutls_datum_t desc;
@@ -53,6 +53,13 @@
     "\"Fast Start\" files are optimized for downloads and allow the user " \
     "to start previewing the file while it is downloading.")
 
+#define FRAGDUR_TEXT N_("Fragment duration (ms)")
+#define FRAGDUR_LONGTEXT N_(\
+    "Target duration of each fragment. Samples are flushed to the output " \
+    "in a moof/mdat pair once this much media has been buffered, bounding " \
+    "the muxer memory and making interrupted recordings recoverable up to " \
+    "the last written fragment.")
+
 static int  Open   (vlc_object_t *);
 static void Close  (vlc_object_t *);
 static int  OpenFrag   (vlc_object_t *);
@@ -79,6 +86,8 @@ add_submodule ()
     set_subcategory(SUBCAT_SOUT_MUX)
     set_shortname("MP4 Frag")
     add_shortcut("mp4frag", "mp4stream")
+    add_integer(SOUT_CFG_PREFIX "frag-duration", 1500,
+                FRAGDUR_TEXT, FRAGDUR_LONGTEXT, true)
     set_capability("sout mux", 0)
     set_callbacks(OpenFrag, CloseFrag)
 
@@ -88,7 +97,7 @@ vlc_module_end ()
  * Exported prototypes
  *****************************************************************************/
 static const char *const ppsz_sout_options[] = {
-    "faststart", NULL
+    "faststart", "frag-duration", NULL
 };
 
 static int Control(sout_mux_t *, int, va_list);
@@ -170,6 +179,7 @@ struct sout_mux_sys_t
     /* mp4frag */
     bool           b_fragmented;
     bool           b_header_sent;
+    mtime_t        i_fragment_length;
     mtime_t        i_written_duration;
     uint32_t       i_mfhd_sequence;
 };
@@ -1187,6 +1197,8 @@ static int OpenFrag(vlc_object_t *p_this)
     if (!p_sys)
         return VLC_ENOMEM;
 
+    config_ChainParse(p_mux, SOUT_CFG_PREFIX, ppsz_sout_options, p_mux->p_cfg);
+
     p_mux->p_sys = (sout_mux_sys_t *) p_sys;
     p_mux->pf_control   = Control;
     p_mux->pf_addstream = AddStream;
@@ -1210,6 +1222,11 @@ static int OpenFrag(vlc_object_t *p_this)
     p_sys->b_fragmented  = true;
     p_sys->i_mfhd_sequence = 1;
 
+    p_sys->i_fragment_length =
+            var_GetInteger(p_mux, SOUT_CFG_PREFIX "frag-duration") * 1000;
+    if (p_sys->i_fragment_length <= 0)
+        p_sys->i_fragment_length = FRAGMENT_LENGTH;
+
     return VLC_SUCCESS;
 }
 
@@ -1217,7 +1234,7 @@ static void WriteFragments(sout_mux_t *p_mux, bool b_flush)
 {
     sout_mux_sys_t *p_sys = (sout_mux_sys_t*) p_mux->p_sys;
     bo_t *moof = NULL;
-    mtime_t i_barrier_time = p_sys->i_written_duration + FRAGMENT_LENGTH;
+    mtime_t i_barrier_time = p_sys->i_written_duration + p_sys->i_fragment_length;
     size_t i_mdat_size = 0;
     bool b_has_samples = false;
 
@@ -1422,7 +1439,7 @@ static int MuxFrag(sout_mux_t *p_mux)
         p_stream->p_held_entry = NULL;
 
         if (p_stream->b_hasiframes && (p_heldblock->i_flags & BLOCK_FLAG_TYPE_I) &&
-            p_stream->mux.i_read_duration - p_sys->i_written_duration < FRAGMENT_LENGTH)
+            p_stream->mux.i_read_duration - p_sys->i_written_duration < p_sys->i_fragment_length)
         {
             /* Flag the last iframe time, we'll use it as boundary so it will start
                next fragment */
@@ -1471,7 +1488,7 @@ static int MuxFrag(sout_mux_t *p_mux)
     p_sys->i_written_duration = i_min_written_duration;
 
     /* we have prerolled enough to know all streams, and have enough date to create a fragment */
-    if (p_stream->read.p_first && p_sys->i_read_duration - p_sys->i_written_duration >= FRAGMENT_LENGTH)
+    if (p_stream->read.p_first && p_sys->i_read_duration - p_sys->i_written_duration >= p_sys->i_fragment_length)
         WriteFragments(p_mux, false);
 
     return VLC_SUCCESS;
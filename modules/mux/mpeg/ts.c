@@ -172,6 +172,12 @@ static void    Close  ( vlc_object_t * );
 #define CU_LONGTEXT N_("CSA encryption key used. It can be the odd/first/1 " \
   "(default) or the even/second/2 one.")
 
+#define BATCH_TEXT N_("Batched output duration (ms)")
+#define BATCH_LONGTEXT N_("Coalesce the TS packets covering the given " \
+    "duration into a single large write towards the access output, " \
+    "instead of one small write per packet. Packets keep their PCR " \
+    "spacing, only the write granularity changes. 0 disables batching." )
+
 #define CPKT_TEXT N_("Packet size in bytes to encrypt")
 #define CPKT_LONGTEXT N_("Size of the TS packet to encrypt. " \
     "The encryption routines subtract the TS-header from the value before " \
@@ -215,6 +221,7 @@ vlc_module_begin ()
     add_integer( SOUT_CFG_PREFIX "bmin", 0, BMIN_TEXT, BMIN_LONGTEXT, true)
     add_integer( SOUT_CFG_PREFIX "bmax", 0, BMAX_TEXT, BMAX_LONGTEXT, true)
     add_integer( SOUT_CFG_PREFIX "dts-delay", 400, DTS_TEXT, DTS_LONGTEXT, true)
+    add_integer( SOUT_CFG_PREFIX "batch", 0, BATCH_TEXT, BATCH_LONGTEXT, true)
 
     add_bool( SOUT_CFG_PREFIX "crypt-audio", true, ACRYPT_TEXT, ACRYPT_LONGTEXT, true)
     add_bool( SOUT_CFG_PREFIX "crypt-video", true, VCRYPT_TEXT, VCRYPT_LONGTEXT, true)
@@ -233,7 +240,7 @@ static const char *const ppsz_sout_options[] = {
     "pid-video", "pid-audio", "pid-spu", "pid-pmt", "tsid",
     "netid", "sdtdesc",
     "es-id-pid", "shaping", "pcr", "bmin", "bmax", "use-key-frames",
-    "dts-delay", "csa-ck", "csa2-ck", "csa-use", "csa-pkt", "crypt-audio", "crypt-video",
+    "dts-delay", "batch", "csa-ck", "csa2-ck", "csa-use", "csa-pkt", "crypt-audio", "crypt-video",
     "muxpmt", "program-pmt", "alignment",
     NULL
 };
@@ -363,6 +370,12 @@ struct sout_mux_sys_t
     int64_t         i_dts_delay;
     mtime_t         first_dts;
 
+    /* output batching */
+    mtime_t         i_batch_length;
+    sout_buffer_chain_t chain_batch;
+    mtime_t         i_batch_dts;
+    size_t          i_batch_bytes;
+
     bool            b_use_key_frames;
 
     mtime_t         i_pcr;  /* last PCR emited */
@@ -463,6 +476,8 @@ static void TSSchedule  ( sout_mux_t *p_mux, sout_buffer_chain_t *p_chain_ts,
                           mtime_t i_pcr_length, mtime_t i_pcr_dts );
 static void TSDate      ( sout_mux_t *p_mux, sout_buffer_chain_t *p_chain_ts,
                           mtime_t i_pcr_length, mtime_t i_pcr_dts );
+static void TSBatchWrite( sout_mux_t *p_mux, block_t *p_ts );
+static void TSBatchFlush( sout_mux_t *p_mux );
 static void GetPAT( sout_mux_t *p_mux, sout_buffer_chain_t *c );
 static void GetPMT( sout_mux_t *p_mux, sout_buffer_chain_t *c );
 
@@ -715,6 +730,12 @@ static int Open( vlc_object_t *p_this )
     var_Get( p_mux, SOUT_CFG_PREFIX "dts-delay", &val );
     p_sys->i_dts_delay = val.i_int * 1000;
 
+    var_Get( p_mux, SOUT_CFG_PREFIX "batch", &val );
+    p_sys->i_batch_length = val.i_int * 1000;
+    BufferChainInit( &p_sys->chain_batch );
+    p_sys->i_batch_dts = 0;
+    p_sys->i_batch_bytes = 0;
+
     msg_Dbg( p_mux, "shaping=%"PRId64" pcr=%"PRId64" dts_delay=%"PRId64,
              p_sys->i_shaping_delay, p_sys->i_pcr_delay, p_sys->i_dts_delay );
 
@@ -740,6 +761,9 @@ static void Close( vlc_object_t * p_this )
     sout_mux_t          *p_mux = (sout_mux_t*)p_this;
     sout_mux_sys_t      *p_sys = p_mux->p_sys;
 
+    /* push out whatever is left in the output batch */
+    TSBatchFlush( p_mux );
+
     if( p_sys->p_dvbpsi )
         dvbpsi_delete( p_sys->p_dvbpsi );
 
@@ -1755,6 +1779,64 @@ static void TSSchedule( sout_mux_t *p_mux, sout_buffer_chain_t *p_chain_ts,
         TSDate( p_mux, &new_chain, i_pcr_length, i_pcr_dts );
 }
 
+/* Gather the pending batch into one contiguous buffer, so the access
+ * output sees a single large packet-aligned write instead of a burst of
+ * 188 byte ones. */
+static void TSBatchFlush( sout_mux_t *p_mux )
+{
+    sout_mux_sys_t *p_sys = p_mux->p_sys;
+    block_t *p_ts;
+
+    if( p_sys->chain_batch.i_depth <= 0 )
+        return;
+
+    block_t *p_batch = block_Alloc( p_sys->i_batch_bytes );
+    if( unlikely(p_batch == NULL) )
+    {
+        /* degraded mode: write the chain as is */
+        while( ( p_ts = BufferChainGet( &p_sys->chain_batch ) ) )
+            sout_AccessOutWrite( p_mux->p_access, p_ts );
+        p_sys->i_batch_bytes = 0;
+        return;
+    }
+
+    const block_t *p_first = BufferChainPeek( &p_sys->chain_batch );
+    p_batch->i_dts = p_first->i_dts;
+    p_batch->i_flags = p_first->i_flags;
+    p_batch->i_length = 0;
+
+    uint8_t *p_dst = p_batch->p_buffer;
+    while( ( p_ts = BufferChainGet( &p_sys->chain_batch ) ) )
+    {
+        memcpy( p_dst, p_ts->p_buffer, p_ts->i_buffer );
+        p_dst += p_ts->i_buffer;
+        p_batch->i_length += p_ts->i_length;
+        block_Release( p_ts );
+    }
+    p_sys->i_batch_bytes = 0;
+
+    sout_AccessOutWrite( p_mux->p_access, p_batch );
+}
+
+static void TSBatchWrite( sout_mux_t *p_mux, block_t *p_ts )
+{
+    sout_mux_sys_t *p_sys = p_mux->p_sys;
+
+    if( p_sys->i_batch_length <= 0 )
+    {
+        sout_AccessOutWrite( p_mux->p_access, p_ts );
+        return;
+    }
+
+    if( p_sys->chain_batch.i_depth == 0 )
+        p_sys->i_batch_dts = p_ts->i_dts;
+    p_sys->i_batch_bytes += p_ts->i_buffer;
+    BufferChainAppend( &p_sys->chain_batch, p_ts );
+
+    if( p_ts->i_dts + p_ts->i_length - p_sys->i_batch_dts >= p_sys->i_batch_length )
+        TSBatchFlush( p_mux );
+}
+
 static void TSDate( sout_mux_t *p_mux, sout_buffer_chain_t *p_chain_ts,
                     mtime_t i_pcr_length, mtime_t i_pcr_dts )
 {
@@ -1804,7 +1886,7 @@ static void TSDate( sout_mux_t *p_mux, sout_buffer_chain_t *p_chain_ts,
         /* latency */
         p_ts->i_dts += p_sys->i_shaping_delay * 3 / 2;
 
-        sout_AccessOutWrite( p_mux->p_access, p_ts );
+        TSBatchWrite( p_mux, p_ts );
     }
 }
 
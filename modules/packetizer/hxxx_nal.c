@@ -17,6 +17,7 @@
  *****************************************************************************/
 
 #include "hxxx_nal.h"
+#include "startcode_helper.h"
 
 #include <vlc_block.h>
 
@@ -55,44 +56,36 @@ block_t *hxxx_AnnexB_to_xVC( block_t *p_block, uint8_t i_nal_length_size )
     if(! (p_list = malloc( sizeof(*p_list) * i_list )) )
         goto error;
 
-    /* Search all startcode of size 3 */
+    /* Search all startcodes, using the vectorized scanner */
     const uint8_t *p_buf = p_block->p_buffer;
     const uint8_t *p_end = &p_block->p_buffer[p_block->i_buffer];
-    unsigned i_bitflow = 0;
     off_t i_move = 0;
-    while( p_buf != p_end )
+    const uint8_t *p_startcode;
+    while( (p_startcode = startcode_FindAnnexB( p_buf, p_end )) )
     {
-        i_bitflow <<= 1;
-        if( !*p_buf )
+        if( p_startcode > p_block->p_buffer && p_startcode[-1] == 0 )
+        {   /* three zero prefixed 1 */
+            p_list[i_nalcount].p = &p_startcode[-1];
+            p_list[i_nalcount].prefix = 4;
+        }
+        else /* two zero prefixed 1 */
         {
-            i_bitflow |= 1;
+            p_list[i_nalcount].p = p_startcode;
+            p_list[i_nalcount].prefix = 3;
         }
-        else if( *p_buf == 0x01 && (i_bitflow & 0x06) == 0x06 ) /* >= two zero prefixed 1 */
+        i_move += (off_t) i_nal_length_size - p_list[i_nalcount].prefix;
+        p_list[i_nalcount++].move = i_move;
+        p_buf = &p_startcode[3];
+
+        /* Check and realloc our list */
+        if(i_nalcount == i_list)
         {
-            if( i_bitflow & 0x08 ) /* three zero prefixed 1 */
-            {
-                p_list[i_nalcount].p = &p_buf[-3];
-                p_list[i_nalcount].prefix = 4;
-            }
-            else /* two zero prefixed 1 */
-            {
-                p_list[i_nalcount].p = &p_buf[-2];
-                p_list[i_nalcount].prefix = 3;
-            }
-            i_move += (off_t) i_nal_length_size - p_list[i_nalcount].prefix;
-            p_list[i_nalcount++].move = i_move;
-
-            /* Check and realloc our list */
-            if(i_nalcount == i_list)
-            {
-                i_list += 16;
-                struct nalmoves_e *p_new = malloc( sizeof(*p_new) * i_list );
-                if(unlikely(!p_new))
-                    goto error;
-                p_list = p_new;
-            }
+            i_list += 16;
+            struct nalmoves_e *p_new = realloc( p_list, sizeof(*p_new) * i_list );
+            if(unlikely(!p_new))
+                goto error;
+            p_list = p_new;
         }
-        p_buf++;
     }
 
     if( !i_nalcount )
@@ -59,6 +59,15 @@
  * efficient demux probing */
 #define STREAM_CACHE_PREBUFFER_SIZE (128)
 
+/* Adaptive cache depth: the retained window doubles while the measured
+ * per-request latency says the source is expensive (network, optical) and
+ * shrinks back on cheap local media, so fast local files do not pin
+ * STREAM_CACHE_SIZE of RAM for nothing */
+#define STREAM_CACHE_SIZE_MIN (STREAM_CACHE_SIZE / 16)
+#define STREAM_ADAPT_INTERVAL (16)        /* reads between two adjustments */
+#define STREAM_ADAPT_SLOW_LATENCY (10000) /* µs per read */
+#define STREAM_ADAPT_FAST_LATENCY (1000)  /* µs per read */
+
 /* Method: Simple, for pf_block.
  *  We get blocks and put them in the linked list.
  *  We release blocks once the total size is bigger than STREAM_CACHE_SIZE
@@ -76,6 +85,8 @@ struct stream_sys_t
     block_t     *p_first;
     block_t    **pp_last;
 
+    uint64_t     i_cache_max;    /* Current (adaptive) cache depth */
+
     struct
     {
         /* Stat about reading data */
@@ -83,8 +94,46 @@ struct stream_sys_t
         uint64_t i_bytes;
         uint64_t i_read_time;
     } stat;
+
+    struct
+    {
+        /* Snapshot of stat at the last cache depth adjustment */
+        uint64_t i_read_count;
+        uint64_t i_read_time;
+    } adapt;
 };
 
+/* Rescale the cache depth from the latency measured over the last
+ * STREAM_ADAPT_INTERVAL reads */
+static void AStreamAdaptCacheSize(stream_t *s)
+{
+    stream_sys_t *sys = s->p_sys;
+    const uint64_t i_count = sys->stat.i_read_count - sys->adapt.i_read_count;
+
+    if (i_count < STREAM_ADAPT_INTERVAL)
+        return;
+
+    const mtime_t i_latency =
+        (sys->stat.i_read_time - sys->adapt.i_read_time) / i_count;
+
+    uint64_t i_cache_max = sys->i_cache_max;
+    if (i_latency > STREAM_ADAPT_SLOW_LATENCY)
+        i_cache_max = __MIN(i_cache_max * 2, STREAM_CACHE_SIZE);
+    else if (i_latency < STREAM_ADAPT_FAST_LATENCY)
+        i_cache_max = __MAX(i_cache_max / 2, STREAM_CACHE_SIZE_MIN);
+
+    if (i_cache_max != sys->i_cache_max)
+    {
+        msg_Dbg(s, "adapting cache depth to %"PRIu64" KiB "
+                "(per-read latency %"PRId64" us)", i_cache_max / 1024,
+                i_latency);
+        sys->i_cache_max = i_cache_max;
+    }
+
+    sys->adapt.i_read_count = sys->stat.i_read_count;
+    sys->adapt.i_read_time = sys->stat.i_read_time;
+}
+
 static block_t *AReadBlock(stream_t *s, bool *restrict eof)
 {
     block_t *block;
@@ -102,7 +151,7 @@ static int AStreamRefillBlock(stream_t *s)
     stream_sys_t *sys = s->p_sys;
 
     /* Release data */
-    while (sys->i_size >= STREAM_CACHE_SIZE &&
+    while (sys->i_size >= sys->i_cache_max &&
            sys->p_first != sys->p_current)
     {
         block_t *b = sys->p_first;
@@ -113,7 +162,7 @@ static int AStreamRefillBlock(stream_t *s)
 
         block_Release(b);
     }
-    if (sys->i_size >= STREAM_CACHE_SIZE &&
+    if (sys->i_size >= sys->i_cache_max &&
         sys->p_current == sys->p_first &&
         sys->p_current->p_next)    /* At least 2 packets */
     {
@@ -157,6 +206,8 @@ static int AStreamRefillBlock(stream_t *s)
 
         b = b->p_next;
     }
+
+    AStreamAdaptCacheSize(s);
     return VLC_SUCCESS;
 }
 
@@ -307,7 +358,7 @@ static int AStreamSeekBlock(stream_t *s, uint64_t i_pos)
             int i_th = b_aseekfast ? 1 : 5;
 
             if (i_skip <= i_th * i_avg &&
-                i_skip < STREAM_CACHE_SIZE)
+                i_skip < (int64_t)sys->i_cache_max)
                 b_seek = false;
             else
                 b_seek = true;
@@ -464,6 +515,9 @@ static int Open(vlc_object_t *obj)
     sys->stat.i_bytes = 0;
     sys->stat.i_read_time = 0;
     sys->stat.i_read_count = 0;
+    sys->adapt.i_read_count = 0;
+    sys->adapt.i_read_time = 0;
+    sys->i_cache_max = STREAM_CACHE_SIZE_MIN;
 
     msg_Dbg(s, "Using block method for AStream*");
 
@@ -72,6 +72,15 @@
 #define STREAM_READ_ATONCE 1024
 #define STREAM_CACHE_TRACK_SIZE (STREAM_CACHE_SIZE/STREAM_CACHE_TRACK)
 
+/* Adaptive readahead: the read granularity doubles while the measured
+ * per-request latency says the medium is expensive (network, optical) and
+ * shrinks back on cheap local media, so the window follows the source
+ * instead of a compile-time constant */
+#define STREAM_READ_SIZE_MAX (STREAM_CACHE_TRACK_SIZE / 4)
+#define STREAM_ADAPT_INTERVAL (16)        /* reads between two adjustments */
+#define STREAM_ADAPT_SLOW_LATENCY (10000) /* µs per read */
+#define STREAM_ADAPT_FAST_LATENCY (1000)  /* µs per read */
+
 typedef struct
 {
     mtime_t date;
@@ -105,8 +114,45 @@ struct stream_sys_t
         uint64_t i_bytes;
         uint64_t i_read_time;
     } stat;
+
+    struct
+    {
+        /* Snapshot of stat at the last granularity adjustment */
+        uint64_t i_read_count;
+        uint64_t i_read_time;
+    } adapt;
 };
 
+/* Rescale the read granularity from the latency measured over the last
+ * STREAM_ADAPT_INTERVAL reads */
+static void AStreamAdaptReadSize(stream_t *s)
+{
+    stream_sys_t *sys = s->p_sys;
+    const uint64_t i_count = sys->stat.i_read_count - sys->adapt.i_read_count;
+
+    if (i_count < STREAM_ADAPT_INTERVAL)
+        return;
+
+    const mtime_t i_latency =
+        (sys->stat.i_read_time - sys->adapt.i_read_time) / i_count;
+
+    unsigned i_read_size = sys->i_read_size;
+    if (i_latency > STREAM_ADAPT_SLOW_LATENCY)
+        i_read_size = __MIN(i_read_size * 2, STREAM_READ_SIZE_MAX);
+    else if (i_latency < STREAM_ADAPT_FAST_LATENCY)
+        i_read_size = __MAX(i_read_size / 2, STREAM_READ_ATONCE);
+
+    if (i_read_size != sys->i_read_size)
+    {
+        msg_Dbg(s, "adapting read size to %u bytes "
+                "(per-read latency %"PRId64" us)", i_read_size, i_latency);
+        sys->i_read_size = i_read_size;
+    }
+
+    sys->adapt.i_read_count = sys->stat.i_read_count;
+    sys->adapt.i_read_time = sys->stat.i_read_time;
+}
+
 static int AStreamRefillStream(stream_t *s)
 {
     stream_sys_t *sys = s->p_sys;
@@ -164,6 +210,8 @@ static int AStreamRefillStream(stream_t *s)
     }
 
     sys->stat.i_read_time += mdate() - start;
+
+    AStreamAdaptReadSize(s);
     return VLC_SUCCESS;
 }
 
@@ -279,8 +327,8 @@ static ssize_t AStreamReadNoSeekStream(stream_t *s, void *buf, size_t len)
     if (tk->i_end + i_copy <= tk->i_start + sys->i_offset + len)
     {
         const size_t i_read_requested = VLC_CLIP(len - i_copy,
-                                                 STREAM_READ_ATONCE / 2,
-                                                 STREAM_READ_ATONCE * 10);
+                                                 sys->i_read_size / 2,
+                                                 (size_t)sys->i_read_size * 10);
         if (sys->i_used < i_read_requested)
             sys->i_used = i_read_requested;
 
@@ -397,7 +445,7 @@ static int AStreamSeekStream(stream_t *s, uint64_t i_pos)
             uint64_t i_skip = i_pos - tk->i_end;
             while (i_skip > 0)
             {
-                const int i_read_max = __MIN(10 * STREAM_READ_ATONCE, i_skip);
+                const int i_read_max = __MIN(10 * sys->i_read_size, i_skip);
                 int i_read = 0;
                 if ((i_read = AStreamReadNoSeekStream(s, NULL, i_read_max)) < 0)
                 {
@@ -435,8 +483,8 @@ static int AStreamSeekStream(stream_t *s, uint64_t i_pos)
      */
     if (tk->i_end < tk->i_start + sys->i_offset + sys->i_read_size)
     {
-        if (sys->i_used < STREAM_READ_ATONCE / 2)
-            sys->i_used = STREAM_READ_ATONCE / 2;
+        if (sys->i_used < sys->i_read_size / 2)
+            sys->i_used = sys->i_read_size / 2;
 
         if (AStreamRefillStream(s))
             return VLC_EGENERIC;
@@ -535,6 +583,8 @@ static int Open(vlc_object_t *obj)
 
     sys->i_used   = 0;
     sys->i_read_size = STREAM_READ_ATONCE;
+    sys->adapt.i_read_count = 0;
+    sys->adapt.i_read_time = 0;
 #if STREAM_READ_ATONCE < 256
 #   error "Invalid STREAM_READ_ATONCE value"
 #endif
@@ -52,6 +52,7 @@
 static int  OpenGzip (vlc_object_t *);
 static int  OpenBzip2 (vlc_object_t *);
 static int  OpenXZ (vlc_object_t *);
+static int  OpenZstd (vlc_object_t *);
 static void Close (vlc_object_t *);
 
 vlc_module_begin ()
@@ -70,6 +71,10 @@ vlc_module_begin ()
     add_submodule ()
     set_description (N_("gzip decompression"))
     set_callbacks (OpenGzip, Close)
+
+    add_submodule ()
+    set_description (N_("Zstandard decompression"))
+    set_callbacks (OpenZstd, Close)
 vlc_module_end ()
 
 struct stream_sys_t
@@ -252,13 +257,18 @@ static int Control (stream_t *stream, int query, va_list args)
     return VLC_SUCCESS;
 }
 
+/* Readahead window: with default-sized pipes the decompressor stalls as
+ * soon as the demuxer stops draining; larger pipes let it run ahead */
+static const int pipesize = 1 << 20;
+
 /**
  * Pipe data through an external executable.
  * @param stream the stream filter object.
- * @param path path to the executable.
+ * @param argv NULL-terminated argument vector, argv[0] is the executable.
  */
-static int Open (stream_t *stream, const char *path)
+static int Open (stream_t *stream, const char *const *argv)
 {
+    const char *path = argv[0];
     stream_sys_t *p_sys = stream->p_sys = malloc (sizeof (*p_sys));
     if (p_sys == NULL)
         return VLC_ENOMEM;
@@ -281,23 +291,27 @@ static int Open (stream_t *stream, const char *path)
      * use vmsplice() on Linux. */
     if (vlc_pipe (comp) == 0)
     {
+#ifdef F_SETPIPE_SZ
+        fcntl (comp[1], F_SETPIPE_SZ, pipesize); /* best effort */
+#endif
         p_sys->write_fd = comp[1];
 
         int uncomp[2];
         if (vlc_pipe (uncomp) == 0)
         {
+#ifdef F_SETPIPE_SZ
+            fcntl (uncomp[1], F_SETPIPE_SZ, pipesize);
+#endif
             p_sys->read_fd = uncomp[0];
 
 #if (_POSIX_SPAWN >= 0)
             posix_spawn_file_actions_t actions;
             if (posix_spawn_file_actions_init (&actions) == 0)
             {
-                char *const argv[] = { (char *)path, NULL };
-
                 if (!posix_spawn_file_actions_adddup2 (&actions, comp[0], 0)
                  && !posix_spawn_file_actions_adddup2 (&actions, uncomp[1], 1)
-                 && !posix_spawnp (&p_sys->pid, path, &actions, NULL, argv,
-                                   environ))
+                 && !posix_spawnp (&p_sys->pid, path, &actions, NULL,
+                                   (char *const *)argv, environ))
                 {
                     if (vlc_clone (&p_sys->thread, Thread, stream,
                                    VLC_THREAD_PRIORITY_INPUT) == 0)
@@ -319,8 +333,8 @@ static int Open (stream_t *stream, const char *path)
                 case 0:
                     dup2 (comp[0], 0);
                     dup2 (uncomp[1], 1);
-                    execlp (path, path, (char *)NULL);
-                    exit (1); /* if we get, execlp() failed! */
+                    execvp (path, (char *const *)argv);
+                    exit (1); /* if we get, execvp() failed! */
                 default:
                     if (vlc_clone (&p_sys->thread, Thread, stream,
                                    VLC_THREAD_PRIORITY_INPUT) == 0)
@@ -394,7 +408,17 @@ static int OpenGzip (vlc_object_t *obj)
         return VLC_EGENERIC;
 
     msg_Dbg (obj, "detected gzip compressed stream");
-    return Open (stream, "zcat");
+#if (_POSIX_SPAWN >= 0)
+    /* pigz decompresses with separate read, write and check threads;
+     * spawn failure (not installed) is reported synchronously, so we can
+     * fall back. With fork()+exec() it would only show up as a read error,
+     * hence the guard. */
+    static const char *const pigz[] = { "pigz", "-dc", NULL };
+    if (Open (stream, pigz) == VLC_SUCCESS)
+        return VLC_SUCCESS;
+#endif
+    static const char *const zcat[] = { "zcat", NULL };
+    return Open (stream, zcat);
 }
 
 
@@ -415,7 +439,8 @@ static int OpenBzip2 (vlc_object_t *obj)
         return VLC_EGENERIC;
 
     msg_Dbg (obj, "detected bzip2 compressed stream");
-    return Open (stream, "bzcat");
+    static const char *const bzcat[] = { "bzcat", NULL };
+    return Open (stream, bzcat);
 }
 
 /**
@@ -434,5 +459,26 @@ static int OpenXZ (vlc_object_t *obj)
         return VLC_EGENERIC;
 
     msg_Dbg (obj, "detected xz compressed stream");
-    return Open (stream, "xzcat");
+    static const char *const xzcat[] = { "xzcat", NULL };
+    return Open (stream, xzcat);
+}
+
+/**
+ * Detects zstd file format
+ */
+static int OpenZstd (vlc_object_t *obj)
+{
+    stream_t      *stream = (stream_t *)obj;
+    const uint8_t *peek;
+
+    /* (Try to) parse the zstd frame magic */
+    if (stream_Peek (stream->p_source, &peek, 4) < 4)
+        return VLC_EGENERIC;
+
+    if (memcmp (peek, "\x28\xb5\x2f\xfd", 4))
+        return VLC_EGENERIC;
+
+    msg_Dbg (obj, "detected zstd compressed stream");
+    static const char *const zstdcat[] = { "zstdcat", NULL };
+    return Open (stream, zstdcat);
 }
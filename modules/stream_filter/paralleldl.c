@@ -0,0 +1,470 @@
+/*****************************************************************************
+ * paralleldl.c: segmented multi-connection download filter
+ *****************************************************************************
+ * Copyright (C) 2016 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vlc_common.h>
+#include <vlc_plugin.h>
+#include <vlc_stream.h>
+#include <vlc_interrupt.h>
+
+/* On long fat links a single TCP connection is capped by its
+ * bandwidth-delay product. This filter splits a seekable source of known
+ * size into fixed chunks on an absolute grid and downloads several of them
+ * in parallel, each worker on its own connection (its own instance of the
+ * underlying access, so HTTP authentication, cookies and proxies keep
+ * working). pf_read serves the chunks back in order.
+ *
+ * The filter is opt-in (--stream-filter=parallel) and bails out when the
+ * source is not seekable or its size is unknown, which for HTTP is
+ * equivalent to the server not supporting range requests. */
+
+typedef struct chunk_t
+{
+    struct chunk_t *p_next; /* Sorted by i_index */
+    uint64_t        i_index;
+    size_t          i_length;
+    char           *p_data;
+} chunk_t;
+
+typedef struct
+{
+    stream_t        *stream; /* The filter, for logging and p_sys */
+    vlc_thread_t     thread;
+    vlc_interrupt_t *interrupt;
+} worker_t;
+
+struct stream_sys_t
+{
+    vlc_mutex_t  lock;
+    vlc_cond_t   wait_data;  /* Signalled when a chunk lands or dies */
+    vlc_cond_t   wait_space; /* Signalled when the window moves */
+
+    uint64_t     size;       /* Source size, known and non-zero */
+    size_t       chunk_size;
+    uint64_t     chunk_count;
+    unsigned     window;     /* Max chunks buffered ahead of the reader */
+
+    uint64_t     read_offset;
+    uint64_t     next_chunk; /* Next chunk index to hand to a worker */
+    chunk_t     *chunks;     /* Completed chunks, sorted */
+
+    bool         killed;
+    bool         error;
+    unsigned     alive;      /* Running workers */
+
+    worker_t    *workers;
+    unsigned     worker_count;
+
+    /* Cached source properties; the source is left untouched once the
+     * workers run, so controls are answered from here */
+    bool         can_pause;
+    bool         can_pace;
+    int64_t      pts_delay;
+    char        *content_type;
+};
+
+static chunk_t *ChunkFind(stream_sys_t *sys, uint64_t i_index)
+{
+    for (chunk_t *c = sys->chunks; c != NULL && c->i_index <= i_index;
+         c = c->p_next)
+        if (c->i_index == i_index)
+            return c;
+    return NULL;
+}
+
+static void ChunkInsert(stream_sys_t *sys, chunk_t *chunk)
+{
+    chunk_t **pp = &sys->chunks;
+
+    while (*pp != NULL && (*pp)->i_index < chunk->i_index)
+        pp = &(*pp)->p_next;
+
+    if (*pp != NULL && (*pp)->i_index == chunk->i_index)
+    {   /* Refetched after a backward seek */
+        free(chunk->p_data);
+        free(chunk);
+        return;
+    }
+    chunk->p_next = *pp;
+    *pp = chunk;
+}
+
+/* Drop buffered chunks the reader can no longer reach */
+static void ChunkPrune(stream_sys_t *sys)
+{
+    uint64_t read_chunk = sys->read_offset / sys->chunk_size;
+    chunk_t **pp = &sys->chunks;
+
+    while (*pp != NULL)
+    {
+        chunk_t *c = *pp;
+
+        if (c->i_index < read_chunk
+         || c->i_index >= read_chunk + sys->window)
+        {
+            *pp = c->p_next;
+            free(c->p_data);
+            free(c);
+        }
+        else
+            pp = &c->p_next;
+    }
+}
+
+static void *Worker(void *opaque)
+{
+    worker_t *worker = opaque;
+    stream_t *stream = worker->stream;
+    stream_sys_t *sys = stream->p_sys;
+
+    vlc_interrupt_set(worker->interrupt);
+
+    stream_t *source = stream_UrlNew(stream, stream->psz_url);
+
+    vlc_mutex_lock(&sys->lock);
+    while (source != NULL && !sys->killed)
+    {
+        uint64_t read_chunk = sys->read_offset / sys->chunk_size;
+
+        /* Chunks present after a backward seek need not be refetched */
+        while (sys->next_chunk < sys->chunk_count
+            && sys->next_chunk < read_chunk + sys->window
+            && ChunkFind(sys, sys->next_chunk) != NULL)
+            sys->next_chunk++;
+
+        if (sys->next_chunk >= sys->chunk_count
+         || sys->next_chunk >= read_chunk + sys->window)
+        {
+            vlc_cond_wait(&sys->wait_space, &sys->lock);
+            continue;
+        }
+
+        uint64_t i_index = sys->next_chunk++;
+        vlc_mutex_unlock(&sys->lock);
+
+        uint64_t i_offset = i_index * (uint64_t)sys->chunk_size;
+        size_t i_length = sys->chunk_size;
+        if (i_offset + i_length > sys->size)
+            i_length = sys->size - i_offset;
+
+        chunk_t *chunk = malloc(sizeof (*chunk));
+        char *p_data = malloc(i_length);
+        bool ok = chunk != NULL && p_data != NULL
+               && stream_Seek(source, i_offset) == VLC_SUCCESS
+               && stream_Read(source, p_data, i_length) == (ssize_t)i_length;
+
+        vlc_mutex_lock(&sys->lock);
+        if (!ok || sys->killed)
+        {
+            free(p_data);
+            free(chunk);
+            if (!ok && !sys->killed)
+            {
+                msg_Err(stream, "cannot fetch chunk at offset %"PRIu64,
+                        i_offset);
+                sys->error = true;
+                vlc_cond_broadcast(&sys->wait_data);
+                break;
+            }
+            continue;
+        }
+
+        chunk->i_index = i_index;
+        chunk->i_length = i_length;
+        chunk->p_data = p_data;
+        ChunkInsert(sys, chunk);
+        vlc_cond_broadcast(&sys->wait_data);
+    }
+
+    sys->alive--;
+    vlc_cond_broadcast(&sys->wait_data);
+    vlc_mutex_unlock(&sys->lock);
+
+    if (source != NULL)
+        stream_Delete(source);
+    else
+        msg_Err(stream, "cannot open extra connection");
+    return NULL;
+}
+
+static ssize_t Read(stream_t *stream, void *buf, size_t len)
+{
+    stream_sys_t *sys = stream->p_sys;
+    chunk_t *chunk;
+
+    if (len == 0)
+        return 0;
+
+    vlc_mutex_lock(&sys->lock);
+    for (;;)
+    {
+        if (sys->read_offset >= sys->size)
+        {
+            vlc_mutex_unlock(&sys->lock);
+            return 0; /* EOF */
+        }
+
+        chunk = ChunkFind(sys, sys->read_offset / sys->chunk_size);
+        if (chunk != NULL)
+            break;
+
+        if (sys->error || sys->alive == 0)
+        {
+            vlc_mutex_unlock(&sys->lock);
+            return -1;
+        }
+        vlc_cond_wait(&sys->wait_data, &sys->lock);
+    }
+
+    size_t i_offset = sys->read_offset % sys->chunk_size;
+    size_t i_copy = __MIN(chunk->i_length - i_offset, len);
+
+    if (buf != NULL)
+        memcpy(buf, chunk->p_data + i_offset, i_copy);
+    sys->read_offset += i_copy;
+
+    ChunkPrune(sys);
+    vlc_cond_broadcast(&sys->wait_space);
+    vlc_mutex_unlock(&sys->lock);
+
+    return i_copy;
+}
+
+static int Seek(stream_t *stream, uint64_t offset)
+{
+    stream_sys_t *sys = stream->p_sys;
+
+    vlc_mutex_lock(&sys->lock);
+    sys->read_offset = offset;
+    if (offset < sys->size)
+    {
+        /* Reschedule the workers around the new position */
+        sys->next_chunk = offset / sys->chunk_size;
+        ChunkPrune(sys);
+        vlc_cond_broadcast(&sys->wait_space);
+    }
+    vlc_mutex_unlock(&sys->lock);
+    return VLC_SUCCESS;
+}
+
+static int Control(stream_t *stream, int query, va_list args)
+{
+    stream_sys_t *sys = stream->p_sys;
+
+    switch (query)
+    {
+        case STREAM_CAN_SEEK:
+        case STREAM_CAN_FASTSEEK:
+            *va_arg(args, bool *) = true;
+            break;
+        case STREAM_CAN_PAUSE:
+            *va_arg(args, bool *) = sys->can_pause;
+            break;
+        case STREAM_CAN_CONTROL_PACE:
+            *va_arg(args, bool *) = sys->can_pace;
+            break;
+        case STREAM_IS_DIRECTORY:
+            return VLC_EGENERIC;
+        case STREAM_GET_SIZE:
+            *va_arg(args, uint64_t *) = sys->size;
+            break;
+        case STREAM_GET_PTS_DELAY:
+            *va_arg(args, int64_t *) = sys->pts_delay;
+            break;
+        case STREAM_GET_TITLE_INFO:
+        case STREAM_GET_TITLE:
+        case STREAM_GET_SEEKPOINT:
+        case STREAM_GET_META:
+            return VLC_EGENERIC;
+        case STREAM_GET_CONTENT_TYPE:
+            if (sys->content_type == NULL)
+                return VLC_EGENERIC;
+            *va_arg(args, char **) = strdup(sys->content_type);
+            return VLC_SUCCESS;
+        case STREAM_GET_SIGNAL:
+            return VLC_EGENERIC;
+        case STREAM_SET_PAUSE_STATE:
+            break; /* The workers keep filling their window */
+        case STREAM_SET_TITLE:
+        case STREAM_SET_SEEKPOINT:
+        case STREAM_SET_PRIVATE_ID_STATE:
+        case STREAM_SET_PRIVATE_ID_CA:
+        case STREAM_GET_PRIVATE_ID_STATE:
+            return VLC_EGENERIC;
+        default:
+            msg_Err(stream, "unimplemented query (%d) in control", query);
+            return VLC_EGENERIC;
+    }
+    return VLC_SUCCESS;
+}
+
+static int Open(vlc_object_t *obj)
+{
+    stream_t *stream = (stream_t *)obj;
+    bool can_seek = false;
+    uint64_t size = 0;
+
+    /* Without the URL the workers cannot open their own connections */
+    if (stream->psz_url == NULL)
+        return VLC_EGENERIC;
+
+    /* Gate on range support: for HTTP, seekability with a known size means
+     * the server honours range requests */
+    stream_Control(stream->p_source, STREAM_CAN_SEEK, &can_seek);
+    if (!can_seek
+     || stream_Control(stream->p_source, STREAM_GET_SIZE, &size)
+     || size == 0)
+        return VLC_EGENERIC;
+
+    stream_sys_t *sys = malloc(sizeof (*sys));
+    if (unlikely(sys == NULL))
+        return VLC_ENOMEM;
+
+    sys->size = size;
+    sys->chunk_size = var_InheritInteger(obj, "parallel-chunk-size") << 10u;
+    sys->chunk_count = (size + sys->chunk_size - 1) / sys->chunk_size;
+    sys->worker_count = var_InheritInteger(obj, "parallel-connections");
+    if (sys->worker_count > sys->chunk_count)
+        sys->worker_count = sys->chunk_count;
+    sys->window = 2 * sys->worker_count;
+    sys->read_offset = 0;
+    sys->next_chunk = 0;
+    sys->chunks = NULL;
+    sys->killed = false;
+    sys->error = false;
+    sys->alive = 0;
+
+    stream_Control(stream->p_source, STREAM_CAN_PAUSE, &sys->can_pause);
+    stream_Control(stream->p_source, STREAM_CAN_CONTROL_PACE, &sys->can_pace);
+    stream_Control(stream->p_source, STREAM_GET_PTS_DELAY, &sys->pts_delay);
+    if (stream_Control(stream->p_source, STREAM_GET_CONTENT_TYPE,
+                       &sys->content_type))
+        sys->content_type = NULL;
+
+    sys->workers = calloc(sys->worker_count, sizeof (*sys->workers));
+    if (unlikely(sys->workers == NULL))
+    {
+        free(sys->content_type);
+        free(sys);
+        return VLC_ENOMEM;
+    }
+
+    vlc_mutex_init(&sys->lock);
+    vlc_cond_init(&sys->wait_data);
+    vlc_cond_init(&sys->wait_space);
+    stream->p_sys = sys;
+
+    for (unsigned i = 0; i < sys->worker_count; i++)
+    {
+        worker_t *worker = &sys->workers[i];
+
+        worker->stream = stream;
+        worker->interrupt = vlc_interrupt_create();
+        if (worker->interrupt == NULL)
+            break;
+        if (vlc_clone(&worker->thread, Worker, worker,
+                      VLC_THREAD_PRIORITY_LOW))
+        {
+            vlc_interrupt_destroy(worker->interrupt);
+            worker->interrupt = NULL;
+            break;
+        }
+        sys->alive++;
+    }
+
+    if (sys->alive == 0)
+    {
+        vlc_cond_destroy(&sys->wait_space);
+        vlc_cond_destroy(&sys->wait_data);
+        vlc_mutex_destroy(&sys->lock);
+        free(sys->workers);
+        free(sys->content_type);
+        free(sys);
+        return VLC_EGENERIC;
+    }
+
+    msg_Dbg(stream, "downloading %"PRIu64" bytes over %u connections, "
+            "%zu bytes chunks", size, sys->alive, sys->chunk_size);
+
+    stream->pf_read = Read;
+    stream->pf_seek = Seek;
+    stream->pf_control = Control;
+    return VLC_SUCCESS;
+}
+
+static void Close(vlc_object_t *obj)
+{
+    stream_t *stream = (stream_t *)obj;
+    stream_sys_t *sys = stream->p_sys;
+
+    vlc_mutex_lock(&sys->lock);
+    sys->killed = true;
+    vlc_cond_broadcast(&sys->wait_space);
+    vlc_mutex_unlock(&sys->lock);
+
+    for (unsigned i = 0; i < sys->worker_count; i++)
+    {
+        worker_t *worker = &sys->workers[i];
+
+        if (worker->interrupt == NULL)
+            continue;
+        vlc_interrupt_kill(worker->interrupt);
+        vlc_join(worker->thread, NULL);
+        vlc_interrupt_destroy(worker->interrupt);
+    }
+
+    for (chunk_t *c = sys->chunks, *next; c != NULL; c = next)
+    {
+        next = c->p_next;
+        free(c->p_data);
+        free(c);
+    }
+
+    vlc_cond_destroy(&sys->wait_space);
+    vlc_cond_destroy(&sys->wait_data);
+    vlc_mutex_destroy(&sys->lock);
+    free(sys->workers);
+    free(sys->content_type);
+    free(sys);
+}
+
+vlc_module_begin()
+    set_category(CAT_INPUT)
+    set_subcategory(SUBCAT_INPUT_STREAM_FILTER)
+    set_capability("stream_filter", 0)
+    add_shortcut("parallel")
+
+    set_description(N_("Segmented multi-connection download"))
+    set_callbacks(Open, Close)
+
+    add_integer("parallel-connections", 4, N_("Connections"),
+                N_("Number of parallel connections"), true)
+        change_integer_range(2, 16)
+    add_integer("parallel-chunk-size", 2048, N_("Chunk size"),
+                N_("Download chunk size (KiB)"), true)
+        change_integer_range(256, 1 << 16)
+vlc_module_end()
@@ -79,6 +79,7 @@ struct stream_sys_t
     size_t       buffer_size;
     char        *buffer;
     size_t       read_size;
+    size_t       read_size_min;
     size_t       seek_threshold;
 };
 
@@ -232,6 +233,11 @@ static void *Thread(void *data)
                     continue;
                 }
 
+                /* The buffer keeps filling up faster than it is drained:
+                 * back the read size off again. */
+                if (sys->read_size > sys->read_size_min)
+                    sys->read_size /= 2;
+
                 /* Wait for data to be read */
                 vlc_cond_wait(&sys->wait_space, &sys->lock);
                 continue;
@@ -331,6 +337,11 @@ static ssize_t Read(stream_t *stream, void *buf, size_t buflen)
             return -1;
         }
 
+        /* The reader failed to stay ahead of the consumer: enlarge the
+         * background reads so more data is in flight per iteration. */
+        if (sys->read_size < (sys->buffer_size / 2))
+            sys->read_size *= 2;
+
         vlc_interrupt_forward_start(sys->interrupt, data);
         vlc_cond_wait(&sys->wait_data, &sys->lock);
         vlc_interrupt_forward_stop(data);
@@ -477,6 +488,7 @@ static int Open(vlc_object_t *obj)
     }
     if (sys->buffer_size < sys->read_size)
         sys->buffer_size = sys->read_size;
+    sys->read_size_min = sys->read_size;
 
 #if !defined(_WIN32) && !defined(__OS2__)
     /* Round up to a multiple of the page size */
@@ -33,6 +33,7 @@
 #include <vlc_plugin.h>
 #include <vlc_sout.h>
 #include <vlc_block.h>
+#include <vlc_atomic.h>
 
 /*****************************************************************************
  * Module descriptor
@@ -78,6 +79,60 @@ struct sout_stream_id_sys_t
 
 static bool ESSelected( const es_format_t *fmt, char *psz_select );
 
+/*****************************************************************************
+ * Shared blocks: instead of copying the payload once per destination, each
+ * destination gets a lightweight block aliasing the original payload, and
+ * the original is released when the last alias is. The aliases are created
+ * with no head or tail room, so a downstream that resizes one (through
+ * block_Realloc()) gets a private copy and never touches the shared bytes.
+ * Downstreams of a sout chain treat the payload itself as read-only.
+ *****************************************************************************/
+typedef struct
+{
+    block_t     *p_block;   /* the original block, owner of the payload */
+    atomic_uint  refs;
+} shared_payload_t;
+
+typedef struct
+{
+    block_t          self;
+    shared_payload_t *p_shared;
+} shared_view_t;
+
+static void SharedRelease( shared_payload_t *p_shared )
+{
+    if( atomic_fetch_sub( &p_shared->refs, 1 ) == 1 )
+    {
+        block_Release( p_shared->p_block );
+        free( p_shared );
+    }
+}
+
+static void SharedViewRelease( block_t *p_block )
+{
+    shared_view_t *p_view = (shared_view_t *)p_block;
+
+    SharedRelease( p_view->p_shared );
+    free( p_view );
+}
+
+static block_t *SharedViewCreate( shared_payload_t *p_shared )
+{
+    shared_view_t *p_view = malloc( sizeof( *p_view ) );
+    if( !p_view )
+        return NULL;
+
+    block_t *p_src = p_shared->p_block;
+
+    block_Init( &p_view->self, p_src->p_buffer, p_src->i_buffer );
+    block_CopyProperties( &p_view->self, p_src );
+    p_view->self.pf_release = SharedViewRelease;
+    p_view->p_shared = p_shared;
+    atomic_fetch_add( &p_shared->refs, 1 );
+
+    return &p_view->self;
+}
+
 /*****************************************************************************
  * Open:
  *****************************************************************************/
@@ -271,31 +326,82 @@ static int Send( sout_stream_t *p_stream, sout_stream_id_sys_t *id,
     while( p_buffer )
     {
         block_t *p_next = p_buffer->p_next;
+        int i_last = -1;
 
         p_buffer->p_next = NULL;
 
-        for( i_stream = 0; i_stream < p_sys->i_nb_streams - 1; i_stream++ )
+        for( i_stream = 0; i_stream < p_sys->i_nb_streams; i_stream++ )
+        {
+            if( id->pp_ids[i_stream] )
+                i_last = i_stream;
+        }
+
+        if( i_last < 0 )
+        {
+            block_Release( p_buffer );
+            p_buffer = p_next;
+            continue;
+        }
+
+        shared_payload_t *p_shared = NULL;
+        for( i_stream = 0; i_stream < p_sys->i_nb_streams; i_stream++ )
         {
+            if( !id->pp_ids[i_stream] )
+                continue;
+
             p_dup_stream = p_sys->pp_streams[i_stream];
 
-            if( id->pp_ids[i_stream] )
+            if( i_stream == i_last )
             {
-                block_t *p_dup = block_Duplicate( p_buffer );
+                /* Sole (or last) destination: it gets the original block,
+                 * unless aliases of it are in flight */
+                if( p_shared == NULL )
+                {
+                    sout_StreamIdSend( p_dup_stream, id->pp_ids[i_stream],
+                                       p_buffer );
+                    p_buffer = NULL;
+                    break;
+                }
+
+                block_t *p_view = SharedViewCreate( p_shared );
+                if( p_view )
+                    sout_StreamIdSend( p_dup_stream, id->pp_ids[i_stream],
+                                       p_view );
+                break;
+            }
 
+            if( p_shared == NULL )
+            {
+                p_shared = malloc( sizeof( *p_shared ) );
+                if( p_shared )
+                {
+                    p_shared->p_block = p_buffer;
+                    atomic_init( &p_shared->refs, 1 );
+                }
+            }
+
+            if( p_shared != NULL )
+            {
+                block_t *p_view = SharedViewCreate( p_shared );
+                if( p_view )
+                    sout_StreamIdSend( p_dup_stream, id->pp_ids[i_stream],
+                                       p_view );
+            }
+            else
+            {
+                /* Out of memory: fall back to a plain copy */
+                block_t *p_dup = block_Duplicate( p_buffer );
                 if( p_dup )
-                    sout_StreamIdSend( p_dup_stream, id->pp_ids[i_stream], p_dup );
+                    sout_StreamIdSend( p_dup_stream, id->pp_ids[i_stream],
+                                       p_dup );
             }
         }
 
-        if( i_stream < p_sys->i_nb_streams && id->pp_ids[i_stream] )
-        {
-            p_dup_stream = p_sys->pp_streams[i_stream];
-            sout_StreamIdSend( p_dup_stream, id->pp_ids[i_stream], p_buffer );
-        }
-        else
-        {
+        if( p_shared != NULL )
+            SharedRelease( p_shared );   /* drops our reference; the original
+                                          * dies with the last alias */
+        else if( p_buffer != NULL )
             block_Release( p_buffer );
-        }
 
         p_buffer = p_next;
     }
@@ -51,6 +51,12 @@ static void     Close   ( vlc_object_t * );
 #define DST_PREFIX_LONGTEXT N_( \
     "Prefix of the destination file automatically generated" )
 
+#define MP4FRAG_TEXT N_("Use fragmented MP4")
+#define MP4FRAG_LONGTEXT N_( \
+    "Record MP4 using the fragmented muxer. Memory stays bounded however " \
+    "long the recording runs, and the file is playable up to the last " \
+    "written fragment if recording is interrupted." )
+
 #define SOUT_CFG_PREFIX "sout-record-"
 
 vlc_module_begin ()
@@ -64,13 +70,15 @@ vlc_module_begin ()
 
     add_string( SOUT_CFG_PREFIX "dst-prefix", "", DST_PREFIX_TEXT,
                 DST_PREFIX_LONGTEXT, true )
+    add_bool( SOUT_CFG_PREFIX "mp4frag", false, MP4FRAG_TEXT,
+              MP4FRAG_LONGTEXT, true )
 
     set_callbacks( Open, Close )
 vlc_module_end ()
 
 /* */
 static const char *const ppsz_sout_options[] = {
-    "dst-prefix",
+    "dst-prefix", "mp4frag",
     NULL
 };
 
@@ -79,6 +87,25 @@ static sout_stream_id_sys_t *Add( sout_stream_t *, const es_format_t * );
 static void              Del ( sout_stream_t *, sout_stream_id_sys_t * );
 static int               Send( sout_stream_t *, sout_stream_id_sys_t *, block_t* );
 
+/* Amount of the pre-start window kept in anonymous memory; the rest is
+ * spooled to a temporary file until the muxer is selected */
+#ifdef OPTIMIZE_MEMORY
+# define RECORD_SPOOL_THRESHOLD (256*1024)
+#else
+# define RECORD_SPOOL_THRESHOLD (4*1024*1024)
+#endif
+
+/* On-disk header in front of each spooled block */
+typedef struct
+{
+    uint32_t i_id;      /**< Index in the stream table */
+    uint32_t i_size;
+    uint32_t i_flags;
+    mtime_t  i_dts;
+    mtime_t  i_pts;
+    mtime_t  i_length;
+} spool_header_t;
+
 /* */
 struct sout_stream_id_sys_t
 {
@@ -91,6 +118,11 @@ struct sout_stream_id_sys_t
 
     bool b_wait_key;
     bool b_wait_start;
+
+    /* Tracked while buffering so OutputStart() does not need to scan
+     * spooled blocks: dts of the first block and of the first key frame */
+    mtime_t i_first_dts;
+    mtime_t i_key_dts;
 };
 
 struct sout_stream_sys_t
@@ -106,10 +138,22 @@ struct sout_stream_sys_t
     size_t      i_max_size;
 
     bool        b_drop;
+    bool        b_mp4frag;
 
     int              i_id;
     sout_stream_id_sys_t **id;
     mtime_t     i_dts_start;
+
+    /* Overflow of the pre-start window, spooled to a temporary file so
+     * memory stays flat at RECORD_SPOOL_THRESHOLD however long the muxer
+     * selection takes */
+    struct
+    {
+        FILE   *p_file;
+        char   *psz_file;
+        size_t  i_size;     /**< Bytes of payload spooled so far */
+        bool    b_error;    /**< Disk full or the like: window truncated */
+    } spool;
 };
 
 static void OutputStart( sout_stream_t *p_stream );
@@ -155,7 +199,12 @@ static int Open( vlc_object_t *p_this )
     p_sys->i_max_size = 20*1024*1024; /* 20 MiB */
 #endif
     p_sys->b_drop = false;
+    p_sys->b_mp4frag = var_GetBool( p_stream, SOUT_CFG_PREFIX "mp4frag" );
     p_sys->i_dts_start = 0;
+    p_sys->spool.p_file = NULL;
+    p_sys->spool.psz_file = NULL;
+    p_sys->spool.i_size = 0;
+    p_sys->spool.b_error = false;
     TAB_INIT( p_sys->i_id, p_sys->id );
 
     return VLC_SUCCESS;
@@ -172,6 +221,13 @@ static void Close( vlc_object_t * p_this )
     if( p_sys->p_out )
         sout_StreamChainDelete( p_sys->p_out, p_sys->p_out );
 
+    if( p_sys->spool.p_file )
+    {
+        fclose( p_sys->spool.p_file );
+        vlc_unlink( p_sys->spool.psz_file );
+        free( p_sys->spool.psz_file );
+    }
+
     TAB_CLEAN( p_sys->i_id, p_sys->id );
     free( p_sys->psz_prefix );
     free( p_sys );
@@ -195,6 +251,8 @@ static sout_stream_id_sys_t *Add( sout_stream_t *p_stream, const es_format_t *p_
     id->id = NULL;
     id->b_wait_key = true;
     id->b_wait_start = true;
+    id->i_first_dts = -1;
+    id->i_key_dts = -1;
 
     TAB_APPEND( p_sys->i_id, p_sys->id, id );
 
@@ -371,6 +429,136 @@ error:
 
 }
 
+static int SpoolOpen( sout_stream_t *p_stream )
+{
+    sout_stream_sys_t *p_sys = p_stream->p_sys;
+    char *psz_file = strdup( DIR_SEP"tmp"DIR_SEP PACKAGE_NAME"-record.XXXXXX" );
+
+    if( unlikely(psz_file == NULL) )
+        return VLC_EGENERIC;
+
+    int fd = vlc_mkstemp( psz_file );
+    if( fd == -1 )
+    {
+        free( psz_file );
+        return VLC_EGENERIC;
+    }
+
+    p_sys->spool.p_file = fdopen( fd, "w+b" );
+    if( p_sys->spool.p_file == NULL )
+    {
+        close( fd );
+        vlc_unlink( psz_file );
+        free( psz_file );
+        return VLC_EGENERIC;
+    }
+    p_sys->spool.psz_file = psz_file;
+
+    msg_Dbg( p_stream, "spooling pre-record window to %s", psz_file );
+    return VLC_SUCCESS;
+}
+
+static void SpoolClose( sout_stream_sys_t *p_sys )
+{
+    fclose( p_sys->spool.p_file );
+    vlc_unlink( p_sys->spool.psz_file );
+    free( p_sys->spool.psz_file );
+    p_sys->spool.p_file = NULL;
+    p_sys->spool.psz_file = NULL;
+    p_sys->spool.i_size = 0;
+}
+
+/* Appends a pre-start block chain to the spool file and releases it.
+ * On a write error the window is truncated: the offending blocks are
+ * dropped, since replaying them out of order would confuse the muxer. */
+static void SpoolWrite( sout_stream_t *p_stream, sout_stream_id_sys_t *id,
+                        block_t *p_block )
+{
+    sout_stream_sys_t *p_sys = p_stream->p_sys;
+    uint32_t i_index = 0;
+
+    while( p_sys->id[i_index] != id )
+        i_index++;
+
+    if( p_sys->spool.p_file == NULL && !p_sys->spool.b_error
+     && SpoolOpen( p_stream ) )
+    {
+        msg_Warn( p_stream, "cannot spool pre-record window, truncating it" );
+        p_sys->spool.b_error = true;
+    }
+
+    while( p_block )
+    {
+        block_t *p_next = p_block->p_next;
+
+        if( !p_sys->spool.b_error )
+        {
+            spool_header_t header = {
+                .i_id     = i_index,
+                .i_size   = p_block->i_buffer,
+                .i_flags  = p_block->i_flags,
+                .i_dts    = p_block->i_dts,
+                .i_pts    = p_block->i_pts,
+                .i_length = p_block->i_length,
+            };
+
+            if( fwrite( &header, sizeof(header), 1,
+                        p_sys->spool.p_file ) != 1
+             || fwrite( p_block->p_buffer, p_block->i_buffer, 1,
+                        p_sys->spool.p_file ) != 1 )
+            {
+                msg_Warn( p_stream, "pre-record spool write failed, "
+                          "truncating the window" );
+                p_sys->spool.b_error = true;
+            }
+            else
+                p_sys->spool.i_size += p_block->i_buffer;
+        }
+
+        if( p_sys->spool.b_error )
+            p_sys->i_size -= p_block->i_buffer;
+
+        block_Release( p_block );
+        p_block = p_next;
+    }
+}
+
+/* Replays the spooled part of the window. It was written after the
+ * in-memory chains, so it is sent after them. */
+static void SpoolReplay( sout_stream_t *p_stream )
+{
+    sout_stream_sys_t *p_sys = p_stream->p_sys;
+    spool_header_t header;
+
+    rewind( p_sys->spool.p_file );
+    while( fread( &header, sizeof(header), 1, p_sys->spool.p_file ) == 1 )
+    {
+        if( header.i_id >= (uint32_t)p_sys->i_id )
+            break;
+
+        block_t *p_block = block_Alloc( header.i_size );
+        if( p_block == NULL )
+            break;
+        if( fread( p_block->p_buffer, header.i_size, 1,
+                   p_sys->spool.p_file ) != 1 )
+        {
+            block_Release( p_block );
+            break;
+        }
+        p_block->i_flags  = header.i_flags;
+        p_block->i_dts    = header.i_dts;
+        p_block->i_pts    = header.i_pts;
+        p_block->i_length = header.i_length;
+
+        sout_stream_id_sys_t *id = p_sys->id[header.i_id];
+        if( id->id )
+            OutputSend( p_stream, id, p_block );
+        else
+            block_Release( p_block );
+    }
+    SpoolClose( p_sys );
+}
+
 static void OutputStart( sout_stream_t *p_stream )
 {
     sout_stream_sys_t *p_sys = p_stream->p_sys;
@@ -494,6 +682,11 @@ static void OutputStart( sout_stream_t *p_stream )
                  psz_muxer, psz_extension, i_best_es, p_sys->i_id );
     }
 
+    /* The fragmented muxer keeps memory flat and leaves a playable file
+     * up to the last flushed fragment should the recording be cut short */
+    if( p_sys->b_mp4frag && !strcmp( psz_muxer, "mp4" ) )
+        psz_muxer = "mp4frag";
+
     /* Create the output */
     if( OutputNew( p_stream, psz_muxer, p_sys->psz_prefix, psz_extension ) < 0 )
     {
@@ -501,26 +694,17 @@ static void OutputStart( sout_stream_t *p_stream )
         return;
     }
 
-    /* Compute highest timestamp of first I over all streams */
+    /* Compute highest timestamp of first I over all streams. Tracked at
+     * buffering time (see OutputSend()), so spooled blocks count too. */
     p_sys->i_dts_start = 0;
     for( int i = 0; i < p_sys->i_id; i++ )
     {
         sout_stream_id_sys_t *id = p_sys->id[i];
-        block_t *p_block;
 
-        if( !id->id || !id->p_first )
+        if( !id->id || id->i_first_dts < 0 )
             continue;
 
-        mtime_t i_dts = id->p_first->i_dts;
-        for( p_block = id->p_first; p_block != NULL; p_block = p_block->p_next )
-        {
-            if( p_block->i_flags & BLOCK_FLAG_TYPE_I )
-            {
-                i_dts = p_block->i_dts;
-                break;
-            }
-        }
-
+        mtime_t i_dts = id->i_key_dts >= 0 ? id->i_key_dts : id->i_first_dts;
         if( i_dts > p_sys->i_dts_start )
             p_sys->i_dts_start = i_dts;
     }
@@ -548,6 +732,9 @@ static void OutputStart( sout_stream_t *p_stream )
         id->p_first = NULL;
         id->pp_last = &id->p_first;
     }
+
+    if( p_sys->spool.p_file )
+        SpoolReplay( p_stream );
 }
 
 static void OutputSend( sout_stream_t *p_stream, sout_stream_id_sys_t *id, block_t *p_block )
@@ -589,7 +776,22 @@ static void OutputSend( sout_stream_t *p_stream, sout_stream_id_sys_t *id, block
 
         block_ChainProperties( p_block, NULL, &i_size, NULL );
         p_sys->i_size += i_size;
-        block_ChainLastAppend( &id->pp_last, p_block );
+
+        for( block_t *p = p_block; p != NULL; p = p->p_next )
+        {
+            if( id->i_first_dts < 0 )
+                id->i_first_dts = p->i_dts;
+            if( id->i_key_dts < 0 && ( p->i_flags & BLOCK_FLAG_TYPE_I ) )
+                id->i_key_dts = p->i_dts;
+        }
+
+        /* Keep memory flat: beyond the threshold, the window overflows
+         * to the spool file */
+        if( p_sys->i_size - p_sys->spool.i_size > RECORD_SPOOL_THRESHOLD
+         || p_sys->spool.p_file != NULL || p_sys->spool.b_error )
+            SpoolWrite( p_stream, id, p_block );
+        else
+            block_ChainLastAppend( &id->pp_last, p_block );
     }
 }
 
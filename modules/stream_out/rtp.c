@@ -140,6 +140,19 @@
     "Default caching value for outbound RTP streams. This " \
     "value should be set in milliseconds." )
 
+#define BATCH_TEXT N_("Send batch size")
+#define BATCH_LONGTEXT N_( \
+    "Maximum number of overdue RTP packets sent per system call, on " \
+    "systems that support batched transmission. Packets are never sent " \
+    "ahead of their schedule." )
+
+#define TXTIME_TEXT N_("Kernel packet pacing")
+#define TXTIME_LONGTEXT N_( \
+    "Stamp each RTP packet with its transmit deadline and let the kernel " \
+    "release it on the wire at that exact time (Linux SO_TXTIME, requires " \
+    "an fq or etf queueing discipline on the interface). This smooths out " \
+    "the bursts caused by scheduler wakeup jitter on high bitrate streams." )
+
 #define PROTO_TEXT N_("Transport protocol")
 #define PROTO_LONGTEXT N_( \
     "This selects which transport protocol to use for RTP." )
@@ -231,6 +244,11 @@ vlc_module_begin ()
               RTCP_MUX_TEXT, RTCP_MUX_LONGTEXT, false )
     add_integer( SOUT_CFG_PREFIX "caching", DEFAULT_PTS_DELAY / 1000,
                  CACHING_TEXT, CACHING_LONGTEXT, true )
+    add_integer( SOUT_CFG_PREFIX "batch", 8,
+                 BATCH_TEXT, BATCH_LONGTEXT, true )
+        change_integer_range( 1, 32 )
+    add_bool( SOUT_CFG_PREFIX "txtime", false,
+              TXTIME_TEXT, TXTIME_LONGTEXT, true )
 
 #ifdef HAVE_SRTP
     add_string( SOUT_CFG_PREFIX "key", "",
@@ -267,7 +285,7 @@ vlc_module_end ()
 static const char *const ppsz_sout_options[] = {
     "dst", "name", "cat", "port", "port-audio", "port-video", "*sdp", "ttl",
     "mux", "sap", "description", "url", "email", "phone",
-    "proto", "rtcp-mux", "caching",
+    "proto", "rtcp-mux", "caching", "batch", "txtime",
 #ifdef HAVE_SRTP
     "key", "salt",
 #endif
@@ -389,6 +407,8 @@ struct sout_stream_id_sys_t
 
     block_fifo_t     *p_fifo;
     int64_t           i_caching;
+    unsigned          i_batch;
+    bool              b_txtime;
 };
 
 /*****************************************************************************
@@ -985,6 +1005,8 @@ static sout_stream_id_sys_t *Add( sout_stream_t *p_stream,
     id->b_first_packet = true;
     id->i_caching =
         (int64_t)1000 * var_GetInteger( p_stream, SOUT_CFG_PREFIX "caching");
+    id->i_batch = var_GetInteger( p_stream, SOUT_CFG_PREFIX "batch" );
+    id->b_txtime = var_GetBool( p_stream, SOUT_CFG_PREFIX "txtime" );
 
     vlc_rand_bytes (&id->i_sequence, sizeof (id->i_sequence));
     vlc_rand_bytes (id->ssrc, sizeof (id->ssrc));
@@ -1403,10 +1425,24 @@ static void* ThreadSend( void *data )
 #endif
     sout_stream_id_sys_t *id = data;
     unsigned i_caching = id->i_caching;
+    block_t *outv[id->i_batch];
+    block_t *next = NULL; /* Packet dequeued ahead of its send time */
 
     for (;;)
     {
-        block_t *out = block_FifoGet( id->p_fifo );
+        block_t *out;
+        /* With kernel pacing, packets are handed over up to this much
+         * ahead of schedule: the socket releases each of them on its own
+         * deadline, without userland wakeup jitter. */
+        mtime_t i_horizon = id->b_txtime ? (CLOCK_FREQ / 50) : 0;
+
+        if (next != NULL)
+        {
+            out = next;
+            next = NULL;
+        }
+        else
+            out = block_FifoGet( id->p_fifo );
         block_cleanup_push (out);
 
 #ifdef HAVE_SRTP
@@ -1430,18 +1466,48 @@ static void* ThreadSend( void *data )
                 out->i_buffer = len;
         }
         if (out)
-            mwait (out->i_dts + i_caching);
+            mwait (out->i_dts + i_caching - i_horizon);
         vlc_cleanup_pop ();
         if (out == NULL)
             continue;
 #else
-        mwait (out->i_dts + i_caching);
+        mwait (out->i_dts + i_caching - i_horizon);
         vlc_cleanup_pop ();
 #endif
 
-        ssize_t len = out->i_buffer;
         int canc = vlc_savecancel ();
 
+        unsigned outc = 1;
+        outv[0] = out;
+
+        /* Gather the packets which are already overdue, so that each sink
+         * gets the backlog in batched system calls. Packets are never sent
+         * ahead of their schedule. */
+#ifdef HAVE_SRTP
+        if( !id->srtp ) /* FIXME: no batching for SRTP */
+#endif
+        {
+            mtime_t now = mdate ();
+
+            while( outc < id->i_batch )
+            {
+                vlc_fifo_Lock( id->p_fifo );
+                next = vlc_fifo_DequeueUnlocked( id->p_fifo );
+                vlc_fifo_Unlock( id->p_fifo );
+                if( next == NULL )
+                    break;
+                if( next->i_dts + i_caching > now + i_horizon )
+                    break; /* Not due yet: keep it for the next round */
+                outv[outc++] = next;
+                next = NULL;
+            }
+        }
+
+        mtime_t deadlines[outc];
+        if( id->b_txtime )
+            for( unsigned j = 0; j < outc; j++ )
+                deadlines[j] = outv[j]->i_dts + i_caching;
+
         vlc_mutex_lock( &id->lock_sink );
         unsigned deadc = 0; /* How many dead sockets? */
         int deadv[id->sinkc]; /* Dead sockets list */
@@ -1451,26 +1517,44 @@ static void* ThreadSend( void *data )
 #ifdef HAVE_SRTP
             if( !id->srtp ) /* FIXME: SRTCP support */
 #endif
-                SendRTCP( id->sinkv[i].rtcp, out );
+                for( unsigned j = 0; j < outc; j++ )
+                    SendRTCP( id->sinkv[i].rtcp, outv[j] );
 
-            if( send( id->sinkv[i].rtp_fd, out->p_buffer, len, 0 ) == -1
-             && net_errno != EAGAIN && net_errno != EWOULDBLOCK
-             && net_errno != ENOBUFS && net_errno != ENOMEM )
+            for( unsigned j = 0; j < outc; )
             {
-                int type;
-                getsockopt( id->sinkv[i].rtp_fd, SOL_SOCKET, SO_TYPE,
-                            &type, &(socklen_t){ sizeof(type) });
-                if( type == SOCK_DGRAM )
+                ssize_t sent = id->b_txtime
+                    ? net_SendDgramsAt( id->sinkv[i].rtp_fd,
+                                        outv + j, outc - j, deadlines + j )
+                    : net_SendDgrams( id->sinkv[i].rtp_fd,
+                                      outv + j, outc - j );
+                if( sent > 0 )
+                {
+                    j += sent;
+                    continue;
+                }
+                if( net_errno != EAGAIN && net_errno != EWOULDBLOCK
+                 && net_errno != ENOBUFS && net_errno != ENOMEM )
+                {
+                    int type;
+                    getsockopt( id->sinkv[i].rtp_fd, SOL_SOCKET, SO_TYPE,
+                                &type, &(socklen_t){ sizeof(type) });
+                    if( type != SOCK_DGRAM )
+                    {   /* Broken connection */
+                        deadv[deadc++] = id->sinkv[i].rtp_fd;
+                        break;
+                    }
                     /* ICMP soft error: ignore and retry */
-                    send( id->sinkv[i].rtp_fd, out->p_buffer, len, 0 );
-                else
-                    /* Broken connection */
-                    deadv[deadc++] = id->sinkv[i].rtp_fd;
+                    net_SendDgrams( id->sinkv[i].rtp_fd, outv + j, 1 );
+                }
+                j++; /* Skip the failed packet */
             }
         }
-        id->i_seq_sent_next = ntohs(((uint16_t *) out->p_buffer)[1]) + 1;
+        id->i_seq_sent_next =
+            ntohs(((uint16_t *) outv[outc - 1]->p_buffer)[1]) + 1;
         vlc_mutex_unlock( &id->lock_sink );
-        block_Release( out );
+
+        for( unsigned j = 0; j < outc; j++ )
+            block_Release( outv[j] );
 
         for( unsigned i = 0; i < deadc; i++ )
         {
@@ -1513,6 +1597,12 @@ int rtp_add_sink( sout_stream_id_sys_t *id, int fd, bool rtcp_mux, uint16_t *seq
         msg_Err( id->p_stream, "RTCP failed!" );
 
     vlc_mutex_lock( &id->lock_sink );
+    if( id->b_txtime && net_SetDgramTxTime( fd ) )
+    {
+        msg_Warn( id->p_stream, "transmit time pacing unavailable: %s",
+                  vlc_strerror_c(net_errno) );
+        id->b_txtime = false;
+    }
     INSERT_ELEM( id->sinkv, id->sinkc, id->sinkc, sink );
     if( seq != NULL )
         *seq = id->i_seq_sent_next;
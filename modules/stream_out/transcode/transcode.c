@@ -127,6 +127,11 @@
 #define THREADS_TEXT N_("Number of threads")
 #define THREADS_LONGTEXT N_( \
     "Number of threads used for the transcoding." )
+#define QUEUE_TEXT N_("Picture queue size")
+#define QUEUE_LONGTEXT N_( \
+    "Maximum number of decoded pictures queued towards the encoder thread. " \
+    "When the queue is full, decoding waits for the encoder to catch up " \
+    "instead of queueing without bound." )
 #define HP_TEXT N_("High priority")
 #define HP_LONGTEXT N_( \
     "Runs the optional encoder thread at the OUTPUT priority instead of " \
@@ -216,6 +221,9 @@ vlc_module_begin ()
     set_section( N_("Miscellaneous"), NULL )
     add_integer( SOUT_CFG_PREFIX "threads", 0, THREADS_TEXT,
                  THREADS_LONGTEXT, true )
+    add_integer( SOUT_CFG_PREFIX "queue-size", 10, QUEUE_TEXT,
+                 QUEUE_LONGTEXT, true )
+        change_integer_range( 1, 256 )
     add_bool( SOUT_CFG_PREFIX "high-priority", false, HP_TEXT, HP_LONGTEXT,
               true )
 
@@ -224,7 +232,7 @@ vlc_module_end ()
 static const char *const ppsz_sout_options[] = {
     "venc", "vcodec", "vb",
     "scale", "fps", "width", "height", "vfilter", "deinterlace",
-    "deinterlace-module", "threads", "aenc", "acodec", "ab", "alang",
+    "deinterlace-module", "threads", "queue-size", "aenc", "acodec", "ab", "alang",
     "afilter", "samplerate", "channels", "senc", "scodec", "soverlay",
     "sfilter", "osd", "high-priority", "maxwidth", "maxheight",
     NULL
@@ -374,6 +382,9 @@ static int Open( vlc_object_t *p_this )
     free( psz_string );
 
     p_sys->i_threads = var_GetInteger( p_stream, SOUT_CFG_PREFIX "threads" );
+    p_sys->i_max_pics = var_GetInteger( p_stream, SOUT_CFG_PREFIX "queue-size" );
+    p_sys->b_drop_phase = false;
+    p_sys->i_dropped_pics = 0;
     p_sys->b_high_priority = var_GetBool( p_stream, SOUT_CFG_PREFIX "high-priority" );
 
     if( p_sys->i_vcodec )
@@ -20,6 +20,11 @@ struct sout_stream_sys_t
     block_t         *p_buffers;
     vlc_mutex_t     lock_out;
     vlc_cond_t      cond;
+    vlc_cond_t      cond_full;
+    unsigned        i_pending_pics;
+    unsigned        i_max_pics;
+    bool            b_drop_phase;
+    unsigned        i_dropped_pics;
     bool            b_abort;
     picture_fifo_t *pp_pics;
     vlc_thread_t    thread;
@@ -84,6 +84,8 @@ static void* EncoderThread( void *obj )
 
         if( p_pic )
         {
+            p_sys->i_pending_pics--;
+            vlc_cond_signal( &p_sys->cond_full );
             /* release lock while encoding */
             vlc_mutex_unlock( &p_sys->lock_out );
             p_block = id->p_encoder->pf_encode_video( id->p_encoder, p_pic );
@@ -100,6 +102,7 @@ static void* EncoderThread( void *obj )
     /*Encode what we have in the buffer on closing*/
     while( (p_pic = picture_fifo_Pop( p_sys->pp_pics )) != NULL )
     {
+        p_sys->i_pending_pics--;
         p_block = id->p_encoder->pf_encode_video( id->p_encoder, p_pic );
         picture_Release( p_pic );
         block_ChainAppend( &p_sys->p_buffers, p_block );
@@ -228,13 +231,16 @@ int transcode_video_new( sout_stream_t *p_stream, sout_stream_id_sys_t *id )
     }
     vlc_mutex_init( &p_sys->lock_out );
     vlc_cond_init( &p_sys->cond );
+    vlc_cond_init( &p_sys->cond_full );
     p_sys->p_buffers = NULL;
     p_sys->b_abort = false;
+    p_sys->i_pending_pics = 0;
     if( vlc_clone( &p_sys->thread, EncoderThread, p_sys, i_priority ) )
     {
         msg_Err( p_stream, "cannot spawn encoder thread" );
         vlc_mutex_destroy( &p_sys->lock_out );
         vlc_cond_destroy( &p_sys->cond );
+        vlc_cond_destroy( &p_sys->cond_full );
         picture_fifo_Delete( p_sys->pp_pics );
         module_unneed( id->p_decoder, id->p_decoder->p_module );
         id->p_decoder->p_module = NULL;
@@ -590,6 +596,7 @@ void transcode_video_close( sout_stream_t *p_stream,
 
     vlc_mutex_destroy( &p_stream->p_sys->lock_out );
     vlc_cond_destroy( &p_stream->p_sys->cond );
+    vlc_cond_destroy( &p_stream->p_sys->cond_full );
 
     /* Close decoder */
     if( id->p_decoder->p_module )
@@ -668,7 +675,31 @@ static void OutputFrame( sout_stream_t *p_stream, picture_t *p_pic, sout_stream_
     if( p_sys->i_threads )
     {
         vlc_mutex_lock( &p_sys->lock_out );
+        if( !p_sys->b_abort && !p_pic->b_force &&
+            p_sys->i_pending_pics >= p_sys->i_max_pics )
+        {
+            /* The encoder cannot keep up: shed every other unforced
+             * picture so the output degrades to a lower but steady frame
+             * rate instead of stalling the pipeline and then losing a
+             * burst. Forced pictures seed key frames and are kept. */
+            p_sys->b_drop_phase = !p_sys->b_drop_phase;
+            if( p_sys->b_drop_phase )
+            {
+                if( ( p_sys->i_dropped_pics++ % 100 ) == 0 )
+                    msg_Warn( p_stream, "video encoder overloaded, "
+                              "%u pictures dropped so far",
+                              p_sys->i_dropped_pics );
+                vlc_mutex_unlock( &p_sys->lock_out );
+                picture_Release( p_pic );
+                return;
+            }
+        }
+        /* Backpressure: when the encoder lags behind, wait for it to
+         * catch up instead of queueing pictures without bound */
+        while( !p_sys->b_abort && p_sys->i_pending_pics >= p_sys->i_max_pics )
+            vlc_cond_wait( &p_sys->cond_full, &p_sys->lock_out );
         picture_fifo_Push( p_sys->pp_pics, p_pic );
+        p_sys->i_pending_pics++;
         vlc_cond_signal( &p_sys->cond );
         vlc_mutex_unlock( &p_sys->lock_out );
     }
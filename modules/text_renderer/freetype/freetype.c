@@ -1200,6 +1200,7 @@ static int Create( vlc_object_t *p_this )
     vlc_dictionary_init( &p_sys->face_map, 50 );
     vlc_dictionary_init( &p_sys->family_map, 50 );
     vlc_dictionary_init( &p_sys->fallback_map, 20 );
+    vlc_dictionary_init( &p_sys->glyph_map, 500 );
 
     p_sys->i_scale = 100;
 
@@ -1337,6 +1338,9 @@ static void Destroy( vlc_object_t *p_this )
     text_style_Delete( p_sys->p_default_style );
     text_style_Delete( p_sys->p_forced_style );
 
+    /* Glyph cache */
+    vlc_dictionary_clear( &p_sys->glyph_map, FreeGlyphCacheEntry, NULL );
+
     /* Fonts dicts */
     vlc_dictionary_clear( &p_sys->fallback_map, FreeFamilies, p_filter );
     vlc_dictionary_clear( &p_sys->face_map, FreeFace, p_filter );
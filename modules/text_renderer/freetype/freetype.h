@@ -111,6 +111,15 @@ struct filter_sys_t
     /** Font face cache */
     vlc_dictionary_t  face_map;
 
+    /**
+     * Cache of loaded and synthesized glyph outlines, keyed by face,
+     * style and glyph index. It is filled and read by LoadGlyphs() and
+     * makes rolling subtitle updates cheap: only glyphs never seen
+     * before have to be loaded, hinted and stroked again.
+     */
+    vlc_dictionary_t  glyph_map;
+    int               i_glyph_map_length;
+
     int               i_fallback_counter;
 
     /* Current scaling of the text, default is 100 (%) */
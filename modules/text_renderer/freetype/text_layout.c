@@ -161,6 +161,36 @@ typedef struct paragraph_t
 
 } paragraph_t;
 
+/**
+ * Cached result of loading, emboldening/obliquing and stroking a glyph.
+ * Rendering to a bitmap is still done on every layout, as it depends on
+ * the subpixel pen position, but those earlier, more expensive steps are
+ * shared between subtitle updates. The advance values are the ones
+ * reported by the face after loading, in 26.6 units.
+ */
+typedef struct glyph_cache_entry_t
+{
+    FT_Glyph p_glyph;
+    FT_Glyph p_outline;
+    FT_Pos   i_x_advance;
+    FT_Pos   i_y_advance;
+} glyph_cache_entry_t;
+
+/* Flush the cache entirely when it grows beyond this, to bound the memory
+ * used by pathological streams cycling through styles and faces */
+#define GLYPH_CACHE_MAX_ENTRIES 4096
+
+void FreeGlyphCacheEntry( void *p_value, void *p_obj )
+{
+    glyph_cache_entry_t *p_entry = p_value;
+    VLC_UNUSED( p_obj );
+
+    FT_Done_Glyph( p_entry->p_glyph );
+    if( p_entry->p_outline )
+        FT_Done_Glyph( p_entry->p_outline );
+    free( p_entry );
+}
+
 static void FreeLine( line_desc_t *p_line )
 {
     for( int i = 0; i < p_line->i_character_count; i++ )
@@ -957,12 +987,13 @@ static int LoadGlyphs( filter_t *p_filter, paragraph_t *p_paragraph,
         else
             p_face = p_run->p_face;
 
+        int i_radius = 0;
         if( p_sys->p_stroker && (p_style->i_style_flags & STYLE_OUTLINE) )
         {
             double f_outline_thickness =
                 var_InheritInteger( p_filter, "freetype-outline-thickness" ) / 100.0;
             f_outline_thickness = VLC_CLIP( f_outline_thickness, 0.0, 0.5 );
-            int i_radius = ( i_live_size << 6 ) * f_outline_thickness;
+            i_radius = ( i_live_size << 6 ) * f_outline_thickness;
             FT_Stroker_Set( p_sys->p_stroker,
                             i_radius,
                             FT_STROKER_LINECAP_ROUND,
@@ -1019,39 +1050,94 @@ static int LoadGlyphs( filter_t *p_filter, paragraph_t *p_paragraph,
                     SKIP_GLYPH( p_bitmaps )
             }
 
-            if( FT_Load_Glyph( p_face, i_glyph_index,
-                               FT_LOAD_NO_BITMAP | FT_LOAD_DEFAULT )
-             && FT_Load_Glyph( p_face, i_glyph_index, FT_LOAD_DEFAULT ) )
-                SKIP_GLYPH( p_bitmaps )
+            /* The face pointer identifies the font file, the face index
+             * and the pixel size, see LoadFace() */
+            char psz_key[64];
+            snprintf( psz_key, sizeof( psz_key ), "%p - %x - %d - %d",
+                      (void *)p_face,
+                      p_style->i_style_flags &
+                          ( STYLE_BOLD | STYLE_ITALIC | STYLE_OUTLINE ),
+                      i_radius, i_glyph_index );
+
+            FT_Pos i_x_advance;
+            FT_Pos i_y_advance;
+            glyph_cache_entry_t *p_cached =
+                vlc_dictionary_value_for_key( &p_sys->glyph_map, psz_key );
+            if( p_cached != kVLCDictionaryNotFound )
+            {
+                if( FT_Glyph_Copy( p_cached->p_glyph, &p_bitmaps->p_glyph ) )
+                    SKIP_GLYPH( p_bitmaps )
+
+                if( p_cached->p_outline
+                 && FT_Glyph_Copy( p_cached->p_outline, &p_bitmaps->p_outline ) )
+                    p_bitmaps->p_outline = 0;
+
+                i_x_advance = p_cached->i_x_advance;
+                i_y_advance = p_cached->i_y_advance;
+            }
+            else
+            {
+                if( FT_Load_Glyph( p_face, i_glyph_index,
+                                   FT_LOAD_NO_BITMAP | FT_LOAD_DEFAULT )
+                 && FT_Load_Glyph( p_face, i_glyph_index, FT_LOAD_DEFAULT ) )
+                    SKIP_GLYPH( p_bitmaps )
+
+                if( ( p_style->i_style_flags & STYLE_BOLD )
+                      && !( p_face->style_flags & FT_STYLE_FLAG_BOLD ) )
+                    FT_GlyphSlot_Embolden( p_face->glyph );
+                if( ( p_style->i_style_flags & STYLE_ITALIC )
+                      && !( p_face->style_flags & FT_STYLE_FLAG_ITALIC ) )
+                    FT_GlyphSlot_Oblique( p_face->glyph );
 
-            if( ( p_style->i_style_flags & STYLE_BOLD )
-                  && !( p_face->style_flags & FT_STYLE_FLAG_BOLD ) )
-                FT_GlyphSlot_Embolden( p_face->glyph );
-            if( ( p_style->i_style_flags & STYLE_ITALIC )
-                  && !( p_face->style_flags & FT_STYLE_FLAG_ITALIC ) )
-                FT_GlyphSlot_Oblique( p_face->glyph );
+                if( FT_Get_Glyph( p_face->glyph, &p_bitmaps->p_glyph ) )
+                    SKIP_GLYPH( p_bitmaps )
 
-            if( FT_Get_Glyph( p_face->glyph, &p_bitmaps->p_glyph ) )
-                SKIP_GLYPH( p_bitmaps )
+                if( p_filter->p_sys->p_stroker && (p_style->i_style_flags & STYLE_OUTLINE) )
+                {
+                    p_bitmaps->p_outline = p_bitmaps->p_glyph;
+                    if( FT_Glyph_StrokeBorder( &p_bitmaps->p_outline,
+                                               p_filter->p_sys->p_stroker, 0, 0 ) )
+                        p_bitmaps->p_outline = 0;
+                }
 
-#undef SKIP_GLYPH
+                i_x_advance = p_face->glyph->advance.x;
+                i_y_advance = p_face->glyph->advance.y;
 
-            if( p_filter->p_sys->p_stroker && (p_style->i_style_flags & STYLE_OUTLINE) )
-            {
-                p_bitmaps->p_outline = p_bitmaps->p_glyph;
-                if( FT_Glyph_StrokeBorder( &p_bitmaps->p_outline,
-                                           p_filter->p_sys->p_stroker, 0, 0 ) )
-                    p_bitmaps->p_outline = 0;
+                if( p_sys->i_glyph_map_length >= GLYPH_CACHE_MAX_ENTRIES )
+                {
+                    vlc_dictionary_clear( &p_sys->glyph_map,
+                                          FreeGlyphCacheEntry, NULL );
+                    p_sys->i_glyph_map_length = 0;
+                }
+
+                glyph_cache_entry_t *p_entry = malloc( sizeof( *p_entry ) );
+                if( p_entry
+                 && !FT_Glyph_Copy( p_bitmaps->p_glyph, &p_entry->p_glyph ) )
+                {
+                    p_entry->p_outline = 0;
+                    if( p_bitmaps->p_outline
+                     && FT_Glyph_Copy( p_bitmaps->p_outline,
+                                       &p_entry->p_outline ) )
+                        p_entry->p_outline = 0;
+                    p_entry->i_x_advance = i_x_advance;
+                    p_entry->i_y_advance = i_y_advance;
+                    vlc_dictionary_insert( &p_sys->glyph_map, psz_key, p_entry );
+                    p_sys->i_glyph_map_length++;
+                }
+                else
+                    free( p_entry );
             }
 
+#undef SKIP_GLYPH
+
             if( p_style->i_shadow_alpha != STYLE_ALPHA_TRANSPARENT )
                 p_bitmaps->p_shadow = p_bitmaps->p_outline ?
                                       p_bitmaps->p_outline : p_bitmaps->p_glyph;
 
             if( b_overwrite_advance )
             {
-                p_bitmaps->i_x_advance = p_face->glyph->advance.x;
-                p_bitmaps->i_y_advance = p_face->glyph->advance.y;
+                p_bitmaps->i_x_advance = i_x_advance;
+                p_bitmaps->i_y_advance = i_y_advance;
             }
         }
 
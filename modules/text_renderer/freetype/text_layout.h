@@ -62,6 +62,12 @@ struct line_desc_t
 void FreeLines( line_desc_t *p_lines );
 line_desc_t *NewLine( int i_count );
 
+/**
+ * Release an entry of the glyph cache \ref filter_sys_t.glyph_map.
+ * Meant to be passed to vlc_dictionary_clear().
+ */
+void FreeGlyphCacheEntry( void *p_value, void *p_obj );
+
 /**
  * Layout the text with shaping, bidirectional support, and font fallback if available.
  *
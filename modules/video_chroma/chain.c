@@ -32,6 +32,8 @@
 #include <vlc_common.h>
 #include <vlc_plugin.h>
 #include <vlc_filter.h>
+#include <vlc_fourcc.h>
+#include <vlc_cpu.h>
 
 /*****************************************************************************
  * Module descriptor
@@ -68,6 +70,48 @@ static const vlc_fourcc_t pi_allowed_chromas[] = {
     0
 };
 
+/* Rough storage cost of a picture in the given chroma, in bits per pixel
+ * scaled by 16 so that subsampled planes stay exact */
+static unsigned ChromaBits( vlc_fourcc_t i_chroma )
+{
+    const vlc_chroma_description_t *p_desc =
+        vlc_fourcc_GetChromaDescription( i_chroma );
+    if( !p_desc || p_desc->plane_count == 0 )
+        return 16 * 32; /* unknown: assume the worst */
+
+    unsigned i_bits = 0;
+    for( unsigned i = 0; i < p_desc->plane_count; i++ )
+        i_bits += 16 * 8 * p_desc->pixel_size
+                * p_desc->p[i].w.num * p_desc->p[i].h.num
+                / ( p_desc->p[i].w.den * p_desc->p[i].h.den );
+    return i_bits;
+}
+
+/* Estimated cost of one conversion step, in the same scaled bits per pixel
+ * unit. This only models memory traffic and the colorspace matrix; it does
+ * not know which converter module will actually grab the formats. */
+static unsigned ConversionCost( vlc_fourcc_t i_from, vlc_fourcc_t i_to )
+{
+    /* Memory traffic: read the source, write the destination */
+    unsigned i_cost = ChromaBits( i_from ) + ChromaBits( i_to );
+
+    /* Crossing between YUV and RGB adds a per-pixel matrix multiply on
+     * top of the copy; the SIMD converters roughly halve that */
+    if( vlc_fourcc_IsYUV( i_from ) != vlc_fourcc_IsYUV( i_to ) )
+    {
+        unsigned i_penalty = 16 * 24;
+#if defined(__i386__) || defined(__x86_64__)
+        if( vlc_CPU_SSE2() )
+            i_penalty /= 2;
+#elif defined(__arm__)
+        if( vlc_CPU_ARM_NEON() )
+            i_penalty /= 2;
+#endif
+        i_cost += i_penalty;
+    }
+    return i_cost;
+}
+
 struct filter_sys_t
 {
     filter_chain_t *p_chain;
@@ -245,7 +289,12 @@ static int BuildChromaChain( filter_t *p_filter )
     if( !cfg_level.psz_name || !cfg_level.psz_value )
         goto exit;
 
-    /* Now try chroma format list */
+    /* Rank the candidate intermediate chromas by estimated cost of the
+     * two conversion steps, cheapest first */
+    vlc_fourcc_t pi_order[ARRAY_SIZE(pi_allowed_chromas)];
+    unsigned pi_cost[ARRAY_SIZE(pi_allowed_chromas)];
+    size_t i_count = 0;
+
     for( int i = 0; pi_allowed_chromas[i]; i++ )
     {
         const vlc_fourcc_t i_chroma = pi_allowed_chromas[i];
@@ -253,8 +302,27 @@ static int BuildChromaChain( filter_t *p_filter )
             i_chroma == p_filter->fmt_out.i_codec )
             continue;
 
-        msg_Dbg( p_filter, "Trying to use chroma %4.4s as middle man",
-                 (char*)&i_chroma );
+        const unsigned i_cost =
+            ConversionCost( p_filter->fmt_in.i_codec, i_chroma ) +
+            ConversionCost( i_chroma, p_filter->fmt_out.i_codec );
+
+        size_t i_pos = i_count++;
+        for( ; i_pos > 0 && pi_cost[i_pos - 1] > i_cost; i_pos-- )
+        {
+            pi_order[i_pos] = pi_order[i_pos - 1];
+            pi_cost[i_pos]  = pi_cost[i_pos - 1];
+        }
+        pi_order[i_pos] = i_chroma;
+        pi_cost[i_pos]  = i_cost;
+    }
+
+    /* Now try the chroma format list in cost order */
+    for( size_t i = 0; i < i_count; i++ )
+    {
+        const vlc_fourcc_t i_chroma = pi_order[i];
+
+        msg_Dbg( p_filter, "Trying to use chroma %4.4s as middle man "
+                 "(estimated cost %u)", (char*)&i_chroma, pi_cost[i] );
 
         es_format_Copy( &fmt_mid, &p_filter->fmt_in );
         fmt_mid.i_codec        =
@@ -268,7 +336,17 @@ static int BuildChromaChain( filter_t *p_filter )
         es_format_Clean( &fmt_mid );
 
         if( i_ret == VLC_SUCCESS )
+        {
+            /* Expose the chosen plan for debugging */
+            char psz_plan[3 * 5 + 2 * 4 + 1];
+            snprintf( psz_plan, sizeof(psz_plan), "%4.4s -> %4.4s -> %4.4s",
+                      (char*)&p_filter->fmt_in.i_codec, (char*)&i_chroma,
+                      (char*)&p_filter->fmt_out.i_codec );
+            var_Create( p_filter, "chain-plan", VLC_VAR_STRING );
+            var_SetString( p_filter, "chain-plan", psz_plan );
+            msg_Dbg( p_filter, "using conversion plan %s", psz_plan );
             break;
+        }
     }
 
 exit:
@@ -93,6 +93,23 @@ void CopyCleanCache(copy_cache_t *cache)
 # define vlc_CPU_SSE2() ((cpu & VLC_CPU_SSE2) != 0)
 #endif
 
+#ifdef CAN_COMPILE_AVX2
+/* Copy 64 bytes with two 32 bytes AVX2 moves. The ymm registers alias the
+ * xmm ones, hence the xmm clobbers. */
+#define COPY64_AVX2(dstp, srcp, load, store) \
+    asm volatile (                      \
+        load "  0(%[src]), %%ymm1\n"    \
+        load " 32(%[src]), %%ymm2\n"    \
+        store " %%ymm1,    0(%[dst])\n" \
+        store " %%ymm2,   32(%[dst])\n" \
+        : : [dst]"r"(dstp), [src]"r"(srcp) : "memory", "xmm1", "xmm2")
+
+#ifndef __AVX2__
+# undef vlc_CPU_AVX2
+# define vlc_CPU_AVX2() ((cpu & VLC_CPU_AVX2) != 0)
+#endif
+#endif
+
 /* Optimized copy from "Uncacheable Speculative Write Combining" memory
  * as used by some video surface.
  * XXX It is really efficient only when SSE4.1 is available.
@@ -114,6 +131,14 @@ static void CopyFromUswc(uint8_t *dst, size_t dst_pitch,
         const unsigned unaligned = (-(uintptr_t)src) & 0x0f;
         unsigned x = unaligned;
 
+#ifdef CAN_COMPILE_AVX2
+        /* The 32 bytes streaming loads need a 32 bytes alignment; surfaces
+         * are naturally over-aligned, so only bother with that case. */
+        if (vlc_CPU_AVX2() && (((uintptr_t)src & 0x1f) == 0)) {
+            for (; x+63 < width; x += 64)
+                COPY64_AVX2(&dst[x], &src[x], "vmovntdqa", "vmovdqu");
+        } else
+#endif
 #ifdef CAN_COMPILE_SSE4_1
         if (vlc_CPU_SSE4_1()) {
             if (!unaligned) {
@@ -143,20 +168,33 @@ static void CopyFromUswc(uint8_t *dst, size_t dst_pitch,
         src += src_pitch;
         dst += dst_pitch;
     }
+#ifdef CAN_COMPILE_AVX2
+    if (vlc_CPU_AVX2())
+        asm volatile ("vzeroupper");
+#endif
     asm volatile ("mfence");
 }
 
 VLC_SSE
 static void Copy2d(uint8_t *dst, size_t dst_pitch,
                    const uint8_t *src, size_t src_pitch,
-                   unsigned width, unsigned height)
+                   unsigned width, unsigned height, unsigned cpu)
 {
+#ifndef CAN_COMPILE_AVX2
+    VLC_UNUSED(cpu);
+#endif
     assert(((intptr_t)src & 0x0f) == 0 && (src_pitch & 0x0f) == 0);
 
     for (unsigned y = 0; y < height; y++) {
         unsigned x = 0;
 
         bool unaligned = ((intptr_t)dst & 0x0f) != 0;
+#ifdef CAN_COMPILE_AVX2
+        if (vlc_CPU_AVX2() && (((uintptr_t)src | (uintptr_t)dst) & 0x1f) == 0) {
+            for (; x+63 < width; x += 64)
+                COPY64_AVX2(&dst[x], &src[x], "vmovdqa", "vmovntdq");
+        } else
+#endif
         if (!unaligned) {
             for (; x+63 < width; x += 64)
                 COPY64(&dst[x], &src[x], "movdqa", "movntdq");
@@ -171,6 +209,10 @@ static void Copy2d(uint8_t *dst, size_t dst_pitch,
         src += src_pitch;
         dst += dst_pitch;
     }
+#ifdef CAN_COMPILE_AVX2
+    if (vlc_CPU_AVX2())
+        asm volatile ("vzeroupper");
+#endif
 }
 
 VLC_SSE
@@ -281,7 +323,7 @@ static void SSE_CopyPlane(uint8_t *dst, size_t dst_pitch,
         /* Copy from our cache to the destination */
         Copy2d(dst, dst_pitch,
                cache, w16,
-               width, hblock);
+               width, hblock, cpu);
 
         /* */
         src += src_pitch * hblock;
@@ -365,6 +407,9 @@ static void SSE_CopyFromNv12ToNv12(picture_t *dst,
                   width, height/2, cpu);
     asm volatile ("emms");
 }
+#ifdef CAN_COMPILE_AVX2
+# undef COPY64_AVX2
+#endif
 #undef COPY64
 #endif /* CAN_COMPILE_SSE2 */
 
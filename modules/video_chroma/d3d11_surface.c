@@ -60,18 +60,24 @@ struct picture_sys_t
     HINSTANCE                     hd3d11_dll; /* TODO */
 };
 
+/* Staging textures are cycled so that a conversion never reuses the
+ * texture of the previous frame; some drivers otherwise stall the new
+ * GPU copy until the previous readback has fully retired. */
+#define STAGING_RING_SIZE 3
+
 struct filter_sys_t {
     copy_cache_t     cache;
-    ID3D11Texture2D  *staging;
+    ID3D11Texture2D  *staging[STAGING_RING_SIZE];
+    unsigned         staging_idx;
     vlc_mutex_t      staging_lock;
 };
 
-static int assert_staging(filter_t *p_filter, picture_sys_t *p_sys)
+static ID3D11Texture2D *next_staging(filter_t *p_filter, picture_sys_t *p_sys)
 {
     filter_sys_t *sys = (filter_sys_t*) p_filter->p_sys;
     HRESULT hr;
 
-    if (sys->staging)
+    if (sys->staging[0])
         goto ok;
 
     D3D11_TEXTURE2D_DESC texDesc;
@@ -87,15 +93,23 @@ static int assert_staging(filter_t *p_filter, picture_sys_t *p_sys)
 
     ID3D11Device *p_device;
     ID3D11DeviceContext_GetDevice(p_sys->context, &p_device);
-    sys->staging = NULL;
-    hr = ID3D11Device_CreateTexture2D( p_device, &texDesc, NULL, &sys->staging);
+    for (unsigned i = 0; i < STAGING_RING_SIZE; i++) {
+        hr = ID3D11Device_CreateTexture2D( p_device, &texDesc, NULL, &sys->staging[i]);
+        if (FAILED(hr)) {
+            while (i > 0)
+                ID3D11Texture2D_Release(sys->staging[--i]);
+            sys->staging[0] = NULL;
+            break;
+        }
+    }
     ID3D11Device_Release(p_device);
     if (FAILED(hr)) {
         msg_Err(p_filter, "Failed to create a %s staging texture to extract surface pixels (hr=0x%0lx)", DxgiFormatToStr(texDesc.Format), hr );
-        return VLC_EGENERIC;
+        return NULL;
     }
 ok:
-    return VLC_SUCCESS;
+    sys->staging_idx = (sys->staging_idx + 1) % STAGING_RING_SIZE;
+    return sys->staging[sys->staging_idx];
 }
 
 static void D3D11_YUY2(filter_t *p_filter, picture_t *src, picture_t *dst)
@@ -107,7 +121,8 @@ static void D3D11_YUY2(filter_t *p_filter, picture_t *src, picture_t *dst)
     D3D11_MAPPED_SUBRESOURCE lock;
 
     vlc_mutex_lock(&sys->staging_lock);
-    if (assert_staging(p_filter, p_sys) != VLC_SUCCESS)
+    ID3D11Texture2D *staging = next_staging(p_filter, p_sys);
+    if (staging == NULL)
     {
         vlc_mutex_unlock(&sys->staging_lock);
         return;
@@ -116,12 +131,14 @@ static void D3D11_YUY2(filter_t *p_filter, picture_t *src, picture_t *dst)
     D3D11_VIDEO_DECODER_OUTPUT_VIEW_DESC viewDesc;
     ID3D11VideoDecoderOutputView_GetDesc( p_sys->decoder, &viewDesc );
 
-    ID3D11DeviceContext_CopySubresourceRegion(p_sys->context, (ID3D11Resource*) sys->staging,
+    ID3D11DeviceContext_CopySubresourceRegion(p_sys->context, (ID3D11Resource*) staging,
                                               0, 0, 0, 0,
                                               (ID3D11Resource*) p_sys->texture, viewDesc.Texture2D.ArraySlice,
                                               NULL);
+    /* get the copy going before we set up the CPU side */
+    ID3D11DeviceContext_Flush(p_sys->context);
 
-    HRESULT hr = ID3D11DeviceContext_Map(p_sys->context, (ID3D11Resource*) sys->staging,
+    HRESULT hr = ID3D11DeviceContext_Map(p_sys->context, (ID3D11Resource*) staging,
                                          0, D3D11_MAP_READ, 0, &lock);
     if (FAILED(hr)) {
         msg_Err(p_filter, "Failed to map source surface. (hr=0x%0lx)", hr);
@@ -135,7 +152,7 @@ static void D3D11_YUY2(filter_t *p_filter, picture_t *src, picture_t *dst)
         dst->p[2].p_pixels = tmp;
     }
 
-    ID3D11Texture2D_GetDesc(sys->staging, &desc);
+    ID3D11Texture2D_GetDesc(staging, &desc);
 
     if (desc.Format == DXGI_FORMAT_YUY2) {
         size_t chroma_pitch = (lock.RowPitch / 2);
@@ -177,7 +194,7 @@ static void D3D11_YUY2(filter_t *p_filter, picture_t *src, picture_t *dst)
     }
 
     /* */
-    ID3D11DeviceContext_Unmap(p_sys->context, (ID3D11Resource*)sys->staging, 0);
+    ID3D11DeviceContext_Unmap(p_sys->context, (ID3D11Resource*)staging, 0);
     vlc_mutex_unlock(&sys->staging_lock);
 }
 
@@ -190,7 +207,8 @@ static void D3D11_NV12(filter_t *p_filter, picture_t *src, picture_t *dst)
     D3D11_MAPPED_SUBRESOURCE lock;
 
     vlc_mutex_lock(&sys->staging_lock);
-    if (assert_staging(p_filter, p_sys) != VLC_SUCCESS)
+    ID3D11Texture2D *staging = next_staging(p_filter, p_sys);
+    if (staging == NULL)
     {
         vlc_mutex_unlock(&sys->staging_lock);
         return;
@@ -199,12 +217,14 @@ static void D3D11_NV12(filter_t *p_filter, picture_t *src, picture_t *dst)
     D3D11_VIDEO_DECODER_OUTPUT_VIEW_DESC viewDesc;
     ID3D11VideoDecoderOutputView_GetDesc( p_sys->decoder, &viewDesc );
 
-    ID3D11DeviceContext_CopySubresourceRegion(p_sys->context, (ID3D11Resource*) sys->staging,
+    ID3D11DeviceContext_CopySubresourceRegion(p_sys->context, (ID3D11Resource*) staging,
                                               0, 0, 0, 0,
                                               (ID3D11Resource*) p_sys->texture, viewDesc.Texture2D.ArraySlice,
                                               NULL);
+    /* get the copy going before we set up the CPU side */
+    ID3D11DeviceContext_Flush(p_sys->context);
 
-    HRESULT hr = ID3D11DeviceContext_Map(p_sys->context, (ID3D11Resource*) sys->staging,
+    HRESULT hr = ID3D11DeviceContext_Map(p_sys->context, (ID3D11Resource*) staging,
                                          0, D3D11_MAP_READ, 0, &lock);
     if (FAILED(hr)) {
         msg_Err(p_filter, "Failed to map source surface. (hr=0x%0lx)", hr);
@@ -212,7 +232,7 @@ static void D3D11_NV12(filter_t *p_filter, picture_t *src, picture_t *dst)
         return;
     }
 
-    ID3D11Texture2D_GetDesc(sys->staging, &desc);
+    ID3D11Texture2D_GetDesc(staging, &desc);
 
     if (desc.Format == DXGI_FORMAT_NV12) {
         uint8_t *plane[2] = {
@@ -230,7 +250,7 @@ static void D3D11_NV12(filter_t *p_filter, picture_t *src, picture_t *dst)
     }
 
     /* */
-    ID3D11DeviceContext_Unmap(p_sys->context, (ID3D11Resource*)sys->staging, 0);
+    ID3D11DeviceContext_Unmap(p_sys->context, (ID3D11Resource*)staging, 0);
     vlc_mutex_unlock(&sys->staging_lock);
 }
 
@@ -275,8 +295,9 @@ static void CloseConverter( vlc_object_t *obj )
     filter_sys_t *p_sys = (filter_sys_t*) p_filter->p_sys;
     CopyCleanCache(&p_sys->cache);
     vlc_mutex_destroy(&p_sys->staging_lock);
-    if (p_sys->staging)
-        ID3D11Texture2D_Release(p_sys->staging);
+    for (unsigned i = 0; i < STAGING_RING_SIZE; i++)
+        if (p_sys->staging[i])
+            ID3D11Texture2D_Release(p_sys->staging[i]);
     free( p_sys );
     p_filter->p_sys = NULL;
 }
@@ -57,6 +57,11 @@ static void CloseScaler( vlc_object_t * );
 #define SCALEMODE_TEXT N_("Scaling mode")
 #define SCALEMODE_LONGTEXT N_("Scaling mode to use.")
 
+#define THREADS_TEXT N_("Conversion threads")
+#define THREADS_LONGTEXT N_("Number of threads used to convert the picture " \
+    "in parallel slices (0 for one thread per CPU core). Slice threading " \
+    "is only used when the conversion does not scale vertically." )
+
 static const int pi_mode_values[] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
 const char *const ppsz_mode_descriptions[] =
 { N_("Fast bilinear"), N_("Bilinear"), N_("Bicubic (good quality)"),
@@ -73,6 +78,7 @@ vlc_module_begin ()
     set_callbacks( OpenScaler, CloseScaler )
     add_integer( "swscale-mode", 2, SCALEMODE_TEXT, SCALEMODE_LONGTEXT, true )
         change_integer_list( pi_mode_values, ppsz_mode_descriptions )
+    add_integer( "swscale-threads", 0, THREADS_TEXT, THREADS_LONGTEXT, true )
 vlc_module_end ()
 
 /* Version checking */
@@ -81,6 +87,21 @@ vlc_module_end ()
  * Local prototypes
  ****************************************************************************/
 
+#define MAX_SLICE_THREADS 16
+
+/**
+ * One horizontal band of the picture, converted by its own worker with
+ * its own SwsContext (contexts are not thread safe).
+ */
+typedef struct
+{
+    filter_t *p_filter;
+    struct SwsContext *ctx;
+    vlc_thread_t thread;
+    int i_ystart;
+    int i_lines;
+} slice_thread_t;
+
 /**
  * Internal swscale filter structure.
  */
@@ -105,6 +126,20 @@ struct filter_sys_t
     bool b_copy;
     bool b_swap_uvi;
     bool b_swap_uvo;
+
+    /* Slice threading, only set up when there is no vertical scaling */
+    unsigned i_threads_conf;
+    unsigned i_threads;
+    slice_thread_t slice[MAX_SLICE_THREADS];
+    vlc_mutex_t lock;
+    vlc_cond_t wait_job;
+    vlc_cond_t wait_done;
+    unsigned i_generation;
+    unsigned i_pending;
+    bool b_exit;
+    /* Current job, plane pointers already UV swapped as needed */
+    uint8_t *job_src[4]; int job_src_stride[4];
+    uint8_t *job_dst[4]; int job_dst_stride[4];
 };
 
 static picture_t *Filter( filter_t *, picture_t * );
@@ -161,6 +196,13 @@ static int OpenScaler( vlc_object_t *p_this )
     /* Set CPU capabilities */
     p_sys->i_cpu_mask = GetSwsCpuMask();
 
+    /* */
+    p_sys->i_threads = 1;
+    p_sys->i_threads_conf = var_CreateGetInteger( p_filter, "swscale-threads" );
+    vlc_mutex_init( &p_sys->lock );
+    vlc_cond_init( &p_sys->wait_job );
+    vlc_cond_init( &p_sys->wait_done );
+
     /* */
     i_sws_mode = var_CreateGetInteger( p_filter, "swscale-mode" );
     switch( i_sws_mode )
@@ -187,6 +229,9 @@ static int OpenScaler( vlc_object_t *p_this )
     {
         if( p_sys->p_filter )
             sws_freeFilter( p_sys->p_filter );
+        vlc_cond_destroy( &p_sys->wait_done );
+        vlc_cond_destroy( &p_sys->wait_job );
+        vlc_mutex_destroy( &p_sys->lock );
         free( p_sys );
         return VLC_EGENERIC;
     }
@@ -217,6 +262,9 @@ static void CloseScaler( vlc_object_t *p_this )
     Clean( p_filter );
     if( p_sys->p_filter )
         sws_freeFilter( p_sys->p_filter );
+    vlc_cond_destroy( &p_sys->wait_done );
+    vlc_cond_destroy( &p_sys->wait_job );
+    vlc_mutex_destroy( &p_sys->lock );
     free( p_sys );
 }
 
@@ -349,6 +397,85 @@ static int GetParameters( ScalerConfiguration *p_cfg,
     return VLC_SUCCESS;
 }
 
+/*****************************************************************************
+ * Slice threading
+ *****************************************************************************/
+static void ConvertSlice( slice_thread_t *p_slice )
+{
+    filter_sys_t *p_sys = p_slice->p_filter->p_sys;
+    uint8_t *src[4]; int src_stride[4];
+    uint8_t *dst[4]; int dst_stride[4];
+
+    for( unsigned i = 0; i < 4; i++ )
+    {
+        src[i] = p_sys->job_src[i];
+        dst[i] = p_sys->job_dst[i];
+        src_stride[i] = p_sys->job_src_stride[i];
+        dst_stride[i] = p_sys->job_dst_stride[i];
+
+        /* The band starts on a multiple of every plane vertical
+         * subsampling, so these divisions are exact */
+        if( src[i] && i < p_sys->desc_in->plane_count )
+            src[i] += src_stride[i] * ( ( p_slice->i_ystart *
+                p_sys->desc_in->p[i].h.num ) / p_sys->desc_in->p[i].h.den );
+        if( dst[i] && i < p_sys->desc_out->plane_count )
+            dst[i] += dst_stride[i] * ( ( p_slice->i_ystart *
+                p_sys->desc_out->p[i].h.num ) / p_sys->desc_out->p[i].h.den );
+    }
+
+    sws_scale( p_slice->ctx, src, src_stride, 0, p_slice->i_lines,
+               dst, dst_stride );
+}
+
+static void *SliceThread( void *opaque )
+{
+    slice_thread_t *p_slice = opaque;
+    filter_sys_t *p_sys = p_slice->p_filter->p_sys;
+    unsigned i_generation = 0;
+
+    vlc_mutex_lock( &p_sys->lock );
+    for( ;; )
+    {
+        while( !p_sys->b_exit && p_sys->i_generation == i_generation )
+            vlc_cond_wait( &p_sys->wait_job, &p_sys->lock );
+        if( p_sys->b_exit )
+            break;
+        i_generation = p_sys->i_generation;
+        vlc_mutex_unlock( &p_sys->lock );
+
+        ConvertSlice( p_slice );
+
+        vlc_mutex_lock( &p_sys->lock );
+        if( --p_sys->i_pending == 0 )
+            vlc_cond_signal( &p_sys->wait_done );
+    }
+    vlc_mutex_unlock( &p_sys->lock );
+    return NULL;
+}
+
+static void StopSlices( filter_t *p_filter )
+{
+    filter_sys_t *p_sys = p_filter->p_sys;
+
+    if( p_sys->i_threads <= 1 )
+        return;
+
+    vlc_mutex_lock( &p_sys->lock );
+    p_sys->b_exit = true;
+    vlc_cond_broadcast( &p_sys->wait_job );
+    vlc_mutex_unlock( &p_sys->lock );
+
+    for( unsigned i = 1; i < p_sys->i_threads; i++ )
+        vlc_join( p_sys->slice[i].thread, NULL );
+    for( unsigned i = 0; i < p_sys->i_threads; i++ )
+    {
+        sws_freeContext( p_sys->slice[i].ctx );
+        p_sys->slice[i].ctx = NULL;
+    }
+    p_sys->b_exit = false;
+    p_sys->i_threads = 1;
+}
+
 static int Init( filter_t *p_filter )
 {
     filter_sys_t *p_sys = p_filter->p_sys;
@@ -455,6 +582,76 @@ static int Init( filter_t *p_filter )
         p_fmto->i_sar_den = i_sar_den;
     }
 
+    /* Optional slice threading. Each band is converted by an independent
+     * context, which is only sound when nothing is scaled vertically. */
+    unsigned i_threads = p_sys->i_threads_conf;
+    if( i_threads == 0 )
+        i_threads = vlc_GetCPUCount();
+    if( i_threads > MAX_SLICE_THREADS )
+        i_threads = MAX_SLICE_THREADS;
+    if( i_threads > (unsigned)p_fmti->i_visible_height / 64 )
+        i_threads = p_fmti->i_visible_height / 64;
+
+    if( i_threads > 1 && !cfg.b_copy &&
+        p_fmti->i_visible_height == p_fmto->i_visible_height &&
+        p_fmti->i_chroma != VLC_CODEC_RGBP )
+    {
+        unsigned i;
+        int i_ystart = 0;
+
+        for( i = 0; i < i_threads; i++ )
+        {
+            slice_thread_t *p_slice = &p_sys->slice[i];
+            /* Align the bands on 4 lines for the vertical subsamplings */
+            int i_yend = ( p_fmti->i_visible_height * (int)(i + 1) /
+                           (int)i_threads ) & ~3;
+            if( i + 1 == i_threads )
+                i_yend = p_fmti->i_visible_height;
+
+            p_slice->p_filter = p_filter;
+            p_slice->i_ystart = i_ystart;
+            p_slice->i_lines  = i_yend - i_ystart;
+            p_slice->ctx = sws_getContext( i_fmti_visible_width, p_slice->i_lines, cfg.i_fmti,
+                                           i_fmto_visible_width, p_slice->i_lines, cfg.i_fmto,
+                                           cfg.i_sws_flags | p_sys->i_cpu_mask,
+                                           p_sys->p_filter, NULL, 0 );
+            if( !p_slice->ctx )
+                break;
+            i_ystart = i_yend;
+        }
+
+        if( i == i_threads )
+        {
+            /* The filter thread converts the first band itself */
+            for( i = 1; i < i_threads; i++ )
+            {
+                if( vlc_clone( &p_sys->slice[i].thread, SliceThread,
+                               &p_sys->slice[i], VLC_THREAD_PRIORITY_VIDEO ) )
+                    break;
+            }
+            p_sys->i_threads = i;
+            if( i != i_threads )
+            {
+                for( unsigned j = ( i > 1 ) ? i : 0; j < i_threads; j++ )
+                {
+                    sws_freeContext( p_sys->slice[j].ctx );
+                    p_sys->slice[j].ctx = NULL;
+                }
+                StopSlices( p_filter );
+            }
+            else
+                msg_Dbg( p_filter, "using %u conversion threads", i_threads );
+        }
+        else
+        {
+            while( i-- > 0 )
+            {
+                sws_freeContext( p_sys->slice[i].ctx );
+                p_sys->slice[i].ctx = NULL;
+            }
+        }
+    }
+
     p_sys->b_add_a = cfg.b_add_a;
     p_sys->b_copy = cfg.b_copy;
     p_sys->fmt_in  = *p_fmti;
@@ -469,6 +666,8 @@ static void Clean( filter_t *p_filter )
 {
     filter_sys_t *p_sys = p_filter->p_sys;
 
+    StopSlices( p_filter );
+
     if( p_sys->p_src_e )
         picture_Release( p_sys->p_src_e );
     if( p_sys->p_dst_e )
@@ -609,6 +808,28 @@ static void Convert( filter_t *p_filter, struct SwsContext *ctx,
     GetPixels( dst, dst_stride, p_sys->desc_out, &p_filter->fmt_out.video,
                p_dst, i_plane_count, b_swap_uvo );
 
+    if( ctx == p_sys->ctx && p_sys->i_threads > 1 )
+    {
+        /* Dispatch the bands to the workers and do the first one here */
+        vlc_mutex_lock( &p_sys->lock );
+        memcpy( p_sys->job_src, src, sizeof(p_sys->job_src) );
+        memcpy( p_sys->job_dst, dst, sizeof(p_sys->job_dst) );
+        memcpy( p_sys->job_src_stride, src_stride, sizeof(p_sys->job_src_stride) );
+        memcpy( p_sys->job_dst_stride, dst_stride, sizeof(p_sys->job_dst_stride) );
+        p_sys->i_pending = p_sys->i_threads - 1;
+        p_sys->i_generation++;
+        vlc_cond_broadcast( &p_sys->wait_job );
+        vlc_mutex_unlock( &p_sys->lock );
+
+        ConvertSlice( &p_sys->slice[0] );
+
+        vlc_mutex_lock( &p_sys->lock );
+        while( p_sys->i_pending > 0 )
+            vlc_cond_wait( &p_sys->wait_done, &p_sys->lock );
+        vlc_mutex_unlock( &p_sys->lock );
+        return;
+    }
+
 #if LIBSWSCALE_VERSION_INT  >= ((0<<16)+(5<<8)+0)
     sws_scale( ctx, src, src_stride, 0, i_height,
                dst, dst_stride );
@@ -167,6 +167,13 @@ static int Create( vlc_object_t *p_this )
             p_filter->pf_video_filter = FilterPlanar;
             p_sys->pf_process_sat_hue_clip = planar_sat_hue_clip_C;
             p_sys->pf_process_sat_hue = planar_sat_hue_C;
+#ifdef CAN_COMPILE_SSE2
+            if( vlc_CPU_SSE2() )
+            {
+                p_sys->pf_process_sat_hue_clip = planar_sat_hue_clip_sse2;
+                p_sys->pf_process_sat_hue = planar_sat_hue_sse2;
+            }
+#endif
             break;
 
         CASE_PLANAR_YUV10
@@ -190,6 +197,9 @@ static int Create( vlc_object_t *p_this )
             return VLC_EGENERIC;
     }
 
+    /* Both variants process strictly per-pixel */
+    p_filter->b_allow_in_place = true;
+
     vlc_mutex_init( &p_sys->lock );
     var_AddCallback( p_filter, "contrast",   AdjustCallback, p_sys );
     var_AddCallback( p_filter, "brightness", AdjustCallback, p_sys );
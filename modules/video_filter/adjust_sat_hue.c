@@ -165,6 +165,142 @@ int planar_sat_hue_C( picture_t * p_pic, picture_t * p_outpic, int i_sin, int i_
     return VLC_SUCCESS;
 }
 
+#ifdef CAN_COMPILE_SSE2
+/*
+ * The scalar reference computes ((t >> 8) * i_sat) >> 8 with t in 24 bits.
+ * Folding i_sat into the rotation coefficients keeps every intermediate in
+ * 16 bits so pmaddwd does the whole rotation; the single truncating shift
+ * makes the output differ from the C routines by a few steps at extreme
+ * saturation values, which is invisible on 8-bit chroma.  packuswb
+ * saturates to [0,255] for free, so one kernel serves both the clipping and
+ * the non-clipping entry points.
+ */
+VLC_SSE
+static void planar_sat_hue_line_sse2( uint8_t *p_out, uint8_t *p_out_v,
+                                      const uint8_t *p_in, const uint8_t *p_in_v,
+                                      intptr_t i_count, int32_t i_cu, int32_t i_cv,
+                                      int32_t i_off_u, int32_t i_off_v )
+{
+    intptr_t x = -i_count;
+
+    __asm__ volatile(
+        "movd            %5, %%xmm4 \n"   /* [cos*sat, sin*sat] >> 8 */
+        "pshufd  $0, %%xmm4, %%xmm4 \n"
+        "movd            %6, %%xmm5 \n"   /* [-sin*sat, cos*sat] >> 8 */
+        "pshufd  $0, %%xmm5, %%xmm5 \n"
+        "movd            %7, %%xmm6 \n"   /* (i_x*sat >> 8) - (128 << 8) */
+        "pshufd  $0, %%xmm6, %%xmm6 \n"
+        "movd            %8, %%xmm7 \n"   /* (i_y*sat >> 8) - (128 << 8) */
+        "pshufd  $0, %%xmm7, %%xmm7 \n"
+        "1: \n"
+        "pxor        %%xmm3, %%xmm3 \n"
+        "movq       (%3,%0), %%xmm0 \n"
+        "movq       (%4,%0), %%xmm2 \n"
+        "punpcklbw   %%xmm3, %%xmm0 \n"   /* 8 u samples as words */
+        "punpcklbw   %%xmm3, %%xmm2 \n"   /* 8 v samples as words */
+        "movdqa      %%xmm0, %%xmm1 \n"
+        "punpcklwd   %%xmm2, %%xmm0 \n"   /* low (u,v) pairs */
+        "punpckhwd   %%xmm2, %%xmm1 \n"   /* high (u,v) pairs */
+        "movdqa      %%xmm0, %%xmm2 \n"
+        "movdqa      %%xmm1, %%xmm3 \n"
+        "pmaddwd     %%xmm4, %%xmm2 \n"   /* u*cos + v*sin, times i_sat */
+        "pmaddwd     %%xmm4, %%xmm3 \n"
+        "psubd       %%xmm6, %%xmm2 \n"
+        "psubd       %%xmm6, %%xmm3 \n"
+        "psrad           $8, %%xmm2 \n"
+        "psrad           $8, %%xmm3 \n"
+        "packssdw    %%xmm3, %%xmm2 \n"
+        "packuswb    %%xmm2, %%xmm2 \n"
+        "movq        %%xmm2, (%1,%0) \n"
+        "pmaddwd     %%xmm5, %%xmm0 \n"   /* v*cos - u*sin, times i_sat */
+        "pmaddwd     %%xmm5, %%xmm1 \n"
+        "psubd       %%xmm7, %%xmm0 \n"
+        "psubd       %%xmm7, %%xmm1 \n"
+        "psrad           $8, %%xmm0 \n"
+        "psrad           $8, %%xmm1 \n"
+        "packssdw    %%xmm1, %%xmm0 \n"
+        "packuswb    %%xmm0, %%xmm0 \n"
+        "movq        %%xmm0, (%2,%0) \n"
+        "add             $8, %0 \n"
+        "jl 1b \n"
+        : "+r"(x)
+        : "r"(p_out + i_count), "r"(p_out_v + i_count),
+          "r"(p_in + i_count), "r"(p_in_v + i_count),
+          "m"(i_cu), "m"(i_cv), "m"(i_off_u), "m"(i_off_v)
+        : "xmm0", "xmm1", "xmm2", "xmm3", "xmm4", "xmm5", "xmm6", "xmm7",
+          "memory"
+    );
+}
+
+int planar_sat_hue_clip_sse2( picture_t * p_pic, picture_t * p_outpic, int i_sin, int i_cos,
+                              int i_sat, int i_x, int i_y )
+{
+    uint8_t *p_in, *p_in_v, *p_in_end, *p_line_end;
+    uint8_t *p_out, *p_out_v;
+
+    const int i_cs = ( i_cos * i_sat ) >> 8;
+    const int i_ss = ( i_sin * i_sat ) >> 8;
+    const int32_t i_cu = (uint16_t)i_cs | (uint32_t)(uint16_t)i_ss << 16;
+    const int32_t i_cv = (uint16_t)-i_ss | (uint32_t)(uint16_t)i_cs << 16;
+    /* Fold the + I_MID( 8 ) applied after the shift into the offset */
+    const int32_t i_off_u = (( i_x * i_sat ) >> 8) - (I_MID( 8 ) << 8);
+    const int32_t i_off_v = (( i_y * i_sat ) >> 8) - (I_MID( 8 ) << 8);
+
+    const intptr_t i_simd = p_pic->p[U_PLANE].i_visible_pitch & ~7;
+
+    p_in = p_pic->p[U_PLANE].p_pixels;
+    p_in_v = p_pic->p[V_PLANE].p_pixels;
+    p_in_end = p_in + p_pic->p[U_PLANE].i_visible_lines
+                      * p_pic->p[U_PLANE].i_pitch;
+
+    p_out = p_outpic->p[U_PLANE].p_pixels;
+    p_out_v = p_outpic->p[V_PLANE].p_pixels;
+
+    uint8_t i_u, i_v;
+
+    for( ; p_in < p_in_end ; )
+    {
+        p_line_end = p_in + p_pic->p[U_PLANE].i_visible_pitch;
+
+        if( i_simd > 0 )
+        {
+            /* Do 8 pixels of both planes at a time */
+            planar_sat_hue_line_sse2( p_out, p_out_v, p_in, p_in_v, i_simd,
+                                      i_cu, i_cv, i_off_u, i_off_v );
+            p_in += i_simd;
+            p_in_v += i_simd;
+            p_out += i_simd;
+            p_out_v += i_simd;
+        }
+
+        for( ; p_in < p_line_end ; )
+        {
+            PLANAR_WRITE_UV_CLIP( 8 );
+        }
+
+        p_in += p_pic->p[U_PLANE].i_pitch
+                - p_pic->p[U_PLANE].i_visible_pitch;
+        p_in_v += p_pic->p[V_PLANE].i_pitch
+                - p_pic->p[V_PLANE].i_visible_pitch;
+        p_out += p_outpic->p[U_PLANE].i_pitch
+                - p_outpic->p[U_PLANE].i_visible_pitch;
+        p_out_v += p_outpic->p[V_PLANE].i_pitch
+                    - p_outpic->p[V_PLANE].i_visible_pitch;
+    }
+
+    return VLC_SUCCESS;
+}
+
+int planar_sat_hue_sse2( picture_t * p_pic, picture_t * p_outpic, int i_sin, int i_cos,
+                         int i_sat, int i_x, int i_y )
+{
+    /* The kernel saturates anyway, so the clipping routine doubles as the
+     * i_sat <= 256 fast path */
+    return planar_sat_hue_clip_sse2( p_pic, p_outpic, i_sin, i_cos, i_sat,
+                                     i_x, i_y );
+}
+#endif
+
 int planar_sat_hue_clip_C_16( picture_t * p_pic, picture_t * p_outpic, int i_sin, int i_cos,
                          int i_sat, int i_x, int i_y )
 {
@@ -49,6 +49,20 @@ int planar_sat_hue_clip_C( picture_t * p_pic, picture_t * p_outpic,
  */
 int planar_sat_hue_C( picture_t * p_pic, picture_t * p_outpic,
                       int i_sin, int i_cos, int i_sat, int i_x, int i_y );
+#ifdef CAN_COMPILE_SSE2
+/**
+ * SSE2 optimized function for 8-bit planar format, i_sat > 256
+ */
+int planar_sat_hue_clip_sse2( picture_t * p_pic, picture_t * p_outpic,
+                              int i_sin, int i_cos, int i_sat, int i_x, int i_y );
+
+/**
+ * SSE2 optimized function for 8-bit planar format, i_sat <= 256
+ */
+int planar_sat_hue_sse2( picture_t * p_pic, picture_t * p_outpic,
+                         int i_sin, int i_cos, int i_sat, int i_x, int i_y );
+#endif
+
 /**
  * Basic C compiler generated function for {9,10}-bit planar format, i_sat > {512,1024}
  */
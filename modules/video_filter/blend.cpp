@@ -31,8 +31,19 @@
 #include <vlc_common.h>
 #include <vlc_plugin.h>
 #include <vlc_filter.h>
+#include <vlc_cpu.h>
 #include "filter_picture.h"
 
+#if defined(CAN_COMPILE_SSE2) && (defined(__i386__) || defined(__x86_64__))
+# include <emmintrin.h>
+# ifdef __SSE2__
+#  define VLC_TARGET_SSE2
+# else
+#  define VLC_TARGET_SSE2 __attribute__ ((__target__ ("sse2")))
+# endif
+# define CAN_BLEND_SSE2
+#endif
+
 /*****************************************************************************
  * Module descriptor
  *****************************************************************************/
@@ -78,6 +89,18 @@ public:
     {
         return fmt;
     }
+    const picture_t *getPicture() const
+    {
+        return picture;
+    }
+    unsigned getX() const
+    {
+        return x;
+    }
+    unsigned getY() const
+    {
+        return y;
+    }
     bool isFull(unsigned) const
     {
         return true;
@@ -622,6 +645,216 @@ static const struct {
 #undef YUV
 };
 
+#ifdef CAN_BLEND_SSE2
+/* Vector version of div255() on 8 16-bit lanes */
+VLC_TARGET_SSE2
+static inline __m128i Div255SSE2(__m128i v)
+{
+    return _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(_mm_srli_epi16(v, 8), v),
+                                        _mm_set1_epi16(1)), 8);
+}
+
+/* Blend one full resolution 8 bit line with a per pixel alpha line,
+ * 16 pixels at a time: dst = div255((255 - a) * dst + src * a) with
+ * a = div255(alpha * alpha_line[x]), like the scalar merge(). */
+VLC_TARGET_SSE2
+static void MergeLineSSE2(uint8_t *dst, const uint8_t *src,
+                          const uint8_t *alpha_line, int alpha, unsigned width)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i c255 = _mm_set1_epi16(255);
+    const __m128i gain = _mm_set1_epi16(alpha);
+    unsigned x = 0;
+
+    for (; x + 15 < width; x += 16) {
+        __m128i a8 = _mm_loadu_si128((const __m128i *)&alpha_line[x]);
+        __m128i s8 = _mm_loadu_si128((const __m128i *)&src[x]);
+        __m128i d8 = _mm_loadu_si128((const __m128i *)&dst[x]);
+
+        __m128i alo = Div255SSE2(_mm_mullo_epi16(_mm_unpacklo_epi8(a8, zero), gain));
+        __m128i ahi = Div255SSE2(_mm_mullo_epi16(_mm_unpackhi_epi8(a8, zero), gain));
+
+        __m128i dlo = _mm_add_epi16(
+            _mm_mullo_epi16(_mm_unpacklo_epi8(d8, zero), _mm_sub_epi16(c255, alo)),
+            _mm_mullo_epi16(_mm_unpacklo_epi8(s8, zero), alo));
+        __m128i dhi = _mm_add_epi16(
+            _mm_mullo_epi16(_mm_unpackhi_epi8(d8, zero), _mm_sub_epi16(c255, ahi)),
+            _mm_mullo_epi16(_mm_unpackhi_epi8(s8, zero), ahi));
+
+        _mm_storeu_si128((__m128i *)&dst[x],
+                         _mm_packus_epi16(Div255SSE2(dlo), Div255SSE2(dhi)));
+    }
+
+    for (; x < width; x++) {
+        unsigned a = div255(alpha * alpha_line[x]);
+        if (a > 0)
+            merge(&dst[x], src[x], a);
+    }
+}
+
+/* YUVA onto 4:2:0 planar/semi planar: the luma plane is blended with the
+ * vector kernel, the subsampled chroma keeps the scalar path (it only
+ * touches one sample out of four, like the generic code). */
+static void BlendYUVAOn420SSE2(const CPicture &dst_data, const CPicture &src_data,
+                               unsigned width, unsigned height, int alpha,
+                               bool swap_uv, bool semi_planar)
+{
+    const picture_t *dstp = dst_data.getPicture();
+    const picture_t *srcp = src_data.getPicture();
+    const unsigned dx = dst_data.getX(), dy = dst_data.getY();
+    const unsigned sx = src_data.getX(), sy = src_data.getY();
+
+    for (unsigned y = 0; y < height; y++) {
+        uint8_t *dst = &dstp->p[0].p_pixels[(dy + y) * dstp->p[0].i_pitch + dx];
+        const uint8_t *src =
+            &srcp->p[0].p_pixels[(sy + y) * srcp->p[0].i_pitch + sx];
+        const uint8_t *src_a =
+            &srcp->p[3].p_pixels[(sy + y) * srcp->p[3].i_pitch + sx];
+        MergeLineSSE2(dst, src, src_a, alpha, width);
+    }
+
+    /* Only the samples landing on even destination positions are blended,
+     * like isFull() does in the scalar code */
+    const unsigned u_plane = swap_uv ? 2 : 1;
+    const unsigned v_plane = swap_uv ? 1 : 2;
+    for (unsigned y = 0; y < height; y++) {
+        if ((dy + y) % 2)
+            continue;
+        const uint8_t *su =
+            &srcp->p[1].p_pixels[(sy + y) * srcp->p[1].i_pitch + sx];
+        const uint8_t *sv =
+            &srcp->p[2].p_pixels[(sy + y) * srcp->p[2].i_pitch + sx];
+        const uint8_t *sa =
+            &srcp->p[3].p_pixels[(sy + y) * srcp->p[3].i_pitch + sx];
+        const unsigned cy = (dy + y) / 2;
+
+        for (unsigned x = dx & 1; x < width; x += 2) {
+            unsigned a = div255(alpha * sa[x]);
+            if (a <= 0)
+                continue;
+            if (semi_planar) {
+                uint8_t *duv = &dstp->p[1].p_pixels[cy * dstp->p[1].i_pitch
+                                                    + (dx + x) / 2 * 2];
+                merge(&duv[swap_uv ? 1 : 0], su[x], a);
+                merge(&duv[swap_uv ? 0 : 1], sv[x], a);
+            } else {
+                merge(&dstp->p[u_plane].p_pixels[cy * dstp->p[u_plane].i_pitch
+                                                 + (dx + x) / 2], su[x], a);
+                merge(&dstp->p[v_plane].p_pixels[cy * dstp->p[v_plane].i_pitch
+                                                 + (dx + x) / 2], sv[x], a);
+            }
+        }
+    }
+}
+
+static void BlendI420YUVASSE2(const CPicture &dst, const CPicture &src,
+                              unsigned width, unsigned height, int alpha)
+{
+    BlendYUVAOn420SSE2(dst, src, width, height, alpha, false, false);
+}
+static void BlendYV12YUVASSE2(const CPicture &dst, const CPicture &src,
+                              unsigned width, unsigned height, int alpha)
+{
+    BlendYUVAOn420SSE2(dst, src, width, height, alpha, true, false);
+}
+static void BlendNV12YUVASSE2(const CPicture &dst, const CPicture &src,
+                              unsigned width, unsigned height, int alpha)
+{
+    BlendYUVAOn420SSE2(dst, src, width, height, alpha, false, true);
+}
+static void BlendNV21YUVASSE2(const CPicture &dst, const CPicture &src,
+                              unsigned width, unsigned height, int alpha)
+{
+    BlendYUVAOn420SSE2(dst, src, width, height, alpha, true, true);
+}
+
+/* RGBA onto RGB32, 4 pixels at a time. The blend is byte-wise with the
+ * per pixel alpha broadcast over the 4 channels, so it needs the
+ * destination channels laid out like the RGBA source; anything else
+ * falls back to the scalar template. The padding byte gets blended
+ * toward the source alpha value, which is harmless as RGB32 ignores it. */
+VLC_TARGET_SSE2
+static void BlendRGB32RGBASSE2(const CPicture &dst_data, const CPicture &src_data,
+                               unsigned width, unsigned height, int alpha)
+{
+    const video_format_t *fmt = dst_data.getFormat();
+#ifdef WORDS_BIGENDIAN
+    const bool b_ordered = false;
+#else
+    const bool b_ordered = fmt->i_lrshift == 0 && fmt->i_lgshift == 8 &&
+                           fmt->i_lbshift == 16;
+#endif
+    if (!b_ordered)
+        return Blend<CPictureRGB32, CPictureRGBA,
+                     compose<convertNone, convertNone> >
+                    (dst_data, src_data, width, height, alpha);
+
+    const picture_t *dstp = dst_data.getPicture();
+    const picture_t *srcp = src_data.getPicture();
+    const unsigned dx = dst_data.getX(), dy = dst_data.getY();
+    const unsigned sx = src_data.getX(), sy = src_data.getY();
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i c255 = _mm_set1_epi16(255);
+    const __m128i gain = _mm_set1_epi16(alpha);
+
+    for (unsigned y = 0; y < height; y++) {
+        uint8_t *dst =
+            &dstp->p[0].p_pixels[(dy + y) * dstp->p[0].i_pitch + dx * 4];
+        const uint8_t *src =
+            &srcp->p[0].p_pixels[(sy + y) * srcp->p[0].i_pitch + sx * 4];
+        unsigned x = 0;
+
+        for (; x + 3 < width; x += 4) {
+            __m128i s = _mm_loadu_si128((const __m128i *)&src[4 * x]);
+            __m128i d = _mm_loadu_si128((const __m128i *)&dst[4 * x]);
+
+            /* Per pixel alpha scaled by the global alpha, then broadcast
+             * to the 4 channels of its pixel */
+            __m128i a32 = Div255SSE2(_mm_mullo_epi16(_mm_srli_epi32(s, 24),
+                                                     gain));
+            __m128i alo = _mm_unpacklo_epi32(a32, a32);
+            __m128i ahi = _mm_unpackhi_epi32(a32, a32);
+            alo = _mm_shufflehi_epi16(_mm_shufflelo_epi16(alo, _MM_SHUFFLE(2, 2, 0, 0)),
+                                      _MM_SHUFFLE(2, 2, 0, 0));
+            ahi = _mm_shufflehi_epi16(_mm_shufflelo_epi16(ahi, _MM_SHUFFLE(2, 2, 0, 0)),
+                                      _MM_SHUFFLE(2, 2, 0, 0));
+
+            __m128i dlo = _mm_add_epi16(
+                _mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), _mm_sub_epi16(c255, alo)),
+                _mm_mullo_epi16(_mm_unpacklo_epi8(s, zero), alo));
+            __m128i dhi = _mm_add_epi16(
+                _mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), _mm_sub_epi16(c255, ahi)),
+                _mm_mullo_epi16(_mm_unpackhi_epi8(s, zero), ahi));
+
+            _mm_storeu_si128((__m128i *)&dst[4 * x],
+                             _mm_packus_epi16(Div255SSE2(dlo), Div255SSE2(dhi)));
+        }
+
+        for (; x < width; x++) {
+            unsigned a = div255(alpha * src[4 * x + 3]);
+            if (a <= 0)
+                continue;
+            merge(&dst[4 * x + 0], src[4 * x + 0], a);
+            merge(&dst[4 * x + 1], src[4 * x + 1], a);
+            merge(&dst[4 * x + 2], src[4 * x + 2], a);
+        }
+    }
+}
+
+static const struct {
+    vlc_fourcc_t     dst;
+    vlc_fourcc_t     src;
+    blend_function_t blend;
+} blends_sse2[] = {
+    { VLC_CODEC_I420,  VLC_CODEC_YUVA, BlendI420YUVASSE2 },
+    { VLC_CODEC_J420,  VLC_CODEC_YUVA, BlendI420YUVASSE2 },
+    { VLC_CODEC_YV12,  VLC_CODEC_YUVA, BlendYV12YUVASSE2 },
+    { VLC_CODEC_NV12,  VLC_CODEC_YUVA, BlendNV12YUVASSE2 },
+    { VLC_CODEC_NV21,  VLC_CODEC_YUVA, BlendNV21YUVASSE2 },
+    { VLC_CODEC_RGB32, VLC_CODEC_RGBA, BlendRGB32RGBASSE2 },
+};
+#endif /* CAN_BLEND_SSE2 */
+
 struct filter_sys_t {
     filter_sys_t() : blend(NULL)
     {
@@ -674,6 +907,14 @@ static int Open(vlc_object_t *object)
         if (blends[i].src == src && blends[i].dst == dst)
             sys->blend = blends[i].blend;
     }
+#ifdef CAN_BLEND_SSE2
+    if (sys->blend && vlc_CPU_SSE2()) {
+        for (size_t i = 0; i < sizeof(blends_sse2) / sizeof(*blends_sse2); i++) {
+            if (blends_sse2[i].src == src && blends_sse2[i].dst == dst)
+                sys->blend = blends_sse2[i].blend;
+        }
+    }
+#endif
 
     if (!sys->blend) {
        msg_Err(filter, "no matching alpha blending routine (chroma: %4.4s -> %4.4s)",
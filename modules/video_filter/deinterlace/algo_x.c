@@ -537,8 +537,25 @@ static inline void XDeintBand8x8MMXEXT( uint8_t *dst, int i_dst,
  * Public functions
  *****************************************************************************/
 
-void RenderX( picture_t *p_outpic, picture_t *p_pic )
+/**
+ * Context for one slice-threaded "X" render. The algorithm works on
+ * independent 8x8 blocks (reading up to two lines below a block), so the
+ * 8-line block rows can be split freely between the slices.
+ * @see SliceThreadsRender()
+ */
+typedef struct
+{
+    picture_t *p_outpic;
+    picture_t *p_pic;
+} x_slice_ctx_t;
+
+static void RenderXSlice( filter_t *p_filter, void *p_opaque,
+                          int i_slice, int i_slices )
 {
+    VLC_UNUSED(p_filter);
+    x_slice_ctx_t *p_ctx = p_opaque;
+    picture_t *p_outpic = p_ctx->p_outpic;
+    picture_t *p_pic = p_ctx->p_pic;
     int i_plane;
 #if defined (CAN_COMPILE_MMXEXT)
     const bool mmxext = vlc_CPU_MMXEXT();
@@ -556,9 +573,12 @@ void RenderX( picture_t *p_outpic, picture_t *p_pic )
         const int i_dst = p_outpic->p[i_plane].i_pitch;
         const int i_src = p_pic->p[i_plane].i_pitch;
 
+        const int y_start = i_mby *  i_slice      / i_slices;
+        const int y_end   = i_mby * (i_slice + 1) / i_slices;
+
         int y, x;
 
-        for( y = 0; y < i_mby; y++ )
+        for( y = y_start; y < y_end; y++ )
         {
             uint8_t *dst = &p_outpic->p[i_plane].p_pixels[8*y*i_dst];
             uint8_t *src = &p_pic->p[i_plane].p_pixels[8*y*i_src];
@@ -571,11 +591,11 @@ void RenderX( picture_t *p_outpic, picture_t *p_pic )
                 XDeintBand8x8C( dst, i_dst, src, i_src, i_mbx, i_modx );
         }
 
-        /* Last line (C only)*/
-        if( i_mody )
+        /* Last line (C only), done by the last slice */
+        if( i_mody && i_slice == i_slices - 1 )
         {
-            uint8_t *dst = &p_outpic->p[i_plane].p_pixels[8*y*i_dst];
-            uint8_t *src = &p_pic->p[i_plane].p_pixels[8*y*i_src];
+            uint8_t *dst = &p_outpic->p[i_plane].p_pixels[8*i_mby*i_dst];
+            uint8_t *src = &p_pic->p[i_plane].p_pixels[8*i_mby*i_src];
 
             for( x = 0; x < i_mbx; x++ )
             {
@@ -595,3 +615,10 @@ void RenderX( picture_t *p_outpic, picture_t *p_pic )
         emms();
 #endif
 }
+
+void RenderX( filter_t *p_filter, picture_t *p_outpic, picture_t *p_pic )
+{
+    x_slice_ctx_t ctx = { .p_outpic = p_outpic, .p_pic = p_pic };
+
+    SliceThreadsRender( p_filter, RenderXSlice, &ctx );
+}
@@ -47,6 +47,82 @@
    Necessary preprocessor macros are defined in common.h. */
 #include "yadif.h"
 
+/**
+ * Context for one slice-threaded yadif render.
+ * All inputs are read only; each band writes its own output lines, so the
+ * bands are independent. @see SliceThreadsRender()
+ */
+typedef struct
+{
+    picture_t *p_dst;
+    picture_t *p_prev;
+    picture_t *p_cur;
+    picture_t *p_next;
+    int i_field;
+    int yadif_parity;
+    void (*pf_line)(uint8_t *dst, uint8_t *prev, uint8_t *cur, uint8_t *next,
+                    int w, int prefs, int mrefs, int parity, int mode);
+} yadif_slice_ctx_t;
+
+static void RenderYadifSlice( filter_t *p_filter, void *p_opaque,
+                              int i_slice, int i_slices )
+{
+    VLC_UNUSED(p_filter);
+    yadif_slice_ctx_t *p_ctx = p_opaque;
+    picture_t *p_dst = p_ctx->p_dst;
+
+    for( int n = 0; n < p_dst->i_planes; n++ )
+    {
+        const plane_t *prevp = &p_ctx->p_prev->p[n];
+        const plane_t *curp  = &p_ctx->p_cur->p[n];
+        const plane_t *nextp = &p_ctx->p_next->p[n];
+        plane_t *dstp        = &p_dst->p[n];
+
+        /* The filtered lines are [1, i_visible_lines - 1); split them
+         * between the slices. Each output line only depends on the
+         * (read only) input pictures, so any split is safe. */
+        const int i_lines = dstp->i_visible_lines - 2;
+        const int y_start = 1 + i_lines *  i_slice      / i_slices;
+        const int y_end   = 1 + i_lines * (i_slice + 1) / i_slices;
+
+        for( int y = y_start; y < y_end; y++ )
+        {
+            if( (y % 2) == p_ctx->i_field  ||  p_ctx->yadif_parity == 2 )
+            {
+                memcpy( &dstp->p_pixels[y * dstp->i_pitch],
+                            &curp->p_pixels[y * curp->i_pitch], dstp->i_visible_pitch );
+            }
+            else
+            {
+                int mode;
+                /* Spatial checks only when enough data */
+                mode = (y >= 2 && y < dstp->i_visible_lines - 2) ? 0 : 2;
+
+                assert( prevp->i_pitch == curp->i_pitch && curp->i_pitch == nextp->i_pitch );
+                p_ctx->pf_line( &dstp->p_pixels[y * dstp->i_pitch],
+                                &prevp->p_pixels[y * prevp->i_pitch],
+                                &curp->p_pixels[y * curp->i_pitch],
+                                &nextp->p_pixels[y * nextp->i_pitch],
+                                dstp->i_visible_pitch,
+                                y < dstp->i_visible_lines - 2  ? curp->i_pitch : -curp->i_pitch,
+                                y  - 1  ?  -curp->i_pitch : curp->i_pitch,
+                                p_ctx->yadif_parity,
+                                mode );
+            }
+
+            /* We duplicate the first and last lines */
+            if( y == 1 )
+                memcpy(&dstp->p_pixels[(y-1) * dstp->i_pitch],
+                           &dstp->p_pixels[ y    * dstp->i_pitch],
+                           dstp->i_pitch);
+            else if( y == dstp->i_visible_lines - 2 )
+                memcpy(&dstp->p_pixels[(y+1) * dstp->i_pitch],
+                           &dstp->p_pixels[ y    * dstp->i_pitch],
+                           dstp->i_pitch);
+        }
+    }
+}
+
 int RenderYadif( filter_t *p_filter, picture_t *p_dst, picture_t *p_src,
                  int i_order, int i_field )
 {
@@ -128,49 +204,16 @@ int RenderYadif( filter_t *p_filter, picture_t *p_dst, picture_t *p_src,
         if( p_sys->chroma->pixel_size == 2 )
             filter = yadif_filter_line_c_16bit;
 
-        for( int n = 0; n < p_dst->i_planes; n++ )
-        {
-            const plane_t *prevp = &p_prev->p[n];
-            const plane_t *curp  = &p_cur->p[n];
-            const plane_t *nextp = &p_next->p[n];
-            plane_t *dstp        = &p_dst->p[n];
-
-            for( int y = 1; y < dstp->i_visible_lines - 1; y++ )
-            {
-                if( (y % 2) == i_field  ||  yadif_parity == 2 )
-                {
-                    memcpy( &dstp->p_pixels[y * dstp->i_pitch],
-                                &curp->p_pixels[y * curp->i_pitch], dstp->i_visible_pitch );
-                }
-                else
-                {
-                    int mode;
-                    /* Spatial checks only when enough data */
-                    mode = (y >= 2 && y < dstp->i_visible_lines - 2) ? 0 : 2;
-
-                    assert( prevp->i_pitch == curp->i_pitch && curp->i_pitch == nextp->i_pitch );
-                    filter( &dstp->p_pixels[y * dstp->i_pitch],
-                            &prevp->p_pixels[y * prevp->i_pitch],
-                            &curp->p_pixels[y * curp->i_pitch],
-                            &nextp->p_pixels[y * nextp->i_pitch],
-                            dstp->i_visible_pitch,
-                            y < dstp->i_visible_lines - 2  ? curp->i_pitch : -curp->i_pitch,
-                            y  - 1  ?  -curp->i_pitch : curp->i_pitch,
-                            yadif_parity,
-                            mode );
-                }
-
-                /* We duplicate the first and last lines */
-                if( y == 1 )
-                    memcpy(&dstp->p_pixels[(y-1) * dstp->i_pitch],
-                               &dstp->p_pixels[ y    * dstp->i_pitch],
-                               dstp->i_pitch);
-                else if( y == dstp->i_visible_lines - 2 )
-                    memcpy(&dstp->p_pixels[(y+1) * dstp->i_pitch],
-                               &dstp->p_pixels[ y    * dstp->i_pitch],
-                               dstp->i_pitch);
-            }
-        }
+        yadif_slice_ctx_t ctx = {
+            .p_dst  = p_dst,
+            .p_prev = p_prev,
+            .p_cur  = p_cur,
+            .p_next = p_next,
+            .i_field = i_field,
+            .yadif_parity = yadif_parity,
+            .pf_line = filter,
+        };
+        SliceThreadsRender( p_filter, RenderYadifSlice, &ctx );
 
         p_sys->i_frame_offset = 1; /* p_cur will be rendered at next frame, too */
 
@@ -182,7 +225,7 @@ int RenderYadif( filter_t *p_filter, picture_t *p_dst, picture_t *p_src,
                  as set by Open() or SetFilterMethod(). It is always 0. */
 
         /* FIXME not good as it does not use i_order/i_field */
-        RenderX( p_dst, p_next );
+        RenderX( p_filter, p_dst, p_next );
         return VLC_SUCCESS;
     }
     else
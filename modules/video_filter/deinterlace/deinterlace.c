@@ -85,6 +85,12 @@
                                     "Best simulation, but requires more CPU "\
                                     "and memory bandwidth.")
 
+#define THREADS_TEXT N_("Deinterlace threads")
+#define THREADS_LONGTEXT N_("Number of threads used to deinterlace a frame "\
+                            "in parallel horizontal bands (0 for one per "\
+                            "CPU core). Only the yadif and x algorithms "\
+                            "use slice threading.")
+
 #define PHOSPHOR_DIMMER_TEXT N_("Phosphor old field dimmer strength")
 #define PHOSPHOR_DIMMER_LONGTEXT N_("This controls the strength of the "\
                                     "darkening filter that simulates CRT TV "\
@@ -103,6 +109,9 @@ vlc_module_begin ()
                 SOUT_MODE_LONGTEXT, false )
         change_string_list( mode_list, mode_list_text )
         change_safe ()
+    add_integer( FILTER_CFG_PREFIX "threads", 0, THREADS_TEXT,
+                THREADS_LONGTEXT, true )
+        change_safe ()
     add_integer( FILTER_CFG_PREFIX "phosphor-chroma", 2, PHOSPHOR_CHROMA_TEXT,
                 PHOSPHOR_CHROMA_LONGTEXT, true )
         change_integer_list( phosphor_chroma_list, phosphor_chroma_list_text )
@@ -126,7 +135,7 @@ vlc_module_end ()
  * and reading logic for them implemented in Open().
  */
 static const char *const ppsz_filter_options[] = {
-    "mode", "phosphor-chroma", "phosphor-dimmer",
+    "mode", "threads", "phosphor-chroma", "phosphor-dimmer",
     NULL
 };
 
@@ -469,7 +478,7 @@ picture_t *Deinterlace( filter_t *p_filter, picture_t *p_pic )
             break;
 
         case DEINTERLACE_X:
-            RenderX( p_dst[0], p_pic );
+            RenderX( p_filter, p_dst[0], p_pic );
             break;
 
         case DEINTERLACE_YADIF:
@@ -663,6 +672,9 @@ notsupp:
 
     IVTCClearState( p_filter );
 
+    SliceThreadsInit( p_filter,
+                      var_GetInteger( p_filter, FILTER_CFG_PREFIX "threads" ) );
+
 #if defined(CAN_COMPILE_C_ALTIVEC)
     if( pixel_size == 1 && vlc_CPU_ALTIVEC() )
         p_sys->pf_merge = MergeAltivec;
@@ -774,5 +786,6 @@ void Close( vlc_object_t *p_this )
     filter_t *p_filter = (filter_t*)p_this;
 
     Flush( p_filter );
+    SliceThreadsDestroy( p_filter );
     free( p_filter->p_sys );
 }
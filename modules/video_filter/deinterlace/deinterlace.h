@@ -37,6 +37,7 @@ struct vlc_object_t;
 #include <vlc_mouse.h>
 
 /* Local algorithm headers */
+#include "slice.h"
 #include "algo_basic.h"
 #include "algo_x.h"
 #include "algo_yadif.h"
@@ -118,6 +119,9 @@ struct filter_sys_t
     /** Input frame history buffer for algorithms with temporal filtering. */
     picture_t *pp_history[HISTORY_SIZE];
 
+    /** Slice threading state for the band-parallel algorithms. */
+    slice_sys_t slices;
+
     /* Algorithm-specific substructures */
     phosphor_sys_t phosphor; /**< Phosphor algorithm state. */
     ivtc_sys_t ivtc;         /**< IVTC algorithm state. */
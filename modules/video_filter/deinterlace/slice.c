@@ -0,0 +1,145 @@
+/*****************************************************************************
+ * slice.c : slice threading for the VLC deinterlacer
+ *****************************************************************************
+ * Copyright (C) 2000-2016 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+#   include "config.h"
+#endif
+
+#include <vlc_common.h>
+#include <vlc_filter.h>
+
+#include "deinterlace.h" /* filter_sys_t */
+
+#include "slice.h"
+
+static void *SliceThread( void *p_data )
+{
+    slice_worker_t *p_worker = p_data;
+    filter_sys_t *p_sys = p_worker->p_filter->p_sys;
+    slice_sys_t *p_slices = &p_sys->slices;
+    unsigned i_generation = 0;
+
+    vlc_mutex_lock( &p_slices->lock );
+    for( ;; )
+    {
+        while( !p_slices->b_exit && p_slices->i_generation == i_generation )
+            vlc_cond_wait( &p_slices->wait_job, &p_slices->lock );
+        if( p_slices->b_exit )
+            break;
+        i_generation = p_slices->i_generation;
+        vlc_mutex_unlock( &p_slices->lock );
+
+        p_slices->pf_render( p_worker->p_filter, p_slices->p_ctx,
+                             p_worker->i_index, p_slices->i_threads );
+
+        vlc_mutex_lock( &p_slices->lock );
+        if( --p_slices->i_pending == 0 )
+            vlc_cond_signal( &p_slices->wait_done );
+    }
+    vlc_mutex_unlock( &p_slices->lock );
+    return NULL;
+}
+
+int SliceThreadsInit( filter_t *p_filter, unsigned i_requested )
+{
+    filter_sys_t *p_sys = p_filter->p_sys;
+    slice_sys_t *p_slices = &p_sys->slices;
+
+    p_slices->i_threads = 1;
+    p_slices->i_generation = 0;
+    p_slices->i_pending = 0;
+    p_slices->b_exit = false;
+    vlc_mutex_init( &p_slices->lock );
+    vlc_cond_init( &p_slices->wait_job );
+    vlc_cond_init( &p_slices->wait_done );
+
+    if( i_requested == 0 )
+        i_requested = vlc_GetCPUCount();
+    if( i_requested > SLICE_MAX_THREADS )
+        i_requested = SLICE_MAX_THREADS;
+    /* Do not bother with bands thinner than 32 lines */
+    if( i_requested > p_filter->fmt_in.video.i_height / 32 )
+        i_requested = p_filter->fmt_in.video.i_height / 32;
+    if( i_requested <= 1 )
+        return VLC_SUCCESS;
+
+    /* Slice 0 belongs to the filter thread, spawn workers for the rest.
+     * Running short of threads just means fewer slices. */
+    unsigned i;
+    for( i = 1; i < i_requested; i++ )
+    {
+        p_slices->worker[i].p_filter = p_filter;
+        p_slices->worker[i].i_index = i;
+        if( vlc_clone( &p_slices->thread[i], SliceThread,
+                       &p_slices->worker[i], VLC_THREAD_PRIORITY_VIDEO ) )
+            break;
+    }
+    p_slices->i_threads = i;
+
+    if( i > 1 )
+        msg_Dbg( p_filter, "using %u deinterlace slices", i );
+    return VLC_SUCCESS;
+}
+
+void SliceThreadsDestroy( filter_t *p_filter )
+{
+    slice_sys_t *p_slices = &p_filter->p_sys->slices;
+
+    if( p_slices->i_threads > 1 )
+    {
+        vlc_mutex_lock( &p_slices->lock );
+        p_slices->b_exit = true;
+        vlc_cond_broadcast( &p_slices->wait_job );
+        vlc_mutex_unlock( &p_slices->lock );
+
+        for( unsigned i = 1; i < p_slices->i_threads; i++ )
+            vlc_join( p_slices->thread[i], NULL );
+    }
+    vlc_cond_destroy( &p_slices->wait_done );
+    vlc_cond_destroy( &p_slices->wait_job );
+    vlc_mutex_destroy( &p_slices->lock );
+}
+
+void SliceThreadsRender( filter_t *p_filter, slice_render_cb pf_render,
+                         void *p_ctx )
+{
+    slice_sys_t *p_slices = &p_filter->p_sys->slices;
+
+    if( p_slices->i_threads <= 1 )
+    {
+        pf_render( p_filter, p_ctx, 0, 1 );
+        return;
+    }
+
+    vlc_mutex_lock( &p_slices->lock );
+    p_slices->pf_render = pf_render;
+    p_slices->p_ctx = p_ctx;
+    p_slices->i_pending = p_slices->i_threads - 1;
+    p_slices->i_generation++;
+    vlc_cond_broadcast( &p_slices->wait_job );
+    vlc_mutex_unlock( &p_slices->lock );
+
+    pf_render( p_filter, p_ctx, 0, p_slices->i_threads );
+
+    vlc_mutex_lock( &p_slices->lock );
+    while( p_slices->i_pending > 0 )
+        vlc_cond_wait( &p_slices->wait_done, &p_slices->lock );
+    vlc_mutex_unlock( &p_slices->lock );
+}
@@ -0,0 +1,101 @@
+/*****************************************************************************
+ * slice.h : slice threading for the VLC deinterlacer
+ *****************************************************************************
+ * Copyright (C) 2000-2016 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef VLC_DEINTERLACE_SLICE_H
+#define VLC_DEINTERLACE_SLICE_H 1
+
+#include <vlc_common.h>
+
+/* Forward declarations */
+struct filter_t;
+
+/** Maximum number of slices (and thus worker threads). */
+#define SLICE_MAX_THREADS 8
+
+/**
+ * Renders slice i_slice out of i_slices horizontal bands of a picture.
+ * How the lines are split between the bands is up to the callback; the
+ * bands must be independent, as they are rendered concurrently.
+ */
+typedef void (*slice_render_cb)( filter_t *p_filter, void *p_ctx,
+                                 int i_slice, int i_slices );
+
+/**
+ * One worker of the slice pool.
+ */
+typedef struct
+{
+    filter_t *p_filter;
+    unsigned i_index;
+} slice_worker_t;
+
+/**
+ * Slice pool state, embedded in filter_sys_t.
+ *
+ * The workers are persistent: they are spawned once in Open() and render
+ * one band of each job dispatched by SliceThreadsRender(). Slice 0 is
+ * always rendered by the calling (filter) thread.
+ */
+typedef struct
+{
+    unsigned i_threads;        /**< Total slices; 1 means no threading. */
+    slice_worker_t worker[SLICE_MAX_THREADS];
+    vlc_thread_t thread[SLICE_MAX_THREADS];
+    vlc_mutex_t lock;
+    vlc_cond_t wait_job;
+    vlc_cond_t wait_done;
+    unsigned i_generation;     /**< Job sequence number. */
+    unsigned i_pending;        /**< Workers still busy on the job. */
+    bool b_exit;
+
+    /* Current job */
+    slice_render_cb pf_render;
+    void *p_ctx;
+} slice_sys_t;
+
+/*****************************************************************************
+ * Functions
+ *****************************************************************************/
+
+/**
+ * Initializes the slice pool and spawns the worker threads.
+ *
+ * @param p_filter The filter instance; p_sys must already be allocated.
+ * @param i_requested Requested number of slices; 0 for one per CPU core.
+ * @return VLC error code (success allowed). Running short of threads
+ *         degrades to fewer slices, never to failure.
+ */
+int SliceThreadsInit( filter_t *p_filter, unsigned i_requested );
+
+/**
+ * Stops the workers and releases the pool. Safe to call after a
+ * successful SliceThreadsInit() only.
+ */
+void SliceThreadsDestroy( filter_t *p_filter );
+
+/**
+ * Renders one picture split into bands: the callback is invoked once per
+ * slice, concurrently, and this only returns when all slices are done.
+ * Without threads, the callback is invoked once for the whole picture.
+ */
+void SliceThreadsRender( filter_t *p_filter, slice_render_cb pf_render,
+                         void *p_ctx );
+
+#endif
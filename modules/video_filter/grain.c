@@ -279,7 +279,7 @@ static picture_t *Filter(filter_t *filter, picture_t *src)
                                      sys->bank_uv;
             PlaneFilter(filter, dstp, srcp, bank, &sys->seed);
         }
-        else {
+        else if (dstp->p_pixels != srcp->p_pixels) {
             plane_CopyPixels(dstp, srcp);
         }
     }
@@ -421,6 +421,8 @@ static int Open(vlc_object_t *object)
 
     filter->p_sys           = sys;
     filter->pf_video_filter = Filter;
+    /* Block-local read-modify-write, no neighbour reads */
+    filter->b_allow_in_place = true;
     return VLC_SUCCESS;
 }
 
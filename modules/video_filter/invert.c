@@ -77,6 +77,8 @@ static int Create( vlc_object_t *p_this )
         return VLC_EGENERIC;
 
     p_filter->pf_video_filter = Filter;
+    /* Strictly per-pixel processing */
+    p_filter->b_allow_in_place = true;
     return VLC_SUCCESS;
 }
 
@@ -116,9 +118,10 @@ static picture_t *Filter( filter_t *p_filter, picture_t *p_pic )
     {
         /* We don't want to invert the alpha plane */
         i_planes = p_pic->i_planes - 1;
-        memcpy(
-            p_outpic->p[A_PLANE].p_pixels, p_pic->p[A_PLANE].p_pixels,
-            p_pic->p[A_PLANE].i_pitch *  p_pic->p[A_PLANE].i_lines );
+        if( p_outpic->p[A_PLANE].p_pixels != p_pic->p[A_PLANE].p_pixels )
+            memcpy(
+                p_outpic->p[A_PLANE].p_pixels, p_pic->p[A_PLANE].p_pixels,
+                p_pic->p[A_PLANE].i_pitch *  p_pic->p[A_PLANE].i_lines );
     }
     else
     {
@@ -127,6 +127,9 @@ typedef struct
     int i_alpha;       /* -1 means use default alpha */
     picture_t *p_pic;
 
+    picture_t *p_cache;  /* copy with i_cache_alpha folded in the A plane */
+    int i_cache_alpha;
+
 } logo_t;
 
 /**
@@ -198,6 +201,7 @@ static void LogoListLoad( vlc_object_t *, logo_list_t *, const char * );
 static void LogoListUnload( logo_list_t * );
 static logo_t *LogoListNext( logo_list_t *p_list, mtime_t i_date );
 static logo_t *LogoListCurrent( logo_list_t *p_list );
+static picture_t *LogoGetBlendPicture( logo_t *p_logo, int *pi_alpha );
 
 /**
  * Open the sub source
@@ -395,8 +399,12 @@ static subpicture_t *FilterSub( filter_t *p_filter, mtime_t date )
         goto exit;
     }
 
-    /* */
-    picture_Copy( p_region->p_picture, p_pic );
+    /* Fold the opacity into the region so that the SPU engine blends at
+     * full alpha and the copy stays stable across renders */
+    int i_alpha = ( p_logo->i_alpha != -1 ?
+                    p_logo->i_alpha : p_list->i_alpha );
+    picture_Copy( p_region->p_picture,
+                  LogoGetBlendPicture( p_logo, &i_alpha ) );
 
     /*  where to locate the logo: */
     if( p_sys->i_pos < 0 )
@@ -415,8 +423,7 @@ static subpicture_t *FilterSub( filter_t *p_filter, mtime_t date )
 
     p_spu->p_region = p_region;
 
-    p_spu->i_alpha = ( p_logo->i_alpha != -1 ?
-                       p_logo->i_alpha : p_list->i_alpha );
+    p_spu->i_alpha = i_alpha;
 
 exit:
     vlc_mutex_unlock( &p_sys->lock );
@@ -495,10 +502,11 @@ static picture_t *FilterVideo( filter_t *p_filter, picture_t *p_src )
         }
 
         /* */
-        const int i_alpha = p_logo->i_alpha != -1 ? p_logo->i_alpha : p_list->i_alpha;
+        int i_alpha = p_logo->i_alpha != -1 ? p_logo->i_alpha : p_list->i_alpha;
+        picture_t *p_blend_pic = LogoGetBlendPicture( p_logo, &i_alpha );
         if( filter_ConfigureBlend( p_sys->p_blend, i_dst_w, i_dst_h, p_fmt ) ||
             filter_Blend( p_sys->p_blend, p_dst, p_sys->i_pos_x, p_sys->i_pos_y,
-                          p_pic, i_alpha ) )
+                          p_blend_pic, i_alpha ) )
         {
             msg_Err( p_filter, "failed to blend a picture" );
         }
@@ -725,6 +733,8 @@ static void LogoListUnload( logo_list_t *p_list )
 
         if( p_logo->p_pic )
             picture_Release( p_logo->p_pic );
+        if( p_logo->p_cache )
+            picture_Release( p_logo->p_cache );
     }
     free( p_list->p_logo );
 }
@@ -750,3 +760,60 @@ static logo_t *LogoListCurrent( logo_list_t *p_list )
     return &p_list->p_logo[p_list->i_counter];
 }
 
+/**
+ * Return a blend source with *pi_alpha folded into the alpha plane.
+ *
+ * The blend code multiplies every source alpha sample by the configured
+ * opacity on each and every frame.  The logo and its opacity hardly ever
+ * change, so the opacity is folded once into a cached copy of the picture
+ * which is then blended at full opacity.  On allocation failure the
+ * original picture is returned and *pi_alpha is left for the caller to
+ * pass down.
+ */
+static picture_t *LogoGetBlendPicture( logo_t *p_logo, int *pi_alpha )
+{
+    picture_t *p_pic = p_logo->p_pic;
+    const int i_alpha = *pi_alpha;
+
+    if( i_alpha == 255 )
+        return p_pic;
+
+    if( !p_logo->p_cache )
+    {
+        p_logo->p_cache = picture_NewFromFormat( &p_pic->format );
+        if( !p_logo->p_cache )
+            return p_pic;
+        p_logo->i_cache_alpha = -1;
+
+        for( int i = 0; i < p_pic->i_planes; i++ )
+        {
+            if( i != A_PLANE )
+                plane_CopyPixels( &p_logo->p_cache->p[i], &p_pic->p[i] );
+        }
+    }
+
+    if( p_logo->i_cache_alpha != i_alpha )
+    {
+        const plane_t *p_srcp = &p_pic->p[A_PLANE];
+        plane_t *p_dstp = &p_logo->p_cache->p[A_PLANE];
+
+        for( int i = 0; i < p_srcp->i_visible_lines; i++ )
+        {
+            const uint8_t *p_in = &p_srcp->p_pixels[i * p_srcp->i_pitch];
+            uint8_t *p_out = &p_dstp->p_pixels[i * p_dstp->i_pitch];
+
+            for( int j = 0; j < p_srcp->i_visible_pitch; j++ )
+            {
+                /* Same rounding as the blend filter div255() so the folded
+                 * copy blends exactly like the original would */
+                unsigned a = p_in[j] * i_alpha;
+                p_out[j] = ((a >> 8) + a + 1) >> 8;
+            }
+        }
+        p_logo->i_cache_alpha = i_alpha;
+    }
+
+    *pi_alpha = 255;
+    return p_logo->p_cache;
+}
+
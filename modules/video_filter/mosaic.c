@@ -42,6 +42,9 @@
 
 #define BLANK_DELAY INT64_C(1000000)
 
+/* Upper bound on the transient threads converting mosaic tiles */
+#define MOSAIC_MAX_CONV_THREADS 8
+
 /*****************************************************************************
  * Local prototypes
  *****************************************************************************/
@@ -60,6 +63,8 @@ struct filter_sys_t
     vlc_mutex_t lock;         /* Internal filter lock */
 
     image_handler_t *p_image;
+    /* Extra converters, one per additional conversion thread ([0] unused) */
+    image_handler_t *pp_image[MOSAIC_MAX_CONV_THREADS];
 
     int i_position;           /* Mosaic positioning method */
     bool b_ar;          /* Do we keep the aspect ratio ? */
@@ -332,6 +337,7 @@ static int CreateFilter( vlc_object_t *p_this )
     {
         p_sys->p_image = image_HandlerCreate( p_filter );
     }
+    memset( p_sys->pp_image, 0, sizeof( p_sys->pp_image ) );
 
     p_sys->i_order_length = 0;
     p_sys->ppsz_order = NULL;
@@ -405,6 +411,11 @@ static void DestroyFilter( vlc_object_t *p_this )
     {
         image_HandlerDelete( p_sys->p_image );
     }
+    for( int i = 1; i < MOSAIC_MAX_CONV_THREADS; i++ )
+    {
+        if( p_sys->pp_image[i] )
+            image_HandlerDelete( p_sys->pp_image[i] );
+    }
 
     if( p_sys->i_order_length )
     {
@@ -425,6 +436,50 @@ static void DestroyFilter( vlc_object_t *p_this )
     free( p_sys );
 }
 
+/*****************************************************************************
+ * Tile conversion
+ *****************************************************************************
+ * One tile per displayable elementary stream.  The selection pass fills the
+ * array sequentially, the conversions then run in parallel (they do not
+ * touch shared state as long as the mosaic locks are held), and the region
+ * pass reassembles the subpicture in order.
+ *****************************************************************************/
+typedef struct
+{
+    bridged_es_t *p_es;
+    video_format_t fmt_in;
+    video_format_t fmt_out;
+    picture_t *p_converted;  /* NULL until converted, or on failure */
+    int i_real_index;
+    int i_row, i_col;
+} mosaic_tile_t;
+
+typedef struct
+{
+    image_handler_t *p_image;
+    mosaic_tile_t *p_tiles;
+    int i_tiles;
+    int i_first, i_stride;
+    vlc_thread_t thread;
+} mosaic_conv_slice_t;
+
+static void *ConvertTiles( void *p_data )
+{
+    mosaic_conv_slice_t *p_slice = p_data;
+
+    for( int i = p_slice->i_first; i < p_slice->i_tiles;
+         i += p_slice->i_stride )
+    {
+        mosaic_tile_t *p_tile = &p_slice->p_tiles[i];
+
+        p_tile->p_converted = image_Convert( p_slice->p_image,
+                                             p_tile->p_es->p_picture,
+                                             &p_tile->fmt_in,
+                                             &p_tile->fmt_out );
+    }
+    return NULL;
+}
+
 /*****************************************************************************
  * Filter
  *****************************************************************************/
@@ -519,16 +574,22 @@ static subpicture_t *Filter( filter_t *p_filter, mtime_t date )
     row_inner_height = ( ( p_sys->i_height - ( p_sys->i_rows - 1 )
                        * p_sys->i_borderh ) / p_sys->i_rows );
 
+    mosaic_tile_t *p_tiles = calloc( p_bridge->i_es_num, sizeof( *p_tiles ) );
+    if( !p_tiles )
+    {
+        vlc_global_unlock( VLC_MOSAIC_MUTEX );
+        vlc_mutex_unlock( &p_sys->lock );
+        return p_spu;
+    }
+    int i_tiles = 0;
+
     i_real_index = 0;
 
+    /* First pass: pick the pictures to display and compute the tile
+     * geometry */
     for( int i_index = 0; i_index < p_bridge->i_es_num; i_index++ )
     {
         bridged_es_t *p_es = p_bridge->pp_es[i_index];
-        video_format_t fmt_in, fmt_out;
-        picture_t *p_converted;
-
-        memset( &fmt_in, 0, sizeof( video_format_t ) );
-        memset( &fmt_out, 0, sizeof( video_format_t ) );
 
         if ( p_es->b_empty )
             continue;
@@ -585,68 +646,155 @@ static subpicture_t *Filter( filter_t *p_filter, mtime_t date )
         i_row = ( i_real_index / p_sys->i_cols ) % p_sys->i_rows;
         i_col = i_real_index % p_sys->i_cols ;
 
+        mosaic_tile_t *p_tile = &p_tiles[i_tiles++];
+        p_tile->p_es = p_es;
+        p_tile->i_real_index = i_real_index;
+        p_tile->i_row = i_row;
+        p_tile->i_col = i_col;
+
         if ( !p_sys->b_keep )
         {
-            /* Convert the images */
-            fmt_in.i_chroma = p_es->p_picture->format.i_chroma;
-            fmt_in.i_height = p_es->p_picture->format.i_height;
-            fmt_in.i_width = p_es->p_picture->format.i_width;
-
-            if( fmt_in.i_chroma == VLC_CODEC_YUVA ||
-                fmt_in.i_chroma == VLC_CODEC_RGBA )
-                fmt_out.i_chroma = VLC_CODEC_YUVA;
+            /* Size the converted images */
+            p_tile->fmt_in.i_chroma = p_es->p_picture->format.i_chroma;
+            p_tile->fmt_in.i_height = p_es->p_picture->format.i_height;
+            p_tile->fmt_in.i_width = p_es->p_picture->format.i_width;
+
+            if( p_tile->fmt_in.i_chroma == VLC_CODEC_YUVA ||
+                p_tile->fmt_in.i_chroma == VLC_CODEC_RGBA )
+                p_tile->fmt_out.i_chroma = VLC_CODEC_YUVA;
             else
-                fmt_out.i_chroma = VLC_CODEC_I420;
-            fmt_out.i_width = col_inner_width;
-            fmt_out.i_height = row_inner_height;
+                p_tile->fmt_out.i_chroma = VLC_CODEC_I420;
+            p_tile->fmt_out.i_width = col_inner_width;
+            p_tile->fmt_out.i_height = row_inner_height;
 
             if( p_sys->b_ar ) /* keep aspect ratio */
             {
-                if( (float)fmt_out.i_width / (float)fmt_out.i_height
-                      > (float)fmt_in.i_width / (float)fmt_in.i_height )
+                if( (float)p_tile->fmt_out.i_width
+                        / (float)p_tile->fmt_out.i_height
+                      > (float)p_tile->fmt_in.i_width
+                        / (float)p_tile->fmt_in.i_height )
                 {
-                    fmt_out.i_width = ( fmt_out.i_height * fmt_in.i_width )
-                                         / fmt_in.i_height;
+                    p_tile->fmt_out.i_width =
+                        ( p_tile->fmt_out.i_height * p_tile->fmt_in.i_width )
+                            / p_tile->fmt_in.i_height;
                 }
                 else
                 {
-                    fmt_out.i_height = ( fmt_out.i_width * fmt_in.i_height )
-                                        / fmt_in.i_width;
+                    p_tile->fmt_out.i_height =
+                        ( p_tile->fmt_out.i_width * p_tile->fmt_in.i_height )
+                            / p_tile->fmt_in.i_width;
                 }
              }
 
-            fmt_out.i_visible_width = fmt_out.i_width;
-            fmt_out.i_visible_height = fmt_out.i_height;
+            p_tile->fmt_out.i_visible_width = p_tile->fmt_out.i_width;
+            p_tile->fmt_out.i_visible_height = p_tile->fmt_out.i_height;
+        }
+        else
+        {
+            p_tile->p_converted = p_es->p_picture;
+            p_tile->fmt_in.i_width = p_tile->fmt_out.i_width =
+                p_tile->p_converted->format.i_width;
+            p_tile->fmt_in.i_height = p_tile->fmt_out.i_height =
+                p_tile->p_converted->format.i_height;
+            p_tile->fmt_in.i_chroma = p_tile->fmt_out.i_chroma =
+                p_tile->p_converted->format.i_chroma;
+            p_tile->fmt_out.i_visible_width = p_tile->fmt_out.i_width;
+            p_tile->fmt_out.i_visible_height = p_tile->fmt_out.i_height;
+        }
+    }
+
+    /* Second pass: scale and convert the tiles, split across cores.  The
+     * source pictures and the tile array are not modified while the mosaic
+     * locks are held, and the workers write to disjoint tile indexes. */
+    if( !p_sys->b_keep && i_tiles > 0 )
+    {
+        mosaic_conv_slice_t slice[MOSAIC_MAX_CONV_THREADS];
+        bool b_thread[MOSAIC_MAX_CONV_THREADS] = { false };
+
+        int i_threads = __MIN( i_tiles, (int)vlc_GetCPUCount() );
+        if( i_threads > MOSAIC_MAX_CONV_THREADS )
+            i_threads = MOSAIC_MAX_CONV_THREADS;
 
-            p_converted = image_Convert( p_sys->p_image, p_es->p_picture,
-                                         &fmt_in, &fmt_out );
-            if( !p_converted )
+        /* Converters are stateful, lazily create one per extra worker */
+        for( int i = 1; i < i_threads; i++ )
+        {
+            if( !p_sys->pp_image[i] &&
+                !( p_sys->pp_image[i] = image_HandlerCreate( p_filter ) ) )
             {
-                msg_Warn( p_filter,
-                           "image resizing and chroma conversion failed" );
-                continue;
+                i_threads = i;
+                break;
             }
         }
-        else
+
+        for( int i = 0; i < i_threads; i++ )
+        {
+            slice[i].p_image = i == 0 ? p_sys->p_image : p_sys->pp_image[i];
+            slice[i].p_tiles = p_tiles;
+            slice[i].i_tiles = i_tiles;
+            slice[i].i_first = i;
+            slice[i].i_stride = i_threads;
+            if( i > 0 )
+                b_thread[i] = vlc_clone( &slice[i].thread, ConvertTiles,
+                                         &slice[i],
+                                         VLC_THREAD_PRIORITY_VIDEO ) == 0;
+        }
+
+        /* Our own share, then the share of any worker that failed to
+         * spawn */
+        ConvertTiles( &slice[0] );
+        for( int i = 1; i < i_threads; i++ )
+        {
+            if( b_thread[i] )
+                vlc_join( slice[i].thread, NULL );
+            else
+                ConvertTiles( &slice[i] );
+        }
+    }
+
+    /* Third pass: build the subpicture regions in mosaic order */
+    for( int i_tile = 0; i_tile < i_tiles; i_tile++ )
+    {
+        mosaic_tile_t *p_tile = &p_tiles[i_tile];
+        bridged_es_t *p_es = p_tile->p_es;
+        const video_format_t *p_fmt_out = &p_tile->fmt_out;
+        picture_t *p_converted = p_tile->p_converted;
+
+        i_real_index = p_tile->i_real_index;
+        i_row = p_tile->i_row;
+        i_col = p_tile->i_col;
+
+        if( !p_converted )
         {
-            p_converted = p_es->p_picture;
-            fmt_in.i_width = fmt_out.i_width = p_converted->format.i_width;
-            fmt_in.i_height = fmt_out.i_height = p_converted->format.i_height;
-            fmt_in.i_chroma = fmt_out.i_chroma = p_converted->format.i_chroma;
-            fmt_out.i_visible_width = fmt_out.i_width;
-            fmt_out.i_visible_height = fmt_out.i_height;
+            msg_Warn( p_filter,
+                       "image resizing and chroma conversion failed" );
+            continue;
         }
 
-        p_region = subpicture_region_New( &fmt_out );
-        /* FIXME the copy is probably not needed anymore */
+        p_region = subpicture_region_New( p_fmt_out );
         if( p_region )
-            picture_Copy( p_region->p_picture, p_converted );
-        if( !p_sys->b_keep )
+        {
+            /* Hand the converted picture over instead of copying it */
+            if( !p_sys->b_keep )
+            {
+                picture_Release( p_region->p_picture );
+                p_region->p_picture = p_converted;
+            }
+            else
+                picture_Copy( p_region->p_picture, p_converted );
+        }
+        else if( !p_sys->b_keep )
             picture_Release( p_converted );
 
         if( !p_region )
         {
             msg_Err( p_filter, "cannot allocate SPU region" );
+            if( !p_sys->b_keep )
+            {
+                for( int i = i_tile + 1; i < i_tiles; i++ )
+                    if( p_tiles[i].p_converted )
+                        picture_Release( p_tiles[i].p_converted );
+            }
+            free( p_tiles );
             subpicture_Delete( p_spu );
             vlc_global_unlock( VLC_MOSAIC_MUTEX );
             vlc_mutex_unlock( &p_sys->lock );
@@ -665,7 +813,7 @@ static subpicture_t *Filter( filter_t *p_filter, mtime_t date )
         }
         else
         {
-            if( fmt_out.i_width > col_inner_width ||
+            if( p_fmt_out->i_width > col_inner_width ||
                 p_sys->b_ar || p_sys->b_keep )
             {
                 /* we don't have to center the video since it takes the
@@ -680,10 +828,10 @@ static subpicture_t *Filter( filter_t *p_filter, mtime_t date )
                 p_region->i_x = p_sys->i_xoffset
                         + i_col * ( p_sys->i_width / p_sys->i_cols )
                         + ( i_col * p_sys->i_borderw ) / p_sys->i_cols
-                        + ( col_inner_width - fmt_out.i_width ) / 2;
+                        + ( col_inner_width - p_fmt_out->i_width ) / 2;
             }
 
-            if( fmt_out.i_height > row_inner_height
+            if( p_fmt_out->i_height > row_inner_height
                 || p_sys->b_ar || p_sys->b_keep )
             {
                 /* we don't have to center the video since it takes the
@@ -698,7 +846,7 @@ static subpicture_t *Filter( filter_t *p_filter, mtime_t date )
                 p_region->i_y = p_sys->i_yoffset
                         + i_row * ( p_sys->i_height / p_sys->i_rows )
                         + ( i_row * p_sys->i_borderh ) / p_sys->i_rows
-                        + ( row_inner_height - fmt_out.i_height ) / 2;
+                        + ( row_inner_height - p_fmt_out->i_height ) / 2;
             }
         }
         p_region->i_align = p_sys->i_align;
@@ -716,6 +864,8 @@ static subpicture_t *Filter( filter_t *p_filter, mtime_t date )
         p_region_prev = p_region;
     }
 
+    free( p_tiles );
+
     vlc_global_unlock( VLC_MOSAIC_MUTEX );
     vlc_mutex_unlock( &p_sys->lock );
 
@@ -38,15 +38,24 @@
  * Local prototypes
  ****************************************************************************/
 static int  OpenFilter ( vlc_object_t * );
+static void CloseFilter( vlc_object_t * );
 static picture_t *Filter( filter_t *, picture_t * );
 
+/* Source column index for each destination column, so the per-pixel clamp
+ * and shift are paid once per plane instead of once per pixel */
+struct filter_sys_t
+{
+    int    *p_offsets;
+    size_t  i_offsets;
+};
+
 /*****************************************************************************
  * Module descriptor
  *****************************************************************************/
 vlc_module_begin ()
     set_description( N_("Video scaling filter") )
     set_capability( "video filter2", 10 )
-    set_callbacks( OpenFilter, NULL )
+    set_callbacks( OpenFilter, CloseFilter )
 vlc_module_end ()
 
 /*****************************************************************************
@@ -71,6 +80,13 @@ static int OpenFilter( vlc_object_t *p_this )
     if( p_filter->fmt_in.video.orientation != p_filter->fmt_out.video.orientation )
         return VLC_EGENERIC;
 
+    filter_sys_t *p_sys = malloc( sizeof( *p_sys ) );
+    if( !p_sys )
+        return VLC_ENOMEM;
+    p_sys->p_offsets = NULL;
+    p_sys->i_offsets = 0;
+    p_filter->p_sys = p_sys;
+
     video_format_ScaleCropAr( &p_filter->fmt_out.video, &p_filter->fmt_in.video );
     p_filter->pf_video_filter = Filter;
 
@@ -81,6 +97,45 @@ static int OpenFilter( vlc_object_t *p_this )
     return VLC_SUCCESS;
 }
 
+/*****************************************************************************
+ * CloseFilter: clean up the filter
+ *****************************************************************************/
+static void CloseFilter( vlc_object_t *p_this )
+{
+    filter_t *p_filter = (filter_t*)p_this;
+    filter_sys_t *p_sys = p_filter->p_sys;
+
+    free( p_sys->p_offsets );
+    free( p_sys );
+}
+
+#define SHIFT_SIZE 16
+
+/* Fills the column offset table for one plane.
+ * Returns NULL on allocation failure. */
+static const int *GetOffsets( filter_t *p_filter, size_t i_count,
+                              int i_width_coef, int i_shift_width,
+                              int i_src_width_1 )
+{
+    filter_sys_t *p_sys = p_filter->p_sys;
+
+    if( i_count > p_sys->i_offsets )
+    {
+        int *p_offsets = realloc( p_sys->p_offsets,
+                                  i_count * sizeof( *p_offsets ) );
+        if( !p_offsets )
+            return NULL;
+        p_sys->p_offsets = p_offsets;
+        p_sys->i_offsets = i_count;
+    }
+
+    int k = 1<<(SHIFT_SIZE-i_shift_width);
+    for( size_t x = 0; x < i_count; x++, k += i_width_coef )
+        p_sys->p_offsets[x] = __MIN( i_src_width_1, k >> SHIFT_SIZE );
+
+    return p_sys->p_offsets;
+}
+
 /****************************************************************************
  * Filter: the whole thing
  ****************************************************************************/
@@ -124,8 +179,6 @@ static picture_t *Filter( filter_t *p_filter, picture_t *p_pic )
                                        p_pic_dst->p[i_plane].i_visible_lines;
             const int i_dst_visible_pitch =
                                        p_pic_dst->p[i_plane].i_visible_pitch;
-            const int i_dst_hidden_pitch  = i_dst_pitch - i_dst_visible_pitch;
-#define SHIFT_SIZE 16
             const int i_height_coef  = ( i_src_height << SHIFT_SIZE )
                                        / i_dst_height;
             const int i_width_coef   = ( i_src_width << SHIFT_SIZE )
@@ -135,25 +188,40 @@ static picture_t *Filter( filter_t *p_filter, picture_t *p_pic )
 
             uint8_t *p_src = p_pic->p[i_plane].p_pixels;
             uint8_t *p_dst = p_pic_dst->p[i_plane].p_pixels;
-            uint8_t *p_dstendline = p_dst + i_dst_visible_pitch;
-            const uint8_t *p_dstend = p_dst + i_dst_visible_lines*i_dst_pitch;
 
             const int i_shift_height = i_dst_height / i_src_height;
             const int i_shift_width = i_dst_width / i_src_width;
 
+            const int *p_offsets = GetOffsets( p_filter, i_dst_visible_pitch,
+                                               i_width_coef, i_shift_width,
+                                               i_src_width_1 );
+            if( !p_offsets )
+            {
+                picture_Release( p_pic_dst );
+                picture_Release( p_pic );
+                return NULL;
+            }
+
             int l = 1<<(SHIFT_SIZE-i_shift_height);
-            for( ; p_dst < p_dstend;
-                 p_dst += i_dst_hidden_pitch,
-                 p_dstendline += i_dst_pitch, l += i_height_coef )
+            int i_last_line = -1;
+            for( int y = 0; y < i_dst_visible_lines; y++, l += i_height_coef )
             {
-                int k = 1<<(SHIFT_SIZE-i_shift_width);
-                uint8_t *p_srcl = p_src
-                       + (__MIN( i_src_height_1, l >> SHIFT_SIZE )*i_src_pitch);
+                uint8_t *p_dstline = p_dst + y*i_dst_pitch;
+                const int i_line = __MIN( i_src_height_1, l >> SHIFT_SIZE );
 
-                for( ; p_dst < p_dstendline; p_dst++, k += i_width_coef )
+                /* When upscaling, consecutive output lines often map to the
+                 * same source line: copy the line just rendered instead */
+                if( i_line == i_last_line )
                 {
-                    *p_dst = p_srcl[__MIN( i_src_width_1, k >> SHIFT_SIZE )];
+                    memcpy( p_dstline, p_dstline - i_dst_pitch,
+                            i_dst_visible_pitch );
+                    continue;
                 }
+                i_last_line = i_line;
+
+                const uint8_t *p_srcl = p_src + i_line*i_src_pitch;
+                for( int x = 0; x < i_dst_visible_pitch; x++ )
+                    p_dstline[x] = p_srcl[p_offsets[x]];
             }
         }
     }
@@ -169,7 +237,6 @@ static picture_t *Filter( filter_t *p_filter, picture_t *p_pic )
                                    p_pic_dst->p->i_visible_lines;
         const int i_dst_visible_pitch =
                                    p_pic_dst->p->i_visible_pitch;
-        const int i_dst_hidden_pitch  = i_dst_pitch - i_dst_visible_pitch;
         const int i_height_coef  = ( i_src_height << SHIFT_SIZE )
                                    / i_dst_height;
         const int i_width_coef   = ( i_src_width << SHIFT_SIZE )
@@ -179,25 +246,38 @@ static picture_t *Filter( filter_t *p_filter, picture_t *p_pic )
 
         uint32_t *p_src = (uint32_t*)p_pic->p->p_pixels;
         uint32_t *p_dst = (uint32_t*)p_pic_dst->p->p_pixels;
-        uint32_t *p_dstendline = p_dst + (i_dst_visible_pitch>>2);
-        const uint32_t *p_dstend = p_dst + i_dst_visible_lines*(i_dst_pitch>>2);
 
         const int i_shift_height = i_dst_height / i_src_height;
         const int i_shift_width = i_dst_width / i_src_width;
 
+        const int *p_offsets = GetOffsets( p_filter, i_dst_visible_pitch>>2,
+                                           i_width_coef, i_shift_width,
+                                           i_src_width_1 );
+        if( !p_offsets )
+        {
+            picture_Release( p_pic_dst );
+            picture_Release( p_pic );
+            return NULL;
+        }
+
         int l = 1<<(SHIFT_SIZE-i_shift_height);
-        for( ; p_dst < p_dstend;
-             p_dst += (i_dst_hidden_pitch>>2),
-             p_dstendline += (i_dst_pitch>>2),
-             l += i_height_coef )
+        int i_last_line = -1;
+        for( int y = 0; y < i_dst_visible_lines; y++, l += i_height_coef )
         {
-            int k = 1<<(SHIFT_SIZE-i_shift_width);
-            uint32_t *p_srcl = p_src
-                    + (__MIN( i_src_height_1, l >> SHIFT_SIZE )*(i_src_pitch>>2));
-            for( ; p_dst < p_dstendline; p_dst++, k += i_width_coef )
+            uint32_t *p_dstline = p_dst + y*(i_dst_pitch>>2);
+            const int i_line = __MIN( i_src_height_1, l >> SHIFT_SIZE );
+
+            if( i_line == i_last_line )
             {
-                *p_dst = p_srcl[__MIN( i_src_width_1, k >> SHIFT_SIZE )];
+                memcpy( p_dstline, p_dstline - (i_dst_pitch>>2),
+                        i_dst_visible_pitch );
+                continue;
             }
+            i_last_line = i_line;
+
+            const uint32_t *p_srcl = p_src + i_line*(i_src_pitch>>2);
+            for( int x = 0; x < (i_dst_visible_pitch>>2); x++ )
+                p_dstline[x] = p_srcl[p_offsets[x]];
         }
     }
 
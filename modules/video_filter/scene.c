@@ -51,7 +51,7 @@ static void Destroy     ( vlc_object_t * );
 static picture_t *Filter( filter_t *, picture_t * );
 
 static void SnapshotRatio( filter_t *p_filter, picture_t *p_pic );
-static void SavePicture( filter_t *, picture_t * );
+static void *SaveThread( void * );
 
 /*****************************************************************************
  * Module descriptor
@@ -127,15 +127,32 @@ static const char *const ppsz_vfilter_options[] = {
 typedef struct scene_t {
     picture_t       *p_pic;
     video_format_t  format;
+    int32_t         i_frames; /* snapshot sequence number */
 } scene_t;
 
+static void SavePicture( filter_t *, const scene_t * );
+
+/* Pending snapshots waiting for the encoding thread; beyond that new
+ * snapshots are dropped rather than stalling the filter chain */
+#define SCENE_QUEUE_SIZE 3
+
 /*****************************************************************************
  * filter_sys_t: private data
  *****************************************************************************/
 struct filter_sys_t
 {
     image_handler_t *p_image;
-    scene_t scene;
+
+    /* Encode+write runs on its own thread so that a slow disk never
+     * blocks the filter chain */
+    vlc_thread_t thread;
+    bool b_thread;
+    bool b_exit;
+    vlc_mutex_t lock;
+    vlc_cond_t wait;
+    scene_t queue[SCENE_QUEUE_SIZE];
+    unsigned i_queue;
+    unsigned i_dropped;
 
     char *psz_path;
     char *psz_prefix;
@@ -198,6 +215,14 @@ static int Create( vlc_object_t *p_this )
     if( p_sys->psz_path == NULL )
         p_sys->psz_path = config_GetUserDir( VLC_PICTURES_DIR );
 
+    vlc_mutex_init( &p_sys->lock );
+    vlc_cond_init( &p_sys->wait );
+    p_sys->b_thread = !vlc_clone( &p_sys->thread, SaveThread, p_filter,
+                                  VLC_THREAD_PRIORITY_LOW );
+    if( !p_sys->b_thread )
+        /* Fall back to writing snapshots on the filter thread */
+        msg_Warn( p_filter, "cannot spawn snapshot thread" );
+
     p_filter->pf_video_filter = Filter;
 
     return VLC_SUCCESS;
@@ -211,10 +236,26 @@ static void Destroy( vlc_object_t *p_this )
     filter_t *p_filter = (filter_t *)p_this;
     filter_sys_t *p_sys = (filter_sys_t *) p_filter->p_sys;
 
+    if( p_sys->b_thread )
+    {
+        vlc_mutex_lock( &p_sys->lock );
+        p_sys->b_exit = true;
+        vlc_cond_signal( &p_sys->wait );
+        vlc_mutex_unlock( &p_sys->lock );
+        vlc_join( p_sys->thread, NULL );
+    }
+    /* The thread flushes its queue before exiting, so this is an empty
+     * loop unless it was never started */
+    for( unsigned i = 0; i < p_sys->i_queue; i++ )
+        picture_Release( p_sys->queue[i].p_pic );
+    if( p_sys->i_dropped > 0 )
+        msg_Dbg( p_filter, "dropped %u snapshot(s) on a busy encoder",
+                 p_sys->i_dropped );
+    vlc_cond_destroy( &p_sys->wait );
+    vlc_mutex_destroy( &p_sys->lock );
+
     image_HandlerDelete( p_sys->p_image );
 
-    if( p_sys->scene.p_pic )
-        picture_Release( p_sys->scene.p_pic );
     free( p_sys->psz_format );
     free( p_sys->psz_prefix );
     free( p_sys->psz_path );
@@ -244,9 +285,6 @@ static void SnapshotRatio( filter_t *p_filter, picture_t *p_pic )
     }
     p_sys->i_frames++;
 
-    if( p_sys->scene.p_pic )
-        picture_Release( p_sys->scene.p_pic );
-
     if( (p_sys->i_width <= 0) && (p_sys->i_height > 0) )
     {
         p_sys->i_width = (p_pic->format.i_width * p_sys->i_height) / p_pic->format.i_height;
@@ -261,18 +299,79 @@ static void SnapshotRatio( filter_t *p_filter, picture_t *p_pic )
         p_sys->i_height = p_pic->format.i_height;
     }
 
-    p_sys->scene.p_pic = picture_NewFromFormat( &p_pic->format );
-    if( p_sys->scene.p_pic )
+    picture_t *p_copy = picture_NewFromFormat( &p_pic->format );
+    if( !p_copy )
+        return;
+    picture_Copy( p_copy, p_pic );
+
+    scene_t scene = {
+        .p_pic = p_copy,
+        .format = p_copy->format,
+        .i_frames = p_sys->i_frames,
+    };
+
+    if( !p_sys->b_thread )
+    {   /* Degraded mode: write on the filter thread */
+        SavePicture( p_filter, &scene );
+        picture_Release( p_copy );
+        return;
+    }
+
+    /* Hand the copy over to the encoding thread; if it is still busy
+     * with older snapshots, drop this one rather than blocking here */
+    vlc_mutex_lock( &p_sys->lock );
+    if( p_sys->i_queue < SCENE_QUEUE_SIZE )
     {
-        picture_Copy( p_sys->scene.p_pic, p_pic );
-        SavePicture( p_filter, p_sys->scene.p_pic );
+        p_sys->queue[p_sys->i_queue++] = scene;
+        p_copy = NULL;
+        vlc_cond_signal( &p_sys->wait );
     }
+    else
+        p_sys->i_dropped++;
+    vlc_mutex_unlock( &p_sys->lock );
+
+    if( p_copy )
+        picture_Release( p_copy );
+}
+
+/*****************************************************************************
+ * SaveThread: encode and write snapshots in the background
+ *****************************************************************************/
+static void *SaveThread( void *p_data )
+{
+    filter_t *p_filter = (filter_t *)p_data;
+    filter_sys_t *p_sys = (filter_sys_t *)p_filter->p_sys;
+
+    vlc_mutex_lock( &p_sys->lock );
+    for( ;; )
+    {
+        while( !p_sys->b_exit && p_sys->i_queue == 0 )
+            vlc_cond_wait( &p_sys->wait, &p_sys->lock );
+        if( p_sys->i_queue == 0 )
+            break; /* exit requested and queue flushed */
+
+        scene_t scene = p_sys->queue[0];
+        p_sys->i_queue--;
+        memmove( &p_sys->queue[0], &p_sys->queue[1],
+                 p_sys->i_queue * sizeof (scene_t) );
+        vlc_mutex_unlock( &p_sys->lock );
+
+        int canc = vlc_savecancel();
+        SavePicture( p_filter, &scene );
+        picture_Release( scene.p_pic );
+        vlc_restorecancel( canc );
+
+        vlc_mutex_lock( &p_sys->lock );
+    }
+    vlc_mutex_unlock( &p_sys->lock );
+
+    return NULL;
 }
 
 /*****************************************************************************
  * Save Picture to disk
  *****************************************************************************/
-static void SavePicture( filter_t *p_filter, picture_t *p_pic )
+static void SavePicture( filter_t *p_filter, const scene_t *p_scene )
 {
     filter_sys_t *p_sys = (filter_sys_t *)p_filter->p_sys;
     video_format_t fmt_in, fmt_out;
@@ -284,7 +383,7 @@ static void SavePicture( filter_t *p_filter, picture_t *p_pic )
     memset( &fmt_out, 0, sizeof(video_format_t) );
 
     /* Save snapshot psz_format to a memory zone */
-    fmt_in = p_pic->format;
+    fmt_in = p_scene->format;
     fmt_out.i_sar_num = fmt_out.i_sar_den = 1;
     fmt_out.i_width = p_sys->i_width;
     fmt_out.i_height = p_sys->i_height;
@@ -301,7 +400,7 @@ static void SavePicture( filter_t *p_filter, picture_t *p_pic )
     else
         i_ret = asprintf( &psz_filename, "%s" DIR_SEP "%s%05d.%s",
                           p_sys->psz_path, p_sys->psz_prefix,
-                          p_sys->i_frames, p_sys->psz_format );
+                          p_scene->i_frames, p_sys->psz_format );
 
     if( i_ret == -1 )
     {
@@ -319,7 +418,7 @@ static void SavePicture( filter_t *p_filter, picture_t *p_pic )
     path_sanitize( psz_temp );
 
     /* Save the image */
-    i_ret = image_WriteUrl( p_sys->p_image, p_pic, &fmt_in, &fmt_out,
+    i_ret = image_WriteUrl( p_sys->p_image, p_scene->p_pic, &fmt_in, &fmt_out,
                             psz_temp );
     if( i_ret != VLC_SUCCESS )
     {
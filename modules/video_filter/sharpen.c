@@ -41,6 +41,7 @@
 #include <vlc_plugin.h>
 
 #include <vlc_filter.h>
+#include <vlc_cpu.h>
 #include "filter_picture.h"
 
 #define SIG_TEXT N_("Sharpen strength (0-2)")
@@ -89,6 +90,8 @@ static const char *const ppsz_filter_options[] = {
 struct filter_sys_t
 {
     vlc_mutex_t lock;
+    void (*pf_sharpen_line)( uint8_t *, const uint8_t *, const uint8_t *,
+                             const uint8_t *, unsigned, int );
     int tab_precalc[512];
 };
 
@@ -100,6 +103,107 @@ inline static int32_t clip( int32_t a )
     return (a > 255) ? 255 : (a < 0) ? 0 : a;
 }
 
+/*****************************************************************************
+ * SharpenLineC: convolve the pixels [1, i_width - 2] of one line
+ *****************************************************************************/
+static void SharpenLineC( uint8_t *p_out, const uint8_t *p_above,
+                          const uint8_t *p_line, const uint8_t *p_below,
+                          unsigned i_width, int sigma )
+{
+    for( unsigned j = 1; j < i_width - 1; j++ )
+    {
+        int pix = (p_line[j] << 3)
+                - p_above[j-1] - p_above[j] - p_above[j+1]
+                - p_line [j-1]              - p_line [j+1]
+                - p_below[j-1] - p_below[j] - p_below[j+1];
+
+        pix = pix >= 0 ? clip( pix ) : -clip( -pix );
+        p_out[j] = clip( p_line[j] + ((pix * sigma) >> 20) );
+    }
+}
+
+#ifdef CAN_COMPILE_SSE2
+/*
+ * 8 pixels at a time in 16-bit arithmetic: the 9-tap sum stays within
+ * [-2040, 2040] and the clipped contribution within +-255 << 4, so pmulhw
+ * against sigma reduced to 4.12 fixed point replaces the 32-bit multiply.
+ * The truncated sigma may make the result differ from the C routine by one.
+ */
+VLC_SSE
+static void SharpenLineSSE2( uint8_t *p_out, const uint8_t *p_above,
+                             const uint8_t *p_line, const uint8_t *p_below,
+                             unsigned i_width, int sigma )
+{
+    const int32_t sigma12 = sigma >> 8;
+
+    if( i_width < 2 + 8 )
+    {
+        SharpenLineC( p_out, p_above, p_line, p_below, i_width, sigma );
+        return;
+    }
+
+    const unsigned i_simd = (i_width - 2) & ~7;
+    if( i_width - 2 > i_simd )
+        SharpenLineC( p_out + i_simd, p_above + i_simd, p_line + i_simd,
+                      p_below + i_simd, i_width - i_simd, sigma );
+
+    intptr_t x = -(intptr_t)i_simd;
+
+    __asm__ volatile(
+        "movd            %5, %%xmm6 \n"
+        "pshuflw $0, %%xmm6, %%xmm6 \n"
+        "pshufd  $0, %%xmm6, %%xmm6 \n"   /* sigma in 4.12 fixed point */
+        "pxor        %%xmm7, %%xmm7 \n"
+        "pcmpeqw     %%xmm5, %%xmm5 \n"
+        "psrlw           $8, %%xmm5 \n"   /* 255 */
+        "pxor        %%xmm4, %%xmm4 \n"
+        "psubw       %%xmm5, %%xmm4 \n"   /* -255 */
+        "1: \n"
+        "movq       (%2,%0), %%xmm0 \n"   /* line above, left */
+        "punpcklbw   %%xmm7, %%xmm0 \n"
+        "movq      1(%2,%0), %%xmm1 \n"
+        "punpcklbw   %%xmm7, %%xmm1 \n"
+        "paddw       %%xmm1, %%xmm0 \n"
+        "movq      2(%2,%0), %%xmm1 \n"
+        "punpcklbw   %%xmm7, %%xmm1 \n"
+        "paddw       %%xmm1, %%xmm0 \n"
+        "movq       (%3,%0), %%xmm1 \n"   /* current line, left */
+        "punpcklbw   %%xmm7, %%xmm1 \n"
+        "paddw       %%xmm1, %%xmm0 \n"
+        "movq      2(%3,%0), %%xmm1 \n"
+        "punpcklbw   %%xmm7, %%xmm1 \n"
+        "paddw       %%xmm1, %%xmm0 \n"
+        "movq       (%4,%0), %%xmm1 \n"   /* line below, left */
+        "punpcklbw   %%xmm7, %%xmm1 \n"
+        "paddw       %%xmm1, %%xmm0 \n"
+        "movq      1(%4,%0), %%xmm1 \n"
+        "punpcklbw   %%xmm7, %%xmm1 \n"
+        "paddw       %%xmm1, %%xmm0 \n"
+        "movq      2(%4,%0), %%xmm1 \n"
+        "punpcklbw   %%xmm7, %%xmm1 \n"
+        "paddw       %%xmm1, %%xmm0 \n"   /* sum of the 8 neighbours */
+        "movq      1(%3,%0), %%xmm2 \n"   /* centre */
+        "punpcklbw   %%xmm7, %%xmm2 \n"
+        "movdqa      %%xmm2, %%xmm1 \n"
+        "psllw           $3, %%xmm1 \n"
+        "psubw       %%xmm0, %%xmm1 \n"   /* pix = (centre << 3) - sum */
+        "pminsw      %%xmm5, %%xmm1 \n"
+        "pmaxsw      %%xmm4, %%xmm1 \n"   /* clip to +-255 */
+        "psllw           $4, %%xmm1 \n"
+        "pmulhw      %%xmm6, %%xmm1 \n"   /* (pix * sigma) >> 20 */
+        "paddsw      %%xmm2, %%xmm1 \n"
+        "packuswb    %%xmm1, %%xmm1 \n"
+        "movq        %%xmm1, (%1,%0) \n"
+        "add             $8, %0 \n"
+        "jl 1b \n"
+        : "+r"(x)
+        : "r"(p_out + 1 + i_simd), "r"(p_above + i_simd),
+          "r"(p_line + i_simd), "r"(p_below + i_simd), "m"(sigma12)
+        : "xmm0", "xmm1", "xmm2", "xmm4", "xmm5", "xmm6", "xmm7", "memory"
+    );
+}
+#endif
+
 static void init_precalc_table(filter_sys_t *p_filter, float sigma)
 {
     for(int i = 0; i < 512; ++i)
@@ -131,6 +235,12 @@ static int Create( vlc_object_t *p_this )
 
     p_filter->pf_video_filter = Filter;
 
+    p_filter->p_sys->pf_sharpen_line = SharpenLineC;
+#ifdef CAN_COMPILE_SSE2
+    if( vlc_CPU_SSE2() )
+        p_filter->p_sys->pf_sharpen_line = SharpenLineSSE2;
+#endif
+
     config_ChainParse( p_filter, FILTER_PREFIX, ppsz_filter_options,
                    p_filter->p_cfg );
 
@@ -174,9 +284,6 @@ static picture_t *Filter( filter_t *p_filter, picture_t *p_pic )
     uint8_t *restrict p_out = NULL;
     int i_src_pitch;
     int i_out_pitch;
-    int pix;
-    const int v1 = -1;
-    const int v2 = 3; /* 2^3 = 8 */
     const unsigned i_visible_lines = p_pic->p[Y_PLANE].i_visible_lines;
     const unsigned i_visible_pitch = p_pic->p[Y_PLANE].i_visible_pitch;
     const int sigma = var_GetFloat( p_filter, FILTER_PREFIX "sigma" ) * (1 << 20);
@@ -203,22 +310,11 @@ static picture_t *Filter( filter_t *p_filter, picture_t *p_pic )
     {
         p_out[i * i_out_pitch] = p_src[i * i_src_pitch];
 
-        for( unsigned j = 1; j < i_visible_pitch - 1; j++ )
-        {
-            pix = (p_src[(i - 1) * i_src_pitch + j - 1] * v1) +
-                  (p_src[(i - 1) * i_src_pitch + j    ] * v1) +
-                  (p_src[(i - 1) * i_src_pitch + j + 1] * v1) +
-                  (p_src[(i    ) * i_src_pitch + j - 1] * v1) +
-                  (p_src[(i    ) * i_src_pitch + j    ] << v2) +
-                  (p_src[(i    ) * i_src_pitch + j + 1] * v1) +
-                  (p_src[(i + 1) * i_src_pitch + j - 1] * v1) +
-                  (p_src[(i + 1) * i_src_pitch + j    ] * v1) +
-                  (p_src[(i + 1) * i_src_pitch + j + 1] * v1);
-
-           pix = pix >= 0 ? clip(pix) : -clip(pix * -1);
-           p_out[i * i_out_pitch + j] = clip( p_src[i * i_src_pitch + j]
-                                              + ((pix * sigma) >> 20));
-        }
+        p_filter->p_sys->pf_sharpen_line( &p_out[i * i_out_pitch],
+                                          &p_src[(i - 1) * i_src_pitch],
+                                          &p_src[i * i_src_pitch],
+                                          &p_src[(i + 1) * i_src_pitch],
+                                          i_visible_pitch, sigma );
 
         p_out[i * i_out_pitch + i_visible_pitch - 1] =
             p_src[i * i_src_pitch + i_visible_pitch - 1];
@@ -35,6 +35,17 @@
 #include <vlc_common.h>
 #include <vlc_plugin.h>
 #include <vlc_filter.h>
+#include <vlc_cpu.h>
+
+#if defined(CAN_COMPILE_SSE2) && (defined(__i386__) || defined(__x86_64__))
+# include <emmintrin.h>
+# define TRANSFORM_USE_SSE2
+# ifndef __SSE2__
+#  define VLC_TARGET_SSE2 __attribute__((__target__("sse2")))
+# else
+#  define VLC_TARGET_SSE2
+# endif
+#endif
 
 /*****************************************************************************
  * Module descriptor
@@ -113,6 +124,12 @@ static void R270(int *sx, int *sy, int w, int h, int dx, int dy)
 }
 typedef void (*convert_t)(int *, int *, int, int, int, int);
 
+/* Size (in pixels) of the square tiles the planes are processed in.
+ * Rotating transforms walk either the source or the destination
+ * column-wise; keeping both footprints tile-sized avoids trashing the
+ * cache on large frames. */
+#define TRANSFORM_TILE 16
+
 #define PLANE(f,bits) \
 static void Plane##bits##_##f(plane_t *restrict dst, const plane_t *restrict src) \
 { \
@@ -122,12 +139,18 @@ static void Plane##bits##_##f(plane_t *restrict dst, const plane_t *restrict src
     const unsigned dst_width = dst->i_pitch / sizeof (*dst_pixels); \
     const unsigned dst_visible_width = dst->i_visible_pitch / sizeof (*dst_pixels); \
  \
-    for (int y = 0; y < dst->i_visible_lines; y++) { \
-        for (unsigned x = 0; x < dst_visible_width; x++) { \
-            int sx, sy; \
-            (f)(&sx, &sy, dst_visible_width, dst->i_visible_lines, x, y); \
-            dst_pixels[y * dst_width + x] = \
-                src_pixels[sy * src_width + sx]; \
+    for (int y0 = 0; y0 < dst->i_visible_lines; y0 += TRANSFORM_TILE) { \
+        int y_end = __MIN(y0 + TRANSFORM_TILE, dst->i_visible_lines); \
+        for (unsigned x0 = 0; x0 < dst_visible_width; x0 += TRANSFORM_TILE) { \
+            unsigned x_end = __MIN(x0 + TRANSFORM_TILE, dst_visible_width); \
+            for (int y = y0; y < y_end; y++) { \
+                for (unsigned x = x0; x < x_end; x++) { \
+                    int sx, sy; \
+                    (f)(&sx, &sy, dst_visible_width, dst->i_visible_lines, x, y); \
+                    dst_pixels[y * dst_width + x] = \
+                        src_pixels[sy * src_width + sx]; \
+                } \
+            } \
         } \
     } \
 }
@@ -225,6 +248,165 @@ YUY2(AntiTranspose)
 YUY2(R90)
 YUY2(R270)
 
+#ifdef TRANSFORM_USE_SSE2
+/*
+ * 8x8 tile transpose kernels for the rotating transforms. Transpose,
+ * anti-transpose and the two rotations only differ in the direction the
+ * tiles and their lines are walked, which the callers below express with
+ * negative pitches; the in-register shuffle network is shared.
+ */
+VLC_TARGET_SSE2
+static inline void Transpose8x8_8(uint8_t *restrict dst, ptrdiff_t dst_pitch,
+                                  const uint8_t *restrict src,
+                                  ptrdiff_t src_pitch)
+{
+    const __m128i r0 = _mm_loadl_epi64((const __m128i *)(src + 0 * src_pitch));
+    const __m128i r1 = _mm_loadl_epi64((const __m128i *)(src + 1 * src_pitch));
+    const __m128i r2 = _mm_loadl_epi64((const __m128i *)(src + 2 * src_pitch));
+    const __m128i r3 = _mm_loadl_epi64((const __m128i *)(src + 3 * src_pitch));
+    const __m128i r4 = _mm_loadl_epi64((const __m128i *)(src + 4 * src_pitch));
+    const __m128i r5 = _mm_loadl_epi64((const __m128i *)(src + 5 * src_pitch));
+    const __m128i r6 = _mm_loadl_epi64((const __m128i *)(src + 6 * src_pitch));
+    const __m128i r7 = _mm_loadl_epi64((const __m128i *)(src + 7 * src_pitch));
+
+    const __m128i t0 = _mm_unpacklo_epi8(r0, r1);
+    const __m128i t1 = _mm_unpacklo_epi8(r2, r3);
+    const __m128i t2 = _mm_unpacklo_epi8(r4, r5);
+    const __m128i t3 = _mm_unpacklo_epi8(r6, r7);
+
+    const __m128i u0 = _mm_unpacklo_epi16(t0, t1);
+    const __m128i u1 = _mm_unpackhi_epi16(t0, t1);
+    const __m128i u2 = _mm_unpacklo_epi16(t2, t3);
+    const __m128i u3 = _mm_unpackhi_epi16(t2, t3);
+
+    const __m128i v0 = _mm_unpacklo_epi32(u0, u2);
+    const __m128i v1 = _mm_unpackhi_epi32(u0, u2);
+    const __m128i v2 = _mm_unpacklo_epi32(u1, u3);
+    const __m128i v3 = _mm_unpackhi_epi32(u1, u3);
+
+    _mm_storel_epi64((__m128i *)(dst + 0 * dst_pitch), v0);
+    _mm_storel_epi64((__m128i *)(dst + 1 * dst_pitch), _mm_srli_si128(v0, 8));
+    _mm_storel_epi64((__m128i *)(dst + 2 * dst_pitch), v1);
+    _mm_storel_epi64((__m128i *)(dst + 3 * dst_pitch), _mm_srli_si128(v1, 8));
+    _mm_storel_epi64((__m128i *)(dst + 4 * dst_pitch), v2);
+    _mm_storel_epi64((__m128i *)(dst + 5 * dst_pitch), _mm_srli_si128(v2, 8));
+    _mm_storel_epi64((__m128i *)(dst + 6 * dst_pitch), v3);
+    _mm_storel_epi64((__m128i *)(dst + 7 * dst_pitch), _mm_srli_si128(v3, 8));
+}
+
+VLC_TARGET_SSE2
+static inline void Transpose8x8_16(uint16_t *restrict dst, ptrdiff_t dst_pitch,
+                                   const uint16_t *restrict src,
+                                   ptrdiff_t src_pitch)
+{
+    const __m128i r0 = _mm_loadu_si128((const __m128i *)(src + 0 * src_pitch));
+    const __m128i r1 = _mm_loadu_si128((const __m128i *)(src + 1 * src_pitch));
+    const __m128i r2 = _mm_loadu_si128((const __m128i *)(src + 2 * src_pitch));
+    const __m128i r3 = _mm_loadu_si128((const __m128i *)(src + 3 * src_pitch));
+    const __m128i r4 = _mm_loadu_si128((const __m128i *)(src + 4 * src_pitch));
+    const __m128i r5 = _mm_loadu_si128((const __m128i *)(src + 5 * src_pitch));
+    const __m128i r6 = _mm_loadu_si128((const __m128i *)(src + 6 * src_pitch));
+    const __m128i r7 = _mm_loadu_si128((const __m128i *)(src + 7 * src_pitch));
+
+    const __m128i t0 = _mm_unpacklo_epi16(r0, r1);
+    const __m128i t1 = _mm_unpackhi_epi16(r0, r1);
+    const __m128i t2 = _mm_unpacklo_epi16(r2, r3);
+    const __m128i t3 = _mm_unpackhi_epi16(r2, r3);
+    const __m128i t4 = _mm_unpacklo_epi16(r4, r5);
+    const __m128i t5 = _mm_unpackhi_epi16(r4, r5);
+    const __m128i t6 = _mm_unpacklo_epi16(r6, r7);
+    const __m128i t7 = _mm_unpackhi_epi16(r6, r7);
+
+    const __m128i u0 = _mm_unpacklo_epi32(t0, t2);
+    const __m128i u1 = _mm_unpackhi_epi32(t0, t2);
+    const __m128i u2 = _mm_unpacklo_epi32(t1, t3);
+    const __m128i u3 = _mm_unpackhi_epi32(t1, t3);
+    const __m128i u4 = _mm_unpacklo_epi32(t4, t6);
+    const __m128i u5 = _mm_unpackhi_epi32(t4, t6);
+    const __m128i u6 = _mm_unpacklo_epi32(t5, t7);
+    const __m128i u7 = _mm_unpackhi_epi32(t5, t7);
+
+    _mm_storeu_si128((__m128i *)(dst + 0 * dst_pitch),
+                     _mm_unpacklo_epi64(u0, u4));
+    _mm_storeu_si128((__m128i *)(dst + 1 * dst_pitch),
+                     _mm_unpackhi_epi64(u0, u4));
+    _mm_storeu_si128((__m128i *)(dst + 2 * dst_pitch),
+                     _mm_unpacklo_epi64(u1, u5));
+    _mm_storeu_si128((__m128i *)(dst + 3 * dst_pitch),
+                     _mm_unpackhi_epi64(u1, u5));
+    _mm_storeu_si128((__m128i *)(dst + 4 * dst_pitch),
+                     _mm_unpacklo_epi64(u2, u6));
+    _mm_storeu_si128((__m128i *)(dst + 5 * dst_pitch),
+                     _mm_unpackhi_epi64(u2, u6));
+    _mm_storeu_si128((__m128i *)(dst + 6 * dst_pitch),
+                     _mm_unpacklo_epi64(u3, u7));
+    _mm_storeu_si128((__m128i *)(dst + 7 * dst_pitch),
+                     _mm_unpackhi_epi64(u3, u7));
+}
+
+/* SRC_TILE/DST_TILE locate the 8x8 tile for destination block (x0, y0);
+ * a negative pitch walks the tile lines backwards, which is how the
+ * flipped variants reuse the plain transpose kernels above. The fringe
+ * that does not fill a whole tile goes through the scalar mapping. */
+#define PLANE_SSE2(f, bits, SRC_TILE, SRC_PITCH, DST_TILE, DST_PITCH) \
+VLC_TARGET_SSE2 \
+static void Plane##bits##_##f##_SSE2(plane_t *restrict dst, \
+                                     const plane_t *restrict src) \
+{ \
+    const uint##bits##_t *src_pixels = (const void *)src->p_pixels; \
+    uint##bits##_t *restrict dst_pixels = (void *)dst->p_pixels; \
+    const ptrdiff_t src_width = src->i_pitch / sizeof (*src_pixels); \
+    const ptrdiff_t dst_width = dst->i_pitch / sizeof (*dst_pixels); \
+    const int w = dst->i_visible_pitch / sizeof (*dst_pixels); \
+    const int h = dst->i_visible_lines; \
+    const int w8 = w & ~7; \
+    const int h8 = h & ~7; \
+ \
+    for (int y0 = 0; y0 < h8; y0 += 8) \
+        for (int x0 = 0; x0 < w8; x0 += 8) \
+            Transpose8x8_##bits(DST_TILE, DST_PITCH, SRC_TILE, SRC_PITCH); \
+ \
+    for (int y = 0; y < h; y++) \
+        for (int x = (y < h8) ? w8 : 0; x < w; x++) { \
+            int sx, sy; \
+            (f)(&sx, &sy, w, h, x, y); \
+            dst_pixels[y * dst_width + x] = src_pixels[sy * src_width + sx]; \
+        } \
+}
+
+#define PLANES_SSE2(f, SRC_TILE, SRC_PITCH, DST_TILE, DST_PITCH) \
+PLANE_SSE2(f, 8, SRC_TILE, SRC_PITCH, DST_TILE, DST_PITCH) \
+PLANE_SSE2(f, 16, SRC_TILE, SRC_PITCH, DST_TILE, DST_PITCH)
+
+PLANES_SSE2(Transpose,
+            src_pixels + (ptrdiff_t)x0 * src_width + y0, src_width,
+            dst_pixels + (ptrdiff_t)y0 * dst_width + x0, dst_width)
+PLANES_SSE2(AntiTranspose,
+            src_pixels + (ptrdiff_t)(w - 1 - x0) * src_width + (h - 8 - y0),
+            -src_width,
+            dst_pixels + (ptrdiff_t)(y0 + 7) * dst_width + x0, -dst_width)
+PLANES_SSE2(R90,
+            src_pixels + (ptrdiff_t)(w - 1 - x0) * src_width + y0, -src_width,
+            dst_pixels + (ptrdiff_t)y0 * dst_width + x0, dst_width)
+PLANES_SSE2(R270,
+            src_pixels + (ptrdiff_t)x0 * src_width + (h - 8 - y0), src_width,
+            dst_pixels + (ptrdiff_t)(y0 + 7) * dst_width + x0, -dst_width)
+
+static const struct {
+    void (*generic)(plane_t *, const plane_t *);
+    void (*sse2)(plane_t *, const plane_t *);
+} plane_sse2_table[] = {
+    { Plane8_Transpose,      Plane8_Transpose_SSE2      },
+    { Plane16_Transpose,     Plane16_Transpose_SSE2     },
+    { Plane8_AntiTranspose,  Plane8_AntiTranspose_SSE2  },
+    { Plane16_AntiTranspose, Plane16_AntiTranspose_SSE2 },
+    { Plane8_R90,            Plane8_R90_SSE2            },
+    { Plane16_R90,           Plane16_R90_SSE2           },
+    { Plane8_R270,           Plane8_R270_SSE2           },
+    { Plane16_R270,          Plane16_R270_SSE2          },
+};
+#endif /* TRANSFORM_USE_SSE2 */
+
 typedef struct {
     char      name[16];
     convert_t convert;
@@ -429,6 +611,16 @@ static int Open(vlc_object_t *object)
             goto error;
     }
 
+#ifdef TRANSFORM_USE_SSE2
+    if (vlc_CPU_SSE2())
+        for (unsigned i = 0; i < PICTURE_PLANE_MAX; i++)
+            for (size_t j = 0; j < ARRAY_SIZE(plane_sse2_table); j++)
+                if (sys->plane[i] == plane_sse2_table[j].generic) {
+                    sys->plane[i] = plane_sse2_table[j].sse2;
+                    break;
+                }
+#endif
+
     filter->p_sys           = sys;
     filter->pf_video_filter = Filter;
     filter->pf_video_mouse  = Mouse;
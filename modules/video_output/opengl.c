@@ -43,6 +43,19 @@
 # define GL_CLAMP_TO_EDGE 0x812F
 #endif
 
+#ifndef GL_PIXEL_UNPACK_BUFFER
+# define GL_PIXEL_UNPACK_BUFFER 0x88EC
+#endif
+#ifndef GL_WRITE_ONLY
+# define GL_WRITE_ONLY 0x88B9
+#endif
+#ifndef GL_STREAM_DRAW
+# define GL_STREAM_DRAW 0x88E0
+#endif
+
+/* Depth of the pixel buffer object ring used for texture upload */
+#define VLCGL_PBO_COUNT 2
+
 #if USE_OPENGL_ES == 2 || defined(__APPLE__)
 #   define PFNGLGETPROGRAMIVPROC             typeof(glGetProgramiv)*
 #   define PFNGLGETPROGRAMINFOLOGPROC        typeof(glGetProgramInfoLog)*
@@ -69,6 +82,10 @@
 #   define PFNGLBINDBUFFERPROC               typeof(glBindBuffer)*
 #   define PFNGLBUFFERDATAPROC               typeof(glBufferData)*
 #   define PFNGLDELETEBUFFERSPROC            typeof(glDeleteBuffers)*
+#if !USE_OPENGL_ES
+#   define PFNGLMAPBUFFERPROC                typeof(glMapBuffer)*
+#   define PFNGLUNMAPBUFFERPROC              typeof(glUnmapBuffer)*
+#endif
 #if defined(__APPLE__) && USE_OPENGL_ES
 #   import <CoreFoundation/CoreFoundation.h>
 #endif
@@ -111,6 +128,13 @@ typedef struct {
 
     float    tex_width;
     float    tex_height;
+
+    /* Source of the last upload, held to detect unchanged regions */
+    picture_t *source;
+    unsigned   source_x;
+    unsigned   source_y;
+    unsigned   source_width;
+    unsigned   source_height;
 } gl_region_t;
 
 struct vout_display_opengl_t {
@@ -183,6 +207,10 @@ struct vout_display_opengl_t {
     PFNGLBINDBUFFERPROC    BindBuffer;
     PFNGLBUFFERDATAPROC    BufferData;
     PFNGLDELETEBUFFERSPROC DeleteBuffers;
+#if !USE_OPENGL_ES
+    PFNGLMAPBUFFERPROC     MapBuffer;
+    PFNGLUNMAPBUFFERPROC   UnmapBuffer;
+#endif
 #endif
 
 #if defined(_WIN32)
@@ -199,6 +227,13 @@ struct vout_display_opengl_t {
 
     uint8_t *texture_temp_buf;
     int      texture_temp_buf_size;
+
+#if !USE_OPENGL_ES
+    /* Pixel buffer object ring for asynchronous texture upload */
+    bool     supports_pbo;
+    GLuint   pixel_buffer_object[VLCGL_PBO_COUNT];
+    unsigned pixel_buffer_index;
+#endif
 };
 
 static inline int GetAlignedSize(unsigned size)
@@ -495,6 +530,10 @@ vout_display_opengl_t *vout_display_opengl_New(video_format_t *fmt,
     vgl->BindBuffer    = (PFNGLBINDBUFFERPROC)vlc_gl_GetProcAddress(vgl->gl, "glBindBuffer");
     vgl->BufferData    = (PFNGLBUFFERDATAPROC)vlc_gl_GetProcAddress(vgl->gl, "glBufferData");
     vgl->DeleteBuffers = (PFNGLDELETEBUFFERSPROC)vlc_gl_GetProcAddress(vgl->gl, "glDeleteBuffers");
+#if !USE_OPENGL_ES
+    vgl->MapBuffer     = (PFNGLMAPBUFFERPROC)vlc_gl_GetProcAddress(vgl->gl, "glMapBuffer");
+    vgl->UnmapBuffer   = (PFNGLUNMAPBUFFERPROC)vlc_gl_GetProcAddress(vgl->gl, "glUnmapBuffer");
+#endif
 
     if (!vgl->CreateShader || !vgl->ShaderSource || !vgl->CreateProgram)
         supports_shaders = false;
@@ -510,6 +549,12 @@ vout_display_opengl_t *vout_display_opengl_New(video_format_t *fmt,
     vgl->supports_npot = HasExtension(extensions, "GL_ARB_texture_non_power_of_two") ||
                          HasExtension(extensions, "GL_APPLE_texture_2D_limited_npot");
 
+#if !USE_OPENGL_ES
+    vgl->supports_pbo = HasExtension(extensions, "GL_ARB_pixel_buffer_object") &&
+                        vgl->GenBuffers && vgl->BindBuffer && vgl->BufferData &&
+                        vgl->MapBuffer && vgl->UnmapBuffer;
+#endif
+
 #if USE_OPENGL_ES == 2
     /* OpenGL ES 2 includes support for non-power of 2 textures by specification
      * so checks for extensions are bound to fail. Check for OpenGL ES version instead. */
@@ -681,6 +726,10 @@ vout_display_opengl_t *vout_display_opengl_New(video_format_t *fmt,
 #ifdef SUPPORTS_SHADERS
     vgl->GenBuffers(1, &vgl->vertex_buffer_object);
     vgl->GenBuffers(vgl->chroma->plane_count, vgl->texture_buffer_object);
+#if !USE_OPENGL_ES
+    if (vgl->supports_pbo)
+        vgl->GenBuffers(VLCGL_PBO_COUNT, vgl->pixel_buffer_object);
+#endif
 
     /* Initial number of allocated buffer objects for subpictures, will grow dynamically. */
     int subpicture_buffer_object_count = 8;
@@ -723,6 +772,8 @@ void vout_display_opengl_Delete(vout_display_opengl_t *vgl)
         for (int i = 0; i < vgl->region_count; i++) {
             if (vgl->region[i].texture)
                 glDeleteTextures(1, &vgl->region[i].texture);
+            if (vgl->region[i].source)
+                picture_Release(vgl->region[i].source);
         }
         free(vgl->region);
 
@@ -735,6 +786,10 @@ void vout_display_opengl_Delete(vout_display_opengl_t *vgl)
         }
         vgl->DeleteBuffers(1, &vgl->vertex_buffer_object);
         vgl->DeleteBuffers(vgl->chroma->plane_count, vgl->texture_buffer_object);
+#if !USE_OPENGL_ES
+        if (vgl->supports_pbo)
+            vgl->DeleteBuffers(VLCGL_PBO_COUNT, vgl->pixel_buffer_object);
+#endif
         if (vgl->subpicture_buffer_object_count > 0)
             vgl->DeleteBuffers(vgl->subpicture_buffer_object_count, vgl->subpicture_buffer_object);
         free(vgl->subpicture_buffer_object);
@@ -863,6 +918,35 @@ static void Upload(vout_display_opengl_t *vgl, int in_width, int in_height,
     (void) vgl;
     {
         glPixelStorei(GL_UNPACK_ROW_LENGTH, pitch / pixel_pitch);
+
+#if !USE_OPENGL_ES
+        /* Stage the copy in a pixel buffer object whenever possible: the
+           driver then pulls the data asynchronously instead of blocking on
+           our client memory inside glTexSubImage2D(). Orphaning the previous
+           storage before mapping keeps the ring free of GPU stalls. */
+        if (vgl->supports_pbo) {
+            int rows = full_upload ? full_height : height;
+            int row_bytes = (full_upload ? full_width : width) * pixel_pitch;
+            size_t buf_size = (size_t)pitch * (rows - 1) + row_bytes;
+            GLuint pbo = vgl->pixel_buffer_object[vgl->pixel_buffer_index];
+
+            vgl->pixel_buffer_index = (vgl->pixel_buffer_index + 1)
+                                      % VLCGL_PBO_COUNT;
+            vgl->BindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo);
+            vgl->BufferData(GL_PIXEL_UNPACK_BUFFER, buf_size, NULL,
+                            GL_STREAM_DRAW);
+
+            void *map = vgl->MapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY);
+            if (map != NULL) {
+                /* Rows keep their pitch, so the GL_UNPACK_ROW_LENGTH set
+                   above applies to the buffer as it did to client memory. */
+                memcpy(map, pixels, buf_size);
+                vgl->UnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+                pixels = NULL; /* i.e. offset zero into the bound buffer */
+            } else
+                vgl->BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        }
+#endif
 #endif
         if (full_upload)
             glTexImage2D(tex_target, 0, tex_format,
@@ -873,6 +957,10 @@ static void Upload(vout_display_opengl_t *vgl, int in_width, int in_height,
                             0, 0,
                             width, height,
                             tex_format, tex_type, pixels);
+#if defined(GL_UNPACK_ROW_LENGTH) && !USE_OPENGL_ES
+        if (pixels == NULL)
+            vgl->BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+#endif
     }
 }
 
@@ -947,20 +1035,46 @@ int vout_display_opengl_Prepare(vout_display_opengl_t *vgl,
                     last[j].height == glr->height &&
                     last[j].format == glr->format &&
                     last[j].type   == glr->type) {
-                    glr->texture = last[j].texture;
+                    glr->texture       = last[j].texture;
+                    glr->source        = last[j].source;
+                    glr->source_x      = last[j].source_x;
+                    glr->source_y      = last[j].source_y;
+                    glr->source_width  = last[j].source_width;
+                    glr->source_height = last[j].source_height;
                     memset(&last[j], 0, sizeof(last[j]));
                     break;
                 }
             }
 
+            /* The SPU core re-renders a region picture only when its content
+               changes, so a recycled texture filled from the same picture and
+               crop rectangle is still up to date and the upload can be
+               skipped entirely. */
+            bool dirty = glr->source        != r->p_picture ||
+                         glr->source_x      != r->fmt.i_x_offset ||
+                         glr->source_y      != r->fmt.i_y_offset ||
+                         glr->source_width  != r->fmt.i_visible_width ||
+                         glr->source_height != r->fmt.i_visible_height;
+            if (glr->source != r->p_picture) {
+                if (glr->source)
+                    picture_Release(glr->source);
+                glr->source = picture_Hold(r->p_picture);
+            }
+            glr->source_x      = r->fmt.i_x_offset;
+            glr->source_y      = r->fmt.i_y_offset;
+            glr->source_width  = r->fmt.i_visible_width;
+            glr->source_height = r->fmt.i_visible_height;
+
             const int pixels_offset = r->fmt.i_y_offset * r->p_picture->p->i_pitch +
                                       r->fmt.i_x_offset * r->p_picture->p->i_pixel_pitch;
             if (glr->texture) {
-                /* A texture was successfully recycled, reuse it. */
-                glBindTexture(GL_TEXTURE_2D, glr->texture);
-                Upload(vgl, r->fmt.i_visible_width, r->fmt.i_visible_height, glr->width, glr->height, 1, 1, 1, 1,
-                       r->p_picture->p->i_pitch, r->p_picture->p->i_pixel_pitch, 0,
-                       &r->p_picture->p->p_pixels[pixels_offset], GL_TEXTURE_2D, glr->format, glr->type);
+                if (dirty) {
+                    /* A texture was successfully recycled, reuse it. */
+                    glBindTexture(GL_TEXTURE_2D, glr->texture);
+                    Upload(vgl, r->fmt.i_visible_width, r->fmt.i_visible_height, glr->width, glr->height, 1, 1, 1, 1,
+                           r->p_picture->p->i_pitch, r->p_picture->p->i_pixel_pitch, 0,
+                           &r->p_picture->p->p_pixels[pixels_offset], GL_TEXTURE_2D, glr->format, glr->type);
+                }
             } else {
                 /* Could not recycle a previous texture, generate a new one. */
                 glGenTextures(1, &glr->texture);
@@ -982,6 +1096,8 @@ int vout_display_opengl_Prepare(vout_display_opengl_t *vgl,
     for (int i = 0; i < last_count; i++) {
         if (last[i].texture)
             glDeleteTextures(1, &last[i].texture);
+        if (last[i].source)
+            picture_Release(last[i].source);
     }
     free(last);
 
@@ -96,6 +96,9 @@ struct vout_display_sys_t {
     void (*unlock)(void *sys, void *id, void *const *plane);
     void (*display)(void *sys, void *id);
     void (*cleanup)(void *sys);
+    void (*lend)(void *sys, void *picture, unsigned count,
+                 void *const *plane, const unsigned *pitch,
+                 const unsigned *lines);
 
     unsigned pitches[PICTURE_PLANE_MAX];
     unsigned lines[PICTURE_PLANE_MAX];
@@ -107,6 +110,8 @@ typedef unsigned (*vlc_format_cb)(void **, char *, unsigned *, unsigned *,
 static picture_pool_t *Pool  (vout_display_t *, unsigned);
 static void           Prepare(vout_display_t *, picture_t *, subpicture_t *);
 static void           Display(vout_display_t *, picture_t *, subpicture_t *);
+static picture_pool_t *PoolLend   (vout_display_t *, unsigned);
+static void            DisplayLend(vout_display_t *, picture_t *, subpicture_t *);
 static int            Control(vout_display_t *, int, va_list);
 
 static void Lock(void *data, picture_t *pic)
@@ -152,8 +157,9 @@ static int Open(vlc_object_t *object)
     /* Get the callbacks */
     vlc_format_cb setup = var_InheritAddress(vd, "vmem-setup");
 
+    sys->lend = var_InheritAddress(vd, "vmem-lend");
     sys->lock = var_InheritAddress(vd, "vmem-lock");
-    if (sys->lock == NULL) {
+    if (sys->lock == NULL && sys->lend == NULL) {
         msg_Err(vd, "missing lock callback");
         free(sys);
         return VLC_EGENERIC;
@@ -246,9 +252,17 @@ static int Open(vlc_object_t *object)
     vd->sys     = sys;
     vd->fmt     = fmt;
     vd->info    = info;
-    vd->pool    = Pool;
-    vd->prepare = Prepare;
-    vd->display = Display;
+    if (sys->lend != NULL) {
+        /* Lending mode: hand out our own pictures instead of rendering
+         * into application buffers. */
+        vd->pool    = PoolLend;
+        vd->prepare = NULL;
+        vd->display = DisplayLend;
+    } else {
+        vd->pool    = Pool;
+        vd->prepare = Prepare;
+        vd->display = Display;
+    }
     vd->control = Control;
     vd->manage  = NULL;
 
@@ -269,7 +283,8 @@ static void Close(vlc_object_t *object)
 
     if (sys->pool)
     {
-        picture_pool_Enum(sys->pool, Unlock, sys);
+        if (sys->lend == NULL)
+            picture_pool_Enum(sys->pool, Unlock, sys);
         picture_pool_Release(sys->pool);
     }
     free(sys);
@@ -325,6 +340,34 @@ static picture_pool_t *Pool(vout_display_t *vd, unsigned count)
     return sys->pool;
 }
 
+static picture_pool_t *PoolLend(vout_display_t *vd, unsigned count)
+{
+    vout_display_sys_t *sys = vd->sys;
+
+    if (sys->pool == NULL)
+        sys->pool = picture_pool_NewFromFormat(&vd->fmt, count);
+    return sys->pool;
+}
+
+static void DisplayLend(vout_display_t *vd, picture_t *pic, subpicture_t *subpic)
+{
+    vout_display_sys_t *sys = vd->sys;
+    void *planes[PICTURE_PLANE_MAX];
+    unsigned pitches[PICTURE_PLANE_MAX];
+    unsigned lines[PICTURE_PLANE_MAX];
+
+    for (int i = 0; i < pic->i_planes; i++) {
+        planes[i] = pic->p[i].p_pixels;
+        pitches[i] = pic->p[i].i_pitch;
+        lines[i] = pic->p[i].i_visible_lines;
+    }
+
+    /* Our reference on the picture moves to the application, which gives
+     * it back through libvlc_video_release_picture(). */
+    sys->lend(sys->opaque, pic, pic->i_planes, planes, pitches, lines);
+    VLC_UNUSED(subpic);
+}
+
 static void Prepare(vout_display_t *vd, picture_t *pic, subpicture_t *subpic)
 {
     Unlock(vd->sys, pic);
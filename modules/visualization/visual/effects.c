@@ -66,6 +66,8 @@ static void dummy_Free( void *data )
 /*****************************************************************************
  * spectrum_Run: spectrum analyser
  *****************************************************************************/
+static void spectrum_Free( void *data );
+
 typedef struct spectrum_data
 {
     int *peaks;
@@ -75,6 +77,11 @@ typedef struct spectrum_data
     int16_t *p_prev_s16_buff;
 
     window_param wind_param;
+
+    /* FFT state and window table: they only depend on the (fixed) FFT
+     * buffer size, so they are built once and reused every frame */
+    fft_state *p_fft_state;
+    window_context wind_ctx;
 } spectrum_data;
 
 static int spectrum_Run(visual_effect_t * p_effect, vlc_object_t *p_aout,
@@ -104,9 +111,6 @@ static int spectrum_Run(visual_effect_t * p_effect, vlc_object_t *p_aout,
      110,115,121,130,141,152,163,174,185,200,255};
     const int *xscale;
 
-    fft_state *p_state;                 /* internal FFT data */
-    DEFINE_WIND_CONTEXT( wind_ctx );    /* internal window data */
-
     int i , j , y , k;
     int i_line;
     int16_t p_dest[FFT_BUFFER_SIZE];      /* Adapted FFT result */
@@ -138,6 +142,19 @@ static int spectrum_Run(visual_effect_t * p_effect, vlc_object_t *p_aout,
         p_data->p_prev_s16_buff = NULL;
 
         window_get_param( p_aout, &p_data->wind_param );
+
+        p_data->wind_ctx.pf_window_table = NULL;
+        p_data->wind_ctx.i_buffer_size = 0;
+        p_data->p_fft_state = visual_fft_init();
+        if( !p_data->p_fft_state
+         || !window_init( FFT_BUFFER_SIZE, &p_data->wind_param,
+                          &p_data->wind_ctx ) )
+        {
+            msg_Err( p_aout, "unable to initialize FFT transform" );
+            spectrum_Free( p_data );
+            p_effect->p_data = NULL;
+            return -1;
+        }
     }
     peaks = (int *)p_data->peaks;
     prev_heights = (int *)p_data->prev_heights;
@@ -186,20 +203,6 @@ static int spectrum_Run(visual_effect_t * p_effect, vlc_object_t *p_aout,
 
         p_buffl++ ; p_buffs++ ;
     }
-    p_state  = visual_fft_init();
-    if( !p_state)
-    {
-        free( height );
-        msg_Err(p_aout,"unable to initialize FFT transform");
-        return -1;
-    }
-    if( !window_init( FFT_BUFFER_SIZE, &p_data->wind_param, &wind_ctx ) )
-    {
-        fft_close( p_state );
-        free( height );
-        msg_Err(p_aout,"unable to initialize FFT window");
-        return -1;
-    }
     p_buffs = p_s16_buff;
     for ( i = 0 ; i < FFT_BUFFER_SIZE ; i++)
     {
@@ -211,8 +214,8 @@ static int spectrum_Run(visual_effect_t * p_effect, vlc_object_t *p_aout,
             p_buffs = p_s16_buff;
 
     }
-    window_scale_in_place( p_buffer1, &wind_ctx );
-    fft_perform( p_buffer1, p_output, p_state);
+    window_scale_in_place( p_buffer1, &p_data->wind_ctx );
+    fft_perform( p_buffer1, p_output, p_data->p_fft_state );
     for( i = 0; i< FFT_BUFFER_SIZE ; i++ )
         p_dest[i] = p_output[i] *  ( 2 ^ 16 ) / ( ( FFT_BUFFER_SIZE / 2 * 32768 ) ^ 2 );
 
@@ -359,10 +362,6 @@ static int spectrum_Run(visual_effect_t * p_effect, vlc_object_t *p_aout,
         }
     }
 
-    window_close( &wind_ctx );
-
-    fft_close( p_state );
-
     free( height );
 
     return 0;
@@ -374,6 +373,8 @@ static void spectrum_Free( void *data )
 
     if( p_data != NULL )
     {
+        window_close( &p_data->wind_ctx );
+        fft_close( p_data->p_fft_state );
         free( p_data->peaks );
         free( p_data->prev_heights );
         free( p_data->p_prev_s16_buff );
@@ -385,6 +386,8 @@ static void spectrum_Free( void *data )
 /*****************************************************************************
  * spectrometer_Run: derivative spectrum analysis
  *****************************************************************************/
+static void spectrometer_Free( void *data );
+
 typedef struct
 {
     int *peaks;
@@ -393,6 +396,10 @@ typedef struct
     int16_t *p_prev_s16_buff;
 
     window_param wind_param;
+
+    /* See spectrum_data: built once, reused every frame */
+    fft_state *p_fft_state;
+    window_context wind_ctx;
 } spectrometer_data;
 
 static int spectrometer_Run(visual_effect_t * p_effect, vlc_object_t *p_aout,
@@ -442,9 +449,6 @@ static int spectrometer_Run(visual_effect_t * p_effect, vlc_object_t *p_aout,
     const int *xscale;
     const double y_scale =  3.60673760222;  /* (log 256) */
 
-    fft_state *p_state;                 /* internal FFT data */
-    DEFINE_WIND_CONTEXT( wind_ctx );    /* internal window data */
-
     int i , j , k;
     int i_line = 0;
     int16_t p_dest[FFT_BUFFER_SIZE];      /* Adapted FFT result */
@@ -477,6 +481,18 @@ static int spectrometer_Run(visual_effect_t * p_effect, vlc_object_t *p_aout,
         p_data->i_prev_nb_samples = 0;
         p_data->p_prev_s16_buff = NULL;
         window_get_param( p_aout, &p_data->wind_param );
+
+        p_data->wind_ctx.pf_window_table = NULL;
+        p_data->wind_ctx.i_buffer_size = 0;
+        p_data->p_fft_state = visual_fft_init();
+        if( !p_data->p_fft_state
+         || !window_init( FFT_BUFFER_SIZE, &p_data->wind_param,
+                          &p_data->wind_ctx ) )
+        {
+            msg_Err( p_aout, "unable to initialize FFT transform" );
+            spectrometer_Free( p_data );
+            return -1;
+        }
         p_effect->p_data = (void*)p_data;
     }
     peaks = p_data->peaks;
@@ -534,20 +550,6 @@ static int spectrometer_Run(visual_effect_t * p_effect, vlc_object_t *p_aout,
 
         p_buffl++ ; p_buffs++ ;
     }
-    p_state  = visual_fft_init();
-    if( !p_state)
-    {
-        msg_Err(p_aout,"unable to initialize FFT transform");
-        free( height );
-        return -1;
-    }
-    if( !window_init( FFT_BUFFER_SIZE, &p_data->wind_param, &wind_ctx ) )
-    {
-        fft_close( p_state );
-        free( height );
-        msg_Err(p_aout,"unable to initialize FFT window");
-        return -1;
-    }
     p_buffs = p_s16_buff;
     for ( i = 0 ; i < FFT_BUFFER_SIZE; i++)
     {
@@ -558,8 +560,8 @@ static int spectrometer_Run(visual_effect_t * p_effect, vlc_object_t *p_aout,
         if( p_buffs >= &p_s16_buff[p_buffer->i_nb_samples * p_effect->i_nb_chans] )
             p_buffs = p_s16_buff;
     }
-    window_scale_in_place( p_buffer1, &wind_ctx );
-    fft_perform( p_buffer1, p_output, p_state);
+    window_scale_in_place( p_buffer1, &p_data->wind_ctx );
+    fft_perform( p_buffer1, p_output, p_data->p_fft_state );
     for(i = 0; i < FFT_BUFFER_SIZE; i++)
     {
         int sqrti = sqrt(p_output[i]);
@@ -856,10 +858,6 @@ static int spectrometer_Run(visual_effect_t * p_effect, vlc_object_t *p_aout,
         }
     }
 
-    window_close( &wind_ctx );
-
-    fft_close( p_state );
-
     free( height );
 
     return 0;
@@ -871,6 +869,8 @@ static void spectrometer_Free( void *data )
 
     if( p_data != NULL )
     {
+        window_close( &p_data->wind_ctx );
+        fft_close( p_data->p_fft_state );
         free( p_data->peaks );
         free( p_data->p_prev_s16_buff );
         free( p_data );
@@ -169,8 +169,20 @@ static void fft_calculate(float * re, float * im, const float *costable, const f
         /* In this step, we have 2 ^ (i - 1) exchange groups, each with
          * 2 ^ (FFT_BUFFER_SIZE_LOG - i) exchanges
          */
-        /* Loop through the exchanges in a group */
-        for(j = 0; j != exchanges; j++) {
+        /* The j = 0 exchange has a factor of 1 + 0i: the butterfly reduces
+         * to additions, so handle it without the complex multiply */
+        for(k = 0; k < FFT_BUFFER_SIZE; k += exchanges << 1) {
+            int k1 = k + exchanges;
+            tmp_real = re[k1];
+            tmp_imag = im[k1];
+            re[k1] = re[k] - tmp_real;
+            im[k1] = im[k] - tmp_imag;
+            re[k]  += tmp_real;
+            im[k]  += tmp_imag;
+        }
+
+        /* Loop through the remaining exchanges in a group */
+        for(j = 1; j != exchanges; j++) {
             /* Work out factor for this exchange
              * factor ^ (exchanges) = -1
              * So, real = cos(j * PI / exchanges),
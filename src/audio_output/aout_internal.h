@@ -75,6 +75,14 @@ typedef struct
         bool discontinuity;
     } sync;
 
+    struct
+    {
+        block_t *first; /**< Buffers deferred while the lock was contended */
+        block_t **lastp;
+        unsigned count;
+        int rate; /**< Input rate of the deferred buffers */
+    } pending; /**< Only accessed from the decoder thread */
+
     audio_sample_format_t input_format;
     audio_sample_format_t mixer_format;
 
@@ -120,6 +128,7 @@ void aout_OutputPause( audio_output_t * p_aout, bool, mtime_t );
 void aout_OutputFlush( audio_output_t * p_aout, bool );
 void aout_OutputDelete( audio_output_t * p_aout );
 void aout_OutputLock(audio_output_t *);
+int aout_OutputTryLock(audio_output_t *);
 void aout_OutputUnlock(audio_output_t *);
 
 
@@ -30,8 +30,19 @@
 
 #include <vlc_common.h>
 #include <vlc_aout.h>
+#include <vlc_cpu.h>
 #include "aout_internal.h"
 
+#if defined(CAN_COMPILE_SSE2) && (defined(__i386__) || defined(__x86_64__))
+# define AOUT_USE_SSE2
+# include <emmintrin.h>
+# ifndef __SSE2__
+#  define VLC_TARGET_SSE2 __attribute__((__target__("sse2")))
+# else
+#  define VLC_TARGET_SSE2
+# endif
+#endif
+
 /*
  * Formats management (internal and external)
  */
@@ -354,6 +365,123 @@ do { \
  * \note The samples must be naturally aligned in memory.
  * \warning Destination and source buffers MUST NOT overlap.
  */
+#ifdef AOUT_USE_SSE2
+/* Stereo (de)interleaving amounts to unpacking or splitting vectors.
+ * Stereo is by far the most common layout of the planar decoders, and these
+ * run for every planar frame, so it is worth special-casing. */
+VLC_TARGET_SSE2
+static void Interleave16Stereo( uint16_t *restrict d, const uint16_t *s0,
+                                const uint16_t *s1, unsigned n )
+{
+    unsigned i = 0;
+
+    for( ; i + 8 <= n; i += 8 )
+    {
+        __m128i a = _mm_loadu_si128( (const __m128i *)(s0 + i) );
+        __m128i b = _mm_loadu_si128( (const __m128i *)(s1 + i) );
+
+        _mm_storeu_si128( (__m128i *)(d + 2 * i),
+                          _mm_unpacklo_epi16( a, b ) );
+        _mm_storeu_si128( (__m128i *)(d + 2 * i + 8),
+                          _mm_unpackhi_epi16( a, b ) );
+    }
+    for( ; i < n; i++ )
+    {
+        d[2 * i] = s0[i];
+        d[2 * i + 1] = s1[i];
+    }
+}
+
+VLC_TARGET_SSE2
+static void Interleave32Stereo( uint32_t *restrict d, const uint32_t *s0,
+                                const uint32_t *s1, unsigned n )
+{
+    unsigned i = 0;
+
+    for( ; i + 4 <= n; i += 4 )
+    {
+        __m128i a = _mm_loadu_si128( (const __m128i *)(s0 + i) );
+        __m128i b = _mm_loadu_si128( (const __m128i *)(s1 + i) );
+
+        _mm_storeu_si128( (__m128i *)(d + 2 * i),
+                          _mm_unpacklo_epi32( a, b ) );
+        _mm_storeu_si128( (__m128i *)(d + 2 * i + 4),
+                          _mm_unpackhi_epi32( a, b ) );
+    }
+    for( ; i < n; i++ )
+    {
+        d[2 * i] = s0[i];
+        d[2 * i + 1] = s1[i];
+    }
+}
+
+VLC_TARGET_SSE2
+static void Interleave64Stereo( double *restrict d, const double *s0,
+                                const double *s1, unsigned n )
+{
+    unsigned i = 0;
+
+    for( ; i + 2 <= n; i += 2 )
+    {
+        __m128d a = _mm_loadu_pd( s0 + i );
+        __m128d b = _mm_loadu_pd( s1 + i );
+
+        _mm_storeu_pd( d + 2 * i, _mm_unpacklo_pd( a, b ) );
+        _mm_storeu_pd( d + 2 * i + 2, _mm_unpackhi_pd( a, b ) );
+    }
+    for( ; i < n; i++ )
+    {
+        d[2 * i] = s0[i];
+        d[2 * i + 1] = s1[i];
+    }
+}
+
+VLC_TARGET_SSE2
+static void Deinterleave32Stereo( uint32_t *restrict d0,
+                                  uint32_t *restrict d1,
+                                  const uint32_t *s, unsigned n )
+{
+    unsigned i = 0;
+
+    for( ; i + 4 <= n; i += 4 )
+    {
+        __m128 a = _mm_loadu_ps( (const float *)(s + 2 * i) );
+        __m128 b = _mm_loadu_ps( (const float *)(s + 2 * i + 4) );
+
+        _mm_storeu_ps( (float *)(d0 + i),
+                       _mm_shuffle_ps( a, b, _MM_SHUFFLE( 2, 0, 2, 0 ) ) );
+        _mm_storeu_ps( (float *)(d1 + i),
+                       _mm_shuffle_ps( a, b, _MM_SHUFFLE( 3, 1, 3, 1 ) ) );
+    }
+    for( ; i < n; i++ )
+    {
+        d0[i] = s[2 * i];
+        d1[i] = s[2 * i + 1];
+    }
+}
+
+VLC_TARGET_SSE2
+static void Deinterleave64Stereo( double *restrict d0, double *restrict d1,
+                                  const double *s, unsigned n )
+{
+    unsigned i = 0;
+
+    for( ; i + 2 <= n; i += 2 )
+    {
+        __m128d a = _mm_loadu_pd( s + 2 * i );
+        __m128d b = _mm_loadu_pd( s + 2 * i + 2 );
+
+        _mm_storeu_pd( d0 + i, _mm_unpacklo_pd( a, b ) );
+        _mm_storeu_pd( d1 + i, _mm_unpackhi_pd( a, b ) );
+    }
+    for( ; i < n; i++ )
+    {
+        d0[i] = s[2 * i];
+        d1[i] = s[2 * i + 1];
+    }
+}
+#endif /* AOUT_USE_SSE2 */
+
 void aout_Interleave( void *restrict dst, const void *const *srcv,
                       unsigned samples, unsigned chans, vlc_fourcc_t fourcc )
 {
@@ -368,6 +496,25 @@ do { \
     } \
 } while(0)
 
+#ifdef AOUT_USE_SSE2
+    if( chans == 2 && vlc_CPU_SSE2() )
+    {
+        switch( fourcc )
+        {
+            case VLC_CODEC_S16N:
+                Interleave16Stereo( dst, srcv[0], srcv[1], samples );
+                return;
+            case VLC_CODEC_FL32:
+            case VLC_CODEC_S32N:
+                Interleave32Stereo( dst, srcv[0], srcv[1], samples );
+                return;
+            case VLC_CODEC_FL64:
+                Interleave64Stereo( dst, srcv[0], srcv[1], samples );
+                return;
+        }
+    }
+#endif
+
     switch( fourcc )
     {
         case VLC_CODEC_U8:   INTERLEAVE_TYPE(uint8_t);  break;
@@ -404,6 +551,24 @@ do { \
     } \
 } while(0)
 
+#ifdef AOUT_USE_SSE2
+    if( chans == 2 && vlc_CPU_SSE2() )
+    {
+        switch( fourcc )
+        {
+            case VLC_CODEC_FL32:
+            case VLC_CODEC_S32N:
+                Deinterleave32Stereo( dst, (uint32_t *)dst + samples, src,
+                                      samples );
+                return;
+            case VLC_CODEC_FL64:
+                Deinterleave64Stereo( dst, (double *)dst + samples, src,
+                                      samples );
+                return;
+        }
+    }
+#endif
+
     switch( fourcc )
     {
         case VLC_CODEC_U8:   DEINTERLEAVE_TYPE(uint8_t);  break;
@@ -36,6 +36,9 @@
 
 #include "aout_internal.h"
 #include "libvlc.h"
+#include "../tracepoint.h"
+
+static void aout_DecDiscardPending (audio_output_t *, bool lost);
 
 /**
  * Creates an audio output
@@ -105,6 +108,9 @@ error:
     owner->sync.end = VLC_TS_INVALID;
     owner->sync.resamp_type = AOUT_RESAMPLING_NONE;
     owner->sync.discontinuity = true;
+    owner->pending.first = NULL;
+    owner->pending.lastp = &owner->pending.first;
+    owner->pending.count = 0;
     aout_OutputUnlock (p_aout);
 
     atomic_init (&owner->buffers_lost, 0);
@@ -119,6 +125,7 @@ void aout_DecDelete (audio_output_t *aout)
     aout_owner_t *owner = aout_owner (aout);
 
     aout_OutputLock (aout);
+    aout_DecDiscardPending (aout, false);
     if (owner->mixer_format.i_format)
     {
         aout_FiltersDelete (aout, owner->filters);
@@ -338,22 +345,19 @@ static void aout_DecSynchronize (audio_output_t *aout, mtime_t dec_pts,
 /*****************************************************************************
  * aout_DecPlay : filter & mix the decoded buffer
  *****************************************************************************/
-int aout_DecPlay (audio_output_t *aout, block_t *block, int input_rate)
+
+/* Maximum number of buffers deferred while the output lock is contended */
+#define AOUT_DEC_BATCH_MAX 16
+
+static int aout_DecPlayLocked (audio_output_t *aout, block_t *block,
+                               int input_rate)
 {
     aout_owner_t *owner = aout_owner (aout);
 
-    assert (input_rate >= INPUT_RATE_DEFAULT / AOUT_MAX_INPUT_RATE);
-    assert (input_rate <= INPUT_RATE_DEFAULT * AOUT_MAX_INPUT_RATE);
-    assert (block->i_pts >= VLC_TS_0);
-
-    block->i_length = CLOCK_FREQ * block->i_nb_samples
-                                 / owner->input_format.i_rate;
+    const mtime_t now = mdate (), advance = block->i_pts - now;
 
-    aout_OutputLock (aout);
-    if (unlikely(aout_CheckReady (aout)))
-        goto drop; /* Pipeline is unrecoverably broken :-( */
+    vlc_tracepoint2 (aout_play, block->i_pts, advance);
 
-    const mtime_t now = mdate (), advance = block->i_pts - now;
     if (advance < -AOUT_MAX_PTS_DELAY)
     {   /* Late buffer can be caused by bugs in the decoder, by scheduling
          * latency spikes (excessive load, SIGSTOP, etc.) or if buffering is
@@ -384,15 +388,101 @@ int aout_DecPlay (audio_output_t *aout, block_t *block, int input_rate)
     owner->sync.end = block->i_pts + block->i_length + 1;
     owner->sync.discontinuity = false;
     aout_OutputPlay (aout, block);
-out:
-    aout_OutputUnlock (aout);
     return 0;
 drop:
     owner->sync.discontinuity = true;
     block_Release (block);
 lost:
     atomic_fetch_add(&owner->buffers_lost, 1);
-    goto out;
+    return -1;
+}
+
+/**
+ * Plays all deferred buffers. The output lock must be held.
+ */
+static void aout_DecPlayPending (audio_output_t *aout)
+{
+    aout_owner_t *owner = aout_owner (aout);
+    block_t *block = owner->pending.first;
+    int rate = owner->pending.rate;
+
+    owner->pending.first = NULL;
+    owner->pending.lastp = &owner->pending.first;
+    owner->pending.count = 0;
+
+    while (block != NULL)
+    {
+        block_t *next = block->p_next;
+
+        block->p_next = NULL;
+        aout_DecPlayLocked (aout, block, rate);
+        block = next;
+    }
+}
+
+/**
+ * Discards all deferred buffers, counting them as lost if requested.
+ * The output lock must be held.
+ */
+static void aout_DecDiscardPending (audio_output_t *aout, bool lost)
+{
+    aout_owner_t *owner = aout_owner (aout);
+
+    if (owner->pending.first == NULL)
+        return;
+
+    if (lost)
+    {
+        owner->sync.discontinuity = true;
+        atomic_fetch_add(&owner->buffers_lost, owner->pending.count);
+    }
+    block_ChainRelease (owner->pending.first);
+    owner->pending.first = NULL;
+    owner->pending.lastp = &owner->pending.first;
+    owner->pending.count = 0;
+}
+
+int aout_DecPlay (audio_output_t *aout, block_t *block, int input_rate)
+{
+    aout_owner_t *owner = aout_owner (aout);
+
+    assert (input_rate >= INPUT_RATE_DEFAULT / AOUT_MAX_INPUT_RATE);
+    assert (input_rate <= INPUT_RATE_DEFAULT * AOUT_MAX_INPUT_RATE);
+    assert (block->i_pts >= VLC_TS_0);
+
+    block->i_length = CLOCK_FREQ * block->i_nb_samples
+                                 / owner->input_format.i_rate;
+    block->p_next = NULL;
+
+    /* A rate change only applies to the buffers queued afterward */
+    if (owner->pending.count > 0 && input_rate != owner->pending.rate)
+    {
+        aout_OutputLock (aout);
+        if (likely(!aout_CheckReady (aout)))
+            aout_DecPlayPending (aout);
+        else
+            aout_DecDiscardPending (aout, true);
+        aout_OutputUnlock (aout);
+    }
+
+    /* Defer the buffer, so that several of them can be pushed to the output
+     * per lock cycle when control requests contend for the lock. */
+    *owner->pending.lastp = block;
+    owner->pending.lastp = &block->p_next;
+    owner->pending.count++;
+    owner->pending.rate = input_rate;
+
+    if (owner->pending.count >= AOUT_DEC_BATCH_MAX)
+        aout_OutputLock (aout);
+    else if (aout_OutputTryLock (aout))
+        return 0; /* Contended: batch with the next buffers */
+
+    if (likely(!aout_CheckReady (aout)))
+        aout_DecPlayPending (aout);
+    else /* Pipeline is unrecoverably broken :-( */
+        aout_DecDiscardPending (aout, true);
+    aout_OutputUnlock (aout);
+    return 0;
 }
 
 int aout_DecGetResetLost (audio_output_t *aout)
@@ -406,6 +496,9 @@ void aout_DecChangePause (audio_output_t *aout, bool paused, mtime_t date)
     aout_owner_t *owner = aout_owner (aout);
 
     aout_OutputLock (aout);
+    if (paused && owner->mixer_format.i_format)
+        /* Push the deferred buffers before the pause point */
+        aout_DecPlayPending (aout);
     if (owner->sync.end != VLC_TS_INVALID)
     {
         if (paused)
@@ -423,18 +516,25 @@ void aout_DecFlush (audio_output_t *aout, bool wait)
     aout_owner_t *owner = aout_owner (aout);
 
     aout_OutputLock (aout);
-    owner->sync.end = VLC_TS_INVALID;
     if (owner->mixer_format.i_format)
     {
         if (wait)
         {
+            aout_DecPlayPending (aout);
+
             block_t *block = aout_FiltersDrain (owner->filters);
             if (block)
                 aout_OutputPlay (aout, block);
         }
         else
+        {
+            aout_DecDiscardPending (aout, false);
             aout_FiltersFlush (owner->filters);
+        }
         aout_OutputFlush (aout, wait);
     }
+    else
+        aout_DecDiscardPending (aout, false);
+    owner->sync.end = VLC_TS_INVALID;
     aout_OutputUnlock (aout);
 }
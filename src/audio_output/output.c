@@ -542,7 +542,7 @@ void aout_OutputLock (audio_output_t *aout)
     vlc_mutex_lock (&owner->lock);
 }
 
-static int aout_OutputTryLock (audio_output_t *aout)
+int aout_OutputTryLock (audio_output_t *aout)
 {
     aout_owner_t *owner = aout_owner (aout);
 
@@ -26,6 +26,7 @@
 #endif
 
 #include <vlc_common.h>
+#include <vlc_arrays.h>
 #include <vlc_keys.h>
 #include <vlc_modules.h>
 #include <vlc_plugin.h>
@@ -471,25 +472,11 @@ ssize_t config_GetPszChoices (vlc_object_t *obj, const char *name,
     return count;
 }
 
-static int confcmp (const void *a, const void *b)
-{
-    const module_config_t *const *ca = a, *const *cb = b;
-
-    return strcmp ((*ca)->psz_name, (*cb)->psz_name);
-}
-
-static int confnamecmp (const void *key, const void *elem)
-{
-    const module_config_t *const *conf = elem;
-
-    return strcmp (key, (*conf)->psz_name);
-}
-
 static struct
 {
-    module_config_t **list;
-    size_t count;
-} config = { NULL, 0 };
+    vlc_dictionary_t dict; /* option name -> module_config_t */
+    bool             ready;
+} config = { .ready = false };
 
 /**
  * Index the configuration items by name for faster lookups.
@@ -502,14 +489,10 @@ int config_SortConfig (void)
     for (size_t i = 0; i < nmod; i++)
          nconf  += mlist[i]->confsize;
 
-    module_config_t **clist = malloc (sizeof (*clist) * nconf);
-    if (unlikely(clist == NULL))
-    {
-        module_list_free (mlist);
-        return VLC_ENOMEM;
-    }
+    /* One hash probe per lookup: var_Inherit*() resolves option names on
+     * hot paths (filter and access open), so this beats a sorted array */
+    vlc_dictionary_init (&config.dict, nconf);
 
-    nconf = 0;
     for (size_t i = 0; i < nmod; i++)
     {
         module_t *parser = mlist[i];
@@ -521,27 +504,22 @@ int config_SortConfig (void)
         {
             if (!CONFIG_ITEM(item->i_type))
                 continue; /* ignore hints */
-            clist[nconf++] = item;
+            vlc_dictionary_insert (&config.dict, item->psz_name, item);
         }
     }
     module_list_free (mlist);
 
-    qsort (clist, nconf, sizeof (*clist), confcmp);
-
-    config.list = clist;
-    config.count = nconf;
+    config.ready = true;
     return VLC_SUCCESS;
 }
 
 void config_UnsortConfig (void)
 {
-    module_config_t **clist;
-
-    clist = config.list;
-    config.list = NULL;
-    config.count = 0;
+    if (!config.ready)
+        return;
 
-    free (clist);
+    config.ready = false;
+    vlc_dictionary_clear (&config.dict, NULL, NULL);
 }
 
 /*****************************************************************************
@@ -553,12 +531,10 @@ module_config_t *config_FindConfig (vlc_object_t *p_this, const char *name)
 {
     VLC_UNUSED(p_this);
 
-    if (unlikely(name == NULL))
+    if (unlikely(name == NULL || !config.ready))
         return NULL;
 
-    module_config_t *const *p;
-    p = bsearch (name, config.list, config.count, sizeof (*p), confnamecmp);
-    return p ? *p : NULL;
+    return vlc_dictionary_value_for_key (&config.dict, name);
 }
 
 /**
@@ -221,11 +221,9 @@ static ssize_t AStreamReadBlock(stream_t *s, void *buf, size_t len)
     {
         uint64_t total;
 
-        vlc_mutex_lock(&input->p->counters.counters_lock);
         stats_Update(input->p->counters.p_read_bytes, block->i_buffer, &total);
         stats_Update(input->p->counters.p_input_bitrate, total, NULL);
         stats_Update(input->p->counters.p_read_packets, 1, NULL);
-        vlc_mutex_unlock(&input->p->counters.counters_lock);
     }
 
     size_t copy = block->i_buffer < len ? block->i_buffer : len;
@@ -271,11 +269,9 @@ static ssize_t AStreamReadStream(stream_t *s, void *buf, size_t len)
     {
         uint64_t total;
 
-        vlc_mutex_lock(&input->p->counters.counters_lock);
         stats_Update(input->p->counters.p_read_bytes, val, &total);
         stats_Update(input->p->counters.p_input_bitrate, total, NULL);
         stats_Update(input->p->counters.p_read_packets, 1, NULL);
-        vlc_mutex_unlock(&input->p->counters.counters_lock);
     }
 
     return val;
@@ -32,6 +32,7 @@
 
 #include <vlc_common.h>
 #include <vlc_input.h>
+#include <vlc_atomic.h>
 #include "clock.h"
 #include <assert.h>
 
@@ -122,6 +123,40 @@ static void    AvgUpdate( average_t *, mtime_t i_value );
 static mtime_t AvgGet( average_t * );
 static void    AvgRescale( average_t *, int i_divider );
 
+/**
+ * This structure holds a second order phase-locked loop drift estimator
+ * ("clock-estimator" set to PLL).
+ *
+ * Unlike the moving average it learns the slope of the drift (the integral
+ * term), so the estimate keeps converging between reference updates, and it
+ * clamps the phase error against the smoothed jitter so an outlier (one
+ * packet delayed by the network) barely moves the estimate instead of
+ * triggering an audible correction.
+ * The divider plays the role of the loop time constant and is driven by the
+ * same "cr-average" scaling as the moving average.
+ */
+typedef struct
+{
+    mtime_t i_offset;      /* Estimated drift */
+    mtime_t i_freq;        /* Drift slope in 1/PLL_FREQ_SCALE of µs per update */
+    mtime_t i_deviation;   /* Smoothed |phase error| used to reject outliers */
+    mtime_t i_dev_residue;
+
+    int     i_count;
+    int     i_divider;
+} pll_t;
+
+/* Fixed point scale of the pll_t frequency term */
+#define PLL_FREQ_SCALE (65536)
+/* Deviation floor (in µs) so the outlier clamp never collapses to zero */
+#define PLL_MIN_DEVIATION (500)
+
+static void    PllInit( pll_t *, int i_divider );
+static void    PllReset( pll_t * );
+static void    PllUpdate( pll_t *, mtime_t i_value );
+static mtime_t PllGet( pll_t * );
+static void    PllRescale( pll_t *, int i_divider );
+
 /* */
 typedef struct
 {
@@ -139,24 +174,46 @@ static inline clock_point_t clock_point_Create( mtime_t i_stream, mtime_t i_syst
 #define INPUT_CLOCK_LATE_COUNT (3)
 
 /* */
+/* Parameters needed to convert a timestamp, as published for the lock-free
+ * readers (see ClockPublishSnapshot) */
+typedef struct
+{
+    bool          b_has_reference;
+    clock_point_t ref;
+    mtime_t       i_drift;
+    int           i_rate;
+    mtime_t       i_pts_delay;
+    mtime_t       i_buffering_duration;
+} input_clock_snapshot_t;
+
 struct input_clock_t
 {
     /* */
     vlc_mutex_t lock;
 
+    /* Seqlock-published snapshot of the conversion parameters, read by
+     * the decoder threads without taking the lock */
+    struct
+    {
+        atomic_uint seq;
+        input_clock_snapshot_t data;
+    } snapshot;
+
     /* Last point
      * It is used to detect unexpected stream discontinuities */
     clock_point_t last;
 
     /* Maximal timestamp returned by input_clock_ConvertTS (in system unit) */
-    mtime_t i_ts_max;
+    atomic_int_fast64_t i_ts_max;
 
     /* Amount of extra buffering expressed in stream clock */
     mtime_t i_buffering_duration;
 
     /* Clock drift */
     mtime_t i_next_drift_update;
+    bool      b_pll;  /* Estimate the drift with the PLL instead of the average */
     average_t drift;
+    pll_t     pll;
 
     /* Late statistics */
     struct
@@ -185,10 +242,79 @@ static mtime_t ClockSystemToStream( input_clock_t *, mtime_t i_system );
 
 static mtime_t ClockGetTsOffset( input_clock_t * );
 
+static void DriftReset( input_clock_t *cl )
+{
+    if( cl->b_pll )
+        PllReset( &cl->pll );
+    else
+        AvgReset( &cl->drift );
+}
+static void DriftUpdate( input_clock_t *cl, mtime_t i_value )
+{
+    if( cl->b_pll )
+        PllUpdate( &cl->pll, i_value );
+    else
+        AvgUpdate( &cl->drift, i_value );
+}
+static mtime_t DriftGet( input_clock_t *cl )
+{
+    return cl->b_pll ? PllGet( &cl->pll ) : AvgGet( &cl->drift );
+}
+
+/**
+ * Publishes the current conversion parameters for the lock-free readers.
+ * Must be called with the lock held, after every modification of them.
+ */
+static void ClockPublishSnapshot( input_clock_t *cl )
+{
+    unsigned seq = atomic_load_explicit( &cl->snapshot.seq,
+                                         memory_order_relaxed );
+
+    atomic_store_explicit( &cl->snapshot.seq, seq + 1, memory_order_relaxed );
+    atomic_thread_fence( memory_order_release );
+
+    cl->snapshot.data.b_has_reference = cl->b_has_reference;
+    cl->snapshot.data.ref = cl->ref;
+    cl->snapshot.data.i_drift = DriftGet( cl );
+    cl->snapshot.data.i_rate = cl->i_rate;
+    cl->snapshot.data.i_pts_delay = cl->i_pts_delay;
+    cl->snapshot.data.i_buffering_duration = cl->i_buffering_duration;
+
+    atomic_store_explicit( &cl->snapshot.seq, seq + 2, memory_order_release );
+}
+
+/**
+ * Reads a coherent snapshot of the conversion parameters, without taking
+ * the lock (and thus without ever blocking on the input thread).
+ */
+static void ClockReadSnapshot( input_clock_t *cl, input_clock_snapshot_t *snap )
+{
+    unsigned s1, s2;
+
+    do
+    {
+        do
+            s1 = atomic_load_explicit( &cl->snapshot.seq,
+                                       memory_order_acquire );
+        while( s1 & 1 );
+        *snap = cl->snapshot.data;
+        atomic_thread_fence( memory_order_acquire );
+        s2 = atomic_load_explicit( &cl->snapshot.seq, memory_order_relaxed );
+    }
+    while( s1 != s2 );
+}
+
+static mtime_t ClockSnapshotStreamToSystem( const input_clock_snapshot_t *snap,
+                                            mtime_t i_stream )
+{
+    return ( i_stream - snap->ref.i_stream ) * snap->i_rate / INPUT_RATE_DEFAULT +
+           snap->ref.i_system;
+}
+
 /*****************************************************************************
  * input_clock_New: create a new clock
  *****************************************************************************/
-input_clock_t *input_clock_New( int i_rate )
+input_clock_t *input_clock_New( int i_rate, bool b_pll_estimator )
 {
     input_clock_t *cl = malloc( sizeof(*cl) );
     if( !cl )
@@ -201,12 +327,15 @@ input_clock_t *input_clock_New( int i_rate )
 
     cl->last = clock_point_Create( VLC_TS_INVALID, VLC_TS_INVALID );
 
-    cl->i_ts_max = VLC_TS_INVALID;
+    atomic_init( &cl->i_ts_max, VLC_TS_INVALID );
+    atomic_init( &cl->snapshot.seq, 0 );
 
     cl->i_buffering_duration = 0;
 
     cl->i_next_drift_update = VLC_TS_INVALID;
+    cl->b_pll = b_pll_estimator;
     AvgInit( &cl->drift, 10 );
+    PllInit( &cl->pll, 10 );
 
     cl->late.i_index = 0;
     for( int i = 0; i < INPUT_CLOCK_LATE_COUNT; i++ )
@@ -217,6 +346,8 @@ input_clock_t *input_clock_New( int i_rate )
     cl->b_paused = false;
     cl->i_pause_date = VLC_TS_INVALID;
 
+    ClockPublishSnapshot( cl );
+
     return cl;
 }
 
@@ -260,7 +391,8 @@ void input_clock_Update( input_clock_t *cl, vlc_object_t *p_log,
          * warning from the stream control facilities (dd-edited
          * stream ?). */
         msg_Warn( p_log, "clock gap, unexpected stream discontinuity" );
-        cl->i_ts_max = VLC_TS_INVALID;
+        atomic_store_explicit( &cl->i_ts_max, VLC_TS_INVALID,
+                               memory_order_relaxed );
 
         /* */
         msg_Warn( p_log, "feeding synchro with a new reference point trying to recover from clock gap" );
@@ -271,12 +403,14 @@ void input_clock_Update( input_clock_t *cl, vlc_object_t *p_log,
     if( b_reset_reference )
     {
         cl->i_next_drift_update = VLC_TS_INVALID;
-        AvgReset( &cl->drift );
+        DriftReset( cl );
 
         /* Feed synchro with a new reference point. */
         cl->b_has_reference = true;
         cl->ref = clock_point_Create( i_ck_stream,
-                                      __MAX( cl->i_ts_max + CR_MEAN_PTS_GAP, i_ck_system ) );
+                                      __MAX( atomic_load_explicit( &cl->i_ts_max,
+                                                 memory_order_relaxed )
+                                             + CR_MEAN_PTS_GAP, i_ck_system ) );
         cl->b_has_external_clock = false;
     }
 
@@ -286,7 +420,7 @@ void input_clock_Update( input_clock_t *cl, vlc_object_t *p_log,
     {
         const mtime_t i_converted = ClockSystemToStream( cl, i_ck_system );
 
-        AvgUpdate( &cl->drift, i_converted - i_ck_stream );
+        DriftUpdate( cl, i_converted - i_ck_stream );
 
         cl->i_next_drift_update = i_ck_system + CLOCK_FREQ/5; /* FIXME why that */
     }
@@ -314,7 +448,7 @@ void input_clock_Update( input_clock_t *cl, vlc_object_t *p_log,
 
     /* It does not take the decoder latency into account but it is not really
      * the goal of the clock here */
-    const mtime_t i_system_expected = ClockStreamToSystem( cl, i_ck_stream + AvgGet( &cl->drift ) );
+    const mtime_t i_system_expected = ClockStreamToSystem( cl, i_ck_stream + DriftGet( cl ) );
     const mtime_t i_late = ( i_ck_system - cl->i_pts_delay ) - i_system_expected;
     *pb_late = i_late > 0;
     if( i_late > 0 )
@@ -323,6 +457,8 @@ void input_clock_Update( input_clock_t *cl, vlc_object_t *p_log,
         cl->late.i_index = ( cl->late.i_index + 1 ) % INPUT_CLOCK_LATE_COUNT;
     }
 
+    ClockPublishSnapshot( cl );
+
     vlc_mutex_unlock( &cl->lock );
 }
 
@@ -336,7 +472,10 @@ void input_clock_Reset( input_clock_t *cl )
     cl->b_has_reference = false;
     cl->ref = clock_point_Create( VLC_TS_INVALID, VLC_TS_INVALID );
     cl->b_has_external_clock = false;
-    cl->i_ts_max = VLC_TS_INVALID;
+    atomic_store_explicit( &cl->i_ts_max, VLC_TS_INVALID,
+                           memory_order_relaxed );
+
+    ClockPublishSnapshot( cl );
 
     vlc_mutex_unlock( &cl->lock );
 }
@@ -356,6 +495,8 @@ void input_clock_ChangeRate( input_clock_t *cl, int i_rate )
     }
     cl->i_rate = i_rate;
 
+    ClockPublishSnapshot( cl );
+
     vlc_mutex_unlock( &cl->lock );
 }
 
@@ -380,6 +521,8 @@ void input_clock_ChangePause( input_clock_t *cl, bool b_paused, mtime_t i_date )
     cl->i_pause_date = i_date;
     cl->b_paused = b_paused;
 
+    ClockPublishSnapshot( cl );
+
     vlc_mutex_unlock( &cl->lock );
 }
 
@@ -394,7 +537,7 @@ mtime_t input_clock_GetWakeup( input_clock_t *cl )
 
     /* Synchronized, we can wait */
     if( cl->b_has_reference )
-        i_wakeup = ClockStreamToSystem( cl, cl->last.i_stream + AvgGet( &cl->drift ) - cl->i_buffering_duration );
+        i_wakeup = ClockStreamToSystem( cl, cl->last.i_stream + DriftGet( cl ) - cl->i_buffering_duration );
 
     vlc_mutex_unlock( &cl->lock );
 
@@ -408,15 +551,19 @@ int input_clock_ConvertTS( vlc_object_t *p_object, input_clock_t *cl,
                            int *pi_rate, mtime_t *pi_ts0, mtime_t *pi_ts1,
                            mtime_t i_ts_bound )
 {
+    input_clock_snapshot_t snap;
+
     assert( pi_ts0 );
-    vlc_mutex_lock( &cl->lock );
+
+    /* Work on the published snapshot: decoder threads must never block
+     * on the input thread updating the clock */
+    ClockReadSnapshot( cl, &snap );
 
     if( pi_rate )
-        *pi_rate = cl->i_rate;
+        *pi_rate = snap.i_rate;
 
-    if( !cl->b_has_reference )
+    if( !snap.b_has_reference )
     {
-        vlc_mutex_unlock( &cl->lock );
         msg_Err(p_object, "Timestamp conversion failed for %"PRId64": "
                 "no reference clock", *pi_ts0);
         *pi_ts0 = VLC_TS_INVALID;
@@ -426,27 +573,32 @@ int input_clock_ConvertTS( vlc_object_t *p_object, input_clock_t *cl,
     }
 
     /* */
-    const mtime_t i_ts_buffering = cl->i_buffering_duration * cl->i_rate / INPUT_RATE_DEFAULT;
-    const mtime_t i_ts_delay = cl->i_pts_delay + ClockGetTsOffset( cl );
+    const mtime_t i_ts_buffering = snap.i_buffering_duration * snap.i_rate / INPUT_RATE_DEFAULT;
+    const mtime_t i_ts_delay = snap.i_pts_delay +
+        snap.i_pts_delay * ( snap.i_rate - INPUT_RATE_DEFAULT ) / INPUT_RATE_DEFAULT;
 
     /* */
     if( *pi_ts0 > VLC_TS_INVALID )
     {
-        *pi_ts0 = ClockStreamToSystem( cl, *pi_ts0 + AvgGet( &cl->drift ) );
-        if( *pi_ts0 > cl->i_ts_max )
-            cl->i_ts_max = *pi_ts0;
+        *pi_ts0 = ClockSnapshotStreamToSystem( &snap, *pi_ts0 + snap.i_drift );
+
+        mtime_t i_ts_max = atomic_load_explicit( &cl->i_ts_max,
+                                                 memory_order_relaxed );
+        while( *pi_ts0 > i_ts_max &&
+               !atomic_compare_exchange_weak_explicit( &cl->i_ts_max,
+                                                       &i_ts_max, *pi_ts0,
+                                                       memory_order_relaxed,
+                                                       memory_order_relaxed ) );
         *pi_ts0 += i_ts_delay;
     }
 
     /* XXX we do not update i_ts_max on purpose */
     if( pi_ts1 && *pi_ts1 > VLC_TS_INVALID )
     {
-        *pi_ts1 = ClockStreamToSystem( cl, *pi_ts1 + AvgGet( &cl->drift ) ) +
+        *pi_ts1 = ClockSnapshotStreamToSystem( &snap, *pi_ts1 + snap.i_drift ) +
                   i_ts_delay;
     }
 
-    vlc_mutex_unlock( &cl->lock );
-
     /* Check ts validity */
     if (i_ts_bound != INT64_MAX && *pi_ts0 > VLC_TS_INVALID) {
         if (*pi_ts0 >= mdate() + i_ts_delay + i_ts_buffering + i_ts_bound) {
@@ -465,13 +617,11 @@ int input_clock_ConvertTS( vlc_object_t *p_object, input_clock_t *cl,
  *****************************************************************************/
 int input_clock_GetRate( input_clock_t *cl )
 {
-    int i_rate;
+    input_clock_snapshot_t snap;
 
-    vlc_mutex_lock( &cl->lock );
-    i_rate = cl->i_rate;
-    vlc_mutex_unlock( &cl->lock );
+    ClockReadSnapshot( cl, &snap );
 
-    return i_rate;
+    return snap.i_rate;
 }
 
 int input_clock_GetState( input_clock_t *cl,
@@ -520,6 +670,8 @@ void input_clock_ChangeSystemOrigin( input_clock_t *cl, bool b_absolute, mtime_t
     cl->ref.i_system += i_offset;
     cl->last.i_system += i_offset;
 
+    ClockPublishSnapshot( cl );
+
     vlc_mutex_unlock( &cl->lock );
 }
 
@@ -572,6 +724,10 @@ void input_clock_SetJitter( input_clock_t *cl,
 
     if( cl->drift.i_divider != i_cr_average )
         AvgRescale( &cl->drift, i_cr_average );
+    if( cl->pll.i_divider != i_cr_average )
+        PllRescale( &cl->pll, i_cr_average );
+
+    ClockPublishSnapshot( cl );
 
     vlc_mutex_unlock( &cl->lock );
 }
@@ -673,3 +829,65 @@ static void AvgRescale( average_t *p_avg, int i_divider )
     p_avg->i_value   = i_tmp / p_avg->i_divider;
     p_avg->i_residue = i_tmp % p_avg->i_divider;
 }
+
+/*****************************************************************************
+ * Phase-locked loop drift estimator helpers
+ *****************************************************************************/
+static void PllInit( pll_t *p_pll, int i_divider )
+{
+    p_pll->i_divider = i_divider;
+    PllReset( p_pll );
+}
+static void PllReset( pll_t *p_pll )
+{
+    p_pll->i_offset      = 0;
+    p_pll->i_freq        = 0;
+    p_pll->i_deviation   = 0;
+    p_pll->i_dev_residue = 0;
+    p_pll->i_count       = 0;
+}
+static void PllUpdate( pll_t *p_pll, mtime_t i_value )
+{
+    mtime_t i_error = i_value - p_pll->i_offset;
+
+    /* Once the loop has warmed up, clamp the phase error to a few times the
+     * smoothed jitter: a lone late observation barely moves the estimate
+     * instead of dragging every subsequent conversion with it */
+    if( p_pll->i_count >= p_pll->i_divider )
+    {
+        const mtime_t i_limit = 3 * __MAX( p_pll->i_deviation,
+                                           PLL_MIN_DEVIATION );
+        if( i_error > i_limit )
+            i_error = i_limit;
+        else if( i_error < -i_limit )
+            i_error = -i_limit;
+    }
+
+    /* Track the jitter level with the same time constant as the loop */
+    const mtime_t i_abs = i_error >= 0 ? i_error : -i_error;
+    const mtime_t i_tmp = (p_pll->i_divider - 1) * p_pll->i_deviation +
+                          i_abs + p_pll->i_dev_residue;
+    p_pll->i_deviation   = i_tmp / p_pll->i_divider;
+    p_pll->i_dev_residue = i_tmp % p_pll->i_divider;
+
+    /* Critically damped second order loop: the proportional term corrects
+     * the phase, the integral term learns the steady drift slope so the
+     * estimate keeps converging between reference updates */
+    p_pll->i_offset += p_pll->i_freq / PLL_FREQ_SCALE +
+                       i_error / p_pll->i_divider;
+    p_pll->i_freq   += i_error * PLL_FREQ_SCALE /
+                       ( 4 * (mtime_t)p_pll->i_divider * p_pll->i_divider );
+
+    p_pll->i_count++;
+}
+static mtime_t PllGet( pll_t *p_pll )
+{
+    return p_pll->i_offset;
+}
+static void PllRescale( pll_t *p_pll, int i_divider )
+{
+    /* The offset and slope stay valid, only the loop bandwidth changes */
+    if( i_divider < 1 )
+        i_divider = 1;
+    p_pll->i_divider = i_divider;
+}
@@ -38,9 +38,12 @@ typedef struct input_clock_t input_clock_t;
 
 /**
  * This function creates a new input_clock_t.
+ * The drift is estimated either with a moving average or, when
+ * b_pll_estimator is set, with a jitter-rejecting phase-locked loop
+ * ("clock-estimator" option).
  * You must use input_clock_Delete to delete it once unused.
  */
-input_clock_t *input_clock_New( int i_rate );
+input_clock_t *input_clock_New( int i_rate, bool b_pll_estimator );
 
 /**
  * This function destroys a input_clock_t created by input_clock_New.
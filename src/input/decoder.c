@@ -53,6 +53,7 @@
 #include "resource.h"
 
 #include "../video_output/vout_control.h"
+#include "../tracepoint.h"
 
 struct decoder_owner_sys_t
 {
@@ -121,10 +122,16 @@ struct decoder_owner_sys_t
         bool b_supported;
         bool pb_present[4];
         decoder_t *pp_decoder[4];
+        /* number of attached CC decoders, read without the lock from the
+         * decoder thread to keep idle CC extraction off the video path */
+        atomic_uint i_consumers;
     } cc;
 
     /* Delay */
     mtime_t i_ts_delay;
+
+    /* Tasks in flight on the shared worker pool (under the pool lock) */
+    unsigned i_pool_pending;
 };
 
 /* Pictures which are DECODER_BOGUS_VIDEO_DELAY or more in advance probably have
@@ -134,6 +141,170 @@ struct decoder_owner_sys_t
 /* */
 #define DECODER_SPU_VOUT_WAIT_DURATION ((int)(0.200*CLOCK_FREQ))
 
+/* Number of blocks drained from the fifo per decoder thread wake-up. Must be
+ * lower than the input_DecoderDecode() high-water mark (10 blocks) so the
+ * feeding thread is not starved. */
+#define DECODER_BATCH 8
+
+/*****************************************************************************
+ * Shared decoder worker pool
+ *****************************************************************************
+ * Frame- or slice-parallel decoder modules schedule independent tasks here
+ * (via decoder_ScheduleTask()) instead of each spawning a private set of
+ * threads. The pool is shared by all decoders of the process; its threads
+ * are started on first use and stopped with the last decoder.
+ */
+typedef struct decoder_task_t
+{
+    struct decoder_task_t *p_next;
+    void                 (*pf_run)( void * );
+    void                  *p_data;
+    decoder_owner_sys_t   *p_owner;
+} decoder_task_t;
+
+static struct
+{
+    vlc_mutex_t      lock;
+    vlc_cond_t       wait_task;    /* A task was queued or b_exit was set */
+    vlc_cond_t       wait_done;    /* A task completed */
+    decoder_task_t  *p_first;
+    decoder_task_t **pp_last;
+    vlc_thread_t    *p_threads;
+    unsigned         i_threads;
+    unsigned         i_refs;       /* Live decoders */
+    bool             b_exit;
+} pool = { VLC_STATIC_MUTEX, VLC_STATIC_COND, VLC_STATIC_COND,
+           NULL, &pool.p_first, NULL, 0, 0, false };
+
+static void *DecoderPoolThread( void *dummy )
+{
+    VLC_UNUSED(dummy);
+
+    vlc_mutex_lock( &pool.lock );
+    while( !pool.b_exit )
+    {
+        decoder_task_t *p_task = pool.p_first;
+        if( p_task == NULL )
+        {
+            vlc_cond_wait( &pool.wait_task, &pool.lock );
+            continue;
+        }
+        pool.p_first = p_task->p_next;
+        if( pool.p_first == NULL )
+            pool.pp_last = &pool.p_first;
+        vlc_mutex_unlock( &pool.lock );
+
+        p_task->pf_run( p_task->p_data );
+
+        vlc_mutex_lock( &pool.lock );
+        p_task->p_owner->i_pool_pending--;
+        vlc_cond_broadcast( &pool.wait_done );
+        free( p_task );
+    }
+    vlc_mutex_unlock( &pool.lock );
+    return NULL;
+}
+
+static int DecoderSchedulePoolTask( decoder_t *p_dec,
+                                    void (*pf_run)(void *), void *p_data )
+{
+    decoder_owner_sys_t *p_owner = p_dec->p_owner;
+    decoder_task_t *p_task = malloc( sizeof( *p_task ) );
+
+    if( unlikely(p_task == NULL) )
+        return VLC_ENOMEM;
+    p_task->p_next = NULL;
+    p_task->pf_run = pf_run;
+    p_task->p_data = p_data;
+    p_task->p_owner = p_owner;
+
+    vlc_mutex_lock( &pool.lock );
+    if( pool.b_exit )
+    {   /* The last decoder is tearing the pool down right now; let the
+         * caller run the task synchronously */
+        vlc_mutex_unlock( &pool.lock );
+        free( p_task );
+        return VLC_EGENERIC;
+    }
+    if( pool.i_threads == 0 )
+    {
+        /* Lazy start: most decoders never schedule anything */
+        unsigned i_want = __MIN( vlc_GetCPUCount(), 8 );
+        pool.p_threads = malloc( i_want * sizeof(vlc_thread_t) );
+        if( pool.p_threads != NULL )
+            for( unsigned i = 0; i < i_want; i++ )
+            {
+                if( vlc_clone( &pool.p_threads[pool.i_threads],
+                               DecoderPoolThread, NULL,
+                               VLC_THREAD_PRIORITY_VIDEO ) )
+                    break;
+                pool.i_threads++;
+            }
+        if( pool.i_threads == 0 )
+        {
+            free( pool.p_threads );
+            pool.p_threads = NULL;
+            vlc_mutex_unlock( &pool.lock );
+            free( p_task );
+            return VLC_EGENERIC;
+        }
+    }
+    *pool.pp_last = p_task;
+    pool.pp_last = &p_task->p_next;
+    p_owner->i_pool_pending++;
+    vlc_cond_signal( &pool.wait_task );
+    vlc_mutex_unlock( &pool.lock );
+    return VLC_SUCCESS;
+}
+
+static void DecoderWaitPoolTasks( decoder_t *p_dec )
+{
+    decoder_owner_sys_t *p_owner = p_dec->p_owner;
+
+    vlc_mutex_lock( &pool.lock );
+    while( p_owner->i_pool_pending > 0 )
+        vlc_cond_wait( &pool.wait_done, &pool.lock );
+    vlc_mutex_unlock( &pool.lock );
+}
+
+static void DecoderPoolRef( void )
+{
+    vlc_mutex_lock( &pool.lock );
+    pool.i_refs++;
+    vlc_mutex_unlock( &pool.lock );
+}
+
+static void DecoderPoolUnref( void )
+{
+    vlc_mutex_lock( &pool.lock );
+    assert( pool.i_refs > 0 );
+    if( --pool.i_refs > 0 || pool.i_threads == 0 )
+    {
+        vlc_mutex_unlock( &pool.lock );
+        return;
+    }
+
+    /* Last decoder gone; every task was waited for in DeleteDecoder so the
+     * queue is empty. New decoders created while we join fall back on
+     * synchronous execution until b_exit is reset. */
+    pool.b_exit = true;
+    vlc_cond_broadcast( &pool.wait_task );
+
+    unsigned i_threads = pool.i_threads;
+    vlc_thread_t *p_threads = pool.p_threads;
+    pool.i_threads = 0;
+    pool.p_threads = NULL;
+    vlc_mutex_unlock( &pool.lock );
+
+    for( unsigned i = 0; i < i_threads; i++ )
+        vlc_join( p_threads[i], NULL );
+    free( p_threads );
+
+    vlc_mutex_lock( &pool.lock );
+    pool.b_exit = false;
+    vlc_mutex_unlock( &pool.lock );
+}
+
 /**
  * Load a decoder module
  */
@@ -802,6 +973,27 @@ static void DecoderGetCc( decoder_t *p_dec, decoder_t *p_dec_cc )
     if( !p_cc )
         return;
 
+    /* Nobody consumes the data: only the channel presence bits need a
+     * refresh, and they are written from this thread only, so they can be
+     * read unlocked here. This keeps idle CC extraction from taking the
+     * owner lock on every video frame of a captioned stream. */
+    if( atomic_load( &p_owner->cc.i_consumers ) == 0 )
+    {
+        bool b_changed = false;
+        for( i = 0; i < 4; i++ )
+            b_changed |= pb_present[i] && !p_owner->cc.pb_present[i];
+
+        if( b_changed )
+        {
+            vlc_mutex_lock( &p_owner->lock );
+            for( i = 0; i < 4; i++ )
+                p_owner->cc.pb_present[i] |= pb_present[i];
+            vlc_mutex_unlock( &p_owner->lock );
+        }
+        block_Release( p_cc );
+        return;
+    }
+
     vlc_mutex_lock( &p_owner->lock );
     for( i = 0, i_cc_decoder = 0; i < 4; i++ )
     {
@@ -885,6 +1077,7 @@ static void DecoderPlayVideo( decoder_t *p_dec, picture_t *p_picture,
             vout_Flush( p_vout, p_picture->date );
             p_owner->i_last_rate = i_rate;
         }
+        vlc_tracepoint1( decoder_video, p_picture->date );
         vout_PutPicture( p_vout, p_picture );
     }
     else
@@ -947,12 +1140,10 @@ static void DecoderUpdateStatVideo( decoder_t *p_dec, int i_decoded,
     /* Update ugly stat */
     if( p_input != NULL && (i_decoded > 0 || i_lost > 0 || i_displayed > 0) )
     {
-        vlc_mutex_lock( &p_input->p->counters.counters_lock );
         stats_Update( p_input->p->counters.p_decoded_video, i_decoded, NULL );
         stats_Update( p_input->p->counters.p_lost_pictures, i_lost , NULL);
         stats_Update( p_input->p->counters.p_displayed_pictures,
                       i_displayed, NULL);
-        vlc_mutex_unlock( &p_input->p->counters.counters_lock );
     }
 }
 
@@ -1088,6 +1279,7 @@ static void DecoderPlayAudio( decoder_t *p_dec, block_t *p_audio,
         return;
     }
 
+    vlc_tracepoint1( decoder_audio, p_audio->i_pts );
     if( aout_DecPlay( p_aout, p_audio, i_rate ) == 0 )
         *pi_played_sum += 1;
 
@@ -1131,11 +1323,9 @@ static void DecoderUpdateStatAudio( decoder_t *p_dec, int i_decoded,
     /* Update ugly stat */
     if( p_input != NULL && (i_decoded > 0 || i_lost > 0 || i_played > 0) )
     {
-        vlc_mutex_lock( &p_input->p->counters.counters_lock);
         stats_Update( p_input->p->counters.p_lost_abuffers, i_lost, NULL );
         stats_Update( p_input->p->counters.p_played_abuffers, i_played, NULL );
         stats_Update( p_input->p->counters.p_decoded_audio, i_decoded, NULL );
-        vlc_mutex_unlock( &p_input->p->counters.counters_lock);
     }
 }
 
@@ -1271,9 +1461,7 @@ static int DecoderQueueSpu( decoder_t *p_dec, subpicture_t *p_spu )
 
     if( p_input != NULL )
     {
-        vlc_mutex_lock( &p_input->p->counters.counters_lock );
         stats_Update( p_input->p->counters.p_decoded_sub, 1, NULL );
-        vlc_mutex_unlock( &p_input->p->counters.counters_lock );
     }
 
     int i_ret = -1;
@@ -1435,6 +1623,8 @@ static void *DecoderThread( void *p_data )
     decoder_owner_sys_t *p_owner = p_dec->p_owner;
     bool paused = false;
 
+    vlc_thread_SetRole( p_dec, "decoder" );
+
     /* The decoder's main loop */
     vlc_fifo_Lock( p_owner->p_fifo );
     vlc_fifo_CleanupPush( p_owner->p_fifo );
@@ -1493,8 +1683,13 @@ static void *DecoderThread( void *p_data )
         vlc_cond_signal( &p_owner->wait_fifo );
         vlc_testcancel(); /* forced expedited cancellation in case of stop */
 
-        block_t *p_block = vlc_fifo_DequeueUnlocked( p_owner->p_fifo );
-        if( p_block == NULL )
+        /* Drain a batch of blocks per wake-up so that locking and wake-up
+         * costs amortize across packets (think thousands of tiny audio
+         * packets per second on live streams). While frame-stepping, stick
+         * to one block at a time so a step decodes exactly one frame. */
+        block_t *p_batch = vlc_fifo_DequeueBatchUnlocked( p_owner->p_fifo,
+                             p_owner->frames_countdown ? 1 : DECODER_BATCH );
+        if( p_batch == NULL )
         {
             if( likely(!p_owner->b_draining) )
             {   /* Wait for a block to decode (or a request to drain) */
@@ -1511,19 +1706,33 @@ static void *DecoderThread( void *p_data )
         vlc_fifo_Unlock( p_owner->p_fifo );
 
         int canc = vlc_savecancel();
-        DecoderProcess( p_dec, p_block );
+        bool drained = ( p_batch == NULL );
+        do
+        {
+            block_t *p_block = p_batch;
 
-        if( p_block == NULL )
-        {   /* Draining: the decoder is drained and all decoded buffers are
-             * queued to the output at this point. Now drain the output. */
-            if( p_owner->p_aout != NULL )
-                aout_DecFlush( p_owner->p_aout, true );
+            if( p_block != NULL )
+            {
+                p_batch = p_block->p_next;
+                p_block->p_next = NULL;
+            }
+
+            DecoderProcess( p_dec, p_block );
+
+            if( p_block == NULL )
+            {   /* Draining: the decoder is drained and all decoded buffers
+                 * are queued to the output at this point. Now drain the
+                 * output. */
+                if( p_owner->p_aout != NULL )
+                    aout_DecFlush( p_owner->p_aout, true );
+            }
         }
+        while( p_batch != NULL );
         vlc_restorecancel( canc );
 
         /* Given that the drained flag is only polled, an atomic variable is
          * sufficient. TODO? Wait for draining instead of polling. */
-        atomic_store( &p_owner->drained, (p_block == NULL) );
+        atomic_store( &p_owner->drained, drained );
 
         vlc_mutex_lock( &p_owner->lock );
         vlc_fifo_Lock( p_owner->p_fifo );
@@ -1593,14 +1802,17 @@ static decoder_t * CreateDecoder( vlc_object_t *p_parent,
 
     es_format_Init( &p_owner->fmt, UNKNOWN_ES, 0 );
 
-    /* decoder fifo */
-    p_owner->p_fifo = block_FifoNew();
+    /* decoder fifo: input and CC fan-out threads both feed it, so use the
+     * lock-free enqueue variant to keep them off the consumer lock */
+    p_owner->p_fifo = block_FifoMPSCNew();
     if( unlikely(p_owner->p_fifo == NULL) )
     {
         free( p_owner );
         vlc_object_release( p_dec );
         return NULL;
     }
+    /* Cycled once per packet: spin briefly rather than park at high rates */
+    block_FifoHot( p_owner->p_fifo );
 
     vlc_mutex_init( &p_owner->lock );
     vlc_cond_init( &p_owner->wait_request );
@@ -1620,6 +1832,11 @@ static decoder_t * CreateDecoder( vlc_object_t *p_parent,
     p_dec->pf_queue_video = DecoderQueueVideo;
     p_dec->pf_queue_audio = DecoderQueueAudio;
     p_dec->pf_queue_sub = DecoderQueueSpu;
+    p_dec->pf_schedule_task = DecoderSchedulePoolTask;
+    p_dec->pf_wait_tasks = DecoderWaitPoolTasks;
+
+    p_owner->i_pool_pending = 0;
+    DecoderPoolRef();
 
     /* Load a packetizer module if the input is not already packetized */
     if( p_sout == NULL && !fmt->b_packetized )
@@ -1678,6 +1895,7 @@ static decoder_t * CreateDecoder( vlc_object_t *p_parent,
         p_owner->cc.pb_present[i] = false;
         p_owner->cc.pp_decoder[i] = NULL;
     }
+    atomic_init( &p_owner->cc.i_consumers, 0 );
     p_owner->i_ts_delay = 0;
     return p_dec;
 }
@@ -1753,6 +1971,10 @@ static void DeleteDecoder( decoder_t * p_dec )
         vlc_object_release( p_owner->p_packetizer );
     }
 
+    /* No task may outlive its decoder */
+    DecoderWaitPoolTasks( p_dec );
+    DecoderPoolUnref();
+
     vlc_cond_destroy( &p_owner->wait_timed );
     vlc_cond_destroy( &p_owner->wait_fifo );
     vlc_cond_destroy( &p_owner->wait_acknowledge );
@@ -1816,6 +2038,10 @@ static decoder_t *decoder_New( vlc_object_t *p_parent, input_thread_t *p_input,
 
     if( p_dec->fmt_out.i_cat == AUDIO_ES )
         i_priority = VLC_THREAD_PRIORITY_AUDIO;
+    else if( p_dec->fmt_out.i_cat == SPU_ES )
+        /* Subtitle decoding is cheap but timing-critical (accessibility):
+         * keep it on a lane that saturated video decoding cannot starve */
+        i_priority = VLC_THREAD_PRIORITY_OUTPUT;
     else
         i_priority = VLC_THREAD_PRIORITY_VIDEO;
 
@@ -1916,6 +2142,15 @@ void input_DecoderDecode( decoder_t *p_dec, block_t *p_block, bool b_do_pace )
 {
     decoder_owner_sys_t *p_owner = p_dec->p_owner;
 
+    /* The subtitle lane is never paced: its decoder thread deliberately
+     * holds decoded subtitles until SPU_MAX_PREPARE_TIME before display, so
+     * the fifo legitimately backs up. Blocking the input thread on it would
+     * hold every other track hostage behind queued captions (and a full
+     * video fifo already delays caption packets demuxed after it). The
+     * byte-count overflow guard below still bounds memory. */
+    if( p_dec->fmt_out.i_cat == SPU_ES )
+        b_do_pace = false;
+
     vlc_fifo_Lock( p_owner->p_fifo );
     if( !b_do_pace )
     {
@@ -2071,6 +2306,7 @@ int input_DecoderSetCcState( decoder_t *p_dec, bool b_decode, int i_channel )
         vlc_mutex_lock( &p_owner->lock );
         p_owner->cc.pp_decoder[i_channel] = p_cc;
         vlc_mutex_unlock( &p_owner->lock );
+        atomic_fetch_add( &p_owner->cc.i_consumers, 1 );
     }
     else
     {
@@ -2082,7 +2318,10 @@ int input_DecoderSetCcState( decoder_t *p_dec, bool b_decode, int i_channel )
         vlc_mutex_unlock( &p_owner->lock );
 
         if( p_cc )
+        {
+            atomic_fetch_sub( &p_owner->cc.i_consumers, 1 );
             input_DecoderDelete(p_cc);
+        }
     }
     return VLC_SUCCESS;
 }
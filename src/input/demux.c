@@ -217,6 +217,14 @@ demux_t *demux_NewAdvanced( vlc_object_t *p_obj, input_thread_t *p_parent_input,
           ;
         SkipAPETag( p_demux );
 
+        if( !b_quick )
+        {   /* Warm up the stream cache with a single large read, so the
+             * probe cascade below is served from memory instead of each
+             * candidate growing the cached header a few bytes at a time. */
+            const uint8_t *p_peek;
+            stream_Peek( s, &p_peek, 16384 );
+        }
+
         p_demux->p_module =
             module_need( p_demux, "demux", psz_module,
                          !strcmp( psz_module, p_demux->psz_demux ) );
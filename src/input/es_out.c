@@ -43,6 +43,7 @@
 #include "clock.h"
 #include "decoder.h"
 #include "es_out.h"
+#include "../tracepoint.h"
 #include "event.h"
 #include "info.h"
 #include "item.h"
@@ -175,6 +176,7 @@ struct es_out_sys_t
 
 static es_out_id_t *EsOutAdd    ( es_out_t *, const es_format_t * );
 static int          EsOutSend   ( es_out_t *, es_out_id_t *, block_t * );
+static int          EsOutSendBatch( es_out_t *, es_out_id_t *, block_t * );
 static void         EsOutDel    ( es_out_t *, es_out_id_t * );
 static int          EsOutControl( es_out_t *, int i_query, va_list );
 static void         EsOutDelete ( es_out_t * );
@@ -242,6 +244,7 @@ es_out_t *input_EsOutNew( input_thread_t *p_input, int i_rate )
     out->pf_del     = EsOutDel;
     out->pf_control = EsOutControl;
     out->pf_destroy = EsOutDelete;
+    out->pf_send_batch = EsOutSendBatch;
     out->p_sys      = p_sys;
 
     vlc_mutex_init_recursive( &p_sys->lock );
@@ -1054,7 +1057,8 @@ static es_out_pgrm_t *EsOutProgramAdd( es_out_t *out, int i_group )
     p_pgrm->psz_name = NULL;
     p_pgrm->psz_now_playing = NULL;
     p_pgrm->psz_publisher = NULL;
-    p_pgrm->p_clock = input_clock_New( p_sys->i_rate );
+    p_pgrm->p_clock = input_clock_New( p_sys->i_rate,
+                                       var_InheritInteger( p_input, "clock-estimator" ) == 1 );
     if( !p_pgrm->p_clock )
     {
         free( p_pgrm );
@@ -1371,7 +1375,7 @@ static void EsOutMeta( es_out_t *p_out, const vlc_meta_t *p_meta )
         psz_arturl = input_item_GetArtURL( p_item ); /* save value */
 
     vlc_mutex_lock( &p_item->lock );
-    vlc_meta_Merge( p_item->p_meta, p_meta );
+    vlc_meta_Merge( input_item_WritableMeta( p_item ), p_meta );
     vlc_mutex_unlock( &p_item->lock );
 
     if( psz_arturl != NULL ) /* restore/favor previously set item art URL */
@@ -1922,34 +1926,35 @@ static void EsOutSelect( es_out_t *out, es_out_id_t *es, bool b_force )
  * \param es the es_out_id
  * \param p_block the data block to send
  */
-static int EsOutSend( es_out_t *out, es_out_id_t *es, block_t *p_block )
+static void EsOutUpdateDemuxStats( input_thread_t *p_input, size_t i_bytes,
+                                   unsigned i_corrupted,
+                                   unsigned i_discontinuity )
 {
-    es_out_sys_t   *p_sys = out->p_sys;
-    input_thread_t *p_input = p_sys->p_input;
+    uint64_t i_total;
 
-    if( libvlc_stats( p_input ) )
-    {
-        uint64_t i_total;
-
-        vlc_mutex_lock( &p_input->p->counters.counters_lock );
-        stats_Update( p_input->p->counters.p_demux_read,
-                      p_block->i_buffer, &i_total );
-        stats_Update( p_input->p->counters.p_demux_bitrate, i_total, NULL );
+    stats_Update( p_input->p->counters.p_demux_read, i_bytes, &i_total );
+    stats_Update( p_input->p->counters.p_demux_bitrate, i_total, NULL );
 
-        /* Update number of corrupted data packats */
-        if( p_block->i_flags & BLOCK_FLAG_CORRUPTED )
-        {
-            stats_Update( p_input->p->counters.p_demux_corrupted, 1, NULL );
-        }
-        /* Update number of discontinuities */
-        if( p_block->i_flags & BLOCK_FLAG_DISCONTINUITY )
-        {
-            stats_Update( p_input->p->counters.p_demux_discontinuity, 1, NULL );
-        }
-        vlc_mutex_unlock( &p_input->p->counters.counters_lock );
+    /* Update number of corrupted data packats */
+    if( i_corrupted > 0 )
+    {
+        stats_Update( p_input->p->counters.p_demux_corrupted, i_corrupted,
+                      NULL );
     }
+    /* Update number of discontinuities */
+    if( i_discontinuity > 0 )
+    {
+        stats_Update( p_input->p->counters.p_demux_discontinuity,
+                      i_discontinuity, NULL );
+    }
+}
 
-    vlc_mutex_lock( &p_sys->lock );
+static void EsOutSendLocked( es_out_t *out, es_out_id_t *es, block_t *p_block )
+{
+    es_out_sys_t   *p_sys = out->p_sys;
+    input_thread_t *p_input = p_sys->p_input;
+
+    vlc_tracepoint2( demux_send, p_block->i_pts, es->fmt.i_cat );
 
     /* Mark preroll blocks */
     if( p_sys->i_preroll_end >= 0 )
@@ -1965,8 +1970,7 @@ static int EsOutSend( es_out_t *out, es_out_id_t *es, block_t *p_block )
     if( !es->p_dec )
     {
         block_Release( p_block );
-        vlc_mutex_unlock( &p_sys->lock );
-        return VLC_SUCCESS;
+        return;
     }
 
     /* Check for sout mode */
@@ -2037,7 +2041,61 @@ static int EsOutSend( es_out_t *out, es_out_id_t *es, block_t *p_block )
         if (p_sys->i_sub_last == i)
             EsOutSelect(out, es->pp_cc_es[i], true);
     }
+}
 
+static int EsOutSend( es_out_t *out, es_out_id_t *es, block_t *p_block )
+{
+    es_out_sys_t   *p_sys = out->p_sys;
+    input_thread_t *p_input = p_sys->p_input;
+
+    if( libvlc_stats( p_input ) )
+        EsOutUpdateDemuxStats( p_input, p_block->i_buffer,
+                               ( p_block->i_flags & BLOCK_FLAG_CORRUPTED ) ? 1 : 0,
+                               ( p_block->i_flags & BLOCK_FLAG_DISCONTINUITY ) ? 1 : 0 );
+
+    vlc_mutex_lock( &p_sys->lock );
+    EsOutSendLocked( out, es, p_block );
+    vlc_mutex_unlock( &p_sys->lock );
+
+    return VLC_SUCCESS;
+}
+
+/**
+ * Sends a p_next chain of blocks of a single ES with one lock acquisition
+ * and one statistics update (es_out_SendBatch).
+ */
+static int EsOutSendBatch( es_out_t *out, es_out_id_t *es, block_t *p_block )
+{
+    es_out_sys_t   *p_sys = out->p_sys;
+    input_thread_t *p_input = p_sys->p_input;
+
+    if( libvlc_stats( p_input ) )
+    {
+        size_t   i_bytes = 0;
+        unsigned i_corrupted = 0;
+        unsigned i_discontinuity = 0;
+
+        for( block_t *p = p_block; p != NULL; p = p->p_next )
+        {
+            i_bytes += p->i_buffer;
+            if( p->i_flags & BLOCK_FLAG_CORRUPTED )
+                i_corrupted++;
+            if( p->i_flags & BLOCK_FLAG_DISCONTINUITY )
+                i_discontinuity++;
+        }
+        EsOutUpdateDemuxStats( p_input, i_bytes, i_corrupted,
+                               i_discontinuity );
+    }
+
+    vlc_mutex_lock( &p_sys->lock );
+    while( p_block != NULL )
+    {
+        block_t *p_next = p_block->p_next;
+
+        p_block->p_next = NULL;
+        EsOutSendLocked( out, es, p_block );
+        p_block = p_next;
+    }
     vlc_mutex_unlock( &p_sys->lock );
 
     return VLC_SUCCESS;
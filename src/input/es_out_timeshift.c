@@ -37,6 +37,10 @@
 #endif
 #include <sys/stat.h>
 #include <unistd.h>
+#ifndef _WIN32
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#endif
 
 #include <vlc_common.h>
 #include <vlc_fs.h>
@@ -159,11 +163,13 @@ struct ts_storage_t
     /* */
 #ifdef _WIN32
     char    *psz_file;  /* Filename */
+#else
+    uint8_t *p_map;     /* Preallocated file mapping, NULL when using stdio */
 #endif
     size_t  i_file_max; /* Max size in bytes */
     int64_t i_file_size;/* Current size in bytes */
-    FILE    *p_filew;   /* FILE handle for data writing */
-    FILE    *p_filer;   /* FILE handle for data reading */
+    FILE    *p_filew;   /* FILE handle for data writing (stdio fallback) */
+    FILE    *p_filer;   /* FILE handle for data reading (stdio fallback) */
 
     /* */
     int      i_cmd_r;
@@ -239,6 +245,7 @@ struct es_out_sys_t
 
 static es_out_id_t *Add    ( es_out_t *, const es_format_t * );
 static int          Send   ( es_out_t *, es_out_id_t *, block_t * );
+static int          SendBatch( es_out_t *, es_out_id_t *, block_t * );
 static void         Del    ( es_out_t *, es_out_id_t * );
 static int          Control( es_out_t *, int i_query, va_list );
 static void         Destroy( es_out_t * );
@@ -308,6 +315,7 @@ es_out_t *input_EsOutTimeshiftNew( input_thread_t *p_input, es_out_t *p_next_out
     p_out->pf_del     = Del;
     p_out->pf_control = Control;
     p_out->pf_destroy = Destroy;
+    p_out->pf_send_batch = SendBatch;
     p_out->p_sys      = p_sys;
 
     /* */
@@ -465,6 +473,35 @@ static int Send( es_out_t *p_out, es_out_id_t *p_es, block_t *p_block )
 
     return i_ret;
 }
+static int SendBatch( es_out_t *p_out, es_out_id_t *p_es, block_t *p_block )
+{
+    es_out_sys_t *p_sys = p_out->p_sys;
+    int i_ret = VLC_SUCCESS;
+
+    vlc_mutex_lock( &p_sys->lock );
+
+    TsAutoStop( p_out );
+
+    if( !p_sys->b_delayed )
+    {
+        /* Keep the chain batched downstream */
+        i_ret = es_out_SendBatch( p_sys->p_out, p_es->p_es, p_block );
+    }
+    else while( p_block != NULL )
+    {
+        block_t *p_next = p_block->p_next;
+        ts_cmd_t cmd;
+
+        p_block->p_next = NULL;
+        CmdInitSend( &cmd, p_es, p_block );
+        TsPushCmd( p_sys->p_ts, &cmd );
+        p_block = p_next;
+    }
+
+    vlc_mutex_unlock( &p_sys->lock );
+
+    return i_ret;
+}
 static void Del( es_out_t *p_out, es_out_id_t *p_es )
 {
     es_out_sys_t *p_sys = p_out->p_sys;
@@ -1107,20 +1144,43 @@ static ts_storage_t *TsStorageNew( const char *psz_tmp_path, int64_t i_tmp_size_
         return NULL;
     }
 
-    p_storage->p_filew = fdopen( fd, "w+b" );
-    if( p_storage->p_filew == NULL )
+    p_storage->p_filew = NULL;
+    p_storage->p_filer = NULL;
+
+#ifndef _WIN32
+    /* Preallocate the whole segment and map it: pushing/popping a command
+     * then boils down to a memcpy(), without any syscall, stdio buffer copy
+     * or file fragmentation. Preallocation also rules out SIGBUS on a full
+     * disk. Fall back on stdio when the file system cannot do it. */
+    p_storage->p_map = NULL;
+    if( posix_fallocate( fd, 0, i_tmp_size_max ) == 0 )
     {
-        close( fd );
-        vlc_unlink( psz_file );
-        goto error;
+        void *p_map = mmap( NULL, i_tmp_size_max, PROT_READ | PROT_WRITE,
+                            MAP_SHARED, fd, 0 );
+        if( p_map != MAP_FAILED )
+            p_storage->p_map = p_map;
     }
 
-    p_storage->p_filer = vlc_fopen( psz_file, "rb" );
-    if( p_storage->p_filer == NULL )
+    if( p_storage->p_map != NULL )
+        close( fd );
+    else
+#endif
     {
-        fclose( p_storage->p_filew );
-        vlc_unlink( psz_file );
-        goto error;
+        p_storage->p_filew = fdopen( fd, "w+b" );
+        if( p_storage->p_filew == NULL )
+        {
+            close( fd );
+            vlc_unlink( psz_file );
+            goto error;
+        }
+
+        p_storage->p_filer = vlc_fopen( psz_file, "rb" );
+        if( p_storage->p_filer == NULL )
+        {
+            fclose( p_storage->p_filew );
+            vlc_unlink( psz_file );
+            goto error;
+        }
     }
 
 #ifndef _WIN32
@@ -1166,8 +1226,15 @@ static void TsStorageDelete( ts_storage_t *p_storage )
     }
     free( p_storage->p_cmd );
 
-    fclose( p_storage->p_filer );
-    fclose( p_storage->p_filew );
+#ifndef _WIN32
+    if( p_storage->p_map != NULL )
+        /* The file is long unlinked, so this also releases its page cache */
+        munmap( p_storage->p_map, p_storage->i_file_max );
+#endif
+    if( p_storage->p_filer != NULL )
+        fclose( p_storage->p_filer );
+    if( p_storage->p_filew != NULL )
+        fclose( p_storage->p_filew );
 #ifdef _WIN32
     vlc_unlink( p_storage->psz_file );
     free( p_storage->psz_file );
@@ -1213,6 +1280,33 @@ static void TsStoragePushCmd( ts_storage_t *p_storage, const ts_cmd_t *p_cmd, bo
         block_t *p_block = cmd.u.send.p_block;
 
         cmd.u.send.p_block = NULL;
+
+#ifndef _WIN32
+        if( p_storage->p_map != NULL )
+        {
+            size_t i_size = sizeof(*p_block) + p_block->i_buffer;
+
+            /* TsStorageIsFull() lets the very first command through unchecked,
+             * so an oversized block could still overrun the mapping */
+            if( (size_t)p_storage->i_file_size + i_size > p_storage->i_file_max )
+            {
+                block_Release( p_block );
+                return;
+            }
+            cmd.u.send.i_offset = p_storage->i_file_size;
+            memcpy( &p_storage->p_map[p_storage->i_file_size],
+                    p_block, sizeof(*p_block) );
+            if( p_block->i_buffer > 0 )
+                memcpy( &p_storage->p_map[p_storage->i_file_size
+                                          + sizeof(*p_block)],
+                        p_block->p_buffer, p_block->i_buffer );
+            p_storage->i_file_size += i_size;
+            block_Release( p_block );
+
+            p_storage->p_cmd[p_storage->i_cmd_w++] = cmd;
+            return;
+        }
+#endif
         cmd.u.send.i_offset = ftell( p_storage->p_filew );
 
         if( fwrite( p_block, sizeof(*p_block), 1, p_storage->p_filew ) != 1 )
@@ -1246,6 +1340,36 @@ static void TsStoragePopCmd( ts_storage_t *p_storage, ts_cmd_t *p_cmd, bool b_fl
     {
         block_t block;
 
+#ifndef _WIN32
+        if( p_storage->p_map != NULL )
+        {
+            if( !b_flush )
+            {
+                memcpy( &block, &p_storage->p_map[p_cmd->u.send.i_offset],
+                        sizeof(block) );
+
+                block_t *p_block = block_Alloc( block.i_buffer );
+                if( p_block )
+                {
+                    p_block->i_dts      = block.i_dts;
+                    p_block->i_pts      = block.i_pts;
+                    p_block->i_flags    = block.i_flags;
+                    p_block->i_length   = block.i_length;
+                    p_block->i_nb_samples = block.i_nb_samples;
+                    memcpy( p_block->p_buffer,
+                            &p_storage->p_map[p_cmd->u.send.i_offset
+                                              + sizeof(block)],
+                            block.i_buffer );
+                }
+                p_cmd->u.send.p_block = p_block;
+            }
+            else
+            {
+                p_cmd->u.send.p_block = block_Alloc( 1 );
+            }
+            return;
+        }
+#endif
         if( !b_flush &&
             !fseek( p_storage->p_filer, p_cmd->u.send.i_offset, SEEK_SET ) &&
             fread( &block, sizeof(block), 1, p_storage->p_filer ) == 1 )
@@ -25,6 +25,20 @@
 #define LIBVLC_INPUT_INFO_H 1
 
 #include "vlc_input_item.h"
+#include "vlc_arrays.h"
+
+/* A category carries a hash index over its info names, so that the
+ * periodic info updates (stats, ES infos) stay O(1) per field instead of
+ * rescanning the array. The public info_category_t layout is unchanged:
+ * the index lives in the private allocation behind it and is maintained
+ * by the helpers below, which are the only writers of a category. */
+typedef struct
+{
+    info_category_t cat;
+    vlc_dictionary_t idx; /* info name -> info_t */
+} info_category_priv_t;
+
+#define info_category_priv(cat) ((info_category_priv_t *)(cat))
 
 static inline info_t *info_New(const char *name, const char *value )
 {
@@ -46,27 +60,32 @@ static inline void info_Delete(info_t *i)
 
 static inline info_category_t *info_category_New(const char *name)
 {
-    info_category_t *cat = malloc(sizeof(*cat));
-    if (!cat)
+    info_category_priv_t *priv = malloc(sizeof(*priv));
+    if (!priv)
         return NULL;
-    cat->psz_name = strdup(name);
-    cat->i_infos  = 0;
-    cat->pp_infos = NULL;
+    priv->cat.psz_name = strdup(name);
+    priv->cat.i_infos  = 0;
+    priv->cat.pp_infos = NULL;
+    vlc_dictionary_init(&priv->idx, 0);
 
-    return cat;
+    return &priv->cat;
 }
 
 static inline info_t *info_category_FindInfo(const info_category_t *cat,
                                              int *index, const char *name)
 {
-    for (int i = 0; i < cat->i_infos; i++) {
-        if (!strcmp(cat->pp_infos[i]->psz_name, name)) {
-            if (index)
+    info_t *info =
+        vlc_dictionary_value_for_key(&info_category_priv(cat)->idx, name);
+
+    if (info && index) {
+        for (int i = 0; i < cat->i_infos; i++) {
+            if (cat->pp_infos[i] == info) {
                 *index = i;
-            return cat->pp_infos[i];
+                break;
+            }
         }
     }
-    return NULL;
+    return info;
 }
 
 static inline void info_category_ReplaceInfo(info_category_t *cat,
@@ -77,9 +96,12 @@ static inline void info_category_ReplaceInfo(info_category_t *cat,
     if (old) {
         info_Delete(cat->pp_infos[index]);
         cat->pp_infos[index] = info;
+        vlc_dictionary_remove_value_for_key(&info_category_priv(cat)->idx,
+                                            info->psz_name, NULL, NULL);
     } else {
         INSERT_ELEM(cat->pp_infos, cat->i_infos, cat->i_infos, info);
     }
+    vlc_dictionary_insert(&info_category_priv(cat)->idx, info->psz_name, info);
 }
 
 static inline info_t *info_category_VaAddInfo(info_category_t *cat,
@@ -92,6 +114,7 @@ static inline info_t *info_category_VaAddInfo(info_category_t *cat,
         if (!info)
             return NULL;
         INSERT_ELEM(cat->pp_infos, cat->i_infos, cat->i_infos, info);
+        vlc_dictionary_insert(&info_category_priv(cat)->idx, name, info);
     } else
         free(info->psz_value);
     if (vasprintf(&info->psz_value, format, args) == -1)
@@ -116,6 +139,8 @@ static inline int info_category_DeleteInfo(info_category_t *cat, const char *nam
 {
     int index;
     if (info_category_FindInfo(cat, &index, name)) {
+        vlc_dictionary_remove_value_for_key(&info_category_priv(cat)->idx,
+                                            name, NULL, NULL);
         info_Delete(cat->pp_infos[index]);
         REMOVE_ELEM(cat->pp_infos, cat->i_infos, index);
         return VLC_SUCCESS;
@@ -125,11 +150,12 @@ static inline int info_category_DeleteInfo(info_category_t *cat, const char *nam
 
 static inline void info_category_Delete(info_category_t *cat)
 {
+    vlc_dictionary_clear(&info_category_priv(cat)->idx, NULL, NULL);
     for (int i = 0; i < cat->i_infos; i++)
         info_Delete(cat->pp_infos[i]);
     free(cat->pp_infos);
     free(cat->psz_name);
-    free(cat);
+    free(info_category_priv(cat));
 }
 
 #endif
@@ -63,6 +63,7 @@ static input_thread_t * Create  ( vlc_object_t *, input_item_t *,
 static  int             Init    ( input_thread_t *p_input );
 static void             End     ( input_thread_t *p_input );
 static void             MainLoop( input_thread_t *p_input, bool b_interactive );
+static void            *WatchdogThread( void * );
 
 static inline int ControlPop( input_thread_t *, int *, vlc_value_t *, mtime_t i_deadline, bool b_postpone_seek );
 static void       ControlRelease( int i_type, vlc_value_t val );
@@ -81,6 +82,9 @@ static input_source_t *InputSourceNew( input_thread_t *, const char *,
                                        bool b_in_can_fail );
 static void InputSourceDestroy( input_source_t * );
 static void InputSourceMeta( input_thread_t *, input_source_t *, vlc_meta_t * );
+static void InputGetSourcesMeta( input_thread_t * );
+static void LoadSubtitles( input_thread_t * );
+static void LoadSlaves( input_thread_t * );
 
 /* TODO */
 //static void InputGetAttachments( input_thread_t *, input_source_t * );
@@ -180,6 +184,21 @@ int input_Start( input_thread_t *p_input )
         msg_Err( p_input, "cannot create input thread" );
         return VLC_EGENERIC;
     }
+
+    if( !p_input->b_preparsing )
+    {
+        mtime_t i_period =
+            var_InheritInteger( p_input, "input-watchdog" ) * CLOCK_FREQ;
+        if( i_period > 0 )
+        {
+            p_input->p->watchdog.i_period = i_period;
+            p_input->p->watchdog.b_thread =
+                !vlc_clone( &p_input->p->watchdog.thread, WatchdogThread,
+                            p_input, VLC_THREAD_PRIORITY_LOW );
+            if( !p_input->p->watchdog.b_thread )
+                msg_Warn( p_input, "cannot create input watchdog thread" );
+        }
+    }
     return VLC_SUCCESS;
 }
 
@@ -213,6 +232,11 @@ void input_Stop( input_thread_t *p_input )
  */
 void input_Close( input_thread_t *p_input )
 {
+    if( p_input->p->watchdog.b_thread )
+    {
+        vlc_cancel( p_input->p->watchdog.thread );
+        vlc_join( p_input->p->watchdog.thread, NULL );
+    }
     if( p_input->p->is_running )
         vlc_join( p_input->p->thread, NULL );
     vlc_interrupt_deinit( &p_input->p->interrupt );
@@ -241,8 +265,6 @@ static void input_Destructor( vlc_object_t *obj )
 
     vlc_gc_decref( p_input->p->p_item );
 
-    vlc_mutex_destroy( &p_input->p->counters.counters_lock );
-
     for( int i = 0; i < p_input->p->i_control; i++ )
     {
         input_control_t *p_ctrl = &p_input->p->control[i];
@@ -318,6 +340,9 @@ static input_thread_t *Create( vlc_object_t *p_parent, input_item_t *p_item,
     p_input->p->is_running = false;
     p_input->p->is_stopped = false;
     p_input->p->b_recording = false;
+    p_input->p->b_init_postponed = false;
+    p_input->p->watchdog.b_thread = false;
+    atomic_init( &p_input->p->watchdog.heartbeat, 0 );
     p_input->p->i_rate = INPUT_RATE_DEFAULT;
     memset( &p_input->p->bookmark, 0, sizeof(p_input->p->bookmark) );
     TAB_INIT( p_input->p->i_bookmark, p_input->p->pp_bookmark );
@@ -448,7 +473,6 @@ static input_thread_t *Create( vlc_object_t *p_parent, input_item_t *p_item,
 
     /* */
     memset( &p_input->p->counters, 0, sizeof( p_input->p->counters ) );
-    vlc_mutex_init( &p_input->p->counters.counters_lock );
 
     p_input->p->p_es_out_display = input_EsOutNew( p_input, p_input->p->i_rate );
     p_input->p->p_es_out = NULL;
@@ -459,6 +483,51 @@ static input_thread_t *Create( vlc_object_t *p_parent, input_item_t *p_item,
     return p_input;
 }
 
+/*****************************************************************************
+ * WatchdogThread: watch the input thread progress heartbeat
+ * When a blocking access stalls, the main loop stops iterating; this
+ * low-priority monitor turns that silence into periodic log lines with the
+ * input state and position instead of an apparent hang.
+ *****************************************************************************/
+static void *WatchdogThread( void *obj )
+{
+    input_thread_t *p_input = obj;
+    input_thread_private_t *priv = p_input->p;
+    unsigned i_last = atomic_load_explicit( &priv->watchdog.heartbeat,
+                                            memory_order_relaxed );
+    unsigned i_periods = 0;
+
+    for( ;; )
+    {
+        msleep( priv->watchdog.i_period ); /* cancellation point */
+
+        unsigned i_beat = atomic_load_explicit( &priv->watchdog.heartbeat,
+                                                memory_order_relaxed );
+        if( i_beat != i_last )
+        {
+            if( i_periods > 0 )
+                msg_Warn( p_input, "input thread resumed after a stall of "
+                          "at least %"PRId64" ms",
+                          i_periods * priv->watchdog.i_period / 1000 );
+            i_last = i_beat;
+            i_periods = 0;
+            continue;
+        }
+
+        /* Paused or finished inputs legitimately stop iterating */
+        int i_state = var_GetInteger( p_input, "state" );
+        if( i_state == PAUSE_S || i_state == END_S )
+            continue;
+
+        i_periods++;
+        msg_Warn( p_input, "input thread stalled for at least %"PRId64" ms "
+                  "(state %d, time %"PRId64")",
+                  i_periods * priv->watchdog.i_period / 1000, i_state,
+                  var_GetInteger( p_input, "time" ) );
+    }
+    vlc_assert_unreachable();
+}
+
 /*****************************************************************************
  * Run: main thread loop
  * This is the "normal" thread that spawns the input processing chain,
@@ -468,6 +537,7 @@ static void *Run( void *obj )
 {
     input_thread_t *p_input = (input_thread_t *)obj;
 
+    vlc_thread_SetRole( p_input, "input" );
     vlc_interrupt_set(&p_input->p->interrupt);
 
     if( !Init( p_input ) )
@@ -648,6 +718,20 @@ static void MainLoopStatistics( input_thread_t *p_input )
     input_SendEventStatistics( p_input );
 }
 
+/**
+ * MainLoopPostponedInit
+ * Run the startup steps postponed by "input-fast-start", now that the
+ * first demuxed data is on its way to the decoders.
+ */
+static void MainLoopPostponedInit( input_thread_t *p_input )
+{
+    p_input->p->b_init_postponed = false;
+
+    LoadSubtitles( p_input );
+    LoadSlaves( p_input );
+    InputGetSourcesMeta( p_input );
+}
+
 /**
  * MainLoop
  * The main input loop.
@@ -665,6 +749,10 @@ static void MainLoop( input_thread_t *p_input, bool b_interactive )
 
     while( !input_Stopped( p_input ) && p_input->p->i_state != ERROR_S )
     {
+        /* Progress heartbeat for WatchdogThread */
+        atomic_fetch_add_explicit( &p_input->p->watchdog.heartbeat, 1,
+                                   memory_order_relaxed );
+
         mtime_t i_wakeup = -1;
         bool b_paused = p_input->p->i_state == PAUSE_S;
         /* FIXME if p_input->p->i_state == PAUSE_S the access/access_demux
@@ -682,6 +770,9 @@ static void MainLoop( input_thread_t *p_input, bool b_interactive )
 
                 MainLoopDemux( p_input, &b_force_update );
 
+                if( p_input->p->b_init_postponed )
+                    MainLoopPostponedInit( p_input );
+
                 if( p_input->p->master->p_demux->pf_demux != NULL )
                     i_wakeup = es_out_GetWakeup( p_input->p->p_es_out );
                 if( b_force_update )
@@ -1178,9 +1269,15 @@ static int Init( input_thread_t * p_input )
 
     if( !p_input->b_preparsing )
     {
+        p_input->p->b_init_postponed =
+            var_GetBool( p_input, "input-fast-start" );
+
         StartTitle( p_input );
-        LoadSubtitles( p_input );
-        LoadSlaves( p_input );
+        if( !p_input->p->b_init_postponed )
+        {
+            LoadSubtitles( p_input );
+            LoadSlaves( p_input );
+        }
         InitPrograms( p_input );
 
         double f_rate = var_InheritFloat( p_input, "rate" );
@@ -1206,22 +1303,8 @@ static int Init( input_thread_t * p_input )
                  p_input->p->b_out_pace_control ? "async" : "sync" );
     }
 
-    vlc_meta_t *p_meta = vlc_meta_New();
-    if( p_meta != NULL )
-    {
-        /* Get meta data from users */
-        InputMetaUser( p_input, p_meta );
-
-        /* Get meta data from master input */
-        InputSourceMeta( p_input, master, p_meta );
-
-        /* And from slave */
-        for( int i = 0; i < p_input->p->i_slave; i++ )
-            InputSourceMeta( p_input, p_input->p->slave[i], p_meta );
-
-        es_out_ControlSetMeta( p_input->p->p_es_out, p_meta );
-        vlc_meta_Delete( p_meta );
-    }
+    if( !p_input->p->b_init_postponed )
+        InputGetSourcesMeta( p_input );
 
     msg_Dbg( p_input, "`%s' successfully opened",
              p_input->p->p_item->psz_uri );
@@ -2303,6 +2386,29 @@ static void InputSourceDestroy( input_source_t *in )
     vlc_object_release( in );
 }
 
+/*****************************************************************************
+ * InputGetSourcesMeta: gather user, master and slave meta data
+ *****************************************************************************/
+static void InputGetSourcesMeta( input_thread_t *p_input )
+{
+    vlc_meta_t *p_meta = vlc_meta_New();
+    if( p_meta == NULL )
+        return;
+
+    /* Get meta data from users */
+    InputMetaUser( p_input, p_meta );
+
+    /* Get meta data from master input */
+    InputSourceMeta( p_input, p_input->p->master, p_meta );
+
+    /* And from slave */
+    for( int i = 0; i < p_input->p->i_slave; i++ )
+        InputSourceMeta( p_input, p_input->p->slave[i], p_meta );
+
+    es_out_ControlSetMeta( p_input->p->p_es_out, p_meta );
+    vlc_meta_Delete( p_meta );
+}
+
 /*****************************************************************************
  * InputSourceMeta:
  *****************************************************************************/
@@ -2845,7 +2951,6 @@ void input_UpdateStatistic( input_thread_t *p_input,
 {
     assert( p_input->p->i_state != INIT_S );
 
-    vlc_mutex_lock( &p_input->p->counters.counters_lock);
     switch( i_type )
     {
 #define I(c) stats_Update( p_input->p->counters.c, i_delta, NULL )
@@ -2874,7 +2979,6 @@ void input_UpdateStatistic( input_thread_t *p_input,
         msg_Err( p_input, "Invalid statistic type %d (internal error)", i_type );
         break;
     }
-    vlc_mutex_unlock( &p_input->p->counters.counters_lock);
 }
 
 /**/
@@ -25,6 +25,7 @@
 #define LIBVLC_INPUT_INTERNAL_H 1
 
 #include <vlc_access.h>
+#include <vlc_atomic.h>
 #include <vlc_demux.h>
 #include <vlc_input.h>
 #include <libvlc.h>
@@ -98,6 +99,8 @@ struct input_thread_private_t
     int64_t     i_stop;     /* :stop-time, 0 if none */
     int64_t     i_time;     /* Current time */
     bool        b_fast_seek;/* :input-fast-seek */
+    bool        b_init_postponed; /* :input-fast-start, slave/meta setup
+                                   * deferred until decoding has started */
 
     /* Output */
     bool            b_out_pace_control; /* XXX Move it ot es_sout ? */
@@ -156,7 +159,6 @@ struct input_thread_private_t
         counter_t *p_lost_abuffers;
         counter_t *p_displayed_pictures;
         counter_t *p_lost_pictures;
-        vlc_mutex_t counters_lock;
     } counters;
 
     /* Buffer of pending actions */
@@ -167,6 +169,15 @@ struct input_thread_private_t
 
     vlc_thread_t thread;
     vlc_interrupt_t interrupt;
+
+    /* Stall watchdog (":input-watchdog", disabled by default) */
+    struct
+    {
+        vlc_thread_t thread;
+        bool         b_thread;
+        mtime_t      i_period;
+        atomic_uint  heartbeat; /* bumped by the input thread main loop */
+    } watchdog;
 };
 
 /***************************************************************************
@@ -256,6 +267,8 @@ void input_SplitMRL( const char **, const char **, const char **,
                      const char **, char * );
 
 /* meta.c */
+vlc_meta_t *vlc_meta_Hold( vlc_meta_t * );
+bool vlc_meta_IsShared( vlc_meta_t * );
 void vlc_audio_replay_gain_MergeFromMeta( audio_replay_gain_t *p_dst,
                                           const vlc_meta_t *p_meta );
 
@@ -34,6 +34,7 @@
 
 #include "item.h"
 #include "info.h"
+#include "input_internal.h"
 
 struct input_item_opaque
 {
@@ -71,25 +72,53 @@ void input_item_SignalPreparseEnded( input_item_t *p_i )
     vlc_event_send( &p_i->event_manager, &event );
 }
 
+/**
+ * Returns the item meta, creating it if needed, ready for writing.
+ *
+ * The item lock must be held.  If the current meta is shared with
+ * snapshot holders (see input_item_GetMetaSnapshot()), it is left to them
+ * untouched and replaced by a private copy, so that readers never see a
+ * concurrent write.  Can return NULL on allocation failure.
+ */
+vlc_meta_t *input_item_WritableMeta( input_item_t *p_i )
+{
+    vlc_meta_t *p_meta = p_i->p_meta;
+
+    if( p_meta == NULL )
+        p_i->p_meta = p_meta = vlc_meta_New();
+    else if( vlc_meta_IsShared( p_meta ) )
+    {
+        vlc_meta_t *p_copy = vlc_meta_New();
+        if( unlikely(p_copy == NULL) )
+            return NULL;
+        vlc_meta_Merge( p_copy, p_meta );
+        vlc_meta_SetStatus( p_copy, vlc_meta_GetStatus( p_meta ) );
+        vlc_meta_Delete( p_meta ); /* drops the item reference */
+        p_i->p_meta = p_meta = p_copy;
+    }
+    return p_meta;
+}
+
 void input_item_SetPreparsed( input_item_t *p_i, bool b_preparsed )
 {
     bool b_send_event = false;
+    int new_status = 0;
 
     vlc_mutex_lock( &p_i->lock );
 
-    if( !p_i->p_meta )
-        p_i->p_meta = vlc_meta_New();
-
-    int status = vlc_meta_GetStatus(p_i->p_meta);
-    int new_status;
-    if( b_preparsed )
-        new_status = status | ITEM_PREPARSED;
-    else
-        new_status = status & ~ITEM_PREPARSED;
-    if( status != new_status )
+    vlc_meta_t *p_meta = input_item_WritableMeta( p_i );
+    if( p_meta != NULL )
     {
-        vlc_meta_SetStatus(p_i->p_meta, new_status);
-        b_send_event = true;
+        int status = vlc_meta_GetStatus( p_meta );
+        if( b_preparsed )
+            new_status = status | ITEM_PREPARSED;
+        else
+            new_status = status & ~ITEM_PREPARSED;
+        if( status != new_status )
+        {
+            vlc_meta_SetStatus( p_meta, new_status );
+            b_send_event = true;
+        }
     }
 
     vlc_mutex_unlock( &p_i->lock );
@@ -107,17 +136,18 @@ void input_item_SetArtNotFound( input_item_t *p_i, bool b_not_found )
 {
     vlc_mutex_lock( &p_i->lock );
 
-    if( !p_i->p_meta )
-        p_i->p_meta = vlc_meta_New();
-
-    int status = vlc_meta_GetStatus(p_i->p_meta);
+    vlc_meta_t *p_meta = input_item_WritableMeta( p_i );
+    if( p_meta != NULL )
+    {
+        int status = vlc_meta_GetStatus( p_meta );
 
-    if( b_not_found )
-        status |= ITEM_ART_NOTFOUND;
-    else
-        status &= ~ITEM_ART_NOTFOUND;
+        if( b_not_found )
+            status |= ITEM_ART_NOTFOUND;
+        else
+            status &= ~ITEM_ART_NOTFOUND;
 
-    vlc_meta_SetStatus(p_i->p_meta, status);
+        vlc_meta_SetStatus( p_meta, status );
+    }
 
     vlc_mutex_unlock( &p_i->lock );
 }
@@ -126,17 +156,18 @@ void input_item_SetArtFetched( input_item_t *p_i, bool b_art_fetched )
 {
     vlc_mutex_lock( &p_i->lock );
 
-    if( !p_i->p_meta )
-        p_i->p_meta = vlc_meta_New();
-
-    int status = vlc_meta_GetStatus(p_i->p_meta);
+    vlc_meta_t *p_meta = input_item_WritableMeta( p_i );
+    if( p_meta != NULL )
+    {
+        int status = vlc_meta_GetStatus( p_meta );
 
-    if( b_art_fetched )
-        status |= ITEM_ART_FETCHED;
-    else
-        status &= ~ITEM_ART_FETCHED;
+        if( b_art_fetched )
+            status |= ITEM_ART_FETCHED;
+        else
+            status &= ~ITEM_ART_FETCHED;
 
-    vlc_meta_SetStatus(p_i->p_meta, status);
+        vlc_meta_SetStatus( p_meta, status );
+    }
 
     vlc_mutex_unlock( &p_i->lock );
 }
@@ -146,9 +177,9 @@ void input_item_SetMeta( input_item_t *p_i, vlc_meta_type_t meta_type, const cha
     vlc_event_t event;
 
     vlc_mutex_lock( &p_i->lock );
-    if( !p_i->p_meta )
-        p_i->p_meta = vlc_meta_New();
-    vlc_meta_Set( p_i->p_meta, meta_type, psz_val );
+    vlc_meta_t *p_meta = input_item_WritableMeta( p_i );
+    if( p_meta != NULL )
+        vlc_meta_Set( p_meta, meta_type, psz_val );
     vlc_mutex_unlock( &p_i->lock );
 
     /* Notify interested third parties */
@@ -248,6 +279,29 @@ char *input_item_GetMeta( input_item_t *p_i, vlc_meta_type_t meta_type )
     return psz;
 }
 
+/**
+ * Returns a read-only snapshot of the item metadata.
+ *
+ * The snapshot stays valid even while the preparser or the input thread
+ * update the item: writers replace the shared meta with a private copy
+ * instead of modifying it.  This lets UI refreshes walk many items
+ * without copying strings or holding any item lock beyond a reference
+ * count bump.
+ *
+ * \return a meta to release with vlc_meta_Delete(), or NULL if the item
+ * has no metadata (yet)
+ */
+vlc_meta_t *input_item_GetMetaSnapshot( input_item_t *p_i )
+{
+    vlc_mutex_lock( &p_i->lock );
+    vlc_meta_t *p_meta = p_i->p_meta;
+    if( p_meta != NULL )
+        vlc_meta_Hold( p_meta );
+    vlc_mutex_unlock( &p_i->lock );
+
+    return p_meta;
+}
+
 /* Get the title of a given item or fallback to the name if the title is empty */
 char *input_item_GetTitleFbName( input_item_t *p_item )
 {
@@ -790,12 +844,14 @@ void input_item_SetEpg( input_item_t *p_item, const vlc_epg_t *p_update )
         if( p_epg )
             TAB_APPEND( p_item->i_epg, p_item->pp_epg, p_epg );
     }
+    int i_changed = 0;
     if( p_epg )
-        vlc_epg_Merge( p_epg, p_update );
+        i_changed = vlc_epg_MergeDelta( p_epg, p_update );
 
     vlc_mutex_unlock( &p_item->lock );
 
-    if( !p_epg )
+    /* Nothing to refresh when the update was a redundant table repeat */
+    if( !p_epg || i_changed == 0 )
         return;
 
 #ifdef EPG_DEBUG
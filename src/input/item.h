@@ -30,6 +30,7 @@
 void input_item_SetErrorWhenReading( input_item_t *p_i, bool b_error );
 void input_item_UpdateTracksInfo( input_item_t *item, const es_format_t *fmt );
 bool input_item_ShouldPreparseSubItems( input_item_t *p_i );
+vlc_meta_t *input_item_WritableMeta( input_item_t *p_i );
 
 typedef struct input_item_owner
 {
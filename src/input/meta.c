@@ -34,19 +34,90 @@
 #include <vlc_arrays.h>
 #include <vlc_modules.h>
 #include <vlc_charset.h>
+#include <vlc_atomic.h>
 
 #include "input_internal.h"
 #include "../playlist/art.h"
 
+/* Meta strings are small, written once or twice and read many times, and
+ * all die together with their vlc_meta_t.  They are therefore carved out
+ * of a chain of per-meta arena blocks and freed in bulk by
+ * vlc_meta_Delete(), instead of one strdup()/free() pair per value; a
+ * library import allocates dozens of them per item. */
+#define META_BLOCK_SIZE  2048
+/* Capacities are rounded up so that a value replaced by a slightly longer
+ * one (typically "now playing" updates) can reuse its slot */
+#define META_ALLOC_ALIGN 16
+
+typedef struct meta_block_t
+{
+    struct meta_block_t *p_next;
+    size_t i_size;
+    size_t i_used;
+    char data[];
+} meta_block_t;
+
 struct vlc_meta_t
 {
     char * ppsz_meta[VLC_META_TYPE_COUNT];
 
     vlc_dictionary_t extra_tags;
 
+    meta_block_t *p_blocks;
+
+    atomic_uint refs;
+
     int i_status;
 };
 
+/**
+ * Duplicates a string into the meta arena.
+ *
+ * Each value is preceded by its slot capacity; when psz_old points to the
+ * previous value of the same slot and the new value fits, the slot is
+ * reused in place.  Otherwise the old value is simply abandoned in the
+ * arena until the meta is deleted.
+ */
+static char *vlc_meta_StrDup( vlc_meta_t *m, char *psz_old,
+                              const char *psz_val )
+{
+    size_t i_len = strlen( psz_val ) + 1;
+    uint16_t i_cap;
+
+    assert( !vlc_meta_IsShared( m ) );
+
+    if( psz_old != NULL )
+    {
+        memcpy( &i_cap, psz_old - sizeof (i_cap), sizeof (i_cap) );
+        if( i_len <= i_cap )
+            return memcpy( psz_old, psz_val, i_len );
+    }
+
+    size_t i_slot = (i_len + META_ALLOC_ALIGN - 1) & ~(size_t)(META_ALLOC_ALIGN - 1);
+    size_t i_need = sizeof (i_cap) + i_slot;
+
+    meta_block_t *p_block = m->p_blocks;
+    if( p_block == NULL || p_block->i_size - p_block->i_used < i_need )
+    {
+        size_t i_size = __MAX( i_need, META_BLOCK_SIZE - sizeof (*p_block) );
+
+        p_block = malloc( sizeof (*p_block) + i_size );
+        if( unlikely(p_block == NULL) )
+            return NULL;
+        p_block->i_size = i_size;
+        p_block->i_used = 0;
+        p_block->p_next = m->p_blocks;
+        m->p_blocks = p_block;
+    }
+
+    char *psz_ret = p_block->data + p_block->i_used + sizeof (i_cap);
+    /* Oversize slots store a zero capacity, meaning "never reuse" */
+    i_cap = i_slot <= UINT16_MAX ? i_slot : 0;
+    memcpy( psz_ret - sizeof (i_cap), &i_cap, sizeof (i_cap) );
+    p_block->i_used += i_need;
+    return memcpy( psz_ret, psz_val, i_len );
+}
+
 /* FIXME bad name convention */
 const char * vlc_meta_TypeToLocalizedString( vlc_meta_type_t meta_type )
 {
@@ -96,23 +167,42 @@ vlc_meta_t *vlc_meta_New( void )
         return NULL;
     memset( m->ppsz_meta, 0, sizeof(m->ppsz_meta) );
     m->i_status = 0;
+    m->p_blocks = NULL;
+    atomic_init( &m->refs, 1 );
     vlc_dictionary_init( &m->extra_tags, 0 );
     return m;
 }
 
-/* Free a dictonary key allocated by strdup() in vlc_meta_AddExtra() */
-static void vlc_meta_FreeExtraKey( void *p_data, void *p_obj )
+/**
+ * Adds a reference to the meta.
+ *
+ * A shared meta must be treated as read-only; writers are expected to
+ * replace it with a private copy first (see input_item_WritableMeta()).
+ */
+vlc_meta_t *vlc_meta_Hold( vlc_meta_t *m )
 {
-    VLC_UNUSED( p_obj );
-    free( p_data );
+    atomic_fetch_add( &m->refs, 1 );
+    return m;
+}
+
+bool vlc_meta_IsShared( vlc_meta_t *m )
+{
+    return atomic_load( &m->refs ) > 1;
 }
 
 void vlc_meta_Delete( vlc_meta_t *m )
 {
-    int i;
-    for( i = 0; i < VLC_META_TYPE_COUNT ; i++ )
-        free( m->ppsz_meta[i] );
-    vlc_dictionary_clear( &m->extra_tags, vlc_meta_FreeExtraKey, NULL );
+    if( atomic_fetch_sub( &m->refs, 1 ) != 1 )
+        return;
+
+    /* All values live in the arena; only the blocks need freeing */
+    vlc_dictionary_clear( &m->extra_tags, NULL, NULL );
+    for( meta_block_t *p_block = m->p_blocks; p_block != NULL; )
+    {
+        meta_block_t *p_next = p_block->p_next;
+        free( p_block );
+        p_block = p_next;
+    }
     free( m );
 }
 
@@ -124,9 +214,10 @@ void vlc_meta_Delete( vlc_meta_t *m )
 
 void vlc_meta_Set( vlc_meta_t *p_meta, vlc_meta_type_t meta_type, const char *psz_val )
 {
-    free( p_meta->ppsz_meta[meta_type] );
     assert( psz_val == NULL || IsUTF8( psz_val ) );
-    p_meta->ppsz_meta[meta_type] = psz_val ? strdup( psz_val ) : NULL;
+    p_meta->ppsz_meta[meta_type] = psz_val ?
+        vlc_meta_StrDup( p_meta, p_meta->ppsz_meta[meta_type], psz_val ) :
+        NULL;
 }
 
 const char *vlc_meta_Get( const vlc_meta_t *p_meta, vlc_meta_type_t meta_type )
@@ -137,10 +228,19 @@ const char *vlc_meta_Get( const vlc_meta_t *p_meta, vlc_meta_type_t meta_type )
 void vlc_meta_AddExtra( vlc_meta_t *m, const char *psz_name, const char *psz_value )
 {
     char *psz_oldvalue = (char *)vlc_dictionary_value_for_key( &m->extra_tags, psz_name );
+    char *psz_dup;
     if( psz_oldvalue != kVLCDictionaryNotFound )
+    {
+        psz_dup = vlc_meta_StrDup( m, psz_oldvalue, psz_value );
+        if( psz_dup == psz_oldvalue )
+            return; /* replaced in place */
         vlc_dictionary_remove_value_for_key( &m->extra_tags, psz_name,
-                                            vlc_meta_FreeExtraKey, NULL );
-    vlc_dictionary_insert( &m->extra_tags, psz_name, strdup(psz_value) );
+                                             NULL, NULL );
+    }
+    else
+        psz_dup = vlc_meta_StrDup( m, NULL, psz_value );
+    if( likely(psz_dup != NULL) )
+        vlc_dictionary_insert( &m->extra_tags, psz_name, psz_dup );
 }
 
 const char * vlc_meta_GetExtra( const vlc_meta_t *m, const char *psz_name )
@@ -186,21 +286,16 @@ void vlc_meta_Merge( vlc_meta_t *dst, const vlc_meta_t *src )
     for( i = 0; i < VLC_META_TYPE_COUNT; i++ )
     {
         if( src->ppsz_meta[i] )
-        {
-            free( dst->ppsz_meta[i] );
-            dst->ppsz_meta[i] = strdup( src->ppsz_meta[i] );
-        }
+            dst->ppsz_meta[i] = vlc_meta_StrDup( dst, dst->ppsz_meta[i],
+                                                 src->ppsz_meta[i] );
     }
 
     /* XXX: If speed up are needed, it is possible */
     ppsz_all_keys = vlc_dictionary_all_keys( &src->extra_tags );
     for( i = 0; ppsz_all_keys && ppsz_all_keys[i]; i++ )
     {
-        /* Always try to remove the previous value */
-        vlc_dictionary_remove_value_for_key( &dst->extra_tags, ppsz_all_keys[i], vlc_meta_FreeExtraKey, NULL );
-
         void *p_value = vlc_dictionary_value_for_key( &src->extra_tags, ppsz_all_keys[i] );
-        vlc_dictionary_insert( &dst->extra_tags, ppsz_all_keys[i], strdup( (const char*)p_value ) );
+        vlc_meta_AddExtra( dst, ppsz_all_keys[i], (const char *)p_value );
         free( ppsz_all_keys[i] );
     }
     free( ppsz_all_keys );
@@ -41,8 +41,13 @@ counter_t * stats_CounterCreate( int i_compute_type )
 
     if( !p_counter ) return NULL;
     p_counter->i_compute_type = i_compute_type;
-    p_counter->i_samples = 0;
-    p_counter->pp_samples = NULL;
+    atomic_init( &p_counter->total, 0 );
+    atomic_init( &p_counter->sequence, 0 );
+    for( int i = 0; i < 2; i++ )
+    {
+        p_counter->samples[i].value = 0;
+        p_counter->samples[i].date = 0;
+    }
 
     p_counter->last_update = 0;
 
@@ -51,18 +56,39 @@ counter_t * stats_CounterCreate( int i_compute_type )
 
 static inline int64_t stats_GetTotal(const counter_t *counter)
 {
-    if (counter == NULL || counter->i_samples == 0)
+    if (counter == NULL)
         return 0;
-    return counter->pp_samples[0]->value;
+    return atomic_load_explicit(&counter->total, memory_order_relaxed);
 }
 
-static inline float stats_GetRate(const counter_t *counter)
+static float stats_GetRate(const counter_t *counter)
 {
-    if (counter == NULL || counter->i_samples < 2)
+    if (counter == NULL)
+        return 0.;
+
+    /* Sequence lock: retry whenever a writer published (or is publishing)
+     * a new sample pair while we were reading it */
+    counter_sample_t s0, s1;
+    unsigned seq;
+
+    do
+    {
+        do
+            seq = atomic_load_explicit(&counter->sequence,
+                                       memory_order_acquire);
+        while (seq & 1);
+
+        s0 = counter->samples[0];
+        s1 = counter->samples[1];
+        atomic_thread_fence(memory_order_acquire);
+    }
+    while (atomic_load_explicit(&counter->sequence,
+                                memory_order_relaxed) != seq);
+
+    if (s1.date == 0 || s0.date == s1.date)
         return 0.;
 
-    return (counter->pp_samples[0]->value - counter->pp_samples[1]->value)
-        / (float)(counter->pp_samples[0]->date - counter->pp_samples[1]->date);
+    return (s0.value - s1.value) / (float)(s0.date - s1.date);
 }
 
 input_stats_t *stats_NewInputStats( input_thread_t *p_input )
@@ -83,7 +109,6 @@ void stats_ComputeInputStats(input_thread_t *input, input_stats_t *st)
     if (!libvlc_stats(input))
         return;
 
-    vlc_mutex_lock(&input->p->counters.counters_lock);
     vlc_mutex_lock(&st->lock);
 
     /* Input */
@@ -116,7 +141,6 @@ void stats_ComputeInputStats(input_thread_t *input, input_stats_t *st)
     st->i_lost_pictures = stats_GetTotal(input->p->counters.p_lost_pictures);
 
     vlc_mutex_unlock(&st->lock);
-    vlc_mutex_unlock(&input->p->counters.counters_lock);
 }
 
 void stats_ReinitInputStats( input_stats_t *p_stats )
@@ -137,18 +161,75 @@ void stats_ReinitInputStats( input_stats_t *p_stats )
 
 void stats_CounterClean( counter_t *p_c )
 {
-    if( p_c )
-    {
-        int i = p_c->i_samples - 1 ;
-        while( i >= 0 )
-        {
-            counter_sample_t *p_s = p_c->pp_samples[i];
-            REMOVE_ELEM( p_c->pp_samples, p_c->i_samples, i );
-            free( p_s );
-            i--;
-        }
-        free( p_c );
-    }
+    free( p_c );
+}
+
+/*****************************************************************************
+ * Media allocation accounting
+ *****************************************************************************
+ * Process-wide, per-subsystem counts of the media path allocations (blocks,
+ * pictures, ES format copies). Unlike the input counters above these are not
+ * tied to an input: the point is to spot which subsystem leaks or churns in
+ * a long-lived process without attaching a heap profiler. Updates are relaxed
+ * atomics, and a disabled hook is a single relaxed load.
+ *****************************************************************************/
+
+static atomic_bool alloc_stats_enabled = ATOMIC_VAR_INIT(false);
+
+static struct
+{
+    atomic_ullong allocs;
+    atomic_ullong frees;
+    atomic_ullong live_bytes;
+} alloc_stats[STATS_ALLOC_TAGS];
+
+/** Turns the allocation accounting on (it cannot be turned off again). */
+void stats_AllocEnable( void )
+{
+    atomic_store_explicit( &alloc_stats_enabled, true, memory_order_relaxed );
+}
+
+/** Records an allocation of \p bytes bytes in subsystem \p tag. */
+void stats_AllocAdd( int tag, size_t bytes )
+{
+    if( likely(!atomic_load_explicit( &alloc_stats_enabled,
+                                      memory_order_relaxed )) )
+        return;
+
+    atomic_fetch_add_explicit( &alloc_stats[tag].allocs, 1,
+                               memory_order_relaxed );
+    atomic_fetch_add_explicit( &alloc_stats[tag].live_bytes, bytes,
+                               memory_order_relaxed );
+}
+
+/** Records the release of an allocation of \p bytes bytes.
+ * The byte count must match the one passed to stats_AllocAdd(). */
+void stats_AllocRemove( int tag, size_t bytes )
+{
+    if( likely(!atomic_load_explicit( &alloc_stats_enabled,
+                                      memory_order_relaxed )) )
+        return;
+
+    atomic_fetch_add_explicit( &alloc_stats[tag].frees, 1,
+                               memory_order_relaxed );
+    atomic_fetch_sub_explicit( &alloc_stats[tag].live_bytes, bytes,
+                               memory_order_relaxed );
+}
+
+/** Reads the live counters of subsystem \p tag.
+ * \note allocs minus frees is the number of live objects. For subsystems
+ * without a release hook (ES format copies), frees stays zero and the byte
+ * count is cumulative. The values may be slightly inconsistent with each
+ * other since updates are not sequenced against reads. */
+void stats_AllocGet( int tag, uint64_t *allocs, uint64_t *frees,
+                     uint64_t *live_bytes )
+{
+    *allocs = atomic_load_explicit( &alloc_stats[tag].allocs,
+                                    memory_order_relaxed );
+    *frees = atomic_load_explicit( &alloc_stats[tag].frees,
+                                   memory_order_relaxed );
+    *live_bytes = atomic_load_explicit( &alloc_stats[tag].live_bytes,
+                                        memory_order_relaxed );
 }
 
 
@@ -167,48 +248,39 @@ void stats_Update( counter_t *p_counter, uint64_t val, uint64_t *new_val )
     {
     case STATS_DERIVATIVE:
     {
-        counter_sample_t *p_new, *p_old;
         mtime_t now = mdate();
         if( now - p_counter->last_update < CLOCK_FREQ )
             return;
+
+        /* Claim the sequence lock. Rates are sampled at most once per
+         * second, so losing a sample to a concurrent writer is harmless. */
+        unsigned seq = atomic_load_explicit( &p_counter->sequence,
+                                             memory_order_relaxed );
+        if( ( seq & 1 ) ||
+            !atomic_compare_exchange_strong_explicit( &p_counter->sequence,
+                                                      &seq, seq + 1,
+                                                      memory_order_acquire,
+                                                      memory_order_relaxed ) )
+            return; /* NOTE: Losing sample here */
+
         p_counter->last_update = now;
         /* Insert the new one at the beginning */
-        p_new = (counter_sample_t*)malloc( sizeof( counter_sample_t ) );
-        if (unlikely(p_new == NULL))
-            return; /* NOTE: Losing sample here */
+        p_counter->samples[1] = p_counter->samples[0];
+        p_counter->samples[0].value = val;
+        p_counter->samples[0].date = now;
 
-        p_new->value = val;
-        p_new->date = p_counter->last_update;
-        INSERT_ELEM( p_counter->pp_samples, p_counter->i_samples,
-                     0, p_new );
-
-        if( p_counter->i_samples == 3 )
-        {
-            p_old = p_counter->pp_samples[2];
-            REMOVE_ELEM( p_counter->pp_samples, p_counter->i_samples, 2 );
-            free( p_old );
-        }
+        atomic_store_explicit( &p_counter->sequence, seq + 2,
+                               memory_order_release );
         break;
     }
     case STATS_COUNTER:
-        if( p_counter->i_samples == 0 )
-        {
-            counter_sample_t *p_new = (counter_sample_t*)malloc(
-                                               sizeof( counter_sample_t ) );
-            if (unlikely(p_new == NULL))
-                return; /* NOTE: Losing sample here */
-
-            p_new->value = 0;
-
-            INSERT_ELEM( p_counter->pp_samples, p_counter->i_samples,
-                         p_counter->i_samples, p_new );
-        }
-        if( p_counter->i_samples == 1 )
-        {
-            p_counter->pp_samples[0]->value += val;
-            if( new_val )
-                *new_val = p_counter->pp_samples[0]->value;
-        }
+    {
+        const uint64_t i_total =
+            atomic_fetch_add_explicit( &p_counter->total, val,
+                                       memory_order_relaxed ) + val;
+        if( new_val )
+            *new_val = i_total;
         break;
     }
+    }
 }
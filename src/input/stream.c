@@ -393,6 +393,11 @@ ssize_t stream_Read(stream_t *s, void *buf, size_t len)
                       : ((copy > 0) ? (ssize_t)copy : ret);
 }
 
+/* Initial allocation of the peek buffer. Probing demultiplexers peek the
+ * same head bytes dozens of times per open; starting from a reasonable
+ * window avoids reallocating for each of them. */
+#define STREAM_PEEK_PREALLOC 4096
+
 ssize_t stream_Peek(stream_t *s, const uint8_t **restrict bufp, size_t len)
 {
     stream_priv_t *priv = (stream_priv_t *)s;
@@ -400,11 +405,13 @@ ssize_t stream_Peek(stream_t *s, const uint8_t **restrict bufp, size_t len)
 
     if (peek == NULL)
     {
-        peek = block_Alloc(len);
+        peek = block_Alloc(len > STREAM_PEEK_PREALLOC
+                               ? len : STREAM_PEEK_PREALLOC);
         if (unlikely(peek == NULL))
             return VLC_ENOMEM;
 
         *bufp = peek->p_buffer;
+        peek->i_buffer = 0;
 
         if (unlikely(len == 0))
         {
@@ -428,11 +435,20 @@ ssize_t stream_Peek(stream_t *s, const uint8_t **restrict bufp, size_t len)
     {
         size_t avail = peek->i_buffer;
 
-        peek = block_TryRealloc(peek, 0, len);
-        if (unlikely(peek == NULL))
-            return VLC_ENOMEM;
+        if (len > (size_t)(peek->p_start + peek->i_size - peek->p_buffer))
+        {   /* Grow the allocation geometrically, so that the buffer
+             * address lent out to callers stays put (and earlier windows
+             * stay valid) across most window enlargements. */
+            size_t room = 2 * peek->i_size;
+            if (room < len)
+                room = len;
 
-        priv->peek = peek;
+            peek = block_TryRealloc(peek, 0, room);
+            if (unlikely(peek == NULL))
+                return VLC_ENOMEM;
+
+            priv->peek = peek;
+        }
         peek->i_buffer = avail;
 
         ssize_t ret = stream_ReadRaw(s, peek->p_buffer + avail, len - avail);
@@ -152,7 +152,9 @@ vlm_t *vlm_New ( vlc_object_t *p_this )
     p_vlm->input_state_changed = false;
     p_vlm->i_id = 1;
     TAB_INIT( p_vlm->i_media, p_vlm->media );
+    vlc_dictionary_init( &p_vlm->media_name_index, 0 );
     TAB_INIT( p_vlm->i_schedule, p_vlm->schedule );
+    vlc_dictionary_init( &p_vlm->schedule_name_index, 0 );
     p_vlm->p_vod = NULL;
     var_Create( p_vlm, "intf-event", VLC_VAR_ADDRESS );
 
@@ -217,9 +219,11 @@ void vlm_Delete( vlm_t *p_vlm )
     vlc_mutex_lock( &p_vlm->lock );
     vlm_ControlInternal( p_vlm, VLM_CLEAR_MEDIAS );
     TAB_CLEAN( p_vlm->i_media, p_vlm->media );
+    vlc_dictionary_clear( &p_vlm->media_name_index, NULL, NULL );
 
     vlm_ControlInternal( p_vlm, VLM_CLEAR_SCHEDULES );
     TAB_CLEAN( p_vlm->i_schedule, p_vlm->schedule );
+    vlc_dictionary_clear( &p_vlm->schedule_name_index, NULL, NULL );
     vlc_mutex_unlock( &p_vlm->lock );
 
     vlc_cancel( p_vlm->thread );
@@ -547,41 +551,37 @@ typedef struct
 /* */
 static vlm_media_sys_t *vlm_ControlMediaGetById( vlm_t *p_vlm, int64_t id )
 {
-    int i;
+    /* The media list is sorted by id (see vlm_internal.h) */
+    int i_min = 0, i_max = p_vlm->i_media - 1;
 
-    for( i = 0; i < p_vlm->i_media; i++ )
+    while( i_min <= i_max )
     {
+        int i = i_min + ( i_max - i_min ) / 2;
+
         if( p_vlm->media[i]->cfg.id == id )
             return p_vlm->media[i];
+        if( p_vlm->media[i]->cfg.id < id )
+            i_min = i + 1;
+        else
+            i_max = i - 1;
     }
     return NULL;
 }
 static vlm_media_sys_t *vlm_ControlMediaGetByName( vlm_t *p_vlm, const char *psz_name )
 {
-    int i;
-
-    for( i = 0; i < p_vlm->i_media; i++ )
-    {
-        if( !strcmp( p_vlm->media[i]->cfg.psz_name, psz_name ) )
-            return p_vlm->media[i];
-    }
-    return NULL;
+    return vlc_dictionary_value_for_key( &p_vlm->media_name_index, psz_name );
 }
 static int vlm_MediaDescriptionCheck( vlm_t *p_vlm, vlm_media_t *p_cfg )
 {
-    int i;
+    vlm_media_sys_t *p_media;
 
     if( !p_cfg || !p_cfg->psz_name ||
         !strcmp( p_cfg->psz_name, "all" ) || !strcmp( p_cfg->psz_name, "media" ) || !strcmp( p_cfg->psz_name, "schedule" ) )
         return VLC_EGENERIC;
 
-    for( i = 0; i < p_vlm->i_media; i++ )
-    {
-        if( p_vlm->media[i]->cfg.id == p_cfg->id )
-            continue;
-        if( !strcmp( p_vlm->media[i]->cfg.psz_name, p_cfg->psz_name ) )
-            return VLC_EGENERIC;
-    }
+    p_media = vlm_ControlMediaGetByName( p_vlm, p_cfg->psz_name );
+    if( p_media && p_media->cfg.id != p_cfg->id )
+        return VLC_EGENERIC;
     return VLC_SUCCESS;
 }
 
@@ -737,8 +737,13 @@ static int vlm_ControlMediaChange( vlm_t *p_vlm, vlm_media_t *p_cfg )
         /* TODO check what are the changes being done (stop instance if needed) */
     }
 
+    /* Re-key the name index, the media may be getting renamed */
+    vlc_dictionary_remove_value_for_key( &p_vlm->media_name_index,
+                                         p_media->cfg.psz_name, NULL, NULL );
     vlm_media_Clean( &p_media->cfg );
     vlm_media_Copy( &p_media->cfg, p_cfg );
+    vlc_dictionary_insert( &p_vlm->media_name_index,
+                           p_media->cfg.psz_name, p_media );
 
     return vlm_OnMediaUpdate( p_vlm, p_media );
 }
@@ -785,6 +790,8 @@ static int vlm_ControlMediaAdd( vlm_t *p_vlm, vlm_media_t *p_cfg, int64_t *p_id
 
     /* */
     TAB_APPEND( p_vlm->i_media, p_vlm->media, p_media );
+    vlc_dictionary_insert( &p_vlm->media_name_index,
+                           p_media->cfg.psz_name, p_media );
 
     if( p_id )
         *p_id = p_media->cfg.id;
@@ -813,6 +820,8 @@ static int vlm_ControlMediaDel( vlm_t *p_vlm, int64_t id )
     /* */
     vlm_SendEventMediaRemoved( p_vlm, id, p_media->cfg.psz_name );
 
+    vlc_dictionary_remove_value_for_key( &p_vlm->media_name_index,
+                                         p_media->cfg.psz_name, NULL, NULL );
     vlm_media_Clean( &p_media->cfg );
 
     vlc_gc_decref( p_media->vod.p_item );
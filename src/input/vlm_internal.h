@@ -99,13 +99,18 @@ struct vlm_t
     /* Vod server (used by media) */
     vod_t          *p_vod;
 
-    /* Media list */
+    /* Media list, sorted by id (ids are handed out from the monotonic
+     * counter above, so appends keep it sorted) */
     int                i_media;
     vlm_media_sys_t    **media;
+    /* Name -> vlm_media_sys_t index, kept in sync with the list above */
+    vlc_dictionary_t   media_name_index;
 
     /* Schedule list */
     int            i_schedule;
     vlm_schedule_sys_t **schedule;
+    /* Name -> vlm_schedule_sys_t index, kept in sync with the list above */
+    vlc_dictionary_t   schedule_name_index;
 };
 
 int64_t vlm_Date(void);
@@ -974,6 +974,8 @@ static vlm_schedule_sys_t *vlm_ScheduleNew( vlm_t *vlm, const char *psz_name )
     p_sched->i_repeat = -1;
 
     TAB_APPEND( vlm->i_schedule, vlm->schedule, p_sched );
+    vlc_dictionary_insert( &vlm->schedule_name_index, p_sched->psz_name,
+                           p_sched );
 
     return p_sched;
 }
@@ -985,6 +987,8 @@ void vlm_ScheduleDelete( vlm_t *vlm, vlm_schedule_sys_t *sched )
     if( sched == NULL ) return;
 
     TAB_REMOVE( vlm->i_schedule, vlm->schedule, sched );
+    vlc_dictionary_remove_value_for_key( &vlm->schedule_name_index,
+                                         sched->psz_name, NULL, NULL );
 
     if( vlm->i_schedule == 0 ) free( vlm->schedule );
     free( sched->psz_name );
@@ -997,17 +1001,7 @@ void vlm_ScheduleDelete( vlm_t *vlm, vlm_schedule_sys_t *sched )
 
 static vlm_schedule_sys_t *vlm_ScheduleSearch( vlm_t *vlm, const char *psz_name )
 {
-    int i;
-
-    for( i = 0; i < vlm->i_schedule; i++ )
-    {
-        if( strcmp( psz_name, vlm->schedule[i]->psz_name ) == 0 )
-        {
-            return vlm->schedule[i];
-        }
-    }
-
-    return NULL;
+    return vlc_dictionary_value_for_key( &vlm->schedule_name_index, psz_name );
 }
 
 /* Ok, setup schedule command will be able to support only one (argument value) at a time  */
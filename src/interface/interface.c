@@ -70,6 +70,9 @@ static vlc_mutex_t lock = VLC_STATIC_MUTEX;
  */
 int intf_Create( playlist_t *playlist, const char *chain )
 {
+    /* Interfaces rely on the hotkey tables, bring them up if need be */
+    libvlc_InternalActionsInit( playlist->p_libvlc );
+
     /* Allocate structure */
     intf_thread_t *p_intf = vlc_custom_create( playlist, sizeof( *p_intf ),
                                                "interface" );
@@ -85,6 +85,11 @@ static const char *const ppsz_snap_formats[] =
     "This is the verbosity level (0=only errors and " \
     "standard messages, 1=warnings, 2=debug).")
 
+#define LOG_ASYNC_TEXT N_("Asynchronous logging")
+#define LOG_ASYNC_LONGTEXT N_( \
+    "Queue log messages and write them from a dedicated thread, so that " \
+    "decoding and rendering threads never wait on log output." )
+
 #define OPEN_TEXT N_("Default stream")
 #define OPEN_LONGTEXT N_( \
     "This stream will always be opened at VLC startup." )
@@ -532,6 +537,17 @@ static const int pi_clock_values[] = { -1, 0, 1 };
 static const char *const ppsz_clock_descriptions[] =
 { N_("Default"), N_("Disable"), N_("Enable") };
 
+#define CLOCK_ESTIMATOR_TEXT N_("Clock drift estimator")
+#define CLOCK_ESTIMATOR_LONGTEXT N_( \
+    "Algorithm used to estimate the drift between the stream clock and the " \
+    "system clock. The phase-locked loop rejects network jitter outliers " \
+    "and is recommended for irregular sources (UDP, SRT); its convergence " \
+    "speed follows the clock reference average counter.")
+
+static const int pi_clock_estimator_values[] = { 0, 1 };
+static const char *const ppsz_clock_estimator_descriptions[] =
+{ N_("Moving average"), N_("Phase-locked loop") };
+
 #define MTU_TEXT N_("MTU of the network interface")
 #define MTU_LONGTEXT N_( \
     "This is the maximum application-layer packet size that can be " \
@@ -636,6 +652,18 @@ static const char *const ppsz_prefres[] = {
 #define INPUT_FAST_SEEK_LONGTEXT N_( \
     "Favor speed over precision while seeking" )
 
+#define INPUT_FAST_START_TEXT N_("Fast start")
+#define INPUT_FAST_START_LONGTEXT N_( \
+    "Start decoding as soon as the first elementary stream is found, " \
+    "postponing subtitle and slave detection and metadata reading until " \
+    "after playback has started." )
+
+#define INPUT_WATCHDOG_TEXT N_("Input stall watchdog (seconds)")
+#define INPUT_WATCHDOG_LONGTEXT N_( \
+    "When set, a watchdog thread checks that the input thread makes " \
+    "progress and logs a warning with its state when it stalls for this " \
+    "many seconds, e.g. on a blocking network access. 0 disables it." )
+
 #define INPUT_RATE_TEXT N_("Playback speed")
 #define INPUT_RATE_LONGTEXT N_( \
     "This defines the playback speed (nominal speed is 1.0)." )
@@ -1014,6 +1042,14 @@ static const char *const ppsz_prefres[] = {
     "priorities. You can use it to tune VLC priority against other " \
     "programs, or against other VLC instances.")
 
+#define INPUT_CPU_SET_TEXT N_("CPUs for the input threads")
+#define DECODER_CPU_SET_TEXT N_("CPUs for the decoder threads")
+#define VOUT_CPU_SET_TEXT N_("CPUs for the video output threads")
+#define CPU_SET_LONGTEXT N_( \
+    "Restrict these threads to a list of CPUs, in the same format as " \
+    "taskset (e.g. \"0,2-3\"). This keeps the media pipeline away from " \
+    "cores reserved for other tasks. By default threads run anywhere.")
+
 #define USE_STREAM_IMMEDIATE_LONGTEXT N_( \
      "This option is useful if you want to lower the latency when " \
      "reading a stream")
@@ -1098,6 +1134,11 @@ static const char *const ppsz_prefres[] = {
     "Automatically preparse files added to the playlist " \
     "(to retrieve some metadata)." )
 
+#define PREPARSE_THREADS_TEXT N_( "Preparsing threads" )
+#define PREPARSE_THREADS_LONGTEXT N_( \
+    "Maximum number of threads used to preparse items concurrently " \
+    "(0 means automatic)." )
+
 #define METADATA_NETWORK_TEXT N_( "Allow metadata network access" )
 
 #define SD_TEXT N_( "Services discovery modules")
@@ -1705,6 +1746,13 @@ vlc_module_begin ()
     add_bool( "input-fast-seek", false,
               INPUT_FAST_SEEK_TEXT, INPUT_FAST_SEEK_LONGTEXT, false )
         change_safe ()
+    add_bool( "input-fast-start", false,
+              INPUT_FAST_START_TEXT, INPUT_FAST_START_LONGTEXT, true )
+        change_safe ()
+    add_integer( "input-watchdog", 0,
+                 INPUT_WATCHDOG_TEXT, INPUT_WATCHDOG_LONGTEXT, true )
+        change_integer_range( 0, 3600 )
+        change_safe ()
     add_float( "rate", 1.,
                INPUT_RATE_TEXT, INPUT_RATE_LONGTEXT, false )
 
@@ -1838,6 +1886,10 @@ vlc_module_begin ()
     add_integer( "clock-synchro", -1, CLOCK_SYNCHRO_TEXT,
                  CLOCK_SYNCHRO_LONGTEXT, true )
         change_integer_list( pi_clock_values, ppsz_clock_descriptions )
+    add_integer( "clock-estimator", 0, CLOCK_ESTIMATOR_TEXT,
+                 CLOCK_ESTIMATOR_LONGTEXT, true )
+        change_integer_list( pi_clock_estimator_values,
+                             ppsz_clock_estimator_descriptions )
     add_integer( "clock-jitter", 5 * CLOCK_FREQ/1000, CLOCK_JITTER_TEXT,
               CLOCK_JITTER_LONGTEXT, true )
         change_safe()
@@ -1969,6 +2021,15 @@ vlc_module_begin ()
                  RT_OFFSET_LONGTEXT, true )
 #endif
 
+#ifdef __linux__
+    add_string( "input-cpu-set", NULL, INPUT_CPU_SET_TEXT,
+                CPU_SET_LONGTEXT, true )
+    add_string( "decoder-cpu-set", NULL, DECODER_CPU_SET_TEXT,
+                CPU_SET_LONGTEXT, true )
+    add_string( "vout-cpu-set", NULL, VOUT_CPU_SET_TEXT,
+                CPU_SET_LONGTEXT, true )
+#endif
+
 #if defined(HAVE_DBUS)
     add_bool( "inhibit", 1, INHIBIT_TEXT,
               INHIBIT_LONGTEXT, true )
@@ -2026,6 +2087,9 @@ vlc_module_begin ()
 
     add_bool( "auto-preparse", true, PREPARSE_TEXT,
               PREPARSE_LONGTEXT, false )
+    add_integer( "preparse-threads", 0, PREPARSE_THREADS_TEXT,
+                 PREPARSE_THREADS_LONGTEXT, true )
+        change_integer_range( 0, 32 )
 
     add_obsolete_integer( "album-art" )
     add_bool( "metadata-network-access", false, METADATA_NETWORK_TEXT,
@@ -2042,6 +2106,7 @@ vlc_module_begin ()
                  false )
         change_short('v')
         change_volatile ()
+    add_bool( "log-async", false, LOG_ASYNC_TEXT, LOG_ASYNC_LONGTEXT, true )
     add_obsolete_string( "verbose-objects" ) /* since 2.1.0 */
 #if !defined(_WIN32) && !defined(__OS2__)
     add_bool( "daemon", 0, DAEMON_TEXT, DAEMON_LONGTEXT, true )
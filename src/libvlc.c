@@ -102,8 +102,12 @@ libvlc_int_t * libvlc_InternalCreate( void )
     priv->playlist = NULL;
     priv->p_dialog_provider = NULL;
     priv->p_vlm = NULL;
+    priv->parser = NULL;
+    priv->actions = NULL;
+    vlc_mutex_init( &priv->lazy_lock );
 
     vlc_ExitInit( &priv->exit );
+    var_NotifierInit( p_libvlc );
 
     return p_libvlc;
 }
@@ -124,6 +128,8 @@ int libvlc_InternalInit( libvlc_int_t *p_libvlc, int i_argc,
     char *       psz_parser = NULL;
     char *       psz_control = NULL;
     char        *psz_val;
+    mtime_t      i_start = mdate();
+    mtime_t      i_bank_duration, i_config_duration, i_intf_duration = 0;
 
     /* System specific initialization code */
     system_Init();
@@ -150,6 +156,7 @@ int libvlc_InternalInit( libvlc_int_t *p_libvlc, int i_argc,
      * list of configuration options exported by each module and loads their
      * default values. */
     size_t module_count = module_LoadPlugins (p_libvlc);
+    i_bank_duration = mdate() - i_start;
 
     /*
      * Override default configuration with config file settings
@@ -172,6 +179,7 @@ int libvlc_InternalInit( libvlc_int_t *p_libvlc, int i_argc,
         module_EndBank (true);
         return VLC_EGENERIC;
     }
+    i_config_duration = mdate() - i_start - i_bank_duration;
 
     vlc_LogInit(p_libvlc);
 
@@ -352,16 +360,14 @@ dbus_out:
     vlc_CPU_dump( VLC_OBJECT(p_libvlc) );
 
     priv->b_stats = var_InheritBool( p_libvlc, "stats" );
+    if( priv->b_stats )
+        stats_AllocEnable();
 
-    /*
-     * Initialize hotkey handling
-     */
-    priv->actions = vlc_InitActions( p_libvlc );
-
-    /*
-     * Meta data handling
-     */
-    priv->parser = playlist_preparser_New(VLC_OBJECT(p_libvlc));
+    /* NOTE: Hotkey handling (priv->actions) and meta data handling
+     * (priv->parser) are initialized on first use, so that embedders on
+     * the fast start-up path - thumbnailers, probing tools - never pay
+     * for parsing the key bindings or spawning the preparser threads.
+     * See libvlc_InternalActionsInit() and ParserGet(). */
 
     /* Create a variable for showing the fullscreen interface */
     var_Create( p_libvlc, "intf-toggle-fscontrol", VLC_VAR_BOOL );
@@ -417,6 +423,7 @@ dbus_out:
     /*
      * Load background interfaces
      */
+    i_intf_duration = mdate();
     psz_modules = var_CreateGetNonEmptyString( p_libvlc, "extraintf" );
     psz_control = var_CreateGetNonEmptyString( p_libvlc, "control" );
 
@@ -457,6 +464,7 @@ dbus_out:
 
     if( var_InheritBool( p_libvlc, "network-synchronisation") )
         libvlc_InternalAddIntf( p_libvlc, "netsync,none" );
+    i_intf_duration = mdate() - i_intf_duration;
 
 #ifdef __APPLE__
     var_Create( p_libvlc, "drawable-view-top", VLC_VAR_INTEGER );
@@ -487,6 +495,22 @@ dbus_out:
         free( psz_val );
     }
 
+    /* Startup phase breakdown, kept in variables so that cold-start
+     * tracking tools (and test/vlc-bench-startup) can query it */
+    mtime_t i_total_duration = mdate() - i_start;
+    var_Create( p_libvlc, "startup-time-bank", VLC_VAR_INTEGER );
+    var_SetInteger( p_libvlc, "startup-time-bank", i_bank_duration );
+    var_Create( p_libvlc, "startup-time-config", VLC_VAR_INTEGER );
+    var_SetInteger( p_libvlc, "startup-time-config", i_config_duration );
+    var_Create( p_libvlc, "startup-time-interfaces", VLC_VAR_INTEGER );
+    var_SetInteger( p_libvlc, "startup-time-interfaces", i_intf_duration );
+    var_Create( p_libvlc, "startup-time-total", VLC_VAR_INTEGER );
+    var_SetInteger( p_libvlc, "startup-time-total", i_total_duration );
+    msg_Dbg( p_libvlc, "startup: bank %"PRId64" us, config %"PRId64" us, "
+             "interfaces %"PRId64" us, total %"PRId64" us",
+             i_bank_duration, i_config_duration, i_intf_duration,
+             i_total_duration );
+
     return VLC_SUCCESS;
 }
 
@@ -528,6 +552,28 @@ void libvlc_InternalCleanup( libvlc_int_t *p_libvlc )
 
     vlc_DeinitActions( p_libvlc, priv->actions );
 
+    /* Flush pending deferred variable callbacks and stop the notifier */
+    var_NotifierClean( p_libvlc );
+
+    if( priv->b_stats )
+    {   /* Media allocation accounting: whatever is still live here (minus
+         * the objects owned by the caller) has leaked */
+        static const char names[STATS_ALLOC_TAGS][10] =
+            { "blocks", "pictures", "es copies" };
+
+        for( int i = 0; i < STATS_ALLOC_TAGS; i++ )
+        {
+            uint64_t allocs, frees, bytes;
+
+            stats_AllocGet( i, &allocs, &frees, &bytes );
+            msg_Dbg( p_libvlc, "%s: %"PRIu64" allocated, %"PRIu64" freed, "
+                     "%"PRIu64" bytes live", names[i], allocs, frees, bytes );
+        }
+
+        /* Per-module probe durations and success rates */
+        module_LogProbeStats( p_libvlc );
+    }
+
     /* Save the configuration */
     if( !var_InheritBool( p_libvlc, "ignore-config" ) )
         config_AutoSaveConfigFile( VLC_OBJECT(p_libvlc) );
@@ -551,6 +597,7 @@ void libvlc_InternalDestroy( libvlc_int_t *p_libvlc )
 {
     libvlc_priv_t *priv = libvlc_priv( p_libvlc );
 
+    vlc_mutex_destroy( &priv->lazy_lock );
     vlc_ExitDestroy( &priv->exit );
 
     assert( atomic_load(&(vlc_internals(p_libvlc)->refs)) == 1 );
@@ -596,6 +643,37 @@ static void GetFilenames( libvlc_int_t *p_vlc, unsigned n,
     }
 }
 
+/**
+ * Initializes the hotkey tables if not done yet.
+ * Deferred out of libvlc_InternalInit(): parsing the key bindings is only
+ * needed once something able to emit "key-pressed" events exists.
+ */
+void libvlc_InternalActionsInit( libvlc_int_t *p_libvlc )
+{
+    libvlc_priv_t *priv = libvlc_priv( p_libvlc );
+
+    vlc_mutex_lock( &priv->lazy_lock );
+    if( priv->actions == NULL )
+        priv->actions = vlc_InitActions( p_libvlc );
+    vlc_mutex_unlock( &priv->lazy_lock );
+}
+
+/**
+ * Returns the meta data handler, creating it on first use.
+ */
+static playlist_preparser_t *ParserGet( libvlc_int_t *p_libvlc )
+{
+    libvlc_priv_t *priv = libvlc_priv( p_libvlc );
+    playlist_preparser_t *parser;
+
+    vlc_mutex_lock( &priv->lazy_lock );
+    parser = priv->parser;
+    if( parser == NULL )
+        parser = priv->parser = playlist_preparser_New( VLC_OBJECT(p_libvlc) );
+    vlc_mutex_unlock( &priv->lazy_lock );
+    return parser;
+}
+
 /**
  * Requests extraction of the meta data for an input item (a.k.a. preparsing).
  * The actual extraction is asynchronous.
@@ -603,16 +681,19 @@ static void GetFilenames( libvlc_int_t *p_vlc, unsigned n,
 int libvlc_MetaRequest(libvlc_int_t *libvlc, input_item_t *item,
                        input_item_meta_request_option_t i_options)
 {
-    libvlc_priv_t *priv = libvlc_priv(libvlc);
+    playlist_preparser_t *parser = ParserGet(libvlc);
 
-    if (unlikely(priv->parser == NULL))
+    if (unlikely(parser == NULL))
         return VLC_ENOMEM;
 
     vlc_mutex_lock( &item->lock );
     if( item->i_preparse_depth == 0 )
         item->i_preparse_depth = 1;
     vlc_mutex_unlock( &item->lock );
-    playlist_preparser_Push(priv->parser, item, i_options);
+    /* Explicit requests come from the API, i.e. from items the user is
+     * looking at: jump ahead of the playlist auto-preparse backlog. */
+    playlist_preparser_Push(parser, item,
+                            i_options | META_REQUEST_OPTION_PRIORITY);
     return VLC_SUCCESS;
 }
 
@@ -623,11 +704,11 @@ int libvlc_MetaRequest(libvlc_int_t *libvlc, input_item_t *item,
 int libvlc_ArtRequest(libvlc_int_t *libvlc, input_item_t *item,
                       input_item_meta_request_option_t i_options)
 {
-    libvlc_priv_t *priv = libvlc_priv(libvlc);
+    playlist_preparser_t *parser = ParserGet(libvlc);
 
-    if (unlikely(priv->parser == NULL))
+    if (unlikely(parser == NULL))
         return VLC_ENOMEM;
 
-    playlist_preparser_fetcher_Push(priv->parser, item, i_options);
+    playlist_preparser_fetcher_Push(parser, item, i_options);
     return VLC_SUCCESS;
 }
@@ -25,6 +25,8 @@
 #ifndef LIBVLC_LIBVLC_H
 # define LIBVLC_LIBVLC_H 1
 
+#include <vlc_atomic.h>
+
 extern const char psz_vlc_changeset[];
 
 typedef struct variable_t variable_t;
@@ -34,6 +36,10 @@ struct vlc_actions;
 struct vlc_actions *vlc_InitActions (libvlc_int_t *);
 extern void vlc_DeinitActions (libvlc_int_t *, struct vlc_actions *);
 
+/* Lazy, idempotent hotkey table setup (libvlc.c). Must be called before
+ * anything that can emit "key-pressed" events is created. */
+void libvlc_InternalActionsInit( libvlc_int_t * );
+
 /*
  * OS-specific initialization
  */
@@ -59,6 +65,18 @@ int vlc_set_priority( vlc_thread_t, int );
 
 void vlc_threads_setup (libvlc_int_t *);
 
+/* Names the calling thread after its pipeline role and applies the CPU
+ * affinity configured with the "<role>-cpu-set" variable, if any. */
+void vlc_thread_SetRole (vlc_object_t *obj, const char *role);
+#define vlc_thread_SetRole(o, r) vlc_thread_SetRole (VLC_OBJECT(o), r)
+
+/* Mutex spinning briefly before parking, for hot queues (threads.c) */
+void vlc_mutex_init_adaptive (vlc_mutex_t *);
+
+/* Marks a block FIFO as hot: adaptive locking and spin-then-park waits.
+ * Call right after creation, before the FIFO is shared (fifo.c). */
+void block_FifoHot (block_fifo_t *);
+
 void vlc_trace (const char *fn, const char *file, unsigned line);
 #define vlc_backtrace() vlc_trace(__func__, __FILE__, __LINE__)
 
@@ -138,6 +156,22 @@ module_t *module_find_by_shortcut (const char *psz_shortcut);
 /**
  * Private LibVLC instance data.
  */
+/*
+ * Deferred variable change notifications (variables.c)
+ */
+typedef struct vlc_var_notify_entry vlc_var_notify_entry_t;
+
+typedef struct vlc_var_notifier
+{
+    vlc_mutex_t lock;
+    vlc_cond_t  wait;
+    vlc_thread_t thread;
+    bool        b_active; /* thread running (spawned lazily) */
+    bool        b_exit;
+    vlc_var_notify_entry_t *p_first;
+    vlc_var_notify_entry_t **pp_last;
+} vlc_var_notifier_t;
+
 typedef struct libvlc_priv_t
 {
     libvlc_int_t       public_data;
@@ -151,10 +185,15 @@ typedef struct libvlc_priv_t
     vlc_object_t      *p_dialog_provider; ///< dialog provider
     struct playlist_t *playlist; ///< Playlist for interfaces
     struct playlist_preparser_t *parser; ///< Input item meta data handler
-    struct vlc_actions *actions; ///< Hotkeys handler
+                                         ///  (created on first use)
+    struct vlc_actions *actions; ///< Hotkeys handler (created on first use)
+    vlc_mutex_t lazy_lock; ///< Protects lazy creation of parser and actions
 
     /* Exit callback */
     vlc_exit_t       exit;
+
+    /* Deferred variable callbacks (VLC_VAR_ISDEFERRED) */
+    vlc_var_notifier_t var_notifier;
 } libvlc_priv_t;
 
 static inline libvlc_priv_t *libvlc_priv (libvlc_int_t *libvlc)
@@ -172,6 +211,8 @@ void intf_DestroyAll( libvlc_int_t * );
  * Variables stuff
  */
 void var_OptionParse (vlc_object_t *, const char *, bool trusted);
+void var_NotifierInit (libvlc_int_t *);
+void var_NotifierClean (libvlc_int_t *);
 
 /*
  * Stats stuff
@@ -190,11 +231,17 @@ typedef struct counter_sample_t
 
 typedef struct counter_t
 {
-    int                 i_compute_type;
-    int                 i_samples;
-    counter_sample_t ** pp_samples;
+    int                  i_compute_type;
 
-    mtime_t             last_update;
+    /* STATS_COUNTER: running total. Relaxed atomic so the hot paths
+     * (access, demux, decoders) bump it without taking any lock. */
+    atomic_uint_fast64_t total;
+
+    /* STATS_DERIVATIVE: the last two samples, under a sequence lock
+     * (odd while a writer is updating them). */
+    atomic_uint          sequence;
+    counter_sample_t     samples[2];
+    mtime_t              last_update;
 } counter_t;
 
 enum
@@ -227,4 +274,21 @@ void stats_CounterClean (counter_t * );
 void stats_ComputeInputStats(input_thread_t*, input_stats_t*);
 void stats_ReinitInputStats(input_stats_t *);
 
+/* Process-wide media allocation accounting (off unless --stats is given).
+ * The hooks sit behind block_Alloc(), picture_NewFromResource() and
+ * es_format_Copy() and cost a single relaxed load when disabled. */
+enum
+{
+    STATS_ALLOC_BLOCK,
+    STATS_ALLOC_PICTURE,
+    STATS_ALLOC_ES_FORMAT,
+    STATS_ALLOC_TAGS
+};
+
+void stats_AllocEnable (void);
+void stats_AllocAdd (int tag, size_t bytes);
+void stats_AllocRemove (int tag, size_t bytes);
+void stats_AllocGet (int tag, uint64_t *allocs, uint64_t *frees,
+                     uint64_t *live_bytes);
+
 #endif
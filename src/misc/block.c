@@ -37,6 +37,9 @@
 #include <vlc_common.h>
 #include <vlc_block.h>
 #include <vlc_fs.h>
+#include <vlc_atomic.h>
+
+#include "../libvlc.h"
 
 /**
  * @section Block handling functions.
@@ -98,11 +101,135 @@ void block_Init( block_t *restrict b, void *buf, size_t size )
 #endif
 }
 
+/**
+ * @section Per-thread block recycling cache.
+ *
+ * block_Alloc() rounds allocations up to a small set of power-of-two size
+ * classes and keeps a bounded per-thread stack of freed allocations for each
+ * class. Media pipelines allocate and free packets of nearly identical sizes
+ * at a very high rate; recycling them here keeps decoder and demuxer threads
+ * off the C heap lock and limits fragmentation.
+ */
+
+#define BLOCK_CACHE_SHIFT_MIN   9 /* 512 bytes: smallest recycled class */
+#define BLOCK_CACHE_CLASSES    10 /* ... up to 256 kilobytes */
+#define BLOCK_CACHE_DEPTH       8 /* allocations kept per size class */
+
+struct block_cache_class
+{
+    block_t *stack; /* free allocations, linked through p_next */
+    unsigned depth;
+};
+
+struct block_cache
+{
+    struct block_cache_class classes[BLOCK_CACHE_CLASSES];
+};
+
+static vlc_mutex_t block_cache_lock = VLC_STATIC_MUTEX;
+static vlc_threadvar_t block_cache_key;
+static atomic_bool block_cache_ready = ATOMIC_VAR_INIT(false);
+
+static atomic_ullong block_cache_hits = ATOMIC_VAR_INIT(0);
+static atomic_ullong block_cache_misses = ATOMIC_VAR_INIT(0);
+
+static void block_CacheDestroy (void *data)
+{
+    struct block_cache *cache = data;
+
+    for (unsigned i = 0; i < BLOCK_CACHE_CLASSES; i++)
+        for (block_t *b = cache->classes[i].stack; b != NULL;)
+        {
+            block_t *next = b->p_next;
+
+            free (b);
+            b = next;
+        }
+    free (cache);
+}
+
+static struct block_cache *block_CacheGet (void)
+{
+    if (unlikely(!atomic_load_explicit (&block_cache_ready,
+                                        memory_order_acquire)))
+    {
+        vlc_mutex_lock (&block_cache_lock);
+        if (!atomic_load (&block_cache_ready))
+        {
+            if (vlc_threadvar_create (&block_cache_key, block_CacheDestroy))
+            {
+                vlc_mutex_unlock (&block_cache_lock);
+                return NULL;
+            }
+            atomic_store_explicit (&block_cache_ready, true,
+                                   memory_order_release);
+        }
+        vlc_mutex_unlock (&block_cache_lock);
+    }
+
+    struct block_cache *cache = vlc_threadvar_get (block_cache_key);
+    if (unlikely(cache == NULL))
+    {
+        cache = calloc (1, sizeof (*cache));
+        if (cache != NULL && vlc_threadvar_set (block_cache_key, cache))
+        {
+            free (cache);
+            cache = NULL;
+        }
+    }
+    return cache;
+}
+
+/**
+ * Maps a raw allocation size onto a recycling size class.
+ * @return the class index, or -1 if the size is not recycled
+ */
+static int block_CacheClass (size_t size)
+{
+    for (unsigned i = 0; i < BLOCK_CACHE_CLASSES; i++)
+        if (size <= ((size_t)1 << (BLOCK_CACHE_SHIFT_MIN + i)))
+            return i;
+    return -1;
+}
+
+/**
+ * Reports the cumulated hit and miss counts of the block recycling cache
+ * (process-wide, across all threads).
+ */
+void block_AllocStats (unsigned long long *restrict hits,
+                       unsigned long long *restrict misses)
+{
+    *hits = atomic_load_explicit (&block_cache_hits, memory_order_relaxed);
+    *misses = atomic_load_explicit (&block_cache_misses,
+                                    memory_order_relaxed);
+}
+
 static void block_generic_Release (block_t *block)
 {
     /* That is always true for blocks allocated with block_Alloc(). */
     assert (block->p_start == (unsigned char *)(block + 1));
     block_Invalidate (block);
+
+    /* Recycle allocations whose size exactly matches a size class (i.e.
+     * those made by block_Alloc(); reallocated odd sizes fall through). */
+    size_t alloc = sizeof (*block) + block->i_size;
+
+    /* Recycled blocks count as freed too: this tracks packet churn,
+     * not heap traffic (the cache hit/miss counters cover the latter). */
+    stats_AllocRemove (STATS_ALLOC_BLOCK, alloc);
+    int cls = block_CacheClass (alloc);
+    if (cls >= 0 && alloc == ((size_t)1 << (BLOCK_CACHE_SHIFT_MIN + cls)))
+    {
+        struct block_cache *cache = block_CacheGet ();
+        if (likely(cache != NULL)
+         && cache->classes[cls].depth < BLOCK_CACHE_DEPTH)
+        {
+            block->p_next = cache->classes[cls].stack;
+            cache->classes[cls].stack = block;
+            cache->classes[cls].depth++;
+            return;
+        }
+    }
     free (block);
 }
 
@@ -127,14 +254,37 @@ static void BlockMetaCopy( block_t *restrict out, const block_t *in )
 block_t *block_Alloc (size_t size)
 {
     /* 2 * BLOCK_PADDING: pre + post padding */
-    const size_t alloc = sizeof (block_t) + BLOCK_ALIGN + (2 * BLOCK_PADDING)
-                       + size;
+    size_t alloc = sizeof (block_t) + BLOCK_ALIGN + (2 * BLOCK_PADDING)
+                 + size;
     if (unlikely(alloc <= size))
         return NULL;
 
-    block_t *b = malloc (alloc);
-    if (unlikely(b == NULL))
-        return NULL;
+    block_t *b = NULL;
+    int cls = block_CacheClass (alloc);
+    if (cls >= 0)
+    {
+        /* Round up to the class size so the allocation can be recycled. */
+        alloc = (size_t)1 << (BLOCK_CACHE_SHIFT_MIN + cls);
+
+        struct block_cache *cache = block_CacheGet ();
+        if (likely(cache != NULL) && cache->classes[cls].depth > 0)
+        {
+            b = cache->classes[cls].stack;
+            cache->classes[cls].stack = b->p_next;
+            cache->classes[cls].depth--;
+            atomic_fetch_add_explicit (&block_cache_hits, 1,
+                                       memory_order_relaxed);
+        }
+    }
+
+    if (b == NULL)
+    {
+        b = malloc (alloc);
+        if (unlikely(b == NULL))
+            return NULL;
+        atomic_fetch_add_explicit (&block_cache_misses, 1,
+                                   memory_order_relaxed);
+    }
 
     block_Init (b, b + 1, alloc - sizeof (*b));
     static_assert ((BLOCK_PADDING % BLOCK_ALIGN) == 0,
@@ -143,6 +293,7 @@ block_t *block_Alloc (size_t size)
     b->p_buffer = (void *)(((uintptr_t)b->p_buffer) & ~(BLOCK_ALIGN - 1));
     b->i_buffer = size;
     b->pf_release = block_generic_Release;
+    stats_AllocAdd (STATS_ALLOC_BLOCK, alloc);
     return b;
 }
 
@@ -320,11 +471,65 @@ block_t *block_mmap_Alloc (void *addr, size_t length)
     block->pf_release = block_mmap_Release;
     return block;
 }
+
+/**
+ * Maps a window of an open file into memory as a block.
+ *
+ * This is the zero-copy equivalent of reading the window into a freshly
+ * allocated block: the payload is served directly from the page cache, and
+ * the mapping is released with the block. The kernel is advised that the
+ * window will be read sequentially and that the leading pages will be
+ * needed, so readahead starts before the caller touches the data.
+ *
+ * @param fd file descriptor to map from (must support mmap)
+ * @param offset offset (bytes) of the window within the file; it does not
+ *               need to be page-aligned
+ * @param length length (bytes) of the window
+ * @return a new block spanning exactly the requested window (release it
+ * with block_Release()), or NULL on error (see errno).
+ */
+block_t *block_FileMap (int fd, uint64_t offset, size_t length)
+{
+    const long page_mask = sysconf(_SC_PAGESIZE) - 1;
+    uint64_t base = offset & ~(uint64_t)page_mask;
+    size_t shift = offset - base;
+
+    if (unlikely(length >= SIZE_MAX - shift))
+    {
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    void *addr = mmap (NULL, shift + length, PROT_READ, MAP_PRIVATE, fd,
+                       base);
+    if (addr == MAP_FAILED)
+        return NULL;
+
+#ifdef POSIX_MADV_SEQUENTIAL
+    posix_madvise (addr, shift + length, POSIX_MADV_SEQUENTIAL);
+    posix_madvise (addr, shift + length, POSIX_MADV_WILLNEED);
+#endif
+
+    block_t *block = block_mmap_Alloc (addr, shift + length);
+    if (block == NULL)
+        return NULL;
+
+    block->p_buffer += shift;
+    block->i_buffer -= shift;
+    return block;
+}
 #else
 block_t *block_mmap_Alloc (void *addr, size_t length)
 {
     (void)addr; (void)length; return NULL;
 }
+
+block_t *block_FileMap (int fd, uint64_t offset, size_t length)
+{
+    (void)fd; (void)offset; (void)length;
+    errno = ENOSYS;
+    return NULL;
+}
 #endif
 
 #ifdef HAVE_SYS_SHM_H
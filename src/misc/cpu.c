@@ -277,6 +277,25 @@ unsigned vlc_CPU (void)
 }
 #endif
 
+/**
+ * Resolves a CPU dispatch table.
+ *
+ * Walks the table and returns the first implementation whose required
+ * capability flags are all available on this processor. The table must end
+ * with a fallback entry requiring no flags. The capability word is computed
+ * once at startup, so callers are expected to resolve their tables once
+ * (typically when the module is opened) and call through the returned
+ * pointer afterwards, instead of testing vlc_CPU() in their inner loops.
+ */
+vlc_cpu_fn_t vlc_CPU_resolve (const vlc_cpu_dispatch_t *table)
+{
+    const unsigned caps = vlc_CPU ();
+
+    while ((table->flags & caps) != table->flags)
+        table++;
+    return table->func;
+}
+
 void vlc_CPU_dump (vlc_object_t *obj)
 {
     char buf[200], *p = buf;
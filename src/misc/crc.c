@@ -0,0 +1,93 @@
+/*****************************************************************************
+ * crc.c: CRC checksums
+ *****************************************************************************
+ * Copyright © 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <vlc_common.h>
+#include <vlc_atomic.h>
+#include <vlc_crc.h>
+
+/*
+ * Slicing-by-8 CRC-32: the input is consumed eight bytes per step through
+ * eight derived lookup tables instead of one byte through one, which cuts
+ * the loop-carried dependency chain to a single XOR tree per step. This is
+ * typically 4-5 times faster than the classic byte-at-a-time table loop.
+ *
+ * Note that the SSE4.2 crc32 instruction is of no use here: it hardwires
+ * the Castagnoli polynomial (CRC-32C), not the MPEG-2 one.
+ */
+
+#define CRC32_POLY 0x04c11db7u
+
+static uint32_t crc32_table[8][256];
+static atomic_bool crc32_ready = ATOMIC_VAR_INIT(false);
+static vlc_mutex_t crc32_lock = VLC_STATIC_MUTEX;
+
+static void vlc_crc32_init( void )
+{
+    vlc_mutex_lock( &crc32_lock );
+    if( !atomic_load_explicit( &crc32_ready, memory_order_relaxed ) )
+    {
+        for( uint32_t i = 0; i < 256; i++ )
+        {
+            uint32_t k = i << 24;
+            for( unsigned j = 0; j < 8; j++ )
+                k = (k << 1) ^ ((k & 0x80000000) ? CRC32_POLY : 0);
+            crc32_table[0][i] = k;
+        }
+        for( unsigned t = 1; t < 8; t++ )
+            for( uint32_t i = 0; i < 256; i++ )
+                crc32_table[t][i] = (crc32_table[t - 1][i] << 8)
+                                  ^ crc32_table[0][crc32_table[t - 1][i] >> 24];
+        atomic_store_explicit( &crc32_ready, true, memory_order_release );
+    }
+    vlc_mutex_unlock( &crc32_lock );
+}
+
+uint32_t vlc_crc32( uint32_t i_crc, const void *p_data, size_t i_size )
+{
+    const uint8_t *p = p_data;
+
+    if( unlikely(!atomic_load_explicit( &crc32_ready, memory_order_acquire )) )
+        vlc_crc32_init();
+
+    while( i_size >= 8 )
+    {
+        i_crc ^= ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16)
+               | ((uint32_t)p[2] <<  8) |  (uint32_t)p[3];
+        i_crc = crc32_table[7][ i_crc >> 24        ]
+              ^ crc32_table[6][(i_crc >> 16) & 0xff]
+              ^ crc32_table[5][(i_crc >>  8) & 0xff]
+              ^ crc32_table[4][ i_crc        & 0xff]
+              ^ crc32_table[3][p[4]]
+              ^ crc32_table[2][p[5]]
+              ^ crc32_table[1][p[6]]
+              ^ crc32_table[0][p[7]];
+        p += 8;
+        i_size -= 8;
+    }
+
+    while( i_size-- > 0 )
+        i_crc = (i_crc << 8) ^ crc32_table[0][((i_crc >> 24) ^ *(p++)) & 0xff];
+
+    return i_crc;
+}
@@ -32,6 +32,67 @@
 #include <vlc_common.h>
 #include <vlc_epg.h>
 
+/* EPG events of a given program never overlap, so the table is kept sorted
+ * by start time and searched by dichotomy. A DVB mux repeats its EIT tables
+ * continuously; the common case by far is a merge that changes nothing, and
+ * vlc_epg_MergeDelta() reports that so callers can skip refreshes. */
+
+static void vlc_epg_EventDelete( vlc_epg_event_t *p_evt )
+{
+    free( p_evt->psz_name );
+    free( p_evt->psz_short_description );
+    free( p_evt->psz_description );
+    free( p_evt );
+}
+
+static vlc_epg_event_t *vlc_epg_EventNew( int64_t i_start, int i_duration,
+                                          const char *psz_name,
+                                          const char *psz_short_description,
+                                          const char *psz_description,
+                                          uint8_t i_rating )
+{
+    vlc_epg_event_t *p_evt = malloc( sizeof(*p_evt) );
+    if( !p_evt )
+        return NULL;
+    p_evt->i_start = i_start;
+    p_evt->i_duration = i_duration;
+    p_evt->psz_name = psz_name ? strdup( psz_name ) : NULL;
+    p_evt->psz_short_description = psz_short_description ? strdup( psz_short_description ) : NULL;
+    p_evt->psz_description = psz_description ? strdup( psz_description ) : NULL;
+    p_evt->i_rating = i_rating;
+    return p_evt;
+}
+
+static bool vlc_epg_StrEqual( const char *a, const char *b )
+{
+    return a == b || ( a && b && !strcmp( a, b ) );
+}
+
+static bool vlc_epg_EventEqual( const vlc_epg_event_t *a,
+                                const vlc_epg_event_t *b )
+{
+    return a->i_start == b->i_start && a->i_duration == b->i_duration &&
+           a->i_rating == b->i_rating &&
+           vlc_epg_StrEqual( a->psz_name, b->psz_name ) &&
+           vlc_epg_StrEqual( a->psz_short_description, b->psz_short_description ) &&
+           vlc_epg_StrEqual( a->psz_description, b->psz_description );
+}
+
+/* Returns the index of the first event starting at or after i_start */
+static int vlc_epg_EventLowerBound( const vlc_epg_t *p_epg, int64_t i_start )
+{
+    int lo = 0, hi = p_epg->i_event;
+    while( lo < hi )
+    {
+        int mid = lo + (hi - lo) / 2;
+        if( p_epg->pp_event[mid]->i_start < i_start )
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
 void vlc_epg_Init( vlc_epg_t *p_epg, const char *psz_name )
 {
     p_epg->psz_name = psz_name ? strdup( psz_name ) : NULL;
@@ -43,13 +104,7 @@ void vlc_epg_Clean( vlc_epg_t *p_epg )
 {
     int i;
     for( i = 0; i < p_epg->i_event; i++ )
-    {
-        vlc_epg_event_t *p_evt = p_epg->pp_event[i];
-        free( p_evt->psz_name );
-        free( p_evt->psz_short_description );
-        free( p_evt->psz_description );
-        free( p_evt );
-    }
+        vlc_epg_EventDelete( p_epg->pp_event[i] );
     TAB_CLEAN( p_epg->i_event, p_epg->pp_event );
     free( p_epg->psz_name );
 }
@@ -58,16 +113,22 @@ void vlc_epg_AddEvent( vlc_epg_t *p_epg, int64_t i_start, int i_duration,
                        const char *psz_name, const char *psz_short_description,
                        const char *psz_description, uint8_t i_rating )
 {
-    vlc_epg_event_t *p_evt = malloc( sizeof(*p_evt) );
+    vlc_epg_event_t *p_evt = vlc_epg_EventNew( i_start, i_duration, psz_name,
+                                               psz_short_description,
+                                               psz_description, i_rating );
     if( !p_evt )
         return;
-    p_evt->i_start = i_start;
-    p_evt->i_duration = i_duration;
-    p_evt->psz_name = psz_name ? strdup( psz_name ) : NULL;
-    p_evt->psz_short_description = psz_short_description ? strdup( psz_short_description ) : NULL;
-    p_evt->psz_description = psz_description ? strdup( psz_description ) : NULL;
-    p_evt->i_rating = i_rating;
-    TAB_APPEND( p_epg->i_event, p_epg->pp_event, p_evt );
+
+    int i = vlc_epg_EventLowerBound( p_epg, i_start );
+    if( i < p_epg->i_event && p_epg->pp_event[i]->i_start == i_start )
+    {   /* Same start time: the event was updated, replace it */
+        if( p_epg->p_current == p_epg->pp_event[i] )
+            p_epg->p_current = p_evt;
+        vlc_epg_EventDelete( p_epg->pp_event[i] );
+        p_epg->pp_event[i] = p_evt;
+    }
+    else
+        TAB_INSERT( p_epg->i_event, p_epg->pp_event, p_evt, i );
 }
 
 vlc_epg_t *vlc_epg_New( const char *psz_name )
@@ -86,65 +147,81 @@ void vlc_epg_Delete( vlc_epg_t *p_epg )
 
 void vlc_epg_SetCurrent( vlc_epg_t *p_epg, int64_t i_start )
 {
-    int i;
     p_epg->p_current = NULL;
     if( i_start < 0 )
         return;
 
-    for( i = 0; i < p_epg->i_event; i++ )
-    {
-        if( p_epg->pp_event[i]->i_start == i_start )
-        {
-            p_epg->p_current = p_epg->pp_event[i];
-            break;
-        }
-    }
+    int i = vlc_epg_EventLowerBound( p_epg, i_start );
+    if( i < p_epg->i_event && p_epg->pp_event[i]->i_start == i_start )
+        p_epg->p_current = p_epg->pp_event[i];
 }
 
-void vlc_epg_Merge( vlc_epg_t *p_dst, const vlc_epg_t *p_src )
+int vlc_epg_MergeDelta( vlc_epg_t *p_dst, const vlc_epg_t *p_src )
 {
-    int i;
+    int i_changed = 0;
 
-    /* Add new event */
-    for( i = 0; i < p_src->i_event; i++ )
+    /* Add new and updated events */
+    for( int i = 0; i < p_src->i_event; i++ )
     {
-        vlc_epg_event_t *p_evt = p_src->pp_event[i];
-        bool b_add = true;
-        int j;
+        const vlc_epg_event_t *p_evt = p_src->pp_event[i];
+        int j = vlc_epg_EventLowerBound( p_dst, p_evt->i_start );
 
-        for( j = 0; j < p_dst->i_event; j++ )
+        if( j < p_dst->i_event && p_dst->pp_event[j]->i_start == p_evt->i_start )
         {
-            if( p_dst->pp_event[j]->i_start == p_evt->i_start && p_dst->pp_event[j]->i_duration == p_evt->i_duration )
-            {
-                b_add = false;
-                break;
-            }
-            if( p_dst->pp_event[j]->i_start > p_evt->i_start )
+            vlc_epg_event_t *p_old = p_dst->pp_event[j];
+            if( vlc_epg_EventEqual( p_old, p_evt ) )
+                continue; /* redundant table repeat */
+
+            vlc_epg_event_t *p_copy = vlc_epg_EventNew( p_evt->i_start,
+                            p_evt->i_duration, p_evt->psz_name,
+                            p_evt->psz_short_description, p_evt->psz_description,
+                            p_evt->i_rating );
+            if( !p_copy )
                 break;
+            if( p_dst->p_current == p_old )
+                p_dst->p_current = p_copy;
+            vlc_epg_EventDelete( p_old );
+            p_dst->pp_event[j] = p_copy;
         }
-        if( b_add )
+        else
         {
-            vlc_epg_event_t *p_copy = calloc( 1, sizeof(vlc_epg_event_t) );
+            vlc_epg_event_t *p_copy = vlc_epg_EventNew( p_evt->i_start,
+                            p_evt->i_duration, p_evt->psz_name,
+                            p_evt->psz_short_description, p_evt->psz_description,
+                            p_evt->i_rating );
             if( !p_copy )
                 break;
-            p_copy->i_start = p_evt->i_start;
-            p_copy->i_duration = p_evt->i_duration;
-            p_copy->psz_name = p_evt->psz_name ? strdup( p_evt->psz_name ) : NULL;
-            p_copy->psz_short_description = p_evt->psz_short_description ? strdup( p_evt->psz_short_description ) : NULL;
-            p_copy->psz_description = p_evt->psz_description ? strdup( p_evt->psz_description ) : NULL;
-            p_copy->i_rating = p_evt->i_rating;
             TAB_INSERT( p_dst->i_event, p_dst->pp_event, p_copy, j );
         }
+        i_changed++;
     }
+
     /* Update current */
     if( p_src->p_current )
+    {
+        const vlc_epg_event_t *p_prev = p_dst->p_current;
         vlc_epg_SetCurrent( p_dst, p_src->p_current->i_start );
+        if( p_dst->p_current != p_prev )
+            i_changed++;
+    }
 
     /* Keep only 1 old event  */
     if( p_dst->p_current )
     {
         while( p_dst->i_event > 1 && p_dst->pp_event[0] != p_dst->p_current && p_dst->pp_event[1] != p_dst->p_current )
-            TAB_REMOVE( p_dst->i_event, p_dst->pp_event, p_dst->pp_event[0] );
+        {
+            vlc_epg_event_t *p_old = p_dst->pp_event[0];
+            TAB_REMOVE( p_dst->i_event, p_dst->pp_event, p_old );
+            vlc_epg_EventDelete( p_old );
+            i_changed++;
+        }
     }
+
+    return i_changed;
+}
+
+void vlc_epg_Merge( vlc_epg_t *p_dst, const vlc_epg_t *p_src )
+{
+    vlc_epg_MergeDelta( p_dst, p_src );
 }
 
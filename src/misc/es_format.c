@@ -34,6 +34,8 @@
 #include <vlc_common.h>
 #include <vlc_es.h>
 
+#include "../libvlc.h"
+
 
 /*****************************************************************************
  * BinaryLog: computes the base 2 log of a binary value
@@ -537,6 +539,10 @@ int es_format_Copy(es_format_t *restrict dst, const es_format_t *src)
             ret = VLC_ENOMEM;
         }
     }
+
+    /* Cumulative only (es_format_Clean() cannot tell copies apart from
+     * initialized formats): spots codepaths that churn format copies */
+    stats_AllocAdd(STATS_ALLOC_ES_FORMAT, dst->i_extra);
     return ret;
 }
 
@@ -30,6 +30,7 @@
 
 #include <vlc_common.h>
 #include <vlc_block.h>
+#include <vlc_atomic.h>
 #include "libvlc.h"
 
 /**
@@ -48,8 +49,59 @@ struct block_fifo_t
     block_t             **pp_last;
     size_t              i_depth;
     size_t              i_size;
+
+    bool                b_mpsc;    /**< Created by block_FifoMPSCNew() */
+    bool                b_hot;     /**< Spin-then-park waits (block_FifoHot) */
+    /** LIFO of blocks pushed by producers without holding the lock.
+     * Only used when \ref b_mpsc is true; drained into the regular list
+     * whenever the consumer takes the lock. */
+    atomic_uintptr_t    staged;
+    /** Wake-up counter, so a spinning waiter notices vlc_fifo_Signal()
+     * calls that do not change the queue state (flush/pause requests) */
+    atomic_uint         wakeups;
 };
 
+/** Number of lock/recheck rounds a waiter on a hot FIFO performs before
+ * parking in the condition variable */
+#define FIFO_SPIN_ROUNDS 16
+
+static inline void vlc_fifo_SpinRelax(void)
+{
+#if defined (__i386__) || defined (__x86_64__)
+    __asm__ __volatile__ ("pause");
+#elif defined (__aarch64__)
+    __asm__ __volatile__ ("yield");
+#endif
+}
+
+/**
+ * Moves lock-free staged blocks into the regular queue.
+ *
+ * The staging list is a Treiber-style LIFO, so it must be reversed before
+ * it is appended in order to preserve FIFO ordering.
+ *
+ * The FIFO must be locked by the calling thread.
+ */
+static void vlc_fifo_DrainStagedLocked(block_fifo_t *fifo)
+{
+    block_t *lifo = (block_t *)atomic_exchange_explicit(&fifo->staged,
+                                                        (uintptr_t)NULL,
+                                                        memory_order_acquire);
+    block_t *chain = NULL;
+
+    while (lifo != NULL)
+    {
+        block_t *next = lifo->p_next;
+
+        lifo->p_next = chain;
+        chain = lifo;
+        lifo = next;
+    }
+
+    if (chain != NULL)
+        vlc_fifo_QueueUnlocked(fifo, chain);
+}
+
 /**
  * Locks a block FIFO. No more than one thread can lock the FIFO at any given
  * time, and no other thread can modify the FIFO while it is locked.
@@ -64,6 +116,8 @@ struct block_fifo_t
 void vlc_fifo_Lock(vlc_fifo_t *fifo)
 {
     vlc_mutex_lock(&fifo->lock);
+    if (unlikely(fifo->b_mpsc))
+        vlc_fifo_DrainStagedLocked(fifo);
 }
 
 /**
@@ -88,6 +142,7 @@ void vlc_fifo_Unlock(vlc_fifo_t *fifo)
  */
 void vlc_fifo_Signal(vlc_fifo_t *fifo)
 {
+    atomic_fetch_add_explicit(&fifo->wakeups, 1, memory_order_relaxed);
     vlc_cond_signal(&fifo->wait);
 }
 
@@ -107,7 +162,36 @@ void vlc_fifo_Wait(vlc_fifo_t *fifo)
 
 void vlc_fifo_WaitCond(vlc_fifo_t *fifo, vlc_cond_t *condvar)
 {
+    if (fifo->b_hot)
+    {
+        /* Spin-then-park: at high packet rates the next wake-up is usually
+         * microseconds away, so parking in the kernel costs more than the
+         * wait itself. Poll the queue for a bounded number of rounds and
+         * return spuriously (the caller rechecks its predicate) as soon as
+         * anything happened; only then fall back to the condition variable.
+         * This is not a cancellation point while spinning, which is fine
+         * since the spin phase is bounded. */
+        const size_t depth = fifo->i_depth, size = fifo->i_size;
+        unsigned wakeups = atomic_load_explicit(&fifo->wakeups,
+                                                memory_order_relaxed);
+
+        for (unsigned i = 0; i < FIFO_SPIN_ROUNDS; i++)
+        {
+            vlc_mutex_unlock(&fifo->lock);
+            for (unsigned j = 0; j < 64; j++)
+                vlc_fifo_SpinRelax();
+            vlc_fifo_Lock(fifo); /* also drains the MPSC staging list */
+
+            if (fifo->i_depth != depth || fifo->i_size != size
+             || atomic_load_explicit(&fifo->wakeups,
+                                     memory_order_relaxed) != wakeups)
+                return;
+        }
+    }
+
     vlc_cond_wait(condvar, &fifo->lock);
+    if (unlikely(fifo->b_mpsc))
+        vlc_fifo_DrainStagedLocked(fifo);
 }
 
 /**
@@ -116,7 +200,10 @@ void vlc_fifo_WaitCond(vlc_fifo_t *fifo, vlc_cond_t *condvar)
  */
 int vlc_fifo_TimedWaitCond(vlc_fifo_t *fifo, vlc_cond_t *condvar, mtime_t deadline)
 {
-    return vlc_cond_timedwait(condvar, &fifo->lock, deadline);
+    int val = vlc_cond_timedwait(condvar, &fifo->lock, deadline);
+    if (unlikely(fifo->b_mpsc))
+        vlc_fifo_DrainStagedLocked(fifo);
+    return val;
 }
 
 /**
@@ -215,6 +302,46 @@ block_t *vlc_fifo_DequeueUnlocked(block_fifo_t *fifo)
     return block;
 }
 
+/**
+ * Dequeues up to a given number of blocks from a locked FIFO.
+ *
+ * This is equivalent to calling vlc_fifo_DequeueUnlocked() up to \p max
+ * times, but the whole batch is unlinked within a single lock cycle, so
+ * wake-up and locking overhead is amortized over the batch.
+ *
+ * @note This function is not a cancellation point.
+ *
+ * @warning The FIFO must be locked by the calling thread using
+ * vlc_fifo_Lock(). Otherwise behaviour is undefined.
+ *
+ * @param max maximum number of blocks to dequeue
+ * @return a linked-list of at most \p max blocks (possibly NULL)
+ */
+block_t *vlc_fifo_DequeueBatchUnlocked(block_fifo_t *fifo, size_t max)
+{
+    vlc_assert_locked(&fifo->lock);
+
+    if (max >= fifo->i_depth)
+        return vlc_fifo_DequeueAllUnlocked(fifo);
+
+    block_t *batch = fifo->p_first;
+    block_t *last = NULL;
+
+    for (block_t *block = batch; max > 0; block = block->p_next, max--)
+    {
+        assert(block != NULL);
+        fifo->i_depth--;
+        fifo->i_size -= block->i_buffer;
+        last = block;
+    }
+
+    fifo->p_first = last->p_next;
+    last->p_next = NULL;
+    assert(fifo->p_first != NULL); /* max < depth: blocks are left over */
+
+    return batch;
+}
+
 /**
  * Dequeues the all blocks from a locked FIFO. This is equivalent to calling
  * vlc_fifo_DequeueUnlocked() repeatedly until the FIFO is emptied, but this
@@ -258,16 +385,62 @@ block_fifo_t *block_FifoNew( void )
     p_fifo->p_first = NULL;
     p_fifo->pp_last = &p_fifo->p_first;
     p_fifo->i_depth = p_fifo->i_size = 0;
+    p_fifo->b_mpsc = false;
+    p_fifo->b_hot = false;
+    atomic_init( &p_fifo->staged, (uintptr_t)NULL );
+    atomic_init( &p_fifo->wakeups, 0 );
 
     return p_fifo;
 }
 
+/**
+ * Creates a FIFO queue of blocks with a lock-free enqueue path.
+ *
+ * This is functionally equivalent to block_FifoNew(), except that
+ * block_FifoPut() stages blocks on an atomic list instead of taking the
+ * FIFO lock, and only touches the lock to wake the consumer up when the
+ * staging list was empty. This avoids producer/consumer lock contention
+ * when many small blocks are queued per second, e.g. on the decoder feed
+ * path.
+ *
+ * Any number of threads may call block_FifoPut() concurrently, but there
+ * must be no more than one consumer thread (multiple-producer,
+ * single-consumer discipline).
+ *
+ * @return the FIFO or NULL on memory error
+ */
+block_fifo_t *block_FifoMPSCNew( void )
+{
+    block_fifo_t *p_fifo = block_FifoNew();
+    if( p_fifo != NULL )
+        p_fifo->b_mpsc = true;
+    return p_fifo;
+}
+
+/**
+ * Marks a FIFO as a hot queue: the lock becomes adaptive and waiters spin
+ * briefly before parking in the kernel (see vlc_fifo_WaitCond()). Worth it
+ * only on queues cycled many hundred times per second, e.g. the decoder
+ * input at high frame rates; the spinning is wasted CPU anywhere else.
+ *
+ * This must be called right after creation, before the FIFO is visible to
+ * any other thread.
+ */
+void block_FifoHot( block_fifo_t *p_fifo )
+{
+    vlc_mutex_destroy( &p_fifo->lock );
+    vlc_mutex_init_adaptive( &p_fifo->lock );
+    p_fifo->b_hot = true;
+}
+
 /**
  * Destroys a FIFO created by block_FifoNew().
  * Any queued blocks are also destroyed.
  */
 void block_FifoRelease( block_fifo_t *p_fifo )
 {
+    if( p_fifo->b_mpsc )
+        vlc_fifo_DrainStagedLocked( p_fifo );
     block_ChainRelease( p_fifo->p_first );
     vlc_cond_destroy( &p_fifo->wait );
     vlc_mutex_destroy( &p_fifo->lock );
@@ -294,6 +467,37 @@ void block_FifoEmpty(block_fifo_t *fifo)
  */
 void block_FifoPut(block_fifo_t *fifo, block_t *block)
 {
+    if (fifo->b_mpsc)
+    {
+        block_t *last = block;
+
+        if (block == NULL)
+            return;
+
+        while (last->p_next != NULL)
+            last = last->p_next;
+
+        uintptr_t head = atomic_load_explicit(&fifo->staged,
+                                              memory_order_relaxed);
+        do
+            last->p_next = (block_t *)head;
+        while (!atomic_compare_exchange_weak_explicit(&fifo->staged, &head,
+                                                      (uintptr_t)block,
+                                                      memory_order_release,
+                                                      memory_order_relaxed));
+
+        /* The staging list was empty: the consumer may be waiting. The lock
+         * round-trip is needed to avoid a lost wake-up, but it is amortized
+         * over the whole batch staged since the last drain. */
+        if (head == (uintptr_t)NULL)
+        {
+            vlc_mutex_lock(&fifo->lock);
+            vlc_fifo_Signal(fifo);
+            vlc_mutex_unlock(&fifo->lock);
+        }
+        return;
+    }
+
     vlc_fifo_Lock(fifo);
     vlc_fifo_QueueUnlocked(fifo, block);
     vlc_fifo_Unlock(fifo);
@@ -339,10 +543,10 @@ block_t *block_FifoShow( block_fifo_t *p_fifo )
 {
     block_t *b;
 
-    vlc_mutex_lock( &p_fifo->lock );
+    vlc_fifo_Lock( p_fifo );
     assert(p_fifo->p_first != NULL);
     b = p_fifo->p_first;
-    vlc_mutex_unlock( &p_fifo->lock );
+    vlc_fifo_Unlock( p_fifo );
 
     return b;
 }
@@ -352,9 +556,9 @@ size_t block_FifoSize (block_fifo_t *fifo)
 {
     size_t size;
 
-    vlc_mutex_lock (&fifo->lock);
+    vlc_fifo_Lock (fifo);
     size = fifo->i_size;
-    vlc_mutex_unlock (&fifo->lock);
+    vlc_fifo_Unlock (fifo);
     return size;
 }
 
@@ -363,8 +567,8 @@ size_t block_FifoCount (block_fifo_t *fifo)
 {
     size_t depth;
 
-    vlc_mutex_lock (&fifo->lock);
+    vlc_fifo_Lock (fifo);
     depth = fifo->i_depth;
-    vlc_mutex_unlock (&fifo->lock);
+    vlc_fifo_Unlock (fifo);
     return depth;
 }
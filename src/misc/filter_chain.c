@@ -27,10 +27,14 @@
 
 #include <vlc_filter.h>
 #include <vlc_modules.h>
+#include <vlc_picture_pool.h>
 #include <vlc_spu.h>
 #include <libvlc.h>
 #include <assert.h>
 
+/* Number of pictures pre-allocated per intermediate video filter */
+#define CHAIN_VIDEO_POOL_SIZE 4
+
 typedef struct chained_filter_t
 {
     /* Public part of the filter structure */
@@ -39,6 +43,12 @@ typedef struct chained_filter_t
     struct chained_filter_t *prev, *next;
     vlc_mouse_t *mouse;
     picture_t *pending;
+    /* Picture currently being filtered (only set during pf_video_filter) */
+    picture_t *input;
+    /* Output picture pool for intermediate video filters */
+    picture_pool_t *pool;
+    video_format_t pool_fmt;
+    unsigned pool_misses;
 } chained_filter_t;
 
 /* Only use this with filter objects from _this_ C module */
@@ -108,9 +118,56 @@ filter_chain_t *filter_chain_New( vlc_object_t *obj, const char *cap,
 /** Chained filter picture allocator function */
 static picture_t *filter_chain_VideoBufferNew( filter_t *filter )
 {
-    if( chained(filter)->next != NULL )
+    chained_filter_t *chained_f = chained( filter );
+
+    if( chained_f->next != NULL )
     {
-        picture_t *pic = picture_NewFromFormat( &filter->fmt_out.video );
+        const video_format_t *fmt = &filter->fmt_out.video;
+
+        /* In-place plan: when the filter declared it can work in place,
+         * the formats match and nobody else references the input picture,
+         * hand the input back as output and skip the copy entirely. */
+        if( filter->b_allow_in_place && chained_f->input != NULL &&
+            !picture_IsReferenced( chained_f->input ) &&
+            video_format_IsSimilar( &filter->fmt_in.video, fmt ) )
+            return picture_Hold( chained_f->input );
+
+        /* Intermediate filters draw their output pictures from a pre-sized
+         * pool instead of allocating one per frame. The pool follows the
+         * filter output format. */
+        if( chained_f->pool != NULL &&
+            ( chained_f->pool_fmt.i_chroma  != fmt->i_chroma ||
+              chained_f->pool_fmt.i_width   != fmt->i_width ||
+              chained_f->pool_fmt.i_height  != fmt->i_height ||
+              chained_f->pool_fmt.i_x_offset != fmt->i_x_offset ||
+              chained_f->pool_fmt.i_y_offset != fmt->i_y_offset ||
+              chained_f->pool_fmt.i_visible_width != fmt->i_visible_width ||
+              chained_f->pool_fmt.i_visible_height != fmt->i_visible_height ) )
+        {
+            picture_pool_Release( chained_f->pool );
+            video_format_Clean( &chained_f->pool_fmt );
+            chained_f->pool = NULL;
+        }
+        if( chained_f->pool == NULL )
+        {
+            chained_f->pool = picture_pool_NewFromFormat( fmt,
+                                                      CHAIN_VIDEO_POOL_SIZE );
+            if( chained_f->pool != NULL )
+                video_format_Copy( &chained_f->pool_fmt, fmt );
+        }
+        if( chained_f->pool != NULL )
+        {
+            picture_t *pic = picture_pool_Get( chained_f->pool );
+            if( pic != NULL )
+                return pic;
+            /* Every pool picture is held downstream: this falls back on the
+             * per-frame allocation the pool is meant to avoid. */
+            if( chained_f->pool_misses++ == 0 )
+                msg_Dbg( filter, "output picture pool exhausted, "
+                         "allocating on the frame path" );
+        }
+
+        picture_t *pic = picture_NewFromFormat( fmt );
         if( pic == NULL )
             msg_Err( filter, "Failed to allocate picture" );
         return pic;
@@ -236,6 +293,10 @@ filter_t *filter_chain_AppendFilter( filter_chain_t *chain, const char *name,
         vlc_mouse_Init( mouse );
     chained->mouse = mouse;
     chained->pending = NULL;
+    chained->input = NULL;
+    chained->pool = NULL;
+    video_format_Init( &chained->pool_fmt, 0 );
+    chained->pool_misses = 0;
 
     msg_Dbg( parent, "Filter '%s' (%p) appended to chain",
              (name != NULL) ? name : module_get_name(filter->p_module, false),
@@ -284,6 +345,15 @@ void filter_chain_DeleteFilter( filter_chain_t *chain, filter_t *filter )
     msg_Dbg( obj, "Filter %p removed from chain", (void *)filter );
     FilterDeletePictures( chained->pending );
 
+    if( chained->pool != NULL )
+    {
+        if( chained->pool_misses > 0 )
+            msg_Dbg( obj, "%u pictures were allocated outside the pool "
+                     "of filter %p", chained->pool_misses, (void *)filter );
+        picture_pool_Release( chained->pool );
+        video_format_Clean( &chained->pool_fmt );
+    }
+
     free( chained->mouse );
     es_format_Clean( &filter->fmt_out );
     es_format_Clean( &filter->fmt_in );
@@ -371,7 +441,9 @@ static picture_t *FilterChainVideoFilter( chained_filter_t *f, picture_t *p_pic
     for( ; f != NULL; f = f->next )
     {
         filter_t *p_filter = &f->filter;
+        f->input = p_pic;
         p_pic = p_filter->pf_video_filter( p_filter, p_pic );
+        f->input = NULL;
         if( !p_pic )
             break;
         if( f->pending )
@@ -31,6 +31,7 @@
 #include <vlc_common.h>
 #include <vlc_fourcc.h>
 #include <vlc_es.h>
+#include <vlc_atomic.h>
 #include <assert.h>
 
 #include "fourcc_tables.h"
@@ -643,16 +644,69 @@ static const struct
 #undef PLANAR_8
 #undef PLANAR
 
-const vlc_chroma_description_t *vlc_fourcc_GetChromaDescription( vlc_fourcc_t i_fourcc )
+/* Open-addressing hash index over p_list_chroma_description. The table is
+ * comfortably oversized with regard to the entry count (load factor well
+ * under 50%), so lookups resolve in one, rarely two, probes - one cache
+ * line instead of a scan over the whole description list. It is built once
+ * on first use; the entries themselves are compile-time constants. */
+#define CHROMA_HASH_SIZE 512 /* power of two > 2x number of fourccs */
+
+static struct chroma_hash_entry
+{
+    vlc_fourcc_t fourcc; /* zero for empty slots */
+    const vlc_chroma_description_t *desc;
+} chroma_hash[CHROMA_HASH_SIZE];
+
+static vlc_mutex_t chroma_hash_mutex = VLC_STATIC_MUTEX;
+static atomic_bool chroma_hash_ready = ATOMIC_VAR_INIT(false);
+
+static size_t ChromaHash( vlc_fourcc_t fourcc )
 {
-    for( unsigned i = 0; p_list_chroma_description[i].p_fourcc[0]; i++ )
+    /* Fibonacci hashing: good dispersion for ASCII-ish 32-bit keys */
+    return (fourcc * UINT32_C(0x9E3779B1)) % CHROMA_HASH_SIZE;
+}
+
+static void ChromaHashBuild( void )
+{
+    vlc_mutex_lock( &chroma_hash_mutex );
+    if( !atomic_load( &chroma_hash_ready ) )
     {
-        const vlc_fourcc_t *p_fourcc = p_list_chroma_description[i].p_fourcc;
-        for( unsigned j = 0; j < 4 && p_fourcc[j] != 0; j++ )
+        for( unsigned i = 0; p_list_chroma_description[i].p_fourcc[0]; i++ )
         {
-            if( p_fourcc[j] == i_fourcc )
-                return &p_list_chroma_description[i].description;
+            const vlc_fourcc_t *p_fourcc =
+                p_list_chroma_description[i].p_fourcc;
+
+            for( unsigned j = 0; j < 4 && p_fourcc[j] != 0; j++ )
+            {
+                size_t slot = ChromaHash( p_fourcc[j] );
+
+                while( chroma_hash[slot].fourcc != 0 )
+                {
+                    assert( chroma_hash[slot].fourcc != p_fourcc[j] );
+                    slot = (slot + 1) % CHROMA_HASH_SIZE;
+                }
+                chroma_hash[slot].fourcc = p_fourcc[j];
+                chroma_hash[slot].desc =
+                    &p_list_chroma_description[i].description;
+            }
         }
+        atomic_store_explicit( &chroma_hash_ready, true,
+                               memory_order_release );
     }
+    vlc_mutex_unlock( &chroma_hash_mutex );
+}
+
+const vlc_chroma_description_t *vlc_fourcc_GetChromaDescription( vlc_fourcc_t i_fourcc )
+{
+    if( unlikely(!atomic_load_explicit( &chroma_hash_ready,
+                                        memory_order_acquire )) )
+        ChromaHashBuild();
+
+    for( size_t slot = ChromaHash( i_fourcc );
+         chroma_hash[slot].fourcc != 0;
+         slot = (slot + 1) % CHROMA_HASH_SIZE )
+        if( chroma_hash[slot].fourcc == i_fourcc )
+            return chroma_hash[slot].desc;
+
     return NULL;
 }
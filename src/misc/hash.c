@@ -0,0 +1,168 @@
+/*****************************************************************************
+ * hash.c: fast non-cryptographic hashing (XXH64)
+ *****************************************************************************
+ * Copyright © 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <vlc_common.h>
+#include <vlc_hash.h>
+
+/*
+ * Straight implementation of the XXH64 algorithm
+ * (https://github.com/Cyan4973/xxHash/blob/dev/doc/xxhash_spec.md).
+ * It consumes input in 32-byte stripes over four independent 64-bit lanes,
+ * which runs an order of magnitude faster than MD5 while distributing well
+ * enough for cache keys and dedup.
+ */
+
+#define PRIME64_1 UINT64_C(0x9E3779B185EBCA87)
+#define PRIME64_2 UINT64_C(0xC2B2AE3D27D4EB4F)
+#define PRIME64_3 UINT64_C(0x165667B19E3779F9)
+#define PRIME64_4 UINT64_C(0x85EBCA77C2B2AE63)
+#define PRIME64_5 UINT64_C(0x27D4EB2F165667C5)
+
+static inline uint64_t rotl64( uint64_t v, unsigned bits )
+{
+    return (v << bits) | (v >> (64 - bits));
+}
+
+static inline uint64_t hash64_round( uint64_t acc, uint64_t input )
+{
+    acc += input * PRIME64_2;
+    acc = rotl64( acc, 31 );
+    return acc * PRIME64_1;
+}
+
+static inline uint64_t hash64_merge_round( uint64_t acc, uint64_t val )
+{
+    acc ^= hash64_round( 0, val );
+    return acc * PRIME64_1 + PRIME64_4;
+}
+
+/** Consumes one aligned-in-buffer 32-byte stripe */
+static inline void hash64_stripe( uint64_t v[4], const uint8_t *p )
+{
+    v[0] = hash64_round( v[0], GetQWLE( p ) );
+    v[1] = hash64_round( v[1], GetQWLE( p + 8 ) );
+    v[2] = hash64_round( v[2], GetQWLE( p + 16 ) );
+    v[3] = hash64_round( v[3], GetQWLE( p + 24 ) );
+}
+
+void vlc_hash64_Init( struct vlc_hash64_s *h, uint64_t i_seed )
+{
+    h->v[0] = i_seed + PRIME64_1 + PRIME64_2;
+    h->v[1] = i_seed + PRIME64_2;
+    h->v[2] = i_seed;
+    h->v[3] = i_seed - PRIME64_1;
+    h->total = 0;
+    h->count = 0;
+}
+
+void vlc_hash64_Add( struct vlc_hash64_s *h, const void *p_data, size_t i_size )
+{
+    const uint8_t *p = p_data;
+
+    h->total += i_size;
+
+    if( h->count > 0 )
+    {   /* Complete the pending stripe first */
+        size_t i_fill = sizeof (h->buf) - h->count;
+        if( i_fill > i_size )
+            i_fill = i_size;
+        memcpy( h->buf + h->count, p, i_fill );
+        h->count += i_fill;
+        p += i_fill;
+        i_size -= i_fill;
+
+        if( h->count < sizeof (h->buf) )
+            return;
+        hash64_stripe( h->v, h->buf );
+        h->count = 0;
+    }
+
+    while( i_size >= sizeof (h->buf) )
+    {
+        hash64_stripe( h->v, p );
+        p += sizeof (h->buf);
+        i_size -= sizeof (h->buf);
+    }
+
+    memcpy( h->buf, p, i_size );
+    h->count = i_size;
+}
+
+uint64_t vlc_hash64_Finish( struct vlc_hash64_s *h )
+{
+    uint64_t acc;
+
+    if( h->total >= sizeof (h->buf) )
+    {
+        acc = rotl64( h->v[0], 1 ) + rotl64( h->v[1], 7 )
+            + rotl64( h->v[2], 12 ) + rotl64( h->v[3], 18 );
+        acc = hash64_merge_round( acc, h->v[0] );
+        acc = hash64_merge_round( acc, h->v[1] );
+        acc = hash64_merge_round( acc, h->v[2] );
+        acc = hash64_merge_round( acc, h->v[3] );
+    }
+    else /* no complete stripe was ever consumed */
+        acc = h->v[2] + PRIME64_5;
+
+    acc += h->total;
+
+    const uint8_t *p = h->buf;
+    size_t left = h->count;
+
+    while( left >= 8 )
+    {
+        acc ^= hash64_round( 0, GetQWLE( p ) );
+        acc = rotl64( acc, 27 ) * PRIME64_1 + PRIME64_4;
+        p += 8;
+        left -= 8;
+    }
+    if( left >= 4 )
+    {
+        acc ^= (uint64_t)GetDWLE( p ) * PRIME64_1;
+        acc = rotl64( acc, 23 ) * PRIME64_2 + PRIME64_3;
+        p += 4;
+        left -= 4;
+    }
+    while( left-- > 0 )
+    {
+        acc ^= *(p++) * PRIME64_5;
+        acc = rotl64( acc, 11 ) * PRIME64_1;
+    }
+
+    acc ^= acc >> 33;
+    acc *= PRIME64_2;
+    acc ^= acc >> 29;
+    acc *= PRIME64_3;
+    acc ^= acc >> 32;
+    return acc;
+}
+
+uint64_t vlc_hash64( const void *p_data, size_t i_size )
+{
+    struct vlc_hash64_s h;
+
+    vlc_hash64_Init( &h, 0 );
+    vlc_hash64_Add( &h, p_data, i_size );
+    return vlc_hash64_Finish( &h );
+}
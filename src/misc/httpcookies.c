@@ -45,10 +45,14 @@ typedef struct http_cookie_t
     bool b_secure;
 } http_cookie_t;
 
+/* Cookies are bucketed by their (lowercased) domain so that a request only
+ * has to look at the buckets for the host and its parent domains, not at the
+ * whole jar. Fetching is far more frequent than storing (every segment of an
+ * HLS stream sends the jar), hence the read/write lock. */
 struct vlc_http_cookie_jar_t
 {
-    vlc_array_t cookies;
-    vlc_mutex_t lock;
+    vlc_dictionary_t domains; /* domain -> vlc_array_t of http_cookie_t */
+    vlc_rwlock_t lock;
 };
 
 static http_cookie_t * cookie_parse( const char *, const char *, const char * );
@@ -64,14 +68,37 @@ static bool cookie_path_matches( const http_cookie_t * cookie, const char *path
 static bool cookie_domain_is_public_suffix( const char *domain );
 static char * cookie_default_path( const char *request_path );
 
+/* Dictionary keys are compared byte-wise but cookie domains are
+ * case-insensitive: normalize them to lower case */
+static char * cookie_domain_key( const char *psz_domain )
+{
+    char *psz_key = strdup( psz_domain );
+    if ( psz_key )
+        for( char *p = psz_key; *p; p++ )
+            if ( *p >= 'A' && *p <= 'Z' )
+                *p += 'a' - 'A';
+    return psz_key;
+}
+
+static void cookie_bucket_destroy( void *p_data, void *p_obj )
+{
+    vlc_array_t *p_bucket = p_data;
+    (void) p_obj;
+
+    for( int i = 0; i < vlc_array_count( p_bucket ); i++ )
+        cookie_destroy( vlc_array_item_at_index( p_bucket, i ) );
+    vlc_array_clear( p_bucket );
+    free( p_bucket );
+}
+
 vlc_http_cookie_jar_t * vlc_http_cookies_new()
 {
     vlc_http_cookie_jar_t * jar = malloc( sizeof( vlc_http_cookie_jar_t ) );
     if ( !jar )
         return NULL;
 
-    vlc_array_init( &jar->cookies );
-    vlc_mutex_init( &jar->lock );
+    vlc_dictionary_init( &jar->domains, 0 );
+    vlc_rwlock_init( &jar->lock );
 
     return jar;
 }
@@ -81,12 +108,8 @@ void vlc_http_cookies_destroy( vlc_http_cookie_jar_t * p_jar )
     if ( !p_jar )
         return;
 
-    int i;
-    for( i = 0; i < vlc_array_count( &p_jar->cookies ); i++ )
-        cookie_destroy( vlc_array_item_at_index( &p_jar->cookies, i ) );
-
-    vlc_array_clear( &p_jar->cookies );
-    vlc_mutex_destroy( &p_jar->lock );
+    vlc_dictionary_clear( &p_jar->domains, cookie_bucket_destroy, NULL );
+    vlc_rwlock_destroy( &p_jar->lock );
 
     free( p_jar );
 }
@@ -97,8 +120,6 @@ bool vlc_http_cookies_store(vlc_http_cookie_jar_t *p_jar, const char *cookies,
     assert(host != NULL);
     assert(path != NULL);
 
-    int i;
-
     http_cookie_t *cookie = cookie_parse(cookies, host, path);
     if (cookie == NULL)
         return false;
@@ -108,31 +129,54 @@ bool vlc_http_cookies_store(vlc_http_cookie_jar_t *p_jar, const char *cookies,
         return false;
     }
 
-    vlc_mutex_lock( &p_jar->lock );
+    char *key = cookie_domain_key(cookie->psz_domain);
+    if (key == NULL)
+    {
+        cookie_destroy(cookie);
+        return false;
+    }
 
-    for( i = 0; i < vlc_array_count( &p_jar->cookies ); i++ )
+    vlc_rwlock_wrlock( &p_jar->lock );
+
+    vlc_array_t *bucket = vlc_dictionary_value_for_key( &p_jar->domains, key );
+    if( bucket == NULL )
+    {
+        bucket = malloc( sizeof( *bucket ) );
+        if( unlikely(bucket == NULL) )
+        {
+            vlc_rwlock_unlock( &p_jar->lock );
+            free( key );
+            cookie_destroy( cookie );
+            return false;
+        }
+        vlc_array_init( bucket );
+        vlc_dictionary_insert( &p_jar->domains, key, bucket );
+    }
+
+    /* A cookie can only shadow another one of the same domain, so the
+     * duplicate check stays within this bucket */
+    for( int i = 0; i < vlc_array_count( bucket ); i++ )
     {
-        http_cookie_t *iter = vlc_array_item_at_index( &p_jar->cookies, i );
+        http_cookie_t *iter = vlc_array_item_at_index( bucket, i );
 
         assert( iter->psz_name );
         assert( iter->psz_domain );
         assert( iter->psz_path );
 
-        bool domains_match =
-            vlc_ascii_strcasecmp( cookie->psz_domain, iter->psz_domain ) == 0;
         bool paths_match = strcmp( cookie->psz_path, iter->psz_path ) == 0;
         bool names_match = strcmp( cookie->psz_name, iter->psz_name ) == 0;
-        if( domains_match && paths_match && names_match )
+        if( paths_match && names_match )
         {
             /* Remove previous value for this cookie */
-            vlc_array_remove( &p_jar->cookies, i );
+            vlc_array_remove( bucket, i );
             cookie_destroy(iter);
             break;
         }
     }
-    vlc_array_append( &p_jar->cookies, cookie );
+    vlc_array_append( bucket, cookie );
 
-    vlc_mutex_unlock( &p_jar->lock );
+    vlc_rwlock_unlock( &p_jar->lock );
+    free( key );
 
     return true;
 }
@@ -157,34 +201,55 @@ bool vlc_http_cookies_append(vlc_http_cookie_jar_t *jar,
 char *vlc_http_cookies_fetch(vlc_http_cookie_jar_t *p_jar, bool secure,
                              const char *host, const char *path)
 {
-    int i;
     char *psz_cookiebuf = NULL;
 
-    vlc_mutex_lock( &p_jar->lock );
+    if( host == NULL )
+        return NULL;
+
+    char *key = cookie_domain_key( host );
+    if( key == NULL )
+        return NULL;
 
-    for( i = 0; i < vlc_array_count( &p_jar->cookies ); i++ )
+    vlc_rwlock_rdlock( &p_jar->lock );
+
+    /* Only cookies whose domain is the host or one of its parent domains
+     * can match: probe each label suffix instead of scanning the jar.
+     * cookie_should_be_sent() still applies the full matching rules
+     * (host-only flag, secure flag, paths, IP literals). */
+    for( const char *domain = key; domain != NULL; )
     {
-        const http_cookie_t * cookie = vlc_array_item_at_index( &p_jar->cookies, i );
-        if (cookie_should_be_sent(cookie, secure, host, path))
+        vlc_array_t *bucket =
+            vlc_dictionary_value_for_key( &p_jar->domains, domain );
+
+        for( int i = 0; bucket != NULL && i < vlc_array_count( bucket ); i++ )
         {
-            char *psz_updated_buf = NULL;
-            if ( asprintf(&psz_updated_buf, "%s%s%s=%s",
-                          psz_cookiebuf ? psz_cookiebuf : "",
-                          psz_cookiebuf ? "; " : "",
-                          cookie->psz_name ? cookie->psz_name : "",
-                          cookie->psz_value ? cookie->psz_value : "") == -1 )
+            const http_cookie_t * cookie = vlc_array_item_at_index( bucket, i );
+            if (cookie_should_be_sent(cookie, secure, host, path))
             {
-                // TODO: report error
+                char *psz_updated_buf = NULL;
+                if ( asprintf(&psz_updated_buf, "%s%s%s=%s",
+                              psz_cookiebuf ? psz_cookiebuf : "",
+                              psz_cookiebuf ? "; " : "",
+                              cookie->psz_name ? cookie->psz_name : "",
+                              cookie->psz_value ? cookie->psz_value : "") == -1 )
+                {
+                    // TODO: report error
+                    free( psz_cookiebuf );
+                    vlc_rwlock_unlock( &p_jar->lock );
+                    free( key );
+                    return NULL;
+                }
                 free( psz_cookiebuf );
-                vlc_mutex_unlock( &p_jar->lock );
-                return NULL;
+                psz_cookiebuf = psz_updated_buf;
             }
-            free( psz_cookiebuf );
-            psz_cookiebuf = psz_updated_buf;
         }
+
+        const char *dot = strchr( domain, '.' );
+        domain = ( dot != NULL && dot[1] != '\0' ) ? dot + 1 : NULL;
     }
 
-    vlc_mutex_unlock( &p_jar->lock );
+    vlc_rwlock_unlock( &p_jar->lock );
+    free( key );
 
     return psz_cookiebuf;
 }
@@ -36,6 +36,7 @@
 
 #include <errno.h>
 #include <limits.h>
+#include <sys/stat.h>
 
 #include <vlc_common.h>
 #include <vlc_codec.h>
@@ -45,6 +46,7 @@
 #include <vlc_image.h>
 #include <vlc_stream.h>
 #include <vlc_fs.h>
+#include <vlc_url.h>
 #include <vlc_sout.h>
 #include <libvlc.h>
 #include <vlc_modules.h>
@@ -74,6 +76,182 @@ vlc_fourcc_t image_Type2Fourcc( const char * );
 vlc_fourcc_t image_Ext2Fourcc( const char * );
 /*static const char *Fourcc2Ext( vlc_fourcc_t );*/
 
+/*****************************************************************************
+ * Decoded picture cache
+ *****************************************************************************
+ * The same artwork is decoded over and over by independent consumers
+ * (fetcher, interfaces, OSD), each with its own image handler. Keep the
+ * most recently used decoded pictures, keyed by URL, file modification
+ * time and requested output format, shared by the whole process.
+ *****************************************************************************/
+
+/* Byte budget for cached decoded pictures */
+#define IMAGE_CACHE_BYTES (1 << 24)
+
+typedef struct image_cache_entry_t
+{
+    struct image_cache_entry_t *p_next;
+
+    char           *psz_url;
+    uint64_t        i_mtime;      /* 0 when the URL is not a local file */
+    video_format_t  fmt_request;  /* target format asked by the caller */
+
+    video_format_t  fmt;          /* format of the decoded picture */
+    picture_t      *p_pic;
+    size_t          i_bytes;
+} image_cache_entry_t;
+
+static struct
+{
+    vlc_mutex_t lock;
+    image_cache_entry_t *p_first; /* most recently used first */
+    size_t i_bytes;
+} image_cache = { VLC_STATIC_MUTEX, NULL, 0 };
+
+static size_t ImageCachePictureBytes( const picture_t *p_pic )
+{
+    size_t i_bytes = 0;
+
+    for( int i = 0; i < p_pic->i_planes; i++ )
+        i_bytes += p_pic->p[i].i_pitch * p_pic->p[i].i_lines;
+    return i_bytes;
+}
+
+static uint64_t ImageCacheMtime( const char *psz_url )
+{
+    char *psz_path = vlc_uri2path( psz_url );
+    struct stat st;
+    uint64_t i_mtime = 0;
+
+    if( psz_path != NULL )
+    {
+        if( !vlc_stat( psz_path, &st ) )
+            i_mtime = (uint64_t)st.st_mtime;
+        free( psz_path );
+    }
+    return i_mtime;
+}
+
+static bool ImageCacheMatch( const image_cache_entry_t *p_entry,
+                             const char *psz_url, uint64_t i_mtime,
+                             const video_format_t *p_fmt )
+{
+    return !strcmp( p_entry->psz_url, psz_url ) &&
+           p_entry->i_mtime == i_mtime &&
+           p_entry->fmt_request.i_chroma == p_fmt->i_chroma &&
+           p_entry->fmt_request.i_width  == p_fmt->i_width &&
+           p_entry->fmt_request.i_height == p_fmt->i_height;
+}
+
+static void ImageCacheEntryDelete( image_cache_entry_t *p_entry )
+{
+    picture_Release( p_entry->p_pic );
+    video_format_Clean( &p_entry->fmt_request );
+    video_format_Clean( &p_entry->fmt );
+    free( p_entry->psz_url );
+    free( p_entry );
+}
+
+static picture_t *ImageCacheGet( const char *psz_url, uint64_t i_mtime,
+                                 const video_format_t *p_fmt_req,
+                                 video_format_t *p_fmt_out )
+{
+    picture_t *p_pic = NULL;
+
+    vlc_mutex_lock( &image_cache.lock );
+    for( image_cache_entry_t **pp = &image_cache.p_first; *pp != NULL;
+         pp = &(*pp)->p_next )
+    {
+        image_cache_entry_t *p_entry = *pp;
+
+        if( !ImageCacheMatch( p_entry, psz_url, i_mtime, p_fmt_req ) )
+            continue;
+
+        /* The consumers own (and may write to) the returned picture,
+         * so hand out a copy of the cached one */
+        p_pic = picture_NewFromFormat( &p_entry->fmt );
+        if( p_pic != NULL )
+        {
+            picture_Copy( p_pic, p_entry->p_pic );
+            video_format_Clean( p_fmt_out );
+            video_format_Copy( p_fmt_out, &p_entry->fmt );
+        }
+
+        /* Move to the front of the LRU list */
+        *pp = p_entry->p_next;
+        p_entry->p_next = image_cache.p_first;
+        image_cache.p_first = p_entry;
+        break;
+    }
+    vlc_mutex_unlock( &image_cache.lock );
+
+    return p_pic;
+}
+
+static void ImageCachePut( const char *psz_url, uint64_t i_mtime,
+                           const video_format_t *p_fmt_req,
+                           const video_format_t *p_fmt,
+                           picture_t *p_pic )
+{
+    const size_t i_bytes = ImageCachePictureBytes( p_pic );
+
+    if( i_bytes > IMAGE_CACHE_BYTES )
+        return;
+
+    image_cache_entry_t *p_entry = malloc( sizeof(*p_entry) );
+    if( p_entry == NULL )
+        return;
+
+    p_entry->psz_url = strdup( psz_url );
+    if( p_entry->psz_url == NULL )
+    {
+        free( p_entry );
+        return;
+    }
+    p_entry->i_mtime = i_mtime;
+    video_format_Copy( &p_entry->fmt_request, p_fmt_req );
+    video_format_Copy( &p_entry->fmt, p_fmt );
+    p_entry->p_pic = picture_Hold( p_pic );
+    p_entry->i_bytes = i_bytes;
+
+    vlc_mutex_lock( &image_cache.lock );
+
+    /* Drop an entry decoded by a concurrent reader for the same key */
+    for( image_cache_entry_t **pp = &image_cache.p_first; *pp != NULL;
+         pp = &(*pp)->p_next )
+    {
+        image_cache_entry_t *p_old = *pp;
+
+        if( ImageCacheMatch( p_old, psz_url, i_mtime, p_fmt_req ) )
+        {
+            *pp = p_old->p_next;
+            image_cache.i_bytes -= p_old->i_bytes;
+            ImageCacheEntryDelete( p_old );
+            break;
+        }
+    }
+
+    /* Evict the least recently used entries to fit the budget */
+    while( image_cache.p_first != NULL &&
+           image_cache.i_bytes + i_bytes > IMAGE_CACHE_BYTES )
+    {
+        image_cache_entry_t **pp = &image_cache.p_first;
+
+        while( (*pp)->p_next != NULL )
+            pp = &(*pp)->p_next;
+
+        image_cache.i_bytes -= (*pp)->i_bytes;
+        ImageCacheEntryDelete( *pp );
+        *pp = NULL;
+    }
+
+    p_entry->p_next = image_cache.p_first;
+    image_cache.p_first = p_entry;
+    image_cache.i_bytes += i_bytes;
+
+    vlc_mutex_unlock( &image_cache.lock );
+}
+
 #undef image_HandlerCreate
 /**
  * Create an image_handler_t instance
@@ -231,6 +409,18 @@ static picture_t *ImageReadUrl( image_handler_t *p_image, const char *psz_url,
     stream_t *p_stream = NULL;
     uint64_t i_size;
 
+    /* A decoded copy may be cached already */
+    const uint64_t i_mtime = ImageCacheMtime( psz_url );
+    video_format_t fmt_request;
+
+    video_format_Copy( &fmt_request, p_fmt_out );
+    p_pic = ImageCacheGet( psz_url, i_mtime, &fmt_request, p_fmt_out );
+    if( p_pic != NULL )
+    {
+        video_format_Clean( &fmt_request );
+        return p_pic;
+    }
+
     p_stream = stream_UrlNew( p_image->p_parent, psz_url );
 
     if( !p_stream )
@@ -269,9 +459,14 @@ static picture_t *ImageReadUrl( image_handler_t *p_image, const char *psz_url,
 
     p_pic = ImageRead( p_image, p_block, p_fmt_in, p_fmt_out );
 
+    if( p_pic != NULL )
+        ImageCachePut( psz_url, i_mtime, &fmt_request, p_fmt_out, p_pic );
+    video_format_Clean( &fmt_request );
+
     return p_pic;
 error:
     stream_Delete( p_stream );
+    video_format_Clean( &fmt_request );
     return NULL;
 }
 
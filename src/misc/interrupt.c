@@ -72,13 +72,13 @@ void vlc_interrupt_init(vlc_interrupt_t *ctx)
 #endif
     vlc_rwlock_unlock(&vlc_interrupt_lock);
 
-    vlc_mutex_init(&ctx->lock);
-    ctx->interrupted = false;
+    atomic_init(&ctx->interrupted, false);
     atomic_init(&ctx->killed, false);
+    atomic_init(&ctx->busy, false);
 #ifndef NDEBUG
     ctx->attached = false;
 #endif
-    ctx->callback = NULL;
+    atomic_init(&ctx->callback, (uintptr_t)NULL);
 }
 
 vlc_interrupt_t *vlc_interrupt_create(void)
@@ -95,9 +95,8 @@ vlc_interrupt_t *vlc_interrupt_create(void)
  */
 void vlc_interrupt_deinit(vlc_interrupt_t *ctx)
 {
-    assert(ctx->callback == NULL);
+    assert(atomic_load(&ctx->callback) == (uintptr_t)NULL);
     assert(!ctx->attached);
-    vlc_mutex_destroy(&ctx->lock);
 
     vlc_rwlock_wrlock(&vlc_interrupt_lock);
     assert(vlc_interrupt_refs > 0);
@@ -113,19 +112,39 @@ void vlc_interrupt_destroy(vlc_interrupt_t *ctx)
     free(ctx);
 }
 
+/**
+ * Serializes callback invocations for a context. Raising an interruption is
+ * rare, so waiting here is too; the point of the busy flag over a mutex is
+ * that the registration fast path never takes it at all.
+ */
+static void vlc_interrupt_cb_lock(vlc_interrupt_t *ctx)
+{
+    while (atomic_exchange(&ctx->busy, true))
+        /* Another thread is invoking the callback. Callbacks only post a
+         * semaphore or write to a pipe, so this resolves promptly. */;
+}
+
+static void vlc_interrupt_cb_unlock(vlc_interrupt_t *ctx)
+{
+    atomic_store(&ctx->busy, false);
+}
+
 void vlc_interrupt_raise(vlc_interrupt_t *ctx)
 {
     assert(ctx != NULL);
 
     /* This function must be reentrant. But the callback typically is not
-     * reentrant. The lock ensures that all calls to the callback for a given
-     * context are serialized. The lock also protects against invalid memory
-     * accesses to the callback pointer proper, and the interrupted flag. */
-    vlc_mutex_lock(&ctx->lock);
-    ctx->interrupted = true;
-    if (ctx->callback != NULL)
-        ctx->callback(ctx->data);
-    vlc_mutex_unlock(&ctx->lock);
+     * reentrant. The busy flag ensures that all calls to the callback for a
+     * given context are serialized, and that vlc_interrupt_finish() does not
+     * return while the callback - which may refer to stack data of the
+     * waiting thread - is being invoked. */
+    atomic_store(&ctx->interrupted, true);
+
+    vlc_interrupt_cb_lock(ctx);
+    void (*cb)(void *) = (void (*)(void *))atomic_load(&ctx->callback);
+    if (cb != NULL)
+        cb(ctx->data);
+    vlc_interrupt_cb_unlock(ctx);
 }
 
 vlc_interrupt_t *vlc_interrupt_set(vlc_interrupt_t *newctx)
@@ -179,15 +198,24 @@ static void vlc_interrupt_prepare(vlc_interrupt_t *ctx,
 {
     assert(ctx != NULL);
     assert(ctx == vlc_interrupt_get());
+    assert(atomic_load(&ctx->callback) == (uintptr_t)NULL);
 
-    vlc_mutex_lock(&ctx->lock);
-    assert(ctx->callback == NULL);
-    ctx->callback = cb;
+    /* Lock-free registration: this runs twice per interruptible I/O
+     * operation, so it must not cost more than the two stores and one load.
+     * The data pointer is published by the (sequentially consistent)
+     * callback store. */
     ctx->data = data;
+    atomic_store(&ctx->callback, (uintptr_t)cb);
+
+    if (likely(!atomic_load(&ctx->interrupted)))
+        return;
 
-    if (unlikely(ctx->interrupted))
+    /* Pending interruption: deliver it here, serialized against any
+     * concurrent raiser so the callback is not entered twice at once. */
+    vlc_interrupt_cb_lock(ctx);
+    if (atomic_load(&ctx->interrupted))
         cb(data);
-    vlc_mutex_unlock(&ctx->lock);
+    vlc_interrupt_cb_unlock(ctx);
 }
 
 /**
@@ -203,21 +231,19 @@ static void vlc_interrupt_prepare(vlc_interrupt_t *ctx,
  */
 static int vlc_interrupt_finish(vlc_interrupt_t *ctx)
 {
-    int ret = 0;
-
     assert(ctx != NULL);
     assert(ctx == vlc_interrupt_get());
 
-    /* Wait for pending callbacks to prevent access by other threads. */
-    vlc_mutex_lock(&ctx->lock);
-    ctx->callback = NULL;
-    if (ctx->interrupted)
-    {
-        ret = EINTR;
-        ctx->interrupted = false;
-    }
-    vlc_mutex_unlock(&ctx->lock);
-    return ret;
+    atomic_store(&ctx->callback, (uintptr_t)NULL);
+
+    /* Wait for a pending invocation: a raiser may have loaded the callback
+     * pointer just before it was cleared above, and the callback can refer
+     * to data on this thread's stack. In the common, uninterrupted case the
+     * busy flag is not even set and this is a single load. */
+    while (atomic_load(&ctx->busy))
+        /* spin briefly, see vlc_interrupt_cb_lock() */;
+
+    return atomic_exchange(&ctx->interrupted, false) ? EINTR : 0;
 }
 
 void vlc_interrupt_register(void (*cb)(void *), void *opaque)
@@ -273,19 +299,35 @@ int vlc_sem_wait_i11e(vlc_sem_t *sem)
     return vlc_interrupt_finish(ctx);
 }
 
+struct vlc_mwait_data
+{
+    vlc_mutex_t lock;
+    vlc_cond_t cond;
+};
+
 static void vlc_mwait_i11e_wake(void *opaque)
 {
-    vlc_cond_signal(opaque);
+    struct vlc_mwait_data *md = opaque;
+
+    /* Taking the lock pairs with the interrupted check done under it in
+     * vlc_mwait_i11e(), so the signal cannot fall in between the check and
+     * the wait. */
+    vlc_mutex_lock(&md->lock);
+    vlc_cond_signal(&md->cond);
+    vlc_mutex_unlock(&md->lock);
 }
 
 static void vlc_mwait_i11e_cleanup(void *opaque)
 {
     vlc_interrupt_t *ctx = opaque;
-    vlc_cond_t *cond = ctx->data;
+    struct vlc_mwait_data *md = ctx->data;
 
-    vlc_mutex_unlock(&ctx->lock);
+    vlc_mutex_unlock(&md->lock);
+    /* finish() waits for any callback invocation in progress, after which
+     * md cannot be accessed by other threads any longer */
     vlc_interrupt_finish(ctx);
-    vlc_cond_destroy(cond);
+    vlc_cond_destroy(&md->cond);
+    vlc_mutex_destroy(&md->lock);
 }
 
 int vlc_mwait_i11e(mtime_t deadline)
@@ -294,20 +336,22 @@ int vlc_mwait_i11e(mtime_t deadline)
     if (ctx == NULL)
         return mwait(deadline), 0;
 
-    vlc_cond_t wait;
-    vlc_cond_init(&wait);
+    struct vlc_mwait_data md;
+    vlc_mutex_init(&md.lock);
+    vlc_cond_init(&md.cond);
 
-    vlc_interrupt_prepare(ctx, vlc_mwait_i11e_wake, &wait);
+    vlc_interrupt_prepare(ctx, vlc_mwait_i11e_wake, &md);
 
-    vlc_mutex_lock(&ctx->lock);
+    vlc_mutex_lock(&md.lock);
     vlc_cleanup_push(vlc_mwait_i11e_cleanup, ctx);
-    while (!ctx->interrupted
-        && vlc_cond_timedwait(&wait, &ctx->lock, deadline) == 0);
+    while (!atomic_load(&ctx->interrupted)
+        && vlc_cond_timedwait(&md.cond, &md.lock, deadline) == 0);
     vlc_cleanup_pop();
-    vlc_mutex_unlock(&ctx->lock);
+    vlc_mutex_unlock(&md.lock);
 
     int ret = vlc_interrupt_finish(ctx);
-    vlc_cond_destroy(&wait);
+    vlc_cond_destroy(&md.cond);
+    vlc_mutex_destroy(&md.lock);
     return ret;
 }
 
@@ -341,7 +385,8 @@ int vlc_interrupt_forward_stop(void *const data[2])
     if (from == NULL)
         return 0;
 
-    assert(from->callback == vlc_interrupt_forward_wake);
+    assert(atomic_load(&from->callback)
+           == (uintptr_t)vlc_interrupt_forward_wake);
     assert(from->data == data);
     return vlc_interrupt_finish(from);
 }
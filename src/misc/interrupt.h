@@ -30,13 +30,16 @@ void vlc_interrupt_deinit(vlc_interrupt_t *);
 
 struct vlc_interrupt
 {
-    vlc_mutex_t lock;
-    bool interrupted;
+    atomic_bool interrupted;
 #ifndef NDEBUG
     bool attached;
 #endif
     atomic_bool killed;
-    void (*callback)(void *);
+    /** Serializes callback invocations (raise against raise and against
+     * deregistration). Never touched on the registration fast path. */
+    atomic_bool busy;
+    /** Interruption callback (atomic function pointer, may be zero) */
+    atomic_uintptr_t callback;
     void *data;
 };
 #endif
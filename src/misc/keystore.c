@@ -229,6 +229,165 @@ smb_split_domain(vlc_credential *p_credential)
     }
 }
 
+/*
+ * In-process credential cache
+ *
+ * A keystore lookup means probing keystore modules and, with the secret
+ * service backends, a few DBus round-trips -- for every single lookup.
+ * Batch-opening many URLs of the same server pays that cost over and over,
+ * so keystore results (including "nothing found") are remembered here for a
+ * short while, keyed by the same fields the keystore lookup matches on.
+ * Negative results expire quickly so freshly stored secrets get picked up.
+ */
+#define CREDENTIAL_CACHE_SIZE     32
+#define CREDENTIAL_CACHE_TTL      (120 * CLOCK_FREQ)
+#define CREDENTIAL_CACHE_NEG_TTL  (10 * CLOCK_FREQ)
+
+static struct
+{
+    vlc_mutex_t lock;
+    unsigned i_next; /* round-robin eviction */
+    struct credential_cache_entry
+    {
+        char *psz_key;
+        char *psz_username; /* NULL for negative entries */
+        char *psz_password; /* NULL for negative entries */
+        mtime_t i_deadline;
+    } entries[CREDENTIAL_CACHE_SIZE];
+} credential_cache = { VLC_STATIC_MUTEX, 0, { { NULL, NULL, NULL, 0 } } };
+
+static char *
+credential_cache_key(const vlc_credential *p_credential)
+{
+    const vlc_url_t *p_url = p_credential->p_url;
+    char *psz_key;
+
+    if (asprintf(&psz_key, "%s\037%s\037%s\037%d\037%s\037%s\037%s",
+                 p_url->psz_protocol,
+                 p_credential->psz_username ? p_credential->psz_username : "",
+                 p_url->psz_host, p_url->i_port,
+                 p_url->psz_path ? p_url->psz_path : "",
+                 p_credential->psz_realm ? p_credential->psz_realm : "",
+                 p_credential->psz_authtype ? p_credential->psz_authtype : "")
+            == -1)
+        return NULL;
+    return psz_key;
+}
+
+/* Returns true on a cache hit. A positive hit fills the credential from the
+ * cache; a negative hit leaves it alone (the caller falls through to the
+ * dialog), but saves the keystore round-trip either way. */
+static bool
+credential_cache_lookup(vlc_credential *p_credential, const char *psz_key)
+{
+    bool b_found = false;
+
+    vlc_mutex_lock(&credential_cache.lock);
+    for (unsigned i = 0; i < CREDENTIAL_CACHE_SIZE; ++i)
+    {
+        struct credential_cache_entry *e = &credential_cache.entries[i];
+
+        if (e->psz_key == NULL || strcmp(e->psz_key, psz_key) != 0)
+            continue;
+        if (mdate() > e->i_deadline)
+            break; /* expired: treat as a miss, the slot will be reused */
+
+        if (e->psz_password != NULL)
+        {
+            char *psz_username = strdup(e->psz_username);
+            char *psz_password = strdup(e->psz_password);
+
+            if (psz_username != NULL && psz_password != NULL)
+            {
+                free(p_credential->psz_cached_username);
+                free(p_credential->psz_cached_password);
+                p_credential->psz_cached_username = psz_username;
+                p_credential->psz_cached_password = psz_password;
+                p_credential->psz_username = psz_username;
+                p_credential->psz_password = psz_password;
+                p_credential->b_from_keystore = true;
+                b_found = true;
+            }
+            else
+            {
+                free(psz_username);
+                free(psz_password);
+            }
+        }
+        else
+            b_found = true; /* negative entry */
+        break;
+    }
+    vlc_mutex_unlock(&credential_cache.lock);
+
+    return b_found;
+}
+
+/* Remember the outcome of a keystore lookup. Takes ownership of psz_key,
+ * which must predate the lookup (the lookup may rewrite the username the
+ * key is derived from). */
+static void
+credential_cache_save(vlc_credential *p_credential, char *psz_key)
+{
+    if (psz_key == NULL)
+        return;
+
+    char *psz_username = NULL, *psz_password = NULL;
+    if (p_credential->b_from_keystore)
+    {
+        psz_username = strdup(p_credential->psz_username);
+        psz_password = strdup(p_credential->psz_password);
+        if (psz_username == NULL || psz_password == NULL)
+        {
+            free(psz_username);
+            free(psz_password);
+            free(psz_key);
+            return;
+        }
+    }
+
+    vlc_mutex_lock(&credential_cache.lock);
+
+    /* Reuse the slot holding the same key, or an empty one, or round-robin */
+    struct credential_cache_entry *e = NULL;
+    for (unsigned i = 0; i < CREDENTIAL_CACHE_SIZE && e == NULL; ++i)
+    {
+        struct credential_cache_entry *it = &credential_cache.entries[i];
+        if (it->psz_key == NULL || strcmp(it->psz_key, psz_key) == 0)
+            e = it;
+    }
+    if (e == NULL)
+        e = &credential_cache.entries[credential_cache.i_next++
+                                      % CREDENTIAL_CACHE_SIZE];
+
+    free(e->psz_key);
+    free(e->psz_username);
+    free(e->psz_password);
+    e->psz_key = psz_key;
+    e->psz_username = psz_username;
+    e->psz_password = psz_password;
+    e->i_deadline = mdate() + (psz_password != NULL ? CREDENTIAL_CACHE_TTL
+                                                    : CREDENTIAL_CACHE_NEG_TTL);
+
+    vlc_mutex_unlock(&credential_cache.lock);
+}
+
+/* Called when a secret is (re)stored: cheaper than tracking which entries
+ * the store invalidates */
+static void
+credential_cache_flush(void)
+{
+    vlc_mutex_lock(&credential_cache.lock);
+    for (unsigned i = 0; i < CREDENTIAL_CACHE_SIZE; ++i)
+    {
+        struct credential_cache_entry *e = &credential_cache.entries[i];
+        FREENULL(e->psz_key);
+        FREENULL(e->psz_username);
+        FREENULL(e->psz_password);
+    }
+    vlc_mutex_unlock(&credential_cache.lock);
+}
+
 static void
 credential_find_keystore(vlc_credential *p_credential)
 {
@@ -310,6 +469,8 @@ vlc_credential_clean(vlc_credential *p_credential)
     free(p_credential->psz_var_password);
     free(p_credential->psz_dialog_username);
     free(p_credential->psz_dialog_password);
+    free(p_credential->psz_cached_username);
+    free(p_credential->psz_cached_password);
 }
 
 #undef vlc_credential_get
@@ -378,16 +539,30 @@ vlc_credential_get(vlc_credential *p_credential, vlc_object_t *p_parent,
             break;
 
         case GET_FROM_KEYSTORE:
+        {
             if (!psz_dialog_title || !psz_dialog_fmt)
                 return false;
 
-            if (p_credential->p_keystore == NULL)
-                p_credential->p_keystore = vlc_keystore_create(p_parent);
-            if (p_credential->p_keystore != NULL)
-                credential_find_keystore(p_credential);
+            char *psz_key = credential_cache_key(p_credential);
+            if (psz_key != NULL && credential_cache_lookup(p_credential,
+                                                           psz_key))
+                free(psz_key);
+            else
+            {
+                if (p_credential->p_keystore == NULL)
+                    p_credential->p_keystore = vlc_keystore_create(p_parent);
+                if (p_credential->p_keystore != NULL)
+                {
+                    credential_find_keystore(p_credential);
+                    credential_cache_save(p_credential, psz_key);
+                }
+                else
+                    free(psz_key);
+            }
 
             p_credential->i_get_order++;
             break;
+        }
 
         default:
         case GET_FROM_DIALOG:
@@ -489,6 +664,8 @@ vlc_credential_store(vlc_credential *p_credential)
     bool b_ret = vlc_keystore_store(p_credential->p_keystore, ppsz_values,
                                     (const uint8_t *)p_credential->psz_password,
                                     -1, psz_label) == VLC_SUCCESS;
+    if (b_ret)
+        credential_cache_flush();
     free(psz_label);
     free(psz_path);
     return b_ret;
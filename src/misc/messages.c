@@ -41,8 +41,28 @@
 #include <vlc_interface.h>
 #include <vlc_charset.h>
 #include <vlc_modules.h>
+#include <vlc_atomic.h>
 #include "../libvlc.h"
 
+struct vlc_log_record
+{
+    struct vlc_log_record *next;
+    int type;
+    vlc_log_t meta;
+    char *module; /* private copies (the caller's strings may be on stack) */
+    char *header;
+    char *msg;
+};
+
+struct vlc_log_async
+{
+    atomic_uintptr_t staged; /**< lock-free LIFO of pending records */
+    vlc_sem_t wait;          /**< posted on empty-to-non-empty transition */
+    vlc_thread_t thread;     /**< drain and dispatch thread */
+    atomic_bool exiting;
+    libvlc_int_t *vlc;
+};
+
 struct vlc_logger_t
 {
     VLC_COMMON_MEMBERS
@@ -50,9 +70,13 @@ struct vlc_logger_t
     vlc_log_cb log;
     void *sys;
     module_t *module;
+    struct vlc_log_async *async; /**< non-NULL in asynchronous mode */
 };
 
-static void vlc_vaLogCallback(libvlc_int_t *vlc, int type,
+/**
+ * Dispatches a log message to the logging backend, synchronously.
+ */
+static void vlc_vaLogDispatch(libvlc_int_t *vlc, int type,
                               const vlc_log_t *item, const char *format,
                               va_list ap)
 {
@@ -67,6 +91,115 @@ static void vlc_vaLogCallback(libvlc_int_t *vlc, int type,
     vlc_restorecancel(canc);
 }
 
+static void vlc_LogRecordFree(struct vlc_log_record *rec)
+{
+    free(rec->module);
+    free(rec->header);
+    free(rec->msg);
+    free(rec);
+}
+
+static void vlc_LogDispatch(libvlc_int_t *vlc, int type,
+                            const vlc_log_t *item, const char *format, ...)
+{
+    va_list ap;
+
+    va_start(ap, format);
+    vlc_vaLogDispatch(vlc, type, item, format, ap);
+    va_end(ap);
+}
+
+static void *vlc_LogAsyncThread(void *opaque)
+{
+    struct vlc_log_async *async = opaque;
+
+    for (;;)
+    {
+        vlc_sem_wait(&async->wait);
+
+        struct vlc_log_record *lifo = (struct vlc_log_record *)
+            atomic_exchange_explicit(&async->staged, (uintptr_t)NULL,
+                                     memory_order_acquire);
+        struct vlc_log_record *rec = NULL;
+
+        while (lifo != NULL) /* reverse: records were staged LIFO */
+        {
+            struct vlc_log_record *next = lifo->next;
+
+            lifo->next = rec;
+            rec = lifo;
+            lifo = next;
+        }
+
+        while (rec != NULL)
+        {
+            struct vlc_log_record *next = rec->next;
+
+            vlc_LogDispatch(async->vlc, rec->type, &rec->meta, "%s",
+                            (rec->msg != NULL) ? rec->msg : "message lost");
+            vlc_LogRecordFree(rec);
+            rec = next;
+        }
+
+        if (atomic_load_explicit(&async->exiting, memory_order_acquire)
+         && atomic_load_explicit(&async->staged,
+                                 memory_order_acquire) == (uintptr_t)NULL)
+            break;
+    }
+    return NULL;
+}
+
+/**
+ * Queues a log message for deferred dispatch by the drain thread.
+ *
+ * The message is formatted on the calling thread (a variable argument list
+ * cannot safely outlive its caller), but the logger lock and backend module
+ * dispatch - where the actual I/O happens - are taken over by the drain
+ * thread, so hot paths never block on log output.
+ */
+static void vlc_vaLogAsync(struct vlc_log_async *async, int type,
+                           const vlc_log_t *item, const char *format,
+                           va_list ap)
+{
+    struct vlc_log_record *rec = malloc(sizeof (*rec));
+    if (unlikely(rec == NULL))
+        return;
+
+    rec->type = type;
+    rec->meta = *item;
+    rec->module = strdup(item->psz_module);
+    rec->header = (item->psz_header != NULL) ? strdup(item->psz_header)
+                                             : NULL;
+    rec->meta.psz_module = rec->module;
+    rec->meta.psz_header = rec->header;
+    if (vasprintf(&rec->msg, format, ap) == -1)
+        rec->msg = NULL;
+
+    uintptr_t head = atomic_load_explicit(&async->staged,
+                                          memory_order_relaxed);
+    do
+        rec->next = (struct vlc_log_record *)head;
+    while (!atomic_compare_exchange_weak_explicit(&async->staged, &head,
+                                                  (uintptr_t)rec,
+                                                  memory_order_release,
+                                                  memory_order_relaxed));
+    if (head == (uintptr_t)NULL)
+        vlc_sem_post(&async->wait);
+}
+
+static void vlc_vaLogCallback(libvlc_int_t *vlc, int type,
+                              const vlc_log_t *item, const char *format,
+                              va_list ap)
+{
+    vlc_logger_t *logger = libvlc_priv(vlc)->logger;
+
+    assert(logger != NULL);
+    if (logger->async != NULL)
+        vlc_vaLogAsync(logger->async, type, item, format, ap);
+    else
+        vlc_vaLogDispatch(vlc, type, item, format, ap);
+}
+
 static void vlc_LogCallback(libvlc_int_t *vlc, int type, const vlc_log_t *item,
                             const char *format, ...)
 {
@@ -329,6 +462,7 @@ int vlc_LogPreinit(libvlc_int_t *vlc)
         return -1;
 
     vlc_rwlock_init(&logger->lock);
+    logger->async = NULL;
 
     if (vlc_LogEarlyOpen(logger))
     {
@@ -378,9 +512,47 @@ int vlc_LogInit(libvlc_int_t *vlc)
     if (early_sys != NULL)
         vlc_LogEarlyClose(logger, early_sys);
 
+    /* Deferred log dispatch: hot threads only format and enqueue, a drain
+     * thread takes care of backend dispatch and I/O. */
+    if (var_InheritBool(vlc, "log-async"))
+    {
+        struct vlc_log_async *async = malloc(sizeof (*async));
+
+        if (likely(async != NULL))
+        {
+            atomic_init(&async->staged, (uintptr_t)NULL);
+            atomic_init(&async->exiting, false);
+            vlc_sem_init(&async->wait, 0);
+            async->vlc = vlc;
+            if (vlc_clone(&async->thread, vlc_LogAsyncThread, async,
+                          VLC_THREAD_PRIORITY_LOW) == 0)
+                logger->async = async;
+            else
+            {
+                vlc_sem_destroy(&async->wait);
+                free(async);
+            }
+        }
+    }
+
     return 0;
 }
 
+static void vlc_LogAsyncStop(vlc_logger_t *logger)
+{
+    struct vlc_log_async *async = logger->async;
+
+    if (async == NULL)
+        return;
+
+    logger->async = NULL;
+    atomic_store_explicit(&async->exiting, true, memory_order_release);
+    vlc_sem_post(&async->wait);
+    vlc_join(async->thread, NULL);
+    vlc_sem_destroy(&async->wait);
+    free(async);
+}
+
 /**
  * Sets the message logging callback.
  * \param cb message callback, or NULL to clear
@@ -425,6 +597,10 @@ void vlc_LogDeinit(libvlc_int_t *vlc)
     if (unlikely(logger == NULL))
         return;
 
+    /* Drain and stop the asynchronous dispatch thread first, so that every
+     * queued record reaches the backend before it is unloaded. */
+    vlc_LogAsyncStop(logger);
+
     if (logger->module != NULL)
         vlc_module_unload(logger->module, vlc_logger_unload, logger->sys);
     else
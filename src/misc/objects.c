@@ -191,7 +191,7 @@ void *vlc_custom_create (vlc_object_t *parent, size_t length,
     if (unlikely(priv == NULL))
         return NULL;
     priv->psz_name = NULL;
-    priv->var_root = NULL;
+    priv->var_table = (vlc_var_table_t){ NULL, 0, 0 };
     vlc_mutex_init (&priv->var_lock);
     vlc_cond_init (&priv->var_wait);
     atomic_init (&priv->refs, 1);
@@ -277,6 +277,45 @@ void vlc_object_set_destructor( vlc_object_t *p_this,
 
 static vlc_mutex_t name_lock = VLC_STATIC_MUTEX;
 
+/* Global index of named objects, so that vlc_object_find_name() does not
+ * have to walk the whole object tree.  Named objects are rare (the name
+ * is deprecated), so a small table is plenty. */
+#define NAME_HASH_SIZE 16
+
+static vlc_object_internals_t *name_index[NAME_HASH_SIZE];
+
+static unsigned NameHash (const char *name)
+{
+    unsigned hash = 5381;
+
+    for (; *name != '\0'; name++)
+        hash = hash * 33 + (unsigned char)*name;
+    return hash % NAME_HASH_SIZE;
+}
+
+/* Must be called with name_lock held */
+static void NameIndexInsert (vlc_object_internals_t *priv)
+{
+    vlc_object_internals_t **pp = &name_index[NameHash (priv->psz_name)];
+
+    priv->name_prev = NULL;
+    priv->name_next = *pp;
+    if (*pp != NULL)
+        (*pp)->name_prev = priv;
+    *pp = priv;
+}
+
+/* Must be called with name_lock held */
+static void NameIndexRemove (vlc_object_internals_t *priv)
+{
+    if (priv->name_prev != NULL)
+        priv->name_prev->name_next = priv->name_next;
+    else
+        name_index[NameHash (priv->psz_name)] = priv->name_next;
+    if (priv->name_next != NULL)
+        priv->name_next->name_prev = priv->name_prev;
+}
+
 #undef vlc_object_set_name
 int vlc_object_set_name(vlc_object_t *obj, const char *name)
 {
@@ -286,7 +325,11 @@ int vlc_object_set_name(vlc_object_t *obj, const char *name)
 
     vlc_mutex_lock (&name_lock);
     oldname = priv->psz_name;
+    if (oldname != NULL)
+        NameIndexRemove (priv);
     priv->psz_name = newname;
+    if (newname != NULL)
+        NameIndexInsert (priv);
     vlc_mutex_unlock (&name_lock);
 
     free (oldname);
@@ -329,6 +372,14 @@ static void vlc_object_destroy( vlc_object_t *p_this )
     /* Destroy the associated variables. */
     var_DestroyAll( p_this );
 
+    if (p_priv->psz_name != NULL)
+    {   /* Unindex before the private data is freed; pending lookups
+         * skip the object as its reference count is already zero */
+        vlc_mutex_lock (&name_lock);
+        NameIndexRemove (p_priv);
+        vlc_mutex_unlock (&name_lock);
+    }
+
     vlc_mutex_destroy (&p_priv->tree_lock);
     vlc_cond_destroy( &p_priv->var_wait );
     vlc_mutex_destroy( &p_priv->var_lock );
@@ -337,25 +388,6 @@ static void vlc_object_destroy( vlc_object_t *p_this )
     free( p_priv );
 }
 
-static vlc_object_t *FindName (vlc_object_t *obj, const char *name)
-{
-    vlc_object_internals_t *priv = vlc_internals(obj);
-
-    if (priv->psz_name != NULL && !strcmp (priv->psz_name, name))
-        return vlc_object_hold (obj);
-
-    vlc_object_t *found = NULL;
-    /* NOTE: nested locking here (due to recursive call) */
-    vlc_mutex_lock (&vlc_internals(obj)->tree_lock);
-
-    for (priv = priv->first; priv != NULL && found == NULL; priv = priv->next)
-        found = FindName (vlc_externals(priv), name);
-
-    /* NOTE: nested locking here (due to recursive call) */
-    vlc_mutex_unlock (&vlc_internals(obj)->tree_lock);
-    return found;
-}
-
 #undef vlc_object_find_name
 /**
  * Finds a named object and increment its reference count.
@@ -396,8 +428,36 @@ vlc_object_t *vlc_object_find_name( vlc_object_t *p_this, const char *psz_name )
     msg_Err( p_this, "looking for object \"%s\"... FIXME XXX", psz_name );
 #endif
 
+    p_found = NULL;
+
     vlc_mutex_lock (&name_lock);
-    p_found = FindName (p_this, psz_name);
+    for (vlc_object_internals_t *priv = name_index[NameHash (psz_name)];
+         priv != NULL; priv = priv->name_next)
+    {
+        if (strcmp (priv->psz_name, psz_name))
+            continue;
+
+        /* Only objects inside the caller subtree qualify.  Parent links
+         * are write-once and the chain is kept alive by the candidate,
+         * which cannot be freed while it is still indexed. */
+        vlc_object_t *obj = vlc_externals (priv);
+        while (obj != NULL && obj != p_this)
+            obj = obj->p_parent;
+        if (obj == NULL)
+            continue;
+
+        /* The object may already await destruction (zero references,
+         * not yet unindexed); hold it only if it is still alive. */
+        unsigned refs = atomic_load (&priv->refs);
+        while (refs > 0)
+            if (atomic_compare_exchange_weak (&priv->refs, &refs, refs + 1))
+            {
+                p_found = vlc_externals (priv);
+                break;
+            }
+        if (p_found != NULL)
+            break;
+    }
     vlc_mutex_unlock (&name_lock);
     return p_found;
 }
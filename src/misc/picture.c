@@ -38,6 +38,8 @@
 #include <vlc_image.h>
 #include <vlc_block.h>
 
+#include "../libvlc.h"
+
 /**
  * Allocate a new picture in the heap.
  *
@@ -62,7 +64,9 @@ static int AllocatePicture( picture_t *p_pic )
         i_bytes += p->i_pitch * p->i_lines;
     }
 
-    uint8_t *p_data = vlc_memalign( 16, i_bytes );
+    /* A whole cache line: AVX2 loads/stores want 32 bytes, and 64 keeps
+     * planes from straddling lines on every current CPU. */
+    uint8_t *p_data = vlc_memalign( 64, i_bytes );
     if( i_bytes > 0 && p_data == NULL )
     {
         p_pic->i_planes = 0;
@@ -84,6 +88,20 @@ static int AllocatePicture( picture_t *p_pic )
  *
  *****************************************************************************/
 
+/**
+ * Size of a picture as described by its planes, for allocation accounting.
+ * For pictures carrying external (resource) memory this counts the memory
+ * the planes point to, not memory owned by the picture.
+ */
+static size_t picture_PlanesSize( const picture_t *p_picture )
+{
+    size_t i_bytes = 0;
+
+    for( int i = 0; i < p_picture->i_planes; i++ )
+        i_bytes += (size_t)p_picture->p[i].i_pitch * p_picture->p[i].i_lines;
+    return i_bytes;
+}
+
 static void PictureDestroyContext( picture_t *p_picture )
 {
     void (**context)( void * ) = p_picture->context;
@@ -137,6 +155,43 @@ static int LCM( int a, int b )
     return a * b / GCD( a, b );
 }
 
+/* Plane geometry depends only on the chroma and dimensions, and pools,
+ * filters and transcode create thousands of pictures per second in the very
+ * same format: memoize computed layouts in a small direct-mapped cache so
+ * the common case is a lookup instead of chroma table walks and LCMs. */
+typedef struct
+{
+    vlc_fourcc_t i_chroma; /* 0 when the slot is empty */
+    unsigned     i_width, i_height;
+    unsigned     i_visible_width, i_visible_height;
+    int          i_planes;
+    plane_t      p[VOUT_MAX_PLANES];
+} picture_layout_t;
+
+#define LAYOUT_CACHE_SIZE 16
+static picture_layout_t layout_cache[LAYOUT_CACHE_SIZE];
+static vlc_mutex_t layout_lock = VLC_STATIC_MUTEX;
+
+static picture_layout_t *LayoutCacheSlot( vlc_fourcc_t i_chroma,
+                                          const video_format_t *restrict fmt )
+{
+    unsigned h = i_chroma ^ (fmt->i_width * 2654435761u)
+               ^ (fmt->i_height * 40503u) ^ fmt->i_visible_width
+               ^ (fmt->i_visible_height << 16);
+    return &layout_cache[h % LAYOUT_CACHE_SIZE];
+}
+
+static bool LayoutCacheMatch( const picture_layout_t *cache,
+                              vlc_fourcc_t i_chroma,
+                              const video_format_t *restrict fmt )
+{
+    return cache->i_chroma == i_chroma &&
+           cache->i_width == fmt->i_width &&
+           cache->i_height == fmt->i_height &&
+           cache->i_visible_width == fmt->i_visible_width &&
+           cache->i_visible_height == fmt->i_visible_height;
+}
+
 int picture_Setup( picture_t *p_picture, const video_format_t *restrict fmt )
 {
     /* Store default values */
@@ -154,8 +209,25 @@ int picture_Setup( picture_t *p_picture, const video_format_t *restrict fmt )
                         fmt->i_visible_width, fmt->i_visible_height,
                         fmt->i_sar_num, fmt->i_sar_den );
 
+    const vlc_fourcc_t i_chroma = p_picture->format.i_chroma;
+    picture_layout_t *cache = LayoutCacheSlot( i_chroma, fmt );
+
+    vlc_mutex_lock( &layout_lock );
+    if( LayoutCacheMatch( cache, i_chroma, fmt ) )
+    {
+        p_picture->i_planes = cache->i_planes;
+        for( int i = 0; i < cache->i_planes; i++ )
+        {
+            p_picture->p[i] = cache->p[i];
+            p_picture->p[i].p_pixels = NULL;
+        }
+        vlc_mutex_unlock( &layout_lock );
+        return VLC_SUCCESS;
+    }
+    vlc_mutex_unlock( &layout_lock );
+
     const vlc_chroma_description_t *p_dsc =
-        vlc_fourcc_GetChromaDescription( p_picture->format.i_chroma );
+        vlc_fourcc_GetChromaDescription( i_chroma );
     if( !p_dsc )
         return VLC_EGENERIC;
 
@@ -194,6 +266,17 @@ int picture_Setup( picture_t *p_picture, const video_format_t *restrict fmt )
     }
     p_picture->i_planes  = p_dsc->plane_count;
 
+    vlc_mutex_lock( &layout_lock );
+    cache->i_chroma = i_chroma;
+    cache->i_width = fmt->i_width;
+    cache->i_height = fmt->i_height;
+    cache->i_visible_width = fmt->i_visible_width;
+    cache->i_visible_height = fmt->i_visible_height;
+    cache->i_planes = p_picture->i_planes;
+    for( int i = 0; i < p_picture->i_planes; i++ )
+        cache->p[i] = p_picture->p[i];
+    vlc_mutex_unlock( &layout_lock );
+
     return VLC_SUCCESS;
 }
 
@@ -261,6 +344,7 @@ picture_t *picture_NewFromResource( const video_format_t *p_fmt, const picture_r
         priv->gc.destroy = picture_Destroy;
     }
 
+    stats_AllocAdd( STATS_ALLOC_PICTURE, picture_PlanesSize( p_picture ) );
     return p_picture;
 }
 
@@ -304,6 +388,7 @@ void picture_Release( picture_t *p_picture )
     if( refs > 1 )
         return;
 
+    stats_AllocRemove( STATS_ALLOC_PICTURE, picture_PlanesSize( p_picture ) );
     PictureDestroyContext( p_picture );
     assert( priv->gc.destroy != NULL );
     priv->gc.destroy( p_picture );
@@ -32,15 +32,34 @@
 #include <assert.h>
 
 #include <vlc_common.h>
+#include <vlc_atomic.h>
 #include <vlc_picture_fifo.h>
+#include "../libvlc.h"
 
 /*****************************************************************************
  *
  *****************************************************************************/
+
+/* A picture fifo is either a plain mutex-protected linked list, or - when
+ * created with picture_fifo_NewSPSC() - a bounded lock-free ring for a
+ * single producer and a single consumer, with the linked list relegated to
+ * overflow duty. On the fast path, the producer and consumer then only
+ * touch their respective atomic index and never contend on the lock. */
 struct picture_fifo_t {
     vlc_mutex_t lock;
     picture_t   *first;
     picture_t   **last_ptr;
+
+    /* Lock-free single-producer/single-consumer ring (may be absent) */
+    unsigned    ring_size;  /* power of two, 0 for plain fifos */
+    picture_t   **ring;
+    atomic_uint read_idx;   /* owned by the consumer */
+    atomic_uint write_idx;  /* owned by the producer */
+    /* Raised by the producer when it falls back to the linked list (ring
+     * full), cleared by the consumer once the list is drained. While it is
+     * raised, the producer keeps appending to the list so that FIFO order
+     * is preserved. */
+    atomic_bool overflow;
 };
 
 static void PictureFifoReset(picture_fifo_t *fifo)
@@ -67,35 +86,130 @@ static picture_t *PictureFifoPop(picture_fifo_t *fifo)
     return picture;
 }
 
-picture_fifo_t *picture_fifo_New(void)
+/* Consumer side: pops the oldest ring entry, if any. */
+static picture_t *PictureRingPop(picture_fifo_t *fifo)
+{
+    unsigned r = atomic_load_explicit(&fifo->read_idx, memory_order_relaxed);
+    unsigned w = atomic_load_explicit(&fifo->write_idx, memory_order_acquire);
+
+    if (r == w)
+        return NULL;
+
+    picture_t *picture = fifo->ring[r & (fifo->ring_size - 1)];
+    atomic_store_explicit(&fifo->read_idx, r + 1, memory_order_release);
+    return picture;
+}
+
+static picture_fifo_t *PictureFifoNew(unsigned ring_size)
 {
     picture_fifo_t *fifo = malloc(sizeof(*fifo));
     if (!fifo)
         return NULL;
 
-    vlc_mutex_init(&fifo->lock);
+    /* Held for a few pointer updates per picture, on the decoder/vout
+     * boundary: spinning beats parking when both sides run hot */
+    vlc_mutex_init_adaptive(&fifo->lock);
     PictureFifoReset(fifo);
+    fifo->ring_size = ring_size;
+    fifo->ring = NULL;
+    atomic_init(&fifo->read_idx, 0);
+    atomic_init(&fifo->write_idx, 0);
+    atomic_init(&fifo->overflow, false);
+
+    if (ring_size > 0) {
+        fifo->ring = malloc(ring_size * sizeof(*fifo->ring));
+        if (!fifo->ring) {
+            vlc_mutex_destroy(&fifo->lock);
+            free(fifo);
+            return NULL;
+        }
+    }
     return fifo;
 }
 
+picture_fifo_t *picture_fifo_New(void)
+{
+    return PictureFifoNew(0);
+}
+
+picture_fifo_t *picture_fifo_NewSPSC(unsigned capacity)
+{
+    unsigned ring_size = 2;
+
+    assert(capacity > 0);
+    while (ring_size < capacity)
+        ring_size *= 2;
+    return PictureFifoNew(ring_size);
+}
+
 void picture_fifo_Push(picture_fifo_t *fifo, picture_t *picture)
 {
+    if (fifo->ring_size > 0
+     && !atomic_load_explicit(&fifo->overflow, memory_order_acquire)) {
+        unsigned w = atomic_load_explicit(&fifo->write_idx,
+                                          memory_order_relaxed);
+        unsigned r = atomic_load_explicit(&fifo->read_idx,
+                                          memory_order_acquire);
+
+        if (w - r < fifo->ring_size) {
+            assert(!picture->p_next);
+            fifo->ring[w & (fifo->ring_size - 1)] = picture;
+            atomic_store_explicit(&fifo->write_idx, w + 1,
+                                  memory_order_release);
+            return;
+        }
+        /* Ring full: spill over to the linked list below. */
+    }
+
     vlc_mutex_lock(&fifo->lock);
     PictureFifoPush(fifo, picture);
+    if (fifo->ring_size > 0)
+        atomic_store_explicit(&fifo->overflow, true, memory_order_release);
     vlc_mutex_unlock(&fifo->lock);
 }
 picture_t *picture_fifo_Pop(picture_fifo_t *fifo)
 {
+    picture_t *picture;
+
+    if (fifo->ring_size > 0) {
+        picture = PictureRingPop(fifo);
+        if (picture != NULL)
+            return picture;
+        /* Ring entries are always older than spilled-over list entries:
+         * only look at the list once the ring is empty. */
+        if (!atomic_load_explicit(&fifo->overflow, memory_order_acquire))
+            return NULL;
+    }
+
     vlc_mutex_lock(&fifo->lock);
-    picture_t *picture = PictureFifoPop(fifo);
+    picture = PictureFifoPop(fifo);
+    if (fifo->ring_size > 0 && fifo->first == NULL)
+        atomic_store_explicit(&fifo->overflow, false, memory_order_release);
     vlc_mutex_unlock(&fifo->lock);
 
     return picture;
 }
 picture_t *picture_fifo_Peek(picture_fifo_t *fifo)
 {
+    picture_t *picture;
+
+    if (fifo->ring_size > 0) {
+        unsigned r = atomic_load_explicit(&fifo->read_idx,
+                                          memory_order_relaxed);
+        unsigned w = atomic_load_explicit(&fifo->write_idx,
+                                          memory_order_acquire);
+
+        if (r != w) {
+            picture = fifo->ring[r & (fifo->ring_size - 1)];
+            picture_Hold(picture);
+            return picture;
+        }
+        if (!atomic_load_explicit(&fifo->overflow, memory_order_acquire))
+            return NULL;
+    }
+
     vlc_mutex_lock(&fifo->lock);
-    picture_t *picture = fifo->first;
+    picture = fifo->first;
     if (picture)
         picture_Hold(picture);
     vlc_mutex_unlock(&fifo->lock);
@@ -111,6 +225,20 @@ void picture_fifo_Flush(picture_fifo_t *fifo, mtime_t date, bool flush_before)
     picture = fifo->first;
     PictureFifoReset(fifo);
 
+    /* Consumer side only: prepend the drained ring entries, which predate
+     * any spilled-over list entry. */
+    if (fifo->ring_size > 0) {
+        picture_t *list = picture;
+        picture_t *ring_pic;
+
+        while ((ring_pic = PictureRingPop(fifo)) != NULL)
+            PictureFifoPush(fifo, ring_pic);
+        *fifo->last_ptr = list;
+
+        picture = fifo->first;
+        PictureFifoReset(fifo);
+    }
+
     picture_fifo_t tmp;
     PictureFifoReset(&tmp);
 
@@ -125,6 +253,11 @@ void picture_fifo_Flush(picture_fifo_t *fifo, mtime_t date, bool flush_before)
             PictureFifoPush(fifo, picture);
         picture = next;
     }
+    /* Survivors stay on the list (in order); make sure the consumer looks
+     * there before the producer refills the ring. */
+    if (fifo->ring_size > 0)
+        atomic_store_explicit(&fifo->overflow, fifo->first != NULL,
+                              memory_order_release);
     vlc_mutex_unlock(&fifo->lock);
 
     while ((picture = PictureFifoPop(&tmp)) != NULL)
@@ -133,6 +266,17 @@ void picture_fifo_Flush(picture_fifo_t *fifo, mtime_t date, bool flush_before)
 void picture_fifo_OffsetDate(picture_fifo_t *fifo, mtime_t delta)
 {
     vlc_mutex_lock(&fifo->lock);
+    if (fifo->ring_size > 0) {
+        /* Consumer side: published ring slots are stable until read_idx
+         * moves past them. */
+        unsigned r = atomic_load_explicit(&fifo->read_idx,
+                                          memory_order_relaxed);
+        unsigned w = atomic_load_explicit(&fifo->write_idx,
+                                          memory_order_acquire);
+
+        for (; r != w; r++)
+            fifo->ring[r & (fifo->ring_size - 1)]->date += delta;
+    }
     for (picture_t *picture = fifo->first; picture != NULL;) {
         picture->date += delta;
         picture = picture->p_next;
@@ -143,6 +287,6 @@ void picture_fifo_Delete(picture_fifo_t *fifo)
 {
     picture_fifo_Flush(fifo, INT64_MAX, true);
     vlc_mutex_destroy(&fifo->lock);
+    free(fifo->ring);
     free(fifo);
 }
-
@@ -170,6 +170,31 @@ error:
     return NULL;
 }
 
+picture_pool_t *picture_pool_NewFromFormatLocal(const video_format_t *fmt,
+                                                unsigned count)
+{
+    picture_pool_t *pool = picture_pool_NewFromFormat(fmt, count);
+    if (pool == NULL)
+        return NULL;
+
+    /* Pre-fault every plane so that, under a first-touch NUMA policy, the
+     * pages end up on the memory node of the calling thread (typically the
+     * video output thread that will render from them) rather than wherever
+     * the kernel first maps them on demand. This also moves the page-fault
+     * cost out of the rendering loop. */
+    for (unsigned i = 0; i < pool->picture_count; i++) {
+        picture_t *picture = pool->picture[i];
+
+        for (int j = 0; j < picture->i_planes; j++) {
+            plane_t *plane = &picture->p[j];
+
+            memset(plane->p_pixels, 0,
+                   (size_t)plane->i_pitch * plane->i_lines);
+        }
+    }
+    return pool;
+}
+
 picture_pool_t *picture_pool_Reserve(picture_pool_t *master, unsigned count)
 {
     picture_t *picture[count ? count : 1];
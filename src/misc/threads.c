@@ -173,3 +173,114 @@ void vlc_sem_wait (vlc_sem_t *sem)
     vlc_mutex_unlock (&sem->lock);
 }
 #endif /* LIBVLC_NEED_SEMAPHORE */
+
+/*** Adaptive mutexes ***/
+
+#include <vlc_variables.h>
+#include "../libvlc.h"
+
+#if defined (LIBVLC_USE_PTHREAD)
+# include <pthread.h>
+#endif
+
+/**
+ * Initializes a mutex that briefly spins before sleeping in the kernel,
+ * where the threading implementation supports it (otherwise this is plain
+ * vlc_mutex_init()). Meant for the hot producer/consumer queues, where the
+ * lock is only ever held for a few dozen instructions and parking the
+ * waiter costs more than the critical section itself.
+ */
+void vlc_mutex_init_adaptive (vlc_mutex_t *mutex)
+{
+#if defined (LIBVLC_USE_PTHREAD) && defined (PTHREAD_MUTEX_ADAPTIVE_NP)
+    pthread_mutexattr_t attr;
+
+    if (unlikely(pthread_mutexattr_init (&attr)))
+        abort ();
+    pthread_mutexattr_settype (&attr, PTHREAD_MUTEX_ADAPTIVE_NP);
+    if (unlikely(pthread_mutex_init (mutex, &attr)))
+        abort ();
+    pthread_mutexattr_destroy (&attr);
+#else
+    vlc_mutex_init (mutex);
+#endif
+}
+
+/*** Thread roles ***/
+
+#ifdef __linux__
+# include <pthread.h>
+# include <sched.h>
+# include <stdio.h>
+# include <string.h>
+
+/**
+ * Parses a CPU list of the taskset kind ("0,2-3") into a CPU set.
+ * @return 0 on success, -1 on a parse error.
+ */
+static int vlc_cpu_set_parse (const char *spec, cpu_set_t *set)
+{
+    CPU_ZERO (set);
+
+    do
+    {
+        char *end;
+        unsigned long first = strtoul (spec, &end, 10);
+        unsigned long last = first;
+
+        if (end == spec)
+            return -1;
+        if (*end == '-')
+        {
+            spec = end + 1;
+            last = strtoul (spec, &end, 10);
+            if (end == spec)
+                return -1;
+        }
+        if (first > last || last >= CPU_SETSIZE)
+            return -1;
+
+        for (unsigned long cpu = first; cpu <= last; cpu++)
+            CPU_SET (cpu, set);
+
+        if (*end == '\0')
+            return 0;
+        if (*end != ',')
+            return -1;
+        spec = end + 1;
+    }
+    while (true);
+}
+#endif
+
+#undef vlc_thread_SetRole
+void vlc_thread_SetRole (vlc_object_t *obj, const char *role)
+{
+#ifdef __linux__
+    /* Name the thread after its role, so that ps/htop/tracers double as a
+     * registry of the pipeline threads (15 characters limit) */
+    char name[16];
+
+    snprintf (name, sizeof (name), "vlc %s", role);
+    pthread_setname_np (pthread_self (), name);
+
+    char varname[32];
+
+    snprintf (varname, sizeof (varname), "%s-cpu-set", role);
+
+    char *spec = var_InheritString (obj, varname);
+    if (spec == NULL)
+        return;
+
+    cpu_set_t set;
+
+    if (vlc_cpu_set_parse (spec, &set)
+     || pthread_setaffinity_np (pthread_self (), sizeof (set), &set))
+        msg_Warn (obj, "cannot apply %s \"%s\"", varname, spec);
+    else
+        msg_Dbg (obj, "%s thread restricted to CPUs %s", role, spec);
+    free (spec);
+#else
+    (void) obj; (void) role;
+#endif
+}
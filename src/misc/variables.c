@@ -73,6 +73,8 @@ typedef struct callback_table_t
 struct variable_t
 {
     char *       psz_name; /**< The variable unique name (must be first) */
+    uint32_t     i_hash;   /**< Hash of psz_name, computed once */
+    struct variable_t *p_hnext; /**< Next variable in the same hash bucket */
 
     /** The variable's exported value */
     vlc_value_t  val;
@@ -99,6 +101,10 @@ struct variable_t
     /** Set to TRUE if the variable is in a callback */
     bool   b_incallback;
 
+    /** Set to TRUE while a deferred notification is queued
+     * (VLC_VAR_ISDEFERRED); further changes are then coalesced */
+    bool   b_notify_queued;
+
     /** Registered value callbacks */
     callback_table_t    value_callbacks;
     /** Registered list callbacks */
@@ -143,23 +149,109 @@ int_ops    = { CmpInt,     DupDummy,  FreeDummy,  },
 string_ops = { CmpString,  DupString, FreeString, },
 coords_ops = { NULL,       DupDummy,  FreeDummy,  };
 
-static int varcmp( const void *a, const void *b )
+/*
+ * Per-object variables are kept in a hash table keyed on the pre-hashed
+ * variable name: interface code calls var_Get()/var_Set() constantly during
+ * playback, and hashing once then chasing a (nearly always singleton)
+ * bucket chain beats a string-compare tree walk on every access.
+ */
+
+#define VAR_TABLE_SIZE_MIN 16 /* power of two */
+
+static uint32_t VarHash( const char *psz_name )
 {
-    const variable_t *va = a, *vb = b;
+    uint32_t hash = UINT32_C(2166136261); /* FNV-1a */
 
-    /* psz_name must be first */
-    assert( va == (const void *)&va->psz_name );
-    return strcmp( va->psz_name, vb->psz_name );
+    for( const unsigned char *p = (const unsigned char *)psz_name; *p; p++ )
+    {
+        hash ^= *p;
+        hash *= UINT32_C(16777619);
+    }
+    return hash;
+}
+
+/**
+ * Finds a variable by (pre-hashed) name. The variable table lock must be
+ * held.
+ */
+static variable_t *TableLookup( vlc_var_table_t *tab, const char *psz_name,
+                                uint32_t i_hash )
+{
+    if( tab->pp_buckets == NULL )
+        return NULL;
+
+    for( variable_t *p_var = tab->pp_buckets[i_hash & (tab->i_size - 1)];
+         p_var != NULL; p_var = p_var->p_hnext )
+        if( p_var->i_hash == i_hash && !strcmp( p_var->psz_name, psz_name ) )
+            return p_var;
+    return NULL;
+}
+
+/**
+ * Inserts a variable. The variable table lock must be held, and no variable
+ * of the same name may exist. Returns -1 on memory error.
+ */
+static int TableInsert( vlc_var_table_t *tab, variable_t *p_var )
+{
+    if( tab->i_count >= tab->i_size - (tab->i_size / 4) )
+    {   /* Load factor reached 3/4: (re)build with twice the buckets */
+        size_t i_size = tab->i_size ? tab->i_size * 2 : VAR_TABLE_SIZE_MIN;
+        variable_t **pp_buckets = calloc( i_size, sizeof (*pp_buckets) );
+
+        if( pp_buckets == NULL )
+        {
+            if( tab->pp_buckets == NULL )
+                return -1;
+            /* Keep the table over-loaded rather than fail */
+        }
+        else
+        {
+            for( size_t i = 0; i < tab->i_size; i++ )
+                for( variable_t *p = tab->pp_buckets[i], *p_next; p != NULL;
+                     p = p_next )
+                {
+                    variable_t **pp = &pp_buckets[p->i_hash & (i_size - 1)];
+
+                    p_next = p->p_hnext;
+                    p->p_hnext = *pp;
+                    *pp = p;
+                }
+            free( tab->pp_buckets );
+            tab->pp_buckets = pp_buckets;
+            tab->i_size = i_size;
+        }
+    }
+
+    variable_t **pp = &tab->pp_buckets[p_var->i_hash & (tab->i_size - 1)];
+
+    p_var->p_hnext = *pp;
+    *pp = p_var;
+    tab->i_count++;
+    return 0;
+}
+
+/**
+ * Unlinks a variable. The variable table lock must be held.
+ */
+static void TableRemove( vlc_var_table_t *tab, variable_t *p_var )
+{
+    variable_t **pp = &tab->pp_buckets[p_var->i_hash & (tab->i_size - 1)];
+
+    while( *pp != p_var )
+        pp = &(*pp)->p_hnext;
+    *pp = p_var->p_hnext;
+    p_var->p_hnext = NULL;
+    assert( tab->i_count > 0 );
+    tab->i_count--;
 }
 
 static variable_t *Lookup( vlc_object_t *obj, const char *psz_name )
 {
     vlc_object_internals_t *priv = vlc_internals( obj );
-    variable_t **pp_var;
+    uint32_t i_hash = VarHash( psz_name );
 
     vlc_mutex_lock(&priv->var_lock);
-    pp_var = tfind( &psz_name, &priv->var_root, varcmp );
-    return (pp_var != NULL) ? *pp_var : NULL;
+    return TableLookup( &priv->var_table, psz_name, i_hash );
 }
 
 static void Destroy( variable_t *p_var )
@@ -278,6 +370,175 @@ static void TriggerCallback(vlc_object_t *obj, variable_t *var,
     vlc_cond_broadcast(&priv->var_wait);
 }
 
+/*
+ * Deferred callback dispatch (VLC_VAR_ISDEFERRED)
+ *
+ * Hot-path variables (position, time, ...) can be watched by slow
+ * observers; running their callbacks synchronously makes var_Set() on the
+ * input thread take milliseconds.  Deferred variables queue a notification
+ * on a per-libvlc notifier thread instead and return immediately.  Bursts
+ * are coalesced: while a notification is queued, further changes only
+ * update the variable, and the callbacks eventually run once with the
+ * latest value and the oldest queued previous value.
+ */
+struct vlc_var_notify_entry
+{
+    vlc_var_notify_entry_t *p_next;
+    vlc_object_t *obj;     /* held */
+    char *psz_name;
+    vlc_value_t prev;      /* duplicated previous value */
+    int i_type;            /* to release prev */
+};
+
+static void NotifyDispatch(vlc_var_notify_entry_t *entry)
+{
+    vlc_object_t *obj = entry->obj;
+    vlc_object_internals_t *priv = vlc_internals(obj);
+
+    /* The variable may have been destroyed (and possibly re-created)
+     * since the notification was queued, hence the lookup by name */
+    variable_t *var = Lookup(obj, entry->psz_name);
+    if (var != NULL)
+    {
+        WaitUnused(obj, var);
+        var->b_notify_queued = false;
+        /* Deliver the latest value; intermediate changes were coalesced */
+        TriggerCallback(obj, var, entry->psz_name, entry->prev);
+    }
+    vlc_mutex_unlock(&priv->var_lock);
+
+    if ((entry->i_type & VLC_VAR_CLASS) == VLC_VAR_STRING)
+        free(entry->prev.psz_string);
+    free(entry->psz_name);
+    vlc_object_release(obj);
+    free(entry);
+}
+
+static void *NotifyThread(void *data)
+{
+    vlc_var_notifier_t *notif = data;
+
+    vlc_mutex_lock(&notif->lock);
+    for (;;)
+    {
+        while (!notif->b_exit && notif->p_first == NULL)
+            vlc_cond_wait(&notif->wait, &notif->lock);
+
+        vlc_var_notify_entry_t *entry = notif->p_first;
+        if (entry == NULL)
+            break; /* exit requested and queue drained */
+        notif->p_first = entry->p_next;
+        if (notif->p_first == NULL)
+            notif->pp_last = &notif->p_first;
+        vlc_mutex_unlock(&notif->lock);
+
+        NotifyDispatch(entry);
+
+        vlc_mutex_lock(&notif->lock);
+    }
+    vlc_mutex_unlock(&notif->lock);
+    return NULL;
+}
+
+/**
+ * Queues a deferred change notification.  The variable lock must be held;
+ * falls back to synchronous dispatch when the notifier is not available.
+ */
+static void DeferCallback(vlc_object_t *obj, variable_t *var,
+                          const char *name, vlc_value_t prev)
+{
+    if (var->value_callbacks.i_entries == 0)
+        return;
+    if (var->b_notify_queued)
+        return; /* coalesced into the pending notification */
+
+    vlc_var_notify_entry_t *entry = malloc(sizeof (*entry));
+    if (unlikely(entry == NULL))
+        goto fallback;
+    entry->psz_name = strdup(name);
+    if (unlikely(entry->psz_name == NULL))
+    {
+        free(entry);
+        goto fallback;
+    }
+    entry->p_next = NULL;
+    entry->i_type = var->i_type;
+    entry->prev = prev;
+    var->ops->pf_dup(&entry->prev);
+
+    vlc_var_notifier_t *notif = &libvlc_priv(obj->p_libvlc)->var_notifier;
+
+    vlc_mutex_lock(&notif->lock);
+    if (!notif->b_active && !notif->b_exit)
+        notif->b_active = !vlc_clone(&notif->thread, NotifyThread, notif,
+                                     VLC_THREAD_PRIORITY_LOW);
+    if (notif->b_active && !notif->b_exit)
+    {
+        entry->obj = vlc_object_hold(obj);
+        var->b_notify_queued = true;
+        *notif->pp_last = entry;
+        notif->pp_last = &entry->p_next;
+        vlc_cond_signal(&notif->wait);
+        entry = NULL;
+    }
+    vlc_mutex_unlock(&notif->lock);
+
+    if (entry == NULL)
+        return;
+
+    /* Notifier gone (libvlc teardown) or thread creation failed */
+    var->ops->pf_free(&entry->prev);
+    free(entry->psz_name);
+    free(entry);
+fallback:
+    TriggerCallback(obj, var, name, prev);
+}
+
+void var_NotifierInit(libvlc_int_t *libvlc)
+{
+    vlc_var_notifier_t *notif = &libvlc_priv(libvlc)->var_notifier;
+
+    vlc_mutex_init(&notif->lock);
+    vlc_cond_init(&notif->wait);
+    notif->b_active = false;
+    notif->b_exit = false;
+    notif->p_first = NULL;
+    notif->pp_last = &notif->p_first;
+}
+
+void var_NotifierClean(libvlc_int_t *libvlc)
+{
+    vlc_var_notifier_t *notif = &libvlc_priv(libvlc)->var_notifier;
+
+    vlc_mutex_lock(&notif->lock);
+    notif->b_exit = true;
+    vlc_cond_signal(&notif->wait);
+    vlc_mutex_unlock(&notif->lock);
+
+    if (notif->b_active)
+    {   /* The thread drains the queue before exiting */
+        vlc_join(notif->thread, NULL);
+        notif->b_active = false;
+    }
+    assert(notif->p_first == NULL);
+
+    vlc_cond_destroy(&notif->wait);
+    vlc_mutex_destroy(&notif->lock);
+}
+
+/**
+ * Runs or queues the value callbacks as configured for the variable.
+ * The variable lock must be held.
+ */
+static void DispatchCallback(vlc_object_t *obj, variable_t *var,
+                             const char *name, vlc_value_t prev)
+{
+    if (var->i_type & VLC_VAR_ISDEFERRED)
+        DeferCallback(obj, var, name, prev);
+    else
+        TriggerCallback(obj, var, name, prev);
+}
+
 static void TriggerListCallback(vlc_object_t *obj, variable_t *var,
                                 const char *name, int action, vlc_value_t *val)
 {
@@ -307,9 +568,8 @@ static void TriggerListCallback(vlc_object_t *obj, variable_t *var,
 /**
  * Initialize a vlc variable
  *
- * We hash the given string and insert it into the sorted list. The insertion
- * may require slow memory copies, but think about what we gain in the log(n)
- * lookup phase when setting/getting the variable value!
+ * We hash the given string once and insert the variable into the object's
+ * hash table; later var_Get()/var_Set() calls then resolve it in O(1).
  *
  * \param p_this The object in which to create the variable
  * \param psz_name The name of the variable
@@ -325,6 +585,7 @@ int var_Create( vlc_object_t *p_this, const char *psz_name, int i_type )
         return VLC_ENOMEM;
 
     p_var->psz_name = strdup( psz_name );
+    p_var->i_hash = VarHash( psz_name );
     p_var->psz_text = NULL;
 
     p_var->i_type = i_type & ~VLC_VAR_DOINHERIT;
@@ -338,6 +599,7 @@ int var_Create( vlc_object_t *p_this, const char *psz_name, int i_type )
     p_var->choices_text.p_values = NULL;
 
     p_var->b_incallback = false;
+    p_var->b_notify_queued = false;
     p_var->value_callbacks = (callback_table_t){ 0 };
 
     /* Always initialize the variable, even if it is a list variable; this
@@ -394,21 +656,26 @@ int var_Create( vlc_object_t *p_this, const char *psz_name, int i_type )
     }
 
     vlc_object_internals_t *p_priv = vlc_internals( p_this );
-    variable_t **pp_var, *p_oldvar;
+    variable_t *p_oldvar;
     int ret = VLC_SUCCESS;
 
     vlc_mutex_lock( &p_priv->var_lock );
 
-    pp_var = tsearch( p_var, &p_priv->var_root, varcmp );
-    if( unlikely(pp_var == NULL) )
-        ret = VLC_ENOMEM;
-    else if( (p_oldvar = *pp_var) == p_var ) /* Variable create */
-        p_var = NULL; /* Variable created */
+    p_oldvar = TableLookup( &p_priv->var_table, p_var->psz_name,
+                            p_var->i_hash );
+    if( p_oldvar == NULL ) /* Variable create */
+    {
+        if( unlikely(TableInsert( &p_priv->var_table, p_var )) )
+            ret = VLC_ENOMEM;
+        else
+            p_var = NULL; /* Variable created */
+    }
     else /* Variable already exists */
     {
         assert (((i_type ^ p_oldvar->i_type) & VLC_VAR_CLASS) == 0);
         p_oldvar->i_usage++;
-        p_oldvar->i_type |= i_type & (VLC_VAR_ISCOMMAND|VLC_VAR_HASCHOICE);
+        p_oldvar->i_type |= i_type & (VLC_VAR_ISCOMMAND|VLC_VAR_HASCHOICE
+                                      |VLC_VAR_ISDEFERRED);
     }
     vlc_mutex_unlock( &p_priv->var_lock );
 
@@ -445,7 +712,7 @@ void (var_Destroy)(vlc_object_t *p_this, const char *psz_name)
     WaitUnused( p_this, p_var );
 
     if( --p_var->i_usage == 0 )
-        tdelete( p_var, &p_priv->var_root, varcmp );
+        TableRemove( &p_priv->var_table, p_var );
     else
         p_var = NULL;
     vlc_mutex_unlock( &p_priv->var_lock );
@@ -454,17 +721,22 @@ void (var_Destroy)(vlc_object_t *p_this, const char *psz_name)
         Destroy( p_var );
 }
 
-static void CleanupVar( void *var )
-{
-    Destroy( var );
-}
-
 void var_DestroyAll( vlc_object_t *obj )
 {
     vlc_object_internals_t *priv = vlc_internals( obj );
+    vlc_var_table_t *tab = &priv->var_table;
 
-    tdestroy( priv->var_root, CleanupVar );
-    priv->var_root = NULL;
+    for( size_t i = 0; i < tab->i_size; i++ )
+        for( variable_t *p_var = tab->pp_buckets[i], *p_next; p_var != NULL;
+             p_var = p_next )
+        {
+            p_next = p_var->p_hnext;
+            Destroy( p_var );
+        }
+    free( tab->pp_buckets );
+    tab->pp_buckets = NULL;
+    tab->i_size = 0;
+    tab->i_count = 0;
 }
 
 #undef var_Change
@@ -754,7 +1026,7 @@ int var_GetAndSet( vlc_object_t *p_this, const char *psz_name, int i_action,
     *p_val = p_var->val;
 
     /* Deal with callbacks.*/
-    TriggerCallback( p_this, p_var, psz_name, oldval );
+    DispatchCallback( p_this, p_var, psz_name, oldval );
 
     vlc_mutex_unlock( &p_priv->var_lock );
     return VLC_SUCCESS;
@@ -826,7 +1098,7 @@ int var_SetChecked( vlc_object_t *p_this, const char *psz_name,
     p_var->val = val;
 
     /* Deal with callbacks */
-    TriggerCallback( p_this, p_var, psz_name, oldval );
+    DispatchCallback( p_this, p_var, psz_name, oldval );
 
     /* Free data if needed */
     p_var->ops->pf_free( &oldval );
@@ -1052,7 +1324,7 @@ void var_TriggerCallback( vlc_object_t *p_this, const char *psz_name )
 
         /* Deal with callbacks. Tell we're in a callback, release the lock,
          * call stored functions, retake the lock. */
-        TriggerCallback( p_this, p_var, psz_name, p_var->val );
+        DispatchCallback( p_this, p_var, psz_name, p_var->val );
     }
     vlc_mutex_unlock( &p_priv->var_lock );
 }
@@ -1373,13 +1645,8 @@ void var_FreeList( vlc_value_t *p_val, vlc_value_t *p_val2 )
     }
 }
 
-static void DumpVariable(const void *data, const VISIT which, const int depth)
+static void DumpVariable(const variable_t *var)
 {
-    if (which != postorder && which != leaf)
-        return;
-    (void) depth;
-
-    const variable_t *var = *(const variable_t **)data;
     const char *typename = "unknown";
 
     switch (var->i_type & VLC_VAR_TYPE)
@@ -1434,10 +1701,15 @@ static void DumpVariable(const void *data, const VISIT which, const int depth)
 
 void DumpVariables(vlc_object_t *obj)
 {
+    vlc_var_table_t *tab = &vlc_internals(obj)->var_table;
+
     vlc_mutex_lock(&vlc_internals(obj)->var_lock);
-    if (vlc_internals(obj)->var_root == NULL)
+    if (tab->i_count == 0)
         puts(" `-o No variables");
     else
-        twalk(vlc_internals(obj)->var_root, DumpVariable);
+        for (size_t i = 0; i < tab->i_size; i++)
+            for (const variable_t *var = tab->pp_buckets[i]; var != NULL;
+                 var = var->p_hnext)
+                DumpVariable(var);
     vlc_mutex_unlock(&vlc_internals(obj)->var_lock);
 }
@@ -30,12 +30,27 @@
  */
 typedef struct vlc_object_internals vlc_object_internals_t;
 
+/**
+ * Hash table of object variables, keyed on the pre-hashed variable name.
+ */
+typedef struct vlc_var_table
+{
+    struct variable_t **pp_buckets; /* chains, lazily allocated */
+    size_t              i_size;     /* bucket count (power of two) */
+    size_t              i_count;    /* number of variables */
+} vlc_var_table_t;
+
 struct vlc_object_internals
 {
     char           *psz_name; /* given name */
 
+    /* Name index chaining, guarded by name_lock (objects.c);
+     * only used while psz_name is non-NULL */
+    vlc_object_internals_t *name_next;
+    vlc_object_internals_t *name_prev;
+
     /* Object variables */
-    void           *var_root;
+    vlc_var_table_t var_table;
     vlc_mutex_t     var_lock;
     vlc_cond_t      var_wait;
 
@@ -34,7 +34,11 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <unistd.h>
+#include <fcntl.h>
 #include <assert.h>
+#ifdef HAVE_MMAP
+# include <sys/mman.h>
+#endif
 
 #include <vlc_common.h>
 #include "libvlc.h"
@@ -45,6 +49,7 @@
 #include "config/configuration.h"
 
 #include <vlc_fs.h>
+#include <vlc_hash.h>
 
 #include "modules/modules.h"
 
@@ -55,7 +60,7 @@
 #ifdef HAVE_DYNAMIC_PLUGINS
 /* Sub-version number
  * (only used to avoid breakage in dev version when cache structure changes) */
-#define CACHE_SUBVERSION_NUM 23
+#define CACHE_SUBVERSION_NUM 24
 
 /* Cache filename */
 #define CACHE_NAME "plugins.dat"
@@ -76,8 +81,34 @@ void CacheDelete( vlc_object_t *obj, const char *dir )
     free( path );
 }
 
+/**
+ * In-memory cursor over the whole cache file.
+ *
+ * The cache file is mapped (or slurped) once, then decoded from memory:
+ * this avoids one read(2)/stdio round-trip per field, which dominates
+ * cold-start time when hundreds of modules are described in the cache.
+ */
+typedef struct
+{
+    const uint8_t *buf;  /**< next byte to decode */
+    size_t left;         /**< remaining bytes */
+    void *base;          /**< mapping/allocation base address */
+    size_t length;       /**< total file length */
+    bool mapped;         /**< true if base must be munmap()ed */
+} vlc_cache_reader_t;
+
+static int CacheRead (vlc_cache_reader_t *r, void *buf, size_t len)
+{
+    if (r->left < len)
+        return -1;
+    memcpy (buf, r->buf, len);
+    r->buf += len;
+    r->left -= len;
+    return 0;
+}
+
 #define LOAD_IMMEDIATE(a) \
-    if (fread (&(a), sizeof (char), sizeof (a), file) != sizeof (a)) \
+    if (CacheRead (file, &(a), sizeof (a))) \
         goto error
 #define LOAD_FLAG(a) \
     do { \
@@ -88,7 +119,7 @@ void CacheDelete( vlc_object_t *obj, const char *dir )
         (a) = b; \
     } while (0)
 
-static int CacheLoadString (char **p, FILE *file)
+static int CacheLoadString (char **p, vlc_cache_reader_t *file)
 {
     char *psz = NULL;
     uint16_t size;
@@ -105,7 +136,7 @@ error:
         psz = malloc (size+1);
         if (unlikely(psz == NULL))
             goto error;
-        if (fread (psz, 1, size, file) != size)
+        if (CacheRead (file, psz, size))
         {
             free (psz);
             goto error;
@@ -119,7 +150,7 @@ error:
 #define LOAD_STRING(a) \
     if (CacheLoadString (&(a), file)) goto error
 
-static int CacheLoadConfig (module_config_t *cfg, FILE *file)
+static int CacheLoadConfig (module_config_t *cfg, vlc_cache_reader_t *file)
 {
     LOAD_IMMEDIATE (cfg->i_type);
     LOAD_IMMEDIATE (cfg->i_short);
@@ -182,7 +213,7 @@ error:
     return -1; /* FIXME: leaks */
 }
 
-static int CacheLoadModuleConfig (module_t *module, FILE *file)
+static int CacheLoadModuleConfig (module_t *module, vlc_cache_reader_t *file)
 {
     uint16_t lines;
 
@@ -214,7 +245,7 @@ error:
     return -1; /* FIXME: leaks */
 }
 
-static module_t *CacheLoadModule (FILE *file)
+static module_t *CacheLoadModule (vlc_cache_reader_t *file)
 {
     module_t *module = vlc_module_create (NULL);
     if (unlikely(module == NULL))
@@ -288,11 +319,87 @@ error:
  * actually load the dynamically loadable module.
  * This allows us to only fully load plugins when they are actually used.
  */
+/**
+ * Maps (or failing that, reads) a whole cache file in memory.
+ */
+static int CacheReaderOpen( vlc_cache_reader_t *file, const char *path )
+{
+    int fd = vlc_open( path, O_RDONLY );
+    if( fd == -1 )
+        return -1;
+
+    struct stat st;
+    if( fstat( fd, &st ) || !S_ISREG( st.st_mode )
+     || (uintmax_t)st.st_size >= SIZE_MAX )
+    {
+        close( fd );
+        errno = EINVAL;
+        return -1;
+    }
+
+    file->length = st.st_size;
+    file->left = st.st_size;
+    file->mapped = false;
+    file->base = NULL;
+
+#ifdef HAVE_MMAP
+    if( file->length > 0 )
+    {
+        void *addr = mmap( NULL, file->length, PROT_READ, MAP_PRIVATE, fd,
+                           0 );
+        if( addr != MAP_FAILED )
+        {
+# ifdef POSIX_MADV_WILLNEED
+            posix_madvise( addr, file->length, POSIX_MADV_WILLNEED );
+# endif
+            file->base = addr;
+            file->mapped = true;
+        }
+    }
+#endif
+    if( !file->mapped )
+    {   /* No usable mmap(): fall back to reading the file in one go */
+        file->base = malloc( file->length ? file->length : 1 );
+        if( file->base == NULL )
+        {
+            close( fd );
+            return -1;
+        }
+        for( size_t i = 0; i < file->length; )
+        {
+            ssize_t val = read( fd, ((char *)file->base) + i,
+                                file->length - i );
+            if( val <= 0 )
+            {
+                free( file->base );
+                close( fd );
+                return -1;
+            }
+            i += val;
+        }
+    }
+    file->buf = file->base;
+    close( fd );
+    return 0;
+}
+
+static void CacheReaderClose( vlc_cache_reader_t *file )
+{
+#ifdef HAVE_MMAP
+    if( file->mapped )
+    {
+        munmap( file->base, file->length );
+        return;
+    }
+#endif
+    free( file->base );
+}
+
 size_t CacheLoad( vlc_object_t *p_this, const char *dir, module_cache_t **r )
 {
     char *psz_filename;
-    FILE *file;
-    int i_size, i_read;
+    vlc_cache_reader_t reader, *const file = &reader;
+    int i_size;
     char p_cachestring[sizeof(CACHE_STRING)];
     int32_t i_marker;
 
@@ -304,8 +411,7 @@ size_t CacheLoad( vlc_object_t *p_this, const char *dir, module_cache_t **r )
 
     msg_Dbg( p_this, "loading plugins cache file %s", psz_filename );
 
-    file = vlc_fopen( psz_filename, "rb" );
-    if( !file )
+    if( CacheReaderOpen( file, psz_filename ) )
     {
         msg_Warn( p_this, "cannot read %s: %s", psz_filename,
                   vlc_strerror_c(errno) );
@@ -314,14 +420,33 @@ size_t CacheLoad( vlc_object_t *p_this, const char *dir, module_cache_t **r )
     }
     free( psz_filename );
 
+    /* Check the whole file against its trailing content hash before the
+     * decoder below chews on it, so a truncated or corrupted cache is
+     * rejected as a whole rather than mis-parsed. */
+    uint64_t i_hash;
+    if( file->length < sizeof (i_hash) )
+    {
+        msg_Warn( p_this, "This doesn't look like a valid plugins cache" );
+        CacheReaderClose( file );
+        return 0;
+    }
+    memcpy( &i_hash, (const uint8_t *)file->base + file->length
+                     - sizeof (i_hash), sizeof (i_hash) );
+    if( vlc_hash64( file->base, file->length - sizeof (i_hash) ) != i_hash )
+    {
+        msg_Warn( p_this, "This doesn't look like a valid plugins cache "
+                  "(corrupted content)" );
+        CacheReaderClose( file );
+        return 0;
+    }
+
     /* Check the file is a plugins cache */
     i_size = sizeof(CACHE_STRING) - 1;
-    i_read = fread( p_cachestring, 1, i_size, file );
-    if( i_read != i_size ||
+    if( CacheRead( file, p_cachestring, i_size ) ||
         memcmp( p_cachestring, CACHE_STRING, i_size ) )
     {
         msg_Warn( p_this, "This doesn't look like a valid plugins cache" );
-        fclose( file );
+        CacheReaderClose( file );
         return 0;
     }
 
@@ -329,50 +454,51 @@ size_t CacheLoad( vlc_object_t *p_this, const char *dir, module_cache_t **r )
     /* Check for distribution specific version */
     char p_distrostring[sizeof( DISTRO_VERSION )];
     i_size = sizeof( DISTRO_VERSION ) - 1;
-    i_read = fread( p_distrostring, 1, i_size, file );
-    if( i_read != i_size ||
+    if( CacheRead( file, p_distrostring, i_size ) ||
         memcmp( p_distrostring, DISTRO_VERSION, i_size ) )
     {
         msg_Warn( p_this, "This doesn't look like a valid plugins cache" );
-        fclose( file );
+        CacheReaderClose( file );
         return 0;
     }
 #endif
 
     /* Check sub-version number */
-    i_read = fread( &i_marker, 1, sizeof(i_marker), file );
-    if( i_read != sizeof(i_marker) || i_marker != CACHE_SUBVERSION_NUM )
+    if( CacheRead( file, &i_marker, sizeof(i_marker) ) ||
+        i_marker != CACHE_SUBVERSION_NUM )
     {
         msg_Warn( p_this, "This doesn't look like a valid plugins cache "
                   "(corrupted header)" );
-        fclose( file );
+        CacheReaderClose( file );
         return 0;
     }
 
     /* Check header marker */
-    i_read = fread( &i_marker, 1, sizeof(i_marker), file );
-    if( i_read != sizeof(i_marker) ||
-        i_marker != ftell( file ) - (int)sizeof(i_marker) )
+    if( CacheRead( file, &i_marker, sizeof(i_marker) ) ||
+        i_marker != (int32_t)(file->length - file->left
+                              - sizeof(i_marker)) )
     {
         msg_Warn( p_this, "This doesn't look like a valid plugins cache "
                   "(corrupted header)" );
-        fclose( file );
+        CacheReaderClose( file );
         return 0;
     }
 
+    /* Keep the trailing hash out of the entries loop */
+    file->left -= sizeof (i_hash);
+
     module_cache_t *cache = NULL;
     size_t count = 0;
     char *path = NULL;
 
     for (;;)
     {
+        if (file->left == 0)
+            break;
+
         module_t *module = CacheLoadModule (file);
         if (module == NULL)
-        {
-            if (feof (file))
-                break;
             goto error;
-        }
 
         struct stat st;
 
@@ -389,19 +515,17 @@ size_t CacheLoad( vlc_object_t *p_this, const char *dir, module_cache_t **r )
         /* TODO: deal with errors */
     }
 
-    fclose( file );
+    CacheReaderClose( file );
 
     *r = cache;
     return count;
 
 error:
     free( path );
-    if (ferror (file))
-        msg_Err(p_this, "plugins cache read error: %s", vlc_strerror_c(errno));
     msg_Warn( p_this, "plugins cache not loaded (corrupted)" );
 
     /* TODO: cleanup */
-    fclose( file );
+    CacheReaderClose( file );
     return 0;
 }
 
@@ -491,6 +615,38 @@ error:
 
 static int CacheSaveBank( FILE *file, const module_cache_t *, size_t );
 
+/**
+ * Appends a hash of everything written so far, verified by CacheLoad()
+ * before any decoding takes place.
+ */
+static int CacheSaveHash( FILE *file, const char *path )
+{
+    struct vlc_hash64_s h;
+    unsigned char buf[4096];
+    size_t len;
+
+    if (fflush (file))
+        return -1;
+
+    FILE *rd = vlc_fopen (path, "rb");
+    if (rd == NULL)
+        return -1;
+
+    vlc_hash64_Init (&h, 0);
+    while ((len = fread (buf, 1, sizeof (buf), rd)) > 0)
+        vlc_hash64_Add (&h, buf, len);
+
+    int err = ferror (rd);
+    fclose (rd);
+    if (err)
+        return -1;
+
+    uint64_t hash = vlc_hash64_Finish (&h);
+    if (fwrite (&hash, sizeof (hash), 1, file) != 1)
+        return -1;
+    return 0;
+}
+
 /**
  * Saves a module cache to disk, and release cache data from memory.
  */
@@ -515,7 +671,7 @@ void CacheSave (vlc_object_t *p_this, const char *dir,
         goto out;
     }
 
-    if (CacheSaveBank (file, entries, n))
+    if (CacheSaveBank (file, entries, n) || CacheSaveHash (file, tmpname))
     {
         msg_Warn (p_this, "cannot write %s: %s", tmpname,
                   vlc_strerror_c(errno));
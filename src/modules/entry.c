@@ -71,6 +71,10 @@ module_t *vlc_module_create (module_t *parent)
     module->i_score = (parent != NULL) ? parent->i_score : 1;
     module->b_loaded = false;
     module->b_unloadable = parent == NULL;
+    atomic_init (&module->stats.probes, 0);
+    atomic_init (&module->stats.successes, 0);
+    atomic_init (&module->stats.total_us, 0);
+    atomic_init (&module->stats.worst_us, 0);
     module->pf_activate = NULL;
     module->pf_deactivate = NULL;
     module->p_config = NULL;
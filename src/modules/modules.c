@@ -169,6 +169,9 @@ static bool module_match_name (const module_t *m, const char *name)
      return false;
 }
 
+/* Probes taking longer than this get a debug line of their own. */
+#define MODULE_PROBE_SLOW (CLOCK_FREQ / 10)
+
 static int module_load (vlc_object_t *obj, module_t *m,
                         vlc_activate_t init, va_list args)
 {
@@ -180,10 +183,32 @@ static int module_load (vlc_object_t *obj, module_t *m,
     if (m->pf_activate != NULL)
     {
         va_list ap;
+        mtime_t duration = mdate ();
 
         va_copy (ap, args);
         ret = init (m->pf_activate, ap);
         va_end (ap);
+
+        duration = mdate () - duration;
+        atomic_fetch_add_explicit (&m->stats.probes, 1, memory_order_relaxed);
+        if (ret == VLC_SUCCESS)
+            atomic_fetch_add_explicit (&m->stats.successes, 1,
+                                       memory_order_relaxed);
+        atomic_fetch_add_explicit (&m->stats.total_us, duration,
+                                   memory_order_relaxed);
+
+        uint_fast64_t worst = atomic_load_explicit (&m->stats.worst_us,
+                                                    memory_order_relaxed);
+        while (worst < (uint_fast64_t)duration
+            && !atomic_compare_exchange_weak_explicit (&m->stats.worst_us,
+                                                       &worst, duration,
+                                                       memory_order_relaxed,
+                                                       memory_order_relaxed));
+
+        if (duration > MODULE_PROBE_SLOW)
+            msg_Dbg (obj, "slow %s probe: \"%s\" took %"PRId64" us",
+                     module_get_capability (m), module_get_object (m),
+                     duration);
     }
     return ret;
 }
@@ -325,6 +350,46 @@ done:
 }
 
 
+#undef module_LogProbeStats
+/**
+ * Logs the probe accounting gathered by module_load() for every module that
+ * was probed at least once: probe count, success count, cumulated and worst
+ * probe durations. Sorted output is left to whoever reads the log; the point
+ * is to spot modules that keep getting probed, keep failing, and are slow
+ * about it, so they can be deprioritized in the configuration.
+ *
+ * \param obj object to log through
+ */
+void module_LogProbeStats (vlc_object_t *obj)
+{
+    size_t count;
+    module_t **list = module_list_get (&count);
+
+    if (unlikely(list == NULL))
+        return;
+
+    msg_Dbg (obj, "module probe statistics:");
+    for (size_t i = 0; i < count; i++)
+    {
+        module_t *m = list[i];
+        unsigned probes = atomic_load_explicit (&m->stats.probes,
+                                                memory_order_relaxed);
+        if (probes == 0)
+            continue;
+
+        msg_Dbg (obj, "  %s \"%s\": %u probes, %u successes, "
+                 "%"PRIu64" us total, %"PRIu64" us worst",
+                 module_get_capability (m), module_get_object (m), probes,
+                 atomic_load_explicit (&m->stats.successes,
+                                       memory_order_relaxed),
+                 (uint64_t)atomic_load_explicit (&m->stats.total_us,
+                                                 memory_order_relaxed),
+                 (uint64_t)atomic_load_explicit (&m->stats.worst_us,
+                                                 memory_order_relaxed));
+    }
+    module_list_free (list);
+}
+
 /**
  * Deinstantiates a module.
  * \param module the module pointer as returned by vlc_module_load()
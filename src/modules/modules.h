@@ -24,6 +24,8 @@
 #ifndef LIBVLC_MODULES_H
 # define LIBVLC_MODULES_H 1
 
+# include <vlc_atomic.h>
+
 typedef struct module_cache_t module_cache_t;
 
 /*****************************************************************************
@@ -79,6 +81,16 @@ struct module_t
     bool          b_loaded;        /* Set to true if the dll is loaded */
     bool b_unloadable;                        /**< Can we be dlclosed? */
 
+    /* Probe accounting, updated by module_load(). Atomic as modules can be
+     * probed from several threads at once. */
+    struct
+    {
+        atomic_uint          probes;       /**< Number of probe attempts */
+        atomic_uint          successes;    /**< Number of successful probes */
+        atomic_uint_fast64_t total_us;     /**< Cumulated probe time */
+        atomic_uint_fast64_t worst_us;     /**< Worst single probe time */
+    } stats;
+
     /* Callbacks */
     void *pf_activate;
     void *pf_deactivate;
@@ -108,6 +120,8 @@ void module_InitBank (void);
 size_t module_LoadPlugins( vlc_object_t * );
 #define module_LoadPlugins(a) module_LoadPlugins(VLC_OBJECT(a))
 void module_EndBank (bool);
+void module_LogProbeStats( vlc_object_t * );
+#define module_LogProbeStats(a) module_LogProbeStats(VLC_OBJECT(a))
 int module_Map (vlc_object_t *, module_t *);
 
 ssize_t module_list_cap (module_t ***, const char *);
@@ -36,6 +36,9 @@
 
 #include <sys/types.h>
 #include <vlc_network.h>
+#include <vlc_interrupt.h>
+
+#include "../libvlc.h" /* vlc_clone_detach() */
 
 #ifndef AF_UNSPEC
 #   define AF_UNSPEC   0
@@ -123,3 +126,293 @@ int vlc_getaddrinfo (const char *node, unsigned port,
 
     return getaddrinfo (node, servname, hints, res);
 }
+
+/**
+ * Releases a list of socket addresses allocated by vlc_getaddrinfo_i11e().
+ */
+void vlc_freeaddrinfo (struct addrinfo *res)
+{
+    while (res != NULL)
+    {
+        struct addrinfo *next = res->ai_next;
+
+        free (res->ai_canonname);
+        free (res);
+        res = next;
+    }
+}
+
+/**
+ * Duplicates a getaddrinfo() result list into separately allocated entries,
+ * releasable with vlc_freeaddrinfo() regardless of which C run-time
+ * allocated the original.
+ */
+static struct addrinfo *CopyAddrInfo (const struct addrinfo *src)
+{
+    struct addrinfo *head = NULL, **pp = &head;
+
+    for (; src != NULL; src = src->ai_next)
+    {
+        struct addrinfo *ai = malloc (sizeof (*ai) + src->ai_addrlen);
+        if (unlikely(ai == NULL))
+            break;
+
+        ai->ai_flags = src->ai_flags;
+        ai->ai_family = src->ai_family;
+        ai->ai_socktype = src->ai_socktype;
+        ai->ai_protocol = src->ai_protocol;
+        ai->ai_addrlen = src->ai_addrlen;
+        ai->ai_addr = (struct sockaddr *)(ai + 1);
+        memcpy (ai->ai_addr, src->ai_addr, src->ai_addrlen);
+        ai->ai_canonname = (src->ai_canonname != NULL)
+                           ? strdup (src->ai_canonname) : NULL;
+        ai->ai_next = NULL;
+
+        *pp = ai;
+        pp = &ai->ai_next;
+    }
+    return head;
+}
+
+/*
+ * Process-wide resolver cache. getaddrinfo() does not expose the DNS
+ * time-to-live, so entries are kept for a fixed conservative lifetime -
+ * long enough to cover a burst of connections to the same server, short
+ * enough to follow DNS-based load balancing.
+ */
+#define DNS_CACHE_TTL   (60 * CLOCK_FREQ)
+#define DNS_CACHE_SIZE  32
+
+struct dns_cache_entry
+{
+    char *node;
+    unsigned port;
+    int family;
+    int socktype;
+    int protocol;
+    int flags;
+    mtime_t expiry;
+    struct addrinfo *res;
+    struct dns_cache_entry *next;
+};
+
+static vlc_mutex_t dns_cache_lock = VLC_STATIC_MUTEX;
+static struct dns_cache_entry *dns_cache = NULL;
+static unsigned dns_cache_count = 0;
+
+static bool DnsCacheMatch (const struct dns_cache_entry *entry,
+                           const char *node, unsigned port,
+                           const struct addrinfo *hints)
+{
+    return !strcmp (entry->node, node) && entry->port == port
+        && entry->family == (hints ? hints->ai_family : AF_UNSPEC)
+        && entry->socktype == (hints ? hints->ai_socktype : 0)
+        && entry->protocol == (hints ? hints->ai_protocol : 0)
+        && entry->flags == (hints ? hints->ai_flags : 0);
+}
+
+static void DnsCacheEntryDelete (struct dns_cache_entry *entry)
+{
+    vlc_freeaddrinfo (entry->res);
+    free (entry->node);
+    free (entry);
+}
+
+static struct addrinfo *DnsCacheLookup (const char *node, unsigned port,
+                                        const struct addrinfo *hints)
+{
+    struct addrinfo *res = NULL;
+    mtime_t now = mdate ();
+
+    vlc_mutex_lock (&dns_cache_lock);
+    for (struct dns_cache_entry *entry = dns_cache, **pp = &dns_cache;
+         entry != NULL; entry = *pp)
+    {
+        if (entry->expiry <= now)
+        {   /* stale entry - drop it */
+            *pp = entry->next;
+            dns_cache_count--;
+            DnsCacheEntryDelete (entry);
+            continue;
+        }
+        if (res == NULL && DnsCacheMatch (entry, node, port, hints))
+            res = CopyAddrInfo (entry->res);
+        pp = &entry->next;
+    }
+    vlc_mutex_unlock (&dns_cache_lock);
+    return res;
+}
+
+static void DnsCacheStore (const char *node, unsigned port,
+                           const struct addrinfo *hints,
+                           const struct addrinfo *res)
+{
+    struct dns_cache_entry *entry = malloc (sizeof (*entry));
+    if (unlikely(entry == NULL))
+        return;
+
+    entry->node = strdup (node);
+    entry->res = CopyAddrInfo (res);
+    if (unlikely(entry->node == NULL || entry->res == NULL))
+    {
+        DnsCacheEntryDelete (entry);
+        return;
+    }
+    entry->port = port;
+    entry->family = hints ? hints->ai_family : AF_UNSPEC;
+    entry->socktype = hints ? hints->ai_socktype : 0;
+    entry->protocol = hints ? hints->ai_protocol : 0;
+    entry->flags = hints ? hints->ai_flags : 0;
+    entry->expiry = mdate () + DNS_CACHE_TTL;
+
+    vlc_mutex_lock (&dns_cache_lock);
+    entry->next = dns_cache;
+    dns_cache = entry;
+    if (++dns_cache_count > DNS_CACHE_SIZE)
+    {   /* evict the oldest entry */
+        struct dns_cache_entry **pp = &dns_cache;
+        while ((*pp)->next != NULL)
+            pp = &(*pp)->next;
+        struct dns_cache_entry *last = *pp;
+        *pp = NULL;
+        dns_cache_count--;
+        DnsCacheEntryDelete (last);
+    }
+    vlc_mutex_unlock (&dns_cache_lock);
+}
+
+struct gai_request
+{
+    char *node;
+    unsigned port;
+    struct addrinfo hints;
+    bool hinted;
+
+    struct addrinfo *res;
+    int val;
+    bool finished;
+    bool detached;
+    vlc_mutex_t lock;
+    vlc_sem_t done;
+};
+
+static void *gai_thread (void *data)
+{
+    struct gai_request *req = data;
+    struct addrinfo *res = NULL;
+    int val = vlc_getaddrinfo (req->node, req->port,
+                               req->hinted ? &req->hints : NULL, &res);
+
+    vlc_mutex_lock (&req->lock);
+    if (req->detached)
+    {   /* the requester gave up - nobody will ever read the result */
+        vlc_mutex_unlock (&req->lock);
+        if (val == 0)
+            freeaddrinfo (res);
+        vlc_mutex_destroy (&req->lock);
+        vlc_sem_destroy (&req->done);
+        free (req->node);
+        free (req);
+        return NULL;
+    }
+    req->res = res;
+    req->val = val;
+    req->finished = true;
+    vlc_mutex_unlock (&req->lock);
+    vlc_sem_post (&req->done);
+    return NULL;
+}
+
+/**
+ * Interruptible host name resolution with caching.
+ *
+ * Behaves like vlc_getaddrinfo(), except that the blocking system resolver
+ * runs on a helper thread, so that the call can be aborted through the
+ * calling thread interruption context (see vlc_interrupt.h), and that
+ * successful lookups are kept in a process-wide cache for a short while.
+ *
+ * @return 0 on success, a getaddrinfo() error otherwise.
+ * On success, *res must be freed with vlc_freeaddrinfo()
+ * (<b>not</b> freeaddrinfo()).
+ */
+int vlc_getaddrinfo_i11e (const char *node, unsigned port,
+                          const struct addrinfo *hints, struct addrinfo **res)
+{
+    struct addrinfo *sys;
+    int val;
+
+    /* Numeric and local lookups do not hit the DNS: resolve in place */
+    if (node == NULL || (hints != NULL && (hints->ai_flags & AI_NUMERICHOST)))
+    {
+        val = vlc_getaddrinfo (node, port, hints, &sys);
+        goto convert;
+    }
+
+    *res = DnsCacheLookup (node, port, hints);
+    if (*res != NULL)
+        return 0;
+
+    struct gai_request *req = malloc (sizeof (*req));
+    if (unlikely(req == NULL))
+        return EAI_MEMORY;
+
+    req->node = strdup (node);
+    if (unlikely(req->node == NULL))
+    {
+        free (req);
+        return EAI_MEMORY;
+    }
+    req->port = port;
+    req->hinted = hints != NULL;
+    if (hints != NULL)
+        req->hints = *hints;
+    req->res = NULL;
+    req->val = 0;
+    req->finished = false;
+    req->detached = false;
+    vlc_mutex_init (&req->lock);
+    vlc_sem_init (&req->done, 0);
+
+    if (vlc_clone_detach (NULL, gai_thread, req, VLC_THREAD_PRIORITY_LOW))
+    {   /* no thread - fall back to a blocking lookup */
+        vlc_mutex_destroy (&req->lock);
+        vlc_sem_destroy (&req->done);
+        free (req->node);
+        free (req);
+
+        val = vlc_getaddrinfo (node, port, hints, &sys);
+        if (val == 0)
+            DnsCacheStore (node, port, hints, sys);
+        goto convert;
+    }
+
+    if (vlc_sem_wait_i11e (&req->done) != 0)
+    {
+        vlc_mutex_lock (&req->lock);
+        if (!req->finished)
+        {   /* still resolving - leave the request to the helper thread */
+            req->detached = true;
+            vlc_mutex_unlock (&req->lock);
+            return EAI_AGAIN;
+        }
+        vlc_mutex_unlock (&req->lock);
+        /* too late to abort - use the result */
+    }
+
+    sys = req->res;
+    val = req->val;
+    vlc_mutex_destroy (&req->lock);
+    vlc_sem_destroy (&req->done);
+    free (req->node);
+    free (req);
+
+    if (val == 0)
+        DnsCacheStore (node, port, hints, sys);
+convert:
+    if (val)
+        return val;
+
+    *res = CopyAddrInfo (sys);
+    freeaddrinfo (sys);
+    return (*res != NULL) ? 0 : EAI_MEMORY;
+}
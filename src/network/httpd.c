@@ -49,11 +49,15 @@
 #ifdef HAVE_POLL
 # include <poll.h>
 #endif
+#ifdef HAVE_EPOLL_CREATE1
+# include <sys/epoll.h>
+#endif
 
 #if defined(_WIN32)
 #   include <winsock2.h>
 #else
 #   include <sys/socket.h>
+#   include <sys/uio.h>
 #endif
 
 #if defined(_WIN32)
@@ -78,6 +82,9 @@ struct httpd_host_t
     int         *fds;
     unsigned     nfd;
     unsigned     port;
+#ifdef HAVE_EPOLL_CREATE1
+    int          evfd; /**< epoll instance watching all host sockets */
+#endif
 
     vlc_thread_t thread;
     vlc_mutex_t lock;
@@ -149,6 +156,9 @@ struct httpd_client_t
 
     bool    b_stream_mode;
     uint8_t i_state;
+#ifdef HAVE_EPOLL_CREATE1
+    short   i_epoll_events; /**< Events currently registered with epoll */
+#endif
 
     mtime_t i_activity_date;
     mtime_t i_activity_timeout;
@@ -960,6 +970,9 @@ static httpd_host_t *httpd_HostCreate(vlc_object_t *p_this,
     vlc_cond_init(&host->wait);
     host->i_ref = 1;
 
+#ifdef HAVE_EPOLL_CREATE1
+    host->evfd = -1;
+#endif
     host->fds = net_ListenTCP(p_this, url.psz_host, port);
     if (!host->fds) {
         msg_Err(p_this, "cannot create socket(s) for HTTP host");
@@ -967,6 +980,23 @@ static httpd_host_t *httpd_HostCreate(vlc_object_t *p_this,
     }
     for (host->nfd = 0; host->fds[host->nfd] != -1; host->nfd++);
 
+#ifdef HAVE_EPOLL_CREATE1
+    host->evfd = epoll_create1(0);
+    if (host->evfd == -1) {
+        msg_Err(p_this, "cannot create epoll instance: %s",
+                vlc_strerror_c(errno));
+        goto error;
+    }
+    /* The listening sockets are registered once and for all */
+    for (unsigned i = 0; i < host->nfd; i++) {
+        struct epoll_event ev = {
+            .events = EPOLLIN,
+            .data.ptr = &host->fds[i],
+        };
+        epoll_ctl(host->evfd, EPOLL_CTL_ADD, host->fds[i], &ev);
+    }
+#endif
+
     host->port     = port;
     host->i_url    = 0;
     host->url      = NULL;
@@ -993,6 +1023,10 @@ error:
     vlc_mutex_unlock(&httpd.mutex);
 
     if (host) {
+#ifdef HAVE_EPOLL_CREATE1
+        if (host->evfd != -1)
+            close(host->evfd);
+#endif
         net_ListenClose(host->fds);
         vlc_cond_destroy(&host->wait);
         vlc_mutex_destroy(&host->lock);
@@ -1039,6 +1073,9 @@ void httpd_HostDelete(httpd_host_t *host)
     TAB_CLEAN(host->i_client, host->client);
 
     vlc_tls_Delete(host->p_tls);
+#ifdef HAVE_EPOLL_CREATE1
+    close(host->evfd);
+#endif
     net_ListenClose(host->fds);
     vlc_cond_destroy(&host->wait);
     vlc_mutex_destroy(&host->lock);
@@ -1240,6 +1277,9 @@ static httpd_client_t *httpd_ClientNew(int fd, vlc_tls_t *p_tls, mtime_t now)
     cl->fd      = fd;
     cl->url     = NULL;
     cl->p_tls = p_tls;
+#ifdef HAVE_EPOLL_CREATE1
+    cl->i_epoll_events = 0;
+#endif
 
     httpd_ClientInit(cl, now);
     if (p_tls)
@@ -1276,6 +1316,51 @@ ssize_t httpd_NetSend (httpd_client_t *cl, const uint8_t *p, size_t i_len)
     return val;
 }
 
+/**
+ * Sends a scatter/gather array on a client connection, with the same
+ * semantics as writev(): the return value only accounts for the bytes
+ * actually written, which may stop short of the full array.
+ */
+static
+ssize_t httpd_NetWritev (httpd_client_t *cl, const struct iovec *iov,
+                         unsigned count)
+{
+    vlc_tls_t *p_tls = cl->p_tls;
+    ssize_t val;
+
+    if (p_tls == NULL)
+    {
+        const struct msghdr msg =
+        {
+            .msg_iov = (struct iovec *)iov,
+            .msg_iovlen = count,
+        };
+
+        do
+            val = sendmsg (cl->fd, &msg, MSG_NOSIGNAL);
+        while (val == -1 && errno == EINTR);
+        return val;
+    }
+
+    /* TLS cannot gather across records: send the segments sequentially */
+    ssize_t total = 0;
+
+    for (unsigned i = 0; i < count; i++)
+    {
+        do
+            val = tls_Send (p_tls, iov[i].iov_base, iov[i].iov_len);
+        while (val == -1 && errno == EINTR);
+
+        if (val == -1)
+            return total ? total : -1;
+
+        total += val;
+        if ((size_t)val < iov[i].iov_len)
+            break;
+    }
+    return total;
+}
+
 
 static const struct
 {
@@ -1615,12 +1700,29 @@ static void httpd_ClientSend(httpd_client_t *cl)
         cl->i_buffer_size = (uint8_t*)p - cl->p_buffer;
     }
 
-    i_len = httpd_NetSend(cl, &cl->p_buffer[cl->i_buffer],
-                           cl->i_buffer_size - cl->i_buffer);
+    struct iovec iov[2];
+    unsigned i_iov = 0;
+
+    iov[i_iov].iov_base = &cl->p_buffer[cl->i_buffer];
+    iov[i_iov].iov_len = cl->i_buffer_size - cl->i_buffer;
+    i_iov++;
+
+    /* Gather an already available body with the (remainder of the) header,
+     * so that short answers leave in a single packet */
+    if (cl->answer.i_body > 0) {
+        iov[i_iov].iov_base = cl->answer.p_body;
+        iov[i_iov].iov_len = cl->answer.i_body;
+        i_iov++;
+    }
+
+    i_len = httpd_NetWritev(cl, iov, i_iov);
     if (i_len >= 0) {
         cl->i_buffer += i_len;
 
         if (cl->i_buffer >= cl->i_buffer_size) {
+            /* Bytes written past the current buffer came from the body */
+            int i_body_sent = cl->i_buffer - cl->i_buffer_size;
+
             if (cl->answer.i_body == 0  && cl->answer.i_body_offset > 0) {
                 /* catch more body data */
                 int     i_msg = cl->query.i_type;
@@ -1638,7 +1740,7 @@ static void httpd_ClientSend(httpd_client_t *cl)
                 free(cl->p_buffer);
                 cl->p_buffer = cl->answer.p_body;
                 cl->i_buffer_size = cl->answer.i_body;
-                cl->i_buffer = 0;
+                cl->i_buffer = i_body_sent;
 
                 cl->answer.i_body = 0;
                 cl->answer.p_body = NULL;
@@ -1709,8 +1811,52 @@ auth_failed:
     return false;
 }
 
+/* Accepts a pending connection on a listening socket */
+static void httpd_HostAccept(httpd_host_t *host, int lfd, mtime_t now)
+{
+    int fd = vlc_accept (lfd, NULL, NULL, true);
+    if (fd == -1)
+        return;
+    setsockopt (fd, SOL_SOCKET, SO_REUSEADDR,
+            &(int){ 1 }, sizeof(int));
+
+    vlc_tls_t *p_tls;
+
+    if (host->p_tls != NULL)
+    {
+        const char *alpn[] = { "http/1.1", NULL };
+
+        p_tls = vlc_tls_ServerSessionCreate(host->p_tls, fd, alpn);
+    }
+    else
+        p_tls = NULL;
+
+    httpd_client_t *cl = httpd_ClientNew(fd, p_tls, now);
+
+    TAB_APPEND(host->i_client, host->client, cl);
+}
+
+/* Performs the pending I/O of one client according to its state */
+static void httpd_ClientHandleEvent(httpd_host_t *host, httpd_client_t *cl,
+                                    mtime_t now)
+{
+    cl->i_activity_date = now;
+
+    switch (cl->i_state) {
+        case HTTPD_CLIENT_RECEIVING: httpd_ClientRecv(cl); break;
+        case HTTPD_CLIENT_SENDING:   httpd_ClientSend(cl); break;
+        case HTTPD_CLIENT_TLS_HS_IN:
+        case HTTPD_CLIENT_TLS_HS_OUT:
+            httpd_ClientTlsHandshake(host, cl);
+            break;
+    }
+}
+
 static void httpdLoop(httpd_host_t *host)
 {
+#ifdef HAVE_EPOLL_CREATE1
+    struct epoll_event eventv[64];
+#else
     struct pollfd ufd[host->nfd + host->i_client];
     unsigned nfd;
     for (nfd = 0; nfd < host->nfd; nfd++) {
@@ -1718,6 +1864,7 @@ static void httpdLoop(httpd_host_t *host)
         ufd[nfd].events = POLLIN;
         ufd[nfd].revents = 0;
     }
+#endif
 
     /* add all socket that should be read/write and close dead connection */
     while (host->i_url <= 0) {
@@ -1743,21 +1890,17 @@ static void httpdLoop(httpd_host_t *host)
             continue;
         }
 
-        struct pollfd *pufd = ufd + nfd;
-        assert (pufd < ufd + (sizeof (ufd) / sizeof (ufd[0])));
-
-        pufd->fd = cl->fd;
-        pufd->events = pufd->revents = 0;
+        short events = 0;
 
         switch (cl->i_state) {
             case HTTPD_CLIENT_RECEIVING:
             case HTTPD_CLIENT_TLS_HS_IN:
-                pufd->events = POLLIN;
+                events = POLLIN;
                 break;
 
             case HTTPD_CLIENT_SENDING:
             case HTTPD_CLIENT_TLS_HS_OUT:
-                pufd->events = POLLOUT;
+                events = POLLOUT;
                 break;
 
             case HTTPD_CLIENT_RECEIVE_DONE: {
@@ -1966,16 +2109,50 @@ static void httpdLoop(httpd_host_t *host)
                 }
         }
 
-        if (pufd->events != 0)
+#ifdef HAVE_EPOLL_CREATE1
+        /* Re-arm the connection only when its interests changed, so idle
+         * rounds cost no system call at all for established clients */
+        if (events != cl->i_epoll_events) {
+            if (events == 0)
+                epoll_ctl(host->evfd, EPOLL_CTL_DEL, cl->fd, NULL);
+            else {
+                struct epoll_event ev = {
+                    .events = ((events & POLLIN) ? EPOLLIN : 0)
+                            | ((events & POLLOUT) ? EPOLLOUT : 0),
+                    .data.ptr = cl,
+                };
+                epoll_ctl(host->evfd, cl->i_epoll_events == 0
+                              ? EPOLL_CTL_ADD : EPOLL_CTL_MOD, cl->fd, &ev);
+            }
+            cl->i_epoll_events = events;
+        }
+        if (events == 0)
+            b_low_delay = true;
+#else
+        struct pollfd *pufd = ufd + nfd;
+        assert (pufd < ufd + (sizeof (ufd) / sizeof (ufd[0])));
+
+        pufd->fd = cl->fd;
+        pufd->events = events;
+        pufd->revents = 0;
+
+        if (events != 0)
             nfd++;
         else
             b_low_delay = true;
+#endif
     }
     vlc_mutex_unlock(&host->lock);
     vlc_restorecancel(canc);
 
     /* we will wait 20ms (not too big) if HTTPD_CLIENT_WAITING */
+#ifdef HAVE_EPOLL_CREATE1
+    int ret = epoll_wait(host->evfd, eventv,
+                         sizeof (eventv) / sizeof (eventv[0]),
+                         b_low_delay ? 20 : -1);
+#else
     int ret = poll(ufd, nfd, b_low_delay ? 20 : -1);
+#endif
 
     canc = vlc_savecancel();
     vlc_mutex_lock(&host->lock);
@@ -1991,8 +2168,21 @@ static void httpdLoop(httpd_host_t *host)
             return;
     }
 
-    /* Handle client sockets */
     now = mdate();
+
+#ifdef HAVE_EPOLL_CREATE1
+    /* Only the connections with pending events are visited */
+    for (int i = 0; i < ret; i++) {
+        void *p = eventv[i].data.ptr;
+
+        if (p >= (void *)host->fds && p < (void *)(host->fds + host->nfd))
+            /* Listening socket: new connection pending */
+            httpd_HostAccept(host, *(int *)p, now);
+        else
+            httpd_ClientHandleEvent(host, p, now);
+    }
+#else
+    /* Handle client sockets */
     nfd = host->nfd;
 
     for (int i_client = 0; i_client < host->i_client; i_client++) {
@@ -2007,21 +2197,11 @@ static void httpdLoop(httpd_host_t *host)
         if (pufd->revents == 0)
             continue; // no event received
 
-        cl->i_activity_date = now;
-
-        switch (cl->i_state) {
-            case HTTPD_CLIENT_RECEIVING: httpd_ClientRecv(cl); break;
-            case HTTPD_CLIENT_SENDING:   httpd_ClientSend(cl); break;
-            case HTTPD_CLIENT_TLS_HS_IN:
-            case HTTPD_CLIENT_TLS_HS_OUT:
-                httpd_ClientTlsHandshake(host, cl);
-                break;
-        }
+        httpd_ClientHandleEvent(host, cl, now);
     }
 
     /* Handle server sockets (accept new connections) */
     for (nfd = 0; nfd < host->nfd; nfd++) {
-        httpd_client_t *cl;
         int fd = ufd[nfd].fd;
 
         assert (fd == host->fds[nfd]);
@@ -2029,28 +2209,9 @@ static void httpdLoop(httpd_host_t *host)
         if (ufd[nfd].revents == 0)
             continue;
 
-        /* */
-        fd = vlc_accept (fd, NULL, NULL, true);
-        if (fd == -1)
-            continue;
-        setsockopt (fd, SOL_SOCKET, SO_REUSEADDR,
-                &(int){ 1 }, sizeof(int));
-
-        vlc_tls_t *p_tls;
-
-        if (host->p_tls != NULL)
-        {
-            const char *alpn[] = { "http/1.1", NULL };
-
-            p_tls = vlc_tls_ServerSessionCreate(host->p_tls, fd, alpn);
-        }
-        else
-            p_tls = NULL;
-
-        cl = httpd_ClientNew(fd, p_tls, now);
-
-        TAB_APPEND(host->i_client, host->client, cl);
+        httpd_HostAccept(host, fd, now);
     }
+#endif
 
     vlc_restorecancel(canc);
 }
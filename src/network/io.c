@@ -39,6 +39,9 @@
 #include <assert.h>
 
 #include <unistd.h>
+#ifndef _WIN32
+# include <sys/uio.h>
+#endif
 #ifdef HAVE_LINUX_DCCP_H
 /* TODO: use glibc instead of linux-kernel headers */
 # include <linux/dccp.h>
@@ -322,6 +325,71 @@ ssize_t (net_Write)(vlc_object_t *obj, int fd, const void *buf, size_t len)
     return written;
 }
 
+/**
+ * Writes data from a scatter/gather array to a socket.
+ * This blocks until all data is written or an error occurs. The segments are
+ * coalesced, so that consecutive buffers (e.g. a protocol header and its
+ * payload) do not need to be copied together before sending.
+ *
+ * This function is a cancellation point.
+ *
+ * @return the total number of bytes written, or -1 if an error occurs
+ * before any data is written.
+ */
+ssize_t (net_Writev)(vlc_object_t *obj, int fd, const struct iovec *iov,
+                     unsigned count)
+{
+    struct iovec iovbuf[count];
+    struct msghdr msg =
+    {
+        .msg_iov = iovbuf,
+        .msg_iovlen = count,
+    };
+    size_t written = 0;
+
+    memcpy(iovbuf, iov, count * sizeof (*iov));
+
+    while (msg.msg_iovlen > 0)
+    {
+        if (vlc_killed())
+        {
+            vlc_testcancel();
+            errno = EINTR;
+            return -1;
+        }
+
+        ssize_t val = vlc_sendmsg_i11e (fd, &msg, MSG_NOSIGNAL);
+        if (val == -1)
+        {
+            if (errno == EINTR || errno == EAGAIN)
+                continue;
+
+            msg_Err(obj, "write error: %s", vlc_strerror_c(errno));
+            return written ? (ssize_t)written : -1;
+        }
+
+        if (val == 0)
+            break;
+
+        written += val;
+        /* Skip the fully written segments... */
+        while (msg.msg_iovlen > 0 && (size_t)val >= msg.msg_iov->iov_len)
+        {
+            val -= msg.msg_iov->iov_len;
+            msg.msg_iov++;
+            msg.msg_iovlen--;
+        }
+        /* ...and advance within the partially written one, if any */
+        if (msg.msg_iovlen > 0)
+        {
+            msg.msg_iov->iov_base = ((char *)msg.msg_iov->iov_base) + val;
+            msg.msg_iov->iov_len -= val;
+        }
+    }
+
+    return written;
+}
+
 #undef net_Gets
 /**
  * Reads a line from a file descriptor.
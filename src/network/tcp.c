@@ -127,7 +127,7 @@ int net_Connect( vlc_object_t *p_this, const char *psz_host, int i_port,
         .ai_flags = AI_NUMERICSERV | AI_IDN,
     }, *res;
 
-    int val = vlc_getaddrinfo (psz_realhost, i_realport, &hints, &res);
+    int val = vlc_getaddrinfo_i11e (psz_realhost, i_realport, &hints, &res);
     if (val)
     {
         msg_Err (p_this, "cannot resolve %s port %d : %s", psz_realhost,
@@ -205,7 +205,7 @@ next_ai: /* failure */
         net_Close( fd );
     }
 
-    freeaddrinfo( res );
+    vlc_freeaddrinfo( res );
 
     if( i_handle == -1 )
         return -1;
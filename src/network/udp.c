@@ -37,6 +37,7 @@
 #include <assert.h>
 
 #include <vlc_network.h>
+#include <vlc_block.h>
 
 #ifdef _WIN32
 #   undef EAFNOSUPPORT
@@ -85,6 +86,10 @@
 # define UDPLITE_RECV_CSCOV     11
 #endif
 
+#if defined (__linux__) && defined (SO_TXTIME)
+# include <linux/net_tstamp.h>
+#endif
+
 extern int net_Socket( vlc_object_t *p_this, int i_family, int i_socktype,
                        int i_protocol );
 
@@ -677,6 +682,167 @@ int net_OpenDgram( vlc_object_t *obj, const char *psz_bind, int i_bind,
 }
 
 
+/**
+ * net_RecvDgrams:
+ * Receives one datagram per block, issuing a single system call for the
+ * whole batch where the operating system supports it. Without recvmmsg(),
+ * only the first datagram is received.
+ * @param fd datagram socket
+ * @param blocks array of blocks to receive into; on input, each block
+ * buffer size is the receive capacity, on output the datagram length
+ * @param count number of blocks
+ * @return the number of datagrams received, or -1 on error
+ */
+ssize_t net_RecvDgrams (int fd, block_t *const *blocks, unsigned count)
+{
+#ifdef HAVE_RECVMMSG
+    struct mmsghdr msgv[count];
+    struct iovec iov[count];
+
+    for (unsigned i = 0; i < count; i++)
+    {
+        iov[i] = (struct iovec){
+            .iov_base = blocks[i]->p_buffer,
+            .iov_len = blocks[i]->i_buffer,
+        };
+        msgv[i] = (struct mmsghdr){
+            .msg_hdr = { .msg_iov = iov + i, .msg_iovlen = 1 },
+        };
+    }
+
+    int val = recvmmsg (fd, msgv, count, 0, NULL);
+    if (val < 0)
+        return -1;
+
+    for (int i = 0; i < val; i++)
+        blocks[i]->i_buffer = msgv[i].msg_len;
+    return val;
+#else
+    ssize_t val = recv (fd, blocks[0]->p_buffer, blocks[0]->i_buffer, 0);
+    if (val < 0)
+        return -1;
+
+    blocks[0]->i_buffer = val;
+    (void) count;
+    return 1;
+#endif
+}
+
+/**
+ * net_SendDgrams:
+ * Sends each block as one datagram, issuing a single system call for the
+ * whole batch where the operating system supports it. Without sendmmsg(),
+ * only the first datagram is sent.
+ * @param fd datagram socket
+ * @param blocks array of blocks to send, one datagram each
+ * @param count number of blocks
+ * @return the number of datagrams sent (possibly fewer than requested),
+ * or -1 if no datagram was sent
+ */
+ssize_t net_SendDgrams (int fd, block_t *const *blocks, unsigned count)
+{
+#ifdef HAVE_SENDMMSG
+    struct mmsghdr msgv[count];
+    struct iovec iov[count];
+
+    for (unsigned i = 0; i < count; i++)
+    {
+        iov[i] = (struct iovec){
+            .iov_base = blocks[i]->p_buffer,
+            .iov_len = blocks[i]->i_buffer,
+        };
+        msgv[i] = (struct mmsghdr){
+            .msg_hdr = { .msg_iov = iov + i, .msg_iovlen = 1 },
+        };
+    }
+
+    int val = sendmmsg (fd, msgv, count, 0);
+    return (val < 0) ? -1 : val;
+#else
+    ssize_t val = send (fd, blocks[0]->p_buffer, blocks[0]->i_buffer, 0);
+
+    (void) count;
+    return (val < 0) ? -1 : 1;
+#endif
+}
+
+/**
+ * net_SetDgramTxTime:
+ * Enables kernel transmit time pacing on a datagram socket, so datagrams
+ * queued with net_SendDgramsAt() are released on the wire at their
+ * individual deadlines (Linux SO_TXTIME, requires an fq or etf qdisc).
+ * @param fd datagram socket
+ * @return 0 on success, -1 if unsupported or on error
+ */
+int net_SetDgramTxTime (int fd)
+{
+#if defined (__linux__) && defined (SO_TXTIME)
+    struct sock_txtime cfg = {
+        .clockid = CLOCK_MONOTONIC,
+        .flags = 0,
+    };
+    return setsockopt (fd, SOL_SOCKET, SO_TXTIME, &cfg, sizeof (cfg));
+#else
+    (void) fd;
+    errno = ENOSYS;
+    return -1;
+#endif
+}
+
+/**
+ * net_SendDgramsAt:
+ * Sends each block as one datagram like net_SendDgrams(), with a per
+ * datagram transmit deadline. On a socket prepared with
+ * net_SetDgramTxTime(), the kernel holds each datagram until its
+ * deadline; elsewhere the deadlines are ignored and the datagrams are
+ * sent immediately.
+ * @param fd datagram socket
+ * @param blocks array of blocks to send, one datagram each
+ * @param count number of blocks
+ * @param deadlines transmit deadline of each datagram (mdate() clock)
+ * @return the number of datagrams sent (possibly fewer than requested),
+ * or -1 if no datagram was sent
+ */
+ssize_t net_SendDgramsAt (int fd, block_t *const *blocks, unsigned count,
+                          const mtime_t *deadlines)
+{
+#if defined (__linux__) && defined (SO_TXTIME) && defined (HAVE_SENDMMSG)
+    struct mmsghdr msgv[count];
+    struct iovec iov[count];
+    char ctl[count][CMSG_SPACE(sizeof (uint64_t))];
+
+    for (unsigned i = 0; i < count; i++)
+    {
+        iov[i] = (struct iovec){
+            .iov_base = blocks[i]->p_buffer,
+            .iov_len = blocks[i]->i_buffer,
+        };
+        msgv[i] = (struct mmsghdr){
+            .msg_hdr = {
+                .msg_iov = iov + i, .msg_iovlen = 1,
+                .msg_control = ctl[i],
+                .msg_controllen = sizeof (ctl[i]),
+            },
+        };
+
+        memset (ctl[i], 0, sizeof (ctl[i]));
+        struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msgv[i].msg_hdr);
+        cmsg->cmsg_level = SOL_SOCKET;
+        cmsg->cmsg_type = SCM_TXTIME;
+        cmsg->cmsg_len = CMSG_LEN(sizeof (uint64_t));
+
+        uint64_t ns = (uint64_t)deadlines[i] * 1000;
+        memcpy (CMSG_DATA(cmsg), &ns, sizeof (ns));
+    }
+
+    int val = sendmmsg (fd, msgv, count, 0);
+    return (val < 0) ? -1 : val;
+#else
+    (void) deadlines;
+    return net_SendDgrams (fd, blocks, count);
+#endif
+}
+
 /**
  * net_SetCSCov:
  * Sets the send and receive checksum coverage of a socket:
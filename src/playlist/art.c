@@ -34,7 +34,7 @@
 #include <vlc_fs.h>
 #include <vlc_strings.h>
 #include <vlc_url.h>
-#include <vlc_md5.h>
+#include <vlc_hash.h>
 
 #include "art.h"
 
@@ -81,23 +81,22 @@ static char* ArtCacheGetDirPath( const char *psz_arturl, const char *psz_artist,
     {
         /* If artist or album are missing, cache by art download URL.
          * If the URL is an attachment://, add the title to the cache name.
-         * It will be md5 hashed to form a valid cache filename.
+         * It will be hashed to form a valid cache filename.
          * We assume that psz_arturl is always the download URL and not the
          * already hashed filename.
          * (We should never need to call this function if art has already been
          * downloaded anyway).
          */
-        struct md5_s md5;
-        InitMD5( &md5 );
-        AddMD5( &md5, psz_arturl, strlen( psz_arturl ) );
+        struct vlc_hash64_s hash;
+        char psz_key[17];
+        vlc_hash64_Init( &hash, 0 );
+        vlc_hash64_Add( &hash, psz_arturl, strlen( psz_arturl ) );
         if( !strncmp( psz_arturl, "attachment://", 13 ) )
-            AddMD5( &md5, psz_title, strlen( psz_title ) );
-        EndMD5( &md5 );
-        char * psz_arturl_sanitized = psz_md5_hash( &md5 );
+            vlc_hash64_Add( &hash, psz_title, strlen( psz_title ) );
+        vlc_hash64_hex( psz_key, vlc_hash64_Finish( &hash ) );
         if( asprintf( &psz_dir, "%s" DIR_SEP "art" DIR_SEP "arturl" DIR_SEP
-                      "%s", psz_cachedir, psz_arturl_sanitized ) == -1 )
+                      "%s", psz_cachedir, psz_key ) == -1 )
             psz_dir = NULL;
-        free( psz_arturl_sanitized );
     }
     free( psz_cachedir );
     return psz_dir;
@@ -262,6 +261,23 @@ int playlist_FindArtInCacheUsingItemUID( input_item_t *p_item )
     return VLC_EGENERIC;
 }
 
+/* The same cover often comes back for many albums (or many URLs of the same
+ * album). Index dumped art by a hash of its content, so identical blobs are
+ * stored - and downloaded art directories filled - only once. */
+static char * GetFileByContentHash( const void *data, size_t length )
+{
+    char psz_hash[17];
+    vlc_hash64_hex( psz_hash, vlc_hash64( data, length ) );
+
+    char *psz_cachedir = config_GetUserDir(VLC_CACHE_DIR);
+    char *psz_file;
+    if( asprintf( &psz_file, "%s" DIR_SEP "art" DIR_SEP "by-content" DIR_SEP
+                  "%s", psz_cachedir, psz_hash ) == -1 )
+        psz_file = NULL;
+    free( psz_cachedir );
+    return psz_file;
+}
+
 /* */
 int playlist_SaveArt( vlc_object_t *obj, input_item_t *p_item,
                       const void *data, size_t length, const char *psz_type )
@@ -288,22 +304,71 @@ int playlist_SaveArt( vlc_object_t *obj, input_item_t *p_item,
         return VLC_SUCCESS;
     }
 
+    /* Check if the same blob was already dumped for another album or URL */
+    char *psz_byhashfile = GetFileByContentHash( data, length );
+    bool b_reused = false;
+    if( psz_byhashfile )
+    {
+        FILE *fd = vlc_fopen( psz_byhashfile, "rb" );
+        if( fd )
+        {
+            char sz_arturl[2049];
+            if( fgets( sz_arturl, 2048, fd ) != NULL )
+            {
+                char *psz_path = vlc_uri2path( sz_arturl );
+                if( psz_path && !vlc_stat( psz_path, &s ) )
+                {
+                    msg_Dbg( obj, "album art already cached as %s", psz_path );
+                    input_item_SetArtURL( p_item, sz_arturl );
+                    free( psz_uri );
+                    psz_uri = strdup( sz_arturl );
+                    b_reused = true;
+                }
+                free( psz_path );
+            }
+            fclose( fd );
+        }
+    }
+
     /* Dump it otherwise */
-    FILE *f = vlc_fopen( psz_filename, "wb" );
-    if( f )
+    if( !b_reused )
     {
-        if( fwrite( data, 1, length, f ) != length )
+        bool b_dumped = false;
+        FILE *f = vlc_fopen( psz_filename, "wb" );
+        if( f )
         {
-            msg_Err( obj, "%s: %s", psz_filename, vlc_strerror_c(errno) );
+            if( fwrite( data, 1, length, f ) != length )
+            {
+                msg_Err( obj, "%s: %s", psz_filename, vlc_strerror_c(errno) );
+            }
+            else
+            {
+                msg_Dbg( obj, "album art saved to %s", psz_filename );
+                input_item_SetArtURL( p_item, psz_uri );
+                b_dumped = true;
+            }
+            fclose( f );
         }
-        else
+
+        /* Remember the content hash of the dumped blob */
+        if( b_dumped && psz_byhashfile )
         {
-            msg_Dbg( obj, "album art saved to %s", psz_filename );
-            input_item_SetArtURL( p_item, psz_uri );
+            char *psz_slash = strrchr( psz_byhashfile, DIR_SEP_CHAR );
+            *psz_slash = '\0';
+            ArtCacheCreateDir( psz_byhashfile );
+            *psz_slash = DIR_SEP_CHAR;
+
+            f = vlc_fopen( psz_byhashfile, "wb" );
+            if( f )
+            {
+                if( fputs( psz_uri, f ) < 0 )
+                    msg_Err( obj, "Error writing %s: %s", psz_byhashfile,
+                             vlc_strerror_c(errno) );
+                fclose( f );
+            }
         }
-        fclose( f );
     }
-    free( psz_uri );
+    free( psz_byhashfile );
 
     /* save uid info */
     char *uid = input_item_GetInfo( p_item, "uid", "md5" );
@@ -318,21 +383,22 @@ int playlist_SaveArt( vlc_object_t *obj, input_item_t *p_item,
     ArtCacheCreateDir( psz_byuiddir );
     free( psz_byuiddir );
 
-    if ( psz_byuidfile )
+    if ( psz_byuidfile && psz_uri )
     {
-        f = vlc_fopen( psz_byuidfile, "wb" );
+        FILE *f = vlc_fopen( psz_byuidfile, "wb" );
         if ( f )
         {
-            if( fputs( "file://", f ) < 0 || fputs( psz_filename, f ) < 0 )
+            if( fputs( psz_uri, f ) < 0 )
                 msg_Err( obj, "Error writing %s: %s", psz_byuidfile,
                          vlc_strerror_c(errno) );
             fclose( f );
         }
-        free( psz_byuidfile );
     }
+    free( psz_byuidfile );
     free( uid );
     /* !save uid info */
 end:
+    free( psz_uri );
     free( psz_filename );
     return VLC_SUCCESS;
 }
@@ -225,6 +225,11 @@ playlist_t *playlist_Create( vlc_object_t *p_parent )
     ARRAY_INIT( pl_priv(p_playlist)->items_to_delete );
     ARRAY_INIT( p_playlist->current );
 
+    playlist_LiveSearchInit( p_playlist );
+
+    pl_priv(p_playlist)->ml_journal.p_file = NULL;
+    pl_priv(p_playlist)->ml_journal.psz_path = NULL;
+
     p_playlist->i_current_index = 0;
     pl_priv(p_playlist)->b_reset_currently_playing = true;
 
@@ -343,18 +348,22 @@ void playlist_Destroy( playlist_t *p_playlist )
     set_current_status_item( p_playlist, NULL );
     PL_UNLOCK;
 
+    playlist_LiveSearchDeinit( p_playlist );
+
     vlc_cond_destroy( &p_sys->signal );
     vlc_mutex_destroy( &p_sys->lock );
 
     /* Remove all remaining items */
     FOREACH_ARRAY( playlist_item_t *p_del, p_playlist->all_items )
         free( p_del->pp_children );
+        free( p_del->psz_search_key );
         vlc_gc_decref( p_del->p_input );
         free( p_del );
     FOREACH_END();
     ARRAY_RESET( p_playlist->all_items );
     FOREACH_ARRAY( playlist_item_t *p_del, p_sys->items_to_delete )
         free( p_del->pp_children );
+        free( p_del->psz_search_key );
         vlc_gc_decref( p_del->p_input );
         free( p_del );
     FOREACH_END();
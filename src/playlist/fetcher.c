@@ -74,13 +74,15 @@ struct playlist_fetcher_t
     vlc_object_t   *object;
     vlc_mutex_t     lock;
     vlc_cond_t      wait;
-    bool            b_live;
+    unsigned        i_threads;
+    unsigned        i_live;
 
     fetcher_entry_t *p_waiting_head[PASS_COUNT];
     fetcher_entry_t *p_waiting_tail[PASS_COUNT];
 
+    /* Albums already searched this session, protected by lock */
     DECL_ARRAY(playlist_album_t) albums;
-    meta_fetcher_scope_t e_scope;
+    meta_fetcher_scope_t e_scope; /* configured maximum, read-only */
 };
 
 static void *Thread( void * );
@@ -98,7 +100,13 @@ playlist_fetcher_t *playlist_fetcher_New( vlc_object_t *parent )
     p_fetcher->object = parent;
     vlc_mutex_init( &p_fetcher->lock );
     vlc_cond_init( &p_fetcher->wait );
-    p_fetcher->b_live = false;
+    /* Workers mostly wait on the network, so a few of them go a long way;
+     * stay well below the preparser pool size to not hammer art servers. */
+    p_fetcher->i_threads = var_InheritInteger( parent, "preparse-threads" );
+    if( p_fetcher->i_threads == 0 )
+        p_fetcher->i_threads = __MIN( vlc_GetCPUCount(), 8 );
+    p_fetcher->i_threads = __MIN( p_fetcher->i_threads, 4 );
+    p_fetcher->i_live = 0;
 
     bool b_access = var_InheritBool( parent, "metadata-network-access" );
     if ( !b_access )
@@ -132,15 +140,18 @@ void playlist_fetcher_Push( playlist_fetcher_t *p_fetcher, input_item_t *p_item,
         p_fetcher->p_waiting_head[PASS1_LOCAL] = p_entry;
     p_fetcher->p_waiting_tail[PASS1_LOCAL] = p_entry;
 
-    if( !p_fetcher->b_live )
+    if( p_fetcher->i_live < p_fetcher->i_threads )
     {
         assert( p_fetcher->p_waiting_head[PASS1_LOCAL] );
         if( vlc_clone_detach( NULL, Thread, p_fetcher,
                               VLC_THREAD_PRIORITY_LOW ) )
-            msg_Err( p_fetcher->object,
-                     "cannot spawn secondary preparse thread" );
+        {
+            if( p_fetcher->i_live == 0 )
+                msg_Err( p_fetcher->object,
+                         "cannot spawn secondary preparse thread" );
+        }
         else
-            p_fetcher->b_live = true;
+            p_fetcher->i_live++;
     }
     vlc_mutex_unlock( &p_fetcher->lock );
 }
@@ -162,7 +173,7 @@ void playlist_fetcher_Delete( playlist_fetcher_t *p_fetcher )
         p_fetcher->p_waiting_head[i_queue] = NULL;
     }
 
-    while( p_fetcher->b_live )
+    while( p_fetcher->i_live > 0 )
         vlc_cond_wait( &p_fetcher->wait, &p_fetcher->lock );
     vlc_mutex_unlock( &p_fetcher->lock );
 
@@ -191,11 +202,11 @@ void playlist_fetcher_Delete( playlist_fetcher_t *p_fetcher )
  *   1 : Art found, need to download
  *  -X : Error/not found
  */
-static int FindArt( playlist_fetcher_t *p_fetcher, input_item_t *p_item )
+static int FindArt( playlist_fetcher_t *p_fetcher, input_item_t *p_item,
+                    meta_fetcher_scope_t e_scope )
 {
     int i_ret;
 
-    playlist_album_t *p_album = NULL;
     char *psz_artist = input_item_GetArtist( p_item );
     char *psz_album = input_item_GetAlbum( p_item );
     char *psz_title = input_item_GetTitle( p_item );
@@ -210,6 +221,11 @@ static int FindArt( playlist_fetcher_t *p_fetcher, input_item_t *p_item )
     /* If we already checked this album in this session, skip */
     if( psz_artist && psz_album )
     {
+        char *psz_cached = NULL;
+        bool b_found = false;
+        bool b_searched = false;
+
+        vlc_mutex_lock( &p_fetcher->lock );
         FOREACH_ARRAY( playlist_album_t album, p_fetcher->albums )
             if( !strcmp( album.psz_artist, psz_artist ) &&
                 !strcmp( album.psz_album, psz_album ) )
@@ -217,29 +233,35 @@ static int FindArt( playlist_fetcher_t *p_fetcher, input_item_t *p_item )
                 msg_Dbg( p_fetcher->object,
                          " %s - %s has already been searched",
                          psz_artist, psz_album );
-                /* TODO-fenrir if we cache art filename too, we can go faster */
-                free( psz_artist );
-                free( psz_album );
-                if( album.b_found )
-                {
-                    if( !strncmp( album.psz_arturl, "file://", 7 ) )
-                        input_item_SetArtURL( p_item, album.psz_arturl );
-                    else /* Actually get URL from cache */
-                        playlist_FindArtInCache( p_item );
-                    return 0;
-                }
-                else if ( album.e_scope >= p_fetcher->e_scope )
-                {
-                    return VLC_EGENERIC;
-                }
-                msg_Dbg( p_fetcher->object,
-                         " will search at higher scope, if possible" );
-                p_album = &p_fetcher->albums.p_elems[fe_idx];
-
-                psz_artist = psz_album = NULL;
+                b_found = album.b_found;
+                b_searched = album.e_scope >= e_scope;
+                if( b_found && album.psz_arturl )
+                    psz_cached = strdup( album.psz_arturl );
+                else if( !b_found && !b_searched )
+                    msg_Dbg( p_fetcher->object,
+                             " will search at higher scope, if possible" );
                 break;
             }
         FOREACH_END();
+        vlc_mutex_unlock( &p_fetcher->lock );
+
+        if( b_found )
+        {
+            free( psz_artist );
+            free( psz_album );
+            if( psz_cached && !strncmp( psz_cached, "file://", 7 ) )
+                input_item_SetArtURL( p_item, psz_cached );
+            else /* Actually get URL from cache */
+                playlist_FindArtInCache( p_item );
+            free( psz_cached );
+            return 0;
+        }
+        if( b_searched )
+        {
+            free( psz_artist );
+            free( psz_album );
+            return VLC_EGENERIC;
+        }
     }
 
     free( psz_artist );
@@ -295,7 +317,7 @@ static int FindArt( playlist_fetcher_t *p_fetcher, input_item_t *p_item )
         module_t *p_module;
 
         p_finder->p_item = p_item;
-        p_finder->e_scope = p_fetcher->e_scope;
+        p_finder->e_scope = e_scope;
 
         p_module = module_need( p_finder, "art finder", NULL, false );
         if( p_module )
@@ -310,12 +332,27 @@ static int FindArt( playlist_fetcher_t *p_fetcher, input_item_t *p_item )
         vlc_object_release( p_finder );
     }
 
-    /* Record this album */
+    /* Record this album. Another worker may have handled the same album
+     * meanwhile, so look it up again rather than keeping a pointer into the
+     * array across the search. */
     if( psz_artist && psz_album )
     {
+        playlist_album_t *p_album = NULL;
+
+        vlc_mutex_lock( &p_fetcher->lock );
+        for( int i = 0; i < p_fetcher->albums.i_size; i++ )
+        {
+            playlist_album_t *p = &p_fetcher->albums.p_elems[i];
+            if( !strcmp( p->psz_artist, psz_artist ) &&
+                !strcmp( p->psz_album, psz_album ) )
+            {
+                p_album = p;
+                break;
+            }
+        }
         if ( p_album )
         {
-            p_album->e_scope = p_fetcher->e_scope;
+            p_album->e_scope = e_scope;
             free( p_album->psz_arturl );
             p_album->psz_arturl = input_item_GetArtURL( p_item );
             p_album->b_found = (i_ret == VLC_EGENERIC ? false : true );
@@ -329,9 +366,10 @@ static int FindArt( playlist_fetcher_t *p_fetcher, input_item_t *p_item )
             a.psz_album = psz_album;
             a.psz_arturl = input_item_GetArtURL( p_item );
             a.b_found = (i_ret == VLC_EGENERIC ? false : true );
-            a.e_scope = p_fetcher->e_scope;
+            a.e_scope = e_scope;
             ARRAY_APPEND( p_fetcher->albums, a );
         }
+        vlc_mutex_unlock( &p_fetcher->lock );
     }
     else
     {
@@ -415,14 +453,15 @@ error:
  * connections, and gather information upon the playing media.
  * (even artwork).
  */
-static void FetchMeta( playlist_fetcher_t *p_fetcher, input_item_t *p_item )
+static void FetchMeta( playlist_fetcher_t *p_fetcher, input_item_t *p_item,
+                       meta_fetcher_scope_t e_scope )
 {
     meta_fetcher_t *p_finder =
         vlc_custom_create( p_fetcher->object, sizeof( *p_finder ), "art finder" );
     if ( !p_finder )
         return;
 
-    p_finder->e_scope = p_fetcher->e_scope;
+    p_finder->e_scope = e_scope;
     p_finder->p_item = p_item;
 
     module_t *p_module = module_need( p_finder, "meta fetcher", NULL, false );
@@ -461,26 +500,29 @@ static void *Thread( void *p_data )
         }
         else
         {
-            p_fetcher->b_live = false;
-            vlc_cond_signal( &p_fetcher->wait );
+            p_fetcher->i_live--;
+            if( p_fetcher->i_live == 0 )
+                vlc_cond_signal( &p_fetcher->wait );
         }
         vlc_mutex_unlock( &p_fetcher->lock );
 
         if( !p_entry )
             break;
 
-        meta_fetcher_scope_t e_prev_scope = p_fetcher->e_scope;
+        /* The scope is kept local to this worker: several of them run
+         * concurrently on different entries. */
+        meta_fetcher_scope_t e_scope = p_fetcher->e_scope;
 
         /* scope override */
-        switch ( p_entry->i_options ) {
+        switch ( p_entry->i_options & META_REQUEST_OPTION_SCOPE_ANY ) {
         case META_REQUEST_OPTION_SCOPE_ANY:
-            p_fetcher->e_scope = FETCHER_SCOPE_ANY;
+            e_scope = FETCHER_SCOPE_ANY;
             break;
         case META_REQUEST_OPTION_SCOPE_LOCAL:
-            p_fetcher->e_scope = FETCHER_SCOPE_LOCAL;
+            e_scope = FETCHER_SCOPE_LOCAL;
             break;
         case META_REQUEST_OPTION_SCOPE_NETWORK:
-            p_fetcher->e_scope = FETCHER_SCOPE_NETWORK;
+            e_scope = FETCHER_SCOPE_NETWORK;
             break;
         case META_REQUEST_OPTION_NONE:
         default:
@@ -493,22 +535,22 @@ static void *Thread( void *p_data )
 
         int i_ret = -1;
 
-        if( e_pass == PASS1_LOCAL && ( p_fetcher->e_scope & FETCHER_SCOPE_LOCAL ) )
+        if( e_pass == PASS1_LOCAL && ( e_scope & FETCHER_SCOPE_LOCAL ) )
         {
             /* only fetch from local */
-            p_fetcher->e_scope = FETCHER_SCOPE_LOCAL;
+            e_scope = FETCHER_SCOPE_LOCAL;
         }
-        else if( e_pass == PASS2_NETWORK && ( p_fetcher->e_scope & FETCHER_SCOPE_NETWORK ) )
+        else if( e_pass == PASS2_NETWORK && ( e_scope & FETCHER_SCOPE_NETWORK ) )
         {
             /* only fetch from network */
-            p_fetcher->e_scope = FETCHER_SCOPE_NETWORK;
+            e_scope = FETCHER_SCOPE_NETWORK;
         }
         else
-            p_fetcher->e_scope = 0;
-        if ( p_fetcher->e_scope & FETCHER_SCOPE_ANY )
+            e_scope = 0;
+        if ( e_scope & FETCHER_SCOPE_ANY )
         {
-            FetchMeta( p_fetcher, p_entry->p_item );
-            i_ret = FindArt( p_fetcher, p_entry->p_item );
+            FetchMeta( p_fetcher, p_entry->p_item, e_scope );
+            i_ret = FindArt( p_fetcher, p_entry->p_item, e_scope );
             switch( i_ret )
             {
             case 1: /* Found, need to dl */
@@ -522,7 +564,6 @@ static void *Thread( void *p_data )
             }
         }
 
-        p_fetcher->e_scope = e_prev_scope;
         /* */
         if ( i_ret != VLC_SUCCESS && (e_pass != PASS2_NETWORK) )
         {
@@ -255,6 +255,7 @@ playlist_item_t *playlist_ItemNewFromInput( playlist_t *p_playlist,
     p_item->pp_children = NULL;
     p_item->i_nb_played = 0;
     p_item->i_flags = 0;
+    p_item->psz_search_key = NULL;
     p_item->p_playlist = p_playlist;
 
     install_input_item_observer( p_item );
@@ -286,6 +287,9 @@ int playlist_ItemRelease( playlist_item_t *p_item )
      *
      * Who wants to add proper memory management? */
     uninstall_input_item_observer( p_item );
+    FREENULL( p_item->psz_search_key );
+    if( pl_priv(p_playlist)->live_search.p_last_root == p_item )
+        pl_priv(p_playlist)->live_search.p_last_root = NULL;
     ARRAY_APPEND( pl_priv(p_playlist)->items_to_delete, p_item);
     return VLC_SUCCESS;
 }
@@ -106,6 +106,236 @@ int playlist_Import( playlist_t *p_playlist, const char *psz_file )
     return input_Read( p_playlist, p_input );
 }
 
+/*****************************************************************************
+ * Media library journal
+ *
+ * Serializing 50k items to XSPF on every change is far too expensive, so
+ * the full dump only happens on exit (and stays the authoritative format,
+ * readable by the existing XSPF demuxer). In between, every item added to
+ * or deleted from the media library is appended to a small journal file,
+ * one flushed line per change. The journal is replayed - idempotently -
+ * on top of ml.xspf at load time, and removed once a full dump succeeds,
+ * so a crash loses at most the change being written.
+ *****************************************************************************/
+
+static char *MLJournalPath( void )
+{
+    char *psz_datadir = config_GetUserDir( VLC_DATA_DIR );
+    if( psz_datadir == NULL )
+        return NULL;
+
+    char *psz_path;
+    if( asprintf( &psz_path, "%s" DIR_SEP "ml.journal", psz_datadir ) == -1 )
+        psz_path = NULL;
+    free( psz_datadir );
+    return psz_path;
+}
+
+/**
+ * Is the item attached under the media library node?
+ * The playlist must be locked.
+ */
+static bool MLJournalCovers( playlist_t *p_playlist, playlist_item_t *p_item )
+{
+    if( p_playlist->p_media_library == NULL )
+        return false;
+    for( ; p_item != NULL; p_item = p_item->p_parent )
+        if( p_item == p_playlist->p_media_library )
+            return true;
+    return false;
+}
+
+/**
+ * Append one change to the journal. Tabs and newlines separate the
+ * fields, so they are squashed out of the name.
+ */
+static void MLJournalWrite( playlist_t *p_playlist, char op,
+                            const char *psz_uri, const char *psz_name )
+{
+    FILE *p_file = pl_priv(p_playlist)->ml_journal.p_file;
+
+    if( p_file == NULL || psz_uri == NULL )
+        return;
+
+    fprintf( p_file, "%c\t%s", op, psz_uri );
+    if( psz_name != NULL )
+    {
+        fputc( '\t', p_file );
+        for( const char *p = psz_name; *p; p++ )
+            fputc( ( *p == '\t' || *p == '\n' ) ? ' ' : *p, p_file );
+    }
+    fputc( '\n', p_file );
+    fflush( p_file );
+}
+
+/* Both callbacks run with the playlist locked, in the thread applying the
+ * change */
+static int MLItemAppended( vlc_object_t *obj, const char *psz_var,
+                           vlc_value_t oldval, vlc_value_t newval, void *data )
+{
+    playlist_t *p_playlist = (playlist_t *)obj;
+    const playlist_add_t *p_add = newval.p_address;
+    playlist_item_t *p_item = playlist_ItemGetById( p_playlist,
+                                                    p_add->i_item );
+
+    if( p_item != NULL && MLJournalCovers( p_playlist, p_item ) )
+    {
+        char *psz_uri = input_item_GetURI( p_item->p_input );
+        char *psz_name = input_item_GetName( p_item->p_input );
+        MLJournalWrite( p_playlist, '+', psz_uri, psz_name );
+        free( psz_name );
+        free( psz_uri );
+    }
+
+    (void) psz_var; (void) oldval; (void) data;
+    return VLC_SUCCESS;
+}
+
+static int MLItemDeleted( vlc_object_t *obj, const char *psz_var,
+                          vlc_value_t oldval, vlc_value_t newval, void *data )
+{
+    playlist_t *p_playlist = (playlist_t *)obj;
+    playlist_item_t *p_item = playlist_ItemGetById( p_playlist,
+                                                    newval.i_int );
+
+    if( p_item != NULL && MLJournalCovers( p_playlist, p_item ) )
+    {
+        char *psz_uri = input_item_GetURI( p_item->p_input );
+        MLJournalWrite( p_playlist, '-', psz_uri, NULL );
+        free( psz_uri );
+    }
+
+    (void) psz_var; (void) oldval; (void) data;
+    return VLC_SUCCESS;
+}
+
+/**
+ * Find an item by URI below a node. The playlist must be locked.
+ */
+static playlist_item_t *MLFindByURI( playlist_item_t *p_node,
+                                     const char *psz_uri )
+{
+    for( int i = 0; i < p_node->i_children; i++ )
+    {
+        playlist_item_t *p_item = p_node->pp_children[i];
+        char *psz = input_item_GetURI( p_item->p_input );
+        bool b_match = psz != NULL && !strcmp( psz, psz_uri );
+        free( psz );
+        if( b_match )
+            return p_item;
+        if( p_item->i_children >= 0 )
+        {
+            p_item = MLFindByURI( p_item, psz_uri );
+            if( p_item != NULL )
+                return p_item;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Apply the journalled changes on top of the loaded media library.
+ * Replay is idempotent: additions of items already present and deletions
+ * of absent ones are skipped, so a journal can be replayed again after a
+ * second crash.
+ */
+static void MLJournalReplay( playlist_t *p_playlist, const char *psz_path )
+{
+    FILE *p_file = vlc_fopen( psz_path, "rt" );
+    if( p_file == NULL )
+        return;
+
+    msg_Dbg( p_playlist, "replaying media library journal" );
+
+    char sz_line[4096];
+    PL_LOCK;
+    while( fgets( sz_line, sizeof (sz_line), p_file ) != NULL )
+    {
+        if( ( sz_line[0] != '+' && sz_line[0] != '-' ) || sz_line[1] != '\t' )
+            continue;
+
+        char *psz_uri = sz_line + 2;
+        char *psz_name = strchr( psz_uri, '\t' );
+        if( psz_name != NULL )
+            *(psz_name++) = '\0';
+        char *psz_nl = strchr( psz_name != NULL ? psz_name : psz_uri, '\n' );
+        if( psz_nl != NULL )
+            *psz_nl = '\0';
+
+        playlist_item_t *p_item = MLFindByURI( p_playlist->p_media_library,
+                                               psz_uri );
+        if( sz_line[0] == '+' && p_item == NULL )
+        {
+            input_item_t *p_input = input_item_New( psz_uri, psz_name );
+            if( p_input != NULL )
+            {
+                playlist_NodeAddInput( p_playlist, p_input,
+                                       p_playlist->p_media_library,
+                                       PLAYLIST_APPEND, PLAYLIST_END,
+                                       pl_Locked );
+                vlc_gc_decref( p_input );
+            }
+        }
+        else if( sz_line[0] == '-' && p_item != NULL )
+            playlist_NodeDelete( p_playlist, p_item, true, false );
+    }
+    PL_UNLOCK;
+    fclose( p_file );
+}
+
+/**
+ * Replay any pending journal, then start journalling the changes of this
+ * session. Called once the initial media library has been read.
+ */
+static void MLJournalSetup( playlist_t *p_playlist )
+{
+    playlist_private_t *p_sys = pl_priv(p_playlist);
+    char *psz_path = MLJournalPath();
+
+    if( psz_path == NULL )
+        return;
+
+    MLJournalReplay( p_playlist, psz_path );
+
+    p_sys->ml_journal.p_file = vlc_fopen( psz_path, "at" );
+    if( p_sys->ml_journal.p_file == NULL )
+    {
+        msg_Warn( p_playlist, "cannot journal media library changes: %s",
+                  vlc_strerror_c(errno) );
+        free( psz_path );
+        return;
+    }
+    p_sys->ml_journal.psz_path = psz_path;
+
+    var_AddCallback( p_playlist, "playlist-item-append", MLItemAppended,
+                     NULL );
+    var_AddCallback( p_playlist, "playlist-item-deleted", MLItemDeleted,
+                     NULL );
+}
+
+/**
+ * Stop journalling; on b_clear (a full dump succeeded), the journal is
+ * obsolete and removed.
+ */
+static void MLJournalStop( playlist_t *p_playlist, bool b_clear )
+{
+    playlist_private_t *p_sys = pl_priv(p_playlist);
+
+    if( p_sys->ml_journal.p_file == NULL )
+        return;
+
+    var_DelCallback( p_playlist, "playlist-item-deleted", MLItemDeleted,
+                     NULL );
+    var_DelCallback( p_playlist, "playlist-item-append", MLItemAppended,
+                     NULL );
+
+    fclose( p_sys->ml_journal.p_file );
+    p_sys->ml_journal.p_file = NULL;
+    if( b_clear )
+        vlc_unlink( p_sys->ml_journal.psz_path );
+    FREENULL( p_sys->ml_journal.psz_path );
+}
+
 /*****************************************************************************
  * A subitem has been added to the Media Library (Event Callback)
  *****************************************************************************/
@@ -145,6 +375,8 @@ int playlist_MLLoad( playlist_t *p_playlist )
     if( vlc_stat( psz_file, &st ) )
     {
         free( psz_file );
+        /* Nothing dumped yet, but a journal may have survived a crash */
+        MLJournalSetup( p_playlist );
         return VLC_EGENERIC;
     }
 
@@ -177,6 +409,8 @@ int playlist_MLLoad( playlist_t *p_playlist )
     vlc_event_detach( &p_input->event_manager, vlc_InputItemSubItemTreeAdded,
                         input_item_subitem_tree_added, p_playlist );
 
+    MLJournalSetup( p_playlist );
+
     return VLC_SUCCESS;
 }
 
@@ -197,13 +431,17 @@ int playlist_MLDump( playlist_t *p_playlist )
     free( psz_temp );
     if( config_CreateDir( (vlc_object_t *)p_playlist, psz_dirname ) )
     {
+        MLJournalStop( p_playlist, false );
         return VLC_EGENERIC;
     }
 
     strcat( psz_dirname, DIR_SEP "ml.xspf" );
 
     if ( asprintf( &psz_temp, "%s.tmp%"PRIu32, psz_dirname, (uint32_t)getpid() ) < 1 )
+    {
+        MLJournalStop( p_playlist, false );
         return VLC_EGENERIC;
+    }
 
     int i_ret = playlist_Export( p_playlist, psz_temp, p_playlist->p_media_library,
                      "export-xspf" );
@@ -211,6 +449,7 @@ int playlist_MLDump( playlist_t *p_playlist )
     {
         vlc_unlink( psz_temp );
         free( psz_temp );
+        MLJournalStop( p_playlist, false );
         return i_ret;
     }
 
@@ -220,7 +459,11 @@ int playlist_MLDump( playlist_t *p_playlist )
     {
         msg_Err( p_playlist, "could not rename %s.tmp: %s",
                  psz_dirname, vlc_strerror_c(errno) );
+        MLJournalStop( p_playlist, false );
         return VLC_EGENERIC;
     }
+
+    /* The dump holds the full state: the journal is obsolete */
+    MLJournalStop( p_playlist, true );
     return VLC_SUCCESS;
 }
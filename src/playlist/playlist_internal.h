@@ -78,6 +78,27 @@ typedef struct playlist_private_t
         vlc_mutex_t         lock;     /**< Lock to protect request */
     } request;
 
+    struct {
+        /* Media library change journal (loadsave.c). Appends survive a
+         * crash between two full dumps; protected by the playlist lock. */
+        FILE            *p_file; /**< Append handle, NULL when inactive */
+        char            *psz_path;
+    } ml_journal;
+
+    struct {
+        /* Live search state. The dirty list collects the inputs whose
+         * cached search key became stale; it has its own lock since
+         * "item-change" fires from the metadata threads. The other fields
+         * are protected by the playlist lock. */
+        vlc_mutex_t      lock;     /**< Protects the dirty list */
+        input_item_t   **pp_dirty; /**< Inputs with a stale search key */
+        int              i_dirty;
+        bool             b_dirty_all; /**< Too many changes, flush all keys */
+        char            *psz_last; /**< Previous live search string */
+        playlist_item_t *p_last_root;
+        bool             b_last_recursive;
+    } live_search;
+
     vlc_thread_t thread; /**< engine thread */
     vlc_mutex_t lock; /**< dah big playlist global lock */
     vlc_cond_t signal; /**< wakes up the playlist engine thread */
@@ -114,6 +135,10 @@ void set_current_status_node( playlist_t *, playlist_item_t * );
 int playlist_MLLoad( playlist_t *p_playlist );
 int playlist_MLDump( playlist_t *p_playlist );
 
+/* Live search (search.c) */
+void playlist_LiveSearchInit( playlist_t *p_playlist );
+void playlist_LiveSearchDeinit( playlist_t *p_playlist );
+
 /**********************************************************************
  * Item management
  **********************************************************************/
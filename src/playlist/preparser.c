@@ -49,10 +49,18 @@ struct playlist_preparser_t
 
     vlc_mutex_t     lock;
     vlc_cond_t      wait;
-    vlc_sem_t       item_done;
-    bool            b_live;
+    unsigned        i_threads;
+    unsigned        i_live;
+    bool            b_deleting;
+    /* Items flagged META_REQUEST_OPTION_PRIORITY are served before the
+     * auto-preparse backlog */
+    preparser_entry_t  **pp_urgent;
+    int             i_urgent;
     preparser_entry_t  **pp_waiting;
     int             i_waiting;
+    /* Inputs currently being preparsed, so that Delete can abort them */
+    input_thread_t **pp_input;
+    int             i_input;
 };
 
 static void *Thread( void * );
@@ -73,10 +81,17 @@ playlist_preparser_t *playlist_preparser_New( vlc_object_t *parent )
 
     vlc_mutex_init( &p_preparser->lock );
     vlc_cond_init( &p_preparser->wait );
-    vlc_sem_init( &p_preparser->item_done, 0 );
-    p_preparser->b_live = false;
+    p_preparser->i_threads = var_InheritInteger( parent, "preparse-threads" );
+    if( p_preparser->i_threads == 0 )
+        p_preparser->i_threads = __MIN( vlc_GetCPUCount(), 8 );
+    p_preparser->i_live = 0;
+    p_preparser->b_deleting = false;
+    p_preparser->i_urgent = 0;
+    p_preparser->pp_urgent = NULL;
     p_preparser->i_waiting = 0;
     p_preparser->pp_waiting = NULL;
+    p_preparser->i_input = 0;
+    p_preparser->pp_input = NULL;
 
     return p_preparser;
 }
@@ -93,15 +108,25 @@ void playlist_preparser_Push( playlist_preparser_t *p_preparser, input_item_t *p
     vlc_gc_incref( p_entry->p_item );
 
     vlc_mutex_lock( &p_preparser->lock );
-    INSERT_ELEM( p_preparser->pp_waiting, p_preparser->i_waiting,
-                 p_preparser->i_waiting, p_entry );
-    if( !p_preparser->b_live )
+    if( i_options & META_REQUEST_OPTION_PRIORITY )
+        INSERT_ELEM( p_preparser->pp_urgent, p_preparser->i_urgent,
+                     p_preparser->i_urgent, p_entry );
+    else
+        INSERT_ELEM( p_preparser->pp_waiting, p_preparser->i_waiting,
+                     p_preparser->i_waiting, p_entry );
+    /* Grow the worker pool with the backlog, up to the configured limit.
+     * Idle workers exit on their own, so there is nothing to shrink here. */
+    if( p_preparser->i_live < p_preparser->i_threads )
     {
         if( vlc_clone_detach( NULL, Thread, p_preparser,
                               VLC_THREAD_PRIORITY_LOW ) )
-            msg_Warn( p_preparser->object, "cannot spawn pre-parser thread" );
+        {
+            if( p_preparser->i_live == 0 )
+                msg_Warn( p_preparser->object,
+                          "cannot spawn pre-parser thread" );
+        }
         else
-            p_preparser->b_live = true;
+            p_preparser->i_live++;
     }
     vlc_mutex_unlock( &p_preparser->lock );
 }
@@ -116,7 +141,15 @@ void playlist_preparser_fetcher_Push( playlist_preparser_t *p_preparser,
 void playlist_preparser_Delete( playlist_preparser_t *p_preparser )
 {
     vlc_mutex_lock( &p_preparser->lock );
-    /* Remove pending item to speed up preparser thread exit */
+    p_preparser->b_deleting = true;
+    /* Remove pending items to speed up the worker threads exit */
+    while( p_preparser->i_urgent > 0 )
+    {
+        preparser_entry_t *p_entry = p_preparser->pp_urgent[0];
+        vlc_gc_decref( p_entry->p_item );
+        free( p_entry );
+        REMOVE_ELEM( p_preparser->pp_urgent, p_preparser->i_urgent, 0 );
+    }
     while( p_preparser->i_waiting > 0 )
     {
         preparser_entry_t *p_entry = p_preparser->pp_waiting[0];
@@ -125,14 +158,15 @@ void playlist_preparser_Delete( playlist_preparser_t *p_preparser )
         REMOVE_ELEM( p_preparser->pp_waiting, p_preparser->i_waiting, 0 );
     }
 
-    vlc_sem_post( &p_preparser->item_done );
+    /* Abort the inputs the workers are currently waiting on */
+    for( int i = 0; i < p_preparser->i_input; i++ )
+        input_Stop( p_preparser->pp_input[i] );
 
-    while( p_preparser->b_live )
+    while( p_preparser->i_live > 0 )
         vlc_cond_wait( &p_preparser->wait, &p_preparser->lock );
     vlc_mutex_unlock( &p_preparser->lock );
 
     /* Destroy the item preparser */
-    vlc_sem_destroy( &p_preparser->item_done );
     vlc_cond_destroy( &p_preparser->wait );
     vlc_mutex_destroy( &p_preparser->lock );
 
@@ -188,17 +222,42 @@ static void Preparse( playlist_preparser_t *preparser, input_item_t *p_item,
         if( input == NULL )
             return;
 
-        var_AddCallback( input, "intf-event", InputEvent,
-                         &preparser->item_done );
-        if( input_Start( input ) == VLC_SUCCESS )
-            vlc_sem_wait( &preparser->item_done );
-        var_DelCallback( input, "intf-event", InputEvent,
-                         &preparser->item_done );
+        /* Each worker waits on its own semaphore: the inputs of concurrent
+         * preparses die in any order. */
+        vlc_sem_t done;
+        vlc_sem_init( &done, 0 );
+        var_AddCallback( input, "intf-event", InputEvent, &done );
+
+        /* Expose the input so that playlist_preparser_Delete() can stop it */
+        vlc_mutex_lock( &preparser->lock );
+        bool b_deleting = preparser->b_deleting;
+        if( !b_deleting )
+            INSERT_ELEM( preparser->pp_input, preparser->i_input,
+                         preparser->i_input, input );
+        vlc_mutex_unlock( &preparser->lock );
+
+        if( !b_deleting && input_Start( input ) == VLC_SUCCESS )
+            vlc_sem_wait( &done );
+
+        if( !b_deleting )
+        {
+            vlc_mutex_lock( &preparser->lock );
+            for( int i = 0; i < preparser->i_input; i++ )
+                if( preparser->pp_input[i] == input )
+                {
+                    REMOVE_ELEM( preparser->pp_input, preparser->i_input, i );
+                    break;
+                }
+            vlc_mutex_unlock( &preparser->lock );
+        }
+
+        var_DelCallback( input, "intf-event", InputEvent, &done );
         /* Normally, the input is already stopped since we waited for it. But
          * if the playlist preparser is being deleted, then the input might
          * still be running. Force it to stop. */
         input_Stop( input );
         input_Close( input );
+        vlc_sem_destroy( &done );
 
         var_SetAddress( preparser->object, "item-change", p_item );
     }
@@ -249,7 +308,8 @@ static void Art( playlist_preparser_t *p_preparser, input_item_t *p_item )
 }
 
 /**
- * This function does the preparsing and issues the art fetching requests
+ * This function does the preparsing and issues the art fetching requests.
+ * Several instances of it run concurrently, one per pool worker.
  */
 static void *Thread( void *data )
 {
@@ -260,9 +320,17 @@ static void *Thread( void *data )
         input_item_t *p_current;
         input_item_meta_request_option_t i_options;
 
-        /* */
+        /* Urgent (user-visible) items preempt the auto-preparse backlog */
         vlc_mutex_lock( &p_preparser->lock );
-        if( p_preparser->i_waiting > 0 )
+        if( p_preparser->i_urgent > 0 )
+        {
+            preparser_entry_t *p_entry = p_preparser->pp_urgent[0];
+            p_current = p_entry->p_item;
+            i_options = p_entry->i_options;
+            free( p_entry );
+            REMOVE_ELEM( p_preparser->pp_urgent, p_preparser->i_urgent, 0 );
+        }
+        else if( p_preparser->i_waiting > 0 )
         {
             preparser_entry_t *p_entry = p_preparser->pp_waiting[0];
             p_current = p_entry->p_item;
@@ -273,8 +341,9 @@ static void *Thread( void *data )
         else
         {
             p_current = NULL;
-            p_preparser->b_live = false;
-            vlc_cond_signal( &p_preparser->wait );
+            p_preparser->i_live--;
+            if( p_preparser->i_live == 0 )
+                vlc_cond_signal( &p_preparser->wait );
         }
         vlc_mutex_unlock( &p_preparser->lock );
 
@@ -85,6 +85,142 @@ playlist_item_t* playlist_ItemGetByInput( playlist_t * p_playlist,
  * Live search handling
  ***************************************************************************/
 
+/* Changes beyond this count make flushing every key cheaper than matching
+ * the dirty list against the item array */
+#define LIVE_SEARCH_DIRTY_MAX 32
+
+/**
+ * An item's meta or name changed: remember to rebuild its search key.
+ * Runs in the thread emitting "item-change", so it only touches the
+ * dirty list, under its own lock.
+ */
+static int ItemChanged( vlc_object_t *obj, const char *psz_var,
+                        vlc_value_t oldval, vlc_value_t newval, void *data )
+{
+    playlist_private_t *p_sys = pl_priv( (playlist_t *)obj );
+    input_item_t *p_input = newval.p_address;
+
+    vlc_mutex_lock( &p_sys->live_search.lock );
+    if( !p_sys->live_search.b_dirty_all )
+    {
+        if( p_sys->live_search.i_dirty >= LIVE_SEARCH_DIRTY_MAX )
+        {
+            p_sys->live_search.b_dirty_all = true;
+            p_sys->live_search.i_dirty = 0;
+            FREENULL( p_sys->live_search.pp_dirty );
+        }
+        else
+            INSERT_ELEM( p_sys->live_search.pp_dirty,
+                         p_sys->live_search.i_dirty,
+                         p_sys->live_search.i_dirty, p_input );
+    }
+    vlc_mutex_unlock( &p_sys->live_search.lock );
+
+    (void) psz_var; (void) oldval; (void) data;
+    return VLC_SUCCESS;
+}
+
+void playlist_LiveSearchInit( playlist_t *p_playlist )
+{
+    playlist_private_t *p_sys = pl_priv( p_playlist );
+
+    vlc_mutex_init( &p_sys->live_search.lock );
+    p_sys->live_search.pp_dirty = NULL;
+    p_sys->live_search.i_dirty = 0;
+    p_sys->live_search.b_dirty_all = false;
+    p_sys->live_search.psz_last = NULL;
+    p_sys->live_search.p_last_root = NULL;
+    p_sys->live_search.b_last_recursive = false;
+
+    var_AddCallback( p_playlist, "item-change", ItemChanged, NULL );
+}
+
+void playlist_LiveSearchDeinit( playlist_t *p_playlist )
+{
+    playlist_private_t *p_sys = pl_priv( p_playlist );
+
+    var_DelCallback( p_playlist, "item-change", ItemChanged, NULL );
+
+    free( p_sys->live_search.pp_dirty );
+    free( p_sys->live_search.psz_last );
+    vlc_mutex_destroy( &p_sys->live_search.lock );
+}
+
+/**
+ * Build the search key of an item: its title (or name), album and artist,
+ * as a single string so that one vlc_strcasestr() covers them all. The
+ * fields are separated with a newline, which cannot occur in a search
+ * string, so no match can straddle two fields.
+ */
+static char *ItemSearchKey( input_item_t *p_input )
+{
+    const char *psz_title = NULL, *psz_album = NULL, *psz_artist = NULL;
+    char *psz_key;
+
+    vlc_mutex_lock( &p_input->lock );
+    if( p_input->p_meta )
+    {
+        psz_title = vlc_meta_Get( p_input->p_meta, vlc_meta_Title );
+        psz_album = vlc_meta_Get( p_input->p_meta, vlc_meta_Album );
+        psz_artist = vlc_meta_Get( p_input->p_meta, vlc_meta_Artist );
+    }
+    if( !psz_title )
+        psz_title = p_input->psz_name;
+
+    if( asprintf( &psz_key, "%s\n%s\n%s",
+                  psz_title ? psz_title : "",
+                  psz_album ? psz_album : "",
+                  psz_artist ? psz_artist : "" ) == -1 )
+        psz_key = NULL;
+    vlc_mutex_unlock( &p_input->lock );
+
+    return psz_key;
+}
+
+/**
+ * Drop the cached keys of the items changed since the previous search.
+ * Invalidation also disables the refinement of the previous results, since
+ * a changed item may match now even though it did not before.
+ * The playlist must be locked.
+ */
+static void LiveSearchFlushDirty( playlist_t *p_playlist )
+{
+    playlist_private_t *p_sys = pl_priv( p_playlist );
+    input_item_t **pp_dirty;
+    int i_dirty;
+    bool b_all;
+
+    vlc_mutex_lock( &p_sys->live_search.lock );
+    pp_dirty = p_sys->live_search.pp_dirty;
+    i_dirty = p_sys->live_search.i_dirty;
+    b_all = p_sys->live_search.b_dirty_all;
+    p_sys->live_search.pp_dirty = NULL;
+    p_sys->live_search.i_dirty = 0;
+    p_sys->live_search.b_dirty_all = false;
+    vlc_mutex_unlock( &p_sys->live_search.lock );
+
+    if( !b_all && i_dirty == 0 )
+        return;
+
+    for( int i = 0; i < p_playlist->all_items.i_size; i++ )
+    {
+        playlist_item_t *p_item = ARRAY_VAL( p_playlist->all_items, i );
+        if( !b_all )
+        {
+            int j;
+            for( j = 0; j < i_dirty; j++ )
+                if( p_item->p_input == pp_dirty[j] )
+                    break;
+            if( j == i_dirty )
+                continue;
+        }
+        FREENULL( p_item->psz_search_key );
+    }
+    free( pp_dirty );
+
+    FREENULL( p_sys->live_search.psz_last );
+}
+
 /**
  * Enable all items in the playlist
  * @param p_root: the current root item
@@ -108,7 +244,8 @@ static void playlist_LiveSearchClean( playlist_item_t *p_root )
  * @return true if an item match
  */
 static bool playlist_LiveSearchUpdateInternal( playlist_item_t *p_root,
-                                               const char *psz_string, bool b_recursive )
+                                               const char *psz_string,
+                                               bool b_recursive, bool b_refine )
 {
     int i;
     bool b_match = false;
@@ -118,30 +255,23 @@ static bool playlist_LiveSearchUpdateInternal( playlist_item_t *p_root,
         playlist_item_t *p_item = p_root->pp_children[i];
         // Go recurssively if their is some children
         if( b_recursive && p_item->i_children >= 0 &&
-            playlist_LiveSearchUpdateInternal( p_item, psz_string, true ) )
+            playlist_LiveSearchUpdateInternal( p_item, psz_string, true,
+                                               b_refine ) )
         {
             b_enable = true;
         }
+        /* When refining the previous search, items it already filtered out
+         * cannot match the longer string: keep them disabled untested. */
+        else if( b_refine && p_item->i_children < 0 &&
+                 ( p_item->i_flags & PLAYLIST_DBL_FLAG ) )
+            continue;
 
         if( !b_enable )
         {
-            vlc_mutex_lock( &p_item->p_input->lock );
-            // Do we have some meta ?
-            if( p_item->p_input->p_meta )
-            {
-                // Use Title or fall back to psz_name
-                const char *psz_title = vlc_meta_Get( p_item->p_input->p_meta, vlc_meta_Title );
-                if( !psz_title )
-                    psz_title = p_item->p_input->psz_name;
-                const char *psz_album = vlc_meta_Get( p_item->p_input->p_meta, vlc_meta_Album );
-                const char *psz_artist = vlc_meta_Get( p_item->p_input->p_meta, vlc_meta_Artist );
-                b_enable = ( psz_title && vlc_strcasestr( psz_title, psz_string ) ) ||
-                           ( psz_album && vlc_strcasestr( psz_album, psz_string ) ) ||
-                           ( psz_artist && vlc_strcasestr( psz_artist, psz_string ) );
-            }
-            else
-                b_enable = p_item->p_input->psz_name && vlc_strcasestr( p_item->p_input->psz_name, psz_string );
-            vlc_mutex_unlock( &p_item->p_input->lock );
+            if( p_item->psz_search_key == NULL )
+                p_item->psz_search_key = ItemSearchKey( p_item->p_input );
+            b_enable = p_item->psz_search_key &&
+                       vlc_strcasestr( p_item->psz_search_key, psz_string );
         }
 
         if( b_enable )
@@ -166,13 +296,37 @@ static bool playlist_LiveSearchUpdateInternal( playlist_item_t *p_root,
 int playlist_LiveSearchUpdate( playlist_t *p_playlist, playlist_item_t *p_root,
                                const char *psz_string, bool b_recursive )
 {
+    playlist_private_t *p_sys = pl_priv(p_playlist);
+
     PL_ASSERT_LOCKED;
-    pl_priv(p_playlist)->b_reset_currently_playing = true;
+    p_sys->b_reset_currently_playing = true;
+
+    LiveSearchFlushDirty( p_playlist );
+
     if( *psz_string )
-        playlist_LiveSearchUpdateInternal( p_root, psz_string, b_recursive );
+    {
+        /* Typing forward only narrows the result: when the previous search
+         * string is contained in the new one, the items it disabled need
+         * not be looked at again. */
+        bool b_refine = p_sys->live_search.psz_last != NULL
+                     && p_sys->live_search.p_last_root == p_root
+                     && p_sys->live_search.b_last_recursive == b_recursive
+                     && vlc_strcasestr( psz_string, p_sys->live_search.psz_last );
+
+        playlist_LiveSearchUpdateInternal( p_root, psz_string, b_recursive,
+                                           b_refine );
+
+        free( p_sys->live_search.psz_last );
+        p_sys->live_search.psz_last = strdup( psz_string );
+        p_sys->live_search.p_last_root = p_root;
+        p_sys->live_search.b_last_recursive = b_recursive;
+    }
     else
+    {
         playlist_LiveSearchClean( p_root );
-    vlc_cond_signal( &pl_priv(p_playlist)->signal );
+        FREENULL( p_sys->live_search.psz_last );
+    }
+    vlc_cond_signal( &p_sys->signal );
     return VLC_SUCCESS;
 }
 
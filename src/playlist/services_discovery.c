@@ -119,6 +119,7 @@ services_discovery_t *vlc_sd_Create( vlc_object_t *p_super,
     vlc_event_manager_t *em = &p_sd->event_manager;
     vlc_event_manager_init( em, p_sd );
     vlc_event_manager_register_event_type(em, vlc_ServicesDiscoveryItemAdded);
+    vlc_event_manager_register_event_type(em, vlc_ServicesDiscoveryItemsAdded);
     vlc_event_manager_register_event_type(em, vlc_ServicesDiscoveryItemRemoved);
     vlc_event_manager_register_event_type(em, vlc_ServicesDiscoveryItemRemoveAll);
     vlc_event_manager_register_event_type(em, vlc_ServicesDiscoveryStarted);
@@ -235,6 +236,30 @@ services_discovery_AddItem ( services_discovery_t * p_sd, input_item_t * p_item,
     vlc_event_send( &p_sd->event_manager, &event );
 }
 
+/*******************************************************************//**
+ * Add a batch of items to the Service Discovery listing
+ *
+ * One event for the whole array: listeners process it as a single
+ * transaction, which matters when a discovery floods in thousands of
+ * items at once
+ ***********************************************************************/
+void
+services_discovery_AddItems ( services_discovery_t * p_sd,
+                              input_item_t * const * pp_items, int i_count,
+                              const char * psz_category )
+{
+    if( i_count <= 0 )
+        return;
+
+    vlc_event_t event;
+    event.type = vlc_ServicesDiscoveryItemsAdded;
+    event.u.services_discovery_items_added.pp_items = pp_items;
+    event.u.services_discovery_items_added.i_count = i_count;
+    event.u.services_discovery_items_added.psz_category = psz_category;
+
+    vlc_event_send( &p_sd->event_manager, &event );
+}
+
 /*******************************************************************//**
  * Remove an item from the Service Discovery listing
  ***********************************************************************/
@@ -260,19 +285,12 @@ struct vlc_sd_internal_t
     char                 *psz_name;
 };
 
- /* A new item has been added to a certain sd */
-static void playlist_sd_item_added( const vlc_event_t * p_event, void * user_data )
+ /* Add one discovered item under the sd node; playlist already locked */
+static void playlist_sd_add( playlist_t * p_playlist,
+                             playlist_item_t * p_parent,
+                             input_item_t * p_input, const char * psz_cat )
 {
-    input_item_t * p_input = p_event->u.services_discovery_item_added.p_new_item;
-    const char * psz_cat = p_event->u.services_discovery_item_added.psz_category;
-    playlist_item_t * p_parent = user_data;
-    playlist_t * p_playlist = p_parent->p_playlist;
-
-    msg_Dbg( p_playlist, "Adding %s in %s",
-                p_input->psz_name ? p_input->psz_name : "(null)",
-                psz_cat ? psz_cat : "(null)" );
-
-    PL_LOCK;
+    PL_ASSERT_LOCKED;
     /* If p_parent is in root category (this is clearly a hack) and we have a cat */
     if( !EMPTY_STR(psz_cat) )
     {
@@ -291,6 +309,41 @@ static void playlist_sd_item_added( const vlc_event_t * p_event, void * user_dat
     playlist_NodeAddInput( p_playlist, p_input, p_parent,
                            PLAYLIST_APPEND, PLAYLIST_END,
                            pl_Locked );
+}
+
+ /* A new item has been added to a certain sd */
+static void playlist_sd_item_added( const vlc_event_t * p_event, void * user_data )
+{
+    input_item_t * p_input = p_event->u.services_discovery_item_added.p_new_item;
+    const char * psz_cat = p_event->u.services_discovery_item_added.psz_category;
+    playlist_item_t * p_parent = user_data;
+    playlist_t * p_playlist = p_parent->p_playlist;
+
+    msg_Dbg( p_playlist, "Adding %s in %s",
+                p_input->psz_name ? p_input->psz_name : "(null)",
+                psz_cat ? psz_cat : "(null)" );
+
+    PL_LOCK;
+    playlist_sd_add( p_playlist, p_parent, p_input, psz_cat );
+    PL_UNLOCK;
+}
+
+ /* A batch of items has been added to a certain sd: one lock round-trip
+  * (and thus one batch of playlist notifications) for the whole array */
+static void playlist_sd_items_added( const vlc_event_t * p_event, void * user_data )
+{
+    input_item_t * const * pp_items = p_event->u.services_discovery_items_added.pp_items;
+    int i_count = p_event->u.services_discovery_items_added.i_count;
+    const char * psz_cat = p_event->u.services_discovery_items_added.psz_category;
+    playlist_item_t * p_parent = user_data;
+    playlist_t * p_playlist = p_parent->p_playlist;
+
+    msg_Dbg( p_playlist, "Adding %d items in %s",
+                i_count, psz_cat ? psz_cat : "(null)" );
+
+    PL_LOCK;
+    for( int i = 0; i < i_count; i++ )
+        playlist_sd_add( p_playlist, p_parent, pp_items[i], psz_cat );
     PL_UNLOCK;
 }
 
@@ -377,6 +430,9 @@ int playlist_ServicesDiscoveryAdd( playlist_t *p_playlist,
     vlc_event_attach( em, vlc_ServicesDiscoveryItemAdded,
                       playlist_sd_item_added, p_node );
 
+    vlc_event_attach( em, vlc_ServicesDiscoveryItemsAdded,
+                      playlist_sd_items_added, p_node );
+
     vlc_event_attach( em, vlc_ServicesDiscoveryItemRemoved,
                       playlist_sd_item_removed, p_node );
 
@@ -435,6 +491,11 @@ int playlist_ServicesDiscoveryRemove( playlist_t * p_playlist,
                         playlist_sd_item_added,
                         p_sds->p_node );
 
+    vlc_event_detach( services_discovery_EventManager( p_sd ),
+                        vlc_ServicesDiscoveryItemsAdded,
+                        playlist_sd_items_added,
+                        p_sds->p_node );
+
     vlc_event_detach( services_discovery_EventManager( p_sd ),
                         vlc_ServicesDiscoveryItemRemoved,
                         playlist_sd_item_removed,
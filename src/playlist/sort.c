@@ -33,19 +33,96 @@
 #include "playlist_internal.h"
 
 
+/* Sort entries: the strings (and duration) an item is compared on are
+ * extracted once per sort, instead of taking the input item lock and
+ * duplicating metadata in every single comparison. The comparison
+ * functions below run on these entries; the items are written back in
+ * their new order once the entry array is sorted. */
+#define SORT_KEY_FIELDS 3
+
+typedef struct
+{
+    playlist_item_t *p_item;
+    char            *psz_title;    /**< Title, or name as fallback */
+    char            *psz_fields[SORT_KEY_FIELDS]; /**< Mode-dependent chain */
+    mtime_t          i_duration;
+} sort_entry_t;
+
+/**
+ * Extract the sort key of one item for the given SORT_* mode.
+ * Strings left NULL compare as missing metadata, like before.
+ */
+static void BuildSortKey( sort_entry_t *p_entry, playlist_item_t *p_item,
+                          unsigned i_mode )
+{
+    input_item_t *p_input = p_item->p_input;
+
+    p_entry->p_item = p_item;
+    p_entry->psz_title = NULL;
+    for( unsigned i = 0; i < SORT_KEY_FIELDS; i++ )
+        p_entry->psz_fields[i] = NULL;
+    p_entry->i_duration = 0;
+
+    switch( i_mode )
+    {
+    case SORT_ID:
+        return;
+    case SORT_DURATION:
+        p_entry->i_duration = input_item_GetDuration( p_input );
+        return;
+    case SORT_URI:
+        p_entry->psz_fields[0] = input_item_GetURI( p_input );
+        return;
+    case SORT_ALBUM:
+        p_entry->psz_fields[0] = input_item_GetMeta( p_input, vlc_meta_Album );
+        p_entry->psz_fields[1] = input_item_GetMeta( p_input,
+                                                     vlc_meta_TrackNumber );
+        break;
+    case SORT_ARTIST:
+        p_entry->psz_fields[0] = input_item_GetMeta( p_input, vlc_meta_Artist );
+        p_entry->psz_fields[1] = input_item_GetMeta( p_input, vlc_meta_Album );
+        p_entry->psz_fields[2] = input_item_GetMeta( p_input,
+                                                     vlc_meta_TrackNumber );
+        break;
+    case SORT_DESCRIPTION:
+        p_entry->psz_fields[0] = input_item_GetMeta( p_input,
+                                                     vlc_meta_Description );
+        break;
+    case SORT_GENRE:
+        p_entry->psz_fields[0] = input_item_GetMeta( p_input, vlc_meta_Genre );
+        break;
+    case SORT_RATING:
+        p_entry->psz_fields[0] = input_item_GetMeta( p_input, vlc_meta_Rating );
+        break;
+    case SORT_TRACK_NUMBER:
+        p_entry->psz_fields[0] = input_item_GetMeta( p_input,
+                                                     vlc_meta_TrackNumber );
+        break;
+    }
+    /* Title fallback, used by all remaining modes */
+    p_entry->psz_title = input_item_GetTitleFbName( p_input );
+}
+
+static void FreeSortKey( sort_entry_t *p_entry )
+{
+    free( p_entry->psz_title );
+    for( unsigned i = 0; i < SORT_KEY_FIELDS; i++ )
+        free( p_entry->psz_fields[i] );
+}
+
 /* General comparison functions */
 /**
- * Compare two items using their title or name
- * @param first: the first item
- * @param second: the second item
+ * Compare two entries using their title or name
+ * @param first: the first entry
+ * @param second: the second entry
  * @return -1, 0 or 1 like strcmp
  */
-static inline int meta_strcasecmp_title( const playlist_item_t *first,
-                              const playlist_item_t *second )
+static inline int meta_strcasecmp_title( const sort_entry_t *first,
+                                         const sort_entry_t *second )
 {
     int i_ret;
-    char *psz_first = input_item_GetTitleFbName( first->p_input );
-    char *psz_second = input_item_GetTitleFbName( second->p_input );
+    const char *psz_first = first->psz_title;
+    const char *psz_second = second->psz_title;
 
     if( psz_first && psz_second )
         i_ret = strcasecmp( psz_first, psz_second );
@@ -55,35 +132,35 @@ static inline int meta_strcasecmp_title( const playlist_item_t *first,
         i_ret = -1;
     else
         i_ret = 0;
-    free( psz_first );
-    free( psz_second );
 
     return i_ret;
 }
 
 /**
- * Compare two intems accoring to the given meta type
- * @param first: the first item
- * @param second: the second item
- * @param meta: the meta type to use to sort the items
+ * Compare two entries according to the given key field
+ * @param first: the first entry
+ * @param second: the second entry
+ * @param i_field: the sort key field to compare
  * @param b_integer: true if the meta are integers
  * @return -1, 0 or 1 like strcmp
  */
-static inline int meta_sort( const playlist_item_t *first,
-                             const playlist_item_t *second,
-                             vlc_meta_type_t meta, bool b_integer )
+static inline int meta_sort( const sort_entry_t *first,
+                             const sort_entry_t *second,
+                             unsigned i_field, bool b_integer )
 {
     int i_ret;
-    char *psz_first = input_item_GetMeta( first->p_input, meta );
-    char *psz_second = input_item_GetMeta( second->p_input, meta );
+    const char *psz_first = first->psz_fields[i_field];
+    const char *psz_second = second->psz_fields[i_field];
 
     /* Nodes go first */
-    if( first->i_children == -1 && second->i_children >= 0 )
+    if( first->p_item->i_children == -1 && second->p_item->i_children >= 0 )
         i_ret = 1;
-    else if( first->i_children >= 0 && second->i_children == -1 )
+    else if( first->p_item->i_children >= 0
+          && second->p_item->i_children == -1 )
        i_ret = -1;
     /* Both are nodes, sort by name */
-    else if( first->i_children >= 0 && second->i_children >= 0 )
+    else if( first->p_item->i_children >= 0
+          && second->p_item->i_children >= 0 )
         i_ret = meta_strcasecmp_title( first, second );
     /* Both are items */
     else if( !psz_first && psz_second )
@@ -101,8 +178,6 @@ static inline int meta_sort( const playlist_item_t *first,
             i_ret = strcasecmp( psz_first, psz_second );
     }
 
-    free( psz_first );
-    free( psz_second );
     return i_ret;
 }
 
@@ -124,20 +199,116 @@ static inline sortfn_t find_sorting_fn( unsigned i_mode, unsigned i_type )
     return sorting_fns[i_mode][i_type];
 }
 
+/* Below this size, spawning sort threads costs more than it saves */
+#define SORT_PARALLEL_MIN 8192
+
+typedef struct
+{
+    sort_entry_t *p_elems;
+    sort_entry_t *p_buf;
+    unsigned      i_count;
+    sortfn_t      p_sortfn;
+    unsigned      i_depth;
+} sort_task_t;
+
+static void SortEntries( sort_entry_t *, sort_entry_t *, unsigned, sortfn_t,
+                         unsigned );
+
+static void *SortThread( void *data )
+{
+    sort_task_t *p_task = data;
+    SortEntries( p_task->p_elems, p_task->p_buf, p_task->i_count,
+                 p_task->p_sortfn, p_task->i_depth );
+    return NULL;
+}
+
+/**
+ * Merge sort splitting the work across threads down to the given depth,
+ * then falling back to qsort() on the leaves.
+ */
+static void SortEntries( sort_entry_t *p_elems, sort_entry_t *p_buf,
+                         unsigned i_count, sortfn_t p_sortfn,
+                         unsigned i_depth )
+{
+    if( i_depth == 0 || i_count < SORT_PARALLEL_MIN )
+    {
+        qsort( p_elems, i_count, sizeof( p_elems[0] ), p_sortfn );
+        return;
+    }
+
+    unsigned i_half = i_count / 2;
+    sort_task_t task = { p_elems, p_buf, i_half, p_sortfn, i_depth - 1 };
+    vlc_thread_t thread;
+    bool b_thread = vlc_clone( &thread, SortThread, &task,
+                               VLC_THREAD_PRIORITY_LOW ) == 0;
+    if( !b_thread )
+        SortEntries( p_elems, p_buf, i_half, p_sortfn, 0 );
+    SortEntries( p_elems + i_half, p_buf + i_half, i_count - i_half,
+                 p_sortfn, i_depth - 1 );
+    if( b_thread )
+        vlc_join( thread, NULL );
+
+    /* Merge the sorted halves */
+    unsigned i = 0, j = i_half, k = 0;
+    while( i < i_half && j < i_count )
+        p_buf[k++] = ( p_sortfn( &p_elems[i], &p_elems[j] ) <= 0 )
+                   ? p_elems[i++] : p_elems[j++];
+    while( i < i_half )
+        p_buf[k++] = p_elems[i++];
+    while( j < i_count )
+        p_buf[k++] = p_elems[j++];
+    memcpy( p_elems, p_buf, i_count * sizeof( p_elems[0] ) );
+}
+
 /**
  * Sort an array of items recursively
  * @param i_items: number of items
  * @param pp_items: the array of items
  * @param p_sortfn: the sorting function
+ * @param i_mode: the SORT_* mode, to extract the matching sort keys
  * @return nothing
  */
-static inline
-void playlist_ItemArraySort( unsigned i_items, playlist_item_t **pp_items,
-                             sortfn_t p_sortfn )
+static void playlist_ItemArraySort( unsigned i_items,
+                                    playlist_item_t **pp_items,
+                                    sortfn_t p_sortfn, unsigned i_mode )
 {
+    if( i_items < 2 )
+        return;
+
     if( p_sortfn )
     {
-        qsort( pp_items, i_items, sizeof( pp_items[0] ), p_sortfn );
+        sort_entry_t *p_entries = malloc( i_items * sizeof( *p_entries ) );
+        if( unlikely(p_entries == NULL) )
+            return;
+
+        for( unsigned i = 0; i < i_items; i++ )
+            BuildSortKey( &p_entries[i], pp_items[i], i_mode );
+
+        /* Split across half the cores - the merges and the metadata
+         * extraction above keep the remaining ones busy enough. */
+        unsigned i_depth = 0;
+        sort_entry_t *p_buf = NULL;
+        if( i_items >= 2 * SORT_PARALLEL_MIN )
+        {
+            unsigned i_cpu = vlc_GetCPUCount();
+            while( (2u << i_depth) <= i_cpu && i_depth < 4 )
+                i_depth++;
+        }
+        if( i_depth > 0 )
+        {
+            p_buf = malloc( i_items * sizeof( *p_buf ) );
+            if( p_buf == NULL )
+                i_depth = 0;
+        }
+        SortEntries( p_entries, p_buf, i_items, p_sortfn, i_depth );
+        free( p_buf );
+
+        for( unsigned i = 0; i < i_items; i++ )
+        {
+            pp_items[i] = p_entries[i].p_item;
+            FreeSortKey( &p_entries[i] );
+        }
+        free( p_entries );
     }
     else /* Randomise */
     {
@@ -162,18 +333,21 @@ void playlist_ItemArraySort( unsigned i_items, playlist_item_t **pp_items,
  * @param p_playlist the playlist
  * @param p_node the node to sort
  * @param p_sortfn the sorting function
+ * @param i_mode: the SORT_* mode
  * @return VLC_SUCCESS on success
  */
 static int recursiveNodeSort( playlist_t *p_playlist, playlist_item_t *p_node,
-                              sortfn_t p_sortfn )
+                              sortfn_t p_sortfn, unsigned i_mode )
 {
     int i;
-    playlist_ItemArraySort(p_node->i_children,p_node->pp_children,p_sortfn);
+    playlist_ItemArraySort( p_node->i_children, p_node->pp_children,
+                            p_sortfn, i_mode );
     for( i = 0 ; i< p_node->i_children; i++ )
     {
         if( p_node->pp_children[i]->i_children != -1 )
         {
-            recursiveNodeSort( p_playlist, p_node->pp_children[i], p_sortfn );
+            recursiveNodeSort( p_playlist, p_node->pp_children[i], p_sortfn,
+                               i_mode );
         }
     }
     return VLC_SUCCESS;
@@ -197,7 +371,8 @@ int playlist_RecursiveNodeSort( playlist_t *p_playlist, playlist_item_t *p_node,
     pl_priv(p_playlist)->b_reset_currently_playing = true;
 
     /* Do the real job recursively */
-    return recursiveNodeSort(p_playlist,p_node,find_sorting_fn(i_mode,i_type));
+    return recursiveNodeSort( p_playlist, p_node,
+                              find_sorting_fn(i_mode,i_type), i_mode );
 }
 
 
@@ -212,37 +387,40 @@ int playlist_RecursiveNodeSort( playlist_t *p_playlist, playlist_item_t *p_node,
  */
 
 #define SORTFN( SORT, first, second ) static inline int proto_##SORT \
-	( const playlist_item_t *first, const playlist_item_t *second )
+	( const sort_entry_t *first, const sort_entry_t *second )
 
 SORTFN( SORT_ALBUM, first, second )
 {
-    int i_ret = meta_sort( first, second, vlc_meta_Album, false );
+    int i_ret = meta_sort( first, second, 0, false );
     /* Items came from the same album: compare the track numbers */
     if( i_ret == 0 )
-        i_ret = meta_sort( first, second, vlc_meta_TrackNumber, true );
+        i_ret = meta_sort( first, second, 1, true );
 
     return i_ret;
 }
 
 SORTFN( SORT_ARTIST, first, second )
 {
-    int i_ret = meta_sort( first, second, vlc_meta_Artist, false );
-    /* Items came from the same artist: compare the albums */
+    int i_ret = meta_sort( first, second, 0, false );
+    /* Items came from the same artist: compare the albums, then the
+     * track numbers (the SORT_ALBUM chain, one key field further) */
+    if( i_ret == 0 )
+        i_ret = meta_sort( first, second, 1, false );
     if( i_ret == 0 )
-        i_ret = proto_SORT_ALBUM( first, second );
+        i_ret = meta_sort( first, second, 2, true );
 
     return i_ret;
 }
 
 SORTFN( SORT_DESCRIPTION, first, second )
 {
-    return meta_sort( first, second, vlc_meta_Description, false );
+    return meta_sort( first, second, 0, false );
 }
 
 SORTFN( SORT_DURATION, first, second )
 {
-    mtime_t time1 = input_item_GetDuration( first->p_input );
-    mtime_t time2 = input_item_GetDuration( second->p_input );
+    mtime_t time1 = first->i_duration;
+    mtime_t time2 = second->i_duration;
     int i_ret = time1 > time2 ? 1 :
                     ( time1 == time2 ? 0 : -1 );
     return i_ret;
@@ -250,17 +428,17 @@ SORTFN( SORT_DURATION, first, second )
 
 SORTFN( SORT_GENRE, first, second )
 {
-    return meta_sort( first, second, vlc_meta_Genre, false );
+    return meta_sort( first, second, 0, false );
 }
 
 SORTFN( SORT_ID, first, second )
 {
-    return first->i_id - second->i_id;
+    return first->p_item->i_id - second->p_item->i_id;
 }
 
 SORTFN( SORT_RATING, first, second )
 {
-    return meta_sort( first, second, vlc_meta_Rating, true );
+    return meta_sort( first, second, 0, true );
 }
 
 SORTFN( SORT_TITLE, first, second )
@@ -271,10 +449,11 @@ SORTFN( SORT_TITLE, first, second )
 SORTFN( SORT_TITLE_NODES_FIRST, first, second )
 {
     /* If first is a node but not second */
-    if( first->i_children == -1 && second->i_children >= 0 )
+    if( first->p_item->i_children == -1 && second->p_item->i_children >= 0 )
         return -1;
     /* If second is a node but not first */
-    else if( first->i_children >= 0 && second->i_children == -1 )
+    else if( first->p_item->i_children >= 0
+          && second->p_item->i_children == -1 )
         return 1;
     /* Both are nodes or both are not nodes */
     else
@@ -284,8 +463,8 @@ SORTFN( SORT_TITLE_NODES_FIRST, first, second )
 SORTFN( SORT_TITLE_NUMERIC, first, second )
 {
     int i_ret;
-    char *psz_first = input_item_GetTitleFbName( first->p_input );
-    char *psz_second = input_item_GetTitleFbName( second->p_input );
+    const char *psz_first = first->psz_title;
+    const char *psz_second = second->psz_title;
 
     if( psz_first && psz_second )
         i_ret = atoi( psz_first ) - atoi( psz_second );
@@ -296,21 +475,19 @@ SORTFN( SORT_TITLE_NUMERIC, first, second )
     else
         i_ret = 0;
 
-    free( psz_first );
-    free( psz_second );
     return i_ret;
 }
 
 SORTFN( SORT_TRACK_NUMBER, first, second )
 {
-    return meta_sort( first, second, vlc_meta_TrackNumber, true );
+    return meta_sort( first, second, 0, true );
 }
 
 SORTFN( SORT_URI, first, second )
 {
     int i_ret;
-    char *psz_first = input_item_GetURI( first->p_input );
-    char *psz_second = input_item_GetURI( second->p_input );
+    const char *psz_first = first->psz_fields[0];
+    const char *psz_second = second->psz_fields[0];
 
     if( psz_first && psz_second )
         i_ret = strcasecmp( psz_first, psz_second );
@@ -321,8 +498,6 @@ SORTFN( SORT_URI, first, second )
     else
         i_ret = 0;
 
-    free( psz_first );
-    free( psz_second );
     return i_ret;
 }
 
@@ -338,11 +513,11 @@ SORTFN( SORT_URI, first, second )
 
 #define DEF( s ) \
 	static int cmp_a_##s(const void *l,const void *r) \
-	{ return proto_##s(*(const playlist_item_t *const *)l, \
-                           *(const playlist_item_t *const *)r); } \
+	{ return proto_##s((const sort_entry_t *)l, \
+                           (const sort_entry_t *)r); } \
 	static int cmp_d_##s(const void *l,const void *r) \
-	{ return -1*proto_##s(*(const playlist_item_t * const *)l, \
-                              *(const playlist_item_t * const *)r); }
+	{ return -1*proto_##s((const sort_entry_t *)l, \
+                              (const sort_entry_t *)r); }
 
 	VLC_DEFINE_SORT_FUNCTIONS
 
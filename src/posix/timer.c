@@ -1,5 +1,5 @@
 /*****************************************************************************
- * timer.c: simple threaded timer
+ * timer.c: shared threaded timer service
  *****************************************************************************
  * Copyright (C) 2009-2012 Rémi Denis-Courmont
  *
@@ -35,67 +35,138 @@
  * they typically require one thread per timer plus one thread per iteration,
  * which is inefficient and overkill (unless you need multiple iteration
  * of the same timer concurrently).
- * Thus, this is a generic manual implementation of timers using a thread.
+ * Thus, this is a generic manual implementation of timers.
+ *
+ * All timers of the process are serviced by a single shared thread keeping a
+ * list of armed timers ordered by expiry. The thread sleeps until the
+ * earliest deadline and fires every timer due at that point in one wake-up,
+ * so a process with many timers incurs one thread and coalesced wake-ups
+ * rather than one idle thread per timer. The thread is started when the
+ * first timer is created and reaped when the last one is destroyed.
+ *
+ * The flip side of sharing is that callbacks of distinct timers are
+ * serialized: a timer callback that blocks for long delays the other timers.
+ * Timer callbacks were always expected to be short; this merely makes it
+ * matter across timers rather than within one.
  */
 
 struct vlc_timer
 {
-    vlc_thread_t thread;
-    vlc_cond_t   reschedule;
-    vlc_mutex_t  lock;
+    struct vlc_timer *next; /**< armed timers list, sorted by deadline */
     void       (*func) (void *);
     void        *data;
     mtime_t      value, interval;
+    bool         armed;   /**< linked in the service list */
+    bool         running; /**< callback currently executing */
     atomic_uint  overruns;
 };
 
-VLC_NORETURN
-static void *vlc_timer_thread (void *data)
+static struct
 {
-    struct vlc_timer *timer = data;
+    vlc_mutex_t  lock;
+    vlc_cond_t   wait; /**< wakes the service thread up */
+    vlc_cond_t   idle; /**< signaled whenever a callback completes */
+    vlc_thread_t thread;
+    struct vlc_timer *first; /**< armed timers, earliest deadline first */
+    unsigned     refs;   /**< number of existing timers */
+    bool         active; /**< whether the service thread is running */
+    bool         exit;
+    bool         ready;  /**< whether the condition variables exist */
+} service = { .lock = VLC_STATIC_MUTEX };
 
-    vlc_mutex_lock (&timer->lock);
-    mutex_cleanup_push (&timer->lock);
+/**
+ * Links a timer in the service list, keeping it sorted by deadline.
+ * The service lock must be held.
+ */
+static void vlc_timer_arm (struct vlc_timer *timer)
+{
+    struct vlc_timer **pp = &service.first;
 
-    for (;;)
+    assert (!timer->armed);
+    while (*pp != NULL && (*pp)->value <= timer->value)
+        pp = &(*pp)->next;
+    timer->next = *pp;
+    *pp = timer;
+    timer->armed = true;
+}
+
+/**
+ * Unlinks a timer from the service list.
+ * The service lock must be held.
+ */
+static void vlc_timer_disarm (struct vlc_timer *timer)
+{
+    struct vlc_timer **pp = &service.first;
+
+    assert (timer->armed);
+    while (*pp != timer)
+        pp = &(*pp)->next;
+    *pp = timer->next;
+    timer->armed = false;
+}
+
+static void *vlc_timer_service_thread (void *data)
+{
+    vlc_mutex_lock (&service.lock);
+    while (!service.exit)
     {
-        while (timer->value == 0)
-            vlc_cond_wait (&timer->reschedule, &timer->lock);
+        struct vlc_timer *timer = service.first;
 
-        if (vlc_cond_timedwait (&timer->reschedule, &timer->lock,
-                                timer->value) == 0)
+        if (timer == NULL)
+        {
+            vlc_cond_wait (&service.wait, &service.lock);
             continue;
-        if (timer->interval == 0)
-            timer->value = 0; /* disarm */
-        vlc_mutex_unlock (&timer->lock);
+        }
+
+        if (mdate () < timer->value)
+        {   /* Sleep until the earliest deadline (or a reschedule). */
+            vlc_cond_timedwait (&service.wait, &service.lock, timer->value);
+            continue; /* the list may have changed either way */
+        }
+
+        vlc_timer_disarm (timer);
+        timer->running = true;
+        vlc_mutex_unlock (&service.lock);
 
         int canc = vlc_savecancel ();
         timer->func (timer->data);
         vlc_restorecancel (canc);
 
         mtime_t now = mdate ();
-        unsigned misses;
 
-        vlc_mutex_lock (&timer->lock);
-        if (timer->interval == 0)
-            continue;
-
-        misses = (now - timer->value) / timer->interval;
-        timer->value += timer->interval;
-        /* Try to compensate for one miss (mwait() will return immediately)
-         * but no more. Otherwise, we might busy loop, after extended periods
-         * without scheduling (suspend, SIGSTOP, RT preemption, ...). */
-        if (misses > 1)
+        vlc_mutex_lock (&service.lock);
+        /* Unless the callback (or another thread) rescheduled the timer,
+         * rearm it if periodic, or disarm it for good. */
+        if (!timer->armed)
         {
-            misses--;
-            timer->value += misses * timer->interval;
-            atomic_fetch_add_explicit (&timer->overruns, misses,
-                                       memory_order_relaxed);
+            if (timer->interval != 0 && timer->value != 0)
+            {
+                unsigned misses = (now - timer->value) / timer->interval;
+
+                timer->value += timer->interval;
+                /* Try to compensate for one miss (mwait() will return
+                 * immediately) but no more. Otherwise, we might busy loop,
+                 * after extended periods without scheduling (suspend,
+                 * SIGSTOP, RT preemption, ...). */
+                if (misses > 1)
+                {
+                    misses--;
+                    timer->value += misses * timer->interval;
+                    atomic_fetch_add_explicit (&timer->overruns, misses,
+                                               memory_order_relaxed);
+                }
+                vlc_timer_arm (timer);
+            }
+            else
+                timer->value = 0; /* disarm */
         }
+        timer->running = false;
+        /* Unblock any vlc_timer_destroy() waiting for this callback. */
+        vlc_cond_broadcast (&service.idle);
     }
-
-    vlc_cleanup_pop ();
-    vlc_assert_unreachable ();
+    vlc_mutex_unlock (&service.lock);
+    (void) data;
+    return NULL;
 }
 
 int vlc_timer_create (vlc_timer_t *id, void (*func) (void *), void *data)
@@ -104,23 +175,42 @@ int vlc_timer_create (vlc_timer_t *id, void (*func) (void *), void *data)
 
     if (unlikely(timer == NULL))
         return ENOMEM;
-    vlc_mutex_init (&timer->lock);
-    vlc_cond_init (&timer->reschedule);
     assert (func);
+    timer->next = NULL;
     timer->func = func;
     timer->data = data;
     timer->value = 0;
     timer->interval = 0;
+    timer->armed = false;
+    timer->running = false;
     atomic_init(&timer->overruns, 0);
 
-    if (vlc_clone (&timer->thread, vlc_timer_thread, timer,
-                   VLC_THREAD_PRIORITY_INPUT))
+    vlc_mutex_lock (&service.lock);
+    if (!service.ready)
+    {   /* The static initializer cannot provide monotonic clock condition
+         * variables, so create them on first use (and keep them forever). */
+        vlc_cond_init (&service.wait);
+        vlc_cond_init (&service.idle);
+        service.ready = true;
+    }
+    /* Wait out a concurrent tear-down of the service thread (the last timer
+     * being destroyed while this one is created). */
+    while (service.exit)
+        vlc_cond_wait (&service.idle, &service.lock);
+
+    if (!service.active)
     {
-        vlc_cond_destroy (&timer->reschedule);
-        vlc_mutex_destroy (&timer->lock);
-        free (timer);
-        return ENOMEM;
+        if (vlc_clone (&service.thread, vlc_timer_service_thread, NULL,
+                       VLC_THREAD_PRIORITY_INPUT))
+        {
+            vlc_mutex_unlock (&service.lock);
+            free (timer);
+            return ENOMEM;
+        }
+        service.active = true;
     }
+    service.refs++;
+    vlc_mutex_unlock (&service.lock);
 
     *id = timer;
     return 0;
@@ -128,10 +218,41 @@ int vlc_timer_create (vlc_timer_t *id, void (*func) (void *), void *data)
 
 void vlc_timer_destroy (vlc_timer_t timer)
 {
-    vlc_cancel (timer->thread);
-    vlc_join (timer->thread, NULL);
-    vlc_cond_destroy (&timer->reschedule);
-    vlc_mutex_destroy (&timer->lock);
+    bool stop;
+
+    vlc_mutex_lock (&service.lock);
+    /* Ensure that the timer has no pending nor ongoing iteration: the
+     * service thread may rearm a periodic timer right after its callback
+     * returns, so disarming must be rechecked after each wait. */
+    for (;;)
+    {
+        if (timer->armed)
+            vlc_timer_disarm (timer);
+        if (!timer->running)
+            break;
+        vlc_cond_wait (&service.idle, &service.lock);
+    }
+
+    assert (service.refs > 0);
+    stop = (--service.refs == 0);
+    if (stop)
+    {
+        service.exit = true;
+        vlc_cond_signal (&service.wait);
+    }
+    vlc_mutex_unlock (&service.lock);
+
+    if (stop)
+    {
+        vlc_join (service.thread, NULL);
+        vlc_mutex_lock (&service.lock);
+        service.active = false;
+        service.exit = false;
+        /* Release any vlc_timer_create() stuck waiting for the tear-down. */
+        vlc_cond_broadcast (&service.idle);
+        vlc_mutex_unlock (&service.lock);
+    }
+
     free (timer);
 }
 
@@ -141,11 +262,17 @@ void vlc_timer_schedule (vlc_timer_t timer, bool absolute,
     if (!absolute && value != 0)
         value += mdate();
 
-    vlc_mutex_lock (&timer->lock);
+    vlc_mutex_lock (&service.lock);
+    if (timer->armed)
+        vlc_timer_disarm (timer);
     timer->value = value;
     timer->interval = interval;
-    vlc_cond_signal (&timer->reschedule);
-    vlc_mutex_unlock (&timer->lock);
+    if (value != 0)
+    {
+        vlc_timer_arm (timer);
+        vlc_cond_signal (&service.wait);
+    }
+    vlc_mutex_unlock (&service.lock);
 }
 
 unsigned vlc_timer_getoverrun (vlc_timer_t timer)
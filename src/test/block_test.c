@@ -84,10 +84,42 @@ static void test_block (void)
     //assert (block == NULL);
 }
 
+static void test_fifo_mpsc (void)
+{
+    block_fifo_t *fifo = block_FifoMPSCNew ();
+    assert (fifo != NULL);
+
+    for (unsigned i = 0; i < 10; i++)
+    {
+        block_t *block = block_Alloc (sizeof (i));
+        assert (block != NULL);
+        memcpy (block->p_buffer, &i, sizeof (i));
+        block_FifoPut (fifo, block);
+    }
+
+    assert (block_FifoCount (fifo) == 10);
+
+    for (unsigned i = 0; i < 10; i++)
+    {
+        block_t *block = block_FifoGet (fifo);
+        unsigned value;
+
+        assert (block != NULL);
+        assert (block->i_buffer == sizeof (value));
+        memcpy (&value, block->p_buffer, sizeof (value));
+        assert (value == i); /* FIFO ordering must be preserved */
+        block_Release (block);
+    }
+
+    block_FifoPut (fifo, block_Alloc (1)); /* leak check on release */
+    block_FifoRelease (fifo);
+}
+
 int main (void)
 {
     test_block_File ();
     test_block ();
+    test_fifo_mpsc ();
     return 0;
 }
 
@@ -0,0 +1,57 @@
+/*****************************************************************************
+ * crc.c: test CRC checksums
+ *****************************************************************************
+ * Copyright © 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#undef NDEBUG
+#include <assert.h>
+#include <string.h>
+
+#include <vlc_common.h>
+#include <vlc_crc.h>
+
+int main( void )
+{
+    /* CRC-32/MPEG-2 check value */
+    assert( vlc_crc32( 0xffffffff, "123456789", 9 ) == 0x0376e6e7 );
+
+    /* Chaining must be equivalent to a single pass */
+    assert( vlc_crc32( vlc_crc32( 0xffffffff, "12345", 5 ), "6789", 4 )
+            == 0x0376e6e7 );
+
+    /* A buffer followed by its own big-endian CRC checks out to zero,
+     * the property PSI section validation relies on. */
+    unsigned char buf[32 + 4];
+    for( size_t i = 0; i < 32; i++ )
+        buf[i] = i * 7;
+    uint32_t crc = vlc_crc32( 0xffffffff, buf, 32 );
+    buf[32] = crc >> 24;
+    buf[33] = crc >> 16;
+    buf[34] = crc >> 8;
+    buf[35] = crc;
+    assert( vlc_crc32( 0xffffffff, buf, sizeof (buf) ) == 0 );
+
+    /* Ogg flavour: same polynomial, zero initial value */
+    assert( vlc_crc32( 0, "123456789", 9 ) == 0x89a1897f );
+
+    return 0;
+}
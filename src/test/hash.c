@@ -0,0 +1,73 @@
+/*****************************************************************************
+ * hash.c: test non-cryptographic hashing
+ *****************************************************************************
+ * Copyright © 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#undef NDEBUG
+#include <assert.h>
+#include <string.h>
+
+#include <vlc_common.h>
+#include <vlc_hash.h>
+
+int main( void )
+{
+    /* Published XXH64 test vectors (zero seed) */
+    assert( vlc_hash64( "", 0 ) == UINT64_C(0xEF46DB3751D8E999) );
+    assert( vlc_hash64( "a", 1 ) == UINT64_C(0xD24EC4F1A98C6E5B) );
+    assert( vlc_hash64( "abc", 3 ) == UINT64_C(0x44BC2CF5AD770999) );
+
+    /* Streaming in arbitrary chunks must match the one-shot value,
+     * across both the short path and the 32-byte stripe path */
+    unsigned char data[1000];
+    for( size_t i = 0; i < sizeof (data); i++ )
+        data[i] = (i * 131 + 7) & 0xff;
+
+    static const size_t sizes[] = { 0, 1, 7, 31, 32, 33, 64, 100, 1000 };
+    for( size_t t = 0; t < ARRAY_SIZE(sizes); t++ )
+    {
+        struct vlc_hash64_s h;
+        vlc_hash64_Init( &h, 0 );
+        for( size_t off = 0; off < sizes[t]; )
+        {
+            size_t n = off % 37 + 1;
+            if( n > sizes[t] - off )
+                n = sizes[t] - off;
+            vlc_hash64_Add( &h, data + off, n );
+            off += n;
+        }
+        assert( vlc_hash64_Finish( &h ) == vlc_hash64( data, sizes[t] ) );
+    }
+
+    /* Different seeds must give different hashes */
+    struct vlc_hash64_s h;
+    vlc_hash64_Init( &h, 1 );
+    vlc_hash64_Add( &h, "abc", 3 );
+    assert( vlc_hash64_Finish( &h ) != vlc_hash64( "abc", 3 ) );
+
+    /* Hexadecimal rendering */
+    char hex[17];
+    vlc_hash64_hex( hex, UINT64_C(0x0123456789ABCDEF) );
+    assert( !strcmp( hex, "0123456789abcdef" ) );
+
+    return 0;
+}
@@ -81,14 +81,13 @@ static inline bool isurisafe (int c)
         || (strchr ("-._~", c) != NULL);
 }
 
-static char *encode_URI_bytes (const char *str, size_t *restrict lenp)
+/* Encodes len bytes from str into buf (which must cover the worst case of
+ * 3 * len bytes) and returns the encoded length. */
+static size_t encode_bytes_to (char *restrict buf, const char *str, size_t len)
 {
-    char *buf = malloc (3 * *lenp + 1);
-    if (unlikely(buf == NULL))
-        return NULL;
-
     char *out = buf;
-    for (size_t i = 0; i < *lenp; i++)
+
+    for (size_t i = 0; i < len; i++)
     {
         static const char hex[16] = "0123456789ABCDEF";
         unsigned char c = str[i];
@@ -104,9 +103,18 @@ static char *encode_URI_bytes (const char *str, size_t *restrict lenp)
             *(out++) = hex[c & 0xf];
         }
     }
+    return out - buf;
+}
+
+static char *encode_URI_bytes (const char *str, size_t *restrict lenp)
+{
+    char *buf = malloc (3 * *lenp + 1);
+    if (unlikely(buf == NULL))
+        return NULL;
+
+    *lenp = encode_bytes_to (buf, str, *lenp);
 
-    *lenp = out - buf;
-    out = realloc (buf, *lenp + 1);
+    char *out = realloc (buf, *lenp + 1);
     return likely(out != NULL) ? out : buf;
 }
 
@@ -119,6 +127,17 @@ char *vlc_uri_encode (const char *str)
     return ret;
 }
 
+char *vlc_uri_encode_buf (char *buf, size_t size, const char *str)
+{
+    size_t len = strlen (str);
+
+    if (size < 3 * len + 1)
+        return NULL;
+
+    buf[encode_bytes_to (buf, str, len)] = '\0';
+    return buf;
+}
+
 char *vlc_path2uri (const char *path, const char *scheme)
 {
     if (path == NULL)
@@ -0,0 +1,51 @@
+/*****************************************************************************
+ * tracepoint.h: static user-space tracepoints (USDT)
+ *****************************************************************************
+ * Copyright (C) 2016 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef LIBVLC_TRACEPOINT_H
+# define LIBVLC_TRACEPOINT_H 1
+
+/**
+ * \file
+ * Static tracepoints at the pipeline boundaries, under the "vlc" provider.
+ * They compile to a single NOP unless a tracer attaches, so they are left
+ * enabled in release builds and can be used on production processes with
+ * bpftrace/perf/systemtap without rebuilding, e.g.:
+ *
+ *   bpftrace -e 'usdt:*libvlccore*:vlc:vout_display { @lat = hist(arg1); }'
+ *
+ * Current probes (all timestamps in microseconds, mtime_t):
+ *   demux_send(pts, es_category)   block leaves the demuxer (es_out)
+ *   decoder_video(pts)             decoded picture queued to the vout
+ *   decoder_audio(pts)             decoded buffer queued to the aout
+ *   vout_filter(pts)               picture leaves the vout filter chain
+ *   vout_display(pts, lateness)    picture handed to the display plugin
+ *   aout_play(pts, advance)        buffer enters the audio output pipeline
+ */
+
+#ifdef HAVE_SYS_SDT_H
+# include <sys/sdt.h>
+# define vlc_tracepoint1(point, a)    DTRACE_PROBE1(vlc, point, a)
+# define vlc_tracepoint2(point, a, b) DTRACE_PROBE2(vlc, point, a, b)
+#else
+# define vlc_tracepoint1(point, a)    ((void)(a))
+# define vlc_tracepoint2(point, a, b) ((void)(a), (void)(b))
+#endif
+
+#endif
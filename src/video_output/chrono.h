@@ -34,6 +34,8 @@ typedef struct {
     int     shift_var;
     mtime_t var;
 
+    mtime_t last;
+
     mtime_t start;
 } vout_chrono_t;
 
@@ -46,6 +48,7 @@ static inline void vout_chrono_Init(vout_chrono_t *chrono, int shift, mtime_t av
     chrono->shift_var   = shift+1;
     chrono->var         = avg_initial / 2;
 
+    chrono->last  = 0;
     chrono->start = VLC_TS_INVALID;
 }
 static inline void vout_chrono_Clean(vout_chrono_t *chrono)
@@ -79,6 +82,9 @@ static inline void vout_chrono_Stop(vout_chrono_t *chrono)
     /* Always update the variance */
     chrono->var = (((1 << chrono->shift_var) - 1) * chrono->var + var) >> chrono->shift_var;
 
+    /* Keep the raw sample for per-frame statistics */
+    chrono->last = duration;
+
     /* For assert */
     chrono->start = VLC_TS_INVALID;
 }
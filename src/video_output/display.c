@@ -397,6 +397,12 @@ struct vout_display_owner_sys_t {
 
     bool reset_pictures;
 
+    /* vsync feedback (VOUT_DISPLAY_EVENT_PRESENTED) */
+    struct {
+        mtime_t last;   /* last reported presentation time */
+        mtime_t period; /* estimated refresh period (0 if unknown) */
+    } presented;
+
     bool ch_fullscreen;
     bool is_fullscreen;
 
@@ -712,6 +718,32 @@ static void VoutDisplayEvent(vout_display_t *vd, int event, va_list args)
         vlc_mutex_unlock(&osys->lock);
         break;
     }
+
+    case VOUT_DISPLAY_EVENT_PRESENTED: {
+        const mtime_t date = va_arg(args, mtime_t);
+
+        vlc_mutex_lock(&osys->lock);
+        if (osys->presented.last > VLC_TS_INVALID &&
+            date > osys->presented.last) {
+            mtime_t delta = date - osys->presented.last;
+
+            if (osys->presented.period > 0) {
+                /* Skipped refreshes show up as multiples of the period;
+                 * fold them back before smoothing the estimate. */
+                mtime_t n = (delta + osys->presented.period / 2)
+                          / osys->presented.period;
+                if (n >= 1) {
+                    delta /= n;
+                    osys->presented.period +=
+                        (delta - osys->presented.period) / 8;
+                }
+            } else if (delta < CLOCK_FREQ / 10)
+                osys->presented.period = delta;
+        }
+        osys->presented.last = date;
+        vlc_mutex_unlock(&osys->lock);
+        break;
+    }
     default:
         msg_Err(vd, "VoutDisplayEvent received event %d", event);
         /* TODO add an assert when all event are handled */
@@ -1079,6 +1111,20 @@ picture_t *vout_FilterDisplay(vout_display_t *vd, picture_t *picture)
     return filter_chain_VideoFilter(osys->filters, picture);
 }
 
+bool vout_display_GetPresented(vout_display_t *vd,
+                               mtime_t *last, mtime_t *period)
+{
+    vout_display_owner_sys_t *osys = vd->owner.sys;
+    bool valid;
+
+    vlc_mutex_lock(&osys->lock);
+    valid = osys->presented.last > VLC_TS_INVALID && osys->presented.period > 0;
+    *last   = osys->presented.last;
+    *period = osys->presented.period;
+    vlc_mutex_unlock(&osys->lock);
+    return valid;
+}
+
 void vout_UpdateDisplaySourceProperties(vout_display_t *vd, const video_format_t *source)
 {
     vout_display_owner_sys_t *osys = vd->owner.sys;
@@ -1217,6 +1263,9 @@ static vout_display_t *DisplayNew(vout_thread_t *vout,
 
     vlc_mutex_init(&osys->lock);
 
+    osys->presented.last   = VLC_TS_INVALID;
+    osys->presented.period = 0;
+
     vlc_mouse_Init(&osys->mouse.state);
     osys->mouse.last_moved = mdate();
     osys->mouse.double_click_timeout = double_click_timeout;
@@ -1408,7 +1457,7 @@ static picture_pool_t *SplitterPool(vout_display_t *vd, unsigned count)
 {
     vout_display_sys_t *sys = vd->sys;
     if (!sys->pool)
-        sys->pool = picture_pool_NewFromFormat(&vd->fmt, count);
+        sys->pool = picture_pool_NewFromFormatLocal(&vd->fmt, count);
     return sys->pool;
 }
 static void SplitterPrepare(vout_display_t *vd,
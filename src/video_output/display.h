@@ -39,3 +39,9 @@ void vout_DeleteDisplayWindow(vout_thread_t *, vout_window_t *);
 void vout_SetDisplayWindowSize(vout_thread_t *, unsigned, unsigned);
 
 void vout_UpdateDisplaySourceProperties(vout_display_t *vd, const video_format_t *);
+
+/* Retrieves the last reported presentation time and the estimated display
+ * refresh period. Returns false until the display has provided vsync
+ * feedback (VOUT_DISPLAY_EVENT_PRESENTED). */
+bool vout_display_GetPresented(vout_display_t *vd,
+                               mtime_t *last, mtime_t *period);
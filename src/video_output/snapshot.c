@@ -49,16 +49,15 @@ void vout_snapshot_Init(vout_snapshot_t *snap)
 
     snap->is_available = true;
     snap->request_count = 0;
+    snap->pending_count = 0;
     snap->picture = NULL;
+    video_format_Init(&snap->fmt, 0);
 }
 void vout_snapshot_Clean(vout_snapshot_t *snap)
 {
-    picture_t *picture = snap->picture;
-    while (picture) {
-        picture_t *next = picture->p_next;
-        picture_Release(picture);
-        picture = next;
-    }
+    if (snap->picture)
+        picture_Release(snap->picture);
+    video_format_Clean(&snap->fmt);
 
     vlc_cond_destroy(&snap->wait);
     vlc_mutex_destroy(&snap->lock);
@@ -89,14 +88,32 @@ picture_t *vout_snapshot_Get(vout_snapshot_t *snap, mtime_t timeout)
         vlc_cond_timedwait(&snap->wait, &snap->lock, deadline) == 0);
 
     /* */
-    picture_t *picture = snap->picture;
-    if (picture)
-        snap->picture = picture->p_next;
-    else if (snap->request_count > 0)
+    picture_t *held = NULL;
+    video_format_t fmt;
+    if (snap->picture) {
+        held = picture_Hold(snap->picture);
+        if (--snap->pending_count <= 0) {
+            picture_Release(snap->picture);
+            snap->picture = NULL;
+        }
+        video_format_Copy(&fmt, &snap->fmt);
+    } else if (snap->request_count > 0) {
         snap->request_count--;
+    }
 
     vlc_mutex_unlock(&snap->lock);
 
+    if (!held)
+        return NULL;
+
+    /* Copy the display picture on the requesting thread; the vout only
+     * paid for the reference grab done in vout_snapshot_Set(). */
+    picture_t *picture = picture_NewFromFormat(&fmt);
+    if (picture)
+        picture_Copy(picture, held);
+    picture_Release(held);
+    video_format_Clean(&fmt);
+
     return picture;
 }
 
@@ -112,22 +129,23 @@ bool vout_snapshot_IsRequested(vout_snapshot_t *snap)
 }
 void vout_snapshot_Set(vout_snapshot_t *snap,
                        const video_format_t *fmt,
-                       const picture_t *picture)
+                       picture_t *picture)
 {
     if (!fmt)
         fmt = &picture->format;
 
     vlc_mutex_lock(&snap->lock);
-    while (snap->request_count > 0) {
-        picture_t *dup = picture_NewFromFormat(fmt);
-        if (!dup)
-            break;
+    if (snap->request_count > 0) {
+        video_format_Clean(&snap->fmt);
+        video_format_Copy(&snap->fmt, fmt);
 
-        picture_Copy(dup, picture);
+        /* Drop a picture the requesters did not collect in time */
+        if (snap->picture)
+            picture_Release(snap->picture);
+        snap->picture = picture_Hold(picture);
 
-        dup->p_next = snap->picture;
-        snap->picture = dup;
-        snap->request_count--;
+        snap->pending_count = snap->request_count;
+        snap->request_count = 0;
     }
     vlc_cond_broadcast(&snap->wait);
     vlc_mutex_unlock(&snap->lock);
@@ -32,7 +32,9 @@ typedef struct {
 
 	bool        is_available;
 	int         request_count;
-	picture_t   *picture;
+	int         pending_count; /**< grabbed pictures not yet collected */
+	picture_t   *picture;      /**< display picture held for the requesters */
+	video_format_t fmt;        /**< format override for the held picture */
 
 } vout_snapshot_t;
 
@@ -53,11 +55,13 @@ bool vout_snapshot_IsRequested(vout_snapshot_t *);
 /**
  * It set the picture used to create the snapshots.
  *
- * The given picture is only copied and not released.
+ * Only a new reference to the given picture is grabbed; the actual copy
+ * is done by vout_snapshot_Get() on the requesting thread, so this call
+ * stays cheap for the vout.
  * If p_fmt is non NULL it will override the format of the p_picture (mainly
  * used because of aspect/crop problems).
  */
-void vout_snapshot_Set(vout_snapshot_t *, const video_format_t *, const picture_t *);
+void vout_snapshot_Set(vout_snapshot_t *, const video_format_t *, picture_t *);
 
 /**
  * This function will return the directory used for snapshots
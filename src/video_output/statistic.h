@@ -25,18 +25,43 @@
 # define LIBVLC_VOUT_STATISTIC_H
 # include <vlc_atomic.h>
 
+/* Number of logarithmic lateness buckets: bucket 0 counts frames less than
+ * 1 ms late (or early), bucket i frames between 2^(i-1) and 2^i ms late, and
+ * the last bucket everything above. Percentiles (e.g. p99) can be derived
+ * from the bucket counts with millisecond-scale resolution. */
+# define VOUT_STATISTIC_BUCKETS 16
+
+/* Depth of the per-frame record ring */
+# define VOUT_STATISTIC_RECORDS 128
+
+typedef struct {
+    mtime_t render;   /* filtering + rendering duration */
+    mtime_t lateness; /* effective display time minus deadline */
+} vout_frame_stat_t;
+
 /* NOTE: Both statistics are atomic on their own, so one might be older than
  * the other one. Currently, only one of them is updated at a time, so this
  * is a non-issue. */
 typedef struct {
     atomic_uint displayed;
     atomic_uint lost;
+    /* Lateness histogram (see VOUT_STATISTIC_BUCKETS) */
+    atomic_uint late[VOUT_STATISTIC_BUCKETS];
+    /* Ring of the most recent per-frame records; written by the vout thread
+     * only, without synchronization. */
+    vout_frame_stat_t record[VOUT_STATISTIC_RECORDS];
+    unsigned record_index;
 } vout_statistic_t;
 
 static inline void vout_statistic_Init(vout_statistic_t *stat)
 {
     atomic_init(&stat->displayed, 0);
     atomic_init(&stat->lost, 0);
+    for (int i = 0; i < VOUT_STATISTIC_BUCKETS; i++)
+        atomic_init(&stat->late[i], 0);
+    for (int i = 0; i < VOUT_STATISTIC_RECORDS; i++)
+        stat->record[i] = (vout_frame_stat_t) { 0, 0 };
+    stat->record_index = 0;
 }
 
 static inline void vout_statistic_Clean(vout_statistic_t *stat)
@@ -61,4 +86,27 @@ static inline void vout_statistic_AddLost(vout_statistic_t *stat, int lost)
     atomic_fetch_add(&stat->lost, lost);
 }
 
+/* Records one displayed frame; returns true whenever the record ring has
+ * wrapped, i.e. every VOUT_STATISTIC_RECORDS frames. */
+static inline bool vout_statistic_AddFrame(vout_statistic_t *stat,
+                                           mtime_t render, mtime_t lateness)
+{
+    int bucket = 0;
+    while (bucket < VOUT_STATISTIC_BUCKETS - 1 &&
+           lateness >= (mtime_t)1000 << bucket)
+        bucket++;
+    atomic_fetch_add(&stat->late[bucket], 1);
+
+    stat->record[stat->record_index] = (vout_frame_stat_t) { render, lateness };
+    stat->record_index = (stat->record_index + 1) % VOUT_STATISTIC_RECORDS;
+    return stat->record_index == 0;
+}
+
+static inline void vout_statistic_GetLateReset(vout_statistic_t *stat,
+                                               unsigned late[VOUT_STATISTIC_BUCKETS])
+{
+    for (int i = 0; i < VOUT_STATISTIC_BUCKETS; i++)
+        late[i] = atomic_exchange(&stat->late[i], 0);
+}
+
 #endif
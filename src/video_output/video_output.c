@@ -36,6 +36,7 @@
 
 #include <vlc_common.h>
 
+#include <stdio.h>
 #include <stdlib.h>                                                /* free() */
 #include <string.h>
 #include <assert.h>
@@ -48,6 +49,7 @@
 #include <vlc_image.h>
 
 #include <libvlc.h>
+#include "../tracepoint.h"
 #include "vout_internal.h"
 #include "interlacing.h"
 #include "display.h"
@@ -118,6 +120,10 @@ static vout_thread_t *VoutCreate(vlc_object_t *object,
     if (VoutValidateFormat(&original, cfg->fmt))
         return NULL;
 
+    /* The window may emit "key-pressed" events, make sure the hotkey
+     * tables mapping them to actions exist even without an interface */
+    libvlc_InternalActionsInit(object->p_libvlc);
+
     /* Allocate descriptor */
     vout_thread_t *vout = vlc_custom_create(object,
                                             sizeof(*vout) + sizeof(*vout->p),
@@ -646,9 +652,9 @@ static void ThreadFilterFlush(vout_thread_t *vout, bool is_locked)
         picture_Release( vout->p->displayed.current );
     vout->p->displayed.current = NULL;
 
-    if (vout->p->displayed.next)
-        picture_Release( vout->p->displayed.next );
-    vout->p->displayed.next = NULL;
+    for (unsigned i = 0; i < vout->p->displayed.next_count; i++)
+        picture_Release( vout->p->displayed.next[i] );
+    vout->p->displayed.next_count = 0;
 
     if (!is_locked)
         vlc_mutex_lock(&vout->p->filter.lock);
@@ -808,14 +814,42 @@ static int ThreadDisplayPreparePicture(vout_thread_t *vout, bool reuse, bool fra
     if (!picture)
         return VLC_EGENERIC;
 
-    assert(!vout->p->displayed.next);
     if (!vout->p->displayed.current)
         vout->p->displayed.current = picture;
-    else
-        vout->p->displayed.next    = picture;
+    else {
+        assert(vout->p->displayed.next_count < VOUT_RENDER_AHEAD);
+        vout->p->displayed.next[vout->p->displayed.next_count++] = picture;
+    }
     return VLC_SUCCESS;
 }
 
+/* Remove the head of the prepared picture queue (NULL if empty) */
+static picture_t *ThreadDisplayNextPop(vout_thread_t *vout)
+{
+    if (vout->p->displayed.next_count == 0)
+        return NULL;
+
+    picture_t *picture = vout->p->displayed.next[0];
+    vout->p->displayed.next_count--;
+    memmove(&vout->p->displayed.next[0], &vout->p->displayed.next[1],
+            vout->p->displayed.next_count * sizeof (picture_t *));
+    return picture;
+}
+
+/* Export the lateness histogram of the elapsed measurement window through
+ * the "frame-latency-histogram" variable, so frame timing (e.g. p99
+ * lateness) can be monitored without attaching a profiler. */
+static void ThreadExportLateHistogram(vout_thread_t *vout)
+{
+    unsigned late[VOUT_STATISTIC_BUCKETS];
+    char buf[VOUT_STATISTIC_BUCKETS * 11], *p = buf;
+
+    vout_statistic_GetLateReset(&vout->p->statistic, late);
+    for (int i = 0; i < VOUT_STATISTIC_BUCKETS; i++)
+        p += sprintf(p, "%s%u", i > 0 ? " " : "", late[i]);
+    var_SetString(vout, "frame-latency-histogram", buf);
+}
+
 static int ThreadDisplayRenderPicture(vout_thread_t *vout, bool is_forced)
 {
     vout_thread_sys_t *sys = vout->p;
@@ -832,6 +866,8 @@ static int ThreadDisplayRenderPicture(vout_thread_t *vout, bool is_forced)
     if (!filtered)
         return VLC_EGENERIC;
 
+    vlc_tracepoint1(vout_filter, filtered->date);
+
     if (filtered->date != vout->p->displayed.current->date)
         msg_Warn(vout, "Unsupported timestamp modifications done by chain_interactive");
 
@@ -1006,14 +1042,39 @@ static int ThreadDisplayRenderPicture(vout_thread_t *vout, bool is_forced)
     if (delay < 1000)
         msg_Warn(vout, "picture is late (%lld ms)", delay / 1000);
 #endif
-    if (!is_forced)
-        mwait(todisplay->date);
+    if (!is_forced) {
+        mtime_t deadline = todisplay->date;
+        mtime_t presented, period;
+
+        /* When the display reports actual presentation times, phase-lock
+         * the wake-up to the measured refresh instead of trusting the
+         * nominal deadline: aim at the predicted vsync nearest the frame
+         * date and wake a quarter period early so the swap reaches it.
+         * This absorbs e.g. the 59.94-on-60Hz beat that a blind mwait()
+         * turns into periodic judder. */
+        if (vout_display_GetPresented(vd, &presented, &period)) {
+            mtime_t offset = (deadline - presented) % period;
+            if (offset < 0)
+                offset += period;
+
+            mtime_t vsync = deadline - offset;
+            if (offset > period / 2)
+                vsync += period;
+            deadline = vsync - period / 4;
+        }
+        mwait(deadline);
+    }
 
     /* Display the direct buffer returned by vout_RenderPicture */
     vout->p->displayed.date = mdate();
+    const mtime_t lateness = vout->p->displayed.date - todisplay->date;
+    vlc_tracepoint2(vout_display, todisplay->date, lateness);
     vout_display_Display(vd, todisplay, subpic);
 
     vout_statistic_AddDisplayed(&vout->p->statistic, 1);
+    if (vout_statistic_AddFrame(&vout->p->statistic, vout->p->render.last,
+                                lateness))
+        ThreadExportLateHistogram(vout);
 
     return VLC_SUCCESS;
 }
@@ -1028,8 +1089,35 @@ static int ThreadDisplayPicture(vout_thread_t *vout, mtime_t *deadline)
         if (ThreadDisplayPreparePicture(vout, true, frame_by_frame)) /* FIXME not sure it is ok */
             return VLC_EGENERIC;
 
+    /* Pictures prepared ahead of time bypassed the lateness check done
+     * when pulling from the decoder fifo; redo it here so that a long
+     * stall does not get a whole queue of stale pictures displayed. */
+    if (vout->p->is_late_dropped && !paused && !frame_by_frame) {
+        while (vout->p->displayed.next_count > 0) {
+            picture_t *next = vout->p->displayed.next[0];
+            const mtime_t late = mdate() - next->date;
+
+            if (next->b_force || late <= VOUT_DISPLAY_LATE_THRESHOLD)
+                break;
+            msg_Warn(vout, "prepared picture is too late to be displayed (missing %"PRId64" ms)", late/1000);
+            picture_Release(ThreadDisplayNextPop(vout));
+            vout_statistic_AddLost(&vout->p->statistic, 1);
+        }
+    }
+
+    /* Render ahead: top up the queue of prepared pictures, so that the
+     * static filters run on future pictures while the current one is
+     * waiting for its display date. Without static filters this would
+     * only hold decoder pictures longer, so keep a single one then. */
+    vlc_mutex_lock(&vout->p->filter.lock);
+    const unsigned ahead =
+        filter_chain_GetLength(vout->p->filter.chain_static) > 0 ?
+            VOUT_RENDER_AHEAD : 1;
+    vlc_mutex_unlock(&vout->p->filter.lock);
+
     if (!paused || frame_by_frame)
-        while (!vout->p->displayed.next && !ThreadDisplayPreparePicture(vout, false, frame_by_frame))
+        while (vout->p->displayed.next_count < ahead &&
+               !ThreadDisplayPreparePicture(vout, false, frame_by_frame))
             ;
 
     const mtime_t date = mdate();
@@ -1037,8 +1125,8 @@ static int ThreadDisplayPicture(vout_thread_t *vout, mtime_t *deadline)
 
     bool drop_next_frame = frame_by_frame;
     mtime_t date_next = VLC_TS_INVALID;
-    if (!paused && vout->p->displayed.next) {
-        date_next = vout->p->displayed.next->date - render_delay;
+    if (!paused && vout->p->displayed.next_count > 0) {
+        date_next = vout->p->displayed.next[0]->date - render_delay;
         if (date_next /* + 0 FIXME */ <= date)
             drop_next_frame = true;
     }
@@ -1073,8 +1161,7 @@ static int ThreadDisplayPicture(vout_thread_t *vout, mtime_t *deadline)
 
     if (drop_next_frame) {
         picture_Release(vout->p->displayed.current);
-        vout->p->displayed.current = vout->p->displayed.next;
-        vout->p->displayed.next    = NULL;
+        vout->p->displayed.current = ThreadDisplayNextPop(vout);
     }
 
     if (!vout->p->displayed.current)
@@ -1291,7 +1378,9 @@ static void ThreadExecuteCropRatio(vout_thread_t *vout,
 static int ThreadStart(vout_thread_t *vout, const vout_display_state_t *state)
 {
     vlc_mouse_Init(&vout->p->mouse);
-    vout->p->decoder_fifo = picture_fifo_New();
+    /* Decoder thread pushes, vout thread pops: SPSC, so use the lock-free
+     * ring and keep 120fps+ content from serializing both threads. */
+    vout->p->decoder_fifo = picture_fifo_NewSPSC(VOUT_MAX_PICTURES);
     vout->p->decoder_pool = NULL;
     vout->p->display_pool = NULL;
     vout->p->private_pool = NULL;
@@ -1337,7 +1426,7 @@ static int ThreadStart(vout_thread_t *vout, const vout_display_state_t *state)
     assert(vout->p->decoder_pool);
 
     vout->p->displayed.current       = NULL;
-    vout->p->displayed.next          = NULL;
+    vout->p->displayed.next_count    = 0;
     vout->p->displayed.decoded       = NULL;
     vout->p->displayed.date          = VLC_TS_INVALID;
     vout->p->displayed.timestamp     = VLC_TS_INVALID;
@@ -1563,6 +1652,8 @@ static void *Thread(void *object)
     vout_thread_t *vout = object;
     vout_thread_sys_t *sys = vout->p;
 
+    vlc_thread_SetRole(vout, "vout");
+
     vout_interlacing_support_t interlacing = {
         .is_interlaced = false,
         .date = mdate(),
@@ -43,6 +43,15 @@
  */
 #define VOUT_MAX_PICTURES (20)
 
+/* Number of pictures the vout thread runs through the static filter chain
+ * ahead of their display date, while the current picture is waiting for
+ * its deadline. A spike on one frame (deinterlacer, postproc...) is then
+ * paid out of the queued slack instead of showing up as a late frame.
+ *
+ * Each extra picture costs one entry in the private pool, so keep it
+ * small. */
+#define VOUT_RENDER_AHEAD (3)
+
 /* */
 struct vout_thread_sys_t
 {
@@ -89,7 +98,9 @@ struct vout_thread_sys_t
         bool        is_interlaced;
         picture_t   *decoded;
         picture_t   *current;
-        picture_t   *next;
+        picture_t   *next[VOUT_RENDER_AHEAD]; /**< prepared pictures, in
+                                                   display order */
+        unsigned    next_count;
     } displayed;
 
     struct {
@@ -788,8 +788,18 @@ static void SpuRenderRegion(spu_t *spu,
             if (changed_palette)
                 is_changed = true;
 
-            if (convert_chroma && private->fmt.i_chroma != chroma_list[0])
-                is_changed = true;
+            /* The cached conversion remains usable as long as its chroma
+             * is still acceptable to the caller. Requiring the first
+             * entry would rebuild the cache every time the chroma list
+             * alternates, e.g. when a snapshot falls back from the
+             * display SPU chromas to the default list and back. */
+            if (convert_chroma) {
+                bool is_acceptable = false;
+                for (int i = 0; chroma_list[i] && !is_acceptable; i++)
+                    is_acceptable = private->fmt.i_chroma == chroma_list[i];
+                if (!is_acceptable)
+                    is_changed = true;
+            }
 
             if (is_changed) {
                 subpicture_region_private_Delete(private);
@@ -124,7 +124,8 @@ int vout_InitWrapper(vout_thread_t *vout)
 
     sys->display.use_dr = !vout_IsDisplayFiltered(vd);
     const bool allow_dr = !vd->info.has_pictures_invalid && !vd->info.is_slow && sys->display.use_dr;
-    const unsigned private_picture  = 4; /* XXX 3 for filter, 1 for SPU */
+    /* XXX 3 for filter, 1 for SPU, plus the render-ahead queue */
+    const unsigned private_picture  = 4 + VOUT_RENDER_AHEAD;
     const unsigned decoder_picture  = 1 + sys->dpb_size;
     const unsigned kept_picture     = 1; /* last displayed picture */
     const unsigned reserved_picture = DISPLAY_PICTURE_COUNT +
@@ -149,7 +150,7 @@ int vout_InitWrapper(vout_thread_t *vout)
         sys->display_pool = display_pool;
     } else if (!sys->decoder_pool) {
         sys->decoder_pool =
-            picture_pool_NewFromFormat(&source,
+            picture_pool_NewFromFormatLocal(&source,
                                        __MAX(VOUT_MAX_PICTURES,
                                              reserved_picture + decoder_picture - DISPLAY_PICTURE_COUNT));
         if (!sys->decoder_pool)
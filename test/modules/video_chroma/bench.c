@@ -0,0 +1,211 @@
+/*****************************************************************************
+ * bench.c: chroma conversion benchmark
+ *****************************************************************************
+ * Copyright (C) 2016 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+/* Times the chroma converters of modules/video_chroma across picture sizes
+ * and implementations (C/MMX/SSE2...), printing per-frame time and
+ * throughput. Not run as part of "make check": build and run it by hand
+ * with "make vlc-bench-chroma" when touching conversion code. */
+
+#include "../../libvlc/test.h"
+#include "../../../lib/libvlc_internal.h"
+
+#include <vlc_modules.h>
+#include <vlc_filter.h>
+#include <vlc_picture.h>
+#include <vlc_cpu.h>
+
+#include <inttypes.h>
+#include <stdio.h>
+
+/* Wall-clock time spent measuring each converter/size combination */
+#define BENCH_RUN_TIME (CLOCK_FREQ / 4)
+#define BENCH_WARMUP_ITERATIONS 4
+
+static const struct
+{
+    vlc_fourcc_t src, dst;
+    /* candidate implementations, requested by module name; NULL stands
+     * for "whatever module_need() picks for this CPU" */
+    const char *ppsz_modules[4];
+} conversions[] = {
+    { VLC_CODEC_I420, VLC_CODEC_YUYV,
+      { NULL, "i420_yuy2", "i420_yuy2_mmx", "i420_yuy2_sse2" } },
+    { VLC_CODEC_I420, VLC_CODEC_RGB16,
+      { NULL, "i420_rgb", "i420_rgb_mmx", "i420_rgb_sse2" } },
+    { VLC_CODEC_I420, VLC_CODEC_RGB32,
+      { NULL, "i420_rgb", "i420_rgb_mmx", "i420_rgb_sse2" } },
+    { VLC_CODEC_I422, VLC_CODEC_YUYV,
+      { NULL, "i422_yuy2", "i422_yuy2_mmx", "i422_yuy2_sse2" } },
+    { VLC_CODEC_I422, VLC_CODEC_I420,
+      { NULL } },
+    { VLC_CODEC_YUYV, VLC_CODEC_I420,
+      { NULL } },
+    { VLC_CODEC_YUYV, VLC_CODEC_I422,
+      { NULL } },
+};
+
+static const struct
+{
+    unsigned width, height;
+} sizes[] = {
+    {  640,  480 },
+    { 1280,  720 },
+    { 1920, 1080 },
+    { 3840, 2160 },
+};
+
+struct bench_owner
+{
+    picture_t *p_out;
+};
+
+static picture_t *BenchNewPicture( filter_t *p_filter )
+{
+    struct bench_owner *p_owner = p_filter->owner.sys;
+
+    /* Hand out the same preallocated picture over and over, so that
+     * allocations do not show up in the measurement */
+    return picture_Hold( p_owner->p_out );
+}
+
+static size_t picture_Bytes( const picture_t *p_pic )
+{
+    size_t i_bytes = 0;
+
+    for( int i = 0; i < p_pic->i_planes; i++ )
+        i_bytes += (size_t)p_pic->p[i].i_visible_pitch
+                 * p_pic->p[i].i_visible_lines;
+    return i_bytes;
+}
+
+static void BenchConversion( libvlc_int_t *p_libvlc, vlc_fourcc_t i_src,
+                             vlc_fourcc_t i_dst, const char *psz_module,
+                             unsigned i_width, unsigned i_height )
+{
+    struct bench_owner owner = { NULL };
+    video_format_t fmt_src, fmt_dst;
+
+    video_format_Init( &fmt_src, i_src );
+    video_format_Setup( &fmt_src, i_src, i_width, i_height,
+                        i_width, i_height, 1, 1 );
+    video_format_Init( &fmt_dst, i_dst );
+    video_format_Setup( &fmt_dst, i_dst, i_width, i_height,
+                        i_width, i_height, 1, 1 );
+
+    picture_t *p_in = picture_NewFromFormat( &fmt_src );
+    owner.p_out = picture_NewFromFormat( &fmt_dst );
+    assert( p_in != NULL && owner.p_out != NULL );
+
+    filter_t *p_filter = vlc_object_create( p_libvlc, sizeof (*p_filter) );
+    assert( p_filter != NULL );
+    p_filter->owner.sys = &owner;
+    p_filter->owner.video.buffer_new = BenchNewPicture;
+    es_format_InitFromVideo( &p_filter->fmt_in, &fmt_src );
+    es_format_InitFromVideo( &p_filter->fmt_out, &fmt_dst );
+
+    p_filter->p_module = module_need( p_filter, "video filter2",
+                                      psz_module, psz_module != NULL );
+    if( p_filter->p_module == NULL )
+    {   /* Implementation not built or rejected on this CPU: not a failure */
+        printf( "%4.4s -> %4.4s  %ux%u  %-16s unavailable\n",
+                (const char *)&i_src, (const char *)&i_dst,
+                i_width, i_height,
+                psz_module ? psz_module : "(default)" );
+        goto out;
+    }
+
+    for( unsigned i = 0; i < BENCH_WARMUP_ITERATIONS; i++ )
+    {
+        picture_Hold( p_in );
+        picture_t *p_out = p_filter->pf_video_filter( p_filter, p_in );
+        assert( p_out != NULL );
+        picture_Release( p_out );
+    }
+
+    unsigned i_iterations = 0;
+    mtime_t i_start = mdate(), i_elapsed;
+
+    do
+    {
+        picture_Hold( p_in );
+        picture_t *p_out = p_filter->pf_video_filter( p_filter, p_in );
+        assert( p_out != NULL );
+        picture_Release( p_out );
+        i_iterations++;
+        i_elapsed = mdate() - i_start;
+    }
+    while( i_elapsed < BENCH_RUN_TIME );
+
+    size_t i_bytes = picture_Bytes( p_in ) + picture_Bytes( owner.p_out );
+    double f_seconds = i_elapsed / (double)CLOCK_FREQ;
+    double f_gbps = i_iterations * i_bytes / f_seconds / 1e9;
+    double f_mpixps = i_iterations * (double)i_width * i_height
+                    / f_seconds / 1e6;
+
+    printf( "%4.4s -> %4.4s  %ux%u  %-16s %8.1f us/frame  %7.1f Mpix/s"
+            "  %5.2f GB/s\n",
+            (const char *)&i_src, (const char *)&i_dst, i_width, i_height,
+            module_get_object( p_filter->p_module ),
+            i_elapsed / (double)i_iterations, f_mpixps, f_gbps );
+
+    module_unneed( p_filter, p_filter->p_module );
+out:
+    es_format_Clean( &p_filter->fmt_in );
+    es_format_Clean( &p_filter->fmt_out );
+    vlc_object_release( p_filter );
+    picture_Release( p_in );
+    picture_Release( owner.p_out );
+}
+
+int main( void )
+{
+    test_init();
+
+    const char *argv[] = {
+        "--ignore-config",
+        "-I", "dummy",
+    };
+    libvlc_instance_t *p_vlc = libvlc_new( sizeof (argv) / sizeof (argv[0]),
+                                           argv );
+    assert( p_vlc != NULL );
+
+    printf( "CPU capabilities: 0x%x\n", vlc_CPU() );
+
+    for( size_t i = 0; i < sizeof (conversions) / sizeof (conversions[0]);
+         i++ )
+        for( size_t j = 0; j < sizeof (sizes) / sizeof (sizes[0]); j++ )
+        {
+            for( size_t k = 0;
+                 k < sizeof (conversions[i].ppsz_modules)
+                   / sizeof (conversions[i].ppsz_modules[0]); k++ )
+            {
+                if( k > 0 && conversions[i].ppsz_modules[k] == NULL )
+                    break;
+                BenchConversion( p_vlc->p_libvlc_int,
+                                 conversions[i].src, conversions[i].dst,
+                                 conversions[i].ppsz_modules[k],
+                                 sizes[j].width, sizes[j].height );
+            }
+            printf( "\n" );
+        }
+
+    libvlc_release( p_vlc );
+    return 0;
+}
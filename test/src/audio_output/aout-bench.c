@@ -0,0 +1,251 @@
+/*****************************************************************************
+ * aout-bench.c: audio output pipeline benchmark
+ *****************************************************************************
+ * Copyright (C) 2016 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+/* Pushes synthetic buffers through aout_FiltersNew()-built chains
+ * (converters, resampler, user filters such as the equalizer) and through
+ * the "audio volume" amplifiers, printing ns/frame per stage and the
+ * speedup over realtime. Not run as part of "make check": build and run it
+ * by hand with "make vlc-bench-aout" when touching audio filter code. */
+
+#include "../../libvlc/test.h"
+#include "../../../lib/libvlc_internal.h"
+
+#include <vlc_modules.h>
+#include <vlc_aout.h>
+#include <vlc_aout_volume.h>
+#include <vlc_block.h>
+#include <vlc_cpu.h>
+#include <vlc_input.h>
+
+#include <inttypes.h>
+#include <stdio.h>
+
+/* Wall-clock time spent measuring each chain */
+#define BENCH_RUN_TIME (CLOCK_FREQ / 4)
+#define BENCH_WARMUP_ITERATIONS 8
+/* Typical decoder output size */
+#define BENCH_FRAMES 1024
+
+static const struct
+{
+    const char *psz_name;
+    vlc_fourcc_t i_in_format;
+    unsigned i_in_rate;
+    vlc_fourcc_t i_out_format;
+    unsigned i_out_rate;
+    const char *psz_filters; /* "audio-filter" chain, NULL for none */
+} chains[] = {
+    { "s16n -> fl32",            VLC_CODEC_S16N, 48000,
+                                 VLC_CODEC_FL32, 48000, NULL },
+    { "resample 44.1k -> 48k",   VLC_CODEC_FL32, 44100,
+                                 VLC_CODEC_FL32, 48000, NULL },
+    { "s16n 44.1k -> fl32 48k",  VLC_CODEC_S16N, 44100,
+                                 VLC_CODEC_FL32, 48000, NULL },
+    { "equalizer",               VLC_CODEC_FL32, 48000,
+                                 VLC_CODEC_FL32, 48000, "equalizer" },
+};
+
+static void InitFormat( audio_sample_format_t *fmt, vlc_fourcc_t i_format,
+                        unsigned i_rate )
+{
+    memset( fmt, 0, sizeof (*fmt) );
+    fmt->i_format = i_format;
+    fmt->i_rate = i_rate;
+    fmt->i_physical_channels = AOUT_CHANS_STEREO;
+    fmt->i_original_channels = AOUT_CHANS_STEREO;
+    aout_FormatPrepare( fmt );
+}
+
+/* Fills a template decoder buffer with a -6 dBFS triangle wave, so that
+ * the filters chew on plausible data rather than on silence */
+static block_t *MakeTemplate( const audio_sample_format_t *fmt )
+{
+    size_t i_bytes = BENCH_FRAMES * fmt->i_bytes_per_frame;
+    block_t *block = block_Alloc( i_bytes );
+    assert( block != NULL );
+    block->i_nb_samples = BENCH_FRAMES;
+
+    for( unsigned i = 0; i < BENCH_FRAMES; i++ )
+    {
+        unsigned period = fmt->i_rate / 440;
+        unsigned phase = i % period;
+        double v = (phase < period / 2)
+            ? -0.5 + 2. * phase / period
+            : 1.5 - 2. * phase / period;
+
+        for( unsigned c = 0; c < 2; c++ )
+            if( fmt->i_format == VLC_CODEC_FL32 )
+                ((float *)block->p_buffer)[2 * i + c] = v;
+            else
+                ((int16_t *)block->p_buffer)[2 * i + c] = v * INT16_MAX;
+    }
+    return block;
+}
+
+static void PrintResult( const char *psz_name, uint64_t i_frames,
+                         unsigned i_rate, mtime_t i_elapsed )
+{
+    double f_seconds = i_elapsed / (double)CLOCK_FREQ;
+
+    printf( "%-24s %8.1f ns/frame  %8.1fx realtime\n", psz_name,
+            i_elapsed * 1000. / i_frames,
+            i_frames / (double)i_rate / f_seconds );
+}
+
+static void BenchChain( libvlc_int_t *p_libvlc, const char *psz_name,
+                        vlc_fourcc_t i_in_format, unsigned i_in_rate,
+                        vlc_fourcc_t i_out_format, unsigned i_out_rate,
+                        const char *psz_filters )
+{
+    audio_sample_format_t infmt, outfmt;
+
+    InitFormat( &infmt, i_in_format, i_in_rate );
+    InitFormat( &outfmt, i_out_format, i_out_rate );
+
+    /* Dedicated parent so the "audio-filter" selection does not leak from
+     * one chain to the next */
+    vlc_object_t *parent = vlc_object_create( p_libvlc,
+                                              sizeof (vlc_object_t) );
+    assert( parent != NULL );
+    var_Create( parent, "audio-filter", VLC_VAR_STRING );
+    if( psz_filters != NULL )
+        var_SetString( parent, "audio-filter", psz_filters );
+
+    aout_filters_t *filters = aout_FiltersNew( parent, &infmt, &outfmt,
+                                               NULL );
+    if( filters == NULL )
+    {   /* Filter or converter not built: not a failure */
+        printf( "%-24s unavailable\n", psz_name );
+        vlc_object_release( parent );
+        return;
+    }
+
+    block_t *template = MakeTemplate( &infmt );
+    date_t date;
+    date_Init( &date, i_in_rate, 1 );
+    date_Set( &date, VLC_TS_0 );
+
+    uint64_t i_frames = 0;
+    mtime_t i_start = 0, i_elapsed = 0;
+
+    for( unsigned i = 0; i_elapsed < BENCH_RUN_TIME; i++ )
+    {
+        if( i == BENCH_WARMUP_ITERATIONS )
+        {   /* Warmed up: start measuring for real */
+            i_frames = 0;
+            i_start = mdate();
+        }
+
+        block_t *block = block_Alloc( template->i_buffer );
+        assert( block != NULL );
+        memcpy( block->p_buffer, template->p_buffer, template->i_buffer );
+        block->i_nb_samples = BENCH_FRAMES;
+        block->i_pts = date_Get( &date );
+        block->i_length = date_Increment( &date, BENCH_FRAMES )
+                        - block->i_pts;
+
+        block = aout_FiltersPlay( filters, block, INPUT_RATE_DEFAULT );
+        if( block != NULL )
+            block_Release( block );
+
+        i_frames += BENCH_FRAMES;
+        if( i_start != 0 )
+            i_elapsed = mdate() - i_start;
+    }
+
+    PrintResult( psz_name, i_frames, i_in_rate, i_elapsed );
+
+    block_Release( template );
+    aout_FiltersDelete( (vlc_object_t *)NULL, filters );
+    vlc_object_release( parent );
+}
+
+static void BenchVolume( libvlc_int_t *p_libvlc, vlc_fourcc_t i_format )
+{
+    char psz_name[32];
+
+    snprintf( psz_name, sizeof (psz_name), "volume %4.4s",
+              (const char *)&i_format );
+
+    audio_volume_t *vol = vlc_object_create( p_libvlc, sizeof (*vol) );
+    assert( vol != NULL );
+    vol->format = i_format;
+
+    module_t *module = module_need( vol, "audio volume", NULL, false );
+    if( module == NULL )
+    {
+        printf( "%-24s unavailable\n", psz_name );
+        vlc_object_release( vol );
+        return;
+    }
+
+    audio_sample_format_t fmt;
+    InitFormat( &fmt, i_format, 48000 );
+
+    /* Amplification is done in place: one buffer can be reused */
+    block_t *block = MakeTemplate( &fmt );
+
+    for( unsigned i = 0; i < BENCH_WARMUP_ITERATIONS; i++ )
+        vol->amplify( vol, block, 0.708f );
+
+    uint64_t i_frames = 0;
+    mtime_t i_start = mdate(), i_elapsed;
+
+    do
+    {
+        vol->amplify( vol, block, 0.708f );
+        i_frames += BENCH_FRAMES;
+        i_elapsed = mdate() - i_start;
+    }
+    while( i_elapsed < BENCH_RUN_TIME );
+
+    PrintResult( psz_name, i_frames, fmt.i_rate, i_elapsed );
+
+    block_Release( block );
+    module_unneed( vol, module );
+    vlc_object_release( vol );
+}
+
+int main( void )
+{
+    test_init();
+
+    const char *argv[] = {
+        "--ignore-config",
+        "-I", "dummy",
+    };
+    libvlc_instance_t *p_vlc = libvlc_new( sizeof (argv) / sizeof (argv[0]),
+                                           argv );
+    assert( p_vlc != NULL );
+
+    printf( "CPU capabilities: 0x%x\n", vlc_CPU() );
+
+    for( size_t i = 0; i < sizeof (chains) / sizeof (chains[0]); i++ )
+        BenchChain( p_vlc->p_libvlc_int, chains[i].psz_name,
+                    chains[i].i_in_format, chains[i].i_in_rate,
+                    chains[i].i_out_format, chains[i].i_out_rate,
+                    chains[i].psz_filters );
+
+    BenchVolume( p_vlc->p_libvlc_int, VLC_CODEC_FL32 );
+    BenchVolume( p_vlc->p_libvlc_int, VLC_CODEC_S16N );
+
+    libvlc_release( p_vlc );
+    return 0;
+}
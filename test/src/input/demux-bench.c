@@ -0,0 +1,225 @@
+/*****************************************************************************
+ * demux-bench.c: demuxer throughput benchmark
+ *****************************************************************************
+ * Copyright (C) 2016 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+/* Runs a demuxer flat out over a file preloaded in memory, with the es_out
+ * stubbed to count-and-discard, and prints input MB/s, blocks/s and output
+ * volume. Not run as part of "make check": build it by hand with
+ * "make vlc-bench-demux" and point it at a sample:
+ *
+ *   ./vlc-bench-demux file.ts [demux-module]
+ */
+
+#include "../../libvlc/test.h"
+#include "../lib/libvlc_internal.h"
+
+#include <vlc_modules.h>
+#include <vlc_stream.h>
+#include <vlc_demux.h>
+#include <vlc_es_out.h>
+#include <vlc_block.h>
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+/*****************************************************************************
+ * Counting es_out stub
+ *****************************************************************************/
+struct es_out_sys_t
+{
+    unsigned i_es;          /* elementary streams added */
+    uint64_t i_blocks;      /* blocks sent by the demuxer */
+    uint64_t i_bytes;       /* payload bytes sent */
+};
+
+static es_out_id_t *EsOutAdd( es_out_t *p_out, const es_format_t *p_fmt )
+{
+    p_out->p_sys->i_es++;
+    (void) p_fmt;
+    /* The demuxer only needs a non-NULL token to pass back to us */
+    return (es_out_id_t *)(uintptr_t)p_out->p_sys->i_es;
+}
+
+static int EsOutSend( es_out_t *p_out, es_out_id_t *id, block_t *p_block )
+{
+    for( block_t *b = p_block; b != NULL; b = b->p_next )
+    {
+        p_out->p_sys->i_blocks++;
+        p_out->p_sys->i_bytes += b->i_buffer;
+    }
+    block_ChainRelease( p_block );
+    (void) id;
+    return VLC_SUCCESS;
+}
+
+static void EsOutDel( es_out_t *p_out, es_out_id_t *id )
+{
+    (void) p_out; (void) id;
+}
+
+static int EsOutControl( es_out_t *p_out, int i_query, va_list args )
+{
+    switch( i_query )
+    {
+        case ES_OUT_GET_ES_STATE:
+            (void) va_arg( args, es_out_id_t * );
+            /* Pretend everything is selected so the demuxer sends it all */
+            *va_arg( args, bool * ) = true;
+            return VLC_SUCCESS;
+        case ES_OUT_GET_EMPTY:
+            *va_arg( args, bool * ) = true;
+            return VLC_SUCCESS;
+        case ES_OUT_GET_PCR_SYSTEM:
+        case ES_OUT_MODIFY_PCR_SYSTEM:
+            return VLC_EGENERIC;
+        default:
+            /* Accept all the SET controls (PCR, meta, group...) silently */
+            (void) p_out;
+            return VLC_SUCCESS;
+    }
+}
+
+static void EsOutDestroy( es_out_t *p_out )
+{
+    (void) p_out;
+}
+
+/*****************************************************************************
+ * Benchmark proper
+ *****************************************************************************/
+static uint8_t *LoadFile( const char *psz_path, size_t *pi_size )
+{
+    FILE *f = fopen( psz_path, "rb" );
+    if( f == NULL )
+        return NULL;
+
+    struct stat st;
+    if( fstat( fileno( f ), &st ) || st.st_size <= 0 )
+    {
+        fclose( f );
+        return NULL;
+    }
+
+    uint8_t *p_data = malloc( st.st_size );
+    assert( p_data != NULL );
+    if( fread( p_data, 1, st.st_size, f ) != (size_t)st.st_size )
+    {
+        free( p_data );
+        fclose( f );
+        return NULL;
+    }
+    fclose( f );
+
+    *pi_size = st.st_size;
+    return p_data;
+}
+
+static int BenchDemux( libvlc_int_t *p_libvlc, const char *psz_path,
+                       const char *psz_module, uint8_t *p_data, size_t i_size )
+{
+    struct es_out_sys_t sys = { 0, 0, 0 };
+    es_out_t out = {
+        .pf_add = EsOutAdd,
+        .pf_send = EsOutSend,
+        .pf_del = EsOutDel,
+        .pf_control = EsOutControl,
+        .pf_destroy = EsOutDestroy,
+        .p_sys = &sys,
+    };
+
+    /* The file is fully preloaded so the numbers are parse time, not I/O */
+    stream_t *s = stream_MemoryNew( p_libvlc, p_data, i_size, true );
+    assert( s != NULL );
+
+    demux_t *p_demux = demux_New( VLC_OBJECT(p_libvlc), psz_module, psz_path,
+                                  s, &out );
+    if( p_demux == NULL )
+    {
+        fprintf( stderr, "no demuxer \"%s\" for %s\n", psz_module, psz_path );
+        stream_Delete( s );
+        return -1;
+    }
+
+    mtime_t i_start = mdate();
+    int i_ret;
+
+    while( ( i_ret = demux_Demux( p_demux ) ) > 0 )
+        ;
+
+    mtime_t i_elapsed = mdate() - i_start;
+    uint64_t i_consumed = stream_Tell( s );
+    char *psz_name = strdup( module_get_object( p_demux->p_module ) );
+
+    demux_Delete( p_demux ); /* also deletes the stream */
+
+    if( i_ret < 0 )
+        fprintf( stderr, "warning: demuxer bailed out with an error\n" );
+    if( i_elapsed <= 0 )
+        i_elapsed = 1;
+
+    double f_seconds = i_elapsed / (double)CLOCK_FREQ;
+
+    printf( "%-10s %2u ES  in %8.1f MB (%5.1f MB/s)  "
+            "out %"PRIu64" blocks (%.0f blocks/s), %.1f MB\n",
+            psz_name, sys.i_es,
+            i_consumed / 1e6, i_consumed / f_seconds / 1e6,
+            sys.i_blocks, sys.i_blocks / f_seconds, sys.i_bytes / 1e6 );
+    free( psz_name );
+    return 0;
+}
+
+int main( int argc, char **argv )
+{
+    test_init();
+
+    if( argc < 2 )
+    {
+        fprintf( stderr, "Usage: %s <file> [demux-module]\n", argv[0] );
+        return 2;
+    }
+
+    const char *psz_path = argv[1];
+    const char *psz_module = ( argc > 2 ) ? argv[2] : "any";
+
+    size_t i_size;
+    uint8_t *p_data = LoadFile( psz_path, &i_size );
+    if( p_data == NULL )
+    {
+        fprintf( stderr, "cannot read %s\n", psz_path );
+        return 1;
+    }
+
+    const char *vlc_argv[] = {
+        "--ignore-config",
+        "-I", "dummy",
+        "--no-media-library",
+    };
+    libvlc_instance_t *p_vlc = libvlc_new( sizeof (vlc_argv)
+                                           / sizeof (vlc_argv[0]), vlc_argv );
+    assert( p_vlc != NULL );
+
+    int ret = BenchDemux( p_vlc->p_libvlc_int, psz_path, psz_module,
+                          p_data, i_size );
+
+    libvlc_release( p_vlc );
+    free( p_data );
+    return ret ? 1 : 0;
+}
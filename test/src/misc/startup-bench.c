@@ -0,0 +1,64 @@
+/*****************************************************************************
+ * startup-bench.c: startup time benchmark
+ *****************************************************************************
+ * Copyright (C) 2016 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+/* Creates and destroys libvlc instances in a loop and prints the startup
+ * phase breakdown recorded by libvlc_InternalInit() (module bank load,
+ * config load, interface spawn) as CSV, one line per run, so cold-start
+ * regressions can be tracked by machines rather than by strace timestamps.
+ * The first run is the interesting "cold" one: later runs hit the warm
+ * plugins cache and the page cache. Not run as part of "make check":
+ * build and run it by hand with "make vlc-bench-startup". */
+
+#include "../../libvlc/test.h"
+#include "../../../lib/libvlc_internal.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+
+#define BENCH_RUNS 5
+
+int main( void )
+{
+    test_init();
+
+    printf( "run,bank_us,config_us,interfaces_us,total_us\n" );
+
+    for( unsigned i = 0; i < BENCH_RUNS; i++ )
+    {
+        const char *argv[] = {
+            "--ignore-config",
+            "-I", "dummy",
+        };
+        libvlc_instance_t *p_vlc =
+            libvlc_new( sizeof (argv) / sizeof (argv[0]), argv );
+        assert( p_vlc != NULL );
+
+        libvlc_int_t *p_libvlc = p_vlc->p_libvlc_int;
+
+        printf( "%u,%"PRId64",%"PRId64",%"PRId64",%"PRId64"\n", i,
+                var_GetInteger( p_libvlc, "startup-time-bank" ),
+                var_GetInteger( p_libvlc, "startup-time-config" ),
+                var_GetInteger( p_libvlc, "startup-time-interfaces" ),
+                var_GetInteger( p_libvlc, "startup-time-total" ) );
+
+        libvlc_release( p_vlc );
+    }
+    return 0;
+}
@@ -0,0 +1,199 @@
+/*****************************************************************************
+ * sout-bench.c: stream output throughput benchmark
+ *****************************************************************************
+ * Copyright (C) 2016 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+/* Drives generated elementary streams (one video-sized, one audio-sized ES)
+ * through muxer + access output combinations flat out, printing input MB/s,
+ * blocks/s and, for file outputs, the mux overhead. The dummy access
+ * isolates the muxer cost; file and udp add the output path. Not run as
+ * part of "make check": build and run it by hand with "make vlc-bench-sout"
+ * when touching mux or stream output code. The TS file left by the file
+ * run can be fed back to vlc-bench-demux for the reading half of the
+ * loopback. */
+
+#include "../../libvlc/test.h"
+#include "../../../lib/libvlc_internal.h"
+
+#include <vlc_modules.h>
+#include <vlc_sout.h>
+#include <vlc_block.h>
+#include <vlc_es.h>
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+/* Wall-clock time spent measuring each combination */
+#define BENCH_RUN_TIME (CLOCK_FREQ / 2)
+
+/* Synthetic ES shaped like a typical SD broadcast program */
+#define VIDEO_BLOCK_SIZE  24000  /* ~4.8 Mbit/s at 25 fps */
+#define VIDEO_BLOCK_LEN   40000  /* 40 ms */
+#define AUDIO_BLOCK_SIZE  672
+#define AUDIO_BLOCK_LEN   24000  /* 24 ms */
+
+static block_t *MakeBlock( size_t i_size, mtime_t i_dts, mtime_t i_length )
+{
+    block_t *block = block_Alloc( i_size );
+    assert( block != NULL );
+
+    /* Non-constant payload, so the output path cannot take shortcuts */
+    for( size_t i = 0; i < i_size; i += 64 )
+        block->p_buffer[i] = i_dts + i;
+    block->i_dts = block->i_pts = i_dts;
+    block->i_length = i_length;
+    return block;
+}
+
+static void BenchMux( libvlc_int_t *p_libvlc, const char *psz_mux,
+                      const char *psz_access, const char *psz_dest )
+{
+    char psz_name[64];
+
+    snprintf( psz_name, sizeof (psz_name), "%s mux -> %s", psz_mux,
+              psz_access );
+
+    /* Minimal stream output instance: enough context for the muxer and
+     * access output, without input/playlist plumbing in the way */
+    sout_instance_t *p_sout = vlc_object_create( p_libvlc,
+                                                 sizeof (*p_sout) );
+    assert( p_sout != NULL );
+    p_sout->psz_sout = NULL;
+    p_sout->i_out_pace_nocontrol = 0;
+    p_sout->p_stream = NULL;
+    vlc_mutex_init( &p_sout->lock );
+    var_Create( p_sout, "sout-mux-caching",
+                VLC_VAR_INTEGER | VLC_VAR_DOINHERIT );
+
+    sout_access_out_t *p_access = sout_AccessOutNew( p_sout, psz_access,
+                                                     psz_dest );
+    if( p_access == NULL )
+    {
+        printf( "%-20s access unavailable\n", psz_name );
+        goto out;
+    }
+
+    sout_mux_t *p_mux = sout_MuxNew( p_sout, psz_mux, p_access );
+    if( p_mux == NULL )
+    {
+        printf( "%-20s mux unavailable\n", psz_name );
+        sout_AccessOutDelete( p_access );
+        goto out;
+    }
+
+    es_format_t fmt_video, fmt_audio;
+    es_format_Init( &fmt_video, VIDEO_ES, VLC_CODEC_MP2V );
+    fmt_video.video.i_width = 720;
+    fmt_video.video.i_height = 576;
+    es_format_Init( &fmt_audio, AUDIO_ES, VLC_CODEC_MPGA );
+    fmt_audio.audio.i_rate = 48000;
+    fmt_audio.audio.i_channels = 2;
+
+    sout_input_t *p_video = sout_MuxAddStream( p_mux, &fmt_video );
+    sout_input_t *p_audio = sout_MuxAddStream( p_mux, &fmt_audio );
+    if( p_video == NULL || p_audio == NULL )
+    {
+        printf( "%-20s cannot add streams\n", psz_name );
+        if( p_video != NULL )
+            sout_MuxDeleteStream( p_mux, p_video );
+        if( p_audio != NULL )
+            sout_MuxDeleteStream( p_mux, p_audio );
+        sout_MuxDelete( p_mux );
+        sout_AccessOutDelete( p_access );
+        goto out;
+    }
+
+    mtime_t i_video_dts = VLC_TS_0;
+    mtime_t i_audio_dts = VLC_TS_0;
+    uint64_t i_blocks = 0, i_bytes = 0;
+    mtime_t i_start = mdate(), i_elapsed;
+
+    do
+    {
+        size_t i_size;
+
+        /* Interleave by DTS, as the input thread would */
+        if( i_video_dts <= i_audio_dts )
+        {
+            i_size = VIDEO_BLOCK_SIZE;
+            sout_MuxSendBuffer( p_mux, p_video,
+                MakeBlock( i_size, i_video_dts, VIDEO_BLOCK_LEN ) );
+            i_video_dts += VIDEO_BLOCK_LEN;
+        }
+        else
+        {
+            i_size = AUDIO_BLOCK_SIZE;
+            sout_MuxSendBuffer( p_mux, p_audio,
+                MakeBlock( i_size, i_audio_dts, AUDIO_BLOCK_LEN ) );
+            i_audio_dts += AUDIO_BLOCK_LEN;
+        }
+        i_blocks++;
+        i_bytes += i_size;
+        i_elapsed = mdate() - i_start;
+    }
+    while( i_elapsed < BENCH_RUN_TIME );
+
+    sout_MuxDeleteStream( p_mux, p_video );
+    sout_MuxDeleteStream( p_mux, p_audio );
+    sout_MuxDelete( p_mux );
+    sout_AccessOutDelete( p_access );
+
+    double f_seconds = i_elapsed / (double)CLOCK_FREQ;
+
+    printf( "%-20s %8.1f MB/s in  %8.0f blocks/s  %8.1f ns/block",
+            psz_name, i_bytes / f_seconds / 1e6, i_blocks / f_seconds,
+            i_elapsed * 1000. / i_blocks );
+
+    struct stat st;
+    if( !strcmp( psz_access, "file" ) && stat( psz_dest, &st ) == 0 )
+        printf( "  %5.2f%% mux overhead",
+                100. * ((double)st.st_size - i_bytes) / i_bytes );
+    printf( "\n" );
+
+out:
+    vlc_mutex_destroy( &p_sout->lock );
+    vlc_object_release( p_sout );
+}
+
+int main( void )
+{
+    test_init();
+
+    const char *argv[] = {
+        "--ignore-config",
+        "-I", "dummy",
+    };
+    libvlc_instance_t *p_vlc = libvlc_new( sizeof (argv) / sizeof (argv[0]),
+                                           argv );
+    assert( p_vlc != NULL );
+
+    const char *psz_file = "/tmp/vlc-bench-sout.ts";
+
+    /* dummy access = muxer cost alone; file and udp add the output path */
+    BenchMux( p_vlc->p_libvlc_int, "ts", "dummy", "" );
+    BenchMux( p_vlc->p_libvlc_int, "ps", "dummy", "" );
+    BenchMux( p_vlc->p_libvlc_int, "ts", "file", psz_file );
+    BenchMux( p_vlc->p_libvlc_int, "ts", "udp", "127.0.0.1:15004" );
+
+    printf( "output left in %s (usable with vlc-bench-demux)\n", psz_file );
+
+    libvlc_release( p_vlc );
+    return 0;
+}